@@ -0,0 +1,1417 @@
+/*
+ * cgroups.c - cgroup v2 control group related definitions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "sort.h"
+
+#include "procps-private.h"
+#include "cgroups.h"
+
+#ifndef CGROUP_DIR                       // (tests may substitute their own)
+#define CGROUP_DIR      "/sys/fs/cgroup"
+#endif
+
+#define CGROUPS_BUFF    8192             // plenty for the largest, memory.stat
+#define STACKS_INCR     64               // amount reap stack allocations grow
+#define HASH_INIT       64               // initial name hash size (power of 2)
+#define RESCAN_SECS     5                // most seconds between hierarchy walks
+#define STR_COMPARE     strverscmp
+
+/* ----------------------------------------------------------------------- +
+   this provision can help ensure that our Item_table remains synchronized |
+   with the enumerators found in the associated header file. It's intended |
+   to only be used locally (& temporarily) at some point before a release! | */
+// #define ITEMTABLE_DEBUG //--------------------------------------------- |
+// ----------------------------------------------------------------------- +
+
+
+struct cg_data {
+    unsigned long long usage_usec;
+    unsigned long long user_usec;
+    unsigned long long system_usec;
+    unsigned long long nr_periods;
+    unsigned long long nr_throttled;
+    unsigned long long throttled_usec;
+    unsigned long long mem_current;
+    unsigned long long anon;
+    unsigned long long file;
+    unsigned long long kernel;
+    unsigned long long shmem;
+    unsigned long long pgfault;
+    unsigned long long pgmajfault;
+    unsigned long long rbytes;
+    unsigned long long wbytes;
+    unsigned long long rios;
+    unsigned long long wios;
+    unsigned long long stamp_ns;       // CLOCK_MONOTONIC when these were read
+};
+
+        // the files read for every group, each with a bit in 'absent'
+static const char *cg_files[] = {
+    "cpu.stat", "memory.current", "memory.stat", "io.stat" };
+enum cg_file { CG_CPU, CG_MEMCUR, CG_MEMSTAT, CG_IO };
+#define CG_FILES  (int)MAXTABLE(cg_files)
+
+struct cg_node {
+    char *name;                        // "/", or relative to CGROUP_DIR
+    int depth;                         // how many '/' separators from "/"
+    int dirfd;                         // its directory (else -1)
+    dev_t dev;                         // that directory's identity, when
+    ino_t ino;                         //  opened (to detect a replacement)
+    int fds[CG_FILES];                 // persistent, re-read with pread
+    unsigned absent;                   // files found missing, by bit
+    unsigned long walked;              // walk generation when last seen
+    int stale;                         // gone or replaced, history useless
+    struct cg_data new;
+    struct cg_data old;
+    struct cg_node *next;
+    struct cg_node *hnext;             // next in this name's hash bucket
+};
+
+struct stacks_extent {
+    int ext_numstacks;
+    struct stacks_extent *next;
+    struct cgroups_stack **stacks;
+};
+
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum cgroups_item *items;          // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for these extents
+};
+
+struct fetch_support {
+    struct cgroups_stack **anchor;     // fetch consolidated extents
+    int n_alloc;                       // number of above pointers allocated
+    int n_inuse;                       // number of above pointers occupied
+    int n_alloc_save;                  // last known reap.stacks allocation
+    struct cgroups_reaped results;     // count + stacks for return to caller
+};
+
+struct cgroups_info {
+    int refcount;
+    char *buf;                         // CGROUPS_BUFF, for any one file
+    int stat_fd;                       // the root's cgroup.stat (maybe)
+    unsigned long long descendants;    // its nr_descendants, when walked
+    struct cg_node *nodes;             // group nodes anchor, in walk order
+    struct cg_node *tail;              // last of those nodes (when walking)
+    struct cg_node **hash;             // the nodes by name, via their 'hnext'
+    unsigned hashsiz;                  // buckets in above hash (a power of 2)
+    int numnodes;                      // total nodes, governing hash growth
+    unsigned long walks;               // walk generation
+    unsigned long long walk_ns;        // CLOCK_MONOTONIC when last walked
+    int rewalk;                        // some group vanished, or was added
+    int fds_max;                       // most fds we'll keep open, all told
+    int fds_inuse;                     // number of above fds held open
+    struct ext_support select_ext;     // supports concurrent select/reap
+    struct ext_support fetch_ext;      // supports concurrent select/reap
+    struct fetch_support fetch;        // support for procps_cgroups_reap
+    struct cgroups_result get_this;    // used by procps_cgroups_get
+    struct cg_node peek;               // a select/get copy, leaving history
+    struct cg_node *peek_from;         //  intact (and the node it's from)
+};
+
+
+// ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+#define setNAME(e) set_cgroups_ ## e
+#define setDECL(e) static void setNAME(e) \
+    (struct cgroups_result *R, struct cg_node *N)
+
+// regular assignment
+#define NOD_set(e,t,x) setDECL(e) { R->result. t = N-> x; }
+#define REG_set(e,x) setDECL(e) { R->result.ull_int = N->new. x; }
+// delta assignment (a group recreated under the same name restarts its totals)
+#define HST_set(e,x) setDECL(e) { \
+    R->result.ull_int = N->new. x > N->old. x ? N->new. x - N->old. x : 0; }
+// percent of the elapsed time, from microseconds & nanoseconds
+#define PCT_set(e,x) setDECL(e) { \
+    unsigned long long ns = N->new.stamp_ns - N->old.stamp_ns; \
+    R->result.real = ns && N->new. x > N->old. x ? ( N->new. x - N->old. x ) * 1.0e5 / ns : 0.0; }
+// rate assignment (with a new node's history equal to its current values)
+#define HST_rate(e,x) setDECL(e) { \
+    unsigned long long ns = N->new.stamp_ns - N->old.stamp_ns; \
+    R->result.real = ns && N->new. x > N->old. x ? ( N->new. x - N->old. x ) * 1.0e9 / ns : 0.0; }
+
+setDECL(noop)  { (void)R; (void)N; }
+setDECL(extra) { (void)N; R->result.ull_int = 0; }
+
+NOD_set(NAME,                      str,     name)
+NOD_set(DEPTH,                     s_int,   depth)
+
+REG_set(CPU_USAGE_USEC,            usage_usec)
+REG_set(CPU_USER_USEC,             user_usec)
+REG_set(CPU_SYSTEM_USEC,           system_usec)
+REG_set(CPU_NR_PERIODS,            nr_periods)
+REG_set(CPU_NR_THROTTLED,          nr_throttled)
+REG_set(CPU_THROTTLED_USEC,        throttled_usec)
+
+REG_set(MEM_CURRENT,               mem_current)
+REG_set(MEM_ANON,                  anon)
+REG_set(MEM_FILE,                  file)
+REG_set(MEM_KERNEL,                kernel)
+REG_set(MEM_SHMEM,                 shmem)
+REG_set(MEM_PGFAULT,               pgfault)
+REG_set(MEM_PGMAJFAULT,            pgmajfault)
+
+REG_set(IO_RBYTES,                 rbytes)
+REG_set(IO_WBYTES,                 wbytes)
+REG_set(IO_RIOS,                   rios)
+REG_set(IO_WIOS,                   wios)
+
+HST_set(DELTA_CPU_USAGE_USEC,      usage_usec)
+HST_set(DELTA_CPU_USER_USEC,       user_usec)
+HST_set(DELTA_CPU_SYSTEM_USEC,     system_usec)
+HST_set(DELTA_CPU_NR_THROTTLED,    nr_throttled)
+HST_set(DELTA_CPU_THROTTLED_USEC,  throttled_usec)
+HST_set(DELTA_MEM_PGFAULT,         pgfault)
+HST_set(DELTA_MEM_PGMAJFAULT,      pgmajfault)
+HST_set(DELTA_IO_RBYTES,           rbytes)
+HST_set(DELTA_IO_WBYTES,           wbytes)
+HST_set(DELTA_IO_RIOS,             rios)
+HST_set(DELTA_IO_WIOS,             wios)
+
+setDECL(DELTA_ELAPSED) { R->result.real = ( N->new.stamp_ns - N->old.stamp_ns ) / 1.0e9; }
+PCT_set(DELTA_CPU_USAGE_PCT,       usage_usec)
+PCT_set(DELTA_CPU_THROTTLED_PCT,   throttled_usec)
+HST_rate(DELTA_IO_RBYTES_PER_SEC,  rbytes)
+HST_rate(DELTA_IO_WBYTES_PER_SEC,  wbytes)
+
+#undef setDECL
+#undef NOD_set
+#undef REG_set
+#undef HST_set
+#undef PCT_set
+#undef HST_rate
+
+
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum cgroups_sort_order order;
+};
+
+#define srtNAME(t) sort_cgroups_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct cgroups_stack **A, const struct cgroups_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct cgroups_result *a = (*A)->head + P->offset; \
+    const struct cgroups_result *b = (*B)->head + P->offset; \
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(ull_int) {
+    const struct cgroups_result *a = (*A)->head + P->offset; \
+    const struct cgroups_result *b = (*B)->head + P->offset; \
+    if ( a->result.ull_int > b->result.ull_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.ull_int < b->result.ull_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(real) {
+    const struct cgroups_result *a = (*A)->head + P->offset; \
+    const struct cgroups_result *b = (*B)->head + P->offset; \
+    if ( a->result.real > b->result.real ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.real < b->result.real ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(str) {
+    const struct cgroups_result *a = (*A)->head + P->offset;
+    const struct cgroups_result *b = (*B)->head + P->offset;
+    return P->order * STR_COMPARE(a->result.str, b->result.str);
+}
+
+srtDECL(noop) { \
+    (void)A; (void)B; (void)P; \
+    return 0;
+}
+
+#undef srtDECL
+
+
+// ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+typedef void (*SET_t)(struct cgroups_result *, struct cg_node *);
+#ifdef ITEMTABLE_DEBUG
+#define RS(e) (SET_t)setNAME(e), CGROUPS_ ## e, STRINGIFY(CGROUPS_ ## e)
+#else
+#define RS(e) (SET_t)setNAME(e)
+#endif
+
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
+#define TS(t) STRINGIFY(t)
+#define TS_noop ""
+
+        /*
+         * Need it be said?
+         * This table must be kept in the exact same order as
+         * those *enum cgroups_item* guys ! */
+static struct {
+    SET_t setsfunc;              // the actual result setting routine
+#ifdef ITEMTABLE_DEBUG
+    int   enumnumb;              // enumerator (must match position!)
+    char *enum2str;              // enumerator name as a char* string
+#endif
+    QSR_t sortfunc;              // sort cmp func for a specific type
+    char *type2str;              // the result type as a string value
+} Item_table[] = {
+/*  setsfunc                            sortfunc      type2str
+    ----------------------------------  ------------  ----------- */
+  { RS(noop),                           QS(noop),     TS_noop     },
+  { RS(extra),                          QS(ull_int),  TS_noop     },
+
+  { RS(NAME),                           QS(str),      TS(str)     },
+  { RS(DEPTH),                          QS(s_int),    TS(s_int)   },
+
+  { RS(CPU_USAGE_USEC),                 QS(ull_int),  TS(ull_int) },
+  { RS(CPU_USER_USEC),                  QS(ull_int),  TS(ull_int) },
+  { RS(CPU_SYSTEM_USEC),                QS(ull_int),  TS(ull_int) },
+  { RS(CPU_NR_PERIODS),                 QS(ull_int),  TS(ull_int) },
+  { RS(CPU_NR_THROTTLED),               QS(ull_int),  TS(ull_int) },
+  { RS(CPU_THROTTLED_USEC),             QS(ull_int),  TS(ull_int) },
+
+  { RS(MEM_CURRENT),                    QS(ull_int),  TS(ull_int) },
+  { RS(MEM_ANON),                       QS(ull_int),  TS(ull_int) },
+  { RS(MEM_FILE),                       QS(ull_int),  TS(ull_int) },
+  { RS(MEM_KERNEL),                     QS(ull_int),  TS(ull_int) },
+  { RS(MEM_SHMEM),                      QS(ull_int),  TS(ull_int) },
+  { RS(MEM_PGFAULT),                    QS(ull_int),  TS(ull_int) },
+  { RS(MEM_PGMAJFAULT),                 QS(ull_int),  TS(ull_int) },
+
+  { RS(IO_RBYTES),                      QS(ull_int),  TS(ull_int) },
+  { RS(IO_WBYTES),                      QS(ull_int),  TS(ull_int) },
+  { RS(IO_RIOS),                        QS(ull_int),  TS(ull_int) },
+  { RS(IO_WIOS),                        QS(ull_int),  TS(ull_int) },
+
+  { RS(DELTA_CPU_USAGE_USEC),           QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_CPU_USER_USEC),            QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_CPU_SYSTEM_USEC),          QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_CPU_NR_THROTTLED),         QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_CPU_THROTTLED_USEC),       QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_MEM_PGFAULT),              QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_MEM_PGMAJFAULT),           QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_IO_RBYTES),                QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_IO_WBYTES),                QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_IO_RIOS),                  QS(ull_int),  TS(ull_int) },
+  { RS(DELTA_IO_WIOS),                  QS(ull_int),  TS(ull_int) },
+
+  { RS(DELTA_ELAPSED),                  QS(real),     TS(real)    },
+  { RS(DELTA_CPU_USAGE_PCT),            QS(real),     TS(real)    },
+  { RS(DELTA_CPU_THROTTLED_PCT),        QS(real),     TS(real)    },
+  { RS(DELTA_IO_RBYTES_PER_SEC),        QS(real),     TS(real)    },
+  { RS(DELTA_IO_WBYTES_PER_SEC),        QS(real),     TS(real)    },
+};
+
+    /* please note,
+     * this enum MUST be 1 greater than the highest value of any enum */
+enum cgroups_item CGROUPS_logical_end = MAXTABLE(Item_table);
+
+#undef setNAME
+#undef srtNAME
+#undef RS
+#undef QS
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- cg_node specific support -----------------------------------------------
+
+static inline unsigned node_hash (
+        const char *name)
+{
+    return procps_hash(name, strlen(name));
+} // end: node_hash
+
+
+static int node_hash_grow (
+        struct cgroups_info *info)
+{
+    unsigned newsiz = info->hashsiz ? info->hashsiz << 1 : HASH_INIT;
+    struct cg_node **hash, *node, *next;
+    unsigned i, h;
+
+    if (!(hash = calloc(newsiz, sizeof(struct cg_node *))))
+        return 0;
+    // the hash, not the nodes list, is complete while we're walking
+    for (i = 0; i < info->hashsiz; i++) {
+        for (node = info->hash[i]; node; node = next) {
+            next = node->hnext;
+            h = node_hash(node->name) & (newsiz - 1);
+            node->hnext = hash[h];
+            hash[h] = node;
+        }
+    }
+    free(info->hash);
+    info->hash = hash;
+    info->hashsiz = newsiz;
+    return 1;
+} // end: node_hash_grow
+
+
+static void node_close (
+        struct cgroups_info *info,
+        struct cg_node *node)
+{
+    int i;
+
+    for (i = 0; i < CG_FILES; i++) {
+        if (node->fds[i] != -1) {
+            close(node->fds[i]);
+            node->fds[i] = -1;
+            --info->fds_inuse;
+        }
+    }
+    if (node->dirfd != -1) {
+        close(node->dirfd);
+        node->dirfd = -1;
+        --info->fds_inuse;
+    }
+} // end: node_close
+
+
+static void node_free (
+        struct cgroups_info *info,
+        struct cg_node *node)
+{
+    if (info->peek_from == node)
+        info->peek_from = NULL;
+    node_close(info, node);
+    free(node->name);
+    free(node);
+} // end: node_free
+
+
+static struct cg_node *node_get (
+        struct cgroups_info *info,
+        const char *name)
+{
+    struct cg_node *node = NULL;
+
+    if (info->hash)
+        node = info->hash[node_hash(name) & (info->hashsiz - 1)];
+    while (node) {
+        if (strcmp(name, node->name) == 0)
+            break;
+        node = node->hnext;
+    }
+    return node;
+} // end: node_get
+
+
+static struct cg_node *node_new (
+        struct cgroups_info *info,
+        const char *name,
+        int depth)
+{
+    struct cg_node *node;
+    unsigned h;
+    int i;
+
+    // the hash grows with the nodes, keeping each chain short
+    if (info->numnodes >= (int)info->hashsiz
+    && !node_hash_grow(info))
+        return NULL;
+    if (!(node = calloc(1, sizeof(struct cg_node))))
+        return NULL;
+    if (!(node->name = strdup(name))) {
+        free(node);
+        return NULL;
+    }
+    node->depth = depth;
+    node->dirfd = -1;
+    for (i = 0; i < CG_FILES; i++)
+        node->fds[i] = -1;
+    h = node_hash(name) & (info->hashsiz - 1);
+    node->hnext = info->hash[h];
+    info->hash[h] = node;
+    ++info->numnodes;
+    return node;
+} // end: node_new
+
+
+        /*
+         * Those nodes not seen in the latest walk are gone, so each is
+         * cut from its hash chain and freed. The nodes list was already
+         * rebuilt by that walk, without them. */
+static void node_purge (
+        struct cgroups_info *info)
+{
+    struct cg_node **hp, *node;
+    unsigned i;
+
+    for (i = 0; i < info->hashsiz; i++) {
+        hp = &info->hash[i];
+        while ((node = *hp)) {
+            if (node->walked == info->walks)
+                hp = &node->hnext;
+            else {
+                *hp = node->hnext;
+                node_free(info, node);
+                --info->numnodes;
+            }
+        }
+    }
+} // end: node_purge
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- generalized support ----------------------------------------------------
+
+static inline void cgroups_assign_results (
+        struct cgroups_stack *stack,
+        struct cg_node *node)
+{
+    struct cgroups_result *this = stack->head;
+
+    for (;;) {
+        enum cgroups_item item = this->item;
+        if (item >= CGROUPS_logical_end)
+            break;
+        Item_table[item].setsfunc(this, node);
+        ++this;
+    }
+    return;
+} // end: cgroups_assign_results
+
+
+static void cgroups_extents_free_all (
+        struct ext_support *this)
+{
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
+        free(p);
+    };
+} // end: cgroups_extents_free_all
+
+
+static inline struct cgroups_result *cgroups_itemize_stack (
+        struct cgroups_result *p,
+        int depth,
+        enum cgroups_item *items)
+{
+    struct cgroups_result *p_sav = p;
+    int i;
+
+    for (i = 0; i < depth; i++) {
+        p->item = items[i];
+        ++p;
+    }
+    return p_sav;
+} // end: cgroups_itemize_stack
+
+
+static inline int cgroups_items_check_failed (
+        enum cgroups_item *items,
+        int numitems)
+{
+    int i;
+
+    /* if an enum is passed instead of an address of one or more enums, ol' gcc
+     * will silently convert it to an address (possibly NULL).  only clang will
+     * offer any sort of warning like the following:
+     *
+     * warning: incompatible integer to pointer conversion passing 'int' to parameter of type 'enum cgroups_item *'
+     * my_stack = procps_cgroups_select(info, CGROUPS_noop, num);
+     *                                        ^~~~~~~~~~~~~~
+     */
+    if (numitems < 1
+    || (void *)items < (void *)(unsigned long)(2 * CGROUPS_logical_end))
+        return 1;
+
+    for (i = 0; i < numitems; i++) {
+        // a cgroups_item is currently unsigned, but we'll protect our future
+        if (items[i] < 0)
+            return 1;
+        if (items[i] >= CGROUPS_logical_end)
+            return 1;
+    }
+
+    return 0;
+} // end: cgroups_items_check_failed
+
+
+        /*
+         * Read one of a group's files into our buffer, at offset 0, where
+         * each read generates fresh content. Its fd is kept open for the
+         * next time, so long as our budget of fds allows (and the group's
+         * directory is held too, since the walk checks on just that one).
+         * Returns the number of bytes read, else 0 if the file is absent or
+         * the group has vanished (then ensuring another walk). */
+static int cgroups_pread (
+        struct cgroups_info *info,
+        struct cg_node *node,
+        int file)
+{
+    char path[PATH_MAX];
+    int fd, size;
+
+    if (node->absent & (1 << file))
+        return 0;
+    if (-1 == (fd = node->fds[file])) {
+        if (node->dirfd != -1)
+            fd = openat(node->dirfd, cg_files[file], O_RDONLY);
+        else {
+            snprintf(path, sizeof(path), "%s%s/%s"
+                , CGROUP_DIR, node->depth ? node->name : "", cg_files[file]);
+            fd = open(path, O_RDONLY);
+        }
+        if (fd == -1) {
+            // a controller not enabled for this group means no such file
+            if (errno == ENOENT)
+                node->absent |= (1 << file);
+            info->rewalk |= (errno != ENOENT);
+            return 0;
+        }
+        if (node->dirfd != -1
+        && info->fds_inuse < info->fds_max) {
+            node->fds[file] = fd;
+            ++info->fds_inuse;
+        }
+    }
+    for (;;) {
+        if ((size = pread(fd, info->buf, CGROUPS_BUFF - 1, 0)) < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+        }
+        break;
+    }
+    if (node->fds[file] != fd)
+        close(fd);
+    if (size < 0) {
+        /* ENODEV, with the group now gone (or since replaced by another
+           of that name), so every fd held for it is stale. They're all
+           closed, any remaining files skipped & the next walk reopens. */
+        node_close(info, node);
+        node->absent = ~0u;
+        node->stale = 1;
+        info->rewalk = 1;
+        size = 0;
+    } else if (size == 0 && node->fds[file] == fd) {
+        close(fd);
+        node->fds[file] = -1;
+        --info->fds_inuse;
+    }
+    info->buf[size] = '\0';
+    return size;
+} // end: cgroups_pread
+
+
+        /*
+         * Parse those 'key value' lines of cpu.stat & memory.stat, for
+         * just the keys of interest (with any others simply ignored). */
+static void cgroups_parse_keys (
+        char *buf,
+        const char *const keys[],
+        unsigned long long *vals[],
+        int numkeys)
+{
+    char *p, *head = buf;
+    int i, len;
+
+    while (*head) {
+        if ((p = strchr(head, ' '))) {
+            len = p - head;
+            for (i = 0; i < numkeys; i++) {
+                if (!strncmp(head, keys[i], len) && keys[i][len] == '\0') {
+                    *vals[i] = strtoull(p + 1, NULL, 10);
+                    break;
+                }
+            }
+        }
+        if (!(head = strchr(head, '\n')))
+            break;
+        ++head;
+    }
+} // end: cgroups_parse_keys
+
+
+        /*
+         * Parse io.stat lines, as in 'MAJ:MIN rbytes=N wbytes=N rios=N ...'
+         * with the values of each device summed for the group as a whole. */
+static void cgroups_parse_io (
+        char *buf,
+        struct cg_data *data)
+{
+    static const char *keys[] = { "rbytes", "wbytes", "rios", "wios" };
+    unsigned long long *vals[] = { &data->rbytes, &data->wbytes, &data->rios, &data->wios };
+    char *p, *head = buf;
+    int i, len;
+
+    while (*head && *head != '\n') {
+        // skip past the device, then on to each 'key=value'
+        head += strcspn(head, " \n");
+        while (*head == ' ') {
+            ++head;
+            if (!(p = strchr(head, '=')))
+                return;
+            len = p - head;
+            for (i = 0; i < (int)MAXTABLE(keys); i++) {
+                if (!strncmp(head, keys[i], len) && keys[i][len] == '\0') {
+                    *vals[i] += strtoull(p + 1, NULL, 10);
+                    break;
+                }
+            }
+            head += strcspn(head, " \n");
+        }
+        if (*head == '\n')
+            ++head;
+    }
+} // end: cgroups_parse_io
+
+
+        /*
+         * Read all of a group's files, filling 'data' (which may or may not
+         * be the node's own 'new'). */
+static void cgroups_data_read (
+        struct cgroups_info *info,
+        struct cg_node *node,
+        struct cg_data *new,
+        unsigned long long ns)
+{
+    static const char *cpu_keys[] = {
+        "usage_usec", "user_usec", "system_usec",
+        "nr_periods", "nr_throttled", "throttled_usec" };
+    static const char *mem_keys[] = {
+        "anon", "file", "kernel", "shmem", "pgfault", "pgmajfault" };
+    unsigned long long *cpu_vals[] = {
+        &new->usage_usec, &new->user_usec, &new->system_usec,
+        &new->nr_periods, &new->nr_throttled, &new->throttled_usec };
+    unsigned long long *mem_vals[] = {
+        &new->anon, &new->file, &new->kernel, &new->shmem, &new->pgfault, &new->pgmajfault };
+
+    // clear out the soon to be 'current' values
+    memset(new, 0, sizeof(struct cg_data));
+    new->stamp_ns = ns;
+
+    if (cgroups_pread(info, node, CG_CPU))
+        cgroups_parse_keys(info->buf, cpu_keys, cpu_vals, MAXTABLE(cpu_keys));
+    if (cgroups_pread(info, node, CG_MEMCUR))
+        new->mem_current = strtoull(info->buf, NULL, 10);
+    if (cgroups_pread(info, node, CG_MEMSTAT))
+        cgroups_parse_keys(info->buf, mem_keys, mem_vals, MAXTABLE(mem_keys));
+    if (cgroups_pread(info, node, CG_IO))
+        cgroups_parse_io(info->buf, new);
+} // end: cgroups_data_read
+
+
+static void cgroups_node_read (
+        struct cgroups_info *info,
+        struct cg_node *node,
+        unsigned long long ns)
+{
+    int brand_new = (node->new.stamp_ns == 0 || node->stale);
+
+    node->stale = 0;
+    // remember history from last time around ...
+    memcpy(&node->old, &node->new, sizeof(struct cg_data));
+    cgroups_data_read(info, node, &node->new, ns);
+
+    // a group found gone (or replaced) mid-read shows no change for now
+    if (node->stale)
+        memcpy(&node->new, &node->old, sizeof(struct cg_data));
+    // and let's not distort the deltas when a new node is read ...
+    else if (brand_new)
+        memcpy(&node->old, &node->new, sizeof(struct cg_data));
+} // end: cgroups_node_read
+
+
+        /*
+         * Read a group's files for select or get, into a copy of its node
+         * whose deltas are then relative to the last reap. Unlike a reap,
+         * this leaves the node's own history alone. */
+static struct cg_node *cgroups_node_peek (
+        struct cgroups_info *info,
+        struct cg_node *node,
+        unsigned long long ns)
+{
+    struct cg_node *peek = &info->peek;
+
+    memcpy(peek, node, sizeof(struct cg_node));
+    memcpy(&peek->old, &node->new, sizeof(struct cg_data));
+    cgroups_data_read(info, node, &peek->new, ns);
+    if (node->stale)
+        memcpy(&peek->new, &peek->old, sizeof(struct cg_data));
+    info->peek_from = node;
+    return peek;
+} // end: cgroups_node_peek
+
+
+static unsigned long long cgroups_descendants (
+        struct cgroups_info *info)
+{
+    char *p;
+    int size;
+
+    if (info->stat_fd == -1)
+        return 0;
+    if ((size = pread(info->stat_fd, info->buf, CGROUPS_BUFF - 1, 0)) <= 0)
+        return 0;
+    info->buf[size] = '\0';
+    if (!(p = strstr(info->buf, "nr_descendants ")))
+        return 0;
+    return strtoull(p + 15, NULL, 10);
+} // end: cgroups_descendants
+
+
+        /*
+         * Visit 'node' then each group beneath it, in a preorder walk with
+         * directories opened relative to their parent's (cached) fd. Every
+         * group found is linked onto the rebuilt nodes list. */
+static int cgroups_walk (
+        struct cgroups_info *info,
+        struct cg_node *node,
+        int parentfd,
+        const char *dname)
+{
+    char path[PATH_MAX];
+    struct dirent *ent;
+    struct cg_node *kid;
+    struct stat sb;
+    DIR *dirp;
+    int fd, rc = 0;
+
+    node->walked = info->walks;
+    node->absent = 0;                  // since controllers may be enabled
+    node->next = NULL;
+    if (info->tail)
+        info->tail->next = node;
+    else
+        info->nodes = node;
+    info->tail = node;
+
+    /* a directory held from some earlier walk may since have been removed,
+       then perhaps recreated, so its identity must still match that name */
+    if (-1 != (fd = node->dirfd)
+    && (fstatat(parentfd, dname, &sb, 0) < 0
+    || sb.st_ino != node->ino
+    || sb.st_dev != node->dev)) {
+        node_close(info, node);
+        node->stale = 1;
+        fd = -1;
+    }
+    if (-1 == fd) {
+        if (-1 == (fd = openat(parentfd, dname, O_RDONLY | O_DIRECTORY)))
+            return (node->depth ? 0 : -1);
+        if (info->fds_inuse < info->fds_max
+        && fstat(fd, &sb) == 0) {
+            node->dirfd = fd;
+            node->dev = sb.st_dev;
+            node->ino = sb.st_ino;
+            ++info->fds_inuse;
+        }
+    }
+    /* fdopendir assumes ownership of the fd it's given, ergo our dup
+       (but that shares its offset, left at the end by any prior walk) */
+    if (!(dirp = fdopendir(dup(fd)))) {
+        if (node->dirfd != fd)
+            close(fd);
+        return (node->depth ? 0 : -1);
+    }
+    rewinddir(dirp);
+    while ((ent = readdir(dirp))) {
+        if (ent->d_name[0] == '.')
+            continue;
+        if (ent->d_type != DT_DIR) {
+            if (ent->d_type != DT_UNKNOWN
+            || fstatat(fd, ent->d_name, &sb, AT_SYMLINK_NOFOLLOW) < 0
+            || !S_ISDIR(sb.st_mode))
+                continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", node->depth ? node->name : "", ent->d_name);
+        if (!(kid = node_get(info, path))
+        && (!(kid = node_new(info, path, node->depth + 1)))) {
+            rc = -1;                   // here, errno was set to ENOMEM
+            break;
+        }
+        if ((rc = cgroups_walk(info, kid, fd, ent->d_name)))
+            break;
+    }
+    closedir(dirp);
+    if (node->dirfd != fd)
+        close(fd);
+    return rc;
+} // end: cgroups_walk
+
+
+/*
+ * cgroups_read_failed:
+ *
+ * @info: info structure created at procps_cgroups_new
+ *
+ * Walk the hierarchy (should it have changed), then read each group's
+ * files putting the information into the supplied info structure
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int cgroups_read_failed (
+        struct cgroups_info *info)
+{
+    unsigned long long descendants, ns;
+    struct cg_node *node;
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    info->peek_from = NULL;
+
+    /* a walk is needed the first time, after some group vanished, when a
+       count of groups has changed or, to catch a group both added & then
+       removed, at least every so often ... */
+    descendants = cgroups_descendants(info);
+    if (!info->nodes
+    || info->rewalk
+    || descendants != info->descendants
+    || ns - info->walk_ns >= RESCAN_SECS * 1000000000ULL) {
+        if (!(node = node_get(info, "/"))
+        && (!(node = node_new(info, "/", 0))))
+            return 1;
+        ++info->walks;
+        info->rewalk = 0;
+        info->walk_ns = ns;
+        info->descendants = descendants;
+        info->nodes = info->tail = NULL;
+        if (cgroups_walk(info, node, AT_FDCWD, CGROUP_DIR))
+            return 1;
+        node_purge(info);
+    }
+
+    for (node = info->nodes; node; node = node->next)
+        cgroups_node_read(info, node, ns);
+    return 0;
+} // end: cgroups_read_failed
+
+
+        /*
+         * Find a group by name, with or without that leading '/'. */
+static struct cg_node *cgroups_name2node (
+        struct cgroups_info *info,
+        const char *name)
+{
+    char path[PATH_MAX];
+
+    if (name[0] != '/') {
+        snprintf(path, sizeof(path), "/%s", name);
+        name = path;
+    }
+    return node_get(info, name);
+} // end: cgroups_name2node
+
+
+/*
+ * cgroups_stacks_alloc():
+ *
+ * Allocate and initialize one or more stacks each of which is anchored in an
+ * associated context structure.
+ *
+ * All such stacks will have their result structures properly primed with
+ * 'items', while the result itself will be zeroed.
+ *
+ * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
+ */
+static struct stacks_extent *cgroups_stacks_alloc (
+        struct ext_support *this,
+        int maxstacks)
+{
+    struct stacks_extent *p_blob;
+    struct cgroups_stack **p_vect;
+    struct cgroups_stack *p_head;
+    size_t vect_size, head_size, list_size, blob_size;
+    void *v_head, *v_list;
+    int i;
+
+    vect_size  = sizeof(void *) * maxstacks;                        // size of the addr vectors |
+    vect_size += sizeof(void *);                                    // plus NULL addr delimiter |
+    head_size  = sizeof(struct cgroups_stack);                      // size of that head struct |
+    list_size  = sizeof(struct cgroups_result) * this->numitems;    // any single results stack |
+    blob_size  = sizeof(struct stacks_extent);                      // the extent anchor itself |
+    blob_size += vect_size;                                         // plus room for addr vects |
+    blob_size += head_size * maxstacks;                             // plus room for head thing |
+    blob_size += list_size * maxstacks;                             // plus room for our stacks |
+
+    /* note: all of our memory is allocated in one single blob, facilitating some later free(). |
+             as a minimum, it's important that all of those result structs themselves always be |
+             contiguous within every stack since they will be accessed via a relative position. | */
+    if (NULL == (p_blob = calloc(1, blob_size)))
+        return NULL;
+
+    p_blob->next = this->extents;                                   // push this extent onto... |
+    this->extents = p_blob;                                         // ...some existing extents |
+    p_vect = (void *)p_blob + sizeof(struct stacks_extent);         // prime our vector pointer |
+    p_blob->stacks = p_vect;                                        // set actual vectors start |
+    v_head = (void *)p_vect + vect_size;                            // prime head pointer start |
+    v_list = v_head + (head_size * maxstacks);                      // prime our stacks pointer |
+
+    for (i = 0; i < maxstacks; i++) {
+        p_head = (struct cgroups_stack *)v_head;
+        p_head->head = cgroups_itemize_stack((struct cgroups_result *)v_list, this->numitems, this->items);
+        p_blob->stacks[i] = p_head;
+        v_list += list_size;
+        v_head += head_size;
+    }
+    p_blob->ext_numstacks = maxstacks;
+    return p_blob;
+} // end: cgroups_stacks_alloc
+
+
+static int cgroups_stacks_fetch (
+        struct cgroups_info *info)
+{
+ #define n_alloc  info->fetch.n_alloc
+ #define n_inuse  info->fetch.n_inuse
+ #define n_saved  info->fetch.n_alloc_save
+    struct stacks_extent *ext;
+    struct cg_node *node;
+
+    // initialize stuff -----------------------------------
+    if (!info->fetch.anchor) {
+        if (!(info->fetch.anchor = calloc(STACKS_INCR, sizeof(void *))))
+            return -ENOMEM;
+        n_alloc = STACKS_INCR;
+    }
+    if (!info->fetch_ext.extents) {
+        if (!(ext = cgroups_stacks_alloc(&info->fetch_ext, n_alloc)))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * n_alloc);
+    }
+
+    // iterate stuff --------------------------------------
+    n_inuse = 0;
+    node = info->nodes;
+    while (node) {
+        if (!(n_inuse < n_alloc)) {
+            n_alloc += STACKS_INCR;
+            if ((!(info->fetch.anchor = realloc(info->fetch.anchor, sizeof(void *) * n_alloc)))
+            || (!(ext = cgroups_stacks_alloc(&info->fetch_ext, STACKS_INCR))))
+                return -1;   // here, errno was set to ENOMEM
+            memcpy(info->fetch.anchor + n_inuse, ext->stacks, sizeof(void *) * STACKS_INCR);
+        }
+        cgroups_assign_results(info->fetch.anchor[n_inuse], node);
+        ++n_inuse;
+        node = node->next;
+    }
+
+    // finalize stuff -------------------------------------
+    /* note: we go to this trouble of maintaining a duplicate of the consolidated |
+             extent stacks addresses represented as our 'anchor' since these ptrs |
+             are exposed to a user (um, not that we don't trust 'em or anything). |
+             plus, we can NULL delimit these ptrs which we couldn't do otherwise. | */
+    if (n_saved < n_inuse + 1) {
+        n_saved = n_inuse + 1;
+        if (!(info->fetch.results.stacks = realloc(info->fetch.results.stacks, sizeof(void *) * n_saved)))
+            return -1;
+    }
+    memcpy(info->fetch.results.stacks, info->fetch.anchor, sizeof(void *) * n_inuse);
+    info->fetch.results.stacks[n_inuse] = NULL;
+    info->fetch.results.total = n_inuse;
+
+    return n_inuse;
+ #undef n_alloc
+ #undef n_inuse
+ #undef n_saved
+} // end: cgroups_stacks_fetch
+
+
+static int cgroups_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum cgroups_item *items,
+        int numitems)
+{
+    if (cgroups_items_check_failed(items, numitems))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum cgroups_item) * numitems)) {
+        // allow for our CGROUPS_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum cgroups_item) * (numitems + 1))))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(this->items, items, sizeof(enum cgroups_item) * numitems);
+        this->items[numitems] = CGROUPS_logical_end;
+        this->numitems = numitems + 1;
+        cgroups_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: cgroups_stacks_reconfig_maybe
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_cgroups_new():
+ *
+ * Create a new container to hold the statistics of every cgroup v2
+ * control group, from where the unified hierarchy is mounted.
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_cgroups_new (
+        struct cgroups_info **info)
+{
+    struct cgroups_info *p;
+    struct rlimit rl;
+    char path[PATH_MAX];
+
+#ifdef ITEMTABLE_DEBUG
+    int i, failed = 0;
+    for (i = 0; i < MAXTABLE(Item_table); i++) {
+        if (i != Item_table[i].enumnumb) {
+            fprintf(stderr, "%s: enum/table error: Item_table[%d] was %s, but its value is %d\n"
+                , __FILE__, i, Item_table[i].enum2str, Item_table[i].enumnumb);
+            failed = 1;
+        }
+    }
+    if (failed) _Exit(EXIT_FAILURE);
+#endif
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    // only a cgroup v2 (unified) hierarchy will have this file at its root
+    snprintf(path, sizeof(path), "%s/cgroup.controllers", CGROUP_DIR);
+    if (access(path, R_OK) < 0)
+        return -errno;
+    if (!(p = calloc(1, sizeof(struct cgroups_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    /* those fds kept open are limited to half of what's allowed us,
+       leaving plenty for the caller (any others are opened as needed) */
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY)
+        p->fds_max = rl.rlim_cur / 2;
+    else
+        p->fds_max = 512;
+    snprintf(path, sizeof(path), "%s/cgroup.stat", CGROUP_DIR);
+    p->stat_fd = open(path, O_RDONLY);
+
+    /* do a priming read here for the following potential benefits: |
+         1) ensure there will be no problems with subsequent access |
+         2) make delta results potentially useful, even if 1st time |
+         3) eliminate need for history distortion 1st time 'switch' | */
+    if (!(p->buf = malloc(CGROUPS_BUFF))
+    || cgroups_read_failed(p)) {
+        int errno_sav = errno;
+        procps_cgroups_unref(&p);
+        return -errno_sav;
+    }
+
+    *info = p;
+    return 0;
+} // end: procps_cgroups_new
+
+
+PROCPS_EXPORT int procps_cgroups_ref (
+        struct cgroups_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_cgroups_ref
+
+
+PROCPS_EXPORT int procps_cgroups_unref (
+        struct cgroups_info **info)
+{
+    struct cg_node *node;
+    unsigned i;
+
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        if ((*info)->stat_fd != -1)
+            close((*info)->stat_fd);
+        free((*info)->buf);
+        // the hash holds every node, even those a failed walk left unlinked
+        for (i = 0; i < (*info)->hashsiz; i++) {
+            while ((node = (*info)->hash[i])) {
+                (*info)->hash[i] = node->hnext;
+                node_free(*info, node);
+            }
+        }
+        free((*info)->hash);
+        if ((*info)->select_ext.extents)
+            cgroups_extents_free_all((&(*info)->select_ext));
+        if ((*info)->select_ext.items)
+            free((*info)->select_ext.items);
+
+        if ((*info)->fetch.anchor)
+            free((*info)->fetch.anchor);
+        if ((*info)->fetch.results.stacks)
+            free((*info)->fetch.results.stacks);
+
+        if ((*info)->fetch_ext.extents)
+            cgroups_extents_free_all(&(*info)->fetch_ext);
+        if ((*info)->fetch_ext.items)
+            free((*info)->fetch_ext.items);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_cgroups_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+PROCPS_EXPORT struct cgroups_result *procps_cgroups_get (
+        struct cgroups_info *info,
+        const char *name,
+        enum cgroups_item item)
+{
+    struct cg_node *node;
+    struct timespec ts;
+    unsigned long long ns;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL)
+        return NULL;
+    if (item < 0 || item >= CGROUPS_logical_end)
+        return NULL;
+    errno = 0;
+
+    info->get_this.item = item;
+    //  with 'get', we must NOT honor the usual 'noop' guarantee
+    info->get_this.result.ull_int = 0;
+
+    if (!(node = cgroups_name2node(info, name))) {
+        errno = ENXIO;
+        return NULL;
+    }
+    /* we will NOT read this group's files with every call - rather, we'll
+       offer a granularity of 1 second between reads (of the same group) ... */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    if (info->peek_from != node
+    || ns - info->peek.new.stamp_ns >= 1000000000ULL)
+        cgroups_node_peek(info, node, ns);
+    Item_table[item].setsfunc(&info->get_this, &info->peek);
+
+    return &info->get_this;
+} // end: procps_cgroups_get
+
+
+/* procps_cgroups_reap():
+ *
+ * Harvest all the requested control groups information providing
+ * the result stacks along with the total number of harvested.
+ *
+ * Returns: pointer to a cgroups_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct cgroups_reaped *procps_cgroups_reap (
+        struct cgroups_info *info,
+        enum cgroups_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > cgroups_stacks_reconfig_maybe(&info->fetch_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (cgroups_read_failed(info))
+        return NULL;
+    if (0 > cgroups_stacks_fetch(info))
+        return NULL;
+
+    return &info->fetch.results;
+} // end: procps_cgroups_reap
+
+
+/* procps_cgroups_select():
+ *
+ * Obtain all the requested information for a single control group,
+ * as found in the most recent walk, then return it in a single
+ * library provided results stack.
+ *
+ * Returns: pointer to a cgroups_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct cgroups_stack *procps_cgroups_select (
+        struct cgroups_info *info,
+        const char *name,
+        enum cgroups_item *items,
+        int numitems)
+{
+    struct cg_node *node;
+    struct timespec ts;
+
+    errno = EINVAL;
+    if (info == NULL || items == NULL || name == NULL)
+        return NULL;
+    if (0 > cgroups_stacks_reconfig_maybe(&info->select_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select_ext.extents
+    && (!cgroups_stacks_alloc(&info->select_ext, 1)))
+       return NULL;
+
+    if (!(node = cgroups_name2node(info, name))) {
+        errno = ENXIO;
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    node = cgroups_node_peek(info, node, ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+
+    cgroups_assign_results(info->select_ext.extents->stacks[0], node);
+
+    return info->select_ext.extents->stacks[0];
+} // end: procps_cgroups_select
+
+
+/*
+ * procps_cgroups_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct cgroups_stack **procps_cgroups_sort (
+        struct cgroups_info *info,
+        struct cgroups_stack *stacks[],
+        int numstacked,
+        enum cgroups_item sortitem,
+        enum cgroups_sort_order order)
+{
+    struct cgroups_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // a cgroups_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= CGROUPS_logical_end)
+        return NULL;
+    if (order != CGROUPS_SORT_ASCEND && order != CGROUPS_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= CGROUPS_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    if (!mergesort_r(stacks, numstacked, (QSR_t)Item_table[p->item].sortfunc, &parms))
+        return NULL;
+    return stacks;
+} // end: procps_cgroups_sort
+
+
+// --- special debugging function(s) ------------------------------------------
+/*
+ *  The following isn't part of the normal programming interface.  Rather,
+ *  it exists to validate result types referenced in application programs.
+ *
+ *  It's used only when:
+ *      1) the 'XTRA_PROCPS_DEBUG' has been defined, or
+ *      2) an #include of 'xtra-procps-debug.h' is used
+ */
+
+PROCPS_EXPORT struct cgroups_result *xtra_cgroups_get (
+        struct cgroups_info *info,
+        const char *name,
+        enum cgroups_item actual_enum,
+        const char *typestr,
+        const char *file,
+        int lineno)
+{
+    struct cgroups_result *r = procps_cgroups_get(info, name, actual_enum);
+
+    if (actual_enum < 0 || actual_enum >= CGROUPS_logical_end) {
+        fprintf(stderr, "%s line %d: invalid item = %d, type = %s\n"
+            , file, lineno, actual_enum, typestr);
+    }
+    if (r) {
+        char *str = Item_table[r->item].type2str;
+        if (str[0]
+        && (strcmp(typestr, str)))
+            fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return r;
+} // end: xtra_cgroups_get
+
+
+PROCPS_EXPORT struct cgroups_result *xtra_cgroups_val (
+        int relative_enum,
+        const char *typestr,
+        const struct cgroups_stack *stack,
+        const char *file,
+        int lineno)
+{
+    char *str;
+    int i;
+
+    for (i = 0; stack->head[i].item < CGROUPS_logical_end; i++)
+        ;
+    if (relative_enum < 0 || relative_enum >= i) {
+        fprintf(stderr, "%s line %d: invalid relative_enum = %d, valid range = 0-%d\n"
+            , file, lineno, relative_enum, i-1);
+        return NULL;
+    }
+    str = Item_table[stack->head[relative_enum].item].type2str;
+    if (str[0]
+    && (strcmp(typestr, str))) {
+        fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return &stack->head[relative_enum];
+} // end: xtra_cgroups_val
@@ -0,0 +1,310 @@
+/*
+ * delayacct.c - per task delay accounting, via the taskstats netlink family
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <linux/taskstats.h>
+
+#include "delayacct.h"
+
+/*
+ * The kernel answers just one task per TASKSTATS_CMD_GET, but it will accept
+ * any number of those requests in a single datagram. So, a batch of them is
+ * sent at once, and each reply is matched to its task by sequence number.
+ * A task which has since ended draws an error reply (ESRCH), while one
+ * whose reply never arrives (our receive buffer overflowed) is not found.
+ */
+
+#define BATCH_MAX    64                // requests sent per round trip
+#define REPLY_WAIT   250               // msecs allowed for a batch's replies
+#define RCVBUF_SIZ   (1024 * 1024)     // room for a whole batch of replies
+#define REPLY_SIZ    8192              // more than any single reply
+
+#define DELAYACCT_FILE  "/proc/sys/kernel/task_delayacct"
+
+struct delayacct {
+    int sock;                          // the NETLINK_GENERIC socket
+    __u16 family;                      // the TASKSTATS family id, resolved
+    __u32 seq;                         // the next request sequence number
+};
+
+struct da_request {                    // a TASKSTATS_CMD_GET, for one task
+    struct nlmsghdr nl;
+    struct genlmsghdr genl;
+    struct nlattr na;
+    __u32 id;
+};
+
+struct da_family {                     // a CTRL_CMD_GETFAMILY, by name
+    struct nlmsghdr nl;
+    struct genlmsghdr genl;
+    struct nlattr na;
+    char name[NLA_ALIGN(sizeof(TASKSTATS_GENL_NAME))];
+};
+
+#define NLA_DATA(na)  ((void *)((char *)(na) + NLA_HDRLEN))
+#define NLA_NEXT(na)  ((struct nlattr *)((char *)(na) + NLA_ALIGN((na)->nla_len)))
+#define NLA_OK(na,end) ((char *)(na) + NLA_HDRLEN <= (char *)(end) \
+    && (na)->nla_len >= NLA_HDRLEN && (char *)(na) + (na)->nla_len <= (char *)(end))
+
+
+        /*
+         * Find the first attribute of 'type' amongst those from 'na' up to
+         * 'end', or NULL. Any NLA_F_NESTED (or byte order) flag is ignored. */
+static struct nlattr *delayacct_attr (
+        struct nlattr *na,
+        void *end,
+        int type)
+{
+    for ( ; NLA_OK(na, end); na = NLA_NEXT(na))
+        if ((na->nla_type & NLA_TYPE_MASK) == type)
+            return na;
+    return NULL;
+} // end: delayacct_attr
+
+
+static inline struct nlattr *delayacct_attrs (
+        struct nlmsghdr *nl)
+{
+    return (struct nlattr *)((char *)NLMSG_DATA(nl) + GENL_HDRLEN);
+} // end: delayacct_attrs
+
+
+        /*
+         * Wait (a while) for a datagram, returning its length or -errno.
+         * A zero return means nothing arrived in time. */
+static ssize_t delayacct_recv (
+        struct delayacct *da,
+        void *buf)
+{
+    struct pollfd pfd = { .fd = da->sock, .events = POLLIN };
+    ssize_t n;
+
+    for (;;) {
+        if ((n = poll(&pfd, 1, REPLY_WAIT)) < 0) {
+            if (errno == EINTR)
+                continue;
+            return -errno;
+        }
+        if (n == 0)
+            return 0;
+        if ((n = recv(da->sock, buf, REPLY_SIZ, MSG_DONTWAIT)) < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return -errno;
+        }
+        return n;
+    }
+} // end: delayacct_recv
+
+
+static int delayacct_family (
+        struct delayacct *da)
+{
+    unsigned long buf[REPLY_SIZ / sizeof(unsigned long)];
+    struct da_family req;
+    struct nlmsghdr *nl;
+    struct nlattr *na;
+    ssize_t n;
+
+    memset(&req, 0, sizeof(req));
+    req.nl.nlmsg_len = sizeof(req);
+    req.nl.nlmsg_type = GENL_ID_CTRL;
+    req.nl.nlmsg_flags = NLM_F_REQUEST;
+    req.nl.nlmsg_seq = da->seq++;
+    req.genl.cmd = CTRL_CMD_GETFAMILY;
+    req.genl.version = 1;
+    req.na.nla_type = CTRL_ATTR_FAMILY_NAME;
+    req.na.nla_len = NLA_HDRLEN + sizeof(TASKSTATS_GENL_NAME);
+    memcpy(req.name, TASKSTATS_GENL_NAME, sizeof(TASKSTATS_GENL_NAME));
+    if (send(da->sock, &req, sizeof(req), 0) < 0)
+        return -errno;
+
+    while ((n = delayacct_recv(da, buf)) > 0) {
+        for (nl = (struct nlmsghdr *)buf; NLMSG_OK(nl, n); nl = NLMSG_NEXT(nl, n)) {
+            if (nl->nlmsg_seq != req.nl.nlmsg_seq)
+                continue;
+            if (nl->nlmsg_type == NLMSG_ERROR)
+                return ((struct nlmsgerr *)NLMSG_DATA(nl))->error;
+            if (nl->nlmsg_type != GENL_ID_CTRL)
+                continue;
+            na = delayacct_attr(delayacct_attrs(nl), (char *)nl + nl->nlmsg_len, CTRL_ATTR_FAMILY_ID);
+            if (!na || na->nla_len < NLA_HDRLEN + sizeof(__u16))
+                return -ENOENT;
+            da->family = *(__u16 *)NLA_DATA(na);
+            return 0;
+        }
+    }
+    return n < 0 ? (int)n : -ETIMEDOUT;
+} // end: delayacct_family
+
+
+        /*
+         * Extract the delays from one reply, whose stats may be shorter
+         * (an older kernel) or longer (a newer one) than our taskstats. */
+static int delayacct_parse (
+        struct nlmsghdr *nl,
+        struct delayacct_vals *v)
+{
+    void *end = (char *)nl + nl->nlmsg_len;
+    struct nlattr *na, *aggr;
+    struct taskstats ts;
+    size_t len;
+
+    if (!(aggr = delayacct_attr(delayacct_attrs(nl), end, TASKSTATS_TYPE_AGGR_PID))
+    && !(aggr = delayacct_attr(delayacct_attrs(nl), end, TASKSTATS_TYPE_AGGR_TGID)))
+        return 0;
+    end = (char *)aggr + aggr->nla_len;
+    if (!(na = delayacct_attr(NLA_DATA(aggr), end, TASKSTATS_TYPE_STATS)))
+        return 0;
+    len = na->nla_len - NLA_HDRLEN;    // (never negative, given NLA_OK)
+    memset(&ts, 0, sizeof(ts));
+    memcpy(&ts, NLA_DATA(na), len < sizeof(ts) ? len : sizeof(ts));
+    v->cpu = ts.cpu_delay_total;
+    v->blkio = ts.blkio_delay_total;
+    v->swapin = ts.swapin_delay_total;
+    v->freepages = ts.freepages_delay_total;
+    v->thrashing = ts.thrashing_delay_total;
+    v->found = 1;
+    return 1;
+} // end: delayacct_parse
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int delayacct_open (
+        struct delayacct **da)
+{
+    int fd, rc, siz = RCVBUF_SIZ;
+    char c;
+
+    /* since linux 5.14 delay accounting is off by default, whereupon
+       every total would be zero, so we won't even bother the kernel ... */
+    if ((fd = open(DELAYACCT_FILE, O_RDONLY | O_CLOEXEC)) >= 0) {
+        rc = read(fd, &c, 1);
+        close(fd);
+        if (rc == 1 && c == '0')
+            return -ENODATA;
+    }
+    if (!(*da = calloc(1, sizeof(struct delayacct))))
+        return -ENOMEM;
+    (*da)->sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if ((*da)->sock < 0) {
+        rc = -errno;
+        goto fail;
+    }
+    // this one requires CAP_NET_ADMIN, the one that follows will be capped
+    if (setsockopt((*da)->sock, SOL_SOCKET, SO_RCVBUFFORCE, &siz, sizeof(siz)) < 0)
+        setsockopt((*da)->sock, SOL_SOCKET, SO_RCVBUF, &siz, sizeof(siz));
+    (*da)->seq = 1;
+    if ((rc = delayacct_family(*da)) < 0)
+        goto fail;
+    return 0;
+
+fail:
+    delayacct_close(da);
+    return rc;
+} // end: delayacct_open
+
+
+void delayacct_close (
+        struct delayacct **da)
+{
+    if (da == NULL || *da == NULL)
+        return;
+    if ((*da)->sock >= 0)
+        close((*da)->sock);
+    free(*da);
+    *da = NULL;
+} // end: delayacct_close
+
+
+int delayacct_fetch (
+        struct delayacct *da,
+        const pid_t *ids,
+        int num,
+        int tgid,
+        struct delayacct_vals *vals)
+{
+    unsigned long buf[REPLY_SIZ / sizeof(unsigned long)];
+    struct da_request req[BATCH_MAX];
+    struct nlmsghdr *nl;
+    ssize_t len;
+    __u32 base, k;
+    int i, j, n, answered, denied, found = 0;
+
+    for (i = 0; i < num; i += n) {
+        n = (num - i < BATCH_MAX) ? num - i : BATCH_MAX;
+        base = da->seq;
+        da->seq += n;
+        memset(req, 0, sizeof(req[0]) * n);
+        for (j = 0; j < n; j++) {
+            req[j].nl.nlmsg_len = sizeof(req[0]);
+            req[j].nl.nlmsg_type = da->family;
+            req[j].nl.nlmsg_flags = NLM_F_REQUEST;
+            req[j].nl.nlmsg_seq = base + j;
+            req[j].genl.cmd = TASKSTATS_CMD_GET;
+            req[j].genl.version = TASKSTATS_GENL_VERSION;
+            req[j].na.nla_type = tgid ? TASKSTATS_CMD_ATTR_TGID : TASKSTATS_CMD_ATTR_PID;
+            req[j].na.nla_len = NLA_HDRLEN + sizeof(__u32);
+            req[j].id = ids[i + j];
+            memset(&vals[i + j], 0, sizeof(struct delayacct_vals));
+        }
+        while (send(da->sock, req, sizeof(req[0]) * n, 0) < 0) {
+            if (errno != EINTR)
+                return -errno;
+        }
+        answered = denied = 0;
+        while (answered < n) {
+            if ((len = delayacct_recv(da, buf)) < 0) {
+                if (len == -ENOBUFS)   // some replies were lost, keep the rest
+                    continue;
+                return (int)len;
+            }
+            if (len == 0)              // those remaining are simply not found
+                break;
+            for (nl = (struct nlmsghdr *)buf; NLMSG_OK(nl, len); nl = NLMSG_NEXT(nl, len)) {
+                // a late reply, from some batch abandoned earlier, is ignored
+                if ((k = nl->nlmsg_seq - base) >= (__u32)n)
+                    continue;
+                if (nl->nlmsg_type == NLMSG_ERROR) {
+                    int err = ((struct nlmsgerr *)NLMSG_DATA(nl))->error;
+                    if (err == -EPERM || err == -EACCES)
+                        ++denied;
+                    ++answered;
+                } else if (nl->nlmsg_type == da->family) {
+                    found += delayacct_parse(nl, &vals[i + k]);
+                    ++answered;
+                }
+            }
+        }
+        // without CAP_NET_ADMIN, every request is refused
+        if (denied && denied == answered)
+            return -EPERM;
+    }
+    return found;
+} // end: delayacct_fetch
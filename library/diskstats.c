@@ -44,12 +44,17 @@
    more effort than a simple 'push-down' list to duplicate prior behavior. | */
 //#define ALPHABETIC_NODES
 
-#define DISKSTATS_LINE_LEN  1024
 #define DISKSTATS_NAME_LEN  34
+#define DISKSTATS_MIN_NUMS  11           // values after the name, the oldest kernels
+#define DISKSTATS_MAX_NUMS  17           // values after the name, as of linux 5.5
+#ifndef DISKSTATS_FILE                   // (tests may substitute their own)
 #define DISKSTATS_FILE      "/proc/diskstats"
 #define SYSBLOCK_DIR        "/sys/block"
+#endif
 
+#define BUFFER_INCR         8192         // amount i/p buffer allocations grow
 #define STACKS_INCR         64           // amount reap stack allocations grow
+#define HASH_INIT           64           // initial name hash size (power of 2)
 #define STR_COMPARE         strverscmp
 
 /* ----------------------------------------------------------------------- +
@@ -72,6 +77,13 @@ struct dev_data {
     unsigned long io_inprogress;
     unsigned long io_time;
     unsigned long io_wtime;
+    unsigned long discards;
+    unsigned long discards_merged;
+    unsigned long discard_sectors;
+    unsigned long discard_time;
+    unsigned long flushes;
+    unsigned long flush_time;
+    unsigned long long stamp_ns;       // CLOCK_MONOTONIC when these were read
 };
 
 struct dev_node {
@@ -83,6 +95,7 @@ struct dev_node {
     struct dev_data new;
     struct dev_data old;
     struct dev_node *next;
+    struct dev_node *hnext;            // next in this name's hash bucket
 };
 
 struct stacks_extent {
@@ -107,10 +120,24 @@ struct fetch_support {
 
 struct diskstats_info {
     int refcount;
-    FILE *diskstats_fp;
+    int diskstats_fd;                  // the /proc/diskstats file
+    int diskstats_nopread;             // that file wasn't seekable
+    char *diskstats_buf;               // grows to hold the entire file
+    int diskstats_buf_size;            // current size of the above buffer
     time_t old_stamp;                  // previous read seconds
     time_t new_stamp;                  // current read seconds
     struct dev_node *nodes;            // dev nodes anchor
+    struct dev_node *tail;             // last of those nodes (when appending)
+    struct dev_node **hash;            // the nodes by name, via their 'hnext'
+    unsigned hashsiz;                  // buckets in above hash (a power of 2)
+    int numnodes;                      // total nodes, governing hash growth
+    unsigned long reads;               // diskstats_read_failed generation
+    char **disks;                      // sorted /sys/block names (the disks)
+    int numdisks;                      // total names in the above
+    int disks_failed;                  // /sys/block wasn't readable
+    struct timespec disks_mtime;       // /sys/block mtime when disks loaded
+    unsigned long disks_loaded;        // reads generation when disks loaded
+    unsigned long disks_checked;       // reads generation when mtime checked
     struct ext_support select_ext;     // supports concurrent select/reap
     struct ext_support fetch_ext;      // supports concurrent select/reap
     struct fetch_support fetch;        // support for procps_diskstats_reap
@@ -129,6 +156,10 @@ struct diskstats_info {
 #define REG_set(e,t,x) setDECL(e) { R->result. t = N->new. x; }
 // delta assignment
 #define HST_set(e,t,x) setDECL(e) { R->result. t = ( N->new. x - N->old. x ); }
+// rate assignment (with a new node's history equal to its current values)
+#define HST_rate(e,x) setDECL(e) { \
+    unsigned long long ns = N->new.stamp_ns - N->old.stamp_ns; \
+    R->result.real = ns ? ( N->new. x - N->old. x ) * 1.0e9 / ns : 0.0; }
 
 setDECL(noop)  { (void)R; (void)N; }
 setDECL(extra) { (void)N; R->result.ul_int = 0; }
@@ -151,6 +182,13 @@ REG_set(WEIGHTED_TIME,        ul_int,  io_wtime)
 
 REG_set(IO_INPROGRESS,        s_int,   io_inprogress)
 
+REG_set(DISCARDS,             ul_int,  discards)
+REG_set(DISCARDS_MERGED,      ul_int,  discards_merged)
+REG_set(DISCARD_SECTORS,      ul_int,  discard_sectors)
+REG_set(DISCARD_TIME,         ul_int,  discard_time)
+REG_set(FLUSHES,              ul_int,  flushes)
+REG_set(FLUSH_TIME,           ul_int,  flush_time)
+
 HST_set(DELTA_READS,          s_int,   reads)
 HST_set(DELTA_READS_MERGED,   s_int,   reads_merged)
 HST_set(DELTA_READ_SECTORS,   s_int,   read_sectors)
@@ -162,10 +200,29 @@ HST_set(DELTA_WRITE_TIME,     s_int,   write_time)
 HST_set(DELTA_IO_TIME,        s_int,   io_time)
 HST_set(DELTA_WEIGHTED_TIME,  s_int,   io_wtime)
 
+HST_set(DELTA_DISCARDS,       s_int,   discards)
+HST_set(DELTA_DISCARDS_MERGED, s_int,  discards_merged)
+HST_set(DELTA_DISCARD_SECTORS, s_int,  discard_sectors)
+HST_set(DELTA_DISCARD_TIME,   s_int,   discard_time)
+HST_set(DELTA_FLUSHES,        s_int,   flushes)
+HST_set(DELTA_FLUSH_TIME,     s_int,   flush_time)
+
+setDECL(DELTA_ELAPSED) { R->result.real = ( N->new.stamp_ns - N->old.stamp_ns ) / 1.0e9; }
+HST_rate(DELTA_READS_PER_SEC,            reads)
+HST_rate(DELTA_READS_MERGED_PER_SEC,     reads_merged)
+HST_rate(DELTA_READ_SECTORS_PER_SEC,     read_sectors)
+HST_rate(DELTA_WRITES_PER_SEC,           writes)
+HST_rate(DELTA_WRITES_MERGED_PER_SEC,    writes_merged)
+HST_rate(DELTA_WRITE_SECTORS_PER_SEC,    write_sectors)
+HST_rate(DELTA_DISCARDS_PER_SEC,         discards)
+HST_rate(DELTA_DISCARD_SECTORS_PER_SEC,  discard_sectors)
+HST_rate(DELTA_FLUSHES_PER_SEC,          flushes)
+
 #undef setDECL
 #undef DEV_set
 #undef REG_set
 #undef HST_set
+#undef HST_rate
 
 
 // ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -193,6 +250,14 @@ srtDECL(ul_int) {
     return 0;
 }
 
+srtDECL(real) {
+    const struct diskstats_result *a = (*A)->head + P->offset; \
+    const struct diskstats_result *b = (*B)->head + P->offset; \
+    if ( a->result.real > b->result.real ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.real < b->result.real ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
 srtDECL(str) {
     const struct diskstats_result *a = (*A)->head + P->offset;
     const struct diskstats_result *b = (*B)->head + P->offset;
@@ -268,6 +333,31 @@ static struct {
   { RS(DELTA_WRITE_TIME),     QS(s_int),   TS(s_int)  },
   { RS(DELTA_IO_TIME),        QS(s_int),   TS(s_int)  },
   { RS(DELTA_WEIGHTED_TIME),  QS(s_int),   TS(s_int)  },
+
+  { RS(DISCARDS),             QS(ul_int),  TS(ul_int) },
+  { RS(DISCARDS_MERGED),      QS(ul_int),  TS(ul_int) },
+  { RS(DISCARD_SECTORS),      QS(ul_int),  TS(ul_int) },
+  { RS(DISCARD_TIME),         QS(ul_int),  TS(ul_int) },
+  { RS(FLUSHES),              QS(ul_int),  TS(ul_int) },
+  { RS(FLUSH_TIME),           QS(ul_int),  TS(ul_int) },
+
+  { RS(DELTA_DISCARDS),       QS(s_int),   TS(s_int)  },
+  { RS(DELTA_DISCARDS_MERGED), QS(s_int),  TS(s_int)  },
+  { RS(DELTA_DISCARD_SECTORS), QS(s_int),  TS(s_int)  },
+  { RS(DELTA_DISCARD_TIME),   QS(s_int),   TS(s_int)  },
+  { RS(DELTA_FLUSHES),        QS(s_int),   TS(s_int)  },
+  { RS(DELTA_FLUSH_TIME),     QS(s_int),   TS(s_int)  },
+
+  { RS(DELTA_ELAPSED),                  QS(real),    TS(real)   },
+  { RS(DELTA_READS_PER_SEC),            QS(real),    TS(real)   },
+  { RS(DELTA_READS_MERGED_PER_SEC),     QS(real),    TS(real)   },
+  { RS(DELTA_READ_SECTORS_PER_SEC),     QS(real),    TS(real)   },
+  { RS(DELTA_WRITES_PER_SEC),           QS(real),    TS(real)   },
+  { RS(DELTA_WRITES_MERGED_PER_SEC),    QS(real),    TS(real)   },
+  { RS(DELTA_WRITE_SECTORS_PER_SEC),    QS(real),    TS(real)   },
+  { RS(DELTA_DISCARDS_PER_SEC),         QS(real),    TS(real)   },
+  { RS(DELTA_DISCARD_SECTORS_PER_SEC),  QS(real),    TS(real)   },
+  { RS(DELTA_FLUSHES_PER_SEC),          QS(real),    TS(real)   },
 };
 
     /* please note,
@@ -283,11 +373,51 @@ enum diskstats_item DISKSTATS_logical_end = MAXTABLE(Item_table);
 // ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
 // --- dev_node specific support ----------------------------------------------
 
+static inline unsigned node_hash (
+        const char *name)
+{
+    return procps_hash(name, strlen(name));
+} // end: node_hash
+
+
+static int node_hash_grow (
+        struct diskstats_info *info)
+{
+    unsigned newsiz = info->hashsiz ? info->hashsiz << 1 : HASH_INIT;
+    struct dev_node **hash, *node;
+    unsigned h;
+
+    if (!(hash = calloc(newsiz, sizeof(struct dev_node *))))
+        return 0;
+    for (node = info->nodes; node; node = node->next) {
+        h = node_hash(node->name) & (newsiz - 1);
+        node->hnext = hash[h];
+        hash[h] = node;
+    }
+    free(info->hash);
+    info->hash = hash;
+    info->hashsiz = newsiz;
+    return 1;
+} // end: node_hash_grow
+
+
 static struct dev_node *node_add (
         struct diskstats_info *info,
         struct dev_node *this)
 {
+#ifdef ALPHABETIC_NODES
     struct dev_node *prev, *walk;
+#endif
+    unsigned h;
+
+    // the hash grows with the nodes, keeping each chain short
+    if (info->numnodes >= (int)info->hashsiz
+    && !node_hash_grow(info))
+        return NULL;
+    h = node_hash(this->name) & (info->hashsiz - 1);
+    this->hnext = info->hash[h];
+    info->hash[h] = this;
+    ++info->numnodes;
 
 #ifdef ALPHABETIC_NODES
     if (!info->nodes
@@ -307,44 +437,113 @@ static struct dev_node *node_add (
     prev->next = this;
     this->next = walk;
 #else
+    this->next = NULL;
     if (!info->nodes)
         info->nodes = this;
-    else {
-        walk = info->nodes;
-        do {
-            prev = walk;
-            walk = walk->next;
-        } while (walk);
-        prev->next = this;
-    }
+    else
+        info->tail->next = this;
+    info->tail = this;
 #endif
     return this;
 } // end: node_add
 
 
-static void node_classify (
-        struct dev_node *this)
+static int node_disks_cmp (
+        const void *a,
+        const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+} // end: node_disks_cmp
+
+
+static void node_disks_free (
+        struct diskstats_info *info)
+{
+    while (info->numdisks)
+        free(info->disks[--info->numdisks]);
+    free(info->disks);
+    info->disks = NULL;
+} // end: node_disks_free
+
+
+static void node_disks_load (
+        struct diskstats_info *info,
+        struct stat *sb)
 {
     DIR *dirp;
     struct dirent *dent;
+    char **disks;
+    int n_alloc = 0;
+
+    node_disks_free(info);
+    info->disks_loaded = info->reads;
+    info->disks_mtime = sb->st_mtim;
+    info->disks_failed = 1;
+    if (!(dirp = opendir(SYSBLOCK_DIR)))
+        return;
+    while ((dent = readdir(dirp))) {
+        if (dent->d_name[0] == '.')
+            continue;
+        if (info->numdisks >= n_alloc) {
+            n_alloc += HASH_INIT;
+            if (!(disks = realloc(info->disks, sizeof(char *) * n_alloc)))
+                goto end_oops;
+            info->disks = disks;
+        }
+        if (!(info->disks[info->numdisks] = strdup(dent->d_name)))
+            goto end_oops;
+        ++info->numdisks;
+    }
+    qsort(info->disks, info->numdisks, sizeof(char *), node_disks_cmp);
+    info->disks_failed = 0;
+end_oops:
+    closedir(dirp);
+} // end: node_disks_load
+
+
+static void node_classify (
+        struct diskstats_info *info,
+        struct dev_node *this)
+{
+    struct stat sb;
+    const char *name = this->name;
 
     /* all disks start off as partitions. this function
        checks /sys/block and changes a device found there
        into a disk. if /sys/block cannot have the directory
-       read, all devices are then treated as disks. */
+       read, all devices are then treated as disks.
+
+       that directory's names are kept between calls, then
+       reloaded should its mtime change. but since sysfs is
+       not obliged to maintain that mtime, a name not found
+       will also prompt one reload per diskstats read ... */
     this->type = DISKSTATS_TYPE_PARTITION;
 
-    if (!(dirp = opendir(SYSBLOCK_DIR))) {
+    if (info->disks_checked != info->reads) {
+        info->disks_checked = info->reads;
+        memset(&sb, 0, sizeof(sb));
+        if (stat(SYSBLOCK_DIR, &sb) < 0
+        || !info->disks_loaded
+        || sb.st_mtim.tv_sec != info->disks_mtime.tv_sec
+        || sb.st_mtim.tv_nsec != info->disks_mtime.tv_nsec)
+            node_disks_load(info, &sb);
+    }
+    if (info->disks_failed) {
         this->type = DISKSTATS_TYPE_DISK;
         return;
     }
-    while ((dent = readdir(dirp))) {
-        if (strcmp(this->name, dent->d_name) == 0) {
+    if (bsearch(&name, info->disks, info->numdisks, sizeof(char *), node_disks_cmp)) {
+        this->type = DISKSTATS_TYPE_DISK;
+        return;
+    }
+    if (info->disks_loaded != info->reads) {
+        memset(&sb, 0, sizeof(sb));
+        stat(SYSBLOCK_DIR, &sb);
+        node_disks_load(info, &sb);
+        if (info->disks_failed
+        || bsearch(&name, info->disks, info->numdisks, sizeof(char *), node_disks_cmp))
             this->type = DISKSTATS_TYPE_DISK;
-            break;
-        }
     }
-    closedir(dirp);
 } // end: node_classify
 
 
@@ -352,16 +551,25 @@ static struct dev_node *node_cut (
         struct diskstats_info *info,
         struct dev_node *this)
 {
-    struct dev_node *node = info->nodes;
+    struct dev_node *node = info->nodes, **hp;
 
     if (this) {
+        hp = &info->hash[node_hash(this->name) & (info->hashsiz - 1)];
+        while (*hp != this)
+            hp = &(*hp)->hnext;
+        *hp = this->hnext;
+        --info->numnodes;
         if (this == node) {
             info->nodes = node->next;
+            if (info->tail == this)
+                info->tail = NULL;
             return this;
         }
         do {
             if (this == node->next) {
                 node->next = node->next->next;
+                if (info->tail == this)
+                    info->tail = node;
                 return this;
             }
             node = node->next;
@@ -375,12 +583,14 @@ static struct dev_node *node_get (
         struct diskstats_info *info,
         const char *name)
 {
-    struct dev_node *node = info->nodes;
+    struct dev_node *node = NULL;
 
+    if (info->hash)
+        node = info->hash[node_hash(name) & (info->hashsiz - 1)];
     while (node) {
         if (strcmp(name, node->name) == 0)
             break;
-        node = node->next;
+        node = node->hnext;
     }
     if (node) {
         /* if this disk or partition has somehow gotten stale, we'll lose
@@ -408,8 +618,11 @@ static int node_update (
         memcpy(target, source, sizeof(struct dev_node));
         // let's not distort the deltas when a new node is created ...
         memcpy(&target->old, &target->new, sizeof(struct dev_data));
-        node_classify(target);
-        node_add(info, target);
+        node_classify(info, target);
+        if (!node_add(info, target)) {
+            free(target);
+            return 0;
+        }
         return 1;
     }
     // remember history from last time around ...
@@ -417,6 +630,7 @@ static int node_update (
     // preserve some stuff from the existing node struct ...
     source->type = target->type;
     source->next = target->next;
+    source->hnext = target->hnext;
     // finally 'update' the existing node struct ...
     memcpy(target, source, sizeof(struct dev_node));
     return 1;
@@ -500,6 +714,93 @@ static inline int diskstats_items_check_failed (
 } // end: diskstats_items_check_failed
 
 
+        /*
+         * Parse one unsigned value, returning 0 if none was present.
+         * A (buggy kernel's) negative value wraps, as with sscanf's %lu. */
+static inline int diskstats_num (
+        char **pp,
+        unsigned long *num)
+{
+    char *p = *pp;
+    unsigned long n = 0;
+    int neg = 0;
+
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    if (*p == '-') {
+        neg = 1;
+        ++p;
+    }
+    if (*p < '0' || *p > '9')
+        return 0;
+    do
+        n = n * 10 + (*p++ - '0');
+    while (*p >= '0' && *p <= '9');
+    *num = neg ? -n : n;
+    *pp = p;
+    return 1;
+} // end: diskstats_num
+
+
+        /*
+         * Bring the entire /proc/diskstats file into our buffer, which
+         * grows as needed, so it's then parsed without stdio involvement.
+         * Returns the number of bytes read, or -1 with errno set. */
+static int diskstats_slurp (
+        struct diskstats_info *info)
+{
+ #define maxSIZ    info->diskstats_buf_size
+ #define curSIZ  ( maxSIZ - tot_read - 1 )
+ #define curPOS  ( info->diskstats_buf + tot_read )
+    int num, tot_read = 0;
+
+    if (info->diskstats_nopread && info->diskstats_fd != -1) {
+        close(info->diskstats_fd);
+        info->diskstats_fd = -1;
+    }
+    if (-1 == info->diskstats_fd
+    && (-1 == (info->diskstats_fd = open(DISKSTATS_FILE, O_RDONLY))))
+        return -1;
+    if (!info->diskstats_buf) {
+        if (!(info->diskstats_buf = malloc(BUFFER_INCR)))
+            return -1;
+        maxSIZ = BUFFER_INCR;
+    }
+    for (;;) {
+        if (info->diskstats_nopread)
+            num = read(info->diskstats_fd, curPOS, curSIZ);
+        else
+            num = pread(info->diskstats_fd, curPOS, curSIZ, tot_read);
+        if (num < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            /* a concession to libvirt lxc support, which has been
+               known to treat a /proc file as non-seekable ... */
+            if (errno == ESPIPE && !info->diskstats_nopread && !tot_read) {
+                info->diskstats_nopread = 1;
+                continue;
+            }
+            return -1;
+        }
+        tot_read += num;
+        /* seq_file hands out one page of device lines per read, so a
+           short read proves nothing. only an eof means we've got it all */
+        if (num == 0)
+            break;
+        if (curSIZ > 0)
+            continue;
+        maxSIZ += BUFFER_INCR;
+        if (!(info->diskstats_buf = realloc(info->diskstats_buf, maxSIZ)))
+            return -1;
+    }
+    info->diskstats_buf[tot_read] = '\0';
+    return tot_read;
+ #undef maxSIZ
+ #undef curSIZ
+ #undef curPOS
+} // end: diskstats_slurp
+
+
 /*
  * diskstats_read_failed:
  *
@@ -513,60 +814,80 @@ static inline int diskstats_items_check_failed (
 static int diskstats_read_failed (
         struct diskstats_info *info)
 {
-    static const char *fmtstr = "%d %d %" STRINGIFY(DISKSTATS_NAME_LEN) \
-        "s %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu";
-    char buf[DISKSTATS_LINE_LEN];
+    unsigned long v[DISKSTATS_MAX_NUMS], num;
+    unsigned long long ns;
+    struct timespec ts;
     struct dev_node node;
-    int rc;
+    char *bp, *name;
+    int i, n;
 
-    if (!info->diskstats_fp
-    && (!(info->diskstats_fp = fopen(DISKSTATS_FILE, "r"))))
+    if (diskstats_slurp(info) < 0)
         return 1;
-    else {
-        if (-1 == fseek(info->diskstats_fp, 0L, SEEK_SET)) {
-            /* a concession to libvirt lxc support, which has been
-               known to treat a /proc file as non-seekable ... */
-            if (ESPIPE != errno)
-                return 1;
-            fclose(info->diskstats_fp);
-            if (!(info->diskstats_fp = fopen(DISKSTATS_FILE, "r")))
-                return 1;
-        }
-    }
 
     info->old_stamp = info->new_stamp;
     info->new_stamp = time(NULL);
+    ++info->reads;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
 
-    while (fgets(buf, DISKSTATS_LINE_LEN, info->diskstats_fp)) {
+    /* the major, minor and name are followed by as many values as this
+       kernel provides (11, 15 or 17), then anything newer is ignored */
+    for (bp = info->diskstats_buf; *bp; bp += (*bp == '\n')) {
         // clear out the soon to be 'current'values
         memset(&node, 0, sizeof(struct dev_node));
 
-        rc = sscanf(buf, fmtstr
-            , &node.major
-            , &node.minor
-            , &node.name[0]
-            , &node.new.reads
-            , &node.new.reads_merged
-            , &node.new.read_sectors
-            , &node.new.read_time
-            , &node.new.writes
-            , &node.new.writes_merged
-            , &node.new.write_sectors
-            , &node.new.write_time
-            , &node.new.io_inprogress
-            , &node.new.io_time
-            , &node.new.io_wtime);
-
-        if (rc != 14) {
-            errno = ERANGE;
-            return 1;
-        }
+        if (!diskstats_num(&bp, &num))
+            goto bad_line;
+        node.major = num;
+        if (!diskstats_num(&bp, &num))
+            goto bad_line;
+        node.minor = num;
+        while (*bp == ' ' || *bp == '\t')
+            ++bp;
+        name = bp;
+        while (*bp && *bp != ' ' && *bp != '\t' && *bp != '\n')
+            ++bp;
+        if (!(i = bp - name))
+            goto bad_line;
+        memcpy(node.name, name, i > DISKSTATS_NAME_LEN ? DISKSTATS_NAME_LEN : i);
+
+        for (n = 0; n < DISKSTATS_MAX_NUMS && diskstats_num(&bp, &v[n]); n++)
+            ;
+        if (n < DISKSTATS_MIN_NUMS)
+            goto bad_line;
+        for (i = n; i < DISKSTATS_MAX_NUMS; i++)
+            v[i] = 0;
+        while (*bp && *bp != '\n')
+            ++bp;
+
+        node.new.reads           = v[0];
+        node.new.reads_merged    = v[1];
+        node.new.read_sectors    = v[2];
+        node.new.read_time       = v[3];
+        node.new.writes          = v[4];
+        node.new.writes_merged   = v[5];
+        node.new.write_sectors   = v[6];
+        node.new.write_time      = v[7];
+        node.new.io_inprogress   = v[8];
+        node.new.io_time         = v[9];
+        node.new.io_wtime        = v[10];
+        node.new.discards        = v[11];
+        node.new.discards_merged = v[12];
+        node.new.discard_sectors = v[13];
+        node.new.discard_time    = v[14];
+        node.new.flushes         = v[15];
+        node.new.flush_time      = v[16];
+        node.new.stamp_ns        = ns;
+
         node.stamped = info->new_stamp;
         if (!node_update(info, &node))
             return 1;        // here, errno was set to ENOMEM
     }
 
     return 0;
+bad_line:
+    errno = ERANGE;
+    return 1;
 } // end: diskstats_read_failed
 
 
@@ -743,6 +1064,7 @@ PROCPS_EXPORT int procps_diskstats_new (
         return -ENOMEM;
 
     p->refcount = 1;
+    p->diskstats_fd = -1;
 
     /* do a priming read here for the following potential benefits: |
          1) ensure there will be no problems with subsequent access |
@@ -782,16 +1104,17 @@ PROCPS_EXPORT int procps_diskstats_unref (
     if ((*info)->refcount < 1) {
         int errno_sav = errno;
 
-        if ((*info)->diskstats_fp) {
-            fclose((*info)->diskstats_fp);
-            (*info)->diskstats_fp = NULL;
-        }
+        if ((*info)->diskstats_fd != -1)
+            close((*info)->diskstats_fd);
+        free((*info)->diskstats_buf);
         node = (*info)->nodes;
         while (node) {
             struct dev_node *p = node;
             node = p->next;
             free(p);
         }
+        free((*info)->hash);
+        node_disks_free(*info);
         if ((*info)->select_ext.extents)
             diskstats_extents_free_all((&(*info)->select_ext));
         if ((*info)->select_ext.items)
@@ -0,0 +1,147 @@
+/*
+ * cgroups.h - cgroup v2 control group related declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_CGROUPS_H
+#define PROCPS_CGROUPS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum cgroups_item {
+    CGROUPS_noop,                   //        ( never altered )
+    CGROUPS_extra,                  //        ( reset to zero )
+    /*
+        note: all values are from the cgroup v2 unified hierarchy, found
+              under /sys/fs/cgroup, and are zero when a controller isn't
+              enabled for some group (or for the root, which lacks them)
+    */
+                                    //  returns        origin, see cgroups(7)
+                                    //  -------        ----------------------
+    CGROUPS_NAME,                   //      str        directory, relative to /sys/fs/cgroup ("/" is root)
+    CGROUPS_DEPTH,                  //    s_int        derived from NAME, where the root is zero
+
+    CGROUPS_CPU_USAGE_USEC,         //  ull_int        cpu.stat
+    CGROUPS_CPU_USER_USEC,          //  ull_int         "
+    CGROUPS_CPU_SYSTEM_USEC,        //  ull_int         "
+    CGROUPS_CPU_NR_PERIODS,         //  ull_int         "
+    CGROUPS_CPU_NR_THROTTLED,       //  ull_int         "
+    CGROUPS_CPU_THROTTLED_USEC,     //  ull_int         "
+
+    CGROUPS_MEM_CURRENT,            //  ull_int        memory.current
+    CGROUPS_MEM_ANON,               //  ull_int        memory.stat
+    CGROUPS_MEM_FILE,               //  ull_int         "
+    CGROUPS_MEM_KERNEL,             //  ull_int         "   ( zero before linux-5.18 )
+    CGROUPS_MEM_SHMEM,              //  ull_int         "
+    CGROUPS_MEM_PGFAULT,            //  ull_int         "
+    CGROUPS_MEM_PGMAJFAULT,         //  ull_int         "
+
+    CGROUPS_IO_RBYTES,              //  ull_int        io.stat, summed for all devices
+    CGROUPS_IO_WBYTES,              //  ull_int         "
+    CGROUPS_IO_RIOS,                //  ull_int         "
+    CGROUPS_IO_WIOS,                //  ull_int         "
+
+    CGROUPS_DELTA_CPU_USAGE_USEC,   //  ull_int        derived from above
+    CGROUPS_DELTA_CPU_USER_USEC,    //  ull_int         "
+    CGROUPS_DELTA_CPU_SYSTEM_USEC,  //  ull_int         "
+    CGROUPS_DELTA_CPU_NR_THROTTLED, //  ull_int         "
+    CGROUPS_DELTA_CPU_THROTTLED_USEC, //ull_int         "
+    CGROUPS_DELTA_MEM_PGFAULT,      //  ull_int         "
+    CGROUPS_DELTA_MEM_PGMAJFAULT,   //  ull_int         "
+    CGROUPS_DELTA_IO_RBYTES,        //  ull_int         "
+    CGROUPS_DELTA_IO_WBYTES,        //  ull_int         "
+    CGROUPS_DELTA_IO_RIOS,          //  ull_int         "
+    CGROUPS_DELTA_IO_WIOS,          //  ull_int         "
+
+    CGROUPS_DELTA_ELAPSED,              //     real   seconds between reads (CLOCK_MONOTONIC)
+    CGROUPS_DELTA_CPU_USAGE_PCT,        //     real   derived from the deltas & DELTA_ELAPSED (of one cpu)
+    CGROUPS_DELTA_CPU_THROTTLED_PCT,    //     real    "
+    CGROUPS_DELTA_IO_RBYTES_PER_SEC,    //     real    "
+    CGROUPS_DELTA_IO_WBYTES_PER_SEC     //     real    "
+};
+
+enum cgroups_sort_order {
+    CGROUPS_SORT_ASCEND   = +1,
+    CGROUPS_SORT_DESCEND  = -1
+};
+
+
+struct cgroups_result {
+    enum cgroups_item item;
+    union {
+        signed int          s_int;
+        unsigned long long  ull_int;
+        char               *str;
+        double              real;
+    } result;
+};
+
+struct cgroups_stack {
+    struct cgroups_result *head;
+};
+
+struct cgroups_reaped {
+    int total;
+    struct cgroups_stack **stacks;
+};
+
+struct cgroups_info;
+
+
+#define CGROUPS_GET( info, name, actual_enum, type ) ( { \
+    struct cgroups_result *r = procps_cgroups_get( info, name, actual_enum ); \
+    r ? r->result . type : 0; } )
+
+#define CGROUPS_VAL( relative_enum, type, stack ) \
+    stack -> head [ relative_enum ] . result . type
+
+
+int procps_cgroups_new   (struct cgroups_info **info);
+int procps_cgroups_ref   (struct cgroups_info  *info);
+int procps_cgroups_unref (struct cgroups_info **info);
+
+struct cgroups_result *procps_cgroups_get (
+    struct cgroups_info *info,
+    const char *name,
+    enum cgroups_item item);
+
+struct cgroups_reaped *procps_cgroups_reap (
+    struct cgroups_info *info,
+    enum cgroups_item *items,
+    int numitems);
+
+struct cgroups_stack *procps_cgroups_select (
+    struct cgroups_info *info,
+    const char *name,
+    enum cgroups_item *items,
+    int numitems);
+
+struct cgroups_stack **procps_cgroups_sort (
+    struct cgroups_info *info,
+    struct cgroups_stack *stacks[],
+    int numstacked,
+    enum cgroups_item sortitem,
+    enum cgroups_sort_order order);
+
+
+#ifdef XTRA_PROCPS_DEBUG
+# include "xtra-procps-debug.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,53 @@
+/*
+ * delayacct.h - per task delay accounting, via the taskstats netlink family
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PROCPS_DELAYACCT_H
+#define PROCPS_DELAYACCT_H
+
+#include <sys/types.h>
+
+struct delayacct;
+
+struct delayacct_vals {
+    unsigned long long cpu;            // cpu_delay_total, nanoseconds
+    unsigned long long blkio;          // blkio_delay_total,  "
+    unsigned long long swapin;         // swapin_delay_total, "
+    unsigned long long freepages;      // freepages_delay_total, "
+    unsigned long long thrashing;      // thrashing_delay_total, "
+    int found;                         // the kernel answered for this task
+};
+
+/*
+ * delayacct_open:
+ *   resolve the TASKSTATS generic netlink family. Returns 0 on success or
+ *   a negative errno when delay accounting is switched off (see sysctl
+ *   kernel.task_delayacct) or that family is unavailable, in which case
+ *   callers must rely on whatever /proc offers.
+ *
+ * delayacct_fetch:
+ *   obtain the delays for 'num' tids (or tgids, if 'tgid' is non-zero),
+ *   pipelined with many requests per round trip. Each 'vals[n].found' is
+ *   set when the kernel answered for 'ids[n]' (a task may have since gone).
+ *   Returns the number found, or a negative errno when no request could
+ *   succeed, as when the caller lacks CAP_NET_ADMIN (-EPERM).
+ */
+int  delayacct_open  (struct delayacct **da);
+void delayacct_close (struct delayacct **da);
+int  delayacct_fetch (struct delayacct *da, const pid_t *ids, int num, int tgid, struct delayacct_vals *vals);
+
+#endif
@@ -57,7 +57,32 @@ enum diskstats_item {
     DISKSTATS_DELTA_WRITE_SECTORS,  //    s_int         "
     DISKSTATS_DELTA_WRITE_TIME,     //    s_int         "
     DISKSTATS_DELTA_IO_TIME,        //    s_int         "
-    DISKSTATS_DELTA_WEIGHTED_TIME   //    s_int         "
+    DISKSTATS_DELTA_WEIGHTED_TIME,  //    s_int         "
+
+    DISKSTATS_DISCARDS,             //   ul_int        /proc/diskstats (4.18+)
+    DISKSTATS_DISCARDS_MERGED,      //   ul_int         "
+    DISKSTATS_DISCARD_SECTORS,      //   ul_int         "
+    DISKSTATS_DISCARD_TIME,         //   ul_int         "
+    DISKSTATS_FLUSHES,              //   ul_int        /proc/diskstats (5.5+)
+    DISKSTATS_FLUSH_TIME,           //   ul_int         "
+
+    DISKSTATS_DELTA_DISCARDS,       //    s_int        derived from above
+    DISKSTATS_DELTA_DISCARDS_MERGED,//    s_int         "
+    DISKSTATS_DELTA_DISCARD_SECTORS,//    s_int         "
+    DISKSTATS_DELTA_DISCARD_TIME,   //    s_int         "
+    DISKSTATS_DELTA_FLUSHES,        //    s_int         "
+    DISKSTATS_DELTA_FLUSH_TIME,     //    s_int         "
+
+    DISKSTATS_DELTA_ELAPSED,                  //     real   seconds between reads (CLOCK_MONOTONIC)
+    DISKSTATS_DELTA_READS_PER_SEC,            //     real   derived from the deltas & DELTA_ELAPSED
+    DISKSTATS_DELTA_READS_MERGED_PER_SEC,     //     real    "
+    DISKSTATS_DELTA_READ_SECTORS_PER_SEC,     //     real    "
+    DISKSTATS_DELTA_WRITES_PER_SEC,           //     real    "
+    DISKSTATS_DELTA_WRITES_MERGED_PER_SEC,    //     real    "
+    DISKSTATS_DELTA_WRITE_SECTORS_PER_SEC,    //     real    "
+    DISKSTATS_DELTA_DISCARDS_PER_SEC,         //     real    "
+    DISKSTATS_DELTA_DISCARD_SECTORS_PER_SEC,  //     real    "
+    DISKSTATS_DELTA_FLUSHES_PER_SEC           //     real    "
 };
 
 enum diskstats_sort_order {
@@ -72,6 +97,7 @@ struct diskstats_result {
         signed int     s_int;
         unsigned long  ul_int;
         char          *str;
+        double         real;
     } result;
 };
 
@@ -0,0 +1,121 @@
+/*
+ * interrupts.h - hard & soft interrupt related declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_INTERRUPTS_H
+#define PROCPS_INTERRUPTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum interrupts_item {
+    INTERRUPTS_noop,                //        ( never altered )
+    INTERRUPTS_extra,               //        ( reset to zero )
+                                    //  returns        origin, see proc(5)
+                                    //  -------        -------------------
+    INTERRUPTS_NAME,                //      str        /proc/interrupts or /proc/softirqs
+    INTERRUPTS_TYPE,                //    s_int         "
+    INTERRUPTS_NUMBER,              //    s_int         "   ( -1 if not a numbered irq )
+    INTERRUPTS_DESCRIPTION,         //      str        /proc/interrupts ( "" for softirqs )
+    INTERRUPTS_NUM_CPUS,            //    s_int        highest online cpu + 1, each vector's length
+    INTERRUPTS_CPU_COUNTS,          //    u_vec        /proc/interrupts or /proc/softirqs, by cpu
+    INTERRUPTS_TOTAL,               //   ull_int        "   ( all cpus )
+
+    INTERRUPTS_DELTA_CPU_COUNTS,    //    u_vec        derived from above
+    INTERRUPTS_DELTA_TOTAL,         //   ull_int         "
+    INTERRUPTS_DELTA_HOT_CPU,       //    s_int         "   ( -1 if no cpu saw a change )
+    INTERRUPTS_DELTA_HOT_CPU_COUNT, //    u_int         "
+    INTERRUPTS_DELTA_ELAPSED,       //     real        seconds between reads (CLOCK_MONOTONIC)
+    INTERRUPTS_DELTA_TOTAL_PER_SEC  //     real        derived from DELTA_TOTAL & DELTA_ELAPSED
+};
+
+enum interrupts_sort_order {
+    INTERRUPTS_SORT_ASCEND   = +1,
+    INTERRUPTS_SORT_DESCEND  = -1
+};
+
+
+struct interrupts_result {
+    enum interrupts_item item;
+    union {
+        signed int          s_int;
+        unsigned int        u_int;
+        unsigned long long  ull_int;
+        double              real;
+        char               *str;
+        unsigned int       *u_vec;
+    } result;
+};
+
+struct interrupts_stack {
+    struct interrupts_result *head;
+};
+
+struct interrupts_reaped {
+    int total;
+    struct interrupts_stack **stacks;
+};
+
+struct interrupts_info;
+
+
+#define INTERRUPTS_TYPE_IRQ       -11111
+#define INTERRUPTS_TYPE_SOFTIRQ   -22222
+
+#define INTERRUPTS_GET( info, name, actual_enum, type ) ( { \
+    struct interrupts_result *r = procps_interrupts_get( info, name, actual_enum ); \
+    r ? r->result . type : 0; } )
+
+#define INTERRUPTS_VAL( relative_enum, type, stack ) \
+    stack -> head [ relative_enum ] . result . type
+
+
+int procps_interrupts_new   (struct interrupts_info **info);
+int procps_interrupts_ref   (struct interrupts_info  *info);
+int procps_interrupts_unref (struct interrupts_info **info);
+
+struct interrupts_result *procps_interrupts_get (
+    struct interrupts_info *info,
+    const char *name,
+    enum interrupts_item item);
+
+struct interrupts_reaped *procps_interrupts_reap (
+    struct interrupts_info *info,
+    enum interrupts_item *items,
+    int numitems);
+
+struct interrupts_stack *procps_interrupts_select (
+    struct interrupts_info *info,
+    const char *name,
+    enum interrupts_item *items,
+    int numitems);
+
+struct interrupts_stack **procps_interrupts_sort (
+    struct interrupts_info *info,
+    struct interrupts_stack *stacks[],
+    int numstacked,
+    enum interrupts_item sortitem,
+    enum interrupts_sort_order order);
+
+
+#ifdef XTRA_PROCPS_DEBUG
+# include "xtra-procps-debug.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
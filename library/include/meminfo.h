@@ -174,7 +174,14 @@ enum meminfo_item {
     MEMINFO_SWAP_DELTA_CACHED,     //    s_int        derived from above
     MEMINFO_SWAP_DELTA_FREE,       //    s_int         "
     MEMINFO_SWAP_DELTA_TOTAL,      //    s_int         "
-    MEMINFO_SWAP_DELTA_USED        //    s_int         "
+    MEMINFO_SWAP_DELTA_USED,       //    s_int         "
+
+    MEMINFO_NODE_ID                //    s_int        numa node, -1 for /proc/meminfo
+};
+
+enum meminfo_sort_order {
+    MEMINFO_SORT_ASCEND   = +1,
+    MEMINFO_SORT_DESCEND  = -1
 };
 
 
@@ -190,6 +197,11 @@ struct meminfo_stack {
     struct meminfo_result *head;
 };
 
+struct meminfo_reaped {
+    int total;
+    struct meminfo_stack **stacks;
+};
+
 struct meminfo_info;
 
 
@@ -209,11 +221,29 @@ struct meminfo_result *procps_meminfo_get (
     struct meminfo_info *info,
     enum meminfo_item item);
 
+struct meminfo_reaped *procps_meminfo_reap (
+    struct meminfo_info *info,
+    enum meminfo_item *items,
+    int numitems);
+
 struct meminfo_stack *procps_meminfo_select (
     struct meminfo_info *info,
     enum meminfo_item *items,
     int numitems);
 
+struct meminfo_stack *procps_meminfo_select_node (
+    struct meminfo_info *info,
+    int node,
+    enum meminfo_item *items,
+    int numitems);
+
+struct meminfo_stack **procps_meminfo_sort (
+    struct meminfo_info *info,
+    struct meminfo_stack *stacks[],
+    int numstacked,
+    enum meminfo_item sortitem,
+    enum meminfo_sort_order order);
+
 
 #ifdef XTRA_PROCPS_DEBUG
 # include "xtra-procps-debug.h"
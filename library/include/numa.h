@@ -21,10 +21,30 @@
 #ifndef PROCPS_NUMA_H
 #define PROCPS_NUMA_H
 
+#define NUMA_NODES_MAX  1024           // the kernel's MAX_NUMNODES, at most
+
 void numa_init (void);
+void numa_refresh (void);
 void numa_uninit (void);
+int numa_nodes_online (int *ids, int max);
+
+struct numa_map {
+    struct numa_map *retired;          // the map this one replaced (if any)
+    int hwm;                           // highest node id, else -1
+    int total;                         // entries in the below
+    int nodes[];                       // each cpu's node, else -1
+};
+
+extern struct numa_map *numa_map;
+
+static inline int numa_max_node (void) {
+    return __atomic_load_n(&numa_map, __ATOMIC_ACQUIRE)->hwm;
+}
+
+static inline int numa_node_of_cpu (int cpu) {
+    const struct numa_map *m = __atomic_load_n(&numa_map, __ATOMIC_ACQUIRE);
 
-extern int (*numa_max_node) (void);
-extern int (*numa_node_of_cpu) (int);
+    return (unsigned)cpu < (unsigned)m->total ? m->nodes[cpu] : -1;
+}
 
 #endif
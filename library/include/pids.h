@@ -190,7 +190,51 @@ enum pids_item {
     PIDS_VM_SWAP,           //   ul_int        status: VmSwap
     PIDS_VM_USED,           //   ul_int        derived from status: VmRSS + VmSwap
     PIDS_VSIZE_BYTES,       //   ul_int        stat: vsize
-    PIDS_WCHAN_NAME         //      str        wchan
+    PIDS_WCHAN_NAME,        //      str        wchan
+                            // ( later additions follow, so values above never change )
+    PIDS_FLT_MAJ_RATE,              //     real        derived from FLT_MAJ_DELTA / seconds between fetches
+    PIDS_FLT_MIN_RATE,              //     real        derived from FLT_MIN_DELTA / seconds between fetches
+    PIDS_IO_READ_BYTES_DELTA,       //   ul_int        derived from IO_READ_BYTES
+    PIDS_IO_READ_BYTES_RATE,        //     real        derived from IO_READ_BYTES_DELTA / seconds between fetches
+    PIDS_IO_READ_CHARS_DELTA,       //   ul_int        derived from IO_READ_CHARS
+    PIDS_IO_READ_CHARS_RATE,        //     real        derived from IO_READ_CHARS_DELTA / seconds between fetches
+    PIDS_IO_READ_OPS_DELTA,         //   ul_int        derived from IO_READ_OPS
+    PIDS_IO_READ_OPS_RATE,          //     real        derived from IO_READ_OPS_DELTA / seconds between fetches
+    PIDS_IO_WRITE_BYTES_DELTA,      //   ul_int        derived from IO_WRITE_BYTES
+    PIDS_IO_WRITE_BYTES_RATE,       //     real        derived from IO_WRITE_BYTES_DELTA / seconds between fetches
+    PIDS_IO_WRITE_CBYTES_DELTA,     //   ul_int        derived from IO_WRITE_CBYTES
+    PIDS_IO_WRITE_CBYTES_RATE,      //     real        derived from IO_WRITE_CBYTES_DELTA / seconds between fetches
+    PIDS_IO_WRITE_CHARS_DELTA,      //   ul_int        derived from IO_WRITE_CHARS
+    PIDS_IO_WRITE_CHARS_RATE,       //     real        derived from IO_WRITE_CHARS_DELTA / seconds between fetches
+    PIDS_IO_WRITE_OPS_DELTA,        //   ul_int        derived from IO_WRITE_OPS
+    PIDS_IO_WRITE_OPS_RATE,         //     real        derived from IO_WRITE_OPS_DELTA / seconds between fetches
+    PIDS_CTXSW_INVOL,               //   ul_int        status: nonvoluntary_ctxt_switches
+    PIDS_CTXSW_INVOL_DELTA,         //   ul_int        derived from CTXSW_INVOL
+    PIDS_CTXSW_VOL,                 //   ul_int        status: voluntary_ctxt_switches
+    PIDS_CTXSW_VOL_DELTA,           //   ul_int        derived from CTXSW_VOL
+    PIDS_SCHED_RUNTIME_NS,          //  ull_int        schedstat: time on cpu, nanoseconds
+    PIDS_SCHED_RUNTIME_NS_DELTA,    //  ull_int        derived from SCHED_RUNTIME_NS
+    PIDS_SCHED_TIMESLICES,          //   ul_int        schedstat: timeslices run on a cpu
+    PIDS_SCHED_TIMESLICES_DELTA,    //   ul_int        derived from SCHED_TIMESLICES
+    PIDS_SCHED_WAIT_NS,             //  ull_int        schedstat: time waiting on a runqueue, nanoseconds
+    PIDS_SCHED_WAIT_NS_DELTA,       //  ull_int        derived from SCHED_WAIT_NS
+    PIDS_SMAP_AGE,                  //     real        derived, seconds since smaps_rollup read (-1 = never)
+    PIDS_GROUP_TASKS,               //    s_int        derived, tasks in a procps_pids_group stack (else 1)
+    PIDS_DELAY_BLKIO_NS,            //  ull_int        taskstats: blkio_delay_total, else stat: blkio_ticks
+    PIDS_DELAY_BLKIO_NS_DELTA,      //  ull_int        derived from DELAY_BLKIO_NS
+    PIDS_DELAY_CPU_NS,              //  ull_int        taskstats: cpu_delay_total, else schedstat
+    PIDS_DELAY_CPU_NS_DELTA,        //  ull_int        derived from DELAY_CPU_NS
+    PIDS_DELAY_FREEPAGES_NS,        //  ull_int        taskstats: freepages_delay_total, else zero
+    PIDS_DELAY_FREEPAGES_NS_DELTA,  //  ull_int        derived from DELAY_FREEPAGES_NS
+    PIDS_DELAY_SWAPIN_NS,           //  ull_int        taskstats: swapin_delay_total, else zero
+    PIDS_DELAY_SWAPIN_NS_DELTA,     //  ull_int        derived from DELAY_SWAPIN_NS
+    PIDS_DELAY_THRASH_NS,           //  ull_int        taskstats: thrashing_delay_total, else zero
+    PIDS_DELAY_THRASH_NS_DELTA,     //  ull_int        derived from DELAY_THRASH_NS
+    PIDS_CPUS_ALLOWED,              //     cpus        status: Cpus_allowed
+    PIDS_PROCESSOR_MIGRATED,        //    s_int        derived from PROCESSOR, changed since last fetch (0 or 1)
+    PIDS_PROCESSOR_MIGRATIONS,      //   ul_int        derived from PROCESSOR_MIGRATED, total since first fetched
+    PIDS_PROCESSOR_NODE_MIGRATED,   //    s_int        derived from PROCESSOR_NODE, changed since last fetch (0 or 1)
+    PIDS_PROCESSOR_NODE_RESIDENT    //     real        derived from PROCESSOR_NODE, seconds seen on that node
 };
                             //              *  while these are all expressed as seconds, each can be
                             //                 converted into tics/jiffies with no loss of precision
@@ -213,6 +257,12 @@ enum pids_sort_order {
 };
 
 
+struct pids_cpus {                  // shared by all tasks with the same mask
+    int count;                      // total cpus allowed
+    int numbits;                    // bits in the mask (a multiple of 32)
+    const unsigned long *mask;      // bit n is set if cpu n is allowed
+};
+
 struct pids_result {
     enum pids_item item;
     union {
@@ -224,6 +274,7 @@ struct pids_result {
         char               *str;
         char              **strv;
         double              real;
+        const struct pids_cpus *cpus;
     } result;
 };
 
@@ -247,6 +298,10 @@ struct pids_info;
 #define PIDS_VAL( relative_enum, type, stack ) \
     stack -> head [ relative_enum ] . result . type
 
+#define PIDS_CPU_ISSET( cpu, cpus ) \
+    ( (unsigned)(cpu) < (unsigned)(cpus) -> numbits \
+    && ( (cpus) -> mask [ (cpu) / (8 * sizeof(long)) ] >> ( (cpu) % (8 * sizeof(long)) ) & 1 ) )
+
 
 int procps_pids_new   (struct pids_info **info, enum pids_item *items, int numitems);
 int procps_pids_ref   (struct pids_info  *info);
@@ -282,6 +337,17 @@ struct pids_stack **procps_pids_sort (
     enum pids_item sortitem,
     enum pids_sort_order order);
 
+struct pids_fetch *procps_pids_group (
+    struct pids_info *info,
+    struct pids_stack *stacks[],
+    int numstacked,
+    enum pids_item keyitem);
+
+int procps_pids_smaps_budget (
+    struct pids_info *info,
+    int topk,
+    int budget_ms);
+
 
 #ifdef XTRA_PROCPS_DEBUG
 # include "xtra-procps-debug.h"
@@ -0,0 +1,127 @@
+/*
+ * pressure.h - pressure stall information declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_PRESSURE_H
+#define PROCPS_PRESSURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum pressure_item {
+    PRESSURE_noop,                  //        ( never altered )
+    PRESSURE_extra,                 //        ( reset to zero )
+    /*
+        note: the AVG values are percentages and TOTAL values are microseconds
+    */
+                                    //  returns        origin, see proc(5)
+                                    //  -------        -------------------
+    PRESSURE_CPU_SOME_AVG10,        //     real        /proc/pressure/cpu
+    PRESSURE_CPU_SOME_AVG60,        //     real         "
+    PRESSURE_CPU_SOME_AVG300,       //     real         "
+    PRESSURE_CPU_SOME_TOTAL,        //   ull_int        "
+    PRESSURE_CPU_FULL_AVG10,        //     real         "   ( zero before linux-5.13 )
+    PRESSURE_CPU_FULL_AVG60,        //     real         "
+    PRESSURE_CPU_FULL_AVG300,       //     real         "
+    PRESSURE_CPU_FULL_TOTAL,        //   ull_int        "
+    PRESSURE_IO_SOME_AVG10,         //     real        /proc/pressure/io
+    PRESSURE_IO_SOME_AVG60,         //     real         "
+    PRESSURE_IO_SOME_AVG300,        //     real         "
+    PRESSURE_IO_SOME_TOTAL,         //   ull_int        "
+    PRESSURE_IO_FULL_AVG10,         //     real         "
+    PRESSURE_IO_FULL_AVG60,         //     real         "
+    PRESSURE_IO_FULL_AVG300,        //     real         "
+    PRESSURE_IO_FULL_TOTAL,         //   ull_int        "
+    PRESSURE_IRQ_FULL_AVG10,        //     real        /proc/pressure/irq ( when available )
+    PRESSURE_IRQ_FULL_AVG60,        //     real         "
+    PRESSURE_IRQ_FULL_AVG300,       //     real         "
+    PRESSURE_IRQ_FULL_TOTAL,        //   ull_int        "
+    PRESSURE_MEM_SOME_AVG10,        //     real        /proc/pressure/memory
+    PRESSURE_MEM_SOME_AVG60,        //     real         "
+    PRESSURE_MEM_SOME_AVG300,       //     real         "
+    PRESSURE_MEM_SOME_TOTAL,        //   ull_int        "
+    PRESSURE_MEM_FULL_AVG10,        //     real         "
+    PRESSURE_MEM_FULL_AVG60,        //     real         "
+    PRESSURE_MEM_FULL_AVG300,       //     real         "
+    PRESSURE_MEM_FULL_TOTAL,        //   ull_int        "
+
+    PRESSURE_DELTA_CPU_SOME_TOTAL,  //   ull_int        derived from above
+    PRESSURE_DELTA_CPU_FULL_TOTAL,  //   ull_int         "
+    PRESSURE_DELTA_IO_SOME_TOTAL,   //   ull_int         "
+    PRESSURE_DELTA_IO_FULL_TOTAL,   //   ull_int         "
+    PRESSURE_DELTA_IRQ_FULL_TOTAL,  //   ull_int         "
+    PRESSURE_DELTA_MEM_SOME_TOTAL,  //   ull_int         "
+    PRESSURE_DELTA_MEM_FULL_TOTAL,  //   ull_int         "
+    PRESSURE_DELTA_ELAPSED,         //     real        seconds between reads (CLOCK_MONOTONIC)
+    PRESSURE_DELTA_CPU_SOME_PCT,    //     real        derived from the delta & DELTA_ELAPSED
+    PRESSURE_DELTA_CPU_FULL_PCT,    //     real         "
+    PRESSURE_DELTA_IO_SOME_PCT,     //     real         "
+    PRESSURE_DELTA_IO_FULL_PCT,     //     real         "
+    PRESSURE_DELTA_IRQ_FULL_PCT,    //     real         "
+    PRESSURE_DELTA_MEM_SOME_PCT,    //     real         "
+    PRESSURE_DELTA_MEM_FULL_PCT     //     real         "
+};
+
+
+struct pressure_result {
+    enum pressure_item item;
+    union {
+        unsigned long long  ull_int;
+        double              real;
+    } result;
+};
+
+struct pressure_stack {
+    struct pressure_result *head;
+};
+
+struct pressure_info;
+
+
+#define PRESSURE_GET( info, actual_enum, type ) ( { \
+    struct pressure_result *r = procps_pressure_get( info, actual_enum ); \
+    r ? r->result . type : 0; } )
+
+#define PRESSURE_VAL( relative_enum, type, stack ) \
+    stack -> head [ relative_enum ] . result . type
+
+
+int procps_pressure_new   (struct pressure_info **info);
+int procps_pressure_ref   (struct pressure_info  *info);
+int procps_pressure_unref (struct pressure_info **info);
+
+int procps_pressure_new_cgroup (
+    struct pressure_info **info,
+    const char *cgroup);
+
+struct pressure_result *procps_pressure_get (
+    struct pressure_info *info,
+    enum pressure_item item);
+
+struct pressure_stack *procps_pressure_select (
+    struct pressure_info *info,
+    enum pressure_item *items,
+    int numitems);
+
+
+#ifdef XTRA_PROCPS_DEBUG
+# include "xtra-procps-debug.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,47 @@
+/*
+ * procevents.h - a live tgid set, maintained from cn_proc fork events
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PROCPS_PROCEVENTS_H
+#define PROCPS_PROCEVENTS_H
+
+#include <sys/types.h>
+
+struct procevents;
+
+/*
+ * procevents_open:
+ *   subscribe to the kernel's process events connector, then seed the set
+ *   with one scan of /proc.  Returns 0 on success or a negative errno when
+ *   that connector is unavailable (not built, unprivileged, or not in the
+ *   initial pid namespace), in which case callers just scan /proc instead.
+ *
+ * procevents_pids:
+ *   consume any pending events then return the number of tgids currently
+ *   thought to be alive, with 'pids' pointing to them in ascending order.
+ *   Should events ever be lost, /proc is quietly rescanned.
+ *
+ * procevents_gone:
+ *   remove a tgid from the set after its /proc/<pid> could not be read.
+ *   Exit events are deliberately ignored, so zombies remain until reaped.
+ */
+int  procevents_open  (struct procevents **ev);
+void procevents_close (struct procevents **ev);
+int  procevents_pids  (struct procevents *ev, pid_t **pids);
+void procevents_gone  (struct procevents *ev, pid_t pid);
+
+#endif
@@ -18,6 +18,8 @@
 #ifndef PROCPS_PRIVATE_H
 #define PROCPS_PRIVATE_H
 
+#include <stddef.h>
+
 #define PROCPS_EXPORT __attribute__ ((visibility("default")))
 
 #define STRINGIFY_ARG(a)	#a
@@ -25,4 +27,16 @@
 
 #define MAXTABLE(t)		(int)(sizeof(t) / sizeof(t[0]))
 
+	/*
+	 * The FNV-1a hash of 'len' bytes, as used by those modules which
+	 * intern names or file contents (with a power of 2 bucket count). */
+static inline unsigned procps_hash (const char *buf, size_t len)
+{
+    unsigned h = 2166136261u;
+
+    while (len--)
+        h = (h ^ (unsigned char)*buf++) * 16777619u;
+    return h;
+}
+
 #endif
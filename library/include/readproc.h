@@ -40,6 +40,8 @@
 // neither tgid nor tid seemed correct. (in other words, FIXME)
 #define XXXID tid
 
+struct pids_cpus;               // see pids.h, shared by tasks (never freed by users)
+
 // Basic data structure which holds all information we can get about a process.
 // (unless otherwise specified, fields are read from /proc/#/stat)
 //
@@ -143,7 +145,13 @@ typedef struct proc_t {
         smap_Private_Hugetlb,  //    "     hugetlbfs backed memory *not* counted in Rss/Pss
         smap_Swap,             //    "     swapped would-be-anonymous memory (includes swapped out shmem)
         smap_SwapPss,          //    "     the proportional share of 'Swap' (excludes swapped out shmem)
-        smap_Locked;           //    "     memory amount locked to RAM
+        smap_Locked,           //    "     memory amount locked to RAM
+        sched_slices,   // schedstat       number of timeslices run on this cpu
+        ctxsw_vol,      // status          voluntary context switches
+        ctxsw_invol;    // status          involuntary context switches
+    unsigned long long
+        sched_runtime,  // schedstat       time spent on the cpu (in nanoseconds)
+        sched_wait;     // schedstat       time spent waiting on a runqueue (in nanoseconds)
     char
         *environ,       // (special)       environment as string (/proc/#/environ)
         *cmdline,       // (special)       command line as string (/proc/#/cmdline)
@@ -203,6 +211,8 @@ typedef struct proc_t {
         autogrp_id,     // autogroup       autogroup number (id)
         autogrp_nice,   // autogroup       autogroup nice value
         fds;            // fd              number of open files
+    const struct pids_cpus
+        *cpus;          // status          Cpus_allowed, as an interned bitmap
 } proc_t;
 
 // PROCTAB: data structure holding the persistent information readproc needs
@@ -211,6 +221,17 @@ typedef struct proc_t {
 
 #define PROCPATHLEN 64  // must hold /proc/2000222000/task/2000222000/cmdline
 
+// For PROC_PINNED, a 0 pid terminated array of these replaces the pid_t list.
+// Each /proc/<pid> directory (and the tgid) is retained from call to call,
+// except 'once' entries whose tgid is known but whose directory is not kept.
+// Each pin is a process: a thread's id is pinned as its thread group instead.
+typedef struct PINTAB {
+    pid_t       pid;            // a requested pid (or 0 for the array's end)
+    pid_t       tgid;           // its tgid, once known (else 0)
+    int         dirfd;          // pinned FD for the /proc/<pid> directory
+    int         once;           // not retained, closed when the finder moves on
+} PINTAB;
+
 typedef struct PROCTAB {
     int         pidfd;          // FD for the /proc/<pid> directory
     int         taskfd;         // FD for the /proc/<pid>/tasks/<tid> directory
@@ -224,11 +245,15 @@ typedef struct PROCTAB {
     int(*taskfinder)(struct PROCTAB *__restrict const, const proc_t *__restrict const, proc_t *__restrict const);
     proc_t*(*taskreader)(struct PROCTAB *__restrict const, proc_t *__restrict const);
     pid_t      *pids;   // pids of the procs
+    PINTAB     *pins;   // pinned pids of the procs (see PROC_PINNED)
     uid_t      *uids;   // uids of procs
     int         nuid;   // cannot really sentinel-terminate unsigned short[]
     int         i;  // generic
     int         hide_kernel;  // getenv LIBPROC_HIDE_KERNEL was set
     unsigned    flags;
+    int(*smaps_gate)(struct PROCTAB *__restrict const, const proc_t *__restrict const); // optional, can skip smaps_rollup
+    void       *gate_data;      // for use by any smaps_gate
+    unsigned long long smaps_ns; // time spent reading a gated smaps_rollup
 } PROCTAB;
 
 
@@ -281,19 +306,20 @@ typedef struct PROCTAB {
 #define PROC_FILLAUTOGRP     0x01000000 // fill in proc_t autogroup stuff
 #define PROC_FILL_DOCKER     0x02000000 // fill in proc_t dockerid, if possible
 #define PROC_FILL_FDS        0x04000000 // fill in proc_t fds
+#define PROC_PINNED          0x08000000 // with PROC_PID, a PINTAB array is passed
+#define PROC_FILLSCHED       0x10000000 // fill in proc_t schedstat stuff
+#define PROC_FILL_CPUS     ( 0x40000000 | PROC_FILLSTATUS ) // fill in proc_t cpus
 
 // it helps to give app code a few spare bits
-#define PROC_SPARE_1         0x10000000
 #define PROC_SPARE_2         0x20000000
-#define PROC_SPARE_3         0x40000000
 #define PROC_SPARE_4         0x80000000
 
-/* available PROC bits ...   0x.8......
-   ( when this one is used, we'll need a 'flags2' addition to PROCTAB ) */
+/* available PROC bits ...   ( none )
+   ( any new flag will now need a 'flags2' addition to the PROCTAB ) */
 
 // Function definitions
 // Initialize a PROCTAB structure holding needed call-to-call persistent data
-PROCTAB *openproc(unsigned flags, ... /* pid_t *| uid_t *| dev_t *| char *[, int n] */ );
+PROCTAB *openproc(unsigned flags, ... /* pid_t *| PINTAB *| uid_t *| dev_t *| char *[, int n] */ );
 // Retrieve the next process or task matching the criteria set by the openproc().
 //
 // Note: When NULL is used as the readproc 'p' or readeither 'x'
@@ -312,7 +338,10 @@ char **vectorize_this_str(const char *src);
 
 struct utlbuf_s;
 struct docker_ids;
+struct cgroup_ele;
 char *lxc_containers(struct utlbuf_s *ub);
 struct docker_ids *docker_containers(struct utlbuf_s *ub);
+struct cgroup_ele *cgroup_interned(int dirfd, struct utlbuf_s *ub);
+const struct pids_cpus *cpus_interned(const char *mask);
 
 #endif
@@ -66,7 +66,13 @@ enum slabinfo_item {
     SLABS_DELTA_ACTIVE_SLABS,   //    s_int         "
     SLABS_DELTA_PAGES_TOTAL,    //    s_int         "
     SLABS_DELTA_SIZE_ACTIVE,    //    s_int         "
-    SLABS_DELTA_SIZE_TOTAL      //    s_int         "
+    SLABS_DELTA_SIZE_TOTAL,     //    s_int         "
+
+    SLAB_DELTA_NUM_OBJS,        //    s_int        derived from SLAB items, since the prior read
+    SLAB_DELTA_ACTIVE_OBJS,     //    s_int         "
+    SLAB_DELTA_NUMS_SLABS,      //    s_int         "
+    SLAB_DELTA_ACTIVE_SLABS,    //    s_int         "
+    SLAB_DELTA_SIZE_TOTAL       //   sl_int         "
 };
 
 enum slabinfo_sort_order {
@@ -80,6 +86,7 @@ struct slabinfo_result {
     union {
         signed int     s_int;
         unsigned int   u_int;
+        signed long    sl_int;
         unsigned long  ul_int;
         char          *str;
     } result;
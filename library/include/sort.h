@@ -30,6 +30,9 @@
  *
  * but, we return 1 on success, 0 on malloc failure!
  *
+ * Being a 'natural' mergesort, any runs already in order are
+ * preserved, so nearly sorted input costs close to n compares.
+ *
  * Attention:
  *   This guy deals EXCLUSIVELY with sorting pointers,
  *   implied by the absence of that qsort 'size' parm!
@@ -82,7 +82,27 @@ enum stat_item {
     STAT_SYS_DELTA_INTERRUPTS,    //    s_int         "
     STAT_SYS_DELTA_PROC_BLOCKED,  //    s_int         "
     STAT_SYS_DELTA_PROC_CREATED,  //    s_int         "
-    STAT_SYS_DELTA_PROC_RUNNING   //    s_int         "
+    STAT_SYS_DELTA_PROC_RUNNING,  //    s_int         "
+
+    STAT_SYS_DELTA_ELAPSED,                  //     real   seconds between reads (CLOCK_MONOTONIC)
+    STAT_SYS_DELTA_CTX_SWITCHES_PER_SEC,     //     real   derived from the deltas & DELTA_ELAPSED
+    STAT_SYS_DELTA_INTERRUPTS_PER_SEC,       //     real    "
+    STAT_SYS_DELTA_PROC_CREATED_PER_SEC,     //     real    "
+
+    STAT_TIC_DELTA_USER_PCT,                 //     real   TIC_DELTA_USER as a % of DELTA_ELAPSED
+    STAT_TIC_DELTA_NICE_PCT,                 //     real    " (per cpu, see TIC_NUM_CONTRIBUTORS)
+    STAT_TIC_DELTA_SYSTEM_PCT,               //     real    "
+    STAT_TIC_DELTA_IDLE_PCT,                 //     real    "
+    STAT_TIC_DELTA_IOWAIT_PCT,               //     real    "
+    STAT_TIC_DELTA_IRQ_PCT,                  //     real    "
+    STAT_TIC_DELTA_SOFTIRQ_PCT,              //     real    "
+    STAT_TIC_DELTA_STOLEN_PCT,               //     real    "
+    STAT_TIC_DELTA_GUEST_PCT,                //     real    "
+    STAT_TIC_DELTA_GUEST_NICE_PCT,           //     real    "
+    STAT_TIC_SUM_DELTA_USER_PCT,             //     real    "
+    STAT_TIC_SUM_DELTA_SYSTEM_PCT,           //     real    "
+    STAT_TIC_SUM_DELTA_IDLE_PCT,             //     real    "
+    STAT_TIC_SUM_DELTA_BUSY_PCT              //     real    "
 };
 
 enum stat_reap_type {
@@ -103,6 +123,7 @@ struct stat_result {
         signed long         sl_int;
         unsigned long       ul_int;
         unsigned long long  ull_int;
+        double              real;
     } result;
 };
 
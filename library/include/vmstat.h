@@ -332,15 +332,42 @@ enum vmstat_item {
     VMSTAT_DELTA_WORKINGSET_NODES,                //   sl_int         "
     VMSTAT_DELTA_WORKINGSET_REFAULT,              //   sl_int         "
     VMSTAT_DELTA_WORKINGSET_RESTORE,              //   sl_int         "
-    VMSTAT_DELTA_ZONE_RECLAIM_FAILED              //   sl_int         "
+    VMSTAT_DELTA_ZONE_RECLAIM_FAILED,             //   sl_int         "
+
+    VMSTAT_DELTA_ELAPSED,                         //     real   seconds between reads (CLOCK_MONOTONIC)
+    VMSTAT_DELTA_PGPGIN_PER_SEC,                  //     real   derived from the delta & DELTA_ELAPSED
+    VMSTAT_DELTA_PGPGOUT_PER_SEC,                 //     real    "
+    VMSTAT_DELTA_PSWPIN_PER_SEC,                  //     real    "
+    VMSTAT_DELTA_PSWPOUT_PER_SEC,                 //     real    "
+    VMSTAT_DELTA_PGFAULT_PER_SEC,                 //     real    "
+    VMSTAT_DELTA_PGMAJFAULT_PER_SEC,              //     real    "
+    VMSTAT_DELTA_PGFREE_PER_SEC,                  //     real    "
+    VMSTAT_DELTA_PGSCAN_KSWAPD_PER_SEC,           //     real    "
+    VMSTAT_DELTA_PGSCAN_DIRECT_PER_SEC,           //     real    "
+    VMSTAT_DELTA_PGSTEAL_KSWAPD_PER_SEC,          //     real    "
+    VMSTAT_DELTA_PGSTEAL_DIRECT_PER_SEC,          //     real    "
+    VMSTAT_DELTA_ALLOCSTALL_NORMAL_PER_SEC,       //     real    "
+    VMSTAT_DELTA_COMPACT_STALL_PER_SEC,           //     real    "
+    VMSTAT_DELTA_OOM_KILL_PER_SEC,                //     real    "
+    VMSTAT_DELTA_THP_FAULT_ALLOC_PER_SEC,         //     real    "
+    VMSTAT_DELTA_WORKINGSET_REFAULT_PER_SEC,      //     real    "
+
+    VMSTAT_NODE_ID                                //    s_int   numa node, -1 for /proc/vmstat
+};
+
+enum vmstat_sort_order {
+    VMSTAT_SORT_ASCEND   = +1,
+    VMSTAT_SORT_DESCEND  = -1
 };
 
 
 struct vmstat_result {
     enum vmstat_item item;
     union {
+        signed int     s_int;
         signed long    sl_int;
         unsigned long  ul_int;
+        double         real;
     } result;
 };
 
@@ -348,6 +375,11 @@ struct vmstat_stack {
     struct vmstat_result *head;
 };
 
+struct vmstat_reaped {
+    int total;
+    struct vmstat_stack **stacks;
+};
+
 struct vmstat_info;
 
 
@@ -367,11 +399,29 @@ struct vmstat_result *procps_vmstat_get (
     struct vmstat_info *info,
     enum vmstat_item item);
 
+struct vmstat_reaped *procps_vmstat_reap (
+    struct vmstat_info *info,
+    enum vmstat_item *items,
+    int numitems);
+
 struct vmstat_stack *procps_vmstat_select (
     struct vmstat_info *info,
     enum vmstat_item *items,
     int numitems);
 
+struct vmstat_stack *procps_vmstat_select_node (
+    struct vmstat_info *info,
+    int node,
+    enum vmstat_item *items,
+    int numitems);
+
+struct vmstat_stack **procps_vmstat_sort (
+    struct vmstat_info *info,
+    struct vmstat_stack *stacks[],
+    int numstacked,
+    enum vmstat_item sortitem,
+    enum vmstat_sort_order order);
+
 
 #ifdef XTRA_PROCPS_DEBUG
 # include "xtra-procps-debug.h"
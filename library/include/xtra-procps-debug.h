@@ -22,6 +22,39 @@
 #define STRINGIFY(a) STRINGIFY_ARG(a)
 
 
+// --- CGROUPS --------------------------------------------
+#if defined(PROCPS_CGROUPS_H) && !defined(PROCPS_CGROUPS_H_DEBUG)
+#define PROCPS_CGROUPS_H_DEBUG
+
+struct cgroups_result *xtra_cgroups_get (
+    struct cgroups_info *info,
+    const char *name,
+    enum cgroups_item actual_enum,
+    const char *typestr,
+    const char *file,
+    int lineno);
+
+# undef CGROUPS_GET
+#define CGROUPS_GET( info, name, actual_enum, type ) ( { \
+    struct cgroups_result *r; \
+    r = xtra_cgroups_get(info, name, actual_enum , STRINGIFY(type), __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+
+struct cgroups_result *xtra_cgroups_val (
+    int relative_enum,
+    const char *typestr,
+    const struct cgroups_stack *stack,
+    const char *file,
+    int lineno);
+
+# undef CGROUPS_VAL
+#define CGROUPS_VAL( relative_enum, type, stack ) ( { \
+    struct cgroups_result *r; \
+    r = xtra_cgroups_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+#endif // . . . . . . . . . .
+
+
 // --- DISKSTATS ------------------------------------------
 #if defined(PROCPS_DISKSTATS_H) && !defined(PROCPS_DISKSTATS_H_DEBUG)
 #define PROCPS_DISKSTATS_H_DEBUG
@@ -55,6 +88,39 @@ struct diskstats_result *xtra_diskstats_val (
 #endif // . . . . . . . . . .
 
 
+// --- INTERRUPTS -----------------------------------------
+#if defined(PROCPS_INTERRUPTS_H) && !defined(PROCPS_INTERRUPTS_H_DEBUG)
+#define PROCPS_INTERRUPTS_H_DEBUG
+
+struct interrupts_result *xtra_interrupts_get (
+    struct interrupts_info *info,
+    const char *name,
+    enum interrupts_item actual_enum,
+    const char *typestr,
+    const char *file,
+    int lineno);
+
+# undef INTERRUPTS_GET
+#define INTERRUPTS_GET( info, name, actual_enum, type ) ( { \
+    struct interrupts_result *r; \
+    r = xtra_interrupts_get(info, name, actual_enum , STRINGIFY(type), __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+
+struct interrupts_result *xtra_interrupts_val (
+    int relative_enum,
+    const char *typestr,
+    const struct interrupts_stack *stack,
+    const char *file,
+    int lineno);
+
+# undef INTERRUPTS_VAL
+#define INTERRUPTS_VAL( relative_enum, type, stack ) ( { \
+    struct interrupts_result *r; \
+    r = xtra_interrupts_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+#endif // . . . . . . . . . .
+
+
 // --- MEMINFO --------------------------------------------
 #if defined(PROCPS_MEMINFO_H) && !defined(PROCPS_MEMINFO_H_DEBUG)
 #define PROCPS_MEMINFO_H_DEBUG
@@ -106,6 +172,38 @@ struct pids_result *xtra_pids_val (
 #endif // . . . . . . . . . .
 
 
+// --- PRESSURE -------------------------------------------
+#if defined(PROCPS_PRESSURE_H) && !defined(PROCPS_PRESSURE_H_DEBUG)
+#define PROCPS_PRESSURE_H_DEBUG
+
+struct pressure_result *xtra_pressure_get (
+    struct pressure_info *info,
+    enum pressure_item actual_enum,
+    const char *typestr,
+    const char *file,
+    int lineno);
+
+# undef PRESSURE_GET
+#define PRESSURE_GET( info, actual_enum, type ) ( { \
+    struct pressure_result *r; \
+    r = xtra_pressure_get(info, actual_enum , STRINGIFY(type), __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+
+struct pressure_result *xtra_pressure_val (
+    int relative_enum,
+    const char *typestr,
+    const struct pressure_stack *stack,
+    const char *file,
+    int lineno);
+
+# undef PRESSURE_VAL
+#define PRESSURE_VAL( relative_enum, type, stack ) ( { \
+    struct pressure_result *r; \
+    r = xtra_pressure_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+#endif // . . . . . . . . . .
+
+
 // --- SLABINFO -------------------------------------------
 #if defined(PROCPS_SLABINFO_H) && !defined(PROCPS_SLABINFO_H_DEBUG)
 #define PROCPS_SLABINFO_H_DEBUG
@@ -0,0 +1,1195 @@
+/*
+ * interrupts.c - hard & soft interrupt related definitions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sort.h"
+
+#include "procps-private.h"
+#include "interrupts.h"
+
+#define INTERRUPTS_NAME_LEN  31
+#ifndef INTERRUPTS_FILE                  // (tests may substitute their own)
+#define INTERRUPTS_FILE      "/proc/interrupts"
+#define SOFTIRQS_FILE        "/proc/softirqs"
+#endif
+
+#define BUFFER_INCR          65536       // amount i/p buffer allocations grow
+#define STACKS_INCR          64          // amount reap stack allocations grow
+#define NODES_INCR           64          // amount node array allocations grow
+#define STR_COMPARE          strverscmp
+
+/* ----------------------------------------------------------------------- +
+   this provision can help ensure that our Item_table remains synchronized |
+   with the enumerators found in the associated header file. It's intended |
+   to only be used locally (& temporarily) at some point before a release! | */
+// #define ITEMTABLE_DEBUG //--------------------------------------------- |
+// ----------------------------------------------------------------------- +
+
+
+/*
+ * Each line of either file becomes an irq_node, with the per-cpu values
+ * held in just two vectors (indexed by cpu number, not by file column).
+ * While a line is parsed, every new count replaces the prior delta and
+ * the delta replaces the prior count, whereupon the two are exchanged.
+ * So no history need be copied, whatever the number of cpus.
+ *
+ * A node only lives as long as its file's cpu columns remain unchanged.
+ * When a cpu comes or goes, every node from that file is started anew
+ * (with zero deltas) rather than have a vector's length or meaning shift.
+ */
+struct irq_node {
+    char name[INTERRUPTS_NAME_LEN+1];
+    int name_len;
+    int type;                          // INTERRUPTS_TYPE_IRQ or _SOFTIRQ
+    int number;                        // the irq number, if it had one
+    char *desc;                        // what follows the counts, or ""
+    unsigned gen;                      // irq_file cpus_gen when created
+    int ncpus;                         // length of both vectors below
+    unsigned *cpus;                    // current counts, by cpu number
+    unsigned *deltas;                  // changes in the above counts
+    unsigned long long total;          // sum of the current counts
+    unsigned long long delta_total;    // sum of the deltas
+    int hot_cpu;                       // cpu number with the largest delta
+    unsigned hot_count;                // and the delta itself
+    unsigned long long new_ns;         // CLOCK_MONOTONIC when these were read
+    unsigned long long old_ns;         // and when the prior values were read
+};
+
+struct irq_file {
+    const char *path;                  // /proc/interrupts or /proc/softirqs
+    int type;                          // the node type for all of its lines
+    int fd;                            // that open file
+    int nopread;                       // that file wasn't seekable
+    int *cols;                         // cpu number for each column
+    int numcols;                       // total columns (online cpus)
+    int alloc_cols;                    // number of above cols allocated
+    int ncpus;                         // highest cpu number + 1
+    unsigned cpus_gen;                 // bumped whenever the columns change
+};
+
+struct stacks_extent {
+    int ext_numstacks;
+    struct stacks_extent *next;
+    struct interrupts_stack **stacks;
+};
+
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum interrupts_item *items;       // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for these extents
+};
+
+struct fetch_support {
+    struct interrupts_stack **anchor;  // fetch consolidated extents
+    int n_alloc;                       // number of above pointers allocated
+    int n_inuse;                       // number of above pointers occupied
+    int n_alloc_save;                  // last known reap.stacks allocation
+    struct interrupts_reaped results;  // count + stacks for return to caller
+};
+
+struct interrupts_info {
+    int refcount;
+    struct irq_file files[2];          // interrupts, then softirqs
+    char *buf;                         // grows to hold either entire file
+    int buf_size;                      // current size of the above buffer
+    time_t new_stamp;                  // current read seconds
+    struct irq_node **nodes;           // the nodes, in file order
+    int numnodes;                      // total nodes in the above
+    int alloc_nodes;                   // number of above nodes allocated
+    struct irq_node **prior;           // the nodes, as of the prior read
+    int numprior;                      // total nodes in the above
+    int alloc_prior;                   // number of above prior allocated
+    int hint;                          // where in 'prior' to look next
+    struct ext_support select_ext;     // supports concurrent select/reap
+    struct ext_support fetch_ext;      // supports concurrent select/reap
+    struct fetch_support fetch;        // support for procps_interrupts_reap
+    struct interrupts_result get_this; // used by procps_interrupts_get
+};
+
+
+// ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+#define setNAME(e) set_interrupts_ ## e
+#define setDECL(e) static void setNAME(e) \
+    (struct interrupts_result *R, struct irq_node *N)
+
+// regular assignment
+#define REG_set(e,t,x) setDECL(e) { R->result. t = N-> x; }
+
+setDECL(noop)  { (void)R; (void)N; }
+setDECL(extra) { (void)N; R->result.ull_int = 0; }
+
+REG_set(NAME,                 str,      name)
+REG_set(TYPE,                 s_int,    type)
+REG_set(NUMBER,               s_int,    number)
+REG_set(DESCRIPTION,          str,      desc)
+REG_set(NUM_CPUS,             s_int,    ncpus)
+REG_set(CPU_COUNTS,           u_vec,    cpus)
+REG_set(TOTAL,                ull_int,  total)
+
+REG_set(DELTA_CPU_COUNTS,     u_vec,    deltas)
+REG_set(DELTA_TOTAL,          ull_int,  delta_total)
+REG_set(DELTA_HOT_CPU,        s_int,    hot_cpu)
+REG_set(DELTA_HOT_CPU_COUNT,  u_int,    hot_count)
+setDECL(DELTA_ELAPSED) { R->result.real = ( N->new_ns - N->old_ns ) / 1.0e9; }
+setDECL(DELTA_TOTAL_PER_SEC) {
+    unsigned long long ns = N->new_ns - N->old_ns;
+    R->result.real = ns ? N->delta_total * 1.0e9 / ns : 0.0; }
+
+#undef setDECL
+#undef REG_set
+
+
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum interrupts_sort_order order;
+};
+
+#define srtNAME(t) sort_interrupts_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct interrupts_stack **A, const struct interrupts_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct interrupts_result *a = (*A)->head + P->offset; \
+    const struct interrupts_result *b = (*B)->head + P->offset; \
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(u_int) {
+    const struct interrupts_result *a = (*A)->head + P->offset; \
+    const struct interrupts_result *b = (*B)->head + P->offset; \
+    if ( a->result.u_int > b->result.u_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.u_int < b->result.u_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(ull_int) {
+    const struct interrupts_result *a = (*A)->head + P->offset; \
+    const struct interrupts_result *b = (*B)->head + P->offset; \
+    if ( a->result.ull_int > b->result.ull_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.ull_int < b->result.ull_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(real) {
+    const struct interrupts_result *a = (*A)->head + P->offset; \
+    const struct interrupts_result *b = (*B)->head + P->offset; \
+    if ( a->result.real > b->result.real ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.real < b->result.real ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(str) {
+    const struct interrupts_result *a = (*A)->head + P->offset;
+    const struct interrupts_result *b = (*B)->head + P->offset;
+    return P->order * STR_COMPARE(a->result.str, b->result.str);
+}
+
+srtDECL(noop) { \
+    (void)A; (void)B; (void)P; \
+    return 0;
+}
+
+#undef srtDECL
+
+
+// ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+typedef void (*SET_t)(struct interrupts_result *, struct irq_node *);
+#ifdef ITEMTABLE_DEBUG
+#define RS(e) (SET_t)setNAME(e), INTERRUPTS_ ## e, STRINGIFY(INTERRUPTS_ ## e)
+#else
+#define RS(e) (SET_t)setNAME(e)
+#endif
+
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
+#define TS(t) STRINGIFY(t)
+#define TS_noop ""
+
+        /*
+         * Need it be said?
+         * This table must be kept in the exact same order as
+         * those *enum interrupts_item* guys ! */
+static struct {
+    SET_t setsfunc;              // the actual result setting routine
+#ifdef ITEMTABLE_DEBUG
+    int   enumnumb;              // enumerator (must match position!)
+    char *enum2str;              // enumerator name as a char* string
+#endif
+    QSR_t sortfunc;              // sort cmp func for a specific type
+    char *type2str;              // the result type as a string value
+} Item_table[] = {
+/*  setsfunc                  sortfunc     type2str
+    ------------------------  -----------  ---------- */
+  { RS(noop),                 QS(noop),    TS_noop     },
+  { RS(extra),                QS(ull_int), TS_noop     },
+
+  { RS(NAME),                 QS(str),     TS(str)     },
+  { RS(TYPE),                 QS(s_int),   TS(s_int)   },
+  { RS(NUMBER),               QS(s_int),   TS(s_int)   },
+  { RS(DESCRIPTION),          QS(str),     TS(str)     },
+  { RS(NUM_CPUS),             QS(s_int),   TS(s_int)   },
+  { RS(CPU_COUNTS),           QS(noop),    TS(u_vec)   },
+  { RS(TOTAL),                QS(ull_int), TS(ull_int) },
+
+  { RS(DELTA_CPU_COUNTS),     QS(noop),    TS(u_vec)   },
+  { RS(DELTA_TOTAL),          QS(ull_int), TS(ull_int) },
+  { RS(DELTA_HOT_CPU),        QS(s_int),   TS(s_int)   },
+  { RS(DELTA_HOT_CPU_COUNT),  QS(u_int),   TS(u_int)   },
+  { RS(DELTA_ELAPSED),        QS(real),    TS(real)    },
+  { RS(DELTA_TOTAL_PER_SEC),  QS(real),    TS(real)    },
+};
+
+    /* please note,
+     * this enum MUST be 1 greater than the highest value of any enum */
+enum interrupts_item INTERRUPTS_logical_end = MAXTABLE(Item_table);
+
+#undef setNAME
+#undef srtNAME
+#undef RS
+#undef QS
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- irq_node specific support ----------------------------------------------
+
+static inline void node_free (
+        struct irq_node *node)
+{
+    if (node) {
+        free(node->desc);
+        free(node);
+    }
+} // end: node_free
+
+
+        /*
+         * Find this line's node among those of the prior read, removing it
+         * from there.  Lines rarely come or go, so it's almost always found
+         * right where the previous match left off and the search is then
+         * but a single compare.  Returns NULL when the node must be created. */
+static struct irq_node *node_find (
+        struct interrupts_info *info,
+        struct irq_file *file,
+        const char *name,
+        int len)
+{
+    struct irq_node *node;
+    int i, n;
+
+    for (n = 0; n < info->numprior; n++) {
+        i = info->hint + n;
+        if (i >= info->numprior)
+            i -= info->numprior;
+        node = info->prior[i];
+        if (node
+        && node->type == file->type
+        && node->gen == file->cpus_gen
+        && node->name_len == len
+        && !memcmp(node->name, name, len)) {
+            info->prior[i] = NULL;
+            info->hint = i + 1;
+            return node;
+        }
+    }
+    return NULL;
+} // end: node_find
+
+
+static struct irq_node *node_new (
+        struct irq_file *file,
+        const char *name,
+        int len)
+{
+    struct irq_node *node;
+    const char *p;
+
+    // the node and its two vectors, all in one blob
+    if (!(node = calloc(1, sizeof(struct irq_node) + 2 * file->ncpus * sizeof(unsigned))))
+        return NULL;
+    memcpy(node->name, name, len);
+    node->name_len = len;
+    node->type = file->type;
+    node->gen = file->cpus_gen;
+    node->ncpus = file->ncpus;
+    node->cpus = (unsigned *)(node + 1);
+    node->deltas = node->cpus + file->ncpus;
+    node->number = -1;
+    if (file->type == INTERRUPTS_TYPE_IRQ) {
+        for (p = name; p < name + len && *p >= '0' && *p <= '9'; p++)
+            ;
+        if (p == name + len)
+            node->number = atoi(node->name);
+    }
+    return node;
+} // end: node_new
+
+
+static struct irq_node *node_get (
+        struct interrupts_info *info,
+        const char *name)
+{
+    int i;
+
+    // the hardware irqs come first, so they'd win any name conflict
+    // (and a name too long for a node is known by its first part alone)
+    for (i = 0; i < info->numnodes; i++)
+        if (!strncmp(info->nodes[i]->name, name, INTERRUPTS_NAME_LEN))
+            return info->nodes[i];
+    return NULL;
+} // end: node_get
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- generalized support ----------------------------------------------------
+
+static inline void interrupts_assign_results (
+        struct interrupts_stack *stack,
+        struct irq_node *node)
+{
+    struct interrupts_result *this = stack->head;
+
+    for (;;) {
+        enum interrupts_item item = this->item;
+        if (item >= INTERRUPTS_logical_end)
+            break;
+        Item_table[item].setsfunc(this, node);
+        ++this;
+    }
+    return;
+} // end: interrupts_assign_results
+
+
+static void interrupts_extents_free_all (
+        struct ext_support *this)
+{
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
+        free(p);
+    };
+} // end: interrupts_extents_free_all
+
+
+static inline struct interrupts_result *interrupts_itemize_stack (
+        struct interrupts_result *p,
+        int depth,
+        enum interrupts_item *items)
+{
+    struct interrupts_result *p_sav = p;
+    int i;
+
+    for (i = 0; i < depth; i++) {
+        p->item = items[i];
+        ++p;
+    }
+    return p_sav;
+} // end: interrupts_itemize_stack
+
+
+static inline int interrupts_items_check_failed (
+        enum interrupts_item *items,
+        int numitems)
+{
+    int i;
+
+    /* if an enum is passed instead of an address of one or more enums, ol' gcc
+     * will silently convert it to an address (possibly NULL).  only clang will
+     * offer any sort of warning like the following:
+     *
+     * warning: incompatible integer to pointer conversion passing 'int' to parameter of type 'enum interrupts_item *'
+     * my_stack = procps_interrupts_select(info, INTERRUPTS_noop, num);
+     *                                           ^~~~~~~~~~~~~~~~
+     */
+    if (numitems < 1
+    || (void *)items < (void *)(unsigned long)(2 * INTERRUPTS_logical_end))
+        return 1;
+
+    for (i = 0; i < numitems; i++) {
+        // an interrupts_item is currently unsigned, but we'll protect our future
+        if (items[i] < 0)
+            return 1;
+        if (items[i] >= INTERRUPTS_logical_end)
+            return 1;
+    }
+
+    return 0;
+} // end: interrupts_items_check_failed
+
+
+        /*
+         * Parse one unsigned value, returning 0 if none was present.
+         * Only blanks are skipped, so a line's end is never crossed. */
+static inline int interrupts_num (
+        char **pp,
+        unsigned long long *num)
+{
+    char *p = *pp;
+    unsigned long long n;
+
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    if (*p < '0' || *p > '9')
+        return 0;
+    n = *p++ - '0';
+    while (*p >= '0' && *p <= '9')
+        n = n * 10 + (*p++ - '0');
+    *num = n;
+    *pp = p;
+    return 1;
+} // end: interrupts_num
+
+
+        /*
+         * Bring an entire file into our buffer, which grows as needed,
+         * so it's then parsed without stdio involvement.
+         * Returns the number of bytes read, or -1 with errno set. */
+static int interrupts_slurp (
+        struct interrupts_info *info,
+        struct irq_file *file)
+{
+ #define maxSIZ    info->buf_size
+ #define curSIZ  ( maxSIZ - tot_read - 1 )
+ #define curPOS  ( info->buf + tot_read )
+    int num, tot_read = 0;
+
+    if (file->nopread && file->fd != -1) {
+        close(file->fd);
+        file->fd = -1;
+    }
+    if (-1 == file->fd
+    && (-1 == (file->fd = open(file->path, O_RDONLY))))
+        return -1;
+    if (!info->buf) {
+        if (!(info->buf = malloc(BUFFER_INCR)))
+            return -1;
+        maxSIZ = BUFFER_INCR;
+    }
+    for (;;) {
+        if (file->nopread)
+            num = read(file->fd, curPOS, curSIZ);
+        else
+            num = pread(file->fd, curPOS, curSIZ, tot_read);
+        if (num < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            /* a concession to libvirt lxc support, which has been
+               known to treat a /proc file as non-seekable ... */
+            if (errno == ESPIPE && !file->nopread && !tot_read) {
+                file->nopread = 1;
+                continue;
+            }
+            return -1;
+        }
+        tot_read += num;
+        /* seq_file hands out a page or so of lines per read, so a short
+           read proves nothing. only an eof means we've got it all ... */
+        if (num == 0)
+            break;
+        if (curSIZ > 0)
+            continue;
+        maxSIZ += BUFFER_INCR;
+        if (!(info->buf = realloc(info->buf, maxSIZ)))
+            return -1;
+    }
+    info->buf[tot_read] = '\0';
+    return tot_read;
+ #undef maxSIZ
+ #undef curSIZ
+ #undef curPOS
+} // end: interrupts_slurp
+
+
+        /*
+         * The header has a 'CPUn' for each online cpu. Should those
+         * differ from last time, the file's generation is bumped so
+         * that none of its nodes will be found again (and reused). */
+static int interrupts_header (
+        struct irq_file *file,
+        char **bp)
+{
+    unsigned long long num;
+    char *p = *bp;
+    int n = 0, changed = 0;
+
+    for (;;) {
+        while (*p == ' ' || *p == '\t')
+            ++p;
+        if (p[0] != 'C' || p[1] != 'P' || p[2] != 'U')
+            break;
+        p += 3;
+        if (!interrupts_num(&p, &num))
+            return 0;
+        if (n >= file->alloc_cols) {
+            int *cols;
+            if (!(cols = realloc(file->cols, sizeof(int) * (n + NODES_INCR))))
+                return 0;
+            file->cols = cols;
+            file->alloc_cols = n + NODES_INCR;
+        }
+        if (n >= file->numcols || file->cols[n] != (int)num) {
+            file->cols[n] = (int)num;
+            changed = 1;
+        }
+        ++n;
+    }
+    if (*p != '\n')
+        return 0;
+    if (changed || n != file->numcols) {
+        file->numcols = n;
+        file->ncpus = 0;
+        while (n--)
+            if (file->cols[n] >= file->ncpus)
+                file->ncpus = file->cols[n] + 1;
+        ++file->cpus_gen;
+    }
+    *bp = p + 1;
+    return 1;
+} // end: interrupts_header
+
+
+        /*
+         * Parse a single file, appending each of its lines (as a node)
+         * onto those already read.  The counts are followed by anything
+         * /proc/interrupts has to say about that irq.  A few lines, like
+         * ERR and MIS, have just a single value which then serves only
+         * as that node's total. */
+static int interrupts_read_file (
+        struct interrupts_info *info,
+        struct irq_file *file,
+        unsigned long long ns)
+{
+    unsigned long long num, total, delta_total;
+    struct irq_node *node;
+    char *bp, *name, *desc;
+    unsigned *new, *old, d;
+    int c, cpu, len, fresh;
+
+    if (interrupts_slurp(info, file) < 0)
+        return 1;
+    bp = info->buf;
+    if (!interrupts_header(file, &bp))
+        goto bad_line;
+
+    for ( ; *bp; bp += (*bp == '\n')) {
+        while (*bp == ' ')
+            ++bp;
+        name = bp;
+        while (*bp && *bp != ':' && *bp != '\n')
+            ++bp;
+        if (*bp != ':' || !(len = bp - name))
+            goto bad_line;
+        if (len > INTERRUPTS_NAME_LEN)     // (as that node would keep it)
+            len = INTERRUPTS_NAME_LEN;
+        ++bp;
+
+        if (info->numnodes >= info->alloc_nodes) {
+            struct irq_node **nodes;
+            if (!(nodes = realloc(info->nodes, sizeof(void *) * (info->alloc_nodes + NODES_INCR))))
+                return 1;    // here, errno was set to ENOMEM
+            info->nodes = nodes;
+            info->alloc_nodes += NODES_INCR;
+        }
+        fresh = 0;
+        if (!(node = node_find(info, file, name, len))) {
+            if (!(node = node_new(file, name, len)))
+                return 1;    // here, errno was set to ENOMEM
+            fresh = 1;
+        }
+        info->nodes[info->numnodes++] = node;
+
+        // the 'old' counts are overwritten with the deltas, then exchanged
+        new = node->deltas;
+        old = node->cpus;
+        node->hot_cpu = -1;
+        node->hot_count = 0;
+        total = delta_total = 0;
+        for (c = 0; c < file->numcols && interrupts_num(&bp, &num); c++) {
+            cpu = file->cols[c];
+            total += num;
+            // the kernel's counters are unsigned ints, which may well wrap
+            d = fresh ? 0 : (unsigned)num - old[cpu];
+            new[cpu] = (unsigned)num;
+            old[cpu] = d;
+            delta_total += d;
+            if (d > node->hot_count) {
+                node->hot_count = d;
+                node->hot_cpu = cpu;
+            }
+        }
+        if (c == file->numcols) {
+            node->cpus = new;
+            node->deltas = old;
+        } else if (c) {
+            // a short line, so we'll ignore any counts from the vectors
+            memset(node->cpus, 0, node->ncpus * sizeof(unsigned));
+            memset(node->deltas, 0, node->ncpus * sizeof(unsigned));
+            delta_total = fresh || total < node->total ? 0 : total - node->total;
+            node->hot_cpu = -1;
+            node->hot_count = 0;
+        }
+        node->total = total;
+        node->delta_total = delta_total;
+        node->old_ns = fresh ? ns : node->new_ns;
+        node->new_ns = ns;
+
+        while (*bp == ' ' || *bp == '\t')
+            ++bp;
+        desc = bp;
+        while (*bp && *bp != '\n')
+            ++bp;
+        for (len = bp - desc; len && (desc[len - 1] == ' ' || desc[len - 1] == '\t'); len--)
+            ;
+        // the description rarely changes, so it's rarely duplicated
+        if (!node->desc || strncmp(node->desc, desc, len) || node->desc[len]) {
+            char *p;
+            if (!(p = malloc(len + 1)))
+                return 1;    // here, errno was set to ENOMEM
+            memcpy(p, desc, len);
+            p[len] = '\0';
+            free(node->desc);
+            node->desc = p;
+        }
+    }
+    return 0;
+bad_line:
+    errno = ERANGE;
+    return 1;
+} // end: interrupts_read_file
+
+
+/*
+ * interrupts_read_failed:
+ *
+ * @info: info structure created at procps_interrupts_new
+ *
+ * Read the data out of /proc/interrupts and then /proc/softirqs,
+ * putting the information into the supplied info structure
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int interrupts_read_failed (
+        struct interrupts_info *info)
+{
+    struct irq_node **swap;
+    unsigned long long ns;
+    struct timespec ts;
+    int i, rc;
+
+    // the current nodes become the prior, from which they'll be reclaimed
+    swap = info->prior;
+    info->prior = info->nodes;
+    info->nodes = swap;
+    info->numprior = info->numnodes;
+    info->numnodes = 0;
+    i = info->alloc_prior;
+    info->alloc_prior = info->alloc_nodes;
+    info->alloc_nodes = i;
+    info->hint = 0;
+
+    info->new_stamp = time(NULL);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+
+    rc = interrupts_read_file(info, &info->files[0], ns)
+      || interrupts_read_file(info, &info->files[1], ns);
+
+    // whatever wasn't reclaimed has gone away (or its cpus have changed)
+    for (i = 0; i < info->numprior; i++)
+        node_free(info->prior[i]);
+    info->numprior = 0;
+    return rc;
+} // end: interrupts_read_failed
+
+
+/*
+ * interrupts_stacks_alloc():
+ *
+ * Allocate and initialize one or more stacks each of which is anchored in an
+ * associated context structure.
+ *
+ * All such stacks will have their result structures properly primed with
+ * 'items', while the result itself will be zeroed.
+ *
+ * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
+ */
+static struct stacks_extent *interrupts_stacks_alloc (
+        struct ext_support *this,
+        int maxstacks)
+{
+    struct stacks_extent *p_blob;
+    struct interrupts_stack **p_vect;
+    struct interrupts_stack *p_head;
+    size_t vect_size, head_size, list_size, blob_size;
+    void *v_head, *v_list;
+    int i;
+
+    vect_size  = sizeof(void *) * maxstacks;                         // size of the addr vectors |
+    vect_size += sizeof(void *);                                     // plus NULL addr delimiter |
+    head_size  = sizeof(struct interrupts_stack);                    // size of that head struct |
+    list_size  = sizeof(struct interrupts_result) * this->numitems;  // any single results stack |
+    blob_size  = sizeof(struct stacks_extent);                       // the extent anchor itself |
+    blob_size += vect_size;                                          // plus room for addr vects |
+    blob_size += head_size * maxstacks;                              // plus room for head thing |
+    blob_size += list_size * maxstacks;                              // plus room for our stacks |
+
+    /* note: all of our memory is allocated in one single blob, facilitating some later free(). |
+             as a minimum, it's important that all of those result structs themselves always be |
+             contiguous within every stack since they will be accessed via a relative position. | */
+    if (NULL == (p_blob = calloc(1, blob_size)))
+        return NULL;
+
+    p_blob->next = this->extents;                                    // push this extent onto... |
+    this->extents = p_blob;                                          // ...some existing extents |
+    p_vect = (void *)p_blob + sizeof(struct stacks_extent);          // prime our vector pointer |
+    p_blob->stacks = p_vect;                                         // set actual vectors start |
+    v_head = (void *)p_vect + vect_size;                             // prime head pointer start |
+    v_list = v_head + (head_size * maxstacks);                       // prime our stacks pointer |
+
+    for (i = 0; i < maxstacks; i++) {
+        p_head = (struct interrupts_stack *)v_head;
+        p_head->head = interrupts_itemize_stack((struct interrupts_result *)v_list, this->numitems, this->items);
+        p_blob->stacks[i] = p_head;
+        v_list += list_size;
+        v_head += head_size;
+    }
+    p_blob->ext_numstacks = maxstacks;
+    return p_blob;
+} // end: interrupts_stacks_alloc
+
+
+static int interrupts_stacks_fetch (
+        struct interrupts_info *info)
+{
+ #define n_alloc  info->fetch.n_alloc
+ #define n_inuse  info->fetch.n_inuse
+ #define n_saved  info->fetch.n_alloc_save
+    struct stacks_extent *ext;
+
+    // initialize stuff -----------------------------------
+    if (!info->fetch.anchor) {
+        if (!(info->fetch.anchor = calloc(STACKS_INCR, sizeof(void *))))
+            return -ENOMEM;
+        n_alloc = STACKS_INCR;
+    }
+    if (!info->fetch_ext.extents) {
+        if (!(ext = interrupts_stacks_alloc(&info->fetch_ext, n_alloc)))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * n_alloc);
+    }
+
+    // iterate stuff --------------------------------------
+    for (n_inuse = 0; n_inuse < info->numnodes; n_inuse++) {
+        if (!(n_inuse < n_alloc)) {
+            n_alloc += STACKS_INCR;
+            if ((!(info->fetch.anchor = realloc(info->fetch.anchor, sizeof(void *) * n_alloc)))
+            || (!(ext = interrupts_stacks_alloc(&info->fetch_ext, STACKS_INCR))))
+                return -1;   // here, errno was set to ENOMEM
+            memcpy(info->fetch.anchor + n_inuse, ext->stacks, sizeof(void *) * STACKS_INCR);
+        }
+        interrupts_assign_results(info->fetch.anchor[n_inuse], info->nodes[n_inuse]);
+    }
+
+    // finalize stuff -------------------------------------
+    /* note: we go to this trouble of maintaining a duplicate of the consolidated |
+             extent stacks addresses represented as our 'anchor' since these ptrs |
+             are exposed to a user (um, not that we don't trust 'em or anything). |
+             plus, we can NULL delimit these ptrs which we couldn't do otherwise. | */
+    if (n_saved < n_inuse + 1) {
+        n_saved = n_inuse + 1;
+        if (!(info->fetch.results.stacks = realloc(info->fetch.results.stacks, sizeof(void *) * n_saved)))
+            return -1;
+    }
+    memcpy(info->fetch.results.stacks, info->fetch.anchor, sizeof(void *) * n_inuse);
+    info->fetch.results.stacks[n_inuse] = NULL;
+    info->fetch.results.total = n_inuse;
+
+    return n_inuse;
+ #undef n_alloc
+ #undef n_inuse
+ #undef n_saved
+} // end: interrupts_stacks_fetch
+
+
+static int interrupts_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum interrupts_item *items,
+        int numitems)
+{
+    if (interrupts_items_check_failed(items, numitems))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum interrupts_item) * numitems)) {
+        // allow for our INTERRUPTS_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum interrupts_item) * (numitems + 1))))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(this->items, items, sizeof(enum interrupts_item) * numitems);
+        this->items[numitems] = INTERRUPTS_logical_end;
+        this->numitems = numitems + 1;
+        interrupts_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: interrupts_stacks_reconfig_maybe
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_interrupts_new():
+ *
+ * @info: location of returned new structure
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_interrupts_new (
+        struct interrupts_info **info)
+{
+    struct interrupts_info *p;
+
+#ifdef ITEMTABLE_DEBUG
+    int i, failed = 0;
+    for (i = 0; i < MAXTABLE(Item_table); i++) {
+        if (i != Item_table[i].enumnumb) {
+            fprintf(stderr, "%s: enum/table error: Item_table[%d] was %s, but its value is %d\n"
+                , __FILE__, i, Item_table[i].enum2str, Item_table[i].enumnumb);
+            failed = 1;
+        }
+    }
+    if (failed) _Exit(EXIT_FAILURE);
+#endif
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct interrupts_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    p->files[0].path = INTERRUPTS_FILE;
+    p->files[0].type = INTERRUPTS_TYPE_IRQ;
+    p->files[0].fd = -1;
+    p->files[1].path = SOFTIRQS_FILE;
+    p->files[1].type = INTERRUPTS_TYPE_SOFTIRQ;
+    p->files[1].fd = -1;
+
+    /* do a priming read here for the following potential benefits: |
+         1) ensure there will be no problems with subsequent access |
+         2) make delta results potentially useful, even if 1st time |
+         3) eliminate need for history distortion 1st time 'switch' | */
+    if (interrupts_read_failed(p)) {
+        procps_interrupts_unref(&p);
+        return -errno;
+    }
+
+    *info = p;
+    return 0;
+} // end: procps_interrupts_new
+
+
+PROCPS_EXPORT int procps_interrupts_ref (
+        struct interrupts_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_interrupts_ref
+
+
+PROCPS_EXPORT int procps_interrupts_unref (
+        struct interrupts_info **info)
+{
+    int i;
+
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        for (i = 0; i < 2; i++) {
+            if ((*info)->files[i].fd != -1)
+                close((*info)->files[i].fd);
+            free((*info)->files[i].cols);
+        }
+        free((*info)->buf);
+        for (i = 0; i < (*info)->numnodes; i++)
+            node_free((*info)->nodes[i]);
+        free((*info)->nodes);
+        free((*info)->prior);
+        if ((*info)->select_ext.extents)
+            interrupts_extents_free_all((&(*info)->select_ext));
+        if ((*info)->select_ext.items)
+            free((*info)->select_ext.items);
+
+        if ((*info)->fetch.anchor)
+            free((*info)->fetch.anchor);
+        if ((*info)->fetch.results.stacks)
+            free((*info)->fetch.results.stacks);
+
+        if ((*info)->fetch_ext.extents)
+            interrupts_extents_free_all(&(*info)->fetch_ext);
+        if ((*info)->fetch_ext.items)
+            free((*info)->fetch_ext.items);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_interrupts_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+PROCPS_EXPORT struct interrupts_result *procps_interrupts_get (
+        struct interrupts_info *info,
+        const char *name,
+        enum interrupts_item item)
+{
+    struct irq_node *node;
+    time_t cur_secs;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL)
+        return NULL;
+    if (item < 0 || item >= INTERRUPTS_logical_end)
+        return NULL;
+    errno = 0;
+
+    /* we will NOT read the interrupts files with every call - rather, we'll
+       offer a granularity of 1 second between reads ... */
+    cur_secs = time(NULL);
+    if (1 <= cur_secs - info->new_stamp) {
+        if (interrupts_read_failed(info))
+            return NULL;
+    }
+
+    info->get_this.item = item;
+    //  with 'get', we must NOT honor the usual 'noop' guarantee
+    info->get_this.result.ull_int = 0;
+
+    if (!(node = node_get(info, name))) {
+        errno = ENXIO;
+        return NULL;
+    }
+    Item_table[item].setsfunc(&info->get_this, node);
+
+    return &info->get_this;
+} // end: procps_interrupts_get
+
+
+/* procps_interrupts_reap():
+ *
+ * Harvest all the requested irq and softirq information providing
+ * the result stacks along with the total number of harvested.
+ *
+ * Returns: pointer to an interrupts_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct interrupts_reaped *procps_interrupts_reap (
+        struct interrupts_info *info,
+        enum interrupts_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > interrupts_stacks_reconfig_maybe(&info->fetch_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (interrupts_read_failed(info))
+        return NULL;
+    if (0 > interrupts_stacks_fetch(info))
+        return NULL;
+
+    return &info->fetch.results;
+} // end: procps_interrupts_reap
+
+
+/* procps_interrupts_select():
+ *
+ * Obtain all the requested information for a single irq or softirq
+ * then return it in a single library provided results stack.
+ *
+ * Returns: pointer to an interrupts_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct interrupts_stack *procps_interrupts_select (
+        struct interrupts_info *info,
+        const char *name,
+        enum interrupts_item *items,
+        int numitems)
+{
+    struct irq_node *node;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL || items == NULL)
+        return NULL;
+    if (0 > interrupts_stacks_reconfig_maybe(&info->select_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select_ext.extents
+    && (!interrupts_stacks_alloc(&info->select_ext, 1)))
+       return NULL;
+
+    if (interrupts_read_failed(info))
+        return NULL;
+    if (!(node = node_get(info, name))) {
+        errno = ENXIO;
+        return NULL;
+    }
+
+    interrupts_assign_results(info->select_ext.extents->stacks[0], node);
+
+    return info->select_ext.extents->stacks[0];
+} // end: procps_interrupts_select
+
+
+/*
+ * procps_interrupts_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct interrupts_stack **procps_interrupts_sort (
+        struct interrupts_info *info,
+        struct interrupts_stack *stacks[],
+        int numstacked,
+        enum interrupts_item sortitem,
+        enum interrupts_sort_order order)
+{
+    struct interrupts_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // an interrupts_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= INTERRUPTS_logical_end)
+        return NULL;
+    if (order != INTERRUPTS_SORT_ASCEND && order != INTERRUPTS_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= INTERRUPTS_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    if (!mergesort_r(stacks, numstacked, (QSR_t)Item_table[p->item].sortfunc, &parms))
+        return NULL;
+    return stacks;
+} // end: procps_interrupts_sort
+
+
+// --- special debugging function(s) ------------------------------------------
+/*
+ *  The following isn't part of the normal programming interface.  Rather,
+ *  it exists to validate result types referenced in application programs.
+ *
+ *  It's used only when:
+ *      1) the 'XTRA_PROCPS_DEBUG' has been defined, or
+ *      2) an #include of 'xtra-procps-debug.h' is used
+ */
+
+PROCPS_EXPORT struct interrupts_result *xtra_interrupts_get (
+        struct interrupts_info *info,
+        const char *name,
+        enum interrupts_item actual_enum,
+        const char *typestr,
+        const char *file,
+        int lineno)
+{
+    struct interrupts_result *r = procps_interrupts_get(info, name, actual_enum);
+
+    if (actual_enum < 0 || actual_enum >= INTERRUPTS_logical_end) {
+        fprintf(stderr, "%s line %d: invalid item = %d, type = %s\n"
+            , file, lineno, actual_enum, typestr);
+    }
+    if (r) {
+        char *str = Item_table[r->item].type2str;
+        if (str[0]
+        && (strcmp(typestr, str)))
+            fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return r;
+} // end: xtra_interrupts_get_
+
+
+PROCPS_EXPORT struct interrupts_result *xtra_interrupts_val (
+        int relative_enum,
+        const char *typestr,
+        const struct interrupts_stack *stack,
+        const char *file,
+        int lineno)
+{
+    char *str;
+    int i;
+
+    for (i = 0; stack->head[i].item < INTERRUPTS_logical_end; i++)
+        ;
+    if (relative_enum < 0 || relative_enum >= i) {
+        fprintf(stderr, "%s line %d: invalid relative_enum = %d, valid range = 0-%d\n"
+            , file, lineno, relative_enum, i-1);
+        return NULL;
+    }
+    str = Item_table[stack->head[relative_enum].item].type2str;
+    if (str[0]
+    && (strcmp(typestr, str))) {
+        fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return &stack->head[relative_enum];
+} // end: xtra_interrupts_val
@@ -21,7 +21,8 @@
 
 #include <errno.h>
 #include <fcntl.h>
-#include <search.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,13 +32,22 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "numa.h"
+#include "sort.h"
+
 #include "procps-private.h"
 #include "meminfo.h"
 
 
+#ifndef MEMINFO_FILE
 #define MEMINFO_FILE  "/proc/meminfo"
+#endif
 #define MEMINFO_BUFF  8192
 
+#ifndef NODE_DIR
+#define NODE_DIR      "/sys/devices/system/node"
+#endif
+
 /* ------------------------------------------------------------------------- +
    this provision can be used to ensure that our Item_table was synchronized |
    with those enumerators found in the associated header file. It's intended |
@@ -65,6 +75,7 @@ struct meminfo_data {
     unsigned long DirectMap4k;
     unsigned long Dirty;
     unsigned long FileHugePages;
+    unsigned long FilePages;           // only in a node's meminfo, see meminfo_derive
     unsigned long FilePmdMapped;
     unsigned long HardwareCorrupted;   //  man 5 proc: 'to be documented'
     unsigned long HighFree;
@@ -122,6 +133,13 @@ struct meminfo_data {
 struct mem_hist {
     struct meminfo_data new;
     struct meminfo_data old;
+    int node_id;                       // numa node, or -1 for /proc/meminfo
+};
+
+struct mem_node {
+    int fd;                            // its nodeN/meminfo, else -1
+    int primed;                        // has 'hist' seen a prior read
+    struct mem_hist hist;
 };
 
 struct stacks_extent {
@@ -130,14 +148,21 @@ struct stacks_extent {
     struct meminfo_stack **stacks;
 };
 
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum meminfo_item *items;          // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for these extents
+};
+
 struct meminfo_info {
     int refcount;
     int meminfo_fd;
     struct mem_hist hist;
-    int numitems;
-    enum meminfo_item *items;
-    struct stacks_extent *extents;
-    struct hsearch_data hashtab;
+    struct ext_support select;         // support for 'procps_meminfo_select()'
+    struct ext_support nodes;          // support for 'procps_meminfo_reap()'
+    struct meminfo_reaped reaped;      // for return to caller after a reap
+    struct mem_node *node_hist;        // per node history, by node number
+    int node_alloc;                    // number of node_hist allocated
     struct meminfo_result get_this;
     time_t sav_secs;
 };
@@ -299,11 +324,46 @@ HST_set(SWAP_DELTA_FREE,         s_int,  SwapFree)
 HST_set(SWAP_DELTA_TOTAL,        s_int,  SwapTotal)
 HST_set(SWAP_DELTA_USED,         s_int,  derived_swap_used)
 
+setDECL(NODE_ID) { R->result.s_int = H->node_id; }
+
 #undef setDECL
 #undef MEM_set
 #undef HST_set
 
 
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum meminfo_sort_order order;
+};
+
+#define srtNAME(t) sort_meminfo_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct meminfo_stack **A, const struct meminfo_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct meminfo_result *a = (*A)->head + P->offset; \
+    const struct meminfo_result *b = (*B)->head + P->offset; \
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(ul_int) {
+    const struct meminfo_result *a = (*A)->head + P->offset; \
+    const struct meminfo_result *b = (*B)->head + P->offset; \
+    if ( a->result.ul_int > b->result.ul_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.ul_int < b->result.ul_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(noop) { \
+    (void)A; (void)B; (void)P; \
+    return 0;
+}
+
+#undef srtDECL
+
+
 // ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 typedef void (*SET_t)(struct meminfo_result *, struct mem_hist *);
@@ -313,6 +373,9 @@ typedef void (*SET_t)(struct meminfo_result *, struct mem_hist *);
 #define RS(e) (SET_t)setNAME(e)
 #endif
 
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
 #define TS(t) STRINGIFY(t)
 #define TS_noop ""
 
@@ -326,154 +389,157 @@ static struct {
     int   enumnumb;              // enumerator (must match position!)
     char *enum2str;              // enumerator name as a char* string
 #endif
+    QSR_t sortfunc;              // sort cmp func for a specific type
     char *type2str;              // the result type as a string value
 } Item_table[] = {
-/*  setsfunc                   type2str
-    -------------------------  ---------- */
-  { RS(noop),                  TS_noop    },
-  { RS(extra),                 TS_noop    },
-
-  { RS(MEM_ACTIVE),            TS(ul_int) },
-  { RS(MEM_ACTIVE_ANON),       TS(ul_int) },
-  { RS(MEM_ACTIVE_FILE),       TS(ul_int) },
-  { RS(MEM_ANON),              TS(ul_int) },
-  { RS(MEM_AVAILABLE),         TS(ul_int) },
-  { RS(MEM_BOUNCE),            TS(ul_int) },
-  { RS(MEM_BUFFERS),           TS(ul_int) },
-  { RS(MEM_CACHED),            TS(ul_int) },
-  { RS(MEM_CACHED_ALL),        TS(ul_int) },
-  { RS(MEM_CMA_FREE),          TS(ul_int) },
-  { RS(MEM_CMA_TOTAL),         TS(ul_int) },
-  { RS(MEM_COMMITTED_AS),      TS(ul_int) },
-  { RS(MEM_COMMIT_LIMIT),      TS(ul_int) },
-  { RS(MEM_DIRECTMAP_1G),      TS(ul_int) },
-  { RS(MEM_DIRECTMAP_2M),      TS(ul_int) },
-  { RS(MEM_DIRECTMAP_4K),      TS(ul_int) },
-  { RS(MEM_DIRECTMAP_4M),      TS(ul_int) },
-  { RS(MEM_DIRTY),             TS(ul_int) },
-  { RS(MEM_FILE_HUGEPAGES),    TS(ul_int) },
-  { RS(MEM_FILE_PMDMAPPED),    TS(ul_int) },
-  { RS(MEM_FREE),              TS(ul_int) },
-  { RS(MEM_HARD_CORRUPTED),    TS(ul_int) },
-  { RS(MEM_HIGH_FREE),         TS(ul_int) },
-  { RS(MEM_HIGH_TOTAL),        TS(ul_int) },
-  { RS(MEM_HIGH_USED),         TS(ul_int) },
-  { RS(MEM_HUGETBL),           TS(ul_int) },
-  { RS(MEM_HUGE_ANON),         TS(ul_int) },
-  { RS(MEM_HUGE_FREE),         TS(ul_int) },
-  { RS(MEM_HUGE_RSVD),         TS(ul_int) },
-  { RS(MEM_HUGE_SIZE),         TS(ul_int) },
-  { RS(MEM_HUGE_SURPLUS),      TS(ul_int) },
-  { RS(MEM_HUGE_TOTAL),        TS(ul_int) },
-  { RS(MEM_INACTIVE),          TS(ul_int) },
-  { RS(MEM_INACTIVE_ANON),     TS(ul_int) },
-  { RS(MEM_INACTIVE_FILE),     TS(ul_int) },
-  { RS(MEM_KERNEL_RECLAIM),    TS(ul_int) },
-  { RS(MEM_KERNEL_STACK),      TS(ul_int) },
-  { RS(MEM_LOCKED),            TS(ul_int) },
-  { RS(MEM_LOW_FREE),          TS(ul_int) },
-  { RS(MEM_LOW_TOTAL),         TS(ul_int) },
-  { RS(MEM_LOW_USED),          TS(ul_int) },
-  { RS(MEM_MAPPED),            TS(ul_int) },
-  { RS(MEM_MAP_COPY),          TS(ul_int) },
-  { RS(MEM_NFS_UNSTABLE),      TS(ul_int) },
-  { RS(MEM_PAGE_TABLES),       TS(ul_int) },
-  { RS(MEM_PAGE_TABLES_SEC),   TS(ul_int) },
-  { RS(MEM_PER_CPU),           TS(ul_int) },
-  { RS(MEM_SHADOWCALLSTACK),   TS(ul_int) },
-  { RS(MEM_SHARED),            TS(ul_int) },
-  { RS(MEM_SHMEM_HUGE),        TS(ul_int) },
-  { RS(MEM_SHMEM_HUGE_MAP),    TS(ul_int) },
-  { RS(MEM_SLAB),              TS(ul_int) },
-  { RS(MEM_SLAB_RECLAIM),      TS(ul_int) },
-  { RS(MEM_SLAB_UNRECLAIM),    TS(ul_int) },
-  { RS(MEM_TOTAL),             TS(ul_int) },
-  { RS(MEM_UNACCEPTED),        TS(ul_int) },
-  { RS(MEM_UNEVICTABLE),       TS(ul_int) },
-  { RS(MEM_USED),              TS(ul_int) },
-  { RS(MEM_VM_ALLOC_CHUNK),    TS(ul_int) },
-  { RS(MEM_VM_ALLOC_TOTAL),    TS(ul_int) },
-  { RS(MEM_VM_ALLOC_USED),     TS(ul_int) },
-  { RS(MEM_WRITEBACK),         TS(ul_int) },
-  { RS(MEM_WRITEBACK_TMP),     TS(ul_int) },
-  { RS(MEM_ZSWAP),             TS(ul_int) },
-  { RS(MEM_ZSWAPPED),          TS(ul_int) },
-
-  { RS(DELTA_ACTIVE),          TS(s_int)  },
-  { RS(DELTA_ACTIVE_ANON),     TS(s_int)  },
-  { RS(DELTA_ACTIVE_FILE),     TS(s_int)  },
-  { RS(DELTA_ANON),            TS(s_int)  },
-  { RS(DELTA_AVAILABLE),       TS(s_int)  },
-  { RS(DELTA_BOUNCE),          TS(s_int)  },
-  { RS(DELTA_BUFFERS),         TS(s_int)  },
-  { RS(DELTA_CACHED),          TS(s_int)  },
-  { RS(DELTA_CACHED_ALL),      TS(s_int)  },
-  { RS(DELTA_CMA_FREE),        TS(s_int)  },
-  { RS(DELTA_CMA_TOTAL),       TS(s_int)  },
-  { RS(DELTA_COMMITTED_AS),    TS(s_int)  },
-  { RS(DELTA_COMMIT_LIMIT),    TS(s_int)  },
-  { RS(DELTA_DIRECTMAP_1G),    TS(s_int)  },
-  { RS(DELTA_DIRECTMAP_2M),    TS(s_int)  },
-  { RS(DELTA_DIRECTMAP_4K),    TS(s_int)  },
-  { RS(DELTA_DIRECTMAP_4M),    TS(s_int)  },
-  { RS(DELTA_DIRTY),           TS(s_int)  },
-  { RS(DELTA_FILE_HUGEPAGES),  TS(s_int)  },
-  { RS(DELTA_FILE_PMDMAPPED),  TS(s_int)  },
-  { RS(DELTA_FREE),            TS(s_int)  },
-  { RS(DELTA_HARD_CORRUPTED),  TS(s_int)  },
-  { RS(DELTA_HIGH_FREE),       TS(s_int)  },
-  { RS(DELTA_HIGH_TOTAL),      TS(s_int)  },
-  { RS(DELTA_HIGH_USED),       TS(s_int)  },
-  { RS(DELTA_HUGETBL),         TS(s_int)  },
-  { RS(DELTA_HUGE_ANON),       TS(s_int)  },
-  { RS(DELTA_HUGE_FREE),       TS(s_int)  },
-  { RS(DELTA_HUGE_RSVD),       TS(s_int)  },
-  { RS(DELTA_HUGE_SIZE),       TS(s_int)  },
-  { RS(DELTA_HUGE_SURPLUS),    TS(s_int)  },
-  { RS(DELTA_HUGE_TOTAL),      TS(s_int)  },
-  { RS(DELTA_INACTIVE),        TS(s_int)  },
-  { RS(DELTA_INACTIVE_ANON),   TS(s_int)  },
-  { RS(DELTA_INACTIVE_FILE),   TS(s_int)  },
-  { RS(DELTA_KERNEL_RECLAIM),  TS(s_int)  },
-  { RS(DELTA_KERNEL_STACK),    TS(s_int)  },
-  { RS(DELTA_LOCKED),          TS(s_int)  },
-  { RS(DELTA_LOW_FREE),        TS(s_int)  },
-  { RS(DELTA_LOW_TOTAL),       TS(s_int)  },
-  { RS(DELTA_LOW_USED),        TS(s_int)  },
-  { RS(DELTA_MAPPED),          TS(s_int)  },
-  { RS(DELTA_MAP_COPY),        TS(s_int)  },
-  { RS(DELTA_NFS_UNSTABLE),    TS(s_int)  },
-  { RS(DELTA_PAGE_TABLES),     TS(s_int)  },
-  { RS(DELTA_PAGE_TABLES_SEC), TS(s_int)  },
-  { RS(DELTA_PER_CPU),         TS(s_int)  },
-  { RS(DELTA_SHADOWCALLSTACK), TS(s_int)  },
-  { RS(DELTA_SHARED),          TS(s_int)  },
-  { RS(DELTA_SHMEM_HUGE),      TS(s_int)  },
-  { RS(DELTA_SHMEM_HUGE_MAP),  TS(s_int)  },
-  { RS(DELTA_SLAB),            TS(s_int)  },
-  { RS(DELTA_SLAB_RECLAIM),    TS(s_int)  },
-  { RS(DELTA_SLAB_UNRECLAIM),  TS(s_int)  },
-  { RS(DELTA_TOTAL),           TS(s_int)  },
-  { RS(DELTA_UNACCEPTED),      TS(s_int)  },
-  { RS(DELTA_UNEVICTABLE),     TS(s_int)  },
-  { RS(DELTA_USED),            TS(s_int)  },
-  { RS(DELTA_VM_ALLOC_CHUNK),  TS(s_int)  },
-  { RS(DELTA_VM_ALLOC_TOTAL),  TS(s_int)  },
-  { RS(DELTA_VM_ALLOC_USED),   TS(s_int)  },
-  { RS(DELTA_WRITEBACK),       TS(s_int)  },
-  { RS(DELTA_WRITEBACK_TMP),   TS(s_int)  },
-  { RS(DELTA_ZSWAP),           TS(s_int)  },
-  { RS(DELTA_ZSWAPPED),        TS(s_int)  },
-
-  { RS(SWAP_CACHED),           TS(ul_int) },
-  { RS(SWAP_FREE),             TS(ul_int) },
-  { RS(SWAP_TOTAL),            TS(ul_int) },
-  { RS(SWAP_USED),             TS(ul_int) },
-
-  { RS(SWAP_DELTA_CACHED),     TS(s_int)  },
-  { RS(SWAP_DELTA_FREE),       TS(s_int)  },
-  { RS(SWAP_DELTA_TOTAL),      TS(s_int)  },
-  { RS(SWAP_DELTA_USED),       TS(s_int)  },
+/*  setsfunc                   sortfunc      type2str
+    -------------------------  ------------  ---------- */
+  { RS(noop),                  QS(noop),     TS_noop    },
+  { RS(extra),                 QS(ul_int),   TS_noop    },
+
+  { RS(MEM_ACTIVE),            QS(ul_int),   TS(ul_int) },
+  { RS(MEM_ACTIVE_ANON),       QS(ul_int),   TS(ul_int) },
+  { RS(MEM_ACTIVE_FILE),       QS(ul_int),   TS(ul_int) },
+  { RS(MEM_ANON),              QS(ul_int),   TS(ul_int) },
+  { RS(MEM_AVAILABLE),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_BOUNCE),            QS(ul_int),   TS(ul_int) },
+  { RS(MEM_BUFFERS),           QS(ul_int),   TS(ul_int) },
+  { RS(MEM_CACHED),            QS(ul_int),   TS(ul_int) },
+  { RS(MEM_CACHED_ALL),        QS(ul_int),   TS(ul_int) },
+  { RS(MEM_CMA_FREE),          QS(ul_int),   TS(ul_int) },
+  { RS(MEM_CMA_TOTAL),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_COMMITTED_AS),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_COMMIT_LIMIT),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_DIRECTMAP_1G),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_DIRECTMAP_2M),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_DIRECTMAP_4K),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_DIRECTMAP_4M),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_DIRTY),             QS(ul_int),   TS(ul_int) },
+  { RS(MEM_FILE_HUGEPAGES),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_FILE_PMDMAPPED),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_FREE),              QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HARD_CORRUPTED),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HIGH_FREE),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HIGH_TOTAL),        QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HIGH_USED),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGETBL),           QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGE_ANON),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGE_FREE),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGE_RSVD),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGE_SIZE),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGE_SURPLUS),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_HUGE_TOTAL),        QS(ul_int),   TS(ul_int) },
+  { RS(MEM_INACTIVE),          QS(ul_int),   TS(ul_int) },
+  { RS(MEM_INACTIVE_ANON),     QS(ul_int),   TS(ul_int) },
+  { RS(MEM_INACTIVE_FILE),     QS(ul_int),   TS(ul_int) },
+  { RS(MEM_KERNEL_RECLAIM),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_KERNEL_STACK),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_LOCKED),            QS(ul_int),   TS(ul_int) },
+  { RS(MEM_LOW_FREE),          QS(ul_int),   TS(ul_int) },
+  { RS(MEM_LOW_TOTAL),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_LOW_USED),          QS(ul_int),   TS(ul_int) },
+  { RS(MEM_MAPPED),            QS(ul_int),   TS(ul_int) },
+  { RS(MEM_MAP_COPY),          QS(ul_int),   TS(ul_int) },
+  { RS(MEM_NFS_UNSTABLE),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_PAGE_TABLES),       QS(ul_int),   TS(ul_int) },
+  { RS(MEM_PAGE_TABLES_SEC),   QS(ul_int),   TS(ul_int) },
+  { RS(MEM_PER_CPU),           QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SHADOWCALLSTACK),   QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SHARED),            QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SHMEM_HUGE),        QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SHMEM_HUGE_MAP),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SLAB),              QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SLAB_RECLAIM),      QS(ul_int),   TS(ul_int) },
+  { RS(MEM_SLAB_UNRECLAIM),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_TOTAL),             QS(ul_int),   TS(ul_int) },
+  { RS(MEM_UNACCEPTED),        QS(ul_int),   TS(ul_int) },
+  { RS(MEM_UNEVICTABLE),       QS(ul_int),   TS(ul_int) },
+  { RS(MEM_USED),              QS(ul_int),   TS(ul_int) },
+  { RS(MEM_VM_ALLOC_CHUNK),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_VM_ALLOC_TOTAL),    QS(ul_int),   TS(ul_int) },
+  { RS(MEM_VM_ALLOC_USED),     QS(ul_int),   TS(ul_int) },
+  { RS(MEM_WRITEBACK),         QS(ul_int),   TS(ul_int) },
+  { RS(MEM_WRITEBACK_TMP),     QS(ul_int),   TS(ul_int) },
+  { RS(MEM_ZSWAP),             QS(ul_int),   TS(ul_int) },
+  { RS(MEM_ZSWAPPED),          QS(ul_int),   TS(ul_int) },
+
+  { RS(DELTA_ACTIVE),          QS(s_int),    TS(s_int)  },
+  { RS(DELTA_ACTIVE_ANON),     QS(s_int),    TS(s_int)  },
+  { RS(DELTA_ACTIVE_FILE),     QS(s_int),    TS(s_int)  },
+  { RS(DELTA_ANON),            QS(s_int),    TS(s_int)  },
+  { RS(DELTA_AVAILABLE),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_BOUNCE),          QS(s_int),    TS(s_int)  },
+  { RS(DELTA_BUFFERS),         QS(s_int),    TS(s_int)  },
+  { RS(DELTA_CACHED),          QS(s_int),    TS(s_int)  },
+  { RS(DELTA_CACHED_ALL),      QS(s_int),    TS(s_int)  },
+  { RS(DELTA_CMA_FREE),        QS(s_int),    TS(s_int)  },
+  { RS(DELTA_CMA_TOTAL),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_COMMITTED_AS),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_COMMIT_LIMIT),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_DIRECTMAP_1G),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_DIRECTMAP_2M),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_DIRECTMAP_4K),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_DIRECTMAP_4M),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_DIRTY),           QS(s_int),    TS(s_int)  },
+  { RS(DELTA_FILE_HUGEPAGES),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_FILE_PMDMAPPED),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_FREE),            QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HARD_CORRUPTED),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HIGH_FREE),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HIGH_TOTAL),      QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HIGH_USED),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGETBL),         QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGE_ANON),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGE_FREE),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGE_RSVD),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGE_SIZE),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGE_SURPLUS),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_HUGE_TOTAL),      QS(s_int),    TS(s_int)  },
+  { RS(DELTA_INACTIVE),        QS(s_int),    TS(s_int)  },
+  { RS(DELTA_INACTIVE_ANON),   QS(s_int),    TS(s_int)  },
+  { RS(DELTA_INACTIVE_FILE),   QS(s_int),    TS(s_int)  },
+  { RS(DELTA_KERNEL_RECLAIM),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_KERNEL_STACK),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_LOCKED),          QS(s_int),    TS(s_int)  },
+  { RS(DELTA_LOW_FREE),        QS(s_int),    TS(s_int)  },
+  { RS(DELTA_LOW_TOTAL),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_LOW_USED),        QS(s_int),    TS(s_int)  },
+  { RS(DELTA_MAPPED),          QS(s_int),    TS(s_int)  },
+  { RS(DELTA_MAP_COPY),        QS(s_int),    TS(s_int)  },
+  { RS(DELTA_NFS_UNSTABLE),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_PAGE_TABLES),     QS(s_int),    TS(s_int)  },
+  { RS(DELTA_PAGE_TABLES_SEC), QS(s_int),    TS(s_int)  },
+  { RS(DELTA_PER_CPU),         QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SHADOWCALLSTACK), QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SHARED),          QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SHMEM_HUGE),      QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SHMEM_HUGE_MAP),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SLAB),            QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SLAB_RECLAIM),    QS(s_int),    TS(s_int)  },
+  { RS(DELTA_SLAB_UNRECLAIM),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_TOTAL),           QS(s_int),    TS(s_int)  },
+  { RS(DELTA_UNACCEPTED),      QS(s_int),    TS(s_int)  },
+  { RS(DELTA_UNEVICTABLE),     QS(s_int),    TS(s_int)  },
+  { RS(DELTA_USED),            QS(s_int),    TS(s_int)  },
+  { RS(DELTA_VM_ALLOC_CHUNK),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_VM_ALLOC_TOTAL),  QS(s_int),    TS(s_int)  },
+  { RS(DELTA_VM_ALLOC_USED),   QS(s_int),    TS(s_int)  },
+  { RS(DELTA_WRITEBACK),       QS(s_int),    TS(s_int)  },
+  { RS(DELTA_WRITEBACK_TMP),   QS(s_int),    TS(s_int)  },
+  { RS(DELTA_ZSWAP),           QS(s_int),    TS(s_int)  },
+  { RS(DELTA_ZSWAPPED),        QS(s_int),    TS(s_int)  },
+
+  { RS(SWAP_CACHED),           QS(ul_int),   TS(ul_int) },
+  { RS(SWAP_FREE),             QS(ul_int),   TS(ul_int) },
+  { RS(SWAP_TOTAL),            QS(ul_int),   TS(ul_int) },
+  { RS(SWAP_USED),             QS(ul_int),   TS(ul_int) },
+
+  { RS(SWAP_DELTA_CACHED),     QS(s_int),    TS(s_int)  },
+  { RS(SWAP_DELTA_FREE),       QS(s_int),    TS(s_int)  },
+  { RS(SWAP_DELTA_TOTAL),      QS(s_int),    TS(s_int)  },
+  { RS(SWAP_DELTA_USED),       QS(s_int),    TS(s_int)  },
+
+  { RS(NODE_ID),               QS(s_int),    TS(s_int)  },
 };
 
     /* please note,
@@ -481,7 +547,9 @@ static struct {
 enum meminfo_item MEMINFO_logical_end = MAXTABLE(Item_table);
 
 #undef setNAME
+#undef srtNAME
 #undef RS
+#undef QS
 
 
 // ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -504,11 +572,11 @@ static inline void meminfo_assign_results (
 
 
 static void meminfo_extents_free_all (
-        struct meminfo_info *info)
+        struct ext_support *this)
 {
-    while (info->extents) {
-        struct stacks_extent *p = info->extents;
-        info->extents = info->extents->next;
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
         free(p);
     };
 } // end: meminfo_extents_free_all
@@ -560,93 +628,215 @@ static inline int meminfo_items_check_failed (
 } // end: meminfo_items_check_failed
 
 
-static int meminfo_make_hash_failed (
-        struct meminfo_info *info)
+typedef struct meminfo_table_struct {
+    const char *name;             // /proc/meminfo field name
+    unsigned char len;            // name length
+    unsigned short offset;        // where it goes in struct meminfo_data
+} meminfo_table_struct;
+
+#define F(x)    { #x, sizeof(#x)-1, offsetof(struct meminfo_data, x) },
+#define FX(k,x) { #k, sizeof(#k)-1, offsetof(struct meminfo_data, x) },
+
+#define MEMINFO_TABLE_SIZE 128
+
+// A perfect hash in the gperf style, as with status2proc in readproc.c:
+//   length + asso[1st char] + asso[10th char] + asso[last char]
+// masked to MEMINFO_TABLE_SIZE, with those key positions giving each of
+// our names a distinct set of characters.  Names not in the table (and
+// there are always a few) simply fail the length or memcmp test.
+//
+// Adding a field means searching out a new 'asso' where none of those
+// names collide, perhaps with other key positions.  A duplicate index in
+// the table below silently replaces the earlier entry, but then it fails
+// check_meminfo_table (library/tests/test_meminfo.c), which finds every name
+// at its own hash and counts them against the struct's fields.
+
+static const unsigned char meminfo_asso[] =
 {
- #define htVAL(f) e.key = STRINGIFY(f); e.data = &info->hist.new. f; \
-  if (!hsearch_r(e, ENTER, &ep, &info->hashtab)) goto err_return;
- #define htXTRA(k,f) e.key = STRINGIFY(k); e.data = &info->hist.new. f; \
-  if (!hsearch_r(e, ENTER, &ep, &info->hashtab)) goto err_return;
-    ENTRY e, *ep;
-    size_t n;
-
-    // will also include those derived fields (more is better)
-    n = sizeof(struct meminfo_data) / sizeof(unsigned long);
-    // we'll follow the hsearch recommendation of an extra 25%
-    if (!hcreate_r(n + (n / 4), &info->hashtab))
-        goto err_return;
-
-    htVAL(Active)
-    htXTRA(Active(anon), Active_anon)
-    htXTRA(Active(file), Active_file)
-    htVAL(AnonHugePages)
-    htVAL(AnonPages)
-    htVAL(Bounce)
-    htVAL(Buffers)
-    htVAL(Cached)
-    htVAL(CmaFree)
-    htVAL(CmaTotal)
-    htVAL(CommitLimit)
-    htVAL(Committed_AS)
-    htVAL(DirectMap1G)
-    htVAL(DirectMap2M)
-    htVAL(DirectMap4M)
-    htVAL(DirectMap4k)
-    htVAL(Dirty)
-    htVAL(FileHugePages)
-    htVAL(FilePmdMapped)
-    htVAL(HardwareCorrupted)
-    htVAL(HighFree)
-    htVAL(HighTotal)
-    htVAL(HugePages_Free)
-    htVAL(HugePages_Rsvd)
-    htVAL(HugePages_Surp)
-    htVAL(HugePages_Total)
-    htVAL(Hugepagesize)
-    htVAL(Hugetlb)
-    htVAL(Inactive)
-    htXTRA(Inactive(anon), Inactive_anon)
-    htXTRA(Inactive(file), Inactive_file)
-    htVAL(KReclaimable)
-    htVAL(KernelStack)
-    htVAL(LowFree)
-    htVAL(LowTotal)
-    htVAL(Mapped)
-    htVAL(MemAvailable)
-    htVAL(MemFree)
-    htVAL(MemTotal)
-    htVAL(Mlocked)
-    htVAL(MmapCopy)
-    htVAL(NFS_Unstable)
-    htVAL(PageTables)
-    htVAL(Percpu)
-    htVAL(SReclaimable)
-    htVAL(SUnreclaim)
-    htVAL(SecPageTables)
-    htVAL(ShadowCallStack)
-    htVAL(Shmem)
-    htVAL(ShmemHugePages)
-    htVAL(ShmemPmdMapped)
-    htVAL(Slab)
-    htVAL(SwapCached)
-    htVAL(SwapFree)
-    htVAL(SwapTotal)
-    htVAL(Unaccepted)
-    htVAL(Unevictable)
-    htVAL(VmallocChunk)
-    htVAL(VmallocTotal)
-    htVAL(VmallocUsed)
-    htVAL(Writeback)
-    htVAL(WritebackTmp)
-    htVAL(Zswap)
-    htVAL(Zswapped)
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  95,   0,   0,   0,   0,   0,   0,   0,  75,
+    120,   0,  99,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   8,   1,  69,  48,   0,
+    113, 106,  66,   9,   0,  77, 119,  12,  81,   0,
+     96,   0,   0,  89,  33,  87,  78, 103,   0,   0,
+     73,   0,   0,   0,   0, 107,   0,  60,  11,  52,
+     59,  41,  18,   0,   0,  52,   0,  42,  33,  62,
+      0,  87,  66,   0,   0,  62,   5,  94,   0,   0,
+      0, 112,   0,   0,   0,   0,   0,   0
+};
 
-    return 0;
- err_return:
-    return 1;
- #undef htVAL
- #undef htXTRA
-} // end: meminfo_make_hash_failed
+static const meminfo_table_struct meminfo_table[MEMINFO_TABLE_SIZE] = {
+    [   0] = F(VmallocTotal)
+    [   3] = F(SwapTotal)
+    [   4] = F(MmapCopy)
+    [   5] = F(ShmemHugePages)
+    [   6] = F(Cached)
+    [   8] = FX(Inactive(file), Inactive_file)
+    [   9] = F(CommitLimit)
+    [  10] = F(SwapFree)
+    [  12] = F(Zswapped)
+    [  13] = F(KReclaimable)
+    [  15] = F(AnonHugePages)
+    [  16] = F(Zswap)
+    [  17] = F(NFS_Unstable)
+    [  20] = FX(Active(file), Active_file)
+    [  21] = F(Committed_AS)
+    [  25] = F(SReclaimable)
+    [  26] = F(Writeback)
+    [  28] = F(Shmem)
+    [  32] = F(LowTotal)
+    [  37] = F(Dirty)
+    [  39] = F(LowFree)
+    [  42] = F(DirectMap4M)
+    [  43] = F(Hugepagesize)
+    [  44] = F(Unevictable)
+    [  47] = F(SecPageTables)
+    [  48] = F(Bounce)
+    [  50] = FX(Inactive(anon), Inactive_anon)
+    [  51] = F(ShadowCallStack)
+    [  53] = F(MemTotal)
+    [  54] = F(KernelStack)
+    [  55] = F(Active)
+    [  56] = F(FilePages)
+    [  58] = F(Inactive)
+    [  60] = F(MemFree)
+    [  61] = F(VmallocUsed)
+    [  63] = F(DirectMap2M)
+    [  68] = F(Percpu)
+    [  70] = F(Buffers)
+    [  72] = F(DirectMap4k)
+    [  74] = FX(Active(anon), Active_anon)
+    [  76] = F(MemAvailable)
+    [  77] = F(Mapped)
+    [  78] = F(Mlocked)
+    [  79] = F(AnonPages)
+    [  84] = F(Hugetlb)
+    [  86] = F(WritebackTmp)
+    [  87] = F(Unaccepted)
+    [  89] = F(SwapCached)
+    [  93] = F(HugePages_Total)
+    [  94] = F(ShmemPmdMapped)
+    [  95] = F(SUnreclaim)
+    [  98] = F(VmallocChunk)
+    [ 100] = F(HugePages_Free)
+    [ 101] = F(HardwareCorrupted)
+    [ 102] = F(PageTables)
+    [ 104] = F(Slab)
+    [ 108] = F(HighTotal)
+    [ 110] = F(CmaTotal)
+    [ 112] = F(DirectMap1G)
+    [ 115] = F(HighFree)
+    [ 117] = F(CmaFree)
+    [ 118] = F(HugePages_Rsvd)
+    [ 120] = F(FileHugePages)
+    [ 123] = F(FilePmdMapped)
+    [ 125] = F(HugePages_Surp)
+};
+
+#undef F
+#undef FX
+
+
+static inline unsigned meminfo_hash (
+        const char *s,
+        unsigned len)
+{
+    unsigned hval = len;
+
+    if (len >= 10)
+        hval += meminfo_asso[s[9] & 127];
+    hval += meminfo_asso[s[0] & 127] + meminfo_asso[s[len - 1] & 127];
+    return hval & (MEMINFO_TABLE_SIZE - 1);
+} // end: meminfo_hash
+
+
+        /*
+         * Fill in those values which are derived from the others. For
+         * a node, Cached comes from FilePages (there are no node Buffers)
+         * and MemAvailable will be the same as MemFree. */
+static void meminfo_derive (
+        struct meminfo_data *data)
+{
+ /* a 'memory data reference' macro for readability,
+    so we can focus the field names ... */
+ #define mHr(f) data-> f
+    signed long mem_used;
+
+    if (mHr(FilePages) && !mHr(Cached) && mHr(FilePages) > mHr(SwapCached))
+        mHr(Cached) = mHr(FilePages) - mHr(SwapCached);
+    if (0 == mHr(MemAvailable))
+        mHr(MemAvailable) = mHr(MemFree);
+    mHr(derived_mem_cached) = mHr(Cached) + mHr(SReclaimable);
+
+    /* if 'available' is greater than 'total' or our calculation of mem_used
+       overflows, that's symptomatic of running within a lxc container where
+       such values will be dramatically distorted over those of the host. */
+    if (mHr(MemAvailable) > mHr(MemTotal))
+        mHr(MemAvailable) = mHr(MemFree);
+    mem_used = mHr(MemTotal) - mHr(MemAvailable);
+    if (mem_used < 0)
+        mem_used = mHr(MemTotal) - mHr(MemFree);
+    mHr(derived_mem_used) = (unsigned long)mem_used;
+
+    if (mHr(HighFree) < mHr(HighTotal))
+         mHr(derived_mem_hi_used) = mHr(HighTotal) - mHr(HighFree);
+
+    if (0 == mHr(LowTotal)) {
+        mHr(LowTotal) = mHr(MemTotal);
+        mHr(LowFree)  = mHr(MemFree);
+    }
+    if (mHr(LowFree) < mHr(LowTotal))
+        mHr(derived_mem_lo_used) = mHr(LowTotal) - mHr(LowFree);
+
+    if (mHr(SwapFree) < mHr(SwapTotal))
+        mHr(derived_swap_used) = mHr(SwapTotal) - mHr(SwapFree);
+ #undef mHr
+} // end: meminfo_derive
+
+
+        /*
+         * Parse a buffer of "Name:  value kB" lines, as found in /proc/meminfo
+         * or, with a "Node N " prefix on each line, a sysfs nodeN/meminfo. */
+static void meminfo_parse (
+        struct meminfo_data *data,
+        char *head,
+        char *end)
+{
+    char *tail;
+
+    /* one pass, with each name hashed and its value then converted in place
+       (/proc/meminfo uses %8lu, so there will never be a sign to deal with) */
+    while (head < end) {
+        const meminfo_table_struct *entry;
+        unsigned long num;
+        unsigned len;
+
+        if (end - head > 5 && !memcmp(head, "Node ", 5)) {
+            for (head += 5; *head >= '0' && *head <= '9'; head++)
+                ;
+            if (*head == ' ')
+                ++head;
+        }
+        if (!(tail = memchr(head, ':', end - head)))
+            break;
+        len = tail - head;
+        entry = &meminfo_table[len ? meminfo_hash(head, len) : 0];
+        if (len && entry->len == len && !memcmp(entry->name, head, len)) {
+            for (head = tail + 1; *head == ' '; head++)
+                ;
+            for (num = 0; *head >= '0' && *head <= '9'; head++)
+                num = num * 10 + (*head - '0');
+            *(unsigned long *)((char *)data + entry->offset) = num;
+            tail = head;
+        }
+        if (!(tail = memchr(tail, '\n', end - tail)))
+            break;
+        head = tail + 1;
+    }
+} // end: meminfo_parse
 
 
 /*
@@ -658,14 +848,8 @@ static int meminfo_make_hash_failed (
 static int meminfo_read_failed (
         struct meminfo_info *info)
 {
- /* a 'memory history reference' macro for readability,
-    so we can focus the field names ... */
- #define mHr(f) info->hist.new. f
     char buf[MEMINFO_BUFF];
-    char *head, *tail;
     int size;
-    unsigned long *valptr;
-    signed long mem_used;
 
     // remember history from last time around
     memcpy(&info->hist.old, &info->hist.new, sizeof(struct meminfo_data));
@@ -701,59 +885,94 @@ static int meminfo_read_failed (
     }
     buf[size] = '\0';
 
-    head = buf;
+    meminfo_parse(&info->hist.new, buf, buf + size);
+    meminfo_derive(&info->hist.new);
+    return 0;
+} // end: meminfo_read_failed
 
-    for (;;) {
-        static __thread ENTRY e;  // keep coverity off our backs (e.data)
-        ENTRY *ep;
 
-        if (!(tail = strchr(head, ':')))
-            break;
-        *tail = '\0';
-        valptr = NULL;
+/*
+ * meminfo_node_read_failed():
+ *
+ * Read the data out of a sysfs nodeN/meminfo file, into that node's
+ * history (which is created as needed). The first read of any node
+ * is copied to its 'old' values, so its deltas start out as zero.
+ */
+static int meminfo_node_read_failed (
+        struct meminfo_info *info,
+        int node)
+{
+    char buf[MEMINFO_BUFF], path[PATH_MAX];
+    struct mem_node *this;
+    int i, size;
 
-        e.key = head;
-        if (hsearch_r(e, FIND, &ep, &info->hashtab))
-            valptr = ep->data;
-        head = tail + 1;
-        if (valptr)
-            *valptr = strtoul(head, NULL, 10);
+    if (node >= info->node_alloc) {
+        if (!(this = realloc(info->node_hist, sizeof(struct mem_node) * (node + 1))))
+            return 1;
+        memset(this + info->node_alloc, 0, sizeof(struct mem_node) * (node + 1 - info->node_alloc));
+        for (i = info->node_alloc; i <= node; i++) {
+            this[i].fd = -1;
+            this[i].hist.node_id = i;
+        }
+        info->node_hist = this;
+        info->node_alloc = node + 1;
+    }
+    this = &info->node_hist[node];
 
-        if (!(tail = strchr(head, '\n')))
-            break;
-        head = tail + 1;
+    if (-1 == this->fd) {
+        snprintf(path, sizeof(path), "%s/node%d/meminfo", NODE_DIR, node);
+        if (-1 == (this->fd = open(path, O_RDONLY)))
+            return 1;
+        this->primed = 0;
+    }
+    // sysfs regenerates an attribute, in full, for each read at offset 0
+    for (;;) {
+        if ((size = pread(this->fd, buf, sizeof(buf)-1, 0)) < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return 1;
+        }
+        break;
     }
+    if (size == 0) {
+        errno = EIO;
+        return 1;
+    }
+    buf[size] = '\0';
 
-    if (0 == mHr(MemAvailable))
-        mHr(MemAvailable) = mHr(MemFree);
-    mHr(derived_mem_cached) = mHr(Cached) + mHr(SReclaimable);
+    memcpy(&this->hist.old, &this->hist.new, sizeof(struct meminfo_data));
+    memset(&this->hist.new, 0, sizeof(struct meminfo_data));
+    meminfo_parse(&this->hist.new, buf, buf + size);
+    meminfo_derive(&this->hist.new);
+    if (!this->primed) {
+        memcpy(&this->hist.old, &this->hist.new, sizeof(struct meminfo_data));
+        this->primed = 1;
+    }
+    return 0;
+} // end: meminfo_node_read_failed
 
-    /* if 'available' is greater than 'total' or our calculation of mem_used
-       overflows, that's symptomatic of running within a lxc container where
-       such values will be dramatically distorted over those of the host. */
-    if (mHr(MemAvailable) > mHr(MemTotal))
-        mHr(MemAvailable) = mHr(MemFree);
-    mem_used = mHr(MemTotal) - mHr(MemAvailable);
-    if (mem_used < 0)
-        mem_used = mHr(MemTotal) - mHr(MemFree);
-    mHr(derived_mem_used) = (unsigned long)mem_used;
 
-    if (mHr(HighFree) < mHr(HighTotal))
-         mHr(derived_mem_hi_used) = mHr(HighTotal) - mHr(HighFree);
+        /*
+         * Close the files of any node no longer in that 'ids' list
+         * (which is ascending), so it starts afresh if it returns. */
+static void meminfo_nodes_offline (
+        struct meminfo_info *info,
+        int *ids,
+        int total)
+{
+    int i, n;
 
-    if (0 == mHr(LowTotal)) {
-        mHr(LowTotal) = mHr(MemTotal);
-        mHr(LowFree)  = mHr(MemFree);
+    for (i = 0, n = 0; i < info->node_alloc; i++) {
+        if (n < total && ids[n] == i) {
+            ++n;
+            continue;
+        }
+        if (-1 != info->node_hist[i].fd) {
+            close(info->node_hist[i].fd);
+            info->node_hist[i].fd = -1;
+        }
     }
-    if (mHr(LowFree) < mHr(LowTotal))
-        mHr(derived_mem_lo_used) = mHr(LowTotal) - mHr(LowFree);
-
-    if (mHr(SwapFree) < mHr(SwapTotal))
-        mHr(derived_swap_used) = mHr(SwapTotal) - mHr(SwapFree);
-
-    return 0;
- #undef mHr
-} // end: meminfo_read_failed
+} // end: meminfo_nodes_offline
 
 
 /*
@@ -768,7 +987,7 @@ static int meminfo_read_failed (
  * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
  */
 static struct stacks_extent *meminfo_stacks_alloc (
-        struct meminfo_info *info,
+        struct ext_support *this,
         int maxstacks)
 {
     struct stacks_extent *p_blob;
@@ -781,7 +1000,7 @@ static struct stacks_extent *meminfo_stacks_alloc (
     vect_size  = sizeof(void *) * maxstacks;                    // size of the addr vectors |
     vect_size += sizeof(void *);                                // plus NULL addr delimiter |
     head_size  = sizeof(struct meminfo_stack);                  // size of that head struct |
-    list_size  = sizeof(struct meminfo_result)*info->numitems;  // any single results stack |
+    list_size  = sizeof(struct meminfo_result)*this->numitems;  // any single results stack |
     blob_size  = sizeof(struct stacks_extent);                  // the extent anchor itself |
     blob_size += vect_size;                                     // plus room for addr vects |
     blob_size += head_size * maxstacks;                         // plus room for head thing |
@@ -793,8 +1012,8 @@ static struct stacks_extent *meminfo_stacks_alloc (
     if (NULL == (p_blob = calloc(1, blob_size)))
         return NULL;
 
-    p_blob->next = info->extents;                               // push this extent onto... |
-    info->extents = p_blob;                                     // ...some existing extents |
+    p_blob->next = this->extents;                               // push this extent onto... |
+    this->extents = p_blob;                                     // ...some existing extents |
     p_vect = (void *)p_blob + sizeof(struct stacks_extent);     // prime our vector pointer |
     p_blob->stacks = p_vect;                                    // set actual vectors start |
     v_head = (void *)p_vect + vect_size;                        // prime head pointer start |
@@ -802,7 +1021,7 @@ static struct stacks_extent *meminfo_stacks_alloc (
 
     for (i = 0; i < maxstacks; i++) {
         p_head = (struct meminfo_stack *)v_head;
-        p_head->head = meminfo_itemize_stack((struct meminfo_result *)v_list, info->numitems, info->items);
+        p_head->head = meminfo_itemize_stack((struct meminfo_result *)v_list, this->numitems, this->items);
         p_blob->stacks[i] = p_head;
         v_list += list_size;
         v_head += head_size;
@@ -812,6 +1031,30 @@ static struct stacks_extent *meminfo_stacks_alloc (
 } // end: meminfo_stacks_alloc
 
 
+static int meminfo_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum meminfo_item *items,
+        int numitems)
+{
+    if (meminfo_items_check_failed(numitems, items))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum meminfo_item) * numitems)) {
+        // allow for our MEMINFO_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum meminfo_item) * (numitems + 1))))
+            return -1;
+        memcpy(this->items, items, sizeof(enum meminfo_item) * numitems);
+        this->items[numitems] = MEMINFO_logical_end;
+        this->numitems = numitems + 1;
+        meminfo_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: meminfo_stacks_reconfig_maybe
+
+
 // ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 // --- standard required functions --------------------------------------------
@@ -851,11 +1094,7 @@ PROCPS_EXPORT int procps_meminfo_new (
 
     p->refcount = 1;
     p->meminfo_fd = -1;
-
-    if (meminfo_make_hash_failed(p)) {
-        free(p);
-        return -errno;
-    }
+    p->hist.node_id = -1;
 
     /* do a priming read here for the following potential benefits: |
          1) ensure there will be no problems with subsequent access |
@@ -895,12 +1134,17 @@ PROCPS_EXPORT int procps_meminfo_unref (
 
         if ((*info)->meminfo_fd != -1)
             close((*info)->meminfo_fd);
+        if ((*info)->node_hist) {
+            meminfo_nodes_offline(*info, NULL, 0);
+            free((*info)->node_hist);
+        }
 
-        if ((*info)->extents)
-            meminfo_extents_free_all((*info));
-        if ((*info)->items)
-            free((*info)->items);
-        hdestroy_r(&(*info)->hashtab);
+        meminfo_extents_free_all(&(*info)->select);
+        if ((*info)->select.items)
+            free((*info)->select.items);
+        meminfo_extents_free_all(&(*info)->nodes);
+        if ((*info)->nodes.items)
+            free((*info)->nodes.items);
 
         free(*info);
         *info = NULL;
@@ -945,6 +1189,56 @@ PROCPS_EXPORT struct meminfo_result *procps_meminfo_get (
 } // end: procps_meminfo_get
 
 
+/* procps_meminfo_reap():
+ *
+ * Harvest the requested MEM and/or SWAP information for each of the
+ * numa nodes, from the sysfs nodeN/meminfo files, then return it in
+ * a results stack per node (in node number order).
+ *
+ * Note: only some of the /proc/meminfo fields have a per node value.
+ *
+ * Returns: pointer to a meminfo_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct meminfo_reaped *procps_meminfo_reap (
+        struct meminfo_info *info,
+        enum meminfo_item *items,
+        int numitems)
+{
+    int ids[NUMA_NODES_MAX];
+    int i, n, total;
+
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > meminfo_stacks_reconfig_maybe(&info->nodes, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    // without numa (or that sysfs directory), there simply are no nodes
+    if (0 > (total = numa_nodes_online(ids, NUMA_NODES_MAX)))
+        total = 0;
+    // a node which goes offline as we read is ignored, just like the rest
+    for (i = 0, n = 0; i < total; i++)
+        if (!meminfo_node_read_failed(info, ids[i]))
+            ids[n++] = ids[i];
+    meminfo_nodes_offline(info, ids, n);
+
+    if (!info->nodes.extents
+    || info->nodes.extents->ext_numstacks != n) {
+        meminfo_extents_free_all(&info->nodes);
+        if (!meminfo_stacks_alloc(&info->nodes, n))
+            return NULL;
+    }
+    for (i = 0; i < n; i++)
+        meminfo_assign_results(info->nodes.extents->stacks[i], &info->node_hist[ids[i]].hist);
+
+    info->reaped.total = n;
+    info->reaped.stacks = info->nodes.extents->stacks;
+    errno = 0;               // (some node we skipped may have set it)
+    return &info->reaped;
+} // end: procps_meminfo_reap
+
+
 /* procps_meminfo_select():
  *
  * Harvest all the requested MEM and/or SWAP information then return
@@ -960,35 +1254,109 @@ PROCPS_EXPORT struct meminfo_stack *procps_meminfo_select (
     errno = EINVAL;
     if (info == NULL || items == NULL)
         return NULL;
-    if (meminfo_items_check_failed(numitems, items))
-        return NULL;
+    if (0 > meminfo_stacks_reconfig_maybe(&info->select, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
     errno = 0;
 
-    /* is this the first time or have things changed since we were last called?
-       if so, gotta' redo all of our stacks stuff ... */
-    if (info->numitems != numitems + 1
-    || memcmp(info->items, items, sizeof(enum meminfo_item) * numitems)) {
-        // allow for our MEMINFO_logical_end
-        if (!(info->items = realloc(info->items, sizeof(enum meminfo_item) * (numitems + 1))))
-            return NULL;
-        memcpy(info->items, items, sizeof(enum meminfo_item) * numitems);
-        info->items[numitems] = MEMINFO_logical_end;
-        info->numitems = numitems + 1;
-        if (info->extents)
-            meminfo_extents_free_all(info);
-    }
-    if (!info->extents
-    && (!meminfo_stacks_alloc(info, 1)))
+    if (!info->select.extents
+    && (!meminfo_stacks_alloc(&info->select, 1)))
        return NULL;
 
     if (meminfo_read_failed(info))
         return NULL;
-    meminfo_assign_results(info->extents->stacks[0], &info->hist);
+    meminfo_assign_results(info->select.extents->stacks[0], &info->hist);
 
-    return info->extents->stacks[0];
+    return info->select.extents->stacks[0];
 } // end: procps_meminfo_select
 
 
+/* procps_meminfo_select_node():
+ *
+ * Just like procps_meminfo_select, but for a single numa node.  The
+ * stack returned is the one also used by procps_meminfo_select.
+ *
+ * Returns: pointer to a meminfo_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct meminfo_stack *procps_meminfo_select_node (
+        struct meminfo_info *info,
+        int node,
+        enum meminfo_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (node < 0 || node >= NUMA_NODES_MAX)
+        return NULL;
+    if (0 > meminfo_stacks_reconfig_maybe(&info->select, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select.extents
+    && (!meminfo_stacks_alloc(&info->select, 1)))
+       return NULL;
+
+    if (meminfo_node_read_failed(info, node))
+        return NULL;
+    meminfo_assign_results(info->select.extents->stacks[0], &info->node_hist[node].hist);
+
+    return info->select.extents->stacks[0];
+} // end: procps_meminfo_select_node
+
+
+/*
+ * procps_meminfo_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct meminfo_stack **procps_meminfo_sort (
+        struct meminfo_info *info,
+        struct meminfo_stack *stacks[],
+        int numstacked,
+        enum meminfo_item sortitem,
+        enum meminfo_sort_order order)
+{
+    struct meminfo_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // a meminfo_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= MEMINFO_logical_end)
+        return NULL;
+    if (order != MEMINFO_SORT_ASCEND && order != MEMINFO_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= MEMINFO_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    if (!mergesort_r(stacks, numstacked, (QSR_t)Item_table[p->item].sortfunc, &parms))
+        return NULL;
+    return stacks;
+} // end: procps_meminfo_sort
+
+
 // --- special debugging function(s) ------------------------------------------
 /*
  *  The following isn't part of the normal programming interface.  Rather,
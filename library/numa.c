@@ -19,9 +19,14 @@
  */
 
 #ifndef NUMA_DISABLE
-#include <dlfcn.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
 #endif
 #include <stdlib.h>
+#include <string.h>
 
 #include "numa.h"
 
@@ -29,10 +34,24 @@
  * We're structured so that if numa_init() is NOT called or that ./configure |
  * --disable-numa WAS specified, then calls to both of our primary functions |
  * of numa_max_node() plus numa_node_of_cpu() would always return a negative |
- * 1 which signifies that NUMA information isn't available. That ./configure |
- * option might be required when libdl.so (necessary for dlopen) is missing. |
+ * 1 which signifies that NUMA information isn't available.                  |
+ *                                                                           |
+ * Otherwise, the node of every cpu is gathered just once from that sysfs    |
+ * node directory (which is what libnuma itself would consult), then each    |
+ * lookup is a simple array index. The <STAT> interface will call for that   |
+ * array to be rebuilt whenever it sees a cpu brought online or offline.     |
+ *                                                                           |
+ * Since <STAT> and <PIDS> may be used from different threads (as top does), |
+ * a rebuilt map is published with a single pointer store and the old one is |
+ * merely retired. It can't be known when a reader is finished with it, but  |
+ * such maps are small and only change with cpu hotplug.                     |
  */
 
+#ifndef NODE_DIR                       // (tests may substitute their own)
+#define NODE_DIR  "/sys/devices/system/node"
+#endif
+#define CPUS_INCR  64                  // amount 'cpu nodes' allocations grow
+
 
 /* ------------------------------------------------------------------------- +
    a strictly development #define, existing specifically for the top program |
@@ -41,23 +60,171 @@
 // ------------------------------------------------------------------------- +
 
 
-static int null_max_node (void) { return -1; }
-static int null_node_of_cpu (int n) { (void)n; return -1; }
+static struct numa_map numa_none = { NULL, -1, 0 };
+struct numa_map *numa_map = &numa_none; // the current map, never NULL
 
 
 #ifndef NUMA_DISABLE
+        /*
+         * Record 'node' for every cpu in a cpulist such as "0-3,8,10-11",
+         * growing that array as needed. Returns 0 if memory was exhausted. */
+static int numa_cpulist (
+        int **nodes,
+        int *total,
+        const char *list,
+        int node)
+{
+    int *p, beg, end, i;
+    char *q;
+
+    while (*list >= '0' && *list <= '9') {
+        beg = end = strtol(list, &q, 10);
+        if (*q == '-')
+            end = strtol(q + 1, &q, 10);
+        if (end >= *total) {
+            i = (end / CPUS_INCR + 1) * CPUS_INCR;
+            if (!(p = realloc(*nodes, i * sizeof(int))))
+                return 0;
+            while (*total < i)
+                p[(*total)++] = -1;
+            *nodes = p;
+        }
+        for (i = beg; i <= end; i++)
+            (*nodes)[i] = node;
+        list = (*q == ',') ? q + 1 : q;
+    }
+    return 1;
+} // end: numa_cpulist
+
+
+ #ifndef PRETEND_NUMA
+        /*
+         * Build the map from each nodeN/cpulist in that sysfs directory,
+         * whose absence means the kernel lacks CONFIG_NUMA (so no nodes).
+         * Returns 0 if the map could not be built. */
+static int numa_sysfs (
+        int **nodes,
+        int *total,
+        int *hwm)
+{
+    char path[PATH_MAX], buf[8192];
+    struct dirent *ent;
+    int fd, n, node;
+    DIR *dir;
+
+    if (!(dir = opendir(NODE_DIR)))
+        return 0;
+    while ((ent = readdir(dir))) {
+        if (strncmp(ent->d_name, "node", 4)
+        || ent->d_name[4] < '0' || ent->d_name[4] > '9')
+            continue;
+        node = atoi(ent->d_name + 4);
+        if (node > *hwm)
+            *hwm = node;
+        snprintf(path, sizeof(path), "%s/%s/cpulist", NODE_DIR, ent->d_name);
+        if (-1 == (fd = open(path, O_RDONLY)))
+            continue;
+        n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n <= 0)
+            continue;
+        buf[n] = '\0';
+        if (!numa_cpulist(nodes, total, buf, node)) {
+            closedir(dir);
+            return 0;
+        }
+    }
+    closedir(dir);
+    return 1;
+} // end: numa_sysfs
+
+ #else
+static int numa_pretend (
+        int **nodes,
+        int *total,
+        int *hwm)
+{
+    char buf[32];
+    int n, cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+    // node 1 is absent, node 0 gets what would've been its cpus
+    for (n = 0; n < cpus; n++) {
+        snprintf(buf, sizeof(buf), "%d", n);
+        if (!numa_cpulist(nodes, total, buf, (1 == (n % 4)) ? 0 : (n % 4)))
+            return 0;
+    }
+    *hwm = 3;
+    return 1;
+} // end: numa_pretend
+ #endif
+#endif
+
+
+        /*
+         * (Re)build the cpu to node map. The new map is completed before
+         * it replaces the old one, so a failure leaves the old one intact.
+         * That old one is chained from the new, but not freed, since some
+         * other thread may be in the midst of a lookup. */
+void numa_refresh (void) {
+#ifndef NUMA_DISABLE
+    int *nodes = NULL, total = 0, hwm = -1;
+    struct numa_map *m;
+
  #ifdef PRETEND_NUMA
-static int fake_max_node (void) { return 3; }
-static int fake_node_of_cpu (int n) { return (1 == (n % 4)) ? 0 : (n % 4); }
+    if (!numa_pretend(&nodes, &total, &hwm)
+ #else
+    if (!numa_sysfs(&nodes, &total, &hwm)
  #endif
+    || !(m = malloc(sizeof(struct numa_map) + total * sizeof(int)))) {
+        free(nodes);
+        return;
+    }
+    if (total)
+        memcpy(m->nodes, nodes, total * sizeof(int));
+    free(nodes);
+    m->hwm = hwm;
+    m->total = total;
+    m->retired = numa_map;
+    __atomic_store_n(&numa_map, m, __ATOMIC_RELEASE);
 #endif
+} // end: numa_refresh
 
 
+        /*
+         * Store the node numbers from that sysfs 'online' file, a list such
+         * as "0-3" or "0,2", though never more than 'max' of them. Returns
+         * the number stored, or -1 if the file could not be read. */
+int numa_nodes_online (
+        int *ids,
+        int max)
+{
 #ifndef NUMA_DISABLE
-static void *libnuma_handle;
+    char path[PATH_MAX], buf[1024], *p, *q;
+    int fd, n, beg, end;
+
+    snprintf(path, sizeof(path), "%s/online", NODE_DIR);
+    if (-1 == (fd = open(path, O_RDONLY)))
+        return -1;
+    n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n < 0)
+        return -1;
+    buf[n] = '\0';
+
+    for (n = 0, p = buf; n < max && *p >= '0' && *p <= '9'; ) {
+        beg = end = strtol(p, &q, 10);
+        if (*q == '-')
+            end = strtol(q + 1, &q, 10);
+        while (beg <= end && n < max)
+            ids[n++] = beg++;
+        p = (*q == ',') ? q + 1 : q;
+    }
+    return n;
+#else
+    (void)ids; (void)max;
+    return 0;
 #endif
-int (*numa_max_node) (void)   = null_max_node;
-int (*numa_node_of_cpu) (int) = null_node_of_cpu;
+} // end: numa_nodes_online
 
 
 void numa_init (void) {
@@ -65,47 +232,14 @@ void numa_init (void) {
 
     if (initialized)
         return;
-
-#ifndef NUMA_DISABLE
- #ifndef PRETEND_NUMA
-    // we'll try for the most recent version, then a version we know works...
-    if ((libnuma_handle = dlopen("libnuma.so", RTLD_LAZY))
-    || (libnuma_handle = dlopen("libnuma.so.1", RTLD_LAZY))) {
-        numa_max_node = dlsym(libnuma_handle, "numa_max_node");
-        numa_node_of_cpu = dlsym(libnuma_handle, "numa_node_of_cpu");
-        if (numa_max_node == NULL
-        || (numa_node_of_cpu == NULL)) {
-            // this dlclose is safe - we've yet to call numa_node_of_cpu
-            // ( there's one other dlclose which has now been disabled )
-            dlclose(libnuma_handle);
-            libnuma_handle = NULL;
-            numa_max_node = null_max_node;
-            numa_node_of_cpu = null_node_of_cpu;
-        }
-    }
- #else
-    libnuma_handle = (void *)-1;
-    numa_max_node = fake_max_node;
-    numa_node_of_cpu = fake_node_of_cpu;
- #endif
-#endif
+    numa_refresh();
     initialized = 1;
 } // end: numa_init
 
 
 void numa_uninit (void) {
-#ifndef PRETEND_NUMA
-    /* note: we'll skip a dlcose() to avoid the following libnuma memory
-     *       leak which is triggered after a call to numa_node_of_cpu():
-     *         ==1234== LEAK SUMMARY:
-     *         ==1234==    definitely lost: 512 bytes in 1 blocks
-     *         ==1234==    indirectly lost: 48 bytes in 2 blocks
-     *         ==1234==    ...
-     * [ thanks very much libnuma for all the pains you have caused us ]
-     */
-//  if (libnuma_handle)
-//      dlclose(libnuma_handle);
-#endif
+    /* note: since the <PIDS> and <STAT> interfaces share our maps,
+     *       they outlive any single one of them (and are never freed) */
 } // end: numa_uninit
 
 
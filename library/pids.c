@@ -24,6 +24,7 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,8 +34,10 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "delayacct.h"
 #include "devname.h"
 #include "numa.h"
+#include "procevents.h"
 #include "readproc.h"
 #include "sort.h"
 #include "wchan.h"
@@ -49,6 +52,10 @@
 #define STACKS_GROW  128               // amount reap stack allocations grow
 #define NEWOLD_INIT  1024              // amount for initial hist allocation
 #define NEWOLD_GROW  128               // amt by which hist allocations grow
+#define PINS_MAX     256               // most pids 'select' will keep pinned
+#define GROUP_HASH   64                // initial interned group keys hash size
+#define GROUP_GROW   64                // amount group stack allocations grow
+#define DELAYS_RETRY 10                // secs before again trying taskstats
 
 /* ------------------------------------------------------------------------- +
    this provision can be used to ensure that our Item_table was synchronized |
@@ -73,8 +80,59 @@ struct fetch_support {
     struct pids_counts counts;         // actual counts pointed to by 'results'
 };
 
+struct group_node {
+    struct group_node *next;           // next in this key's hash bucket
+    char *key;                         // the interned key (a group's name)
+    unsigned hash;                     // its full hash value, for regrowth
+    unsigned stamp;                    // last procps_pids_group to see it
+    int slot;                          // its aggregate stack, as of then
+};
+
+struct group_support {
+    struct group_node **hash;          // the interned keys, via their 'next'
+    unsigned hashsiz;                  // buckets in above hash (a power of 2)
+    int numnodes;                      // total nodes, governing hash growth
+    unsigned stamp;                    // bumped with each procps_pids_group
+    unsigned char *ops;                // how each result is to be aggregated
+    struct pids_result *lists;         // every aggregate stack's results,
+    struct pids_stack *heads;          // their heads,
+    struct pids_stack **stacks;        // and their addresses (NULL delimited)
+    int n_alloc;                       // the number of above stacks,
+    int n_items;                       // each having this many results
+    struct pids_fetch results;         // counts + stacks for return to caller
+    struct pids_counts counts;         // actual counts pointed to by 'results'
+};
+
+struct delay_task {
+    int tid;                           // for the history lookup, along with
+    unsigned long long began;          // this start time (as tics)
+    int slot;                          // its history slot this fetch (or -1)
+    unsigned long long cpu;            // the /proc fallbacks, should taskstats
+    unsigned long long blkio;          // not be available (as nanoseconds)
+};
+
 typedef void (*SET_t)(struct pids_info *, struct pids_result *, proc_t *);
 
+        /*
+         * These are the proc_t values which history support can remember
+         * from one fetch to the next, yielding deltas (and rates) for any
+         * items requiring them. Such items identify those needed via the
+         * Item_table 'needhist' bits, as in HS(TIC) | HS(RBY) ... */
+enum pids_hsrc {
+    hs_TIC,                            // utime + stime
+    hs_MAJ, hs_MIN,                    // maj_flt, min_flt
+    hs_RBY, hs_RCH, hs_ROP,            // read_bytes, rchar, syscr
+    hs_WBY, hs_WCB, hs_WCH, hs_WOP,    // write_bytes, cancelled_write_bytes, wchar, syscw
+    hs_SRN, hs_SWT, hs_STS,            // sched_runtime, sched_wait, sched_slices
+    hs_CSV, hs_CSI,                    // ctxsw_vol, ctxsw_invol
+    hs_CPU, hs_MIG,                    // processor, migrations seen (derived)
+    hs_NOD, hs_RES,                    // processor's node, on it since (derived)
+    hs_DBI, hs_DCP, hs_DFP, hs_DSW,    // delays: blkio, cpu, freepages, swapin,
+    hs_DTH,                            // thrashing (these must remain last)
+    HS_NUMSRC
+};
+#define HS(s)  (1 << hs_ ## s)
+
 struct pids_info {
     int refcount;
     int maxitems;                      // includes 'logical_end' delimiter
@@ -82,8 +140,14 @@ struct pids_info {
     struct stacks_extent *extents;     // anchor for all resettable extents
     struct stacks_extent *otherexts;   // anchor for invariant extents // <=== currently unused
     struct fetch_support fetch;        // support for procps_pids_reap, select, fatal
-    int history_yes;                   // need historical data
+    int history_yes;                   // need historical data (as HS bits)
     struct history_info *hist;         // pointer to historical support data
+    unsigned long long hist_deltas[HS_NUMSRC]; // current task's deltas, via pids_make_hist
+    double hist_elapsed;               // seconds between the last two fetches
+    int smaps_topk;                    // smaps_rollup sampling, tasks by rss always read
+    unsigned long long smaps_budget;   // plus others, while under this many ns per fetch
+    int smaps_yes;                     // sampling is active & some smaps item was wanted
+    double smaps_age;                  // current task's smaps age, via pids_make_smaps
     proc_t*(*read_something)(PROCTAB*, proc_t*); // readproc/readeither via which
     unsigned pgs2k_shift;              // to convert some proc values
     unsigned oldflags;                 // the old library PROC_FILL flagss
@@ -99,6 +163,22 @@ struct pids_info {
     SET_t *func_array;                 // extracted Item_table 'setsfunc' pointers
     int containers_yes;                // need to call pids_containers_check
     unsigned *select_ids;              // copy of user 'these' (pids/uids)
+    PINTAB *pins;                      // pinned /proc/<pid> for 'select' pids
+    int numpins;                       // total pins (excluding the delimiter)
+    int events_yes;                    // getenv LIBPROC_PROC_EVENTS was set
+    struct procevents *events;         // cn_proc live tgids for 'reap' (maybe)
+    PINTAB *evpins;                    // the 'once' list built from the above
+    int evalloc;                       // number of above evpins allocated
+    struct group_support *group;       // for procps_pids_group (maybe)
+    int delays_yes;                    // some DELAY item was wanted
+    unsigned long long delays_retry;   // CLOCK_MONOTONIC ns, no taskstats until
+    int delays_tgid;                   // ask about whole thread groups, not tids
+    struct delayacct *delayacct;       // that taskstats source (maybe)
+    struct delay_task *delays;         // each task's delay particulars, this fetch
+    pid_t *delay_ids;                  // plus their ids for delayacct_fetch
+    struct delayacct_vals *delay_vals; // and the values it returned
+    int delays_alloc;                  // number of each of the above allocated
+    struct delayacct_vals delay_now;   // current task's delays, via pids_delays_fill
 };
 
 
@@ -154,6 +234,15 @@ static const char *pids_sched_to_classstr (
 #define DUP_set(e,x) setDECL(e) { \
     freNAME(str)(R); \
     if (!(R->result.str = strdup(P-> x))) I->seterr = 1; }
+/* a history delta, courtesy of pids_make_hist */
+#define HDL_set(e,t,s) setDECL(e) { \
+    (void)P; R->result. t = I->hist_deltas[hs_ ## s]; }
+/* a delay, courtesy of pids_delays_fill */
+#define DLY_set(e,x) setDECL(e) { \
+    (void)P; R->result.ull_int = I->delay_now. x; }
+/* a history delta, as a per second rate */
+#define HRT_set(e,s) setDECL(e) { \
+    (void)P; R->result.real = I->hist_elapsed > 0.0 ? I->hist_deltas[hs_ ## s] / I->hist_elapsed : 0.0; }
 /* regular assignment copy */
 #define REG_set(e,t,x) setDECL(e) { \
     (void)I; R->result. t = P-> x; }
@@ -184,12 +273,27 @@ REG_set(ADDR_STACK_START, ul_int,  start_stack)
 REG_set(AUTOGRP_ID,       s_int,   autogrp_id)
 REG_set(AUTOGRP_NICE,     s_int,   autogrp_nice)
 DUP_set(CAPS_PERMITTED,            capprm)
-STR_set(CGNAME,                    cgname)
-STR_set(CGROUP,                    cgroup)
+REG_set(CGNAME,           str,     cgname)
+REG_set(CGROUP,           str,     cgroup)
 VEC_set(CGROUP_V,                  cgroup_v)
 STR_set(CMD,                       cmd)
 STR_set(CMDLINE,                   cmdline)
 VEC_set(CMDLINE_V,                 cmdline_v)
+setDECL(CPUS_ALLOWED)   { static const struct pids_cpus none; (void)I; R->result.cpus = P->cpus ? P->cpus : &none; }
+REG_set(CTXSW_INVOL,      ul_int,  ctxsw_invol)
+HDL_set(CTXSW_INVOL_DELTA,         ul_int,  CSI)
+REG_set(CTXSW_VOL,        ul_int,  ctxsw_vol)
+HDL_set(CTXSW_VOL_DELTA,           ul_int,  CSV)
+DLY_set(DELAY_BLKIO_NS,            blkio)
+HDL_set(DELAY_BLKIO_NS_DELTA,      ull_int, DBI)
+DLY_set(DELAY_CPU_NS,              cpu)
+HDL_set(DELAY_CPU_NS_DELTA,        ull_int, DCP)
+DLY_set(DELAY_FREEPAGES_NS,        freepages)
+HDL_set(DELAY_FREEPAGES_NS_DELTA,  ull_int, DFP)
+DLY_set(DELAY_SWAPIN_NS,           swapin)
+HDL_set(DELAY_SWAPIN_NS_DELTA,     ull_int, DSW)
+DLY_set(DELAY_THRASH_NS,           thrashing)
+HDL_set(DELAY_THRASH_NS_DELTA,     ull_int, DTH)
 REG_set(DOCKER_ID,        str,     dockerid)
 REG_set(DOCKER_ID_64,     str,     dockerid_64)
 STR_set(ENVIRON,                   environ)
@@ -200,9 +304,12 @@ REG_set(FLAGS,            ul_int,  flags)
 REG_set(FLT_MAJ,          ul_int,  maj_flt)
 setDECL(FLT_MAJ_C)      { (void)I; R->result.ul_int = P->maj_flt + P->cmaj_flt; }
 REG_set(FLT_MAJ_DELTA,    s_int,   maj_delta)
+HRT_set(FLT_MAJ_RATE,              MAJ)
 REG_set(FLT_MIN,          ul_int,  min_flt)
 setDECL(FLT_MIN_C)      { (void)I; R->result.ul_int = P->min_flt + P->cmin_flt; }
 REG_set(FLT_MIN_DELTA,    s_int,   min_delta)
+HRT_set(FLT_MIN_RATE,              MIN)
+setDECL(GROUP_TASKS)    { (void)I; (void)P; R->result.s_int = 1; }
 REG_set(ID_EGID,          u_int,   egid)
 REG_set(ID_EGROUP,        str,     egroup)
 REG_set(ID_EUID,          u_int,   euid)
@@ -228,12 +335,26 @@ REG_set(ID_TGID,          s_int,   tgid)
 REG_set(ID_TID,           s_int,   tid)
 REG_set(ID_TPGID,         s_int,   tpgid)
 REG_set(IO_READ_BYTES,    ul_int,  read_bytes)
+HDL_set(IO_READ_BYTES_DELTA,       ul_int,  RBY)
+HRT_set(IO_READ_BYTES_RATE,        RBY)
 REG_set(IO_READ_CHARS,    ul_int,  rchar)
+HDL_set(IO_READ_CHARS_DELTA,       ul_int,  RCH)
+HRT_set(IO_READ_CHARS_RATE,        RCH)
 REG_set(IO_READ_OPS,      ul_int,  syscr)
+HDL_set(IO_READ_OPS_DELTA,         ul_int,  ROP)
+HRT_set(IO_READ_OPS_RATE,          ROP)
 REG_set(IO_WRITE_BYTES,   ul_int,  write_bytes)
+HDL_set(IO_WRITE_BYTES_DELTA,      ul_int,  WBY)
+HRT_set(IO_WRITE_BYTES_RATE,       WBY)
 REG_set(IO_WRITE_CBYTES,  ul_int,  cancelled_write_bytes)
+HDL_set(IO_WRITE_CBYTES_DELTA,     ul_int,  WCB)
+HRT_set(IO_WRITE_CBYTES_RATE,      WCB)
 REG_set(IO_WRITE_CHARS,   ul_int,  wchar)
+HDL_set(IO_WRITE_CHARS_DELTA,      ul_int,  WCH)
+HRT_set(IO_WRITE_CHARS_RATE,       WCH)
 REG_set(IO_WRITE_OPS,     ul_int,  syscw)
+HDL_set(IO_WRITE_OPS_DELTA,        ul_int,  WOP)
+HRT_set(IO_WRITE_OPS_RATE,         WOP)
 REG_set(LXCNAME,          str,     lxcname)
 CVT_set(MEM_CODE,         ul_int,  trs)
 REG_set(MEM_CODE_PGS,     ul_int,  trs)
@@ -261,23 +382,34 @@ REG_set(OPEN_FILES,       s_int,   fds)
 REG_set(PRIORITY,         s_int,   priority)
 REG_set(PRIORITY_RT,      s_int,   rtprio)
 REG_set(PROCESSOR,        s_int,   processor)
+HDL_set(PROCESSOR_MIGRATED,        s_int,   CPU)
+HDL_set(PROCESSOR_MIGRATIONS,      ul_int,  MIG)
 setDECL(PROCESSOR_NODE) { (void)I; R->result.s_int = numa_node_of_cpu(P->processor); }
+HDL_set(PROCESSOR_NODE_MIGRATED,   s_int,   NOD)
+setDECL(PROCESSOR_NODE_RESIDENT) { (void)P; R->result.real = I->hist_deltas[hs_RES] / 1.0e9; }
 REG_set(RSS,              ul_int,  rss)
 REG_set(RSS_RLIM,         ul_int,  rss_rlim)
 REG_set(SCHED_CLASS,      s_int,   sched)
 setDECL(SCHED_CLASSSTR) { (void)I; R->result.str = (char *)pids_sched_to_classstr(P); }
+REG_set(SCHED_RUNTIME_NS, ull_int, sched_runtime)
+HDL_set(SCHED_RUNTIME_NS_DELTA,    ull_int, SRN)
+REG_set(SCHED_TIMESLICES, ul_int,  sched_slices)
+HDL_set(SCHED_TIMESLICES_DELTA,    ul_int,  STS)
+REG_set(SCHED_WAIT_NS,    ull_int, sched_wait)
+HDL_set(SCHED_WAIT_NS_DELTA,       ull_int, SWT)
 STR_set(SD_MACH,                   sd_mach)
 STR_set(SD_OUID,                   sd_ouid)
 STR_set(SD_SEAT,                   sd_seat)
 STR_set(SD_SESS,                   sd_sess)
-STR_set(SD_SLICE,                  sd_slice)
-STR_set(SD_UNIT,                   sd_unit)
-STR_set(SD_UUNIT,                  sd_uunit)
+REG_set(SD_SLICE,         str,     sd_slice)
+REG_set(SD_UNIT,          str,     sd_unit)
+REG_set(SD_UUNIT,         str,     sd_uunit)
 DUP_set(SIGBLOCKED,                blocked)
 DUP_set(SIGCATCH,                  sigcatch)
 DUP_set(SIGIGNORE,                 sigignore)
 DUP_set(SIGNALS,                   signal)
 DUP_set(SIGPENDING,                _sigpnd)
+setDECL(SMAP_AGE)       { (void)P; R->result.real = I->smaps_age; }
 REG_set(SMAP_ANONYMOUS,   ul_int,  smap_Anonymous)
 REG_set(SMAP_HUGE_ANON,   ul_int,  smap_AnonHugePages)
 REG_set(SMAP_HUGE_FILE,   ul_int,  smap_FilePmdMapped)
@@ -340,6 +472,8 @@ setDECL(WCHAN_NAME)     { freNAME(str)(R); if (!(R->result.str = strdup(lookup_w
 #undef setDECL
 #undef CVT_set
 #undef DUP_set
+#undef HDL_set
+#undef HRT_set
 #undef REG_set
 #undef STR_set
 #undef VEC_set
@@ -383,6 +517,12 @@ srtDECL(str) {
     return P->order * strcoll(a->result.str, b->result.str);
 }
 
+srtDECL(cpus) {
+    const struct pids_result *a = (*A)->head + P->offset;
+    const struct pids_result *b = (*B)->head + P->offset;
+    return P->order * (a->result.cpus->count - b->result.cpus->count);
+}
+
 srtDECL(strv) {
     const struct pids_result *a = (*A)->head + P->offset;
     const struct pids_result *b = (*B)->head + P->offset;
@@ -408,7 +548,8 @@ srtDECL(noop) {
 
 // ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-#define f_either   PROC_SPARE_1        // either status or stat (favor stat)
+#define f_cpus     PROC_FILL_CPUS
+#define f_either   PROC_SPARE_2        // either status or stat (favor stat)
 #define f_exe      PROC_FILL_EXE
 #define f_fds      PROC_FILL_FDS
 #define f_grp      PROC_FILLGRP
@@ -417,6 +558,7 @@ srtDECL(noop) {
 #define f_lxc      PROC_FILL_LXC
 #define f_ns       PROC_FILLNS
 #define f_oom      PROC_FILLOOM
+#define f_sched    PROC_FILLSCHED
 #define f_smaps    PROC_FILLSMAPS
 #define f_stat     PROC_FILLSTAT
 #define f_statm    PROC_FILLMEM
@@ -465,180 +607,250 @@ static struct {
     unsigned oldflags;            // PROC_FILLxxxx flags for this item
     FRE_t    freefunc;            // free function for strings storage
     QSR_t    sortfunc;            // sort cmp func for a specific type
-    int      needhist;            // a result requires history support
+    int      needhist;            // history sources (HS bits) a result requires
     char    *type2str;            // the result type as a string value
 } Item_table[] = {
-/*    setsfunc               oldflags    freefunc   sortfunc       needhist  type2str
-      ---------------------  ----------  ---------  -------------  --------  ----------- */
-    { RS(noop),              0,          NULL,      QS(noop),      0,        TS_noop     }, // user only, never altered
-    { RS(extra),             0,          NULL,      QS(ull_int),   0,        TS_noop     }, // user only, reset to zero
-
-    { RS(ADDR_CODE_END),     f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(ADDR_CODE_START),   f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(ADDR_CURR_EIP),     f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(ADDR_CURR_ESP),     f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(ADDR_STACK_START),  f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(AUTOGRP_ID),        z_autogrp,  NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(AUTOGRP_NICE),      z_autogrp,  NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(CAPS_PERMITTED),    f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CGNAME),            x_cgroup,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CGROUP),            x_cgroup,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CGROUP_V),          v_cgroup,   FF(strv),  QS(strv),      0,        TS(strv)    },
-    { RS(CMD),               f_either,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CMDLINE),           x_cmdline,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CMDLINE_V),         v_arg,      FF(strv),  QS(strv),      0,        TS(strv)    },
-    { RS(DOCKER_ID),         z_docker,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(DOCKER_ID_64),      z_docker,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(ENVIRON),           x_environ,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(ENVIRON_V),         v_env,      FF(strv),  QS(strv),      0,        TS(strv)    },
-    { RS(EXE),               f_exe,      FF(str),   QS(str),       0,        TS(str)     },
-    { RS(EXIT_SIGNAL),       f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(FLAGS),             f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(FLT_MAJ),           f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(FLT_MAJ_C),         f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(FLT_MAJ_DELTA),     f_stat,     NULL,      QS(s_int),     +1,       TS(s_int)   },
-    { RS(FLT_MIN),           f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(FLT_MIN_C),         f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(FLT_MIN_DELTA),     f_stat,     NULL,      QS(s_int),     +1,       TS(s_int)   },
-    { RS(ID_EGID),           0,          NULL,      QS(u_int),     0,        TS(u_int)   }, // oldflags: free w/ simple_read
-    { RS(ID_EGROUP),         f_grp,      NULL,      QS(str),       0,        TS(str)     },
-    { RS(ID_EUID),           0,          NULL,      QS(u_int),     0,        TS(u_int)   }, // oldflags: free w/ simple_read
-    { RS(ID_EUSER),          f_usr,      NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(ID_FGID),           f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
-    { RS(ID_FGROUP),         x_ogroup,   NULL,      QS(str),       0,        TS(str)     },
-    { RS(ID_FUID),           f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
-    { RS(ID_FUSER),          x_ouser,    NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(ID_LOGIN),          f_login,    NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(ID_PGRP),           f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(ID_PID),            0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nextpid
-    { RS(ID_PPID),           f_either,   NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(ID_RGID),           f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
-    { RS(ID_RGROUP),         x_ogroup,   NULL,      QS(str),       0,        TS(str)     },
-    { RS(ID_RUID),           f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
-    { RS(ID_RUSER),          x_ouser,    NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(ID_SESSION),        f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(ID_SGID),           f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
-    { RS(ID_SGROUP),         x_ogroup,   NULL,      QS(str),       0,        TS(str)     },
-    { RS(ID_SUID),           f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
-    { RS(ID_SUSER),          x_ouser,    NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(ID_TGID),           0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nextpid
-    { RS(ID_TID),            0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nexttid
-    { RS(ID_TPGID),          f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(IO_READ_BYTES),     f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(IO_READ_CHARS),     f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(IO_READ_OPS),       f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(IO_WRITE_BYTES),    f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(IO_WRITE_CBYTES),   f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(IO_WRITE_CHARS),    f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(IO_WRITE_OPS),      f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(LXCNAME),           f_lxc,      NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(MEM_CODE),          f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_CODE_PGS),      f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_DATA),          f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_DATA_PGS),      f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_RES),           f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_RES_PGS),       f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_SHR),           f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_SHR_PGS),       f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_VIRT),          f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(MEM_VIRT_PGS),      f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NICE),              f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(NLWP),              f_either,   NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(NS_CGROUP),         f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_IPC),            f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_MNT),            f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_NET),            f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_PID),            f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_TIME),           f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_USER),           f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(NS_UTS),            f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(OOM_ADJ),           f_oom,      NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(OOM_SCORE),         f_oom,      NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(OPEN_FILES),        f_fds,      NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(PRIORITY),          f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(PRIORITY_RT),       f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(PROCESSOR),         f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(PROCESSOR_NODE),    f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(RSS),               f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(RSS_RLIM),          f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SCHED_CLASS),       f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(SCHED_CLASSSTR),    f_stat,     NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(SD_MACH),           f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SD_OUID),           f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SD_SEAT),           f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SD_SESS),           f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SD_SLICE),          f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SD_UNIT),           f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SD_UUNIT),          f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGBLOCKED),        f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGCATCH),          f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGIGNORE),         f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGNALS),           f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGPENDING),        f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SMAP_ANONYMOUS),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_HUGE_ANON),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_HUGE_FILE),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_HUGE_SHMEM),   f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_HUGE_TLBPRV),  f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_HUGE_TLBSHR),  f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_LAZY_FREE),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_LOCKED),       f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PRV_CLEAN),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PRV_DIRTY),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PRV_TOTAL),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PSS),          f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PSS_ANON),     f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PSS_FILE),     f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_PSS_SHMEM),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_REFERENCED),   f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_RSS),          f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_SHR_CLEAN),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_SHR_DIRTY),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_SWAP),         f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(SMAP_SWAP_PSS),     f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(STATE),             f_either,   NULL,      QS(s_ch),      0,        TS(s_ch)    },
-    { RS(SUPGIDS),           f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SUPGROUPS),         x_supgrp,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(TICS_ALL),          f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_ALL_C),        f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_ALL_DELTA),    f_stat,     NULL,      QS(u_int),     +1,       TS(u_int)   },
-    { RS(TICS_BEGAN),        f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_BLKIO),        f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_GUEST),        f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_GUEST_C),      f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_SYSTEM),       f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_SYSTEM_C),     f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_USER),         f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TICS_USER_C),       f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
-    { RS(TIME_ALL),          f_stat,     NULL,      QS(real),      0,        TS(real)    },
-    { RS(TIME_ALL_C),        f_stat,     NULL,      QS(real),      0,        TS(real)    },
-    { RS(TIME_ELAPSED),      f_stat,     NULL,      QS(real),      0,        TS(real)    },
-    { RS(TIME_START),        f_stat,     NULL,      QS(real),      0,        TS(real)    },
-    { RS(TTY),               f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(TTY_NAME),          f_stat,     FF(str),   QS(strvers),   0,        TS(str)     },
-    { RS(TTY_NUMBER),        f_stat,     FF(str),   QS(strvers),   0,        TS(str)     },
-    { RS(UTILIZATION),       f_stat,     NULL,      QS(real),      0,        TS(real)    },
-    { RS(UTILIZATION_C),     f_stat,     NULL,      QS(real),      0,        TS(real)    },
-    { RS(VM_DATA),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_EXE),            f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_LIB),            f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_RSS),            f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_RSS_ANON),       f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_RSS_FILE),       f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_RSS_LOCKED),     f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_RSS_SHARED),     f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_SIZE),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_STACK),          f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_SWAP),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VM_USED),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(VSIZE_BYTES),       f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(WCHAN_NAME),        0,          FF(str),   QS(str),       0,        TS(str)     }, // oldflags: tid already free
+/*    setsfunc                       oldflags    freefunc   sortfunc       needhist  type2str
+      -----------------------------  ----------  ---------  -------------  --------  ----------- */
+    { RS(noop),                      0,          NULL,      QS(noop),      0,        TS_noop     }, // user only, never altered
+    { RS(extra),                     0,          NULL,      QS(ull_int),   0,        TS_noop     }, // user only, reset to zero
+
+    { RS(ADDR_CODE_END),             f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(ADDR_CODE_START),           f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(ADDR_CURR_EIP),             f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(ADDR_CURR_ESP),             f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(ADDR_STACK_START),          f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(AUTOGRP_ID),                z_autogrp,  NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(AUTOGRP_NICE),              z_autogrp,  NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(CAPS_PERMITTED),            f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(CGNAME),                    x_cgroup,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(CGROUP),                    x_cgroup,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(CGROUP_V),                  v_cgroup,   FF(strv),  QS(strv),      0,        TS(strv)    },
+    { RS(CMD),                       f_either,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(CMDLINE),                   x_cmdline,  FF(str),   QS(str),       0,        TS(str)     },
+    { RS(CMDLINE_V),                 v_arg,      FF(strv),  QS(strv),      0,        TS(strv)    },
+    { RS(DOCKER_ID),                 z_docker,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(DOCKER_ID_64),              z_docker,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(ENVIRON),                   x_environ,  FF(str),   QS(str),       0,        TS(str)     },
+    { RS(ENVIRON_V),                 v_env,      FF(strv),  QS(strv),      0,        TS(strv)    },
+    { RS(EXE),                       f_exe,      FF(str),   QS(str),       0,        TS(str)     },
+    { RS(EXIT_SIGNAL),               f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(FLAGS),                     f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(FLT_MAJ),                   f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(FLT_MAJ_C),                 f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(FLT_MAJ_DELTA),             f_stat,     NULL,      QS(s_int),     HS(MAJ),  TS(s_int)   },
+    { RS(FLT_MIN),                   f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(FLT_MIN_C),                 f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(FLT_MIN_DELTA),             f_stat,     NULL,      QS(s_int),     HS(MIN),  TS(s_int)   },
+    { RS(ID_EGID),                   0,          NULL,      QS(u_int),     0,        TS(u_int)   }, // oldflags: free w/ simple_read
+    { RS(ID_EGROUP),                 f_grp,      NULL,      QS(str),       0,        TS(str)     },
+    { RS(ID_EUID),                   0,          NULL,      QS(u_int),     0,        TS(u_int)   }, // oldflags: free w/ simple_read
+    { RS(ID_EUSER),                  f_usr,      NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(ID_FGID),                   f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
+    { RS(ID_FGROUP),                 x_ogroup,   NULL,      QS(str),       0,        TS(str)     },
+    { RS(ID_FUID),                   f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
+    { RS(ID_FUSER),                  x_ouser,    NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(ID_LOGIN),                  f_login,    NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(ID_PGRP),                   f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(ID_PID),                    0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nextpid
+    { RS(ID_PPID),                   f_either,   NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(ID_RGID),                   f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
+    { RS(ID_RGROUP),                 x_ogroup,   NULL,      QS(str),       0,        TS(str)     },
+    { RS(ID_RUID),                   f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
+    { RS(ID_RUSER),                  x_ouser,    NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(ID_SESSION),                f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(ID_SGID),                   f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
+    { RS(ID_SGROUP),                 x_ogroup,   NULL,      QS(str),       0,        TS(str)     },
+    { RS(ID_SUID),                   f_status,   NULL,      QS(u_int),     0,        TS(u_int)   },
+    { RS(ID_SUSER),                  x_ouser,    NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(ID_TGID),                   0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nextpid
+    { RS(ID_TID),                    0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nexttid
+    { RS(ID_TPGID),                  f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(IO_READ_BYTES),             f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_READ_CHARS),             f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_READ_OPS),               f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_WRITE_BYTES),            f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_WRITE_CBYTES),           f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_WRITE_CHARS),            f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_WRITE_OPS),              f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(LXCNAME),                   f_lxc,      NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(MEM_CODE),                  f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_CODE_PGS),              f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_DATA),                  f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_DATA_PGS),              f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_RES),                   f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_RES_PGS),               f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_SHR),                   f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_SHR_PGS),               f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_VIRT),                  f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(MEM_VIRT_PGS),              f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NICE),                      f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(NLWP),                      f_either,   NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(NS_CGROUP),                 f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_IPC),                    f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_MNT),                    f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_NET),                    f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_PID),                    f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_TIME),                   f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_USER),                   f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(NS_UTS),                    f_ns,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(OOM_ADJ),                   f_oom,      NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(OOM_SCORE),                 f_oom,      NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(OPEN_FILES),                f_fds,      NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(PRIORITY),                  f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(PRIORITY_RT),               f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(PROCESSOR),                 f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(PROCESSOR_NODE),            f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(RSS),                       f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(RSS_RLIM),                  f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SCHED_CLASS),               f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(SCHED_CLASSSTR),            f_stat,     NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(SD_MACH),                   f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SD_OUID),                   f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SD_SEAT),                   f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SD_SESS),                   f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SD_SLICE),                  f_systemd,  NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(SD_UNIT),                   f_systemd,  NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(SD_UUNIT),                  f_systemd,  NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
+    { RS(SIGBLOCKED),                f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SIGCATCH),                  f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SIGIGNORE),                 f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SIGNALS),                   f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SIGPENDING),                f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SMAP_ANONYMOUS),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_HUGE_ANON),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_HUGE_FILE),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_HUGE_SHMEM),           f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_HUGE_TLBPRV),          f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_HUGE_TLBSHR),          f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_LAZY_FREE),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_LOCKED),               f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PRV_CLEAN),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PRV_DIRTY),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PRV_TOTAL),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PSS),                  f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PSS_ANON),             f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PSS_FILE),             f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_PSS_SHMEM),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_REFERENCED),           f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_RSS),                  f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_SHR_CLEAN),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_SHR_DIRTY),            f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_SWAP),                 f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SMAP_SWAP_PSS),             f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(STATE),                     f_either,   NULL,      QS(s_ch),      0,        TS(s_ch)    },
+    { RS(SUPGIDS),                   f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SUPGROUPS),                 x_supgrp,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(TICS_ALL),                  f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_ALL_C),                f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_ALL_DELTA),            f_stat,     NULL,      QS(u_int),     HS(TIC),  TS(u_int)   },
+    { RS(TICS_BEGAN),                f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_BLKIO),                f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_GUEST),                f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_GUEST_C),              f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_SYSTEM),               f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_SYSTEM_C),             f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_USER),                 f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TICS_USER_C),               f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(TIME_ALL),                  f_stat,     NULL,      QS(real),      0,        TS(real)    },
+    { RS(TIME_ALL_C),                f_stat,     NULL,      QS(real),      0,        TS(real)    },
+    { RS(TIME_ELAPSED),              f_stat,     NULL,      QS(real),      0,        TS(real)    },
+    { RS(TIME_START),                f_stat,     NULL,      QS(real),      0,        TS(real)    },
+    { RS(TTY),                       f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(TTY_NAME),                  f_stat,     FF(str),   QS(strvers),   0,        TS(str)     },
+    { RS(TTY_NUMBER),                f_stat,     FF(str),   QS(strvers),   0,        TS(str)     },
+    { RS(UTILIZATION),               f_stat,     NULL,      QS(real),      0,        TS(real)    },
+    { RS(UTILIZATION_C),             f_stat,     NULL,      QS(real),      0,        TS(real)    },
+    { RS(VM_DATA),                   f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_EXE),                    f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_LIB),                    f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_RSS),                    f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_RSS_ANON),               f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_RSS_FILE),               f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_RSS_LOCKED),             f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_RSS_SHARED),             f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_SIZE),                   f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_STACK),                  f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_SWAP),                   f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_USED),                   f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VSIZE_BYTES),               f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(WCHAN_NAME),                0,          FF(str),   QS(str),       0,        TS(str)     }, // oldflags: tid already free
+    // ( later additions follow, in the very same order as their enums )
+    { RS(FLT_MAJ_RATE),              f_stat,     NULL,      QS(real),      HS(MAJ),  TS(real)    },
+    { RS(FLT_MIN_RATE),              f_stat,     NULL,      QS(real),      HS(MIN),  TS(real)    },
+    { RS(IO_READ_BYTES_DELTA),       f_io,       NULL,      QS(ul_int),    HS(RBY),  TS(ul_int)  },
+    { RS(IO_READ_BYTES_RATE),        f_io,       NULL,      QS(real),      HS(RBY),  TS(real)    },
+    { RS(IO_READ_CHARS_DELTA),       f_io,       NULL,      QS(ul_int),    HS(RCH),  TS(ul_int)  },
+    { RS(IO_READ_CHARS_RATE),        f_io,       NULL,      QS(real),      HS(RCH),  TS(real)    },
+    { RS(IO_READ_OPS_DELTA),         f_io,       NULL,      QS(ul_int),    HS(ROP),  TS(ul_int)  },
+    { RS(IO_READ_OPS_RATE),          f_io,       NULL,      QS(real),      HS(ROP),  TS(real)    },
+    { RS(IO_WRITE_BYTES_DELTA),      f_io,       NULL,      QS(ul_int),    HS(WBY),  TS(ul_int)  },
+    { RS(IO_WRITE_BYTES_RATE),       f_io,       NULL,      QS(real),      HS(WBY),  TS(real)    },
+    { RS(IO_WRITE_CBYTES_DELTA),     f_io,       NULL,      QS(ul_int),    HS(WCB),  TS(ul_int)  },
+    { RS(IO_WRITE_CBYTES_RATE),      f_io,       NULL,      QS(real),      HS(WCB),  TS(real)    },
+    { RS(IO_WRITE_CHARS_DELTA),      f_io,       NULL,      QS(ul_int),    HS(WCH),  TS(ul_int)  },
+    { RS(IO_WRITE_CHARS_RATE),       f_io,       NULL,      QS(real),      HS(WCH),  TS(real)    },
+    { RS(IO_WRITE_OPS_DELTA),        f_io,       NULL,      QS(ul_int),    HS(WOP),  TS(ul_int)  },
+    { RS(IO_WRITE_OPS_RATE),         f_io,       NULL,      QS(real),      HS(WOP),  TS(real)    },
+    { RS(CTXSW_INVOL),               f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(CTXSW_INVOL_DELTA),         f_status,   NULL,      QS(ul_int),    HS(CSI),  TS(ul_int)  },
+    { RS(CTXSW_VOL),                 f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(CTXSW_VOL_DELTA),           f_status,   NULL,      QS(ul_int),    HS(CSV),  TS(ul_int)  },
+    { RS(SCHED_RUNTIME_NS),          f_sched,    NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(SCHED_RUNTIME_NS_DELTA),    f_sched,    NULL,      QS(ull_int),   HS(SRN),  TS(ull_int) },
+    { RS(SCHED_TIMESLICES),          f_sched,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(SCHED_TIMESLICES_DELTA),    f_sched,    NULL,      QS(ul_int),    HS(STS),  TS(ul_int)  },
+    { RS(SCHED_WAIT_NS),             f_sched,    NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(SCHED_WAIT_NS_DELTA),       f_sched,    NULL,      QS(ull_int),   HS(SWT),  TS(ull_int) },
+    { RS(SMAP_AGE),                  f_smaps,    NULL,      QS(real),      0,        TS(real)    },
+    { RS(GROUP_TASKS),               0,          NULL,      QS(s_int),     0,        TS(s_int)   },
+    { RS(DELAY_BLKIO_NS),            f_stat,     NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(DELAY_BLKIO_NS_DELTA),      f_stat,     NULL,      QS(ull_int),   HS(DBI),  TS(ull_int) },
+    { RS(DELAY_CPU_NS),              f_sched,    NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(DELAY_CPU_NS_DELTA),        f_sched,    NULL,      QS(ull_int),   HS(DCP),  TS(ull_int) },
+    { RS(DELAY_FREEPAGES_NS),        0,          NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(DELAY_FREEPAGES_NS_DELTA),  0,          NULL,      QS(ull_int),   HS(DFP),  TS(ull_int) },
+    { RS(DELAY_SWAPIN_NS),           0,          NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(DELAY_SWAPIN_NS_DELTA),     0,          NULL,      QS(ull_int),   HS(DSW),  TS(ull_int) },
+    { RS(DELAY_THRASH_NS),           0,          NULL,      QS(ull_int),   0,        TS(ull_int) },
+    { RS(DELAY_THRASH_NS_DELTA),     0,          NULL,      QS(ull_int),   HS(DTH),  TS(ull_int) },
+    { RS(CPUS_ALLOWED),              f_cpus,     NULL,      QS(cpus),      0,        TS(cpus)    }, // freefunc NULL w/ cached bitmap
+    { RS(PROCESSOR_MIGRATED),        f_stat,     NULL,      QS(s_int),     HS(CPU),  TS(s_int)   },
+    { RS(PROCESSOR_MIGRATIONS),      f_stat,     NULL,      QS(ul_int),    HS(CPU) | HS(MIG), TS(ul_int) },
+    { RS(PROCESSOR_NODE_MIGRATED),   f_stat,     NULL,      QS(s_int),     HS(NOD),  TS(s_int)   },
+    { RS(PROCESSOR_NODE_RESIDENT),   f_stat,     NULL,      QS(real),      HS(NOD) | HS(RES), TS(real) },
 };
 
     /* please note,
      * this enum MUST be 1 greater than the highest value of any enum */
 enum pids_item PIDS_logical_end = MAXTABLE(Item_table);
 
+        /*
+         * The DELAY items, which pids_delays_fill assigns after a fetch. */
+#define pids_delay_item(e)  ((e) >= PIDS_DELAY_BLKIO_NS && (e) <= PIDS_DELAY_THRASH_NS_DELTA)
+
+        /*
+         * Numeric items which procps_pids_group does not sum, since
+         * a total would be meaningless. A group's first task supplies them. */
+static enum pids_item Group_first[] = {
+    PIDS_ADDR_CODE_END,    PIDS_ADDR_CODE_START,  PIDS_ADDR_CURR_EIP,
+    PIDS_ADDR_CURR_ESP,    PIDS_ADDR_STACK_START, PIDS_AUTOGRP_ID,
+    PIDS_AUTOGRP_NICE,     PIDS_EXIT_SIGNAL,      PIDS_FLAGS,
+    PIDS_ID_EGID,          PIDS_ID_EUID,          PIDS_ID_FGID,
+    PIDS_ID_FUID,          PIDS_ID_LOGIN,         PIDS_ID_PGRP,
+    PIDS_ID_PID,           PIDS_ID_PPID,          PIDS_ID_RGID,
+    PIDS_ID_RUID,          PIDS_ID_SESSION,       PIDS_ID_SGID,
+    PIDS_ID_SUID,          PIDS_ID_TGID,          PIDS_ID_TID,
+    PIDS_ID_TPGID,         PIDS_NICE,             PIDS_NS_CGROUP,
+    PIDS_NS_IPC,           PIDS_NS_MNT,           PIDS_NS_NET,
+    PIDS_NS_PID,           PIDS_NS_TIME,          PIDS_NS_USER,
+    PIDS_NS_UTS,           PIDS_OOM_ADJ,          PIDS_OOM_SCORE,
+    PIDS_PRIORITY,         PIDS_PRIORITY_RT,      PIDS_PROCESSOR,
+    PIDS_PROCESSOR_NODE,   PIDS_PROCESSOR_NODE_RESIDENT, PIDS_RSS_RLIM,
+    PIDS_SCHED_CLASS,
+    PIDS_SMAP_AGE,         PIDS_TICS_BEGAN,       PIDS_TIME_ELAPSED,
+    PIDS_TIME_START,       PIDS_TTY };
+
 #undef setNAME
 #undef freNAME
 #undef srtNAME
@@ -646,6 +858,7 @@ enum pids_item PIDS_logical_end = MAXTABLE(Item_table);
 #undef FF
 #undef QS
 
+//#undef f_cpus                   // needed later
 //#undef f_either                 // needed later
 #undef f_exe
 #undef f_fds
@@ -655,16 +868,17 @@ enum pids_item PIDS_logical_end = MAXTABLE(Item_table);
 //#undef f_lxc                    // needed later
 #undef f_ns
 #undef f_oom
-#undef f_smaps
+#undef f_sched
+//#undef f_smaps                  // needed later
 //#undef f_stat                   // needed later
 #undef f_statm
 //#undef f_status                 // needed later
-#undef f_systemd
+//#undef f_systemd                // needed later
 #undef f_usr
 #undef v_arg
 #undef v_cgroup
 #undef v_env
-#undef x_cgroup
+//#undef x_cgroup                 // needed later
 #undef x_cmdline
 #undef x_environ
 #undef x_ogroup
@@ -685,52 +899,97 @@ enum pids_item PIDS_logical_end = MAXTABLE(Item_table);
 typedef unsigned long long TIC_t;
 
 typedef struct HST_t {
-    TIC_t tics;                        // last frame's tics count
-    unsigned long maj, min;            // last frame's maj/min_flt counts
-    int pid;                           // record 'key'
+    TIC_t began;                       // record 'key' (with tid), for pid reuse
+    int tid;                           // record 'key'
     int lnk;                           // next on hash chain
 } HST_t;
 
+    // smap_Rss thru smap_Locked are contiguous unsigned longs in a proc_t
+#define SMAP_NUMVALS  (int)((offsetof(proc_t, smap_Locked) - offsetof(proc_t, smap_Rss)) / sizeof(unsigned long) + 1)
+
+typedef struct SMP_t {
+    unsigned long vals[SMAP_NUMVALS];  // the smaps_rollup values, when last read
+    unsigned long long stamp;          // new_ns as of that read (zero = never)
+} SMP_t;
+
 
 struct history_info {
     int    num_tasks;                  // used as index (tasks tallied)
     int    HHist_siz;                  // max number of HST_t structs
     HST_t *PHist_sav;                  // alternating 'old/new' HST_t anchors
     HST_t *PHist_new;
+    unsigned long long *PVals_sav;     // alternating 'old/new' source values,
+    unsigned long long *PVals_new;     // (with 'numsrcs' of them per HST_t)
+    int    srcmask;                    // the HS bits these values represent
+    int    numsrcs;                    // total sources in that srcmask
+    int    srcs [HS_NUMSRC];           // and each as an enum pids_hsrc
+    unsigned long long old_ns;         // CLOCK_MONOTONIC as of the prior fetch
+    unsigned long long new_ns;         // CLOCK_MONOTONIC as of this fetch
     int    HHash_one [HHASH_SIZE];     // the actual hash tables
     int    HHash_two [HHASH_SIZE];     // (accessed via PHash_sav/PHash_new)
     int    HHash_nul [HHASH_SIZE];     // an 'empty' hash table image
     int   *PHash_sav;                  // alternating 'old/new' hash tables
     int   *PHash_new;                  // (aka. the 'one/two' actual tables)
+    SMP_t *PSmap_sav;                  // alternating 'old/new' smaps_rollup values,
+    SMP_t *PSmap_new;                  // (only when smaps sampling is active)
+    unsigned long *RSS_heap;           // min-heap of the 'smaps_topk' largest rss
+    int    RSS_num;                    // entries in that heap, this fetch
+    unsigned long rss_min;             // rss at/above which smaps is always read
+    int    rr_tid;                     // round-robin, budgeted reads begin after
+    int    rr_last;                    // the last tid read under that budget
+    int    rr_spent;                   // the budget was exhausted this fetch
+    int    fresh;                      // the current task's smaps were just read
 };
 
 
-static void pids_config_history (
+static int pids_config_history (
         struct pids_info *info)
 {
-    int i;
+    unsigned long long *v;
+    int i, n;
+
+    for (i = 0, n = 0; i < HS_NUMSRC; i++)
+        if (info->history_yes & (1 << i))
+            Hr(srcs[n++]) = i;
+    /* while an empty 'srcmask' is possible, we'll still keep
+       1 value per task so that realloc never sees a zero size */
+    if (!(v = realloc(Hr(PVals_sav), sizeof(*v) * Hr(HHist_siz) * (n ? n : 1))))
+        return 0;
+    Hr(PVals_sav) = v;
+    if (!(v = realloc(Hr(PVals_new), sizeof(*v) * Hr(HHist_siz) * (n ? n : 1))))
+        return 0;
+    Hr(PVals_new) = v;
+    Hr(numsrcs) = n;
+    Hr(srcmask) = info->history_yes;
 
+    /* whatever history may have existed is now lost, so the next
+       fetch will see every task as if it were brand new ... */
     for (i = 0; i < HHASH_SIZE; i++)   // make the 'empty' table image
         Hr(HHash_nul[i]) = -1;
     memcpy(Hr(HHash_one), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
     memcpy(Hr(HHash_two), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
     Hr(PHash_sav) = Hr(HHash_one);     // alternating 'old/new' hash tables
     Hr(PHash_new) = Hr(HHash_two);
+    Hr(num_tasks) = 0;
+    Hr(new_ns) = 0;
+    return 1;
 } // end: pids_config_history
 
 
-static inline HST_t *pids_histget (
+static inline int pids_histget (
         struct pids_info *info,
-        int pid)
+        int tid,
+        TIC_t began)
 {
-    int V = Hr(PHash_sav[_HASH_PID_(pid)]);
+    int V = Hr(PHash_sav[_HASH_PID_(tid)]);
 
     while (-1 < V) {
-        if (Hr(PHist_sav[V].pid) == pid)
-            return &Hr(PHist_sav[V]);
+        if (Hr(PHist_sav[V].tid) == tid
+        && (Hr(PHist_sav[V].began) == began))
+            return V;
         V = Hr(PHist_sav[V].lnk);
     }
-    return NULL;
+    return -1;
 } // end: pids_histget
 
 
@@ -738,7 +997,7 @@ static inline void pids_histput (
         struct pids_info *info,
         unsigned this)
 {
-    int V = _HASH_PID_(Hr(PHist_new[this].pid));
+    int V = _HASH_PID_(Hr(PHist_new[this].tid));
 
     Hr(PHist_new[this].lnk) = Hr(PHash_new[V]);
     Hr(PHash_new[V] = this);
@@ -747,67 +1006,351 @@ static inline void pids_histput (
 #undef _HASH_PID_
 
 
+static inline unsigned long long pids_hist_value (
+        proc_t *p,
+        int src)
+{
+    switch (src) {
+        case hs_TIC: return p->utime + p->stime;
+        case hs_MAJ: return p->maj_flt;
+        case hs_MIN: return p->min_flt;
+        case hs_RBY: return p->read_bytes;
+        case hs_RCH: return p->rchar;
+        case hs_ROP: return p->syscr;
+        case hs_WBY: return p->write_bytes;
+        case hs_WCB: return p->cancelled_write_bytes;
+        case hs_WCH: return p->wchar;
+        case hs_WOP: return p->syscw;
+        case hs_SRN: return p->sched_runtime;
+        case hs_SWT: return p->sched_wait;
+        case hs_STS: return p->sched_slices;
+        case hs_CSV: return p->ctxsw_vol;
+        case hs_CSI: return p->ctxsw_invol;
+        case hs_CPU: return p->processor;
+        case hs_NOD: return numa_node_of_cpu(p->processor);
+        default:     break;            // others, see pids_make_hist & pids_delays_fill
+    }
+    return 0;
+} // end: pids_hist_value
+
+
+    /*
+     * This guy is invoked by readproc.c for every task, before any smaps
+     * read. Those tasks with the largest rss are always read, as are new
+     * tasks. The others are read round-robin (by tid) until that budget
+     * is exhausted, whereupon pids_make_smaps serves their prior values. */
+static int pids_smaps_gate (
+        PROCTAB *PT,
+        const proc_t *p)
+{
+    struct pids_info *info = PT->gate_data;
+    int h;
+
+    Hr(fresh) = 1;
+    if (p->rss >= Hr(rss_min))
+        return 1;
+    if (PT->smaps_ns < info->smaps_budget) {
+        h = pids_histget(info, p->tid, p->start_time);
+        if (h < 0 || !Hr(PSmap_sav[h].stamp))
+            return 1;
+        if (p->tid > Hr(rr_tid)) {
+            Hr(rr_last) = p->tid;
+            return 1;
+        }
+    } else
+        Hr(rr_spent) = 1;
+    Hr(fresh) = 0;
+    return 0;
+} // end: pids_smaps_gate
+
+
+static inline void pids_make_smaps (
+        struct pids_info *info,
+        proc_t *p,
+        int h,
+        int slot)
+{
+    SMP_t *new = &Hr(PSmap_new[slot]);
+    unsigned long *heap = Hr(RSS_heap), rss = p->rss;
+    int i, c;
+
+    if (Hr(fresh)) {
+        memcpy(new->vals, &p->smap_Rss, sizeof(new->vals));
+        new->stamp = Hr(new_ns);
+    } else if (h > -1) {
+        *new = Hr(PSmap_sav[h]);
+        memcpy(&p->smap_Rss, new->vals, sizeof(new->vals));
+    } else
+        memset(new, 0, sizeof(SMP_t));
+    info->smaps_age = new->stamp ? (Hr(new_ns) - new->stamp) / 1.0e9 : -1.0;
+
+    // keep the 'smaps_topk' largest rss, with the smallest at heap[0]
+    if (Hr(RSS_num) < info->smaps_topk) {
+        for (i = Hr(RSS_num)++; i && heap[(i - 1) / 2] > rss; i = (i - 1) / 2)
+            heap[i] = heap[(i - 1) / 2];
+        heap[i] = rss;
+    } else if (info->smaps_topk && rss > heap[0]) {
+        for (i = 0; (c = 2 * i + 1) < Hr(RSS_num); i = c) {
+            if (c + 1 < Hr(RSS_num) && heap[c + 1] < heap[c])
+                c++;
+            if (heap[c] >= rss)
+                break;
+            heap[i] = heap[c];
+        }
+        heap[i] = rss;
+    }
+} // end: pids_make_smaps
+
+
 static inline int pids_make_hist (
         struct pids_info *info,
         proc_t *p)
 {
-    TIC_t tics;
-    HST_t *h;
+    unsigned long long *new, *sav = NULL;
+    int i, h, n = Hr(numsrcs) ? Hr(numsrcs) : 1;
     int slot = info->hist->num_tasks;
 
     if (slot + 1 >= Hr(HHist_siz)) {
         Hr(HHist_siz) += NEWOLD_GROW;
         Hr(PHist_sav) = realloc(Hr(PHist_sav), sizeof(HST_t) * Hr(HHist_siz));
         Hr(PHist_new) = realloc(Hr(PHist_new), sizeof(HST_t) * Hr(HHist_siz));
-        if (!Hr(PHist_sav) || !Hr(PHist_new))
+        Hr(PVals_sav) = realloc(Hr(PVals_sav), sizeof(*sav) * Hr(HHist_siz) * n);
+        Hr(PVals_new) = realloc(Hr(PVals_new), sizeof(*sav) * Hr(HHist_siz) * n);
+        if (!Hr(PHist_sav) || !Hr(PHist_new) || !Hr(PVals_sav) || !Hr(PVals_new))
             return 0;
+        if (Hr(PSmap_sav)) {
+            Hr(PSmap_sav) = realloc(Hr(PSmap_sav), sizeof(SMP_t) * Hr(HHist_siz));
+            Hr(PSmap_new) = realloc(Hr(PSmap_new), sizeof(SMP_t) * Hr(HHist_siz));
+            if (!Hr(PSmap_sav) || !Hr(PSmap_new))
+                return 0;
+        }
     }
-    Hr(PHist_new[slot].pid)  = p->tid;
-    Hr(PHist_new[slot].maj)  = p->maj_flt;
-    Hr(PHist_new[slot].min)  = p->min_flt;
-    Hr(PHist_new[slot].tics) = tics = (p->utime + p->stime);
-
+    Hr(PHist_new[slot].tid)   = p->tid;
+    Hr(PHist_new[slot].began) = p->start_time;
     pids_histput(info, slot);
 
-    if ((h = pids_histget(info, p->tid))) {
-        tics -= h->tics;
-        p->maj_delta = p->maj_flt - h->maj;
-        p->min_delta = p->min_flt - h->min;
+    if (-1 < (h = pids_histget(info, p->tid, p->start_time)))
+        sav = &Hr(PVals_sav[h * n]);
+    new = &Hr(PVals_new[slot * n]);
+
+    for (i = 0; i < Hr(numsrcs); i++) {
+        int src = Hr(srcs[i]);
+        new[i] = pids_hist_value(p, src);
+        /* the processor and its node yield a 'changed' flag, which those
+           next sources (always following them in 'srcs') then build upon */
+        switch (src) {
+            case hs_CPU: case hs_NOD:
+                info->hist_deltas[src] = (sav && new[i] != sav[i]);
+                continue;
+            case hs_MIG:
+                new[i] = (sav ? sav[i] : 0) + info->hist_deltas[hs_CPU];
+                info->hist_deltas[src] = new[i];
+                continue;
+            case hs_RES:
+                new[i] = (sav && !info->hist_deltas[hs_NOD]) ? sav[i] : Hr(new_ns);
+                info->hist_deltas[src] = Hr(new_ns) - new[i];
+                continue;
+        }
+        /* tasks not previously seen via that pids_histget() guy
+           (including a reused pid) yield no deltas, except tics */
+        if (sav)
+            info->hist_deltas[src] = new[i] - sav[i];
+        else
+            info->hist_deltas[src] = (src == hs_TIC) ? new[i] : 0;
     }
-    /* here we're saving elapsed tics, which will include any
-       tasks not previously seen via that pids_histget() guy! */
-    p->pcpu = tics;
+    // the old library interface(s), deltas derived from proc_t
+    p->pcpu = info->hist_deltas[hs_TIC];
+    p->maj_delta = info->hist_deltas[hs_MAJ];
+    p->min_delta = info->hist_deltas[hs_MIN];
+
+    if (info->smaps_yes)
+        pids_make_smaps(info, p, h, slot);
 
     info->hist->num_tasks++;
     return 1;
 } // end: pids_make_hist
 
 
-static inline void pids_toggle_history (
+static inline int pids_toggle_history (
         struct pids_info *info)
 {
+    struct timespec ts;
     void *v;
 
+    if (Hr(srcmask) != info->history_yes) {
+        if (!pids_config_history(info))
+            return 0;
+    }
     v = Hr(PHist_sav);
     Hr(PHist_sav) = Hr(PHist_new);
     Hr(PHist_new) = v;
 
+    v = Hr(PVals_sav);
+    Hr(PVals_sav) = Hr(PVals_new);
+    Hr(PVals_new) = v;
+
     v = Hr(PHash_sav);
     Hr(PHash_sav) = Hr(PHash_new);
     Hr(PHash_new) = v;
     memcpy(Hr(PHash_new), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
 
+    Hr(old_ns) = Hr(new_ns);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    Hr(new_ns) = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    info->hist_elapsed = 0.0;
+    if (Hr(old_ns) && Hr(new_ns) > Hr(old_ns))
+        info->hist_elapsed = (Hr(new_ns) - Hr(old_ns)) / 1.0e9;
+
+    if (info->smaps_yes) {
+        if (!Hr(PSmap_sav)) {
+            if (!(Hr(PSmap_sav) = calloc(Hr(HHist_siz), sizeof(SMP_t)))
+            || !(Hr(PSmap_new) = calloc(Hr(HHist_siz), sizeof(SMP_t))))
+                return 0;
+        }
+        v = Hr(PSmap_sav);
+        Hr(PSmap_sav) = Hr(PSmap_new);
+        Hr(PSmap_new) = v;
+        /* with a first fetch (or too few tasks last time) we can't know
+           the 'topk' threshold, so everything will then be read ... */
+        if (!info->smaps_topk)
+            Hr(rss_min) = ULONG_MAX;
+        else if (Hr(RSS_num) < info->smaps_topk)
+            Hr(rss_min) = 0;
+        else
+            Hr(rss_min) = Hr(RSS_heap[0]);
+        Hr(RSS_num) = 0;
+        Hr(rr_tid) = Hr(rr_spent) ? Hr(rr_last) : 0;
+        Hr(rr_spent) = 0;
+    } else if (Hr(PSmap_sav)) {
+        free(Hr(PSmap_sav));
+        free(Hr(PSmap_new));
+        Hr(PSmap_sav) = Hr(PSmap_new) = NULL;
+    }
     info->hist->num_tasks = 0;
+    return 1;
 } // end: pids_toggle_history
 
 
+        /*
+         * Remember what pids_delays_fill will need for the n'th task of
+         * this fetch, once all of them have been read, including what any
+         * /proc files offered in case the taskstats source isn't usable. */
+static int pids_delays_note (
+        struct pids_info *info,
+        int n,
+        proc_t *p)
+{
+    struct delay_task *d;
+
+    if (n >= info->delays_alloc) {
+        int new = info->delays_alloc + NEWOLD_GROW;
+        if (!(d = realloc(info->delays, sizeof(struct delay_task) * new)))
+            return 0;
+        info->delays = d;
+        if (!(info->delay_ids = realloc(info->delay_ids, sizeof(pid_t) * new))
+        || !(info->delay_vals = realloc(info->delay_vals, sizeof(struct delayacct_vals) * new)))
+            return 0;
+        info->delays_alloc = new;
+    }
+    d = &info->delays[n];
+    d->tid = info->delay_ids[n] = p->tid;
+    d->began = p->start_time;
+    d->slot = (info->history_yes || info->smaps_yes) ? info->hist->num_tasks - 1 : -1;
+    d->cpu = p->sched_wait;
+    d->blkio = p->blkio_tics * (1000000000ULL / info->hertz);
+    return 1;
+} // end: pids_delays_note
+
+
+static inline unsigned long long pids_delay_value (
+        struct delayacct_vals *v,
+        int src)
+{
+    switch (src) {
+        case hs_DBI: return v->blkio;
+        case hs_DCP: return v->cpu;
+        case hs_DFP: return v->freepages;
+        case hs_DSW: return v->swapin;
+        case hs_DTH: return v->thrashing;
+    }
+    return 0;
+} // end: pids_delay_value
+
+
+        /*
+         * With every task read, this guy asks taskstats for all of their
+         * delays at once (well, in a few large batches). Then, for each of
+         * those stacks, he completes the history and assigns the DELAY items
+         * which pids_assign_results could not. Whenever taskstats is denied
+         * us (we lack CAP_NET_ADMIN) or delay accounting is off, the cpu and
+         * blkio delays come from the schedstat and stat files instead, with
+         * any others then zero. Such a failure isn't forever, though. That
+         * sysctl may be switched on or capabilities change, so taskstats is
+         * tried again once DELAYS_RETRY seconds have passed. */
+static void pids_delays_fill (
+        struct pids_info *info,
+        struct pids_stack **stacks,
+        int numstacks)
+{
+    struct delayacct_vals *v;
+    struct delay_task *d;
+    unsigned long long *new, *sav;
+    struct timespec ts;
+    unsigned long long now;
+    int i, j, h, n = Hr(numsrcs) ? Hr(numsrcs) : 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    if (!info->delayacct && now >= info->delays_retry
+    && delayacct_open(&info->delayacct) < 0)
+        info->delays_retry = now + DELAYS_RETRY * 1000000000ULL;
+    if (info->delayacct
+    && delayacct_fetch(info->delayacct, info->delay_ids, numstacks, info->delays_tgid, info->delay_vals) < 0) {
+        delayacct_close(&info->delayacct);
+        info->delays_retry = now + DELAYS_RETRY * 1000000000ULL;
+    }
+    if (!info->delayacct)
+        memset(info->delay_vals, 0, sizeof(struct delayacct_vals) * numstacks);
+
+    for (i = 0; i < numstacks; i++) {
+        d = &info->delays[i];
+        v = &info->delay_vals[i];
+        if (!v->found) {
+            v->cpu = d->cpu;
+            v->blkio = d->blkio;
+        }
+        info->delay_now = *v;
+        for (j = hs_DBI; j < HS_NUMSRC; j++)
+            info->hist_deltas[j] = 0;
+        if (d->slot > -1) {
+            sav = NULL;
+            if (-1 < (h = pids_histget(info, d->tid, d->began)))
+                sav = &Hr(PVals_sav[h * n]);
+            new = &Hr(PVals_new[d->slot * n]);
+            for (j = 0; j < Hr(numsrcs); j++) {
+                int src = Hr(srcs[j]);
+                if (src < hs_DBI)
+                    continue;
+                new[j] = pids_delay_value(v, src);
+                // a source switched (taskstats to /proc) mustn't go backward
+                if (sav && new[j] > sav[j])
+                    info->hist_deltas[src] = new[j] - sav[j];
+            }
+        }
+        for (j = 0; info->func_array[j]; j++)
+            if (pids_delay_item(info->items[j]))
+                info->func_array[j](info, &stacks[i]->head[j], NULL);
+    }
+} // end: pids_delays_fill
+
+
 #ifdef UNREF_RPTHASH
 static void pids_unref_rpthash (
         struct pids_info *info)
 {
     int i, j, pop, total_occupied, maxdepth, maxdepth_sav, numdepth
         , cross_foot, sz = HHASH_SIZE * (int)sizeof(int)
-        , hsz = (int)sizeof(HST_t) * Hr(HHist_siz);
+        , hsz = ((int)sizeof(HST_t) + (int)sizeof(long long) * Hr(numsrcs)) * Hr(HHist_siz);
     int depths[HHASH_SIZE];
 
     for (i = 0, total_occupied = 0, maxdepth = 0; i < HHASH_SIZE; i++) {
@@ -827,7 +1370,7 @@ static void pids_unref_rpthash (
 
     fprintf(stderr,
         "\n    History Memory Costs:"
-        "\n\tHST_t size = %d, total allocated = %d,"
+        "\n\tHST_t size = %d (plus %d values), total allocated = %d,"
         "\n\tthus PHist_new & PHist_sav consumed %dk (%d) total bytes."
         "\n"
         "\n\tTwo hash tables provide for %d entries each + 1 extra 'empty' image,"
@@ -840,7 +1383,7 @@ static void pids_unref_rpthash (
         "\n\tLevel-0 hash entries = %d (%d%% occupied)"
         "\n\tMax Depth = %d"
         "\n\n"
-        , (int)sizeof(HST_t),  Hr(HHist_siz)
+        , (int)sizeof(HST_t), Hr(numsrcs), Hr(HHist_siz)
         , hsz / 1024, hsz
         , HHASH_SIZE
         , sz / 1024, sz, (sz * 3) / 1024, sz * 3
@@ -874,10 +1417,10 @@ static void pids_unref_rpthash (
             for (i = 0; i < HHASH_SIZE; i++)
                 if (depths[i] == maxdepth_sav) {
                     j = Hr(PHash_new[i]);
-                    fprintf(stderr, "\n\tpos %4d:  %05d", i, Hr(PHist_new[j].pid));
+                    fprintf(stderr, "\n\tpos %4d:  %05d", i, Hr(PHist_new[j].tid));
                     while (-1 < j) {
                         j = Hr(PHist_new[j].lnk);
-                        if (-1 < j) fprintf(stderr, ", %05d", Hr(PHist_new[j].pid));
+                        if (-1 < j) fprintf(stderr, ", %05d", Hr(PHist_new[j].tid));
                     }
                 }
             fprintf(stderr, "\n");
@@ -890,15 +1433,168 @@ static void pids_unref_rpthash (
 #undef HHASH_SIZE
 
 
+// ___ Group Support Private Functions ||||||||||||||||||||||||||||||||||||||||
+
+enum group_op {
+    GRP_first, GRP_s_int, GRP_u_int, GRP_ul_int, GRP_ull_int, GRP_real
+};
+
+
+static inline unsigned pids_group_hash (
+        const char *key)
+{
+    return procps_hash(key, strlen(key));
+} // end: pids_group_hash
+
+
+static int pids_group_op (
+        enum pids_item item)
+{
+    static const char *types[] = {
+        "", "s_int", "u_int", "ul_int", "ull_int", "real" };
+    unsigned i;
+
+    if (item <= PIDS_extra || item >= PIDS_logical_end)
+        return GRP_first;
+    for (i = 0; i < MAXTABLE(Group_first); i++)
+        if (Group_first[i] == item)
+            return GRP_first;
+    for (i = GRP_s_int; i < MAXTABLE(types); i++)
+        if (!strcmp(Item_table[item].type2str, types[i]))
+            return i;
+    return GRP_first;
+} // end: pids_group_op
+
+
+        /*
+         * Here we intern a key never seen before, growing that hash with
+         * the nodes so each chain stays short. Nodes outlive any one call
+         * (until purged as stale), so a group's key is a stable address. */
+static struct group_node *pids_group_intern (
+        struct group_support *g,
+        const char *key,
+        unsigned h)
+{
+    struct group_node **hash, *node, *next;
+    unsigned i, newsiz;
+
+    if (g->numnodes >= (int)g->hashsiz) {
+        newsiz = g->hashsiz ? g->hashsiz << 1 : GROUP_HASH;
+        if (!(hash = calloc(newsiz, sizeof(struct group_node *))))
+            return NULL;
+        for (i = 0; i < g->hashsiz; i++) {
+            for (node = g->hash[i]; node; node = next) {
+                next = node->next;
+                node->next = hash[node->hash & (newsiz - 1)];
+                hash[node->hash & (newsiz - 1)] = node;
+            }
+        }
+        free(g->hash);
+        g->hash = hash;
+        g->hashsiz = newsiz;
+    }
+    if (!(node = calloc(1, sizeof(struct group_node)))
+    || (!(node->key = strdup(key)))) {
+        free(node);
+        return NULL;
+    }
+    node->hash = h;
+    node->next = g->hash[h & (g->hashsiz - 1)];
+    g->hash[h & (g->hashsiz - 1)] = node;
+    ++g->numnodes;
+    return node;
+} // end: pids_group_intern
+
+
+        /*
+         * Keys no longer in use (say, a container that's gone) are purged
+         * once they outnumber those in use, keeping the hash from bloating. */
+static void pids_group_purge (
+        struct group_support *g,
+        int numgroups)
+{
+    struct group_node **prev, *node;
+    unsigned i;
+
+    if (g->numnodes <= GROUP_HASH || g->numnodes <= numgroups * 2)
+        return;
+    for (i = 0; i < g->hashsiz; i++) {
+        prev = &g->hash[i];
+        while ((node = *prev)) {
+            if (node->stamp == g->stamp)
+                prev = &node->next;
+            else {
+                *prev = node->next;
+                free(node->key);
+                free(node);
+                --g->numnodes;
+            }
+        }
+    }
+} // end: pids_group_purge
+
+
+static int pids_group_grow (
+        struct pids_info *info,
+        struct group_support *g)
+{
+    int i, n = g->n_alloc + GROUP_GROW;
+    void *p;
+
+    if (!(p = realloc(g->lists, sizeof(struct pids_result) * info->maxitems * n)))
+        goto fail;
+    g->lists = p;
+    if (!(p = realloc(g->heads, sizeof(struct pids_stack) * n)))
+        goto fail;
+    g->heads = p;
+    if (!(p = realloc(g->stacks, sizeof(void *) * (n + 1))))
+        goto fail;
+    g->stacks = p;
+    for (i = 0; i < n; i++) {
+        g->heads[i].head = g->lists + (i * info->maxitems);
+        g->stacks[i] = &g->heads[i];
+    }
+    g->n_alloc = n;
+    return 1;
+fail:
+    g->n_alloc = 0;                    // so that everything is reprimed
+    return 0;
+} // end: pids_group_grow
+
+
+static void pids_group_free (
+        struct group_support *g)
+{
+    struct group_node *node, *next;
+    unsigned i;
+
+    for (i = 0; i < g->hashsiz; i++) {
+        for (node = g->hash[i]; node; node = next) {
+            next = node->next;
+            free(node->key);
+            free(node);
+        }
+    }
+    free(g->hash);
+    free(g->ops);
+    free(g->lists);
+    free(g->heads);
+    free(g->stacks);
+    free(g);
+} // end: pids_group_free
+
+
 // ___ Unique/Specialized Private Function(s) |||||||||||||||||||||||||||||||||
 
         /*
          * This routine periodically invokes the garbage collection services
-         * embedded in 'lxc' and 'docker' container extraction functions. It
-         * exists in case a library caller (like top) is kept running for an
-         * extended period of time (perhaps weeks or months). In such a case
-         * containers long since disappeared would otherwise be tracked thus
-         * consuming ever more memory while needlessly slowing the searches. */
+         * embedded in 'lxc' and 'docker' container extraction functions, and
+         * in the cgroup interning they serve (with its cgroup & sd units),
+         * plus the Cpus_allowed interning. It exists in case a library caller
+         * (like top) is kept running for an extended period of time (perhaps
+         * weeks or months). In such a case containers long since disappeared
+         * would otherwise be tracked thus consuming ever more memory while
+         * needlessly slowing the searches. */
 static void pids_containers_check (void) {
  #define oneDAY (60 * 60 * 24)
     static __thread time_t sav_secs;
@@ -907,6 +1603,8 @@ static void pids_containers_check (void) {
     if (!sav_secs)
        sav_secs = cur_secs;
     else if (oneDAY <= (cur_secs - sav_secs)) {
+        cgroup_interned(-1, NULL);
+        cpus_interned(NULL);
         lxc_containers(NULL);
         docker_containers(NULL);
         sav_secs = cur_secs;
@@ -1074,7 +1772,12 @@ static inline void pids_libflags_set (
 //      if (!(info->oldflags & (f_stat | f_status)))
 //          info->oldflags |= f_stat;
 //  }
-    info->containers_yes = info->oldflags & (f_lxc | z_docker);
+    info->containers_yes = info->oldflags & (f_lxc | z_docker | x_cgroup | f_systemd | (f_cpus & ~f_status));
+    info->delays_yes = 0;
+    for (i = 0; i < info->maxitems - 1; i++)
+        if (pids_delay_item(info->items[i]))
+            info->delays_yes = 1;
+    info->smaps_yes = (info->smaps_topk || info->smaps_budget) && (info->oldflags & f_smaps);
     return;
 } // end: pids_libflags_set
 
@@ -1112,6 +1815,111 @@ static inline int pids_oldproc_open (
 } // end: pids_oldproc_open
 
 
+static void pids_pins_free (
+        struct pids_info *info)
+{
+    int i;
+
+    if (info->pins) {
+        for (i = 0; i < info->numpins; i++)
+            if (info->pins[i].dirfd >= 0)
+                close(info->pins[i].dirfd);
+        free(info->pins);
+        info->pins = NULL;
+    }
+    info->numpins = 0;
+} // end: pids_pins_free
+
+
+static int pids_pins_sync (
+        struct pids_info *info,
+        unsigned *these,
+        int numthese)
+{
+    PINTAB *pins;
+    int i, j;
+
+    // the very same pids (in the same order) as last time is most likely
+    if (numthese == info->numpins) {
+        for (i = 0; i < numthese; i++)
+            if (info->pins[i].pid != (pid_t)these[i])
+                break;
+        if (i == numthese)
+            return 1;
+    }
+    if (!(pins = calloc(numthese + 1, sizeof(PINTAB))))
+        return 0;
+    // otherwise we'll keep any pins still wanted, and release the others
+    for (i = 0; i < numthese; i++) {
+        pins[i].pid = these[i];
+        pins[i].dirfd = -1;
+        for (j = 0; j < info->numpins; j++) {
+            if (info->pins[j].pid == pins[i].pid && info->pins[j].dirfd >= 0) {
+                pins[i].dirfd = info->pins[j].dirfd;
+                pins[i].tgid = info->pins[j].tgid;
+                info->pins[j].dirfd = -1;
+                break;
+            }
+        }
+    }
+    pins[numthese].dirfd = -1;
+    pids_pins_free(info);
+    info->pins = pins;
+    info->numpins = numthese;
+    return 1;
+} // end: pids_pins_sync
+
+
+        /*
+         * When a cn_proc event source was wanted, and it's available, this
+         * builds the list of tgids that 'reap' will read in place of /proc.
+         * Returns 1 if the list is ready, or 0 to fall back on scanning. */
+static int pids_events_prep (
+        struct pids_info *info)
+{
+    pid_t *pids;
+    int i, n;
+
+    if (!info->events_yes)
+        return 0;
+    if (!info->events && procevents_open(&info->events) < 0) {
+        info->events_yes = 0;          // we'll not be asking again
+        return 0;
+    }
+    if ((n = procevents_pids(info->events, &pids)) < 0)
+        return 0;
+    if (n + 1 > info->evalloc) {
+        PINTAB *p = realloc(info->evpins, (n + 1 + NEWOLD_GROW) * sizeof(PINTAB));
+        if (!p)
+            return 0;
+        info->evpins = p;
+        info->evalloc = n + 1 + NEWOLD_GROW;
+    }
+    for (i = 0; i < n; i++) {
+        info->evpins[i].pid = info->evpins[i].tgid = pids[i];
+        info->evpins[i].dirfd = -1;
+        info->evpins[i].once = 1;
+    }
+    memset(&info->evpins[n], 0, sizeof(PINTAB));
+    info->evpins[n].dirfd = -1;
+    return 1;
+} // end: pids_events_prep
+
+
+        /*
+         * Any tgid whose /proc/<pid> could not be read during 'reap' has
+         * ended, which the event source learns only from us. */
+static void pids_events_sweep (
+        struct pids_info *info)
+{
+    PINTAB *pin;
+
+    for (pin = info->evpins; pin->pid; pin++)
+        if (!pin->tgid)
+            procevents_gone(info->events, pin->pid);
+} // end: pids_events_sweep
+
+
 static int pids_prep_func_array (
         struct pids_info *info)
 {
@@ -1158,8 +1966,12 @@ static inline int pids_proc_tally (
     }
     ++counts->total;
 
-    if (info->history_yes)
-        return pids_make_hist(info, p);
+    if (info->history_yes || info->smaps_yes) {
+        if (!pids_make_hist(info, p))
+            return 0;
+    }
+    if (info->delays_yes)
+        return pids_delays_note(info, counts->total - 1, p);
     return 1;
 } // end: pids_proc_tally
 
@@ -1237,8 +2049,16 @@ static int pids_stacks_fetch (
         memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * STACKS_INIT);
         n_alloc = STACKS_INIT;
     }
-    pids_toggle_history(info);
+    if (!pids_toggle_history(info))
+        return -1;           // here, errno was set to ENOMEM
     memset(&info->fetch.counts, 0, sizeof(struct pids_counts));
+    info->smaps_age = 0.0;
+    if (info->smaps_yes) {
+        info->fetch_PT->smaps_gate = pids_smaps_gate;
+        info->fetch_PT->gate_data = info;
+    }
+
+    info->delays_tgid = (info->read_something == readproc);
 
     // iterate stuff --------------------------------------
     n_inuse = 0;
@@ -1260,6 +2080,8 @@ static int pids_stacks_fetch (
        in which case they would have returned a NULL, thus ending our while loop. | */
     if (errno == ENOMEM)
         return -1;
+    if (info->delays_yes && n_inuse)
+        pids_delays_fill(info, info->fetch.anchor, n_inuse);
 
     // finalize stuff -------------------------------------
     /* note: we go to this trouble of maintaining a duplicate of the consolidated |
@@ -1377,11 +2199,12 @@ PROCPS_EXPORT int procps_pids_new (
         return -ENOMEM;
     }
     p->hist->HHist_siz = NEWOLD_INIT;
-    pids_config_history(p);
+    p->hist->srcmask = -1;             // forces pids_config_history at 1st fetch
 
     pgsz = getpagesize();
     while (pgsz > 1024) { pgsz >>= 1; p->pgs2k_shift++; }
     p->hertz = procps_hertz_get();
+    p->events_yes = (NULL != getenv("LIBPROC_PROC_EVENTS"));
 
     numa_init();
 
@@ -1443,6 +2266,11 @@ PROCPS_EXPORT int procps_pids_unref (
         if ((*info)->hist) {
             free((*info)->hist->PHist_sav);
             free((*info)->hist->PHist_new);
+            free((*info)->hist->PVals_sav);
+            free((*info)->hist->PVals_new);
+            free((*info)->hist->PSmap_sav);
+            free((*info)->hist->PSmap_new);
+            free((*info)->hist->RSS_heap);
             free((*info)->hist);
         }
 
@@ -1455,6 +2283,19 @@ PROCPS_EXPORT int procps_pids_unref (
         if ((*info)->select_ids)
             free((*info)->select_ids);
 
+        pids_pins_free(*info);
+
+        procevents_close(&(*info)->events);
+        free((*info)->evpins);
+
+        if ((*info)->group)
+            pids_group_free((*info)->group);
+
+        delayacct_close(&(*info)->delayacct);
+        free((*info)->delays);
+        free((*info)->delay_ids);
+        free((*info)->delay_vals);
+
         numa_uninit();
 
         free(*info);
@@ -1528,8 +2369,18 @@ fresh_start:
 
     if (NULL == info->read_something(info->get_PT, &info->get_proc))
         return NULL;
+    // no history here, so any delta (or rate) items will be zero
+    memset(info->hist_deltas, 0, sizeof(info->hist_deltas));
+    info->smaps_age = 0.0;
     if (!pids_assign_results(info, info->get_ext->stacks[0], &info->get_proc))
         return NULL;
+    if (info->delays_yes) {
+        info->delays_tgid = (which == PIDS_FETCH_TASKS_ONLY);
+        if (!pids_delays_note(info, 0, &info->get_proc))
+            return NULL;
+        info->delays[0].slot = -1;
+        pids_delays_fill(info, info->get_ext->stacks, 1);
+    }
     return info->get_ext->stacks[0];
 } // end: procps_pids_get
 
@@ -1546,7 +2397,7 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_reap (
         enum pids_fetch_type which)
 {
     struct timespec ts;
-    int rc;
+    int rc, evented;
 
     errno = EINVAL;
     if (info == NULL)
@@ -1562,7 +2413,10 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_reap (
     if (info->containers_yes)
         pids_containers_check();
 
-    if (!pids_oldproc_open(&info->fetch_PT, info->oldflags))
+    if ((evented = pids_events_prep(info))) {
+        if (!pids_oldproc_open(&info->fetch_PT, (info->oldflags | PROC_PID | PROC_PINNED), info->evpins))
+            return NULL;
+    } else if (!pids_oldproc_open(&info->fetch_PT, info->oldflags))
         return NULL;
     info->read_something = which ? readeither : readproc;
 
@@ -1573,6 +2427,8 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_reap (
     rc = pids_stacks_fetch(info);
 
     pids_oldproc_close(&info->fetch_PT);
+    if (evented)
+        pids_events_sweep(info);
     // we better have found at least 1 pid
     return (rc > 0) ? &info->fetch.results : NULL;
 } // end: procps_pids_reap
@@ -1665,14 +2521,23 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_select (
     if (info->containers_yes)
         pids_containers_check();
 
-    // the zero delimiter is really only needed with PIDS_SELECT_PID
-    if (!(info->select_ids = realloc(info->select_ids, sizeof(unsigned) * (numthese + 1))))
-        return NULL;
-    memcpy(info->select_ids, these, sizeof(unsigned) * numthese);
-    info->select_ids[numthese] = 0;
+    /* with a reasonable number of pids, their /proc/<pid> directories (and
+       tgids) are kept from call to call, avoiding repeated opens & reads */
+    if ((which & PIDS_SELECT_PID) && numthese <= PINS_MAX) {
+        if (!pids_pins_sync(info, these, numthese))
+            return NULL;
+        if (!pids_oldproc_open(&info->fetch_PT, (info->oldflags | which | PROC_PINNED), info->pins))
+            return NULL;
+    } else {
+        // the zero delimiter is really only needed with PIDS_SELECT_PID
+        if (!(info->select_ids = realloc(info->select_ids, sizeof(unsigned) * (numthese + 1))))
+            return NULL;
+        memcpy(info->select_ids, these, sizeof(unsigned) * numthese);
+        info->select_ids[numthese] = 0;
 
-    if (!pids_oldproc_open(&info->fetch_PT, (info->oldflags | which), info->select_ids, numthese))
-        return NULL;
+        if (!pids_oldproc_open(&info->fetch_PT, (info->oldflags | which), info->select_ids, numthese))
+            return NULL;
+    }
     info->read_something = (which & PIDS_FETCH_THREADS_TOO) ? readeither : readproc;
 
     info->boot_tics = 0;
@@ -1742,6 +2607,147 @@ PROCPS_EXPORT struct pids_stack **procps_pids_sort (
 } // end: procps_pids_sort
 
 
+/*
+ * procps_pids_group():
+ *
+ * Aggregate the passed stacks (normally those from a reap or select) by
+ * the string value of 'keyitem', such as PIDS_CGROUP or PIDS_SD_UNIT. It
+ * must be one of the items in those stacks.
+ *
+ * Each group's stack then has its numeric items summed across its tasks,
+ * except those in Group_first above. The PIDS_GROUP_TASKS item becomes
+ * the number of tasks. 'keyitem' becomes that group's key, while the
+ * other strings are borrowed from the group's first task.
+ *
+ * Returns: pointer to a pids_fetch struct (with a 'total' of groups) which
+ *          remains valid until the next reap, select, reset or group call
+ */
+PROCPS_EXPORT struct pids_fetch *procps_pids_group (
+        struct pids_info *info,
+        struct pids_stack *stacks[],
+        int numstacked,
+        enum pids_item keyitem)
+{
+    struct group_support *g;
+    struct group_node *node;
+    struct pids_result *src, *dst;
+    const char *key;
+    int i, j, keyoff, numgroups = 0;
+    unsigned h;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL || numstacked < 0)
+        return NULL;
+    // a pids_item is currently unsigned, but we'll protect our future
+    if (keyitem < 0 || keyitem >= PIDS_logical_end
+    || strcmp(Item_table[keyitem].type2str, "str"))
+        return NULL;
+    keyoff = 0;
+    if (numstacked) {
+        for (src = stacks[0]->head; src->item != keyitem; src++, keyoff++)
+            if (keyoff >= info->maxitems - 1)
+                return NULL;
+    }
+    errno = 0;
+
+    if (!info->group
+    && (!(info->group = calloc(1, sizeof(struct group_support)))))
+        return NULL;
+    g = info->group;
+    if (g->n_items != info->maxitems) {
+        if (!(g->ops = realloc(g->ops, info->maxitems)))
+            return NULL;
+        g->n_items = info->maxitems;
+        g->n_alloc = 0;
+    }
+    if (!g->n_alloc && !pids_group_grow(info, g))
+        return NULL;
+    if (numstacked) {
+        for (j = 0; j < info->maxitems; j++)
+            g->ops[j] = pids_group_op(stacks[0]->head[j].item);
+    }
+    ++g->stamp;
+
+    for (i = 0; i < numstacked; i++) {
+        src = stacks[i]->head;
+        if (!(key = src[keyoff].result.str))
+            key = "";
+        h = pids_group_hash(key);
+        for (node = g->hash ? g->hash[h & (g->hashsiz - 1)] : NULL; node; node = node->next)
+            if (node->hash == h && !strcmp(node->key, key))
+                break;
+        if (!node && !(node = pids_group_intern(g, key, h)))
+            return NULL;
+        if (node->stamp != g->stamp) {
+            // a group's first task, copied whole (save for the key)
+            if (!(numgroups < g->n_alloc) && !pids_group_grow(info, g))
+                return NULL;
+            node->stamp = g->stamp;
+            node->slot = numgroups++;
+            dst = g->heads[node->slot].head;
+            memcpy(dst, src, sizeof(struct pids_result) * info->maxitems);
+            dst[keyoff].result.str = node->key;
+            continue;
+        }
+        dst = g->heads[node->slot].head;
+        for (j = 0; j < info->maxitems; j++) {
+            switch (g->ops[j]) {
+                case GRP_s_int:   dst[j].result.s_int   += src[j].result.s_int;   break;
+                case GRP_u_int:   dst[j].result.u_int   += src[j].result.u_int;   break;
+                case GRP_ul_int:  dst[j].result.ul_int  += src[j].result.ul_int;  break;
+                case GRP_ull_int: dst[j].result.ull_int += src[j].result.ull_int; break;
+                case GRP_real:    dst[j].result.real    += src[j].result.real;    break;
+                default:
+                    break;
+            }
+        }
+    }
+    pids_group_purge(g, numgroups);
+
+    memset(&g->counts, 0, sizeof(struct pids_counts));
+    g->counts.total = numgroups;
+    g->stacks[numgroups] = NULL;
+    g->results.counts = &g->counts;
+    g->results.stacks = g->stacks;
+    return &g->results;
+} // end: procps_pids_group
+
+
+/*
+ * procps_pids_smaps_budget():
+ *
+ * Bound the cost of any PIDS_SMAP_ items for subsequent reaps or selects.
+ * The 'topk' tasks with the largest rss are always read, then others are
+ * read round-robin until 'budget_ms' is spent. The remaining tasks serve
+ * their prior values, with PIDS_SMAP_AGE showing how old those might be.
+ *
+ * Both of those parameters as zero (the default) means read every task.
+ *
+ * Returns: 0 on success, negative errno on error
+ */
+PROCPS_EXPORT int procps_pids_smaps_budget (
+        struct pids_info *info,
+        int topk,
+        int budget_ms)
+{
+    unsigned long *heap;
+
+    if (info == NULL || topk < 0 || budget_ms < 0)
+        return -EINVAL;
+
+    if (topk != info->smaps_topk) {
+        if (!(heap = realloc(info->hist->RSS_heap, sizeof(*heap) * (topk ? topk : 1))))
+            return -ENOMEM;
+        info->hist->RSS_heap = heap;
+        info->hist->RSS_num = 0;
+        info->smaps_topk = topk;
+    }
+    info->smaps_budget = budget_ms * 1000000ULL;
+    pids_libflags_set(info);
+    return 0;
+} // end: procps_pids_smaps_budget
+
+
 // --- special debugging function(s) ------------------------------------------
 /*
  *  The following isn't part of the normal programming interface.  Rather,
@@ -0,0 +1,780 @@
+/*
+ * pressure.c - pressure stall information definitions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "procps-private.h"
+#include "pressure.h"
+
+
+#ifndef PRESSURE_DIR
+#define PRESSURE_DIR  "/proc/pressure"
+#endif
+#ifndef CGROUP_DIR
+#define CGROUP_DIR    "/sys/fs/cgroup"
+#endif
+#define PRESSURE_BUFF  256
+
+/* ------------------------------------------------------------------------- +
+   this provision can be used to ensure that our Item_table was synchronized |
+   with those enumerators found in the associated header file. It's intended |
+   to only be used locally (& temporarily) at some point prior to a release! | */
+// #define ITEMTABLE_DEBUG //----------------------------------------------- |
+// ------------------------------------------------------------------------- +
+
+
+struct psi_line {
+    double avg10;
+    double avg60;
+    double avg300;
+    unsigned long long total;          // microseconds, since boot (or creation)
+};
+
+struct psi_resource {
+    struct psi_line some;
+    struct psi_line full;              // (irq has only this line)
+};
+
+struct pressure_data {
+    struct psi_resource cpu;
+    struct psi_resource io;
+    struct psi_resource irq;
+    struct psi_resource mem;
+};
+
+struct psi_hist {
+    struct pressure_data new;
+    struct pressure_data old;
+    unsigned long long new_ns;         // CLOCK_MONOTONIC when 'new' was read
+    unsigned long long old_ns;         //  "  'old' (zero before a 2nd read)
+};
+
+        // in the order of those psi_resource found in pressure_data
+static const char *psi_names[] = { "cpu", "io", "irq", "memory" };
+#define PSI_FILES  (int)MAXTABLE(psi_names)
+
+struct psi_file {
+    int fd;                            // persistent, re-read with pread
+    int absent;                        // the file could not be opened
+};
+
+struct stacks_extent {
+    int ext_numstacks;
+    struct stacks_extent *next;
+    struct pressure_stack **stacks;
+};
+
+struct pressure_info {
+    int refcount;
+    char *dir;                         // where those files are found
+    const char *suffix;                // "" or ".pressure" (for a cgroup)
+    struct psi_file files[PSI_FILES];  // one per psi_names entry
+    struct psi_hist hist;
+    int numitems;                      // includes 'logical_end' delimiter
+    enum pressure_item *items;         // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for all resettable extents
+    struct pressure_result get_this;
+    time_t sav_secs;
+};
+
+
+// ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+#define setNAME(e) set_pressure_ ## e
+#define setDECL(e) static void setNAME(e) \
+    (struct pressure_result *R, struct psi_hist *H)
+
+// regular assignment
+#define PSI_set(e,t,x) setDECL(e) { R->result. t = H->new. x; }
+// delta assignment (a cgroup recreated under the same name restarts its totals)
+#define HST_set(e,x) setDECL(e) { \
+    R->result.ull_int = H->new. x > H->old. x ? H->new. x - H->old. x : 0; }
+// percent of the elapsed time stalled, from microseconds & nanoseconds
+#define PCT_set(e,x) setDECL(e) { \
+    unsigned long long ns = H->old_ns ? H->new_ns - H->old_ns : 0; \
+    double pct = ns && H->new. x > H->old. x ? ( H->new. x - H->old. x ) * 1.0e5 / ns : 0.0; \
+    R->result.real = pct > 100.0 ? 100.0 : pct; }
+
+setDECL(noop)  { (void)R; (void)H; }
+setDECL(extra) { (void)H; R->result.ull_int = 0; }
+
+PSI_set(CPU_SOME_AVG10,         real,     cpu.some.avg10)
+PSI_set(CPU_SOME_AVG60,         real,     cpu.some.avg60)
+PSI_set(CPU_SOME_AVG300,        real,     cpu.some.avg300)
+PSI_set(CPU_SOME_TOTAL,         ull_int,  cpu.some.total)
+PSI_set(CPU_FULL_AVG10,         real,     cpu.full.avg10)
+PSI_set(CPU_FULL_AVG60,         real,     cpu.full.avg60)
+PSI_set(CPU_FULL_AVG300,        real,     cpu.full.avg300)
+PSI_set(CPU_FULL_TOTAL,         ull_int,  cpu.full.total)
+PSI_set(IO_SOME_AVG10,          real,     io.some.avg10)
+PSI_set(IO_SOME_AVG60,          real,     io.some.avg60)
+PSI_set(IO_SOME_AVG300,         real,     io.some.avg300)
+PSI_set(IO_SOME_TOTAL,          ull_int,  io.some.total)
+PSI_set(IO_FULL_AVG10,          real,     io.full.avg10)
+PSI_set(IO_FULL_AVG60,          real,     io.full.avg60)
+PSI_set(IO_FULL_AVG300,         real,     io.full.avg300)
+PSI_set(IO_FULL_TOTAL,          ull_int,  io.full.total)
+PSI_set(IRQ_FULL_AVG10,         real,     irq.full.avg10)
+PSI_set(IRQ_FULL_AVG60,         real,     irq.full.avg60)
+PSI_set(IRQ_FULL_AVG300,        real,     irq.full.avg300)
+PSI_set(IRQ_FULL_TOTAL,         ull_int,  irq.full.total)
+PSI_set(MEM_SOME_AVG10,         real,     mem.some.avg10)
+PSI_set(MEM_SOME_AVG60,         real,     mem.some.avg60)
+PSI_set(MEM_SOME_AVG300,        real,     mem.some.avg300)
+PSI_set(MEM_SOME_TOTAL,         ull_int,  mem.some.total)
+PSI_set(MEM_FULL_AVG10,         real,     mem.full.avg10)
+PSI_set(MEM_FULL_AVG60,         real,     mem.full.avg60)
+PSI_set(MEM_FULL_AVG300,        real,     mem.full.avg300)
+PSI_set(MEM_FULL_TOTAL,         ull_int,  mem.full.total)
+
+HST_set(DELTA_CPU_SOME_TOTAL,             cpu.some.total)
+HST_set(DELTA_CPU_FULL_TOTAL,             cpu.full.total)
+HST_set(DELTA_IO_SOME_TOTAL,              io.some.total)
+HST_set(DELTA_IO_FULL_TOTAL,              io.full.total)
+HST_set(DELTA_IRQ_FULL_TOTAL,             irq.full.total)
+HST_set(DELTA_MEM_SOME_TOTAL,             mem.some.total)
+HST_set(DELTA_MEM_FULL_TOTAL,             mem.full.total)
+setDECL(DELTA_ELAPSED) { R->result.real = H->old_ns ? ( H->new_ns - H->old_ns ) / 1.0e9 : 0.0; }
+PCT_set(DELTA_CPU_SOME_PCT,               cpu.some.total)
+PCT_set(DELTA_CPU_FULL_PCT,               cpu.full.total)
+PCT_set(DELTA_IO_SOME_PCT,                io.some.total)
+PCT_set(DELTA_IO_FULL_PCT,                io.full.total)
+PCT_set(DELTA_IRQ_FULL_PCT,               irq.full.total)
+PCT_set(DELTA_MEM_SOME_PCT,               mem.some.total)
+PCT_set(DELTA_MEM_FULL_PCT,               mem.full.total)
+
+#undef setDECL
+#undef PSI_set
+#undef HST_set
+#undef PCT_set
+
+
+// ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+typedef void (*SET_t)(struct pressure_result *, struct psi_hist *);
+#ifdef ITEMTABLE_DEBUG
+#define RS(e) (SET_t)setNAME(e), PRESSURE_ ## e, STRINGIFY(PRESSURE_ ## e)
+#else
+#define RS(e) (SET_t)setNAME(e)
+#endif
+
+#define TS(t) STRINGIFY(t)
+#define TS_noop ""
+
+        /*
+         * Need it be said?
+         * This table must be kept in the exact same order as
+         * those 'enum pressure_item' guys ! */
+static struct {
+    SET_t setsfunc;              // the actual result setting routine
+#ifdef ITEMTABLE_DEBUG
+    int   enumnumb;              // enumerator (must match position!)
+    char *enum2str;              // enumerator name as a char* string
+#endif
+    char *type2str;              // the result type as a string value
+} Item_table[] = {
+/*  setsfunc                       type2str
+    -----------------------------  ----------- */
+  { RS(noop),                      TS_noop     },
+  { RS(extra),                     TS_noop     },
+
+  { RS(CPU_SOME_AVG10),            TS(real)    },
+  { RS(CPU_SOME_AVG60),            TS(real)    },
+  { RS(CPU_SOME_AVG300),           TS(real)    },
+  { RS(CPU_SOME_TOTAL),            TS(ull_int) },
+  { RS(CPU_FULL_AVG10),            TS(real)    },
+  { RS(CPU_FULL_AVG60),            TS(real)    },
+  { RS(CPU_FULL_AVG300),           TS(real)    },
+  { RS(CPU_FULL_TOTAL),            TS(ull_int) },
+  { RS(IO_SOME_AVG10),             TS(real)    },
+  { RS(IO_SOME_AVG60),             TS(real)    },
+  { RS(IO_SOME_AVG300),            TS(real)    },
+  { RS(IO_SOME_TOTAL),             TS(ull_int) },
+  { RS(IO_FULL_AVG10),             TS(real)    },
+  { RS(IO_FULL_AVG60),             TS(real)    },
+  { RS(IO_FULL_AVG300),            TS(real)    },
+  { RS(IO_FULL_TOTAL),             TS(ull_int) },
+  { RS(IRQ_FULL_AVG10),            TS(real)    },
+  { RS(IRQ_FULL_AVG60),            TS(real)    },
+  { RS(IRQ_FULL_AVG300),           TS(real)    },
+  { RS(IRQ_FULL_TOTAL),            TS(ull_int) },
+  { RS(MEM_SOME_AVG10),            TS(real)    },
+  { RS(MEM_SOME_AVG60),            TS(real)    },
+  { RS(MEM_SOME_AVG300),           TS(real)    },
+  { RS(MEM_SOME_TOTAL),            TS(ull_int) },
+  { RS(MEM_FULL_AVG10),            TS(real)    },
+  { RS(MEM_FULL_AVG60),            TS(real)    },
+  { RS(MEM_FULL_AVG300),           TS(real)    },
+  { RS(MEM_FULL_TOTAL),            TS(ull_int) },
+
+  { RS(DELTA_CPU_SOME_TOTAL),      TS(ull_int) },
+  { RS(DELTA_CPU_FULL_TOTAL),      TS(ull_int) },
+  { RS(DELTA_IO_SOME_TOTAL),       TS(ull_int) },
+  { RS(DELTA_IO_FULL_TOTAL),       TS(ull_int) },
+  { RS(DELTA_IRQ_FULL_TOTAL),      TS(ull_int) },
+  { RS(DELTA_MEM_SOME_TOTAL),      TS(ull_int) },
+  { RS(DELTA_MEM_FULL_TOTAL),      TS(ull_int) },
+  { RS(DELTA_ELAPSED),             TS(real)    },
+  { RS(DELTA_CPU_SOME_PCT),        TS(real)    },
+  { RS(DELTA_CPU_FULL_PCT),        TS(real)    },
+  { RS(DELTA_IO_SOME_PCT),         TS(real)    },
+  { RS(DELTA_IO_FULL_PCT),         TS(real)    },
+  { RS(DELTA_IRQ_FULL_PCT),        TS(real)    },
+  { RS(DELTA_MEM_SOME_PCT),        TS(real)    },
+  { RS(DELTA_MEM_FULL_PCT),        TS(real)    },
+};
+
+    /* please note,
+     * this enum MUST be 1 greater than the highest value of any enum */
+enum pressure_item PRESSURE_logical_end = MAXTABLE(Item_table);
+
+#undef setNAME
+#undef RS
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+static inline void pressure_assign_results (
+        struct pressure_stack *stack,
+        struct psi_hist *hist)
+{
+    struct pressure_result *this = stack->head;
+
+    for (;;) {
+        enum pressure_item item = this->item;
+        if (item >= PRESSURE_logical_end)
+            break;
+        Item_table[item].setsfunc(this, hist);
+        ++this;
+    }
+    return;
+} // end: pressure_assign_results
+
+
+static void pressure_extents_free_all (
+        struct pressure_info *info)
+{
+    while (info->extents) {
+        struct stacks_extent *p = info->extents;
+        info->extents = info->extents->next;
+        free(p);
+    };
+} // end: pressure_extents_free_all
+
+
+static inline struct pressure_result *pressure_itemize_stack (
+        struct pressure_result *p,
+        int depth,
+        enum pressure_item *items)
+{
+    struct pressure_result *p_sav = p;
+    int i;
+
+    for (i = 0; i < depth; i++) {
+        p->item = items[i];
+        ++p;
+    }
+    return p_sav;
+} // end: pressure_itemize_stack
+
+
+static inline int pressure_items_check_failed (
+        int numitems,
+        enum pressure_item *items)
+{
+    int i;
+
+    /* if an enum is passed instead of an address of one or more enums, ol' gcc
+     * will silently convert it to an address (possibly NULL).  only clang will
+     * offer any sort of warning like the following:
+     *
+     * warning: incompatible integer to pointer conversion passing 'int' to parameter of type 'enum pressure_item *'
+     * my_stack = procps_pressure_select(info, PRESSURE_noop, num);
+     *                                         ^~~~~~~~~~~~~~~~~
+     */
+    if (numitems < 1
+    || (void *)items < (void *)(unsigned long)(2 * PRESSURE_logical_end))
+        return 1;
+
+    for (i = 0; i < numitems; i++) {
+        // a pressure_item is currently unsigned, but we'll protect our future
+        if (items[i] < 0)
+            return 1;
+        if (items[i] >= PRESSURE_logical_end)
+            return 1;
+    }
+
+    return 0;
+} // end: pressure_items_check_failed
+
+
+        /*
+         * Convert the kernel's "%lu.%02lu" average, which (unlike strtod)
+         * won't be at the mercy of some locale's decimal point. */
+static inline double pressure_avg (
+        const char **p)
+{
+    const char *s = *p;
+    unsigned long whole = 0, frac = 0, div = 1;
+
+    for ( ; *s >= '0' && *s <= '9'; s++)
+        whole = whole * 10 + (*s - '0');
+    if (*s == '.')
+        for (++s; *s >= '0' && *s <= '9'; s++, div *= 10)
+            frac = frac * 10 + (*s - '0');
+    *p = s;
+    return whole + (double)frac / div;
+} // end: pressure_avg
+
+
+        /*
+         * Parse one file's "some" and/or "full" lines, each of which has
+         * the form "some avg10=0.00 avg60=0.00 avg300=0.00 total=0". */
+static void pressure_parse (
+        struct psi_resource *res,
+        const char *head)
+{
+    struct psi_line *line;
+    const char *p;
+
+    while (*head) {
+        if (!strncmp(head, "some ", 5))
+            line = &res->some;
+        else if (!strncmp(head, "full ", 5))
+            line = &res->full;
+        else
+            line = NULL;
+        if (line) {
+            if ((p = strstr(head, "avg10="))) {
+                p += 6;
+                line->avg10 = pressure_avg(&p);
+            }
+            if ((p = strstr(head, "avg60="))) {
+                p += 6;
+                line->avg60 = pressure_avg(&p);
+            }
+            if ((p = strstr(head, "avg300="))) {
+                p += 7;
+                line->avg300 = pressure_avg(&p);
+            }
+            if ((p = strstr(head, "total=")))
+                line->total = strtoull(p + 6, NULL, 10);
+        }
+        if (!(head = strchr(head, '\n')))
+            break;
+        ++head;
+    }
+} // end: pressure_parse
+
+
+/*
+ * pressure_read_failed():
+ *
+ * Read each of the pressure files (opening them the first time only),
+ * into the 'new' history. A file which can't be opened is ignored
+ * thereafter, so long as at least one of them could be opened.
+ */
+static int pressure_read_failed (
+        struct pressure_info *info)
+{
+    char buf[PRESSURE_BUFF], path[PATH_MAX];
+    struct psi_resource *res[] = {
+        &info->hist.new.cpu, &info->hist.new.io, &info->hist.new.irq, &info->hist.new.mem };
+    struct timespec ts;
+    int i, size, present = 0, open_errno = ENOENT;
+
+    // remember history from last time around
+    memcpy(&info->hist.old, &info->hist.new, sizeof(struct pressure_data));
+    // clear out the soon to be 'current' values
+    memset(&info->hist.new, 0, sizeof(struct pressure_data));
+    info->hist.old_ns = info->hist.new_ns;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    info->hist.new_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+
+    for (i = 0; i < PSI_FILES; i++) {
+        struct psi_file *this = &info->files[i];
+
+        if (this->absent)
+            continue;
+        if (-1 == this->fd) {
+            snprintf(path, sizeof(path), "%s/%s%s", info->dir, psi_names[i], info->suffix);
+            if (-1 == (this->fd = open(path, O_RDONLY))) {
+                open_errno = errno;
+                this->absent = 1;
+                continue;
+            }
+        }
+        // each read at offset 0 generates fresh content, no lseek needed
+        for (;;) {
+            if ((size = pread(this->fd, buf, sizeof(buf)-1, 0)) < 0) {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                return 1;
+            }
+            break;
+        }
+        if (size == 0) {
+            errno = EIO;
+            return 1;
+        }
+        buf[size] = '\0';
+        pressure_parse(res[i], buf);
+        ++present;
+    }
+    if (!present) {
+        errno = open_errno;
+        return 1;
+    }
+    return 0;
+} // end: pressure_read_failed
+
+
+/*
+ * pressure_stacks_alloc():
+ *
+ * Allocate and initialize one or more stacks each of which is anchored in an
+ * associated context structure.
+ *
+ * All such stacks will have their result structures properly primed with
+ * 'items', while the result itself will be zeroed.
+ *
+ * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
+ */
+static struct stacks_extent *pressure_stacks_alloc (
+        struct pressure_info *info,
+        int maxstacks)
+{
+    struct stacks_extent *p_blob;
+    struct pressure_stack **p_vect;
+    struct pressure_stack *p_head;
+    size_t vect_size, head_size, list_size, blob_size;
+    void *v_head, *v_list;
+    int i;
+
+    vect_size  = sizeof(void *) * maxstacks;                    // size of the addr vectors |
+    vect_size += sizeof(void *);                                // plus NULL addr delimiter |
+    head_size  = sizeof(struct pressure_stack);                 // size of that head struct |
+    list_size  = sizeof(struct pressure_result)*info->numitems; // any single results stack |
+    blob_size  = sizeof(struct stacks_extent);                  // the extent anchor itself |
+    blob_size += vect_size;                                     // plus room for addr vects |
+    blob_size += head_size * maxstacks;                         // plus room for head thing |
+    blob_size += list_size * maxstacks;                         // plus room for our stacks |
+
+    /* note: all of this memory is allocated in a single blob, facilitating a later free(). |
+             as a minimum, it is important that the result structures themselves always are |
+             contiguous within each stack since they're accessed through relative position. | */
+    if (NULL == (p_blob = calloc(1, blob_size)))
+        return NULL;
+
+    p_blob->next = info->extents;                               // push this extent onto... |
+    info->extents = p_blob;                                     // ...some existing extents |
+    p_vect = (void *)p_blob + sizeof(struct stacks_extent);     // prime our vector pointer |
+    p_blob->stacks = p_vect;                                    // set actual vectors start |
+    v_head = (void *)p_vect + vect_size;                        // prime head pointer start |
+    v_list = v_head + (head_size * maxstacks);                  // prime our stacks pointer |
+
+    for (i = 0; i < maxstacks; i++) {
+        p_head = (struct pressure_stack *)v_head;
+        p_head->head = pressure_itemize_stack((struct pressure_result *)v_list, info->numitems, info->items);
+        p_blob->stacks[i] = p_head;
+        v_list += list_size;
+        v_head += head_size;
+    }
+    p_blob->ext_numstacks = maxstacks;
+    return p_blob;
+} // end: pressure_stacks_alloc
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_pressure_new_cgroup:
+ *
+ * Create a new container to hold the pressure stall information for a
+ * cgroup v2 control group, as in "/system.slice" (relative to where the
+ * unified hierarchy is mounted), or for the whole system when 'cgroup'
+ * is NULL.
+ *
+ * The initial refcount is 1, and needs to be decremented
+ * to release the resources of the structure.
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_pressure_new_cgroup (
+        struct pressure_info **info,
+        const char *cgroup)
+{
+    struct pressure_info *p;
+    char path[PATH_MAX];
+    int i;
+
+#ifdef ITEMTABLE_DEBUG
+    int failed = 0;
+    for (i = 0; i < MAXTABLE(Item_table); i++) {
+        if (i != Item_table[i].enumnumb) {
+            fprintf(stderr, "%s: enum/table error: Item_table[%d] was %s, but its value is %d\n"
+                , __FILE__, i, Item_table[i].enum2str, Item_table[i].enumnumb);
+            failed = 1;
+        }
+    }
+    if (failed) _Exit(EXIT_FAILURE);
+#endif
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct pressure_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    for (i = 0; i < PSI_FILES; i++)
+        p->files[i].fd = -1;
+    if (cgroup) {
+        snprintf(path, sizeof(path), "%s%s%s"
+            , CGROUP_DIR, cgroup[0] == '/' ? "" : "/", cgroup);
+        p->suffix = ".pressure";
+    } else {
+        snprintf(path, sizeof(path), "%s", PRESSURE_DIR);
+        p->suffix = "";
+    }
+    if (!(p->dir = strdup(path))) {
+        free(p);
+        return -ENOMEM;
+    }
+
+    /* do a priming read here for the following potential benefits: |
+         1) ensure there will be no problems with subsequent access |
+         2) make delta results potentially useful, even if 1st time |
+         3) eliminate need for history distortion 1st time 'switch' | */
+    if (pressure_read_failed(p)) {
+        procps_pressure_unref(&p);
+        return -errno;
+    }
+
+    *info = p;
+    return 0;
+} // end: procps_pressure_new_cgroup
+
+
+/*
+ * procps_pressure_new:
+ *
+ * Create a new container to hold the system wide pressure stall
+ * information, from the /proc/pressure directory.
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_pressure_new (
+        struct pressure_info **info)
+{
+    return procps_pressure_new_cgroup(info, NULL);
+} // end: procps_pressure_new
+
+
+PROCPS_EXPORT int procps_pressure_ref (
+        struct pressure_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_pressure_ref
+
+
+PROCPS_EXPORT int procps_pressure_unref (
+        struct pressure_info **info)
+{
+    int i;
+
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        for (i = 0; i < PSI_FILES; i++)
+            if ((*info)->files[i].fd != -1)
+                close((*info)->files[i].fd);
+
+        if ((*info)->extents)
+            pressure_extents_free_all(*info);
+        if ((*info)->items)
+            free((*info)->items);
+        free((*info)->dir);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_pressure_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+PROCPS_EXPORT struct pressure_result *procps_pressure_get (
+        struct pressure_info *info,
+        enum pressure_item item)
+{
+    time_t cur_secs;
+
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    if (item < 0 || item >= PRESSURE_logical_end)
+        return NULL;
+    errno = 0;
+
+    /* we will NOT read the pressure files with every call - rather, we'll
+       offer a granularity of 1 second between reads ... */
+    cur_secs = time(NULL);
+    if (1 <= cur_secs - info->sav_secs) {
+        if (pressure_read_failed(info))
+            return NULL;
+        info->sav_secs = cur_secs;
+    }
+
+    info->get_this.item = item;
+    //  with 'get', we must NOT honor the usual 'noop' guarantee
+    info->get_this.result.ull_int = 0;
+    Item_table[item].setsfunc(&info->get_this, &info->hist);
+
+    return &info->get_this;
+} // end: procps_pressure_get
+
+
+/* procps_pressure_select():
+ *
+ * Harvest all the requested pressure information then return
+ * it in a results stack.  Every call re-reads the files, which
+ * are kept open, so that frequent polling remains inexpensive.
+ *
+ * Returns: pointer to a pressure_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct pressure_stack *procps_pressure_select (
+        struct pressure_info *info,
+        enum pressure_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (pressure_items_check_failed(numitems, items))
+        return NULL;
+    errno = 0;
+
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (info->numitems != numitems + 1
+    || memcmp(info->items, items, sizeof(enum pressure_item) * numitems)) {
+        // allow for our PRESSURE_logical_end
+        if (!(info->items = realloc(info->items, sizeof(enum pressure_item) * (numitems + 1))))
+            return NULL;
+        memcpy(info->items, items, sizeof(enum pressure_item) * numitems);
+        info->items[numitems] = PRESSURE_logical_end;
+        info->numitems = numitems + 1;
+        if (info->extents)
+            pressure_extents_free_all(info);
+    }
+    if (!info->extents
+    && (!pressure_stacks_alloc(info, 1)))
+       return NULL;
+
+    if (pressure_read_failed(info))
+        return NULL;
+    pressure_assign_results(info->extents->stacks[0], &info->hist);
+
+    return info->extents->stacks[0];
+} // end: procps_pressure_select
+
+
+// --- special debugging function(s) ------------------------------------------
+/*
+ *  The following isn't part of the normal programming interface.  Rather,
+ *  it exists to validate result types referenced in application programs.
+ *
+ *  It's used only when:
+ *      1) the 'XTRA_PROCPS_DEBUG' has been defined, or
+ *      2) an #include of 'xtra-procps-debug.h' is used
+ */
+
+PROCPS_EXPORT struct pressure_result *xtra_pressure_get (
+        struct pressure_info *info,
+        enum pressure_item actual_enum,
+        const char *typestr,
+        const char *file,
+        int lineno)
+{
+    struct pressure_result *r = procps_pressure_get(info, actual_enum);
+
+    if (actual_enum < 0 || actual_enum >= PRESSURE_logical_end) {
+        fprintf(stderr, "%s line %d: invalid item = %d, type = %s\n"
+            , file, lineno, actual_enum, typestr);
+    }
+    if (r) {
+        char *str = Item_table[r->item].type2str;
+        if (str[0]
+        && (strcmp(typestr, str)))
+            fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return r;
+} // end: xtra_pressure_get_
+
+
+PROCPS_EXPORT struct pressure_result *xtra_pressure_val (
+        int relative_enum,
+        const char *typestr,
+        const struct pressure_stack *stack,
+        const char *file,
+        int lineno)
+{
+    char *str;
+    int i;
+
+    for (i = 0; stack->head[i].item < PRESSURE_logical_end; i++)
+        ;
+    if (relative_enum < 0 || relative_enum >= i) {
+        fprintf(stderr, "%s line %d: invalid relative_enum = %d, valid range = 0-%d\n"
+            , file, lineno, relative_enum, i-1);
+        return NULL;
+    }
+    str = Item_table[stack->head[relative_enum].item].type2str;
+    if (str[0]
+    && (strcmp(typestr, str))) {
+        fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return &stack->head[relative_enum];
+} // end: xtra_pressure_val
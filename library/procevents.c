@@ -0,0 +1,310 @@
+/*
+ * procevents.c - a live tgid set, maintained from cn_proc fork events
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+
+#include "procevents.h"
+
+/*
+ * The set is a bitmap indexed by pid, plus a summary map with one bit for
+ * each non-zero word of the first.  So, while pid_max might be in the millions,
+ * producing the ascending tgid list costs just a few thousand word tests.
+ *
+ * Only fork events are of interest, and only those for a new thread group.
+ * The exits are left to procevents_gone since a group leader's exit doesn't
+ * mean its process has ended, nor does it mean the zombie has been reaped.
+ */
+
+#define BPW          (8 * sizeof(unsigned long))
+#define PIDMAX_DEF   4194304           // used if /proc/sys/kernel/pid_max fails
+#define ACK_WAIT     100               // msecs allowed for the subscription ack
+#define RCVBUF_SIZ   (1024 * 1024)     // room for bursts of events between reaps
+#define PIDS_GROW    1024              // amount by which the 'pids' array grows
+
+struct procevents {
+    int sock;                          // the NETLINK_CONNECTOR socket
+    int resync;                        // events were lost, rescan /proc
+    unsigned nbits;                    // current pid_max, as bits in 'map'
+    unsigned long *map;                // one bit per live tgid
+    unsigned long *sum;                // one bit per non-zero 'map' word
+    pid_t *pids;                       // the tgids returned by procevents_pids
+    int alloc;                         // number of above pids allocated
+};
+
+struct cn_listen {
+    struct nlmsghdr nl;
+    struct cn_msg cn;
+    enum proc_cn_mcast_op op;
+} __attribute__((packed));
+
+
+static inline void procevents_set (
+        struct procevents *ev,
+        pid_t pid)
+{
+    unsigned w = (unsigned)pid / BPW;
+
+    if (pid <= 0 || (unsigned)pid >= ev->nbits) {
+        ev->resync = 1;                // pid_max must have been raised
+        return;
+    }
+    ev->map[w] |= 1UL << ((unsigned)pid % BPW);
+    ev->sum[w / BPW] |= 1UL << (w % BPW);
+} // end: procevents_set
+
+
+static unsigned procevents_pidmax (void)
+{
+    unsigned n = 0;
+    FILE *fp;
+
+    if ((fp = fopen("/proc/sys/kernel/pid_max", "r"))) {
+        if (fscanf(fp, "%u", &n) != 1)
+            n = 0;
+        fclose(fp);
+    }
+    return n ? n + 1 : PIDMAX_DEF;
+} // end: procevents_pidmax
+
+
+static int procevents_rescan (
+        struct procevents *ev)
+{
+    unsigned nbits, nwords;
+    struct dirent *ent;
+    DIR *dir;
+
+    nbits = procevents_pidmax();
+    nwords = (nbits + BPW - 1) / BPW;
+    if (nbits > ev->nbits) {
+        free(ev->map);
+        free(ev->sum);
+        ev->map = calloc(nwords, sizeof(unsigned long));
+        ev->sum = calloc(nwords / BPW + 1, sizeof(unsigned long));
+        ev->nbits = 0;
+        if (!ev->map || !ev->sum)
+            return -ENOMEM;
+        ev->nbits = nwords * BPW;
+    } else {
+        memset(ev->map, 0, (ev->nbits / BPW) * sizeof(unsigned long));
+        memset(ev->sum, 0, (ev->nbits / BPW / BPW + 1) * sizeof(unsigned long));
+    }
+    if (!(dir = opendir("/proc")))
+        return -errno;
+    while ((ent = readdir(dir))) {
+        if (*ent->d_name > '0' && *ent->d_name <= '9')
+            procevents_set(ev, (pid_t)strtoul(ent->d_name, NULL, 10));
+    }
+    closedir(dir);
+    ev->resync = 0;
+    return 0;
+} // end: procevents_rescan
+
+
+        /*
+         * Read whatever the kernel has queued for us, returning the number
+         * of fork events seen.  A PROC_EVENT_NONE (acknowledgement) sets 'ack'
+         * to its error value, if non-NULL, and that value is biased by one
+         * so that a zero 'ack' still means no acknowledgement was received. */
+static int procevents_drain (
+        struct procevents *ev,
+        int *ack)
+{
+    unsigned long buf[8192 / sizeof(unsigned long)];
+    struct sockaddr_nl from;
+    socklen_t fromlen;
+    struct nlmsghdr *nl;
+    struct proc_event *pe;
+    struct cn_msg *cn;
+    ssize_t n;
+    int forks = 0;
+
+    for (;;) {
+        fromlen = sizeof(from);
+        n = recvfrom(ev->sock, buf, sizeof(buf), 0, (struct sockaddr *)&from, &fromlen);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOBUFS) {    // our receive buffer overflowed
+                ev->resync = 1;
+                continue;
+            }
+            break;                     // EAGAIN, i.e. nothing left
+        }
+        if (from.nl_pid != 0)          // only the kernel is believed
+            continue;
+        for (nl = (struct nlmsghdr *)buf; NLMSG_OK(nl, n); nl = NLMSG_NEXT(nl, n)) {
+            if (nl->nlmsg_type == NLMSG_ERROR || nl->nlmsg_type == NLMSG_NOOP)
+                continue;
+            cn = NLMSG_DATA(nl);
+            if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC)
+                continue;
+            pe = (struct proc_event *)cn->data;
+            switch (pe->what) {
+                case PROC_EVENT_FORK:
+                    if (pe->event_data.fork.child_pid == pe->event_data.fork.child_tgid) {
+                        procevents_set(ev, pe->event_data.fork.child_tgid);
+                        ++forks;
+                    }
+                    break;
+                case PROC_EVENT_NONE:
+                    if (ack)
+                        *ack = pe->event_data.ack.err + 1;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return forks;
+} // end: procevents_drain
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int procevents_open (
+        struct procevents **ev)
+{
+    struct sockaddr_nl sa = { .nl_family = AF_NETLINK, .nl_groups = CN_IDX_PROC };
+    struct cn_listen msg;
+    struct pollfd pfd;
+    int ack = 0, rc, siz = RCVBUF_SIZ;
+
+    if (!(*ev = calloc(1, sizeof(struct procevents))))
+        return -ENOMEM;
+    (*ev)->sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+    if ((*ev)->sock < 0)
+        goto fail_errno;
+    if (bind((*ev)->sock, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+        goto fail_errno;
+    // this one requires CAP_NET_ADMIN, the one that follows will be capped
+    if (setsockopt((*ev)->sock, SOL_SOCKET, SO_RCVBUFFORCE, &siz, sizeof(siz)) < 0)
+        setsockopt((*ev)->sock, SOL_SOCKET, SO_RCVBUF, &siz, sizeof(siz));
+
+    memset(&msg, 0, sizeof(msg));
+    msg.nl.nlmsg_len = sizeof(msg);
+    msg.nl.nlmsg_type = NLMSG_DONE;
+    msg.nl.nlmsg_pid = getpid();
+    msg.cn.id.idx = CN_IDX_PROC;
+    msg.cn.id.val = CN_VAL_PROC;
+    msg.cn.len = sizeof(enum proc_cn_mcast_op);
+    msg.op = PROC_CN_MCAST_LISTEN;
+    if (send((*ev)->sock, &msg, sizeof(msg), 0) < 0)
+        goto fail_errno;
+
+    /* outside the initial namespaces, the kernel ignores our request without
+       any reply, so no acknowledgement is treated the same as a refusal ... */
+    pfd.fd = (*ev)->sock;
+    pfd.events = POLLIN;
+    while (!ack) {
+        if (poll(&pfd, 1, ACK_WAIT) <= 0) {
+            rc = -EPERM;
+            goto fail;
+        }
+        procevents_drain(*ev, &ack);
+    }
+    if (ack > 1) {
+        rc = -(ack - 1);
+        goto fail;
+    }
+    // we're subscribed, so any task we miss in this scan will be an event
+    if ((rc = procevents_rescan(*ev)) < 0)
+        goto fail;
+    return 0;
+
+fail_errno:
+    rc = -errno;
+fail:
+    procevents_close(ev);
+    return rc;
+} // end: procevents_open
+
+
+void procevents_close (
+        struct procevents **ev)
+{
+    if (ev == NULL || *ev == NULL)
+        return;
+    if ((*ev)->sock >= 0)
+        close((*ev)->sock);
+    free((*ev)->map);
+    free((*ev)->sum);
+    free((*ev)->pids);
+    free(*ev);
+    *ev = NULL;
+} // end: procevents_close
+
+
+int procevents_pids (
+        struct procevents *ev,
+        pid_t **pids)
+{
+    unsigned long bits, words;
+    unsigned s, w, nsum;
+    int n = 0;
+
+    procevents_drain(ev, NULL);
+    if (ev->resync && procevents_rescan(ev) < 0)
+        return -1;
+
+    nsum = ev->nbits / BPW / BPW + 1;
+    for (s = 0; s < nsum; s++) {
+        for (words = ev->sum[s]; words; words &= words - 1) {
+            w = s * BPW + __builtin_ctzl(words);
+            for (bits = ev->map[w]; bits; bits &= bits - 1) {
+                if (n + 1 >= ev->alloc) {
+                    pid_t *p = realloc(ev->pids, (ev->alloc + PIDS_GROW) * sizeof(pid_t));
+                    if (!p)
+                        return -1;
+                    ev->pids = p;
+                    ev->alloc += PIDS_GROW;
+                }
+                ev->pids[n++] = w * BPW + __builtin_ctzl(bits);
+            }
+        }
+    }
+    *pids = ev->pids;
+    return n;
+} // end: procevents_pids
+
+
+void procevents_gone (
+        struct procevents *ev,
+        pid_t pid)
+{
+    unsigned w = (unsigned)pid / BPW;
+
+    if (pid <= 0 || (unsigned)pid >= ev->nbits)
+        return;
+    ev->map[w] &= ~(1UL << ((unsigned)pid % BPW));
+    if (!ev->map[w])
+        ev->sum[w / BPW] &= ~(1UL << (w % BPW));
+} // end: procevents_gone
@@ -38,6 +38,7 @@
 #include <sys/syscall.h>
 #include <limits.h>
 #include <stdint.h>
+#include <time.h>
 #ifdef WITH_SYSTEMD
 #include <systemd/sd-login.h>
 #endif
@@ -48,8 +49,11 @@
 #include "devname.h"
 #include "escape.h"
 #include "misc.h"
+#include "pids.h"
+#include "procps-private.h"
 #include "pwcache.h"
 #include "readproc.h"
+#include "smaps.h"
 
 // sometimes it's easier to do this manually, w/o gcc helping
 #ifdef PROF
@@ -81,6 +85,40 @@ static int task_dir_missing;
 
 char *str_none = "-";
 
+    // A /proc/<pid>/cgroup file, as read, plus everything derived from it.
+    // The many tasks with identical contents all share one such record, found
+    // by hashing those contents, with each field valued upon its first use.
+    // Thus proc_t fields pointing here are never freed by anyone but us.
+struct cgroup_ele {
+    struct cgroup_ele *next;
+    unsigned hash;
+    int len;
+    char *raw;                  // the file's contents, our key
+    char *cgroup;               // PROC_EDITCGRPCVT
+    char *cgname;               //  "
+    char *lxcname;              // PROC_FILL_LXC (owned by lxc_containers)
+    struct docker_ids *docker;  // PROC_FILL_DOCKER (owned by docker_containers)
+    int sd_done;                // PROC_FILLSYSTEMD, once all next 3 are valued
+    char *sd_slice;
+    char *sd_unit;
+    char *sd_uunit;
+};
+#define CGROUP_HASH  256        // buckets for the above (a power of 2)
+
+#define CGROUP_INTERN ( PROC_FILLCGROUP | PROC_EDITCGRPCVT | PROC_FILLSYSTEMD | PROC_FILL_LXC | PROC_FILL_DOCKER )
+
+    // A status 'Cpus_allowed' mask, likewise shared by all tasks having it,
+    // with the bitmap (then that raw text) allocated along with each one.
+struct cpus_ele {
+    struct cpus_ele *next;
+    unsigned hash;
+    int len;
+    const char *raw;            // the status text, our key
+    struct pids_cpus cpus;      // PROC_FILL_CPUS
+};
+#define CPUS_HASH  32           // buckets for the above (a power of 2)
+#define CPUS_BPW   (int)(8 * sizeof(unsigned long))
+
 // free any additional dynamically acquired storage associated with a proc_t
 static inline void free_acquired (proc_t *p) {
     /*
@@ -88,16 +126,12 @@ static inline void free_acquired (proc_t *p) {
      * requested by our caller.  it is expected that pid.c will then free |
      * any remaining dynamic memory which might be dangling off a proc_t. | */
     if (p->cmd)    free(p->cmd);
-    if (p->cgname) free(p->cgname);
 
-    if (p->cgroup   && p->cgroup   != str_none)  free(p->cgroup);
+    // ( cgroup, cgname & sd_slice, sd_unit, sd_uunit are a cgroup_ele's )
     if (p->sd_mach  && p->sd_mach  != str_none)  free(p->sd_mach);
     if (p->sd_ouid  && p->sd_ouid  != str_none)  free(p->sd_ouid);
     if (p->sd_seat  && p->sd_seat  != str_none)  free(p->sd_seat);
     if (p->sd_sess  && p->sd_sess  != str_none)  free(p->sd_sess);
-    if (p->sd_slice && p->sd_slice != str_none)  free(p->sd_slice);
-    if (p->sd_unit  && p->sd_unit  != str_none)  free(p->sd_unit);
-    if (p->sd_uunit && p->sd_uunit != str_none)  free(p->sd_uunit);
     if (p->supgid   && p->supgid   != str_none)  free(p->supgid);
 
     memset(p, '\0', sizeof(proc_t));
@@ -120,6 +154,18 @@ static void close_dirfd(int *fd)
     }
 }
 
+// a pinned /proc/<pid> whose process died is released, to be reopened later
+static void pinned_unpin(PROCTAB *PT)
+{
+    PINTAB *pin = PT->pins - 1;         // the finder has already moved on
+
+    if (pin->once)
+        close_dirfd(&PT->pidfd);
+    close_dirfd(&pin->dirfd);
+    pin->tgid = 0;
+    PT->pidfd = -1;
+}
+
 /*
  * Open a directory stream using the pathname relative what dirfd points to.
  * If successful, fdopendir() takes control of the fd, so we it gets closed
@@ -148,7 +194,7 @@ static DIR* opendirat(
 ///////////////////////////////////////////////////////////////////////////
 
 typedef struct status_table_struct {
-    unsigned char name[8];        // /proc/*/status field name
+    unsigned char name[26];       // /proc/*/status field name
     unsigned char len;            // name length
 #ifdef LABEL_OFFSET
     long offset;                  // jump address offset
@@ -184,8 +230,12 @@ typedef struct status_table_struct {
 // In the status_table_struct watch out for name size (grrr, expanding)
 // and the number of entries. Currently, the table is padded to 128
 // entries and we therefore mask with 127.
+//
+// The 2 '*_ctxt_switches' entries were then placed by hand, using the
+// 'asso' values of 'l', 'n' and 'v' (otherwise unused) to reach 2 NULs.
+// And 'Cpus_allowed' (via 'C', 'u' and 's') landed in the padding at 115.
 
-static int status2proc (char *S, proc_t *restrict P, int is_proc) {
+static int status2proc (char *S, proc_t *restrict P, int is_proc, unsigned flags) {
     long Threads = 0;
     long Tgid = 0;
     long Pid = 0;
@@ -203,8 +253,8 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
        50,  10,   0,  35, 101, 101,  21, 101,  30, 101,
        20,  36,   0,   5,   0,  40,   0,   0, 101, 101,
       101, 101, 101, 101, 101, 101, 101,  30, 101,  15,
-        0,   1, 101,  10, 101,  10, 101, 101, 101,  25,
-      101,  40,   0, 101,   0,  50,   6,  40, 101,   1,
+        0,   1, 101,  10, 101,  10, 101, 101,   1,  25,
+       21,  40,   0, 101,   0,  50,   6,  40,   1,   1,
        35, 101, 101, 101, 101, 101, 101, 101
     };
 
@@ -235,7 +285,9 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
       NUL NUL NUL
       F(SigCgt)
       F(State)
-      NUL NUL NUL
+      F(voluntary_ctxt_switches)
+      F(nonvoluntary_ctxt_switches)
+      NUL
       F(CapPrm)
       F(Uid)
       NUL NUL NUL
@@ -263,6 +315,8 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
       F(RssAnon)
       NUL NUL NUL NUL
       F(RssFile)
+      NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL
+      F(Cpus_allowed)
     };
 
 #undef F
@@ -407,6 +461,18 @@ ENTER(0x220);
     case_VmSwap: // Linux 2.6.34
         P->vm_swap = (unsigned long)strtol(S,&S,10);
         continue;
+    case_voluntary_ctxt_switches:    // Linux 2.6.23
+        P->ctxsw_vol = strtoul(S,&S,10);
+        continue;
+    case_nonvoluntary_ctxt_switches:
+        P->ctxsw_invol = strtoul(S,&S,10);
+        continue;
+    case_Cpus_allowed:
+        if (flags & (PROC_FILL_CPUS & ~PROC_FILLSTATUS)) {
+            if (!(P->cpus = cpus_interned(S)))
+                return 1;
+        }
+        continue;
     case_Groups:
     {   char *ss = S, *nl = strchr(S, '\n');
         size_t j;
@@ -541,7 +607,20 @@ static inline void oomadj2proc(const char *S, proc_t *restrict P)
 
 ///////////////////////////////////////////////////////////////////////
 
-static int sd2proc (proc_t *restrict p) {
+#if defined(WITH_SYSTEMD) || defined(WITH_ELOGIND)
+    // A cgroup_ele's sd-login answer: the string, else str_none when there
+    // is definitely no such thing, else NULL when the task had gone (which
+    // leaves it to be asked again of some later task with this cgroup).
+static inline void sd2cgroup (int rc, char **str) {
+    if (rc >= 0)
+        return;
+    *str = (rc == -ESRCH || rc == -ENOENT) ? NULL : str_none;
+}
+#endif
+
+    // Those slice & unit fields follow from a task's cgroup alone, so
+    // they're asked of sd-login just once for each distinct cgroup_ele.
+static int sd2proc (proc_t *restrict p, struct cgroup_ele *cg) {
 #if defined(WITH_SYSTEMD) || defined(WITH_ELOGIND)
     char buf[64];
     uid_t uid;
@@ -563,14 +642,17 @@ static int sd2proc (proc_t *restrict p) {
         if (0 > sd_session_get_seat(p->sd_sess, &p->sd_seat))
             p->sd_seat = str_none;
     }
-    if (0 > sd_pid_get_slice(p->tid, &p->sd_slice))
-        p->sd_slice = str_none;
-
-    if (0 > sd_pid_get_unit(p->tid, &p->sd_unit))
-        p->sd_unit = str_none;
-
-    if (0 > sd_pid_get_user_unit(p->tid, &p->sd_uunit))
-        p->sd_uunit = str_none;
+    /* only a lookup failing with the task gone isn't remembered -- a
+       system service has no user unit, nor a kernel thread any unit */
+    if (!cg->sd_done) {
+        if (!cg->sd_slice)
+            sd2cgroup(sd_pid_get_slice(p->tid, &cg->sd_slice), &cg->sd_slice);
+        if (!cg->sd_unit)
+            sd2cgroup(sd_pid_get_unit(p->tid, &cg->sd_unit), &cg->sd_unit);
+        if (!cg->sd_uunit)
+            sd2cgroup(sd_pid_get_user_unit(p->tid, &cg->sd_uunit), &cg->sd_uunit);
+        cg->sd_done = (cg->sd_slice && cg->sd_unit && cg->sd_uunit);
+    }
 #else
     if (!(p->sd_mach  = strdup("?")))
         return 1;
@@ -580,13 +662,19 @@ static int sd2proc (proc_t *restrict p) {
         return 1;
     if (!(p->sd_sess  = strdup("?")))
         return 1;
-    if (!(p->sd_slice = strdup("?")))
-        return 1;
-    if (!(p->sd_unit  = strdup("?")))
-        return 1;
-    if (!(p->sd_uunit = strdup("?")))
-        return 1;
+    if (!cg->sd_done) {
+        if (!cg->sd_slice && !(cg->sd_slice = strdup("?")))
+            return 1;
+        if (!cg->sd_unit  && !(cg->sd_unit  = strdup("?")))
+            return 1;
+        if (!cg->sd_uunit && !(cg->sd_uunit = strdup("?")))
+            return 1;
+        cg->sd_done = 1;
+    }
 #endif
+    p->sd_slice = cg->sd_slice ? cg->sd_slice : str_none;
+    p->sd_unit  = cg->sd_unit  ? cg->sd_unit  : str_none;
+    p->sd_uunit = cg->sd_uunit ? cg->sd_uunit : str_none;
     return 0;
 }
 
@@ -675,6 +763,11 @@ static void statm2proc(const char *s, proc_t *restrict P) {
            &P->trs, &P->lrs, &P->drs, &P->dt);
 }
 
+static void schedstat2proc(const char *s, proc_t *restrict P) {
+    sscanf(s, "%llu %llu %lu",
+            &P->sched_runtime, &P->sched_wait, &P->sched_slices);
+}
+
 static void io2proc(const char *s, proc_t *restrict P) {
     sscanf(s, "rchar: %lu wchar: %lu syscr: %lu syscw: %lu read_bytes: %lu write_bytes: %lu cancelled_write_bytes: %lu",
             &P->rchar, &P->wchar, &P->syscr,
@@ -682,25 +775,13 @@ static void io2proc(const char *s, proc_t *restrict P) {
 }
 
     // Assuming permissions have allowed the read of smaps_rollup, this
-    // guy will extract some %lu data. Considering the number of items,
-    // we are between small enough to use a sscanf and large enough for
-    // a search.h approach. Thus we roll (get it?) our own custom code.
-static void smaps2proc (const char *s, proc_t *restrict P) {
-  #define enMAX (int)((sizeof(smaptab) / sizeof(smaptab[0])))
-    // 1st proc_t data field
-  #define fZERO tid
-    // a smaptab entry generator
-  #define mkENT(F) { #F ":", -1, offsetof(proc_t, smap_ ## F) }
-    // make a target field
-  #define mkOBJ(X) ( (unsigned long *)((void *)&P->fZERO + smaptab[X].offs) )
-    static struct {
-        const char *item;
-        int slen;
-        int offs;
-    } smaptab[] =  {
-        /*    Size                 smaps only, not rollup */
-        /*    KernelPageSize                 "            */
-        /*    MMUPageSize                    "            */
+    // guy will extract some %lu data. It's a single pass over the lines,
+    // with each name looked up via the (perfect) hash in local/smaps.c,
+    // so neither the kernel's order nor any new fields will matter here.
+static void smaps2proc (char *s, int len, proc_t *restrict P) {
+    // a smaptab entry generator, 0 means the field isn't kept in a proc_t
+  #define mkENT(F) [SMAPS_ ## F] = offsetof(proc_t, smap_ ## F)
+    static const unsigned short smaptab[SMAPS_NUMFIELDS] = {
         mkENT(Rss),
         mkENT(Pss),
         mkENT(Pss_Anon),        /* rollup only, not smaps */
@@ -721,30 +802,16 @@ static void smaps2proc (const char *s, proc_t *restrict P) {
         mkENT(Swap),
         mkENT(SwapPss),
         mkENT(Locked)
-        /*    THPeligible          smaps only, not rollup */
-        /*    ProtectionKey                  "            */
-        /*    VmFlags                        "            */
     };
-    const char *head;
-    char *tail;
-    int i;
+    struct smaps_line line;
+    const char *end = s + len;
 
-    if (smaptab[0].slen < 0) {
-        for (i = 0; i < enMAX; i++)
-            smaptab[i].slen = (int)strlen(smaptab[i].item);
-    }
-    for (i = 0; i < enMAX; i++) {
-        if (!(head = strstr(s, smaptab[i].item)))
+    while ((s = smaps_line(s, end, &line))) {
+        if (line.field < 0 || !line.numeric || !smaptab[line.field])
             continue;
-        head += smaptab[i].slen;
-        *mkOBJ(i) = strtoul(head, &tail, 10);
-        // saves some overhead BUT makes us dependent on current order
-        s = tail;
+        *(unsigned long *)((char *)P + smaptab[line.field]) = line.num;
     }
-  #undef enMAX
-  #undef fZERO
   #undef mkENT
-  #undef mkOBJ
 }
 
 static int file2str(int dirfd, const char *what, struct utlbuf_s *ub) {
@@ -781,11 +848,73 @@ static int file2str(int dirfd, const char *what, struct utlbuf_s *ub) {
 }
 
 
+    // An smaps_rollup read is expensive for the larger address spaces,
+    // so a caller may supply a gate deciding which tasks deserve one.
+    // When gated, the time spent is accumulated for that gate's benefit.
+static void smaps_gated (PROCTAB *restrict const PT, int dirfd, struct utlbuf_s *ub, proc_t *restrict const p) {
+    struct timespec beg, end;
+    int len;
+
+    if (!PT->smaps_gate) {
+        if ((len = file2str(dirfd, "smaps_rollup", ub)) != -1)
+            smaps2proc(ub->buf, len, p);
+        return;
+    }
+    if (!PT->smaps_gate(PT, p))
+        return;
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    if ((len = file2str(dirfd, "smaps_rollup", ub)) != -1)
+        smaps2proc(ub->buf, len, p);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    PT->smaps_ns += (end.tv_sec - beg.tv_sec) * 1000000000ULL + end.tv_nsec - beg.tv_nsec;
+}
+
+
+    // Split 'tot' bytes of a malloc'd 'rbuf' (ending with a '\0') into the
+    // strings of a vector, at each '\0' or '\n', with the pointers appended
+    // to that very same buffer (which the vector then owns).
+static char **buf2strvec(char *rbuf, int tot) {
+    char *p, *endbuf, **q, **ret, *strp;
+    int n, c, align;
+
+    rbuf[tot-1] = '\0';            /* belt and suspenders (the while loop did it, too) */
+    endbuf = rbuf + tot;           /* count space for pointers */
+    align = (sizeof(char*)-1) - ((tot + sizeof(char*)-1) & (sizeof(char*)-1));
+    c = sizeof(char*);             /* one extra for NULL term */
+    for (p = rbuf; p < endbuf; p++) {
+        if (!*p || *p == '\n') {
+            if (c >= INT_MAX - (tot + (int)sizeof(char*) + align)) break;
+            c += sizeof(char*);
+        }
+        if (*p == '\n')
+            *p = 0;
+    }
+
+    rbuf = realloc(rbuf, tot + c + align);      /* make room for ptrs AT END */
+    if (!rbuf) return NULL;
+    endbuf = rbuf + tot;                        /* addr just past data buf */
+    q = ret = (char**) (endbuf+align);          /* ==> free(*ret) to dealloc */
+    for (strp = p = rbuf; p < endbuf; p++) {
+        if (!*p) {                              /* NUL char implies that */
+            if (c < 2 * (int)sizeof(char*)) break;
+            c -= sizeof(char*);
+            *q++ = strp;                        /* point ptrs to the strings */
+            strp = p+1;                         /* next string -> next char */
+        }
+    }
+    *q = 0;                                     /* null ptr list terminator */
+    for (n = 0; ret[n]; n++) {
+        escape_str(dst_buffer, ret[n], MAX_BUFSZ);
+        strcpy(ret[n], dst_buffer);
+    }
+    return ret;
+}
+
+
 static char **file2strvec(int dirfd, const char *what) {
     char buf[2048];     /* read buf bytes at a time */
-    char *p, *rbuf = 0, *endbuf, **q, **ret, *strp;
-    int fd, tot = 0, n, c, end_of_file = 0;
-    int align;
+    char *rbuf = 0;
+    int fd, tot = 0, n, end_of_file = 0;
 
     fd = openat(dirfd, what, O_RDONLY, 0);
     if(fd==-1) return NULL;
@@ -827,38 +956,7 @@ static char **file2strvec(int dirfd, const char *what) {
         if (rbuf) free(rbuf);
         return NULL;               /* read error */
     }
-
-    rbuf[tot-1] = '\0';            /* belt and suspenders (the while loop did it, too) */
-    endbuf = rbuf + tot;           /* count space for pointers */
-    align = (sizeof(char*)-1) - ((tot + sizeof(char*)-1) & (sizeof(char*)-1));
-    c = sizeof(char*);             /* one extra for NULL term */
-    for (p = rbuf; p < endbuf; p++) {
-        if (!*p || *p == '\n') {
-            if (c >= INT_MAX - (tot + (int)sizeof(char*) + align)) break;
-            c += sizeof(char*);
-        }
-        if (*p == '\n')
-            *p = 0;
-    }
-
-    rbuf = realloc(rbuf, tot + c + align);      /* make room for ptrs AT END */
-    if (!rbuf) return NULL;
-    endbuf = rbuf + tot;                        /* addr just past data buf */
-    q = ret = (char**) (endbuf+align);          /* ==> free(*ret) to dealloc */
-    for (strp = p = rbuf; p < endbuf; p++) {
-        if (!*p) {                              /* NUL char implies that */
-            if (c < 2 * (int)sizeof(char*)) break;
-            c -= sizeof(char*);
-            *q++ = strp;                        /* point ptrs to the strings */
-            strp = p+1;                         /* next string -> next char */
-        }
-    }
-    *q = 0;                                     /* null ptr list terminator */
-    for (n = 0; ret[n]; n++) {
-        escape_str(dst_buffer, ret[n], MAX_BUFSZ);
-        strcpy(ret[n], dst_buffer);
-    }
-    return ret;
+    return buf2strvec(rbuf, tot);
 }
 
 
@@ -930,15 +1028,22 @@ static int vectorize_dash_rc (char ***vec) {
 }
 
 
-    // This routine reads a 'cgroup' for the designated proc_t and
-    // guarantees the caller a valid proc_t.cgroup pointer.
-static int fill_cgroup_cvt (int dirfd, proc_t *restrict p) {
+    // This routine converts a 'cgroup' for the designated proc_t, just
+    // once for its cgroup_ele, and guarantees the caller a valid
+    // proc_t.cgroup pointer.
+static int fill_cgroup_cvt (struct cgroup_ele *cg, proc_t *restrict p) {
  #define vMAX ( MAX_BUFSZ - (int)(dst - dst_buffer) )
     char *src, *dst, *grp, *eob, *name;
     int tot, x, len;
 
+    if (cg->cgname)
+        goto done;
     *(dst = dst_buffer) = '\0';                  // empty destination
-    tot = read_unvectored(src_buffer, MAX_BUFSZ, dirfd, "cgroup", '\0');
+    // lines become strings, as with read_unvectored(..., '\0')
+    tot = cg->len < MAX_BUFSZ ? cg->len : MAX_BUFSZ - 1;
+    for (x = 0; x < tot; x++)
+        src_buffer[x] = cg->raw[x] == '\n' ? '\0' : cg->raw[x];
+    src_buffer[tot] = '\0';
     for (src = src_buffer, eob = src_buffer + tot; src < eob; src += x) {
         x = 1;                                   // loop assist
         if (!*src) continue;
@@ -954,19 +1059,39 @@ static int fill_cgroup_cvt (int dirfd, proc_t *restrict p) {
         dst += escape_str(dst, grp, vMAX);
     }
     if (dst_buffer[0]) {
-        if (!(p->cgroup = strdup(dst_buffer)))
+        if (!(cg->cgroup = strdup(dst_buffer)))
             return 1;
     } else
-        p->cgroup = str_none;
-    name = strstr(p->cgroup, ":name=");
-    if (name && *(name+6)) name += 6; else name = p->cgroup;
-    if (!(p->cgname = strdup(name)))
+        cg->cgroup = str_none;
+    name = strstr(cg->cgroup, ":name=");
+    if (name && *(name+6)) name += 6; else name = cg->cgroup;
+    if (name == str_none)
+        cg->cgname = str_none;
+    else if (!(cg->cgname = strdup(name)))
         return 1;
+done:
+    p->cgroup = cg->cgroup;
+    p->cgname = cg->cgname;
     return 0;
  #undef vMAX
 }
 
 
+    // This routine provides a task's own copy of the 'cgroup' vectors,
+    // from the contents of its cgroup_ele (so the file isn't read twice).
+static char **cgroup2strvec (struct cgroup_ele *cg) {
+    char *rbuf;
+
+    if (!cg->len)
+        return NULL;
+    if (!(rbuf = malloc(cg->len + 1)))
+        return NULL;
+    memcpy(rbuf, cg->raw, cg->len);
+    rbuf[cg->len] = '\0';
+    return buf2strvec(rbuf, cg->len + 1);
+}
+
+
     // This routine reads a 'cmdline' for the designated proc_t, "escapes"
     // the result into a single string while guaranteeing the caller a
     // valid proc_t.cmdline pointer.
@@ -1151,6 +1276,144 @@ struct docker_ids *docker_containers (struct utlbuf_s *ub) {
 }
 
 
+    // Provide the cgroup_ele for a task's /proc/#/cgroup contents (perhaps
+    // empty), creating one only if those exact contents are not yet known.
+    // As with the container functions, a NULL 'ub' means time for cleanup.
+struct cgroup_ele *cgroup_interned (int dirfd, struct utlbuf_s *ub) {
+    static __thread struct cgroup_ele *hash[CGROUP_HASH];
+    struct cgroup_ele *ele;
+    const char *raw;
+    unsigned h;
+    int i, len;
+
+    if (ub == NULL) {                          // looks like time for cleanup
+        for (i = 0; i < CGROUP_HASH; i++) {
+            while ((ele = hash[i])) {
+                hash[i] = ele->next;
+                if (ele->cgroup   && ele->cgroup   != str_none) free(ele->cgroup);
+                if (ele->cgname   && ele->cgname   != str_none) free(ele->cgname);
+                if (ele->sd_slice && ele->sd_slice != str_none) free(ele->sd_slice);
+                if (ele->sd_unit  && ele->sd_unit  != str_none) free(ele->sd_unit);
+                if (ele->sd_uunit && ele->sd_uunit != str_none) free(ele->sd_uunit);
+                free(ele->raw);
+                free(ele);
+            }
+        }
+        return NULL;
+    }
+    // ok if nothing is read, an empty file will do just fine ...
+    if (0 >= (len = file2str(dirfd, "cgroup", ub)))
+        len = 0;
+    raw = len ? ub->buf : "";
+    h = procps_hash(raw, len);
+
+    for (ele = hash[h & (CGROUP_HASH - 1)]; ele; ele = ele->next)
+        if (ele->hash == h && ele->len == len && !memcmp(ele->raw, raw, len))
+            return ele;                        // a most likely outcome
+
+    if (!(ele = calloc(1, sizeof(struct cgroup_ele))))
+        return NULL;
+    if (!(ele->raw = malloc(len + 1))) {
+        free(ele);
+        return NULL;
+    }
+    memcpy(ele->raw, raw, len + 1);
+    ele->len = len;
+    ele->hash = h;
+    ele->next = hash[h & (CGROUP_HASH - 1)];
+    hash[h & (CGROUP_HASH - 1)] = ele;
+    return ele;
+}
+
+
+    // Provide the cpus_ele for a status 'Cpus_allowed' mask, as 32 bit hex
+    // words (most significant first) separated by commas, creating one only
+    // if that exact text is not yet known. A NULL 'mask' means cleanup.
+const struct pids_cpus *cpus_interned (const char *mask) {
+    static __thread struct cpus_ele *hash[CPUS_HASH];
+    struct cpus_ele *ele;
+    unsigned long *bits;
+    unsigned h;
+    int i, n, len, words, longs;
+
+    if (mask == NULL) {                        // looks like time for cleanup
+        for (i = 0; i < CPUS_HASH; i++) {
+            while ((ele = hash[i])) {
+                hash[i] = ele->next;
+                free(ele);
+            }
+        }
+        return NULL;
+    }
+    len = strcspn(mask, "\n");
+    h = procps_hash(mask, len);
+    for (ele = hash[h & (CPUS_HASH - 1)]; ele; ele = ele->next)
+        if (ele->hash == h && ele->len == len && !memcmp(ele->raw, mask, len))
+            return &ele->cpus;                 // a most likely outcome
+
+    for (i = 0, words = 1; i < len; i++)
+        words += (mask[i] == ',');
+
+    longs = (words * 32 + CPUS_BPW - 1) / CPUS_BPW;
+    if (!(ele = calloc(1, sizeof(struct cpus_ele) + longs * sizeof(long) + len + 1)))
+        return NULL;
+    bits = (unsigned long *)(ele + 1);
+    memcpy((char *)(bits + longs), mask, len);
+    ele->raw = (char *)(bits + longs);
+    ele->len = len;
+    ele->hash = h;
+    ele->cpus.numbits = words * 32;
+    ele->cpus.mask = bits;
+
+    // the final word holds cpus 0 - 31, so we'll work backward from there
+    for (i = len - 1, n = 0; i >= 0; i--) {
+        int x;
+        if (mask[i] == ',') {
+            n = (n + 31) & ~31;                // any short word is zero filled
+            continue;
+        }
+        if (mask[i] >= '0' && mask[i] <= '9') x = mask[i] - '0';
+        else if (mask[i] >= 'a' && mask[i] <= 'f') x = mask[i] - 'a' + 10;
+        else if (mask[i] >= 'A' && mask[i] <= 'F') x = mask[i] - 'A' + 10;
+        else break;
+        bits[n / CPUS_BPW] |= (unsigned long)x << (n % CPUS_BPW);
+        ele->cpus.count += __builtin_popcount(x);
+        n += 4;
+    }
+    ele->next = hash[h & (CPUS_HASH - 1)];
+    hash[h & (CPUS_HASH - 1)] = ele;
+    return &ele->cpus;
+}
+
+
+    // The container functions alter their buffer, so get a copy of 'raw'
+static struct utlbuf_s *cgroup_rawcopy (struct cgroup_ele *cg) {
+    static __thread struct utlbuf_s ub;
+    int len = cg->len < MAX_BUFSZ ? cg->len : MAX_BUFSZ - 1;
+
+    memcpy(src_buffer, cg->raw, len);
+    src_buffer[len] = '\0';
+    ub.buf = src_buffer;
+    ub.siz = MAX_BUFSZ;
+    return &ub;
+}
+
+
+static void cgroup_containers (struct cgroup_ele *cg, unsigned flags, proc_t *restrict p) {
+    if (flags & PROC_FILL_LXC) {               // value the lxc name
+        if (!cg->lxcname)
+            cg->lxcname = lxc_containers(cgroup_rawcopy(cg));
+        p->lxcname = cg->lxcname;
+    }
+    if (flags & PROC_FILL_DOCKER) {            // value the dockerids
+        if (!cg->docker)
+            cg->docker = docker_containers(cgroup_rawcopy(cg));
+        p->dockerid = cg->docker->id;
+        p->dockerid_64 = cg->docker->id_64;
+    }
+}
+
+
     // Provide the user id at login (or -1 if not available)
 static int login_uid (const int dirfd) {
     char buf[P_G_SZ];
@@ -1240,6 +1503,7 @@ static inline void stat_fd (int dirfd, proc_t *p) {
 static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict const p) {
     static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status,cgroup
     static __thread struct stat sb;     // stat() buffer
+    struct cgroup_ele *cg = NULL;
     unsigned flags = PT->flags;
     int rc = 0;
 
@@ -1255,8 +1519,11 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
     /* this attempted read of 'stat' is now unconditional to ensure a 'cmd' name
        as a minimum. this prevents a NULL 'cmdline' pointer for kernel threads
        in case the 'status' file is missing or not otherwise read ... */
-    if (file2str(PT->pidfd, "stat", &ub) == -1)
+    if (file2str(PT->pidfd, "stat", &ub) == -1) {
+        if (flags & PROC_PINNED)                /* that process has now died */
+            pinned_unpin(PT);
         goto next_proc;
+    }
     rc += stat2proc(ub.buf, p);
 
     if (PT->hide_kernel && (p->ppid == 2 || p->tid == 2)) {
@@ -1269,11 +1536,14 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
             io2proc(ub.buf, p);
     }
 
-    if (flags & PROC_FILLSMAPS) {               // read /proc/#/smaps_rollup
-        if (file2str(PT->pidfd, "smaps_rollup", &ub) != -1)
-            smaps2proc(ub.buf, p);
+    if (flags & PROC_FILLSCHED) {               // read /proc/#/schedstat
+        if (file2str(PT->pidfd, "schedstat", &ub) != -1)
+            schedstat2proc(ub.buf, p);
     }
 
+    if (flags & PROC_FILLSMAPS)                 // read /proc/#/smaps_rollup
+        smaps_gated(PT, PT->pidfd, &ub, p);
+
     if (flags & PROC_FILLMEM) {                 // read /proc/#/statm
         if (file2str(PT->pidfd, "statm", &ub) != -1)
             statm2proc(ub.buf, p);
@@ -1281,7 +1551,7 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
 
     if (flags & PROC_FILLSTATUS) {              // read /proc/#/status
         if (file2str(PT->pidfd, "status", &ub) != -1){
-            rc += status2proc(ub.buf, p, 1);
+            rc += status2proc(ub.buf, p, 1, flags);
             if (flags & (PROC_FILL_SUPGRP & ~PROC_FILLSTATUS))
                 rc += supgrps_from_supgids(p);
             if (flags & (PROC_FILL_OUSERS & ~PROC_FILLSTATUS)) {
@@ -1320,11 +1590,14 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
     if (flags & PROC_EDITCMDLCVT)
         rc += fill_cmdline_cvt(PT->pidfd, p);
 
-    if ((flags & PROC_FILLCGROUP))              // read /proc/#/cgroup
-        if (!(p->cgroup_v = file2strvec(PT->pidfd, "cgroup")))
+    if (flags & CGROUP_INTERN)                  // find /proc/#/cgroup's twin
+        if (!(cg = cgroup_interned(PT->pidfd, &ub)))
+            rc += 1;
+    if ((flags & PROC_FILLCGROUP))              // vectorize that cgroup
+        if (!cg || !(p->cgroup_v = cgroup2strvec(cg)))
             rc += vectorize_dash_rc(&p->cgroup_v);
-    if (flags & PROC_EDITCGRPCVT)
-        rc += fill_cgroup_cvt(PT->pidfd, p);
+    if (cg && (flags & PROC_EDITCGRPCVT))
+        rc += fill_cgroup_cvt(cg, p);
 
     if (flags & PROC_FILLOOM) {
         if (file2str(PT->pidfd, "oom_score", &ub) != -1)
@@ -1337,20 +1610,11 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
         procps_ns_read_pid(p->tid, &(p->ns));
 
 
-    if (flags & PROC_FILLSYSTEMD)               // get sd-login.h stuff
-        rc += sd2proc(p);
+    if (cg && (flags & PROC_FILLSYSTEMD))       // get sd-login.h stuff
+        rc += sd2proc(p, cg);
 
-    if (flags & (PROC_FILL_LXC | PROC_FILL_DOCKER)) {
-        // ok if nothing is read, an empty buffer will do just fine ...
-        file2str(PT->pidfd, "cgroup", &ub);
-        if (flags & PROC_FILL_LXC)              // value the lxc name
-            p->lxcname = lxc_containers(&ub);
-        if (flags & PROC_FILL_DOCKER) {         // value the dockerids
-            struct docker_ids *ids = docker_containers(&ub);
-            p->dockerid = ids->id;
-            p->dockerid_64 = ids->id_64;
-        }
-    }
+    if (cg)                                     // value lxc and/or docker
+        cgroup_containers(cg, flags, p);
 
     if (flags & PROC_FILL_LUID)                 // value the login user id
         p->luid = login_uid(PT->pidfd);
@@ -1381,6 +1645,7 @@ next_proc:
 static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict const t) {
     static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status.cgroup
     static __thread struct stat sb;     // stat() buffer
+    struct cgroup_ele *cg = NULL;
     unsigned flags = PT->flags;
     int rc = 0;
 
@@ -1410,11 +1675,14 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
             io2proc(ub.buf, t);
     }
 
-    if (flags & PROC_FILLSMAPS) {               // read /proc/#/task/#/smaps_rollup
-        if (file2str(PT->taskfd, "smaps_rollup", &ub) != -1)
-            smaps2proc(ub.buf, t);
+    if (flags & PROC_FILLSCHED) {               // read /proc/#/task/#/schedstat
+        if (file2str(PT->taskfd, "schedstat", &ub) != -1)
+            schedstat2proc(ub.buf, t);
     }
 
+    if (flags & PROC_FILLSMAPS)                 // read /proc/#/task/#/smaps_rollup
+        smaps_gated(PT, PT->taskfd, &ub, t);
+
     if (flags & PROC_FILLMEM) {                 // read /proc/#/task/#/statm
         if (file2str(PT->taskfd, "statm", &ub) != -1)
             statm2proc(ub.buf, t);
@@ -1422,7 +1690,7 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
 
     if (flags & PROC_FILLSTATUS) {              // read /proc/#/task/#/status
         if (file2str(PT->taskfd, "status", &ub) != -1) {
-            rc += status2proc(ub.buf, t, 0);
+            rc += status2proc(ub.buf, t, 0, flags);
             if (flags & (PROC_FILL_SUPGRP & ~PROC_FILLSTATUS))
                 rc += supgrps_from_supgids(t);
             if (flags & (PROC_FILL_OUSERS & ~PROC_FILLSTATUS)) {
@@ -1457,14 +1725,17 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
     if (flags & PROC_EDITENVRCVT)
         rc += fill_environ_cvt(PT->taskfd, t);
 
-    if ((flags & PROC_FILLCGROUP))              // read /proc/#/task/#/cgroup
-        if (!(t->cgroup_v = file2strvec(PT->taskfd, "cgroup")))
+    if (flags & CGROUP_INTERN)                  // find /proc/#/task/#/cgroup's twin
+        if (!(cg = cgroup_interned(PT->taskfd, &ub)))
+            rc += 1;
+    if ((flags & PROC_FILLCGROUP))              // vectorize that cgroup
+        if (!cg || !(t->cgroup_v = cgroup2strvec(cg)))
             rc += vectorize_dash_rc(&t->cgroup_v);
-    if (flags & PROC_EDITCGRPCVT)
-        rc += fill_cgroup_cvt(PT->taskfd, t);
+    if (cg && (flags & PROC_EDITCGRPCVT))
+        rc += fill_cgroup_cvt(cg, t);
 
-    if (flags & PROC_FILLSYSTEMD)               // get sd-login.h stuff
-        rc += sd2proc(t);
+    if (cg && (flags & PROC_FILLSYSTEMD))       // get sd-login.h stuff
+        rc += sd2proc(t, cg);
 
     if (flags & PROC_FILL_EXE) {
         if (!(t->exe = readlink_exe(PT->taskfd)))
@@ -1480,17 +1751,8 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
     if (flags & PROC_FILLNS)                    // read /proc/#/task/#/ns/*
         procps_ns_read_pid(t->tid, &(t->ns));
 
-    if (flags & (PROC_FILL_LXC | PROC_FILL_DOCKER)) {
-        // ok if nothing is read, an empty buffer will do just fine ...
-        file2str(PT->taskfd, "cgroup", &ub);
-        if (flags & PROC_FILL_LXC)              // value the lxc name
-            t->lxcname = lxc_containers(&ub);
-        if (flags & PROC_FILL_DOCKER) {         // value the dockerids
-            struct docker_ids *ids = docker_containers(&ub);
-            t->dockerid = ids->id;
-            t->dockerid_64 = ids->id_64;
-        }
-    }
+    if (cg)                                     // value lxc and/or docker
+        cgroup_containers(cg, flags, t);
 
     if (flags & PROC_FILL_LUID)
         t->luid = login_uid(PT->taskfd);
@@ -1566,7 +1828,8 @@ static int simple_nexttid(PROCTAB *restrict const PT, const proc_t *restrict con
 
 
 //////////////////////////////////////////////////////////////////////////////////
-// This "finds" processes in a list that was given to openproc().
+// This "finds" processes in a list that was given to openproc().  As with
+// pinned_nextpid, a thread's id is taken to mean its whole thread group.
 // Return non-zero on success. (tgid is a real headache)
 static int listed_nextpid (PROCTAB *PT, proc_t *p) {
   static __thread struct utlbuf_s ub = { NULL, 0 };
@@ -1589,11 +1852,85 @@ static int listed_nextpid (PROCTAB *PT, proc_t *p) {
       if (str)
         p->tgid = atoi(str + 5);   // this tgid is the proper one |
     }
+    if (p->tgid != pid) {
+      int fd;
+      snprintf(path, PROCPATHLEN, "/proc/%d", p->tgid);
+      if ((fd = open(path, O_RDONLY | O_DIRECTORY)) >= 0) {
+        close_dirfd(&(PT->pidfd));
+        PT->pidfd = fd;
+        p->tid = p->tgid;
+      } else
+        p->tgid = pid;
+    }
   }
   return pid;
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////
+// This "finds" processes in a PINTAB list that was given to openproc().  Unlike
+// listed_nextpid, the /proc/<pid> directory and tgid survive from call to call,
+// so neither an open nor a status read is usually needed.  And, since a pinned
+// directory refers to one process only, a reused pid can't be mistaken for it.
+// A 'once' entry (see procevents.c) is opened and closed as with simple_nextpid
+// but, being a known tgid, it too avoids the status read.  When it can't be
+// opened, its tgid is zeroed so the caller will know that process has ended.
+// Pins are for processes only.  Should a pid prove to be some thread's id, its
+// pin is moved to that thread group's directory, so the whole process is found
+// (along with every thread, through readeither) just as for the leader's pid,
+// and just as listed_nextpid does.
+// Return non-zero on success.
+static int pinned_nextpid (PROCTAB *PT, proc_t *p) {
+  static __thread struct utlbuf_s ub = { NULL, 0 };
+  PINTAB *pin = PT->pins;
+  char path[PROCPATHLEN];
+
+  if (PT->pidfd >= 0 && PT->pins[-1].once) {
+    close_dirfd(&PT->pidfd);
+    close_dirfd(&PT->taskfd);
+  }
+  PT->pidfd = -1;                  // a pinned fd is never ours to close |
+  if (!pin->pid)
+    return 0;
+  PT->pins++;
+  p->tid = p->tgid = pin->pid;
+  if (pin->once) {
+    snprintf(path, PROCPATHLEN, "/proc/%d", pin->pid);
+    if ((PT->pidfd = open(path, O_RDONLY | O_DIRECTORY)) < 0)
+      pin->tgid = 0;
+    return pin->pid;
+  }
+  if (pin->pid > 0) {
+    if (pin->dirfd < 0) {
+      snprintf(path, PROCPATHLEN, "/proc/%d", pin->pid);
+      pin->dirfd = open(path, O_RDONLY | O_DIRECTORY);
+      pin->tgid = 0;
+    }
+    // only the first time do we need 'status' for the task's real tgid |
+    if (pin->dirfd >= 0 && !pin->tgid) {
+      pin->tgid = pin->pid;
+      if (file2str(pin->dirfd, "status", &ub) != -1) {
+        char *str = strstr(ub.buf, "Tgid:");
+        if (str)
+          pin->tgid = atoi(str + 5);
+      }
+      if (pin->tgid != pin->pid) {
+        int fd;
+        snprintf(path, PROCPATHLEN, "/proc/%d", pin->tgid);
+        if ((fd = open(path, O_RDONLY | O_DIRECTORY)) >= 0) {
+          close(pin->dirfd);
+          pin->dirfd = fd;
+        } else
+          pin->tgid = pin->pid;
+      }
+    }
+    PT->pidfd = pin->dirfd;
+    p->tid = p->tgid = pin->tgid ? pin->tgid : pin->pid;
+  }
+  return pin->pid;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////
 /* readproc: return a pointer to a proc_t filled with requested info about the
  * next process available matching the restriction set.  If no more such
@@ -1695,7 +2032,7 @@ PROCTAB *openproc(unsigned flags, ...) {
     PT->reader = simple_readproc;
     if (flags & PROC_PID){
         PT->procfs = NULL;
-        PT->finder = listed_nextpid;
+        PT->finder = (flags & PROC_PINNED) ? pinned_nextpid : listed_nextpid;
     }else{
         PT->procfs = opendir("/proc");
         if (!PT->procfs) { free(PT); return NULL; }
@@ -1704,7 +2041,9 @@ PROCTAB *openproc(unsigned flags, ...) {
     PT->flags = flags;
 
     va_start(ap, flags);
-    if (flags & PROC_PID)
+    if (flags & PROC_PINNED)
+        PT->pins = va_arg(ap, PINTAB*);
+    else if (flags & PROC_PID)
         PT->pids = va_arg(ap, pid_t*);
     else if (flags & PROC_UID){
         PT->uids = va_arg(ap, uid_t*);
@@ -1738,7 +2077,9 @@ void closeproc(PROCTAB *PT) {
     if (PT){
         if (PT->procfs) closedir(PT->procfs);
         if (PT->taskdir) closedir(PT->taskdir);
-        close_dirfd(&(PT->pidfd));
+        if (!(PT->flags & PROC_PINNED)
+        || (PT->pidfd >= 0 && PT->pins[-1].once))
+            close_dirfd(&(PT->pidfd));
         close_dirfd(&(PT->taskfd));
         free(PT);
     }
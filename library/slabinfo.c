@@ -41,10 +41,13 @@
 #include "slabinfo.h"
 
 
+#ifndef SLABINFO_FILE                    // (tests may substitute their own)
 #define SLABINFO_FILE        "/proc/slabinfo"
-#define SLABINFO_LINE_LEN    2048
+#endif
 #define SLABINFO_NAME_LEN    128
 
+#define BUFFER_INCR          32768       // amount i/p buffer allocations grow
+#define NODES_INCR           128         // amount slabnode allocations grow
 #define STACKS_INCR          128         // amount reap stack allocations grow
 
 /* ---------------------------------------------------------------------------- +
@@ -93,6 +96,11 @@ struct slabs_node {
     unsigned int  nr_slabs;          // number of slabs in this cache
     unsigned int  nr_active_slabs;   // number of active slabs
     unsigned int  use;               // percent full: total / active
+    signed int    delta_objs;        // these 5 are changes since the prior read
+    signed int    delta_active_objs;
+    signed int    delta_slabs;
+    signed int    delta_active_slabs;
+    signed long   delta_size;
 };
 
 struct slabs_hist {
@@ -113,6 +121,8 @@ struct ext_support {
 #ifdef ENFORCE_LOGICAL
     enum slabinfo_item lowest;       // range of allowable enums
     enum slabinfo_item highest;
+    enum slabinfo_item lowest2;      // plus a second such range
+    enum slabinfo_item highest2;
 #endif
 };
 
@@ -126,10 +136,15 @@ struct fetch_support {
 
 struct slabinfo_info {
     int refcount;
-    FILE *slabinfo_fp;
-    int nodes_alloc;                 // nodes alloc()ed
+    int slabinfo_fd;                 // kept open, then read with pread
+    int slabinfo_nopread;            // that file wasn't seekable
+    char *slabinfo_buf;              // grows to hold the entire file
+    int slabinfo_buf_size;           // current size of the above buffer
+    int nodes_alloc;                 // nodes alloc()ed (in each pool)
     int nodes_used;                  // nodes using alloced memory
+    int nodes_prev;                  // nodes used as of the prior read
     struct slabs_node *nodes;        // first slabnode of this list
+    struct slabs_node *prev;         // the prior read's nodes (the history)
     struct slabs_hist slabs;         // new/old slabs_summ data
     struct ext_support select_ext;   // supports concurrent select/reap
     struct ext_support fetch_ext;    // supports concurrent select/reap
@@ -165,6 +180,11 @@ NOD_set(SLAB_ACTIVE_SLABS,           u_int,  nr_active_slabs)
 NOD_set(SLAB_PAGES_PER_SLAB,         u_int,  pages_per_slab)
 NOD_set(SLAB_PERCENT_USED,           u_int,  use)
 NOD_set(SLAB_SIZE_TOTAL,            ul_int,  cache_size)
+NOD_set(SLAB_DELTA_NUM_OBJS,         s_int,  delta_objs)
+NOD_set(SLAB_DELTA_ACTIVE_OBJS,      s_int,  delta_active_objs)
+NOD_set(SLAB_DELTA_NUMS_SLABS,       s_int,  delta_slabs)
+NOD_set(SLAB_DELTA_ACTIVE_SLABS,     s_int,  delta_active_slabs)
+NOD_set(SLAB_DELTA_SIZE_TOTAL,      sl_int,  delta_size)
 
 REG_set(SLABS_CACHES_TOTAL,          u_int,  nr_caches)
 REG_set(SLABS_CACHES_ACTIVE,         u_int,  nr_active_caches)
@@ -209,6 +229,14 @@ struct sort_parms {
 #define srtDECL(t) static int srtNAME(t) \
     (const struct slabinfo_stack **A, const struct slabinfo_stack **B, struct sort_parms *P)
 
+srtDECL(s_int) {
+    const struct slabinfo_result *a = (*A)->head + P->offset; \
+    const struct slabinfo_result *b = (*B)->head + P->offset; \
+    if ( a->result.s_int > b->result.s_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.s_int < b->result.s_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
 srtDECL(u_int) {
     const struct slabinfo_result *a = (*A)->head + P->offset; \
     const struct slabinfo_result *b = (*B)->head + P->offset; \
@@ -225,6 +253,14 @@ srtDECL(ul_int) {
     return 0;
 }
 
+srtDECL(sl_int) {
+    const struct slabinfo_result *a = (*A)->head + P->offset; \
+    const struct slabinfo_result *b = (*B)->head + P->offset; \
+    if ( a->result.sl_int > b->result.sl_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.sl_int < b->result.sl_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
 srtDECL(str) {
     const struct slabinfo_result *a = (*A)->head + P->offset;
     const struct slabinfo_result *b = (*B)->head + P->offset;
@@ -308,6 +344,12 @@ static struct {
   { RS(SLABS_DELTA_PAGES_TOTAL),    QS(noop),    TS(s_int)  },
   { RS(SLABS_DELTA_SIZE_ACTIVE),    QS(noop),    TS(s_int)  },
   { RS(SLABS_DELTA_SIZE_TOTAL),     QS(noop),    TS(s_int)  },
+
+  { RS(SLAB_DELTA_NUM_OBJS),        QS(s_int),   TS(s_int)  },
+  { RS(SLAB_DELTA_ACTIVE_OBJS),     QS(s_int),   TS(s_int)  },
+  { RS(SLAB_DELTA_NUMS_SLABS),      QS(s_int),   TS(s_int)  },
+  { RS(SLAB_DELTA_ACTIVE_SLABS),    QS(s_int),   TS(s_int)  },
+  { RS(SLAB_DELTA_SIZE_TOTAL),      QS(sl_int),  TS(sl_int) },
 };
 
     /* please note,
@@ -324,6 +366,9 @@ enum slabinfo_item SLABINFO_logical_end = MAXTABLE(Item_table);
 // --- slabnode specific support ----------------------------------------------
 
 /* Alloc up more slabnode memory, if required
+ *
+ * Both pools, the current one and the prior read's, always have the
+ * same size so that they may be swapped with each read.
  */
 static int alloc_slabnodes (
         struct slabinfo_info *info)
@@ -334,24 +379,27 @@ static int alloc_slabnodes (
     if (info->nodes_used < info->nodes_alloc)
         return 1;
     /* Increment the allocated number of slabs */
-    new_count = info->nodes_alloc * 5/4+30;
+    new_count = info->nodes_alloc + NODES_INCR;
 
     new_nodes = realloc(info->nodes, sizeof(struct slabs_node) * new_count);
     if (!new_nodes)
         return 0;
     info->nodes = new_nodes;
+    new_nodes = realloc(info->prev, sizeof(struct slabs_node) * new_count);
+    if (!new_nodes)
+        return 0;
+    info->prev = new_nodes;
     info->nodes_alloc = new_count;
     return 1;
 } // end: alloc_slabnodes
 
 
 /*
- * get_slabnode - allocate slab_info structures using a free list
+ * get_slabnode - allocate slab_info structures from our node pool
  *
- * In the fast path, we simply return a node off the free list.  In the slow
- * list, we malloc() a new node.  The free list is never automatically reaped,
- * both for simplicity and because the number of slab caches is fairly
- * constant.
+ * In the fast path, we simply return the next node in the pool.  In the slow
+ * path, the pool is grown.  The pool is never automatically reaped, both for
+ * simplicity and because the number of slab caches is fairly constant.
  */
 static int get_slabnode (
         struct slabinfo_info *info,
@@ -366,6 +414,54 @@ static int get_slabnode (
 } // end: get_slabnode
 
 
+/*
+ * get_slabprior - find a cache among those from the prior read
+ *
+ * The kernel lists its caches in a stable order, adding new ones at the
+ * front, so each is almost always just after the one last found ('hint').
+ * The search wraps around from there, so a cache listed out of that order
+ * is still found.  Only one created since the prior read is not.
+ */
+static struct slabs_node *get_slabprior (
+        struct slabinfo_info *info,
+        const char *name,
+        int *hint)
+{
+    int i, n;
+
+    for (n = 0; n < info->nodes_prev; n++) {
+        i = *hint + n;
+        if (i >= info->nodes_prev)
+            i -= info->nodes_prev;
+        if (!strcmp(name, info->prev[i].name)) {
+            *hint = i + 1;
+            return &info->prev[i];
+        }
+    }
+    return NULL;
+} // end: get_slabprior
+
+
+static inline int slabinfo_num (
+        char **pp,
+        unsigned int *num)
+{
+    char *p = *pp;
+    unsigned int n = 0;
+
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    if (*p < '0' || *p > '9')
+        return 0;
+    do
+        n = n * 10 + (*p++ - '0');
+    while (*p >= '0' && *p <= '9');
+    *num = n;
+    *pp = p;
+    return 1;
+} // end: slabinfo_num
+
+
 /* parse_slabinfo20:
  *
  * Actual parse routine for slabinfo 2.x (2.6 kernels)
@@ -399,34 +495,61 @@ static int get_slabnode (
  *  : cpustat <allochit> <allocmiss> <freehit> <freemiss>
  */
 static int parse_slabinfo20 (
-        struct slabinfo_info *info)
+        struct slabinfo_info *info,
+        char *bp)
 {
-    struct slabs_node *node;
-    char buffer[SLABINFO_LINE_LEN];
+    struct slabs_node *node, *prior;
     int page_size = getpagesize();
     struct slabs_summ *slabs = &(info->slabs.new);
+    int i, hint = 0;
+    char *name;
 
     slabs->min_obj_size = INT_MAX;
     slabs->max_obj_size = 0;
 
-    while (fgets(buffer, SLABINFO_LINE_LEN, info->slabinfo_fp )) {
-        if (buffer[0] == '#')
+    for ( ; *bp; bp += (*bp == '\n')) {
+        if (*bp == '#') {
+            while (*bp && *bp != '\n')
+                ++bp;
             continue;
+        }
 
         if (!get_slabnode(info, &node))
             return 1;        // here, errno was set to ENOMEM
 
-        if (sscanf(buffer,
-                   "%" STRINGIFY(SLABINFO_NAME_LEN) "s" \
-                   "%u %u %u %u %u : tunables %*u %*u %*u : slabdata %u %u %*u",
-                   node->name,
-                   &node->nr_active_objs, &node->nr_objs,
-                   &node->obj_size, &node->objs_per_slab,
-                   &node->pages_per_slab, &node->nr_active_slabs,
-                   &node->nr_slabs) < 8) {
-            errno = ERANGE;
-            return 1;
+        name = bp;
+        while (*bp && *bp != ' ' && *bp != '\t' && *bp != '\n')
+            ++bp;
+        if ((i = bp - name) > SLABINFO_NAME_LEN)
+            i = SLABINFO_NAME_LEN;
+        memcpy(node->name, name, i);
+        node->name[i] = '\0';
+
+        if (!slabinfo_num(&bp, &node->nr_active_objs)
+        || !slabinfo_num(&bp, &node->nr_objs)
+        || !slabinfo_num(&bp, &node->obj_size)
+        || !slabinfo_num(&bp, &node->objs_per_slab)
+        || !slabinfo_num(&bp, &node->pages_per_slab))
+            goto bad_line;
+        // skip the tunables section, which is followed by the slabdata
+        for (i = 0; i < 2; i++) {
+            while (*bp && *bp != ':' && *bp != '\n')
+                ++bp;
+            if (*bp != ':')
+                goto bad_line;
+            ++bp;
         }
+        while (*bp == ' ' || *bp == '\t')
+            ++bp;
+        if (strncmp(bp, "slabdata", 8))
+            goto bad_line;
+        bp += 8;
+        if (!slabinfo_num(&bp, &node->nr_active_slabs)
+        || !slabinfo_num(&bp, &node->nr_slabs))
+            goto bad_line;
+        // sharedavail, plus any statistics, are of no interest
+        while (*bp && *bp != '\n')
+            ++bp;
 
         if (!node->name[0])
             snprintf(node->name, sizeof(node->name), "%s", "unknown");
@@ -448,6 +571,19 @@ static int parse_slabinfo20 (
         } else
             node->use = 0;
 
+        // a cache new since the prior read shows no change (not its entire size)
+        if ((prior = get_slabprior(info, node->name, &hint))) {
+            node->delta_objs = (signed int)node->nr_objs - prior->nr_objs;
+            node->delta_active_objs = (signed int)node->nr_active_objs - prior->nr_active_objs;
+            node->delta_slabs = (signed int)node->nr_slabs - prior->nr_slabs;
+            node->delta_active_slabs = (signed int)node->nr_active_slabs - prior->nr_active_slabs;
+            node->delta_size = (signed long)node->cache_size - prior->cache_size;
+        } else {
+            node->delta_objs = node->delta_active_objs = 0;
+            node->delta_slabs = node->delta_active_slabs = 0;
+            node->delta_size = 0;
+        }
+
         slabs->nr_objs += node->nr_objs;
         slabs->nr_active_objs += node->nr_active_objs;
         slabs->total_size += (unsigned long)node->nr_objs * node->obj_size;
@@ -462,9 +598,70 @@ static int parse_slabinfo20 (
         slabs->avg_obj_size = slabs->total_size / slabs->nr_objs;
 
     return 0;
+bad_line:
+    errno = ERANGE;
+    return 1;
 } // end: parse_slabinfo20
 
 
+        /*
+         * Bring the entire /proc/slabinfo file into our buffer, which
+         * grows as needed, so it's then parsed without stdio involvement.
+         * Returns the number of bytes read, or -1 with errno set. */
+static int slabinfo_slurp (
+        struct slabinfo_info *info)
+{
+ #define maxSIZ    info->slabinfo_buf_size
+ #define curSIZ  ( maxSIZ - tot_read - 1 )
+ #define curPOS  ( info->slabinfo_buf + tot_read )
+    int num, tot_read = 0;
+
+    if (info->slabinfo_nopread && info->slabinfo_fd != -1) {
+        close(info->slabinfo_fd);
+        info->slabinfo_fd = -1;
+    }
+    if (-1 == info->slabinfo_fd
+    && (-1 == (info->slabinfo_fd = open(SLABINFO_FILE, O_RDONLY))))
+        return -1;
+    if (!info->slabinfo_buf) {
+        if (!(info->slabinfo_buf = malloc(BUFFER_INCR)))
+            return -1;
+        maxSIZ = BUFFER_INCR;
+    }
+    for (;;) {
+        if (info->slabinfo_nopread)
+            num = read(info->slabinfo_fd, curPOS, curSIZ);
+        else
+            num = pread(info->slabinfo_fd, curPOS, curSIZ, tot_read);
+        if (num < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            /* a concession to libvirt lxc support, which has been
+               known to treat a /proc file as non-seekable ... */
+            if (errno == ESPIPE && !info->slabinfo_nopread && !tot_read) {
+                info->slabinfo_nopread = 1;
+                continue;
+            }
+            return -1;
+        }
+        tot_read += num;
+        // seq_file hands out a page or so per read, only an eof is the end
+        if (num == 0)
+            break;
+        if (curSIZ > 0)
+            continue;
+        maxSIZ += BUFFER_INCR;
+        if (!(info->slabinfo_buf = realloc(info->slabinfo_buf, maxSIZ)))
+            return -1;
+    }
+    info->slabinfo_buf[tot_read] = '\0';
+    return tot_read;
+ #undef maxSIZ
+ #undef curSIZ
+ #undef curPOS
+} // end: slabinfo_slurp
+
+
 /* slabinfo_read_failed():
  *
  * Read the data out of /proc/slabinfo putting the information
@@ -475,43 +672,33 @@ static int parse_slabinfo20 (
 static int slabinfo_read_failed (
         struct slabinfo_info *info)
 {
-    char line[SLABINFO_LINE_LEN];
-    int major, minor;
+    struct slabs_node *swap;
+    char *bp;
 
     memcpy(&info->slabs.old, &info->slabs.new, sizeof(struct slabs_summ));
     memset(&(info->slabs.new), 0, sizeof(struct slabs_summ));
-    if (!alloc_slabnodes(info))
-        return 1;            // here, errno was set to ENOMEM
-
-    memset(info->nodes, 0, sizeof(struct slabs_node)*info->nodes_alloc);
-    info->nodes_used = 0;
-
-    if (!info->slabinfo_fp
-    && (!(info->slabinfo_fp = fopen(SLABINFO_FILE, "r"))))
-        return 1;
-    else {
-        if (-1 == fseek(info->slabinfo_fp, 0L, SEEK_SET)) {
-            /* a concession to libvirt lxc support, which has been
-               known to treat a /proc file as non-seekable ... */
-            if (ESPIPE != errno)
-                return 1;
-            fclose(info->slabinfo_fp);
-            if (!(info->slabinfo_fp = fopen(SLABINFO_FILE, "r")))
-                return 1;
-        }
-    }
 
-    /* Parse the version string */
-    if (!fgets(line, SLABINFO_LINE_LEN, info->slabinfo_fp))
+    if (slabinfo_slurp(info) < 0)
         return 1;
 
-    if (2 != sscanf(line, "slabinfo - version: %d.%d", &major, &minor)
-    || (major != 2)) {
+    /* Check the version string */
+    bp = info->slabinfo_buf;
+    if (strncmp(bp, "slabinfo - version: 2.", 22)) {
         errno = ERANGE;
         return 1;
     }
+    while (*bp && *bp != '\n')
+        ++bp;
+    bp += (*bp == '\n');
+
+    // this read's nodes now become our history, reusing the older pool
+    swap = info->prev;
+    info->prev = info->nodes;
+    info->nodes = swap;
+    info->nodes_prev = info->nodes_used;
+    info->nodes_used = 0;
 
-    return parse_slabinfo20(info);
+    return parse_slabinfo20(info, bp);
 } // end: slabinfo_read_failed
 
 
@@ -587,8 +774,8 @@ static inline int slabinfo_items_check_failed (
         if (items[i] == SLABINFO_noop
         || (items[i] == SLABINFO_extra))
             continue;
-        if (items[i] < this->lowest
-        || (items[i] > this->highest))
+        if ((items[i] < this->lowest || items[i] > this->highest)
+        && (items[i] < this->lowest2 || items[i] > this->highest2))
             return 1;
 #else
         // a slabinfo_item is currently unsigned, but we'll protect our future
@@ -774,13 +961,16 @@ PROCPS_EXPORT int procps_slabinfo_new (
         return -ENOMEM;
 
 #ifdef ENFORCE_LOGICAL
-    p->select_ext.lowest  = SLABS_CACHES_TOTAL;
-    p->select_ext.highest = SLABS_DELTA_SIZE_TOTAL;
+    p->select_ext.lowest  = p->select_ext.lowest2  = SLABS_CACHES_TOTAL;
+    p->select_ext.highest = p->select_ext.highest2 = SLABS_DELTA_SIZE_TOTAL;
     p->fetch_ext.lowest   = SLAB_NAME;
     p->fetch_ext.highest  = SLAB_SIZE_TOTAL;
+    p->fetch_ext.lowest2  = SLAB_DELTA_NUM_OBJS;
+    p->fetch_ext.highest2 = SLAB_DELTA_SIZE_TOTAL;
 #endif
 
     p->refcount = 1;
+    p->slabinfo_fd = -1;
 
     /* do a priming read here for the following potential benefits: |
          1) see if that caller's permissions were sufficient (root) |
@@ -818,8 +1008,9 @@ PROCPS_EXPORT int procps_slabinfo_unref (
     if ((*info)->refcount < 1) {
         int errno_sav = errno;
 
-        if ((*info)->slabinfo_fp)
-            fclose((*info)->slabinfo_fp);
+        if ((*info)->slabinfo_fd != -1)
+            close((*info)->slabinfo_fd);
+        free((*info)->slabinfo_buf);
 
         if ((*info)->select_ext.extents)
             slabinfo_extents_free_all((&(*info)->select_ext));
@@ -837,6 +1028,7 @@ PROCPS_EXPORT int procps_slabinfo_unref (
             free((*info)->fetch_ext.items);
 
         free((*info)->nodes);
+        free((*info)->prev);
 
         free(*info);
         *info = NULL;
@@ -40,6 +40,15 @@
  *   As a result of this, we can move them around much |
  *   more efficiently than thousands of memcpy() calls |
  *   who then moves a whopping 8 bytes with each call. |
+ *
+ * Plus:
+ *   This is a 'natural' mergesort. Rather than start  |
+ *   with runs of one, it first finds those runs which |
+ *   already exist (reversing any strictly descending) |
+ *   and then merges them. So input that's nearly in   |
+ *   order, as with a prior sort reused as a hint, is  |
+ *   sorted in close to linear time (n comparisons if  |
+ *   already sorted, against n log n for random data). |
  */
 
 int mergesort_r (
@@ -49,54 +58,79 @@ int mergesort_r (
         void *arg)
 {
     void *aux;
-    char **src, **next_src, **dst;
-    size_t top_start, bottom_start, bottom_end, half_depth, t, b;
+    char **src, **dst, **swap, *hold;
+    size_t *runs, nruns, r, n, top_start, bottom_start, bottom_end, t, b, d;
 
     if (nmemb < 2) return 1;
 
-    // allocate one auxiliary buffer for the entire sort
-    if (!(aux = malloc(nmemb * sizeof(void *))))
+    // allocate one auxiliary buffer for the entire sort, plus run bounds
+    if (!(aux = malloc(nmemb * sizeof(void *) + (nmemb + 1) * sizeof(size_t))))
         return 0;
+    runs = (size_t *)((char **)aux + nmemb);
 
     src = base;
-    dst = next_src = aux;
+    dst = aux;
+
+    // find the natural runs (reversing strictly descending ones, for stability)
+    for (nruns = 0, t = 0; t < nmemb; t = b) {
+        runs[nruns++] = t;
+        b = t + 1;
+        if (b < nmemb && compar(src + t, src + b, arg) > 0) {
+            while (b + 1 < nmemb && compar(src + b, src + b + 1, arg) > 0)
+                b++;
+            for (top_start = t, bottom_end = b; top_start < bottom_end; top_start++, bottom_end--) {
+                hold = src[top_start];
+                src[top_start] = src[bottom_end];
+                src[bottom_end] = hold;
+            }
+        }
+        // (the first pair was already compared, above)
+        if (b < nmemb) b++;
+        while (b < nmemb && compar(src + b - 1, src + b, arg) <= 0)
+            b++;
+    }
+    runs[nruns] = nmemb;
 
-    // bottom-up merge sort
-    for (half_depth = 1; half_depth < nmemb; half_depth *= 2) {
+    // bottom-up merge of adjacent runs, until only one remains
+    while (nruns > 1) {
 
-        for (top_start = 0; top_start < nmemb; top_start += 2 * half_depth) {
-            bottom_start = (top_start + half_depth < nmemb) ? top_start + half_depth : nmemb;
-            bottom_end = (top_start + (2 * half_depth) < nmemb) ? top_start + (2 * half_depth) : nmemb;
+        for (r = 0, n = 0; r < nruns; r += 2, n++) {
+            top_start = runs[r];
+            bottom_start = runs[r + 1];
+            bottom_end = (r + 2 <= nruns) ? runs[r + 2] : nmemb;
+            runs[n] = d = top_start;
 
             t = top_start;
             b = bottom_start;
 
-            // merge two sorted halves into buffer
-            while (t < bottom_start && b < bottom_end) {
-                if (compar(src + t, src + b, arg) <= 0)
-                    *dst = *(src + t++);
-                else
-                    *dst = *(src + b++);
-                dst++;
+            // merge two sorted runs into buffer (unless already in order)
+            if (b < bottom_end && compar(src + b - 1, src + b, arg) > 0) {
+                while (t < bottom_start && b < bottom_end) {
+                    if (compar(src + t, src + b, arg) <= 0)
+                        dst[d++] = src[t++];
+                    else
+                        dst[d++] = src[b++];
+                }
             }
 
             // copy remaining top stuff
             while (t < bottom_start)
-                *(dst++) = *(src + t++);
+                dst[d++] = src[t++];
 
             // copy remaining bottom stuff
             while (b < bottom_end)
-                *(dst++) = *(src + b++);
+                dst[d++] = src[b++];
         }
+        nruns = n;
+        runs[nruns] = nmemb;
 
         // swap roles of src and dst
-        dst = src;
-        src = next_src;
-        next_src = dst;
+        swap = src;
+        src = dst;
+        dst = swap;
     }
 
     // if sorted data is in aux, copy back to base
-    // (and remember, pointers have been switched)
     if (src != (char **)base)
         memcpy(base, src, nmemb * sizeof(void *));
 
@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "misc.h"
 #include "numa.h"
 #include "sort.h"
 
@@ -37,7 +38,9 @@
 #include "stat.h"
 
 
+#ifndef STAT_FILE
 #define STAT_FILE "/proc/stat"
+#endif
 #define CORE_FILE "/proc/cpuinfo"
 
 #define CORE_BUFSIZ   1024             // buf size for line of /proc/cpuinfo
@@ -104,11 +107,13 @@ struct stat_data {
     unsigned long procs_created;
     unsigned long procs_blocked;
     unsigned long procs_running;
+    unsigned long long stamp_ns;       // CLOCK_MONOTONIC when these were read
 };
 
 struct hist_sys {
     struct stat_data new;
     struct stat_data old;
+    double tics;                       // possible jiffies per cpu, last interval
 };
 
 struct hist_tic {
@@ -157,7 +162,8 @@ struct reap_support {
 
 struct stat_info {
     int refcount;
-    FILE *stat_fp;
+    int stat_fd;                       // kept open, then read with pread
+    int stat_nopread;                  // set if /proc/stat can't be pread
     char *stat_buf;                    // grows to accommodate all /proc/stat
     int stat_buf_size;                 // current size for the above stat_buf
     int cpu_count_hwm;                 // if changed, triggers new cores scan
@@ -173,6 +179,7 @@ struct stat_info {
     struct item_support select_items;  // items unique to select
     time_t sav_secs;                   // used by procps_stat_get to limit i/o
     struct stat_core *cores;           // linked list, also linked from hist_tic
+    long hertz;                        // for the TIC_*_PCT calculations
 };
 
 // ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -193,6 +200,13 @@ struct stat_info {
     (void)S; R->result. t = ( T->new. x - T->old. x ); }
 #define SYSsetH(e,t,x) setDECL(e) { \
     (void)T; R->result. t = ( S->new. x - S->old. x ); }
+// rate and percentage assignment
+#define SYSsetR(e,x) setDECL(e) { \
+    unsigned long long ns = S->new.stamp_ns - S->old.stamp_ns; (void)T; \
+    R->result.real = ns ? ( S->new. x - S->old. x ) * 1.0e9 / ns : 0.0; }
+#define TICsetP(e,x) setDECL(e) { \
+    double tics = S->tics * T->count; \
+    R->result.real = tics > 0 ? ( T->new. x - T->old. x ) * 100.0 / tics : 0.0; }
 
 setDECL(noop)  { (void)R; (void)S; (void)T; }
 setDECL(extra) { (void)S; (void)T; R->result.ull_int = 0; }
@@ -250,11 +264,33 @@ SYSsetH(SYS_DELTA_PROC_BLOCKED,   s_int,    procs_blocked)
 SYSsetH(SYS_DELTA_PROC_CREATED,   s_int,    procs_created)
 SYSsetH(SYS_DELTA_PROC_RUNNING,   s_int,    procs_running)
 
+setDECL(SYS_DELTA_ELAPSED)      { (void)T; R->result.real = ( S->new.stamp_ns - S->old.stamp_ns ) / 1.0e9; }
+SYSsetR(SYS_DELTA_CTX_SWITCHES_PER_SEC,   ctxt)
+SYSsetR(SYS_DELTA_INTERRUPTS_PER_SEC,     intr)
+SYSsetR(SYS_DELTA_PROC_CREATED_PER_SEC,   procs_created)
+
+TICsetP(TIC_DELTA_USER_PCT,               user)
+TICsetP(TIC_DELTA_NICE_PCT,               nice)
+TICsetP(TIC_DELTA_SYSTEM_PCT,             system)
+TICsetP(TIC_DELTA_IDLE_PCT,               idle)
+TICsetP(TIC_DELTA_IOWAIT_PCT,             iowait)
+TICsetP(TIC_DELTA_IRQ_PCT,                irq)
+TICsetP(TIC_DELTA_SOFTIRQ_PCT,            sirq)
+TICsetP(TIC_DELTA_STOLEN_PCT,             stolen)
+TICsetP(TIC_DELTA_GUEST_PCT,              guest)
+TICsetP(TIC_DELTA_GUEST_NICE_PCT,         gnice)
+TICsetP(TIC_SUM_DELTA_USER_PCT,           xusr)
+TICsetP(TIC_SUM_DELTA_SYSTEM_PCT,         xsys)
+TICsetP(TIC_SUM_DELTA_IDLE_PCT,           xidl)
+TICsetP(TIC_SUM_DELTA_BUSY_PCT,           xbsy)
+
 #undef setDECL
 #undef TIC_set
 #undef SYS_set
 #undef TICsetH
 #undef SYSsetH
+#undef SYSsetR
+#undef TICsetP
 
 
 // ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -296,6 +332,14 @@ srtDECL(ull_int) {
     return 0;
 }
 
+srtDECL(real) {
+    const struct stat_result *a = (*A)->head + P->offset; \
+    const struct stat_result *b = (*B)->head + P->offset; \
+    if ( a->result.real > b->result.real ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.real < b->result.real ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
 srtDECL(noop) { \
     (void)A; (void)B; (void)P; \
     return 0;
@@ -388,13 +432,35 @@ static struct {
   { RS(SYS_DELTA_PROC_BLOCKED),  QS(s_int),    TS(s_int)   },
   { RS(SYS_DELTA_PROC_CREATED),  QS(s_int),    TS(s_int)   },
   { RS(SYS_DELTA_PROC_RUNNING),  QS(s_int),    TS(s_int)   },
+
+  { RS(SYS_DELTA_ELAPSED),               QS(real),  TS(real)  },
+  { RS(SYS_DELTA_CTX_SWITCHES_PER_SEC),  QS(real),  TS(real)  },
+  { RS(SYS_DELTA_INTERRUPTS_PER_SEC),    QS(real),  TS(real)  },
+  { RS(SYS_DELTA_PROC_CREATED_PER_SEC),  QS(real),  TS(real)  },
+
+  { RS(TIC_DELTA_USER_PCT),              QS(real),  TS(real)  },
+  { RS(TIC_DELTA_NICE_PCT),              QS(real),  TS(real)  },
+  { RS(TIC_DELTA_SYSTEM_PCT),            QS(real),  TS(real)  },
+  { RS(TIC_DELTA_IDLE_PCT),              QS(real),  TS(real)  },
+  { RS(TIC_DELTA_IOWAIT_PCT),            QS(real),  TS(real)  },
+  { RS(TIC_DELTA_IRQ_PCT),               QS(real),  TS(real)  },
+  { RS(TIC_DELTA_SOFTIRQ_PCT),           QS(real),  TS(real)  },
+  { RS(TIC_DELTA_STOLEN_PCT),            QS(real),  TS(real)  },
+  { RS(TIC_DELTA_GUEST_PCT),             QS(real),  TS(real)  },
+  { RS(TIC_DELTA_GUEST_NICE_PCT),        QS(real),  TS(real)  },
+  { RS(TIC_SUM_DELTA_USER_PCT),          QS(real),  TS(real)  },
+  { RS(TIC_SUM_DELTA_SYSTEM_PCT),        QS(real),  TS(real)  },
+  { RS(TIC_SUM_DELTA_IDLE_PCT),          QS(real),  TS(real)  },
+  { RS(TIC_SUM_DELTA_BUSY_PCT),          QS(real),  TS(real)  },
 };
 
     /* please note,
      * 1st enum MUST be kept in sync with highest TIC type
-     * 2nd enum MUST be 1 greater than the highest value of any enum */
+     * 2nd enum MUST be the lowest of the later TIC (_PCT) types
+     * 3rd enum MUST be 1 greater than the highest value of any enum */
 #ifdef ENFORCE_LOGICAL
 enum stat_item STAT_TIC_highest = STAT_TIC_DELTA_GUEST_NICE;
+enum stat_item STAT_TIC_pct_lowest = STAT_TIC_DELTA_USER_PCT;
 #endif
 enum stat_item STAT_logical_end = MAXTABLE(Item_table);
 
@@ -750,13 +816,123 @@ static int stat_make_numa_hist (
 } // end: stat_make_numa_hist
 
 
+        /*
+         * Bring the entire /proc/stat file into our buffer, which grows
+         * as needed.  We slurp it all in at once thus avoiding repeated
+         * calls to read, especially for a massively parallel environment.
+         * Additionally, each cpu line is then frozen in time rather than
+         * changing until we get around to accessing it.  This helps to
+         * minimize (not eliminate) some distortions.
+         * Returns the number of bytes read, or -1 with errno set. */
+static int stat_slurp (
+        struct stat_info *info)
+{
+ #define maxSIZ    info->stat_buf_size
+ #define curSIZ  ( maxSIZ - tot_read - 1 )
+ #define curPOS  ( info->stat_buf + tot_read )
+    int num, tot_read = 0;
+
+    if (info->stat_nopread && info->stat_fd != -1) {
+        close(info->stat_fd);
+        info->stat_fd = -1;
+    }
+    if (-1 == info->stat_fd
+    && (-1 == (info->stat_fd = open(STAT_FILE, O_RDONLY))))
+        return -1;
+    for (;;) {
+        if (info->stat_nopread)
+            num = read(info->stat_fd, curPOS, curSIZ);
+        else
+            num = pread(info->stat_fd, curPOS, curSIZ, tot_read);
+        if (num < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            /* a concession to libvirt lxc support, which has been
+               known to treat a /proc file as non-seekable ... */
+            if (errno == ESPIPE && !info->stat_nopread && !tot_read) {
+                info->stat_nopread = 1;
+                continue;
+            }
+            return -1;
+        }
+        tot_read += num;
+        // a short read (with seq_file) means we've got it all
+        if (num == 0 || curSIZ > 0)
+            break;
+        maxSIZ += BUFFER_INCR;
+        if (!(info->stat_buf = realloc(info->stat_buf, maxSIZ)))
+            return -1;
+    }
+    info->stat_buf[tot_read] = '\0';
+    return tot_read;
+ #undef maxSIZ
+ #undef curSIZ
+ #undef curPOS
+} // end: stat_slurp
+
+
+static inline unsigned long long stat_num (
+        const char *p)
+{
+    unsigned long long n = 0;
+
+    while (*p == ' ')
+        ++p;
+    while (*p >= '0' && *p <= '9')
+        n = n * 10 + (*p++ - '0');
+    return n;
+} // end: stat_num
+
+
+        /*
+         * Parse a "cpu" (when id is NULL) or "cpuN" line, returning the
+         * number of values converted, as with sscanf.  Those jiffies not
+         * present are left untouched.  Only when a line was recognized
+         * is 'bp' then advanced to the start of the next line. */
+static int stat_cpu_line (
+        char **bp,
+        int *id,
+        struct stat_jifs *jifs)
+{
+    unsigned long long *vals = &jifs->user;
+    char *p = *bp;
+    int n = 0;
+
+    if (p[0] != 'c' || p[1] != 'p' || p[2] != 'u')
+        return 0;
+    p += 3;
+    if (id) {
+        if (*p < '0' || *p > '9')
+            return 0;
+        for (*id = 0; *p >= '0' && *p <= '9'; p++)
+            *id = *id * 10 + (*p - '0');
+        n = 1;
+    } else if (*p != ' ')
+        return 0;
+    for (; vals <= &jifs->gnice; vals++, n++) {
+        while (*p == ' ')
+            ++p;
+        if (*p < '0' || *p > '9')
+            break;
+        for (*vals = 0; *p >= '0' && *p <= '9'; p++)
+            *vals = *vals * 10 + (*p - '0');
+    }
+    if ((p = strchr(p, '\n')))
+        *bp = p + 1;
+    else
+        *bp = p = strchr(*bp, '\0');
+    return n;
+} // end: stat_cpu_line
+
+
 static int stat_read_failed (
         struct stat_info *info)
 {
     struct hist_tic *sum_ptr, *cpu_ptr;
-    char *bp, *b;
-    int i, rc, num, tot_read;
-    unsigned long long llnum;
+    char *bp, *end;
+    int i, rc, tot_read;
+    unsigned long long stamp_ns;
+    struct timespec ts;
     int refresh_cores = 0;
 
     if (!info->cpus.hist.n_alloc) {
@@ -767,40 +943,12 @@ static int stat_read_failed (
         info->cpus.hist.n_inuse = 0;
     }
 
-    if (!info->stat_fp
-    && (!(info->stat_fp = fopen(STAT_FILE, "r"))))
+    if ((tot_read = stat_slurp(info)) < 0)
         return 1;
-    else {
-        fflush(info->stat_fp);
-        rewind(info->stat_fp);
-    }
-
- #define maxSIZ    info->stat_buf_size
- #define curSIZ  ( maxSIZ - tot_read )
- #define curPOS  ( info->stat_buf + tot_read )
-    /* we slurp in the entire directory thus avoiding repeated calls to fread, |
-       especially for a massively parallel environment. additionally, each cpu |
-       line is then frozen in time rather than changing until we get around to |
-       accessing it.  this helps to minimize (not eliminate) some distortions. | */
-    tot_read = 0;
-    while ((0 < (num = fread(curPOS, 1, curSIZ, info->stat_fp)))) {
-        tot_read += num;
-        if (tot_read < maxSIZ)
-            break;
-        maxSIZ += BUFFER_INCR;
-        if (!(info->stat_buf = realloc(info->stat_buf, maxSIZ)))
-            return 1;
-    };
- #undef maxSIZ
- #undef curSIZ
- #undef curPOS
-
-    if (!feof(info->stat_fp)) {
-        errno = EIO;
-        return 1;
-    }
-    info->stat_buf[tot_read] = '\0';
     bp = info->stat_buf;
+    end = bp + tot_read;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    stamp_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
 
     sum_ptr = &info->cpu_hist;
     // remember summary from last time around
@@ -811,14 +959,10 @@ static int stat_read_failed (
 
     // now value the cpu summary tics from line #1
 #ifdef __CYGWIN__
-    if (4 > sscanf(bp, "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+    if (4 > stat_cpu_line(&bp, NULL, &sum_ptr->new)) {
 #else
-    if (8 > sscanf(bp, "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+    if (8 > stat_cpu_line(&bp, NULL, &sum_ptr->new)) {
 #endif
-        , &sum_ptr->new.user,  &sum_ptr->new.nice,   &sum_ptr->new.system
-        , &sum_ptr->new.idle,  &sum_ptr->new.iowait, &sum_ptr->new.irq
-        , &sum_ptr->new.sirq,  &sum_ptr->new.stolen
-        , &sum_ptr->new.guest, &sum_ptr->new.gnice)) {
             errno = ERANGE;
             return 1;
     }
@@ -836,7 +980,6 @@ reap_em_again:
     cpu_ptr = info->cpus.hist.tics + i;   // adapt to relocated if reap_em_again
 
     do {
-        bp = 1 + strchr(bp, '\n');
         // remember this cpu from last time around
         memcpy(&cpu_ptr->old, &cpu_ptr->new, sizeof(struct stat_jifs));
         // next can be overridden under 'stat_make_numa_hist'
@@ -844,15 +987,10 @@ reap_em_again:
         cpu_ptr->count = 1;
 
 #ifdef __CYGWIN__
-        if (4 > (rc = sscanf(bp, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+        if (4 > (rc = stat_cpu_line(&bp, &cpu_ptr->id, &cpu_ptr->new))) {
 #else
-        if (8 > (rc = sscanf(bp, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+        if (8 > (rc = stat_cpu_line(&bp, &cpu_ptr->id, &cpu_ptr->new))) {
 #endif
-            , &cpu_ptr->id
-            , &cpu_ptr->new.user,  &cpu_ptr->new.nice,   &cpu_ptr->new.system
-            , &cpu_ptr->new.idle,  &cpu_ptr->new.iowait, &cpu_ptr->new.irq
-            , &cpu_ptr->new.sirq,  &cpu_ptr->new.stolen
-            , &cpu_ptr->new.guest, &cpu_ptr->new.gnice))) {
                 break;                   // we must tolerate cpus taken offline
         }
         stat_derive_unique(cpu_ptr);
@@ -882,44 +1020,59 @@ reap_em_again:
        ensure that no new cores have now become visible
        or become invisible when a cpu is taken offline. */
     if (info->cpu_count_hwm != info->cpus.total) {
+        // ( the numa map was built by numa_init, prior to our first read )
+        if (info->cpu_count_hwm)
+            numa_refresh();
         info->cpu_count_hwm = info->cpus.total;
         refresh_cores = 1;
     }
 
     // remember sys_hist stuff from last time around
     memcpy(&info->sys_hist.old, &info->sys_hist.new, sizeof(struct stat_data));
-
-    llnum = 0;
-    if ((b = strstr(bp, "intr ")))
-        sscanf(b,  "intr %llu", &llnum);
-    info->sys_hist.new.intr = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "ctxt ")))
-        sscanf(b,  "ctxt %llu", &llnum);
-    info->sys_hist.new.ctxt = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "btime ")))
-        sscanf(b,  "btime %llu", &llnum);
-    info->sys_hist.new.btime = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "processes ")))
-        sscanf(b,  "processes %llu", &llnum);
-    info->sys_hist.new.procs_created = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "procs_blocked ")))
-        sscanf(b,  "procs_blocked %llu", &llnum);
-    info->sys_hist.new.procs_blocked = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "procs_running ")))
-        sscanf(b,  "procs_running %llu", &llnum);
-    if (llnum)
-        llnum--; //exclude itself
-    info->sys_hist.new.procs_running = llnum;
+    info->sys_hist.new.stamp_ns = stamp_ns;
+    if (!info->sys_hist.old.stamp_ns)
+        info->sys_hist.old.stamp_ns = stamp_ns;
+    info->sys_hist.tics = info->hertz * (stamp_ns - info->sys_hist.old.stamp_ns) / 1.0e9;
+
+    info->sys_hist.new.intr = info->sys_hist.new.ctxt = info->sys_hist.new.btime = 0;
+    info->sys_hist.new.procs_created = info->sys_hist.new.procs_blocked = 0;
+    info->sys_hist.new.procs_running = 0;
+
+    /* the remaining lines are handled in a single forward pass, where just
+       the first (total) value on the 'intr' & 'softirq' lines is of interest
+       and the thousands of per-irq counts which may follow are then skipped
+       with memchr, rather than being scanned repeatedly as with strstr ... */
+    while (bp < end) {
+        switch (*bp) {
+            case 'b':
+                if (!strncmp(bp, "btime ", 6))
+                    info->sys_hist.new.btime = stat_num(bp + 6);
+                break;
+            case 'c':
+                if (!strncmp(bp, "ctxt ", 5))
+                    info->sys_hist.new.ctxt = stat_num(bp + 5);
+                break;
+            case 'i':
+                if (!strncmp(bp, "intr ", 5))
+                    info->sys_hist.new.intr = stat_num(bp + 5);
+                break;
+            case 'p':
+                if (!strncmp(bp, "processes ", 10))
+                    info->sys_hist.new.procs_created = stat_num(bp + 10);
+                else if (!strncmp(bp, "procs_running ", 14)) {
+                    info->sys_hist.new.procs_running = stat_num(bp + 14);
+                    if (info->sys_hist.new.procs_running)
+                        info->sys_hist.new.procs_running--; //exclude itself
+                } else if (!strncmp(bp, "procs_blocked ", 14))
+                    info->sys_hist.new.procs_blocked = stat_num(bp + 14);
+                break;
+            default:
+                break;
+        }
+        if (!(bp = memchr(bp, '\n', end - bp)))
+            break;
+        ++bp;
+    }
 
     if (refresh_cores) {
         stat_cores_reset(info);
@@ -1123,7 +1276,9 @@ PROCPS_EXPORT int procps_stat_new (
         return -ENOMEM;
     }
     p->stat_buf_size = BUFFER_INCR;
+    p->stat_fd = -1;
     p->refcount = 1;
+    p->hertz = procps_hertz_get();
 
     p->results.cpus = &p->cpus.result;
     p->results.numa = &p->nodes.result;
@@ -1172,8 +1327,8 @@ PROCPS_EXPORT int procps_stat_unref (
     if ((*info)->refcount < 1) {
         int errno_sav = errno;
 
-        if ((*info)->stat_fp)
-            fclose((*info)->stat_fp);
+        if ((*info)->stat_fd != -1)
+            close((*info)->stat_fd);
         if ((*info)->stat_buf)
             free((*info)->stat_buf);
 
@@ -1286,7 +1441,7 @@ PROCPS_EXPORT struct stat_reaped *procps_stat_reap (
 {   int i;
     // those STAT_SYS_type enum's make sense only to 'select' ...
     for (i = 0; i < numitems; i++) {
-        if (items[i] > STAT_TIC_highest)
+        if (items[i] > STAT_TIC_highest && items[i] < STAT_TIC_pct_lowest)
             return NULL;
     }
 }
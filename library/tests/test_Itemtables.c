@@ -19,15 +19,26 @@
 
 #include <stdlib.h>
 
+#include "cgroups.h"
 #include "diskstats.h"
+#include "interrupts.h"
 #include "meminfo.h"
 #include "pids.h"
+#include "pressure.h"
 #include "slabinfo.h"
 #include "stat.h"
 #include "vmstat.h"
 
 #include "tests.h"
 
+static int check_cgroups (void *data) {
+    struct cgroups_info *ctx = NULL;
+    testname = "Itemtable check, cgroups";
+    if (0 == procps_cgroups_new(&ctx))
+        procps_cgroups_unref(&ctx);
+    return 1;
+}
+
 static int check_diskstats (void *data) {
     struct diskstats_info *ctx = NULL;
     testname = "Itemtable check, diskstats";
@@ -36,6 +47,14 @@ static int check_diskstats (void *data) {
     return 1;
 }
 
+static int check_interrupts (void *data) {
+    struct interrupts_info *ctx = NULL;
+    testname = "Itemtable check, interrupts";
+    if (0 == procps_interrupts_new(&ctx))
+        procps_interrupts_unref(&ctx);
+    return 1;
+}
+
 static int check_meminfo (void *data) {
     struct meminfo_info *ctx = NULL;
     testname = "Itemtable check, meminfo";
@@ -52,6 +71,14 @@ static int check_pids (void *data) {
     return 1;
 }
 
+static int check_pressure (void *data) {
+    struct pressure_info *ctx = NULL;
+    testname = "Itemtable check, pressure";
+    if (0 == procps_pressure_new(&ctx))
+        procps_pressure_unref(&ctx);
+    return 1;
+}
+
 static int check_slabinfo (void *data) {
     struct slabinfo_info *ctx = NULL;
     testname = "Itemtable check, slabinfo";
@@ -77,9 +104,12 @@ static int check_vmstat (void *data) {
 }
 
 static TestFunction test_funcs[] = {
+    check_cgroups,
     check_diskstats,
+    check_interrupts,
     check_meminfo,
     check_pids,
+    check_pressure,
     check_slabinfo,
     check_stat,
     check_vmstat,
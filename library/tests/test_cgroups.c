@@ -0,0 +1,236 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the cgroups library calls, using a synthetic hierarchy
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+// the library source is included here, but reading our own files
+static char cgroup_dir[64];
+#define CGROUP_DIR  cgroup_dir
+#include "../cgroups.c"
+
+#include "tests.h"
+
+static char tmp_dir[] = "/tmp/test_cgroups.XXXXXX";
+
+static enum cgroups_item items[] = {
+    CGROUPS_NAME, CGROUPS_DEPTH, CGROUPS_CPU_USAGE_USEC, CGROUPS_DELTA_CPU_USAGE_USEC,
+    CGROUPS_DELTA_CPU_USAGE_PCT, CGROUPS_DELTA_IO_WBYTES, CGROUPS_MEM_ANON };
+enum rel_items {
+    name, depth, usage, usage_DEL, usage_PCT, wbytes_DEL, anon };
+
+static int write_file (const char *group, const char *file, const char *fmt, unsigned long long val)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s%s/%s", cgroup_dir, group, file);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    fprintf(fp, fmt, val, val, val, val);
+    return (fclose(fp) == 0);
+}
+
+        /*
+         * Write the files of one group, with everything based on 'usage'.
+         * Its io.stat holds two devices, with half of those bytes on each. */
+static int write_group (const char *group, unsigned long long usage)
+{
+    char path[128];
+
+    snprintf(path, sizeof(path), "%s%s", cgroup_dir, group);
+    if (mkdir(path, 0700) < 0 && errno != EEXIST)
+        return 0;
+    return write_file(group, "cpu.stat"
+            , "usage_usec %llu\nuser_usec %llu\nsystem_usec 0\nnr_periods 0\n"
+              "nr_throttled 0\nthrottled_usec 0\nnr_bursts 0\nburst_usec %llu\n", usage)
+        && write_file(group, "memory.current", "%llu\n", usage * 4)
+        && write_file(group, "memory.stat"
+            , "anon %llu\nfile %llu\nkernel 0\nkernel_stack 0\nshmem %llu\n", usage)
+        && write_file(group, "io.stat"
+            , "8:16 rbytes=%llu wbytes=%llu rios=1 wios=1 dbytes=0 dios=0\n"
+              "8:0 rbytes=%llu wbytes=%llu rios=1 wios=1 dbytes=0 dios=0\n", usage / 2);
+}
+
+static int write_descendants (unsigned long long count)
+{
+    return write_file("", "cgroup.stat", "nr_descendants %llu\nnr_dying_descendants 0\n", count);
+}
+
+int check_cgroups_values (void *data)
+{
+    struct cgroups_info *info = NULL;
+    int rc;
+
+    testname = "cgroups values, with a group lacking most files";
+    if (!write_group("/system.slice", 1000)
+    || mkdir("system.slice/cron.service", 0700) < 0
+    || !write_file("/system.slice/cron.service", "memory.current", "%llu\n", 8192)
+    || !write_descendants(2))
+        return 0;
+    if (procps_cgroups_new(&info) < 0)
+        return 0;
+    rc = (CGROUPS_GET(info, "/system.slice", CGROUPS_CPU_USAGE_USEC, ull_int) == 1000
+        && CGROUPS_GET(info, "/system.slice", CGROUPS_CPU_USER_USEC, ull_int) == 1000
+        && CGROUPS_GET(info, "system.slice", CGROUPS_MEM_CURRENT, ull_int) == 4000
+        && CGROUPS_GET(info, "system.slice", CGROUPS_MEM_SHMEM, ull_int) == 1000
+        && CGROUPS_GET(info, "system.slice", CGROUPS_IO_RBYTES, ull_int) == 1000
+        && CGROUPS_GET(info, "system.slice", CGROUPS_IO_WIOS, ull_int) == 2
+        && CGROUPS_GET(info, "/system.slice/cron.service", CGROUPS_DEPTH, s_int) == 2
+        && CGROUPS_GET(info, "/system.slice/cron.service", CGROUPS_MEM_CURRENT, ull_int) == 8192
+        && CGROUPS_GET(info, "/system.slice/cron.service", CGROUPS_CPU_USAGE_USEC, ull_int) == 0
+        && CGROUPS_GET(info, "/", CGROUPS_DEPTH, s_int) == 0
+        && CGROUPS_GET(info, "/user.slice", CGROUPS_DEPTH, s_int) == 0 && errno == ENXIO);
+    procps_cgroups_unref(&info);
+    return rc;
+}
+
+static struct cgroups_stack *reap_group (struct cgroups_info *info, const char *group)
+{
+    struct cgroups_reaped *reap;
+    int i;
+
+    if (!(reap = procps_cgroups_reap(info, items, MAXTABLE(items))))
+        return NULL;
+    for (i = 0; i < reap->total; i++)
+        if (!strcmp(CGROUPS_VAL(name, str, reap->stacks[i]), group))
+            return reap->stacks[i];
+    return NULL;
+}
+
+int check_cgroups_deltas (void *data)
+{
+    struct cgroups_info *info = NULL;
+    struct cgroups_stack *stack;
+    int rc;
+
+    testname = "cgroups deltas, through persistent fds & a group recreated";
+    if (!write_group("/system.slice", 1000))
+        return 0;
+    if (procps_cgroups_new(&info) < 0)
+        return 0;
+    if (!write_group("/system.slice", 3000))
+        return 0;
+    usleep(10000);
+    if (!(stack = procps_cgroups_select(info, "/system.slice", items, MAXTABLE(items))))
+        return 0;
+    rc = (CGROUPS_VAL(usage, ull_int, stack) == 3000
+        && CGROUPS_VAL(usage_DEL, ull_int, stack) == 2000
+        && CGROUPS_VAL(wbytes_DEL, ull_int, stack) == 2000
+        && CGROUPS_VAL(usage_PCT, real, stack) > 0.0
+        && CGROUPS_VAL(usage_PCT, real, stack) <= 20.0
+        && info->fds_inuse > 0);
+    // a group whose totals went backward was recreated, so has no delta
+    if (rc && write_group("/system.slice", 500)
+    && (stack = procps_cgroups_select(info, "/system.slice", items, MAXTABLE(items))))
+        rc = (CGROUPS_VAL(usage_DEL, ull_int, stack) == 0
+            && CGROUPS_VAL(usage_PCT, real, stack) == 0.0);
+    else
+        rc = 0;
+    // those selects must not have disturbed the history a reap relies on
+    if (rc && write_group("/system.slice", 1500)
+    && (stack = reap_group(info, "/system.slice")))
+        rc = (CGROUPS_VAL(usage_DEL, ull_int, stack) == 500);
+    else
+        rc = 0;
+    /* a group removed then recreated (as its fds are still readable) must
+       be reopened by the next walk, with its history then discarded */
+    if (rc && tests_remove_dir("system.slice") == 0
+    && write_group("/system.slice", 1800)
+    && mkdir("system.slice/cron.service", 0700) == 0) {
+        info->rewalk = 1;
+        rc = ((stack = reap_group(info, "/system.slice"))
+            && CGROUPS_VAL(usage, ull_int, stack) == 1800
+            && CGROUPS_VAL(usage_DEL, ull_int, stack) == 0);
+    } else
+        rc = 0;
+    procps_cgroups_unref(&info);
+    return rc;
+}
+
+int check_cgroups_walks (void *data)
+{
+    struct cgroups_info *info = NULL;
+    struct cgroups_reaped *reap;
+    int rc;
+
+    testname = "cgroups reap, sort & rewalk, with no fds to spare";
+    if (!write_group("/system.slice", 3000)
+    || !write_descendants(2))
+        return 0;
+    if (procps_cgroups_new(&info) < 0)
+        return 0;
+    // everything should still work (if more slowly) without any cached fds
+    info->fds_max = 0;
+    if (!write_group("/user.slice", 2000)
+    || !write_descendants(3)
+    || !(reap = procps_cgroups_reap(info, items, MAXTABLE(items)))
+    || !procps_cgroups_sort(info, reap->stacks, reap->total, CGROUPS_CPU_USAGE_USEC, CGROUPS_SORT_DESCEND))
+        return 0;
+    rc = (reap->total == 4
+        && !strcmp(CGROUPS_VAL(name, str, reap->stacks[0]), "/system.slice")
+        && !strcmp(CGROUPS_VAL(name, str, reap->stacks[1]), "/user.slice")
+        && CGROUPS_VAL(anon, ull_int, reap->stacks[1]) == 2000
+        && CGROUPS_VAL(usage_DEL, ull_int, reap->stacks[1]) == 0);
+    // and now that a group is gone, its node must be as well
+    if (rc) {
+        if (tests_remove_dir("user.slice") < 0
+        || !write_descendants(2)
+        || !(reap = procps_cgroups_reap(info, items, MAXTABLE(items))))
+            rc = 0;
+        else
+            rc = (reap->total == 3
+                && info->numnodes == 3
+                && CGROUPS_GET(info, "/user.slice", CGROUPS_NAME, str) == NULL);
+    }
+    procps_cgroups_unref(&info);
+    return rc;
+}
+
+int check_cgroups_missing (void *data)
+{
+    struct cgroups_info *info = NULL;
+
+    testname = "procps_cgroups_new() without a unified hierarchy";
+    unlink("cgroup.controllers");
+    return (procps_cgroups_new(&info) == -ENOENT
+        && info == NULL);
+}
+
+TestFunction test_funcs[] = {
+    check_cgroups_values,
+    check_cgroups_deltas,
+    check_cgroups_walks,
+    check_cgroups_missing,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(cgroup_dir, sizeof(cgroup_dir), "%s", tmp_dir);
+    return write_file("", "cgroup.controllers", "cpu io memory pids\n", 0);
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
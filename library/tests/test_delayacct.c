@@ -0,0 +1,238 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the taskstats delay accounting, using a stub netlink responder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <errno.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sys/wait.h>
+
+// the library source is included here, but talking to our own stub
+#include "../delayacct.c"
+
+#include "tests.h"
+
+#define STUB_FAMILY    0x1d            // the TASKSTATS family id we'll claim
+#define STUB_DENIED    900000          // ids from here on are refused (EPERM)
+#define STUB_GONE(id)  ((id) % 7 == 0) // these tasks have since ended (ESRCH)
+#define STUB_OLD(id)   ((id) % 5 == 0) // these replies are from an 'old kernel'
+#define STUB_SEND      4000            // replies are sent several at a time
+
+static struct delayacct stub_da = { .sock = -1, .seq = 1 };
+static pid_t stub_pid;
+
+
+static struct nlmsghdr *stub_msg (char *buf, int *pos, int type, __u32 seq)
+{
+    struct nlmsghdr *nl = (struct nlmsghdr *)(buf + *pos);
+
+    memset(nl, 0, sizeof(*nl));
+    nl->nlmsg_len = NLMSG_HDRLEN;
+    nl->nlmsg_type = type;
+    nl->nlmsg_seq = seq;
+    return nl;
+}
+
+static struct nlattr *stub_attr (struct nlmsghdr *nl, int type, const void *data, int len)
+{
+    struct nlattr *na = (struct nlattr *)((char *)nl + NLMSG_ALIGN(nl->nlmsg_len));
+
+    na->nla_type = type;
+    na->nla_len = NLA_HDRLEN + len;
+    if (data)
+        memcpy(NLA_DATA(na), data, len);
+    nl->nlmsg_len = NLMSG_ALIGN(nl->nlmsg_len) + NLA_ALIGN(na->nla_len);
+    return na;
+}
+
+static void stub_reply (char *buf, int *pos, struct nlmsghdr *req)
+{
+    struct nlattr *na = (struct nlattr *)((char *)NLMSG_DATA(req) + GENL_HDRLEN);
+    struct nlmsghdr *nl;
+    struct nlmsgerr *err;
+    struct nlattr *aggr;
+    struct taskstats ts;
+    __u16 family = STUB_FAMILY;
+    __u32 id = 0;
+
+    if (req->nlmsg_type == GENL_ID_CTRL) {
+        nl = stub_msg(buf, pos, GENL_ID_CTRL, req->nlmsg_seq);
+        nl->nlmsg_len += GENL_HDRLEN;
+        stub_attr(nl, CTRL_ATTR_FAMILY_ID, &family, sizeof(family));
+        *pos += NLMSG_ALIGN(nl->nlmsg_len);
+        return;
+    }
+    memcpy(&id, NLA_DATA(na), sizeof(id));
+    if (id >= STUB_DENIED || STUB_GONE(id)) {
+        nl = stub_msg(buf, pos, NLMSG_ERROR, req->nlmsg_seq);
+        err = NLMSG_DATA(nl);
+        err->error = (id >= STUB_DENIED) ? -EPERM : -ESRCH;
+        err->msg = *req;
+        nl->nlmsg_len += sizeof(*err);
+        *pos += NLMSG_ALIGN(nl->nlmsg_len);
+        return;
+    }
+    memset(&ts, 0, sizeof(ts));
+    ts.version = TASKSTATS_VERSION;
+    ts.cpu_delay_total = id * 10;
+    ts.blkio_delay_total = id * 20;
+    ts.swapin_delay_total = id * 30;
+    ts.freepages_delay_total = id * 40;
+    ts.thrashing_delay_total = id * 50;
+
+    nl = stub_msg(buf, pos, STUB_FAMILY, req->nlmsg_seq);
+    nl->nlmsg_len += GENL_HDRLEN;
+    aggr = stub_attr(nl, na->nla_type == TASKSTATS_CMD_ATTR_TGID
+        ? TASKSTATS_TYPE_AGGR_TGID : TASKSTATS_TYPE_AGGR_PID, NULL, 0);
+    stub_attr(nl, TASKSTATS_TYPE_PID, &id, sizeof(id));
+    stub_attr(nl, TASKSTATS_TYPE_STATS, &ts
+        , STUB_OLD(id) ? offsetof(struct taskstats, freepages_delay_total) : sizeof(ts));
+    aggr->nla_len = (char *)nl + nl->nlmsg_len - (char *)aggr;
+    *pos += NLMSG_ALIGN(nl->nlmsg_len);
+}
+
+        /*
+         * Our pretend kernel, answering each request found in a datagram
+         * with replies packed several to a datagram, as a real one won't. */
+static void stub_run (int sock)
+{
+    static unsigned long in[REPLY_SIZ / sizeof(unsigned long)];
+    static unsigned long out[2 * REPLY_SIZ / sizeof(unsigned long)];
+    struct nlmsghdr *nl;
+    ssize_t n;
+    int pos;
+
+    while ((n = recv(sock, in, sizeof(in), 0)) > 0) {
+        pos = 0;
+        for (nl = (struct nlmsghdr *)in; NLMSG_OK(nl, n); nl = NLMSG_NEXT(nl, n)) {
+            stub_reply((char *)out, &pos, nl);
+            if (pos > STUB_SEND) {
+                send(sock, out, pos, 0);
+                pos = 0;
+            }
+        }
+        if (pos)
+            send(sock, out, pos, 0);
+    }
+    _exit(0);
+}
+
+
+int check_delayacct_family (void *data)
+{
+    testname = "delayacct family resolved by name";
+    return (delayacct_family(&stub_da) == 0
+        && stub_da.family == STUB_FAMILY);
+}
+
+int check_delayacct_batches (void *data)
+{
+    struct delayacct_vals vals[200];
+    pid_t ids[200];
+    int i, gone = 0, ok = 1;
+
+    testname = "delayacct_fetch() several batches, with tasks gone and old replies";
+    for (i = 0; i < 200; i++) {
+        ids[i] = i + 1;
+        gone += STUB_GONE(ids[i]);
+    }
+    if (delayacct_fetch(&stub_da, ids, 200, 0, vals) != 200 - gone)
+        return 0;
+    for (i = 0; i < 200 && ok; i++) {
+        unsigned long long id = ids[i];
+        if (STUB_GONE(id))
+            ok = !vals[i].found && vals[i].cpu == 0;
+        else
+            ok = vals[i].found
+                && vals[i].cpu == id * 10 && vals[i].blkio == id * 20
+                && vals[i].swapin == id * 30
+                && vals[i].freepages == (STUB_OLD(id) ? 0 : id * 40)
+                && vals[i].thrashing == (STUB_OLD(id) ? 0 : id * 50);
+    }
+    return ok;
+}
+
+int check_delayacct_tgid (void *data)
+{
+    struct delayacct_vals vals[2];
+    pid_t ids[2] = { 4241, 1234 };
+
+    testname = "delayacct_fetch() thread groups";
+    return (delayacct_fetch(&stub_da, ids, 2, 1, vals) == 2
+        && vals[0].cpu == 42410 && vals[1].blkio == 24680);
+}
+
+int check_delayacct_denied (void *data)
+{
+    struct delayacct_vals vals[3];
+    pid_t ids[3] = { STUB_DENIED, STUB_DENIED + 1, STUB_DENIED + 2 };
+
+    testname = "delayacct_fetch() without CAP_NET_ADMIN returns -EPERM";
+    return (delayacct_fetch(&stub_da, ids, 3, 0, vals) == -EPERM);
+}
+
+int check_delayacct_live (void *data)
+{
+    struct delayacct *da = NULL;
+    struct delayacct_vals vals[1];
+    pid_t self = getpid();
+    int rc;
+
+    testname = "delayacct_fetch() from the kernel, when permitted";
+    // delay accounting may be off, taskstats absent, or we're unprivileged
+    if ((rc = delayacct_open(&da)) < 0)
+        return (da == NULL);
+    rc = delayacct_fetch(da, &self, 1, 0, vals);
+    delayacct_close(&da);
+    return (rc == -EPERM || (rc == 1 && vals[0].found));
+}
+
+TestFunction test_funcs[] = {
+    check_delayacct_family,
+    check_delayacct_batches,
+    check_delayacct_tgid,
+    check_delayacct_denied,
+    check_delayacct_live,
+    NULL,
+};
+
+int main(int argc, char *argv[])
+{
+    int sv[2], rc;
+
+    if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sv) < 0)
+        return EXIT_FAILURE;
+    if ((stub_pid = fork()) < 0)
+        return EXIT_FAILURE;
+    if (stub_pid == 0) {
+        close(sv[0]);
+        stub_run(sv[1]);
+    }
+    close(sv[1]);
+    stub_da.sock = sv[0];
+
+    rc = run_tests(test_funcs, NULL);
+
+    close(sv[0]);
+    kill(stub_pid, SIGTERM);
+    waitpid(stub_pid, NULL, 0);
+    return rc;
+}
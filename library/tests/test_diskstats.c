@@ -0,0 +1,241 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the diskstats library calls, using a synthetic diskstats file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+// the library source is included here, but reading our own files
+static char diskstats_file[64];
+static char sysblock_dir[64];
+#define DISKSTATS_FILE  diskstats_file
+#define SYSBLOCK_DIR    sysblock_dir
+#include "../diskstats.c"
+
+#include "tests.h"
+
+#define NUM_DISKS       1000
+#define NUM_PARTS       4              // per disk, for 5k lines in all
+#define NUM_REAPS       50
+
+static char tmp_dir[] = "/tmp/test_diskstats.XXXXXX";
+
+static enum diskstats_item items[] = {
+    DISKSTATS_NAME, DISKSTATS_TYPE, DISKSTATS_READS, DISKSTATS_DELTA_READS,
+    DISKSTATS_DELTA_FLUSHES };
+
+static int write_diskstats (int num_disks, unsigned long reads)
+{
+    FILE *fp;
+    int d, p;
+
+    if (!(fp = fopen(diskstats_file, "w")))
+        return 0;
+    for (d = 0; d < num_disks; d++) {
+        for (p = 0; p <= NUM_PARTS; p++) {
+            char name[32];
+            if (p) snprintf(name, sizeof(name), "vd%dp%d", d, p);
+            else snprintf(name, sizeof(name), "vd%d", d);
+            fprintf(fp, " %4d %7d %s %lu 2 3 4 5 6 7 8 0 10 11 12 13 14 15 %lu 17\n"
+                , 252 + d / 200, (d % 200) * 16 + p, name, reads + d, reads);
+        }
+    }
+    return (fclose(fp) == 0);
+}
+
+static int add_disk (int d)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/vd%d", sysblock_dir, d);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    return (fclose(fp) == 0);
+}
+
+static int count_types (struct diskstats_reaped *reaped, int *disks, int *parts)
+{
+    int i;
+
+    *disks = *parts = 0;
+    for (i = 0; i < reaped->total; i++) {
+        if (DISKSTATS_VAL(1, s_int, reaped->stacks[i]) == DISKSTATS_TYPE_DISK)
+            ++*disks;
+        else
+            ++*parts;
+    }
+    return reaped->total;
+}
+
+int check_diskstats_classify (void *data)
+{
+    struct diskstats_info *info = NULL;
+    struct diskstats_reaped *reaped;
+    int disks, parts, ok;
+
+    testname = "diskstats disks vs. partitions, then a disk is added";
+    if (procps_diskstats_new(&info) < 0)
+        return 0;
+    ok = ((reaped = procps_diskstats_reap(info, items, 5))
+        && count_types(reaped, &disks, &parts) == NUM_DISKS * (NUM_PARTS + 1)
+        && disks == NUM_DISKS
+        && parts == NUM_DISKS * NUM_PARTS);
+    // a new disk must be recognized, whether or not the mtime was changed
+    if (ok) {
+        ok = (add_disk(NUM_DISKS) && write_diskstats(NUM_DISKS + 1, 0)
+            && (reaped = procps_diskstats_reap(info, items, 5))
+            && count_types(reaped, &disks, &parts) == (NUM_DISKS + 1) * (NUM_PARTS + 1)
+            && disks == NUM_DISKS + 1
+            && DISKSTATS_GET(info, "vd1000", DISKSTATS_TYPE, s_int) == DISKSTATS_TYPE_DISK
+            && DISKSTATS_GET(info, "vd1000p1", DISKSTATS_TYPE, s_int) == DISKSTATS_TYPE_PARTITION);
+    }
+    procps_diskstats_unref(&info);
+    return (ok && write_diskstats(NUM_DISKS, 0));
+}
+
+int check_diskstats_deltas (void *data)
+{
+    struct diskstats_info *info = NULL;
+    struct diskstats_reaped *reaped;
+    int i, ok;
+
+    testname = "diskstats delta reads, every device";
+    if (procps_diskstats_new(&info) < 0)
+        return 0;
+    ok = (write_diskstats(NUM_DISKS, 5)
+        && (reaped = procps_diskstats_reap(info, items, 5)));
+    for (i = 0; ok && i < reaped->total; i++)
+        if (DISKSTATS_VAL(3, s_int, reaped->stacks[i]) != 5
+        || DISKSTATS_VAL(4, s_int, reaped->stacks[i]) != 5)
+            ok = 0;
+    procps_diskstats_unref(&info);
+    return (ok && write_diskstats(NUM_DISKS, 0));
+}
+
+int check_diskstats_fields (void *data)
+{
+    struct diskstats_info *info = NULL;
+    FILE *fp;
+    int ok;
+
+    testname = "diskstats 14, 18 and 20 field lines";
+    if (!(fp = fopen(diskstats_file, "w")))
+        return 0;
+    fprintf(fp, "   8       0 sda 1 2 3 4 5 6 7 8 9 10 11\n"
+                "   8       1 sda1 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15\n"
+                " 259       0 nvme0n1 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17\n");
+    if (fclose(fp) != 0 || procps_diskstats_new(&info) < 0)
+        return 0;
+    ok = (DISKSTATS_GET(info, "sda", DISKSTATS_WEIGHTED_TIME, ul_int) == 11
+        && DISKSTATS_GET(info, "sda", DISKSTATS_DISCARDS, ul_int) == 0
+        && DISKSTATS_GET(info, "sda1", DISKSTATS_DISCARD_TIME, ul_int) == 15
+        && DISKSTATS_GET(info, "sda1", DISKSTATS_FLUSHES, ul_int) == 0
+        && DISKSTATS_GET(info, "nvme0n1", DISKSTATS_DISCARDS_MERGED, ul_int) == 13
+        && DISKSTATS_GET(info, "nvme0n1", DISKSTATS_FLUSH_TIME, ul_int) == 17
+        && DISKSTATS_GET(info, "nvme0n1", DISKSTATS_MAJOR, s_int) == 259);
+    procps_diskstats_unref(&info);
+    return (ok && write_diskstats(NUM_DISKS, 0));
+}
+
+int check_diskstats_rates (void *data)
+{
+    struct diskstats_info *info = NULL;
+    enum diskstats_item rates[] = {
+        DISKSTATS_DELTA_READS, DISKSTATS_DELTA_ELAPSED, DISKSTATS_DELTA_READS_PER_SEC };
+    struct diskstats_reaped *reaped;
+    double elapsed, rate;
+    int ok;
+
+    testname = "diskstats elapsed time & reads per second";
+    if (procps_diskstats_new(&info) < 0)
+        return 0;
+    usleep(100000);
+    ok = (write_diskstats(NUM_DISKS, 50)
+        && (reaped = procps_diskstats_reap(info, rates, 3)));
+    if (ok) {
+        elapsed = DISKSTATS_VAL(1, real, reaped->stacks[0]);
+        rate = DISKSTATS_VAL(2, real, reaped->stacks[0]);
+        ok = (DISKSTATS_VAL(0, s_int, reaped->stacks[0]) == 50
+            && elapsed >= 0.1 && elapsed < 5.0
+            && rate > 49.0 / elapsed && rate < 51.0 / elapsed);
+    }
+    procps_diskstats_unref(&info);
+    return (ok && write_diskstats(NUM_DISKS, 0));
+}
+
+/*
+ * A simple benchmark, the first read (creating every node) followed by
+ * a number of reaps, with 5000 lines in that synthetic diskstats file.
+ * It's run only when asked for, see tests_bench.
+ */
+int check_diskstats_bench (void *data)
+{
+    struct diskstats_info *info = NULL;
+    struct timespec beg, mid, end;
+    int i;
+
+    testname = "diskstats benchmark, 5k devices (only with TESTS_BENCH)";
+    if (!tests_bench())
+        return 1;
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    if (procps_diskstats_new(&info) < 0)
+        return 0;
+    clock_gettime(CLOCK_MONOTONIC, &mid);
+    for (i = 0; i < NUM_REAPS; i++)
+        if (!procps_diskstats_reap(info, items, 5))
+            return 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d lines: new %.1f us, then per reap %.1f us\n"
+        , NUM_DISKS * (NUM_PARTS + 1)
+        , ((mid.tv_sec - beg.tv_sec) * 1.0e9 + (mid.tv_nsec - beg.tv_nsec)) / 1000.0
+        , ((end.tv_sec - mid.tv_sec) * 1.0e9 + (end.tv_nsec - mid.tv_nsec)) / 1000.0 / NUM_REAPS);
+    procps_diskstats_unref(&info);
+    return 1;
+}
+
+TestFunction test_funcs[] = {
+    check_diskstats_classify,
+    check_diskstats_deltas,
+    check_diskstats_fields,
+    check_diskstats_rates,
+    check_diskstats_bench,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    int d;
+
+    snprintf(diskstats_file, sizeof(diskstats_file), "%s/diskstats", tmp_dir);
+    snprintf(sysblock_dir, sizeof(sysblock_dir), "%s/block", tmp_dir);
+    if (mkdir(sysblock_dir, 0700) < 0)
+        return 0;
+    for (d = 0; d < NUM_DISKS; d++)
+        if (!add_disk(d))
+            return 0;
+    return write_diskstats(NUM_DISKS, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
@@ -0,0 +1,292 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the interrupts library calls, using synthetic interrupts files
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// the library source is included here, but reading our own files
+static char interrupts_file[64];
+static char softirqs_file[64];
+#define INTERRUPTS_FILE  interrupts_file
+#define SOFTIRQS_FILE    softirqs_file
+#include "../interrupts.c"
+
+#include "tests.h"
+
+#define NUM_CPUS        512
+#define NUM_IRQS        200
+#define NUM_REAPS       50
+#define LONG_NAME       "THIS_IRQ_NAME_IS_RATHER_LONGER_THAN_31"
+
+static char tmp_dir[] = "/tmp/test_interrupts.XXXXXX";
+
+static const char *softirqs[] = {
+    "HI", "TIMER", "NET_TX", "NET_RX", "BLOCK",
+    "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU" };
+
+static enum interrupts_item items[] = {
+    INTERRUPTS_NAME, INTERRUPTS_DELTA_TOTAL, INTERRUPTS_DELTA_HOT_CPU,
+    INTERRUPTS_DELTA_CPU_COUNTS };
+
+        /*
+         * Every irq 'i' on every cpu 'c' has a count of base + i + c,
+         * except that cpu 'hot' (if any) sees 'i' more. Should 'gone'
+         * be valid, that cpu is offline and thus has no column. */
+static int write_files (int ncpus, int gone, unsigned base, int hot)
+{
+    FILE *fp;
+    int c, i;
+
+    if (!(fp = fopen(interrupts_file, "w")))
+        return 0;
+    fprintf(fp, "    ");
+    for (c = 0; c < ncpus; c++)
+        if (c != gone)
+            fprintf(fp, "      CPU%-4d", c);
+    fprintf(fp, "\n");
+    for (i = 0; i < NUM_IRQS; i++) {
+        fprintf(fp, "%4d:", i);
+        for (c = 0; c < ncpus; c++)
+            if (c != gone)
+                fprintf(fp, " %12u", base + i + c + (c == hot ? i : 0));
+        fprintf(fp, "  PCI-MSIX-0000:00:%02d.0 %d-edge      virtio%d-req.%d \n", i % 32, i, i / 8, i % 8);
+    }
+    fprintf(fp, "NMI:");
+    for (c = 0; c < ncpus; c++)
+        if (c != gone)
+            fprintf(fp, " %12u", base);
+    fprintf(fp, "   Non-maskable interrupts\nERR: %12u\nMIS: %12u\n", base, 7);
+    if (fclose(fp) != 0)
+        return 0;
+
+    if (!(fp = fopen(softirqs_file, "w")))
+        return 0;
+    fprintf(fp, "           ");
+    for (c = 0; c < ncpus; c++)
+        if (c != gone)
+            fprintf(fp, "      CPU%-4d", c);
+    fprintf(fp, "\n");
+    for (i = 0; i < (int)MAXTABLE(softirqs); i++) {
+        fprintf(fp, "%12s:", softirqs[i]);
+        for (c = 0; c < ncpus; c++)
+            if (c != gone)
+                fprintf(fp, " %12u", base * i);
+        fprintf(fp, "\n");
+    }
+    return (fclose(fp) == 0);
+}
+
+int check_interrupts_values (void *data)
+{
+    struct interrupts_info *info = NULL;
+    unsigned *vec;
+    int ok;
+
+    testname = "interrupts irq, softirq and single value lines";
+    if (!write_files(4, -1, 100, -1) || procps_interrupts_new(&info) < 0)
+        return 0;
+    vec = INTERRUPTS_GET(info, "3", INTERRUPTS_CPU_COUNTS, u_vec);
+    ok = (INTERRUPTS_GET(info, "3", INTERRUPTS_TOTAL, ull_int) == 103 + 104 + 105 + 106
+        && INTERRUPTS_GET(info, "3", INTERRUPTS_NUMBER, s_int) == 3
+        && INTERRUPTS_GET(info, "3", INTERRUPTS_NUM_CPUS, s_int) == 4
+        && INTERRUPTS_GET(info, "3", INTERRUPTS_TYPE, s_int) == INTERRUPTS_TYPE_IRQ
+        && !strcmp(INTERRUPTS_GET(info, "3", INTERRUPTS_DESCRIPTION, str), "PCI-MSIX-0000:00:03.0 3-edge      virtio0-req.3")
+        && vec && vec[0] == 103 && vec[3] == 106
+        && INTERRUPTS_GET(info, "NMI", INTERRUPTS_NUMBER, s_int) == -1
+        && !strcmp(INTERRUPTS_GET(info, "NMI", INTERRUPTS_DESCRIPTION, str), "Non-maskable interrupts")
+        && INTERRUPTS_GET(info, "MIS", INTERRUPTS_TOTAL, ull_int) == 7
+        && INTERRUPTS_GET(info, "RCU", INTERRUPTS_TOTAL, ull_int) == 4 * 900
+        && INTERRUPTS_GET(info, "RCU", INTERRUPTS_TYPE, s_int) == INTERRUPTS_TYPE_SOFTIRQ
+        && !strcmp(INTERRUPTS_GET(info, "RCU", INTERRUPTS_DESCRIPTION, str), "")
+        && !procps_interrupts_get(info, "nonesuch", INTERRUPTS_TOTAL));
+    procps_interrupts_unref(&info);
+    return ok;
+}
+
+int check_interrupts_deltas (void *data)
+{
+    struct interrupts_info *info = NULL;
+    struct interrupts_reaped *reaped;
+    unsigned *vec;
+    int i, ok;
+
+    testname = "interrupts deltas and the hot cpu, with a counter wrap";
+    if (!write_files(NUM_CPUS, -1, 4294967000u, -1) || procps_interrupts_new(&info) < 0)
+        return 0;
+    ok = (write_files(NUM_CPUS, -1, 1000, 300)
+        && (reaped = procps_interrupts_reap(info, items, 4))
+        && reaped->total == NUM_IRQS + 3 + (int)MAXTABLE(softirqs));
+    // the counts wrapped by 296 + 1000, while cpu 300 saw another 'i'
+    for (i = 1; ok && i < NUM_IRQS; i++) {
+        vec = INTERRUPTS_VAL(3, u_vec, reaped->stacks[i]);
+        if (INTERRUPTS_VAL(1, ull_int, reaped->stacks[i]) != 1296ULL * NUM_CPUS + i
+        || INTERRUPTS_VAL(2, s_int, reaped->stacks[i]) != 300
+        || vec[0] != 1296 || vec[300] != 1296u + i)
+            ok = 0;
+    }
+    if (ok)
+        ok = (INTERRUPTS_VAL(2, s_int, reaped->stacks[0]) == 0
+            && INTERRUPTS_GET(info, "ERR", INTERRUPTS_DELTA_TOTAL, ull_int) == 0
+            && INTERRUPTS_GET(info, "MIS", INTERRUPTS_DELTA_HOT_CPU, s_int) == -1);
+    procps_interrupts_unref(&info);
+    return ok;
+}
+
+int check_interrupts_hotplug (void *data)
+{
+    struct interrupts_info *info = NULL;
+    struct interrupts_reaped *reaped;
+    unsigned *vec;
+    int i, ok;
+
+    testname = "interrupts with a cpu going offline, then online";
+    if (!write_files(8, -1, 100, -1) || procps_interrupts_new(&info) < 0)
+        return 0;
+    // with cpu 5 gone, history starts over and its count reads as zero
+    ok = (write_files(8, 5, 200, -1)
+        && (reaped = procps_interrupts_reap(info, items, 4)));
+    for (i = 0; ok && i < reaped->total; i++)
+        if (INTERRUPTS_VAL(1, ull_int, reaped->stacks[i]) != 0)
+            ok = 0;
+    if (ok) {
+        vec = INTERRUPTS_GET(info, "2", INTERRUPTS_CPU_COUNTS, u_vec);
+        ok = (vec && vec[4] == 206 && vec[5] == 0 && vec[6] == 208
+            && INTERRUPTS_GET(info, "2", INTERRUPTS_NUM_CPUS, s_int) == 8
+            && INTERRUPTS_GET(info, "2", INTERRUPTS_TOTAL, ull_int) == 7 * 202 + 28 - 5);
+    }
+    // then with it back, history starts over once more before deltas resume
+    if (ok)
+        ok = (write_files(8, -1, 400, -1)
+            && (reaped = procps_interrupts_reap(info, items, 4))
+            && write_files(8, -1, 410, 7)
+            && (reaped = procps_interrupts_reap(info, items, 4))
+            && INTERRUPTS_VAL(1, ull_int, reaped->stacks[2]) == 8 * 10 + 2
+            && INTERRUPTS_VAL(2, s_int, reaped->stacks[2]) == 7);
+    procps_interrupts_unref(&info);
+    return ok;
+}
+
+        /*
+         * Replace that interrupts file with one irq, its name longer than
+         * a node keeps, whose count on each of 2 cpus is 'count'. */
+static int write_long_name (unsigned count)
+{
+    FILE *fp;
+
+    if (!(fp = fopen(interrupts_file, "w")))
+        return 0;
+    fprintf(fp, "            CPU0       CPU1\n%s: %10u %10u   Long named interrupts\n"
+        , LONG_NAME, count, count);
+    return (fclose(fp) == 0);
+}
+
+int check_interrupts_long_name (void *data)
+{
+    struct interrupts_info *info = NULL;
+    struct interrupts_stack *stack;
+    int ok;
+
+    testname = "interrupts deltas for a name longer than is kept";
+    if (!write_files(2, -1, 100, -1) || !write_long_name(100)
+    || procps_interrupts_new(&info) < 0)
+        return 0;
+    ok = (write_long_name(150)
+        && (stack = procps_interrupts_select(info, LONG_NAME, items, 4))
+        && INTERRUPTS_VAL(1, ull_int, stack) == 100);
+    procps_interrupts_unref(&info);
+    return ok;
+}
+
+int check_interrupts_sort (void *data)
+{
+    struct interrupts_info *info = NULL;
+    struct interrupts_reaped *reaped;
+    struct interrupts_stack *stack;
+    int ok;
+
+    testname = "interrupts sorted by delta, then one selected";
+    if (!write_files(NUM_CPUS, -1, 1000, -1) || procps_interrupts_new(&info) < 0)
+        return 0;
+    ok = (write_files(NUM_CPUS, -1, 1000, 17)
+        && (reaped = procps_interrupts_reap(info, items, 4))
+        && procps_interrupts_sort(info, reaped->stacks, reaped->total, INTERRUPTS_DELTA_TOTAL, INTERRUPTS_SORT_DESCEND)
+        && !strcmp(INTERRUPTS_VAL(0, str, reaped->stacks[0]), "199")
+        && !strcmp(INTERRUPTS_VAL(0, str, reaped->stacks[1]), "198")
+        && INTERRUPTS_VAL(1, ull_int, reaped->stacks[0]) == 199
+        && INTERRUPTS_VAL(1, ull_int, reaped->stacks[reaped->total - 1]) == 0
+        && (stack = procps_interrupts_select(info, "TIMER", items, 4))
+        && !strcmp(INTERRUPTS_VAL(0, str, stack), "TIMER"));
+    procps_interrupts_unref(&info);
+    return ok;
+}
+
+/*
+ * A simple benchmark, the first read (creating every node) followed by
+ * a number of reaps, with a few hundred lines from each of 512 cpus.
+ * It's run only when asked for, see tests_bench.
+ */
+int check_interrupts_bench (void *data)
+{
+    struct interrupts_info *info = NULL;
+    struct timespec beg, mid, end;
+    int i;
+
+    testname = "interrupts benchmark, 512 cpus (only with TESTS_BENCH)";
+    if (!tests_bench())
+        return 1;
+    if (!write_files(NUM_CPUS, -1, 1000000, -1))
+        return 0;
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    if (procps_interrupts_new(&info) < 0)
+        return 0;
+    clock_gettime(CLOCK_MONOTONIC, &mid);
+    for (i = 0; i < NUM_REAPS; i++)
+        if (!procps_interrupts_reap(info, items, 4))
+            return 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d lines x %d cpus: new %.1f us, then per reap %.1f us\n"
+        , NUM_IRQS + 3 + (int)MAXTABLE(softirqs), NUM_CPUS
+        , ((mid.tv_sec - beg.tv_sec) * 1.0e9 + (mid.tv_nsec - beg.tv_nsec)) / 1000.0
+        , ((end.tv_sec - mid.tv_sec) * 1.0e9 + (end.tv_nsec - mid.tv_nsec)) / 1000.0 / NUM_REAPS);
+    procps_interrupts_unref(&info);
+    return 1;
+}
+
+TestFunction test_funcs[] = {
+    check_interrupts_values,
+    check_interrupts_deltas,
+    check_interrupts_hotplug,
+    check_interrupts_long_name,
+    check_interrupts_sort,
+    check_interrupts_bench,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(interrupts_file, sizeof(interrupts_file), "%s/interrupts", tmp_dir);
+    snprintf(softirqs_file, sizeof(softirqs_file), "%s/softirqs", tmp_dir);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
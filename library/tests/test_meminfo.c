@@ -0,0 +1,233 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the meminfo library calls, using a synthetic meminfo file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+// the library sources are included here, but reading our own files
+static char meminfo_file[64];
+static char node_dir[64];
+#define MEMINFO_FILE  meminfo_file
+#define NODE_DIR      node_dir
+#include "../meminfo.c"
+#include "../numa.c"
+
+#include "tests.h"
+
+#define NUM_SELECTS  20000
+
+static char tmp_dir[] = "/tmp/test_meminfo.XXXXXX";
+
+/*
+ * Every name in our table, each with its own value, interleaved
+ * with names we don't know and ending without a newline.
+ */
+static int write_meminfo (void)
+{
+    FILE *fp;
+    int i, n = 0;
+
+    if (!(fp = fopen(meminfo_file, "w")))
+        return 0;
+    fprintf(fp, "Unknown_Before:        1 kB\n");
+    for (i = 0; i < MEMINFO_TABLE_SIZE; i++) {
+        if (!meminfo_table[i].len)
+            continue;
+        fprintf(fp, "%s:%*d kB\n", meminfo_table[i].name
+            , 24 - meminfo_table[i].len, 1000 + i);
+        if (++n % 10 == 0)
+            fprintf(fp, "%s_Unknown: %8d kB\n", meminfo_table[i].name, i);
+    }
+    fprintf(fp, "HugePages_Unknown:     2");
+    return (fclose(fp) == 0);
+}
+
+int check_meminfo_table (void *data)
+{
+    int i, n = 0;
+
+    testname = "meminfo perfect hash, every name in its own entry";
+    for (i = 0; i < MEMINFO_TABLE_SIZE; i++) {
+        if (!meminfo_table[i].len)
+            continue;
+        if (meminfo_table[i].len != strlen(meminfo_table[i].name)
+        || meminfo_hash(meminfo_table[i].name, meminfo_table[i].len) != (unsigned)i)
+            return 0;
+        ++n;
+    }
+    // that table is missing only the 'derived' fields
+    return (n == offsetof(struct meminfo_data, derived_mem_cached) / sizeof(unsigned long));
+}
+
+int check_meminfo_values (void *data)
+{
+    struct meminfo_info *info = NULL;
+    int i, ok = 1;
+
+    testname = "meminfo values, every field (with unknowns ignored)";
+    if (!write_meminfo() || procps_meminfo_new(&info) < 0)
+        return 0;
+    for (i = 0; ok && i < MEMINFO_TABLE_SIZE; i++) {
+        // this one may have been adjusted, as if we were in a container
+        if (!meminfo_table[i].len || !strcmp(meminfo_table[i].name, "MemAvailable"))
+            continue;
+        if (*(unsigned long *)((char *)&info->hist.new + meminfo_table[i].offset) != 1000UL + i)
+            ok = 0;
+    }
+    ok = (ok && MEMINFO_GET(info, MEMINFO_MEM_FREE, ul_int) == 1000UL + meminfo_hash("MemFree", 7));
+    procps_meminfo_unref(&info);
+    return ok;
+}
+
+/*
+ * A node's meminfo, with just the fields the kernel provides per node.
+ */
+static int write_node (int node, unsigned long total, unsigned long free)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/node%d", node_dir, node);
+    if (mkdir(path, 0700) < 0 && errno != EEXIST)
+        return 0;
+    snprintf(path, sizeof(path), "%s/node%d/meminfo", node_dir, node);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    fprintf(fp, "Node %d MemTotal:       %8lu kB\n", node, total);
+    fprintf(fp, "Node %d MemFree:        %8lu kB\n", node, free);
+    fprintf(fp, "Node %d MemUsed:        %8lu kB\n", node, total - free);
+    fprintf(fp, "Node %d SwapCached:     %8d kB\n", node, 100);
+    fprintf(fp, "Node %d FilePages:      %8d kB\n", node, 700);
+    fprintf(fp, "Node %d HugePages_Total:     0\n", node);
+    return (fclose(fp) == 0);
+}
+
+static int write_online (const char *list)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/online", node_dir);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    fprintf(fp, "%s\n", list);
+    return (fclose(fp) == 0);
+}
+
+int check_meminfo_nodes (void *data)
+{
+    enum meminfo_item items[] = {
+        MEMINFO_NODE_ID, MEMINFO_MEM_FREE, MEMINFO_MEM_USED, MEMINFO_MEM_CACHED,
+        MEMINFO_DELTA_FREE };
+    struct meminfo_info *info = NULL;
+    struct meminfo_reaped *reaped;
+    struct meminfo_stack *stack;
+    int ok;
+
+    testname = "meminfo nodes, reaped then sorted, selected and one offline";
+    if (!write_online("0,2-3")
+    || !write_node(0, 4000, 1000) || !write_node(2, 4000, 3000) || !write_node(3, 2000, 2000)
+    || procps_meminfo_new(&info) < 0)
+        return 0;
+    ok = ((reaped = procps_meminfo_reap(info, items, 5))
+        && reaped->total == 3
+        && reaped->stacks[3] == NULL
+        && MEMINFO_VAL(0, s_int, reaped->stacks[1]) == 2
+        && MEMINFO_VAL(1, ul_int, reaped->stacks[1]) == 3000
+        && MEMINFO_VAL(2, ul_int, reaped->stacks[0]) == 3000
+        && MEMINFO_VAL(3, ul_int, reaped->stacks[0]) == 600
+        && MEMINFO_VAL(4, s_int, reaped->stacks[0]) == 0);
+    // the deltas are per node, and a sort must leave node 2 the freest
+    ok = (ok && write_node(0, 4000, 900)
+        && (reaped = procps_meminfo_reap(info, items, 5))
+        && MEMINFO_VAL(4, s_int, reaped->stacks[0]) == -100
+        && MEMINFO_VAL(4, s_int, reaped->stacks[1]) == 0
+        && procps_meminfo_sort(info, reaped->stacks, reaped->total, MEMINFO_MEM_FREE, MEMINFO_SORT_DESCEND)
+        && MEMINFO_VAL(0, s_int, reaped->stacks[0]) == 2
+        && MEMINFO_VAL(0, s_int, reaped->stacks[2]) == 0);
+    ok = (ok && (stack = procps_meminfo_select_node(info, 3, items, 5))
+        && MEMINFO_VAL(0, s_int, stack) == 3
+        && MEMINFO_VAL(2, ul_int, stack) == 0
+        && (stack = procps_meminfo_select(info, items, 5))
+        && MEMINFO_VAL(0, s_int, stack) == -1
+        && !procps_meminfo_select_node(info, 1, items, 5));
+    ok = (ok && write_online("0,3")
+        && (reaped = procps_meminfo_reap(info, items, 5))
+        && reaped->total == 2
+        && reaped->stacks[2] == NULL
+        && MEMINFO_VAL(0, s_int, reaped->stacks[1]) == 3
+        && info->node_hist[2].fd == -1);
+    procps_meminfo_unref(&info);
+    return ok;
+}
+
+/*
+ * A simple benchmark, the cost of a select (a read plus a parse of the
+ * whole file) for both that synthetic file and the real /proc/meminfo.
+ * It's run only when asked for, see tests_bench.
+ */
+int check_meminfo_bench (void *data)
+{
+    enum meminfo_item items[] = { MEMINFO_MEM_FREE, MEMINFO_MEM_USED };
+    struct meminfo_info *info = NULL;
+    struct timespec beg, end;
+    int i, pass;
+
+    testname = "meminfo benchmark, procps_meminfo_select (only with TESTS_BENCH)";
+    if (!tests_bench())
+        return 1;
+    for (pass = 0; pass < 2; pass++) {
+        if (pass)
+            strcpy(meminfo_file, "/proc/meminfo");
+        if (procps_meminfo_new(&info) < 0)
+            return pass;               // a missing /proc/meminfo is not our problem
+        clock_gettime(CLOCK_MONOTONIC, &beg);
+        for (i = 0; i < NUM_SELECTS; i++)
+            if (!procps_meminfo_select(info, items, 2))
+                return 0;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%s: per select %.2f us\n", meminfo_file
+            , ((end.tv_sec - beg.tv_sec) * 1.0e9 + (end.tv_nsec - beg.tv_nsec)) / 1000.0 / NUM_SELECTS);
+        procps_meminfo_unref(&info);
+    }
+    return 1;
+}
+
+TestFunction test_funcs[] = {
+    check_meminfo_table,
+    check_meminfo_values,
+    check_meminfo_nodes,
+    check_meminfo_bench,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(meminfo_file, sizeof(meminfo_file), "%s/meminfo", tmp_dir);
+    snprintf(node_dir, sizeof(node_dir), "%s/node", tmp_dir);
+    return (mkdir(node_dir, 0700) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
@@ -0,0 +1,97 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the numa cpu to node map, using a synthetic sysfs node directory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <sys/stat.h>
+
+// the library source is included here, but reading our own directory
+static char node_dir[] = "/tmp/test_numa.XXXXXX";
+#define NODE_DIR  node_dir
+#include "../numa.c"
+
+#include "tests.h"
+
+static int write_cpulist (int node, const char *list)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/node%d", node_dir, node);
+    if (mkdir(path, 0700) < 0 && errno != EEXIST)
+        return 0;
+    snprintf(path, sizeof(path), "%s/node%d/cpulist", node_dir, node);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    fprintf(fp, "%s\n", list);
+    return (fclose(fp) == 0);
+}
+
+int check_numa_map (void *data)
+{
+    testname = "numa nodes from cpulists, with a gap and a cpuless node";
+    if (!write_cpulist(0, "0-3,8")
+    || !write_cpulist(2, "4-7,9-11")
+    || !write_cpulist(3, ""))
+        return 0;
+    numa_init();
+    return (numa_max_node() == 3
+        && numa_node_of_cpu(0) == 0
+        && numa_node_of_cpu(3) == 0
+        && numa_node_of_cpu(4) == 2
+        && numa_node_of_cpu(8) == 0
+        && numa_node_of_cpu(11) == 2
+        && numa_node_of_cpu(12) == -1
+        && numa_node_of_cpu(-1) == -1
+        && numa_node_of_cpu(100000) == -1);
+}
+
+int check_numa_refresh (void *data)
+{
+    struct numa_map *old = numa_map;
+
+    testname = "numa map rebuilt after a cpu hotplug";
+    if (!write_cpulist(3, "12-200"))
+        return 0;
+    // without a refresh, the earlier map must still be in use
+    if (numa_node_of_cpu(12) != -1)
+        return 0;
+    numa_refresh();
+    // and it remains intact, for any reader still holding it
+    return (numa_map != old
+        && numa_map->retired == old
+        && old->total == 64 && old->nodes[9] == 2
+        && numa_max_node() == 3
+        && numa_node_of_cpu(12) == 3
+        && numa_node_of_cpu(200) == 3
+        && numa_node_of_cpu(201) == -1
+        && numa_node_of_cpu(9) == 2);
+}
+
+TestFunction test_funcs[] = {
+    check_numa_map,
+    check_numa_refresh,
+    NULL,
+};
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, node_dir, NULL);
+}
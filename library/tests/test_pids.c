@@ -19,12 +19,84 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/syscall.h>
+#include <sys/wait.h>
 
 #include "pids.h"
 #include "tests.h"
 
 enum pids_item items[] = { PIDS_ID_PID, PIDS_ID_PID };
 enum pids_item items2[] = { PIDS_ID_PID, PIDS_VM_RSS };
+enum pids_item items3[] = { PIDS_ID_PID, PIDS_ID_TGID };
+enum pids_item items4[] = { PIDS_ID_PID, PIDS_IO_WRITE_CHARS_DELTA, PIDS_IO_WRITE_OPS_DELTA, PIDS_IO_WRITE_CHARS_RATE,
+                            PIDS_IO_READ_OPS_DELTA };
+enum pids_item items5[] = { PIDS_ID_PID, PIDS_CTXSW_VOL, PIDS_CTXSW_VOL_DELTA, PIDS_SCHED_RUNTIME_NS,
+                            PIDS_SCHED_RUNTIME_NS_DELTA };
+enum pids_item items6[] = { PIDS_ID_PID, PIDS_SMAP_RSS, PIDS_SMAP_AGE };
+enum pids_item items7[] = { PIDS_ID_PID, PIDS_ID_EUSER, PIDS_GROUP_TASKS, PIDS_VM_RSS };
+enum pids_item items8[] = { PIDS_ID_PID, PIDS_CGROUP, PIDS_CGNAME, PIDS_SD_UNIT, PIDS_CGROUP_V };
+enum pids_item items9[] = { PIDS_ID_PID, PIDS_DELAY_CPU_NS, PIDS_DELAY_CPU_NS_DELTA, PIDS_DELAY_BLKIO_NS,
+                            PIDS_DELAY_BLKIO_NS_DELTA };
+enum pids_item items10[] = { PIDS_ID_PID, PIDS_CPUS_ALLOWED, PIDS_PROCESSOR, PIDS_PROCESSOR_MIGRATED,
+                             PIDS_PROCESSOR_MIGRATIONS, PIDS_PROCESSOR_NODE_RESIDENT };
+
+/*
+ * Fork 'n' children which just wait to be killed, filling 'pids' with our
+ * own pid followed by each of theirs (so n + 1 of them, in all).
+ */
+static int fork_waiters (unsigned *pids, int n)
+{
+    pid_t kid;
+    int i;
+
+    pids[0] = getpid();
+    for (i = 1; i <= n; i++) {
+        if ((kid = fork()) < 0)
+            break;
+        if (kid == 0) {
+            pause();
+            _exit(0);
+        }
+        pids[i] = kid;
+    }
+    if (i > n)
+        return 1;
+    while (--i > 0) {
+        kill(pids[i], SIGKILL);
+        waitpid(pids[i], NULL, 0);
+    }
+    return 0;
+}
+
+static void kill_waiters (unsigned *pids, int n)
+{
+    int i;
+
+    for (i = 1; i <= n; i++) {
+        kill(pids[i], SIGKILL);
+        waitpid(pids[i], NULL, 0);
+    }
+}
+
+/*
+ * Select these pids, which must then be found (every one of them).
+ */
+static struct pids_fetch *select_these (struct pids_info *info, unsigned *pids, int n)
+{
+    struct pids_fetch *fetch;
+
+    if (!(fetch = procps_pids_select(info, pids, n, PIDS_SELECT_PID))
+    || fetch->counts->total != n)
+        return NULL;
+    return fetch;
+}
 
 int check_pids_new_nullinfo(void *data)
 {
@@ -60,11 +132,449 @@ int check_fatal_proc_unmounted(void *data)
 	    ( PIDS_VAL(1, ul_int, stack) > 0));
 }
 
+int check_pids_select_repeated(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned these[2];
+    int i, ok = 1;
+    testname = "procps_pids_select() repeated, then a process ends";
+
+    if (!fork_waiters(these, 1))
+        return 0;
+    if (procps_pids_new(&info, items3, 2) < 0)
+        ok = 0;
+    // the same pids, many times over, must always be found ...
+    for (i = 0; ok && i < 5; i++) {
+        if (!(fetch = select_these(info, these, 2))
+        || PIDS_VAL(0, s_int, fetch->stacks[1]) != (int)these[1]
+        || PIDS_VAL(1, s_int, fetch->stacks[1]) != (int)these[1])
+            ok = 0;
+    }
+    kill_waiters(these, 1);
+    // ... until one of them has ended
+    if (ok
+    && (!(fetch = procps_pids_select(info, these, 2, PIDS_SELECT_PID))
+    || fetch->counts->total != 1
+    || PIDS_VAL(0, s_int, fetch->stacks[0]) != (int)these[0]))
+        ok = 0;
+    // and a different list of pids must also be honored
+    if (ok && !select_these(info, &these[0], 1))
+        ok = 0;
+    procps_pids_unref(&info);
+    return ok;
+}
+
+static void *thread_waiter (void *arg)
+{
+    int *fds = arg;
+    unsigned tid = syscall(SYS_gettid);
+    char c;
+
+    if (write(fds[1], &tid, sizeof(tid)) == sizeof(tid))
+        (void)read(fds[2], &c, 1);       // until released
+    return NULL;
+}
+
+#define PINS_PLENTY  300               // more than <pids> will ever pin
+
+int check_pids_select_thread(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    pthread_t thread;
+    unsigned tid, many[PINS_PLENTY];
+    int fds[4], i, ok = 1;
+    pid_t self = getpid();
+    testname = "procps_pids_select() of a thread's id finds its process";
+
+    if (pipe(&fds[0]) < 0 || pipe(&fds[2]) < 0)
+        return 0;
+    if (pthread_create(&thread, NULL, thread_waiter, fds)
+    || read(fds[0], &tid, sizeof(tid)) != sizeof(tid))
+        ok = 0;
+    if (ok && procps_pids_new(&info, items3, 2) < 0)
+        ok = 0;
+    if (ok
+    && (!(fetch = procps_pids_select(info, &tid, 1, PIDS_SELECT_PID))
+    || fetch->counts->total != 1
+    || PIDS_VAL(0, s_int, fetch->stacks[0]) != self
+    || PIDS_VAL(1, s_int, fetch->stacks[0]) != self))
+        ok = 0;
+    // likewise when too many pids are given for them to be pinned
+    for (i = 0; i < PINS_PLENTY; i++)
+        many[i] = tid;
+    if (ok
+    && (!(fetch = procps_pids_select(info, many, PINS_PLENTY, PIDS_SELECT_PID))
+    || fetch->counts->total != PINS_PLENTY
+    || PIDS_VAL(0, s_int, fetch->stacks[PINS_PLENTY - 1]) != self
+    || PIDS_VAL(1, s_int, fetch->stacks[PINS_PLENTY - 1]) != self))
+        ok = 0;
+    // and with threads, every one of them (the leader first)
+    if (ok
+    && (!(fetch = procps_pids_select(info, &tid, 1, PIDS_SELECT_PID_THREADS))
+    || fetch->counts->total != 2
+    || PIDS_VAL(0, s_int, fetch->stacks[0]) != self
+    || PIDS_VAL(0, s_int, fetch->stacks[1]) != (int)tid
+    || PIDS_VAL(1, s_int, fetch->stacks[1]) != self))
+        ok = 0;
+    procps_pids_unref(&info);
+    if (write(fds[3], "", 1) == 1)
+        pthread_join(thread, NULL);
+    for (tid = 0; tid < 4; tid++)
+        close(fds[tid]);
+    return ok;
+}
+
+static int reap_finds (struct pids_info *info, pid_t pid)
+{
+    struct pids_fetch *fetch;
+    int i;
+
+    if (!(fetch = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)))
+        return -1;
+    for (i = 0; i < fetch->counts->total; i++)
+        if (PIDS_VAL(0, s_int, fetch->stacks[i]) == pid)
+            return PIDS_VAL(1, s_int, fetch->stacks[i]) == pid;
+    return 0;
+}
+
+/*
+ * With LIBPROC_PROC_EVENTS, reap will use the cn_proc connector when it's
+ * available and otherwise scan /proc, so this must pass either way.
+ */
+int check_pids_reap_events(void *data)
+{
+    struct pids_info *info = NULL;
+    unsigned pids[2];
+    pid_t zombie;
+    int ok = 1;
+    testname = "procps_pids_reap() with LIBPROC_PROC_EVENTS, fork then exit";
+
+    setenv("LIBPROC_PROC_EVENTS", "1", 1);
+    if (procps_pids_new(&info, items3, 2) < 0)
+        return 0;
+    unsetenv("LIBPROC_PROC_EVENTS");
+    if (reap_finds(info, getpid()) != 1)
+        ok = 0;
+    if (!fork_waiters(pids, 1))
+        return 0;
+    if ((zombie = fork()) < 0)
+        return 0;
+    if (zombie == 0)
+        _exit(0);
+    // the new process is found, and one that has exited stays until waited
+    if (ok && reap_finds(info, pids[1]) != 1)
+        ok = 0;
+    if (ok && reap_finds(info, zombie) != 1)
+        ok = 0;
+    kill_waiters(pids, 1);
+    waitpid(zombie, NULL, 0);
+    if (ok && (reap_finds(info, pids[1]) != 0 || reap_finds(info, zombie) != 0))
+        ok = 0;
+    // while those still alive remain
+    if (ok && reap_finds(info, getpid()) != 1)
+        ok = 0;
+    procps_pids_unref(&info);
+    return ok;
+}
+
+/*
+ * Our own writes (to /dev/null, which is still counted) must show up as
+ * deltas and rates on a second select, but never on the first one.
+ */
+int check_pids_io_deltas(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned self = getpid();
+    char buf[4096] = { 0 };
+    int fd, i, ok = 1;
+    testname = "procps_pids_select() io deltas and rates, with a reset";
+
+    if ((fd = open("/dev/null", O_WRONLY)) < 0)
+        return 0;
+    if (procps_pids_new(&info, items4, 4) < 0)
+        return 0;
+    for (i = 0; ok && i < 2; i++) {
+        // at first, then after a reset needing more history, there's none
+        if (!(fetch = select_these(info, &self, 1))
+        || PIDS_VAL(1, ul_int, fetch->stacks[0]) != 0
+        || PIDS_VAL(3, real, fetch->stacks[0]) != 0.0)
+            ok = 0;
+        if (write(fd, buf, sizeof(buf)) != sizeof(buf)
+        || write(fd, buf, sizeof(buf)) != sizeof(buf))
+            ok = 0;
+        usleep(10000);
+        if (ok
+        && (!(fetch = select_these(info, &self, 1))
+        || PIDS_VAL(1, ul_int, fetch->stacks[0]) < 2 * sizeof(buf)
+        || PIDS_VAL(2, ul_int, fetch->stacks[0]) < 2
+        || PIDS_VAL(3, real, fetch->stacks[0]) <= 0.0))
+            ok = 0;
+        if (procps_pids_reset(info, items4, 5) < 0)
+            ok = 0;
+    }
+    close(fd);
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_sched_deltas(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned self = getpid();
+    unsigned long vol;
+    unsigned long long runtime;
+    int ok = 0;
+    testname = "procps_pids_select() context switch and schedstat deltas";
+
+    if (procps_pids_new(&info, items5, 5) < 0)
+        return 0;
+    if ((fetch = select_these(info, &self, 1))
+    && PIDS_VAL(2, ul_int, fetch->stacks[0]) == 0
+    && PIDS_VAL(4, ull_int, fetch->stacks[0]) == 0) {
+        vol = PIDS_VAL(1, ul_int, fetch->stacks[0]);
+        runtime = PIDS_VAL(3, ull_int, fetch->stacks[0]);
+        // sleeping is a voluntary switch, and fetching consumes cpu
+        usleep(10000);
+        if ((fetch = select_these(info, &self, 1))) {
+            ok = (PIDS_VAL(2, ul_int, fetch->stacks[0]) >= 1
+                && PIDS_VAL(2, ul_int, fetch->stacks[0]) == PIDS_VAL(1, ul_int, fetch->stacks[0]) - vol
+                && PIDS_VAL(4, ull_int, fetch->stacks[0]) == PIDS_VAL(3, ull_int, fetch->stacks[0]) - runtime);
+        }
+    }
+    procps_pids_unref(&info);
+    return ok;
+}
+
+/*
+ * With a budget of nothing, only the largest task (by rss) is read on that
+ * second select while a smaller child's values come from the first one.
+ */
+int check_pids_smaps_budget(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned pids[2];
+    unsigned long rss = 0;
+    char *big;
+    int i, ok = 1;
+    testname = "procps_pids_smaps_budget() serves stale smaps with an age";
+
+    if (procps_pids_new(&info, items6, 3) < 0)
+        return 0;
+    if (procps_pids_smaps_budget(info, -1, 0) != -EINVAL
+    || procps_pids_smaps_budget(info, 1, 0) < 0)
+        ok = 0;
+    if (!fork_waiters(pids, 1))
+        return 0;
+    // once forked, we grow so as to be the largest of the two
+    if (!(big = malloc(16 * 1024 * 1024)))
+        ok = 0;
+    else
+        memset(big, 1, 16 * 1024 * 1024);
+    if (ok && !(fetch = select_these(info, pids, 2)))
+        ok = 0;
+    for (i = 0; ok && i < 2; i++) {
+        if (PIDS_VAL(2, real, fetch->stacks[i]) != 0.0)
+            ok = 0;
+        if (PIDS_VAL(0, s_int, fetch->stacks[i]) == (int)pids[1])
+            rss = PIDS_VAL(1, ul_int, fetch->stacks[i]);
+    }
+    usleep(10000);
+    if (ok && !(fetch = select_these(info, pids, 2)))
+        ok = 0;
+    for (i = 0; ok && i < 2; i++) {
+        if (PIDS_VAL(0, s_int, fetch->stacks[i]) == (int)pids[0])
+            ok = (PIDS_VAL(2, real, fetch->stacks[i]) == 0.0);
+        else
+            ok = (PIDS_VAL(2, real, fetch->stacks[i]) >= 0.01
+                && PIDS_VAL(1, ul_int, fetch->stacks[i]) == rss);
+    }
+    kill_waiters(pids, 1);
+    free(big);
+    procps_pids_unref(&info);
+    return ok && rss;
+}
+
+int check_pids_group(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch, *group;
+    unsigned pids[3];
+    unsigned long rss = 0;
+    int i, ok = 1;
+    testname = "procps_pids_group() sums tasks sharing a key";
+
+    if (procps_pids_new(&info, items7, 4) < 0)
+        return 0;
+    if (procps_pids_group(info, NULL, 0, PIDS_ID_EUSER) != NULL
+    || procps_pids_group(info, NULL, 0, PIDS_VM_RSS) != NULL)
+        ok = 0;
+    if (!fork_waiters(pids, 2))
+        return 0;
+    // the same euser for all three, of course
+    if (ok && !(fetch = select_these(info, pids, 3)))
+        ok = 0;
+    for (i = 0; ok && i < 3; i++)
+        rss += PIDS_VAL(3, ul_int, fetch->stacks[i]);
+    // twice, so those interned keys are reused
+    for (i = 0; ok && i < 2; i++) {
+        if (!(group = procps_pids_group(info, fetch->stacks, 3, PIDS_ID_EUSER))
+        || group->counts->total != 1)
+            ok = 0;
+        else
+            ok = (PIDS_VAL(2, s_int, group->stacks[0]) == 3
+                && PIDS_VAL(3, ul_int, group->stacks[0]) == rss
+                && PIDS_VAL(0, s_int, group->stacks[0]) == PIDS_VAL(0, s_int, fetch->stacks[0])
+                && !strcmp(PIDS_VAL(1, str, group->stacks[0]), PIDS_VAL(1, str, fetch->stacks[0]))
+                && group->stacks[1] == NULL);
+    }
+    kill_waiters(pids, 2);
+    procps_pids_unref(&info);
+    return ok && rss;
+}
+
+int check_pids_cgroup_shared(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned pids[2];
+    char *cgroup = NULL, **vec0, **vec1, line[512];
+    FILE *fp;
+    int i, ok = 1;
+    testname = "procps_pids_select() cgroup strings shared by identical cgroups";
+
+    // the cgroup vectors, though no longer read separately, must still match
+    if (!(fp = fopen("/proc/self/cgroup", "r")))
+        return 0;
+    if (!fgets(line, sizeof(line), fp))
+        line[0] = '\0';
+    fclose(fp);
+    line[strcspn(line, "\n")] = '\0';
+    if (procps_pids_new(&info, items8, 5) < 0)
+        return 0;
+    if (!fork_waiters(pids, 1))
+        return 0;
+    /* a child shares our cgroup, so shares the very same strings (twice over)
+       yet each must own its cgroup vectors, since those are freed with it */
+    for (i = 0; ok && i < 2; i++) {
+        if (!(fetch = select_these(info, pids, 2)))
+            ok = 0;
+        else {
+            vec0 = PIDS_VAL(4, strv, fetch->stacks[0]);
+            vec1 = PIDS_VAL(4, strv, fetch->stacks[1]);
+            ok = (vec0 != vec1 && *vec0 != *vec1
+                && (!line[0] || !strcmp(vec0[0], line))
+                && !strcmp(vec0[0], vec1[0])
+                && PIDS_VAL(1, str, fetch->stacks[0]) == PIDS_VAL(1, str, fetch->stacks[1])
+                && PIDS_VAL(2, str, fetch->stacks[0]) == PIDS_VAL(2, str, fetch->stacks[1])
+                && PIDS_VAL(3, str, fetch->stacks[0]) == PIDS_VAL(3, str, fetch->stacks[1])
+                && (!cgroup || cgroup == PIDS_VAL(1, str, fetch->stacks[0])));
+            cgroup = PIDS_VAL(1, str, fetch->stacks[0]);
+        }
+    }
+    kill_waiters(pids, 1);
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_delays(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned self = getpid();
+    unsigned long long cpu, blkio;
+    int ok = 0;
+    testname = "procps_pids_select() delay accounting, with deltas";
+
+    // whether from taskstats or the /proc fallback, the deltas must agree
+    if (procps_pids_new(&info, items9, 5) < 0)
+        return 0;
+    if ((fetch = select_these(info, &self, 1))
+    && PIDS_VAL(2, ull_int, fetch->stacks[0]) == 0
+    && PIDS_VAL(4, ull_int, fetch->stacks[0]) == 0) {
+        cpu = PIDS_VAL(1, ull_int, fetch->stacks[0]);
+        blkio = PIDS_VAL(3, ull_int, fetch->stacks[0]);
+        usleep(10000);
+        if ((fetch = select_these(info, &self, 1))) {
+            ok = (PIDS_VAL(1, ull_int, fetch->stacks[0]) >= cpu
+                && PIDS_VAL(2, ull_int, fetch->stacks[0]) == PIDS_VAL(1, ull_int, fetch->stacks[0]) - cpu
+                && PIDS_VAL(4, ull_int, fetch->stacks[0]) == PIDS_VAL(3, ull_int, fetch->stacks[0]) - blkio);
+        }
+    }
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_cpus_migrations(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    const struct pids_cpus *cpus;
+    unsigned self = getpid();
+    cpu_set_t set, one;
+    int cpu, other = -1, ok = 0;
+    testname = "procps_pids_select() cpus allowed, with migrations";
+
+    if (sched_getaffinity(0, sizeof(set), &set) < 0)
+        return 0;
+    if (procps_pids_new(&info, items10, 6) < 0)
+        return 0;
+    if (!(fetch = select_these(info, &self, 1)))
+        goto done;
+    cpus = PIDS_VAL(1, cpus, fetch->stacks[0]);
+    if (cpus->count != CPU_COUNT(&set)
+    || PIDS_VAL(3, s_int, fetch->stacks[0]) != 0
+    || PIDS_VAL(4, ul_int, fetch->stacks[0]) != 0)
+        goto done;
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &set) != !PIDS_CPU_ISSET(cpu, cpus))
+            goto done;
+        if (CPU_ISSET(cpu, &set) && cpu != PIDS_VAL(2, s_int, fetch->stacks[0]))
+            other = cpu;
+    }
+    // with another cpu allowed, we'll move there (once) and back again
+    if (other > -1) {
+        CPU_ZERO(&one);
+        CPU_SET(other, &one);
+        if (sched_setaffinity(0, sizeof(one), &one) < 0)
+            goto done;
+    }
+    fetch = select_these(info, &self, 1);
+    if (other > -1)
+        sched_setaffinity(0, sizeof(set), &set);
+    if (fetch && other > -1)
+        ok = (PIDS_VAL(1, cpus, fetch->stacks[0])->count == 1
+            && PIDS_VAL(2, s_int, fetch->stacks[0]) == other
+            && PIDS_VAL(3, s_int, fetch->stacks[0]) == 1
+            && PIDS_VAL(4, ul_int, fetch->stacks[0]) == 1);
+    else if (fetch)
+        ok = (PIDS_VAL(1, cpus, fetch->stacks[0]) == cpus
+            && PIDS_VAL(3, s_int, fetch->stacks[0]) == 0
+            && PIDS_VAL(5, real, fetch->stacks[0]) > 0.0);
+done:
+    procps_pids_unref(&info);
+    return ok;
+}
+
 TestFunction test_funcs[] = {
     check_pids_new_nullinfo,
     // skipped, ask Jim check_pids_new_toomany,
     check_pids_new_and_unref,
     check_fatal_proc_unmounted,
+    check_pids_select_repeated,
+    check_pids_select_thread,
+    check_pids_reap_events,
+    check_pids_io_deltas,
+    check_pids_sched_deltas,
+    check_pids_smaps_budget,
+    check_pids_group,
+    check_pids_cgroup_shared,
+    check_pids_delays,
+    check_pids_cpus_migrations,
     NULL };
 
 int main(int argc, char *argv[])
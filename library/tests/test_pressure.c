@@ -0,0 +1,176 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the pressure library calls, using synthetic pressure files
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+// the library source is included here, but reading our own files
+static char pressure_dir[64];
+static char cgroup_dir[64];
+#define PRESSURE_DIR  pressure_dir
+#define CGROUP_DIR    cgroup_dir
+#include "../pressure.c"
+
+#include "tests.h"
+
+static char tmp_dir[] = "/tmp/test_pressure.XXXXXX";
+
+static enum pressure_item items[] = {
+    PRESSURE_CPU_SOME_TOTAL, PRESSURE_DELTA_CPU_SOME_TOTAL, PRESSURE_DELTA_IO_FULL_TOTAL,
+    PRESSURE_DELTA_IRQ_FULL_TOTAL, PRESSURE_DELTA_ELAPSED, PRESSURE_DELTA_MEM_SOME_PCT };
+enum rel_items {
+    cpu_TOT, cpu_DEL, io_DEL, irq_DEL, elapsed, mem_PCT };
+
+        /*
+         * Write one of those files, with 'total' as its some total and
+         * half that as its full total (irq being all of the latter). */
+static int write_psi (const char *dir, const char *name, const char *suffix, unsigned long long total)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/%s%s", dir, name, suffix);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    if (strcmp(name, "irq"))
+        fprintf(fp, "some avg10=7.71 avg60=26.97 avg300=14.78 total=%llu\n", total);
+    fprintf(fp, "full avg10=0.05 avg60=100.00 avg300=0.00 total=%llu\n", total / 2);
+    return (fclose(fp) == 0);
+}
+
+static int write_all (const char *dir, const char *suffix, unsigned long long total)
+{
+    return write_psi(dir, "cpu", suffix, total)
+        && write_psi(dir, "io", suffix, total)
+        && write_psi(dir, "memory", suffix, total);
+}
+
+int check_pressure_values (void *data)
+{
+    struct pressure_info *info = NULL;
+    int rc;
+
+    testname = "pressure values, without an irq file";
+    if (!write_all(pressure_dir, "", 411012497ULL))
+        return 0;
+    if (procps_pressure_new(&info) < 0)
+        return 0;
+    rc = (PRESSURE_GET(info, PRESSURE_CPU_SOME_AVG10, real) == 7.71
+        && PRESSURE_GET(info, PRESSURE_CPU_SOME_AVG60, real) == 26.97
+        && PRESSURE_GET(info, PRESSURE_IO_SOME_AVG300, real) == 14.78
+        && PRESSURE_GET(info, PRESSURE_MEM_FULL_AVG10, real) == 0.05
+        && PRESSURE_GET(info, PRESSURE_MEM_FULL_AVG60, real) == 100.0
+        && PRESSURE_GET(info, PRESSURE_CPU_SOME_TOTAL, ull_int) == 411012497ULL
+        && PRESSURE_GET(info, PRESSURE_IO_FULL_TOTAL, ull_int) == 411012497ULL / 2
+        && PRESSURE_GET(info, PRESSURE_IRQ_FULL_TOTAL, ull_int) == 0);
+    procps_pressure_unref(&info);
+    return rc;
+}
+
+int check_pressure_deltas (void *data)
+{
+    struct pressure_info *info = NULL;
+    struct pressure_stack *stack;
+    int rc;
+
+    testname = "pressure deltas, with an irq file appearing late";
+    if (!write_all(pressure_dir, "", 1000000ULL))
+        return 0;
+    if (procps_pressure_new(&info) < 0)
+        return 0;
+    // that irq file was absent when we began, so it is never looked at
+    if (!write_all(pressure_dir, "", 1000000ULL + 2000)
+    || !write_psi(pressure_dir, "irq", "", 5000))
+        return 0;
+    usleep(10000);
+    if (!(stack = procps_pressure_select(info, items, MAXTABLE(items))))
+        return 0;
+    rc = (PRESSURE_VAL(cpu_TOT, ull_int, stack) == 1002000ULL
+        && PRESSURE_VAL(cpu_DEL, ull_int, stack) == 2000
+        && PRESSURE_VAL(io_DEL, ull_int, stack) == 1000
+        && PRESSURE_VAL(irq_DEL, ull_int, stack) == 0
+        && PRESSURE_VAL(elapsed, real, stack) >= 0.01
+        && PRESSURE_VAL(mem_PCT, real, stack) > 0.0
+        && PRESSURE_VAL(mem_PCT, real, stack) <= 20.0);
+    // and no change at all, means nothing stalled
+    if (rc && (stack = procps_pressure_select(info, items, MAXTABLE(items))))
+        rc = (PRESSURE_VAL(cpu_DEL, ull_int, stack) == 0
+            && PRESSURE_VAL(mem_PCT, real, stack) == 0.0);
+    procps_pressure_unref(&info);
+    return rc && stack;
+}
+
+int check_pressure_cgroup (void *data)
+{
+    struct pressure_info *info = NULL;
+    char path[128];
+    int rc;
+
+    testname = "pressure for a cgroup, then one that is missing";
+    snprintf(path, sizeof(path), "%s/system.slice", cgroup_dir);
+    if (mkdir(path, 0700) < 0 || !write_all(path, ".pressure", 12345))
+        return 0;
+    if (procps_pressure_new_cgroup(&info, "/system.slice") < 0)
+        return 0;
+    rc = (PRESSURE_GET(info, PRESSURE_MEM_SOME_TOTAL, ull_int) == 12345);
+    procps_pressure_unref(&info);
+    if (!rc || procps_pressure_new_cgroup(&info, "system.slice") < 0)
+        return 0;
+    procps_pressure_unref(&info);
+    return (procps_pressure_new_cgroup(&info, "/user.slice") == -ENOENT
+        && info == NULL);
+}
+
+int check_pressure_select_bad (void *data)
+{
+    struct pressure_info *info = NULL;
+    enum pressure_item bad[] = { PRESSURE_CPU_SOME_AVG10, 999 };
+    int rc;
+
+    testname = "procps_pressure_select() with a bad item";
+    if (procps_pressure_new(&info) < 0)
+        return 0;
+    rc = (procps_pressure_select(info, bad, MAXTABLE(bad)) == NULL
+        && errno == EINVAL);
+    procps_pressure_unref(&info);
+    return rc;
+}
+
+TestFunction test_funcs[] = {
+    check_pressure_values,
+    check_pressure_deltas,
+    check_pressure_cgroup,
+    check_pressure_select_bad,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(pressure_dir, sizeof(pressure_dir), "%s/pressure", tmp_dir);
+    snprintf(cgroup_dir, sizeof(cgroup_dir), "%s/cgroup", tmp_dir);
+    return (mkdir(pressure_dir, 0700) == 0 && mkdir(cgroup_dir, 0700) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
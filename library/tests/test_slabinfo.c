@@ -0,0 +1,212 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the slabinfo library calls, using a synthetic slabinfo file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// the library source is included here, but reading our own file
+static char slabinfo_file[64];
+#define SLABINFO_FILE  slabinfo_file
+#include "../slabinfo.c"
+
+#include "tests.h"
+
+#define NUM_CACHES      1000
+#define NUM_REAPS       50
+
+static char tmp_dir[] = "/tmp/test_slabinfo.XXXXXX";
+
+static enum slabinfo_item items[] = {
+    SLAB_NAME, SLAB_NUM_OBJS, SLAB_ACTIVE_SLABS, SLAB_NUMS_SLABS,
+    SLAB_DELTA_NUM_OBJS, SLAB_DELTA_ACTIVE_SLABS, SLAB_DELTA_SIZE_TOTAL };
+enum rel_items {
+    name, objs, aslabs, slabs, objs_DEL, aslabs_DEL, size_DEL };
+
+        /*
+         * Write that file, with caches 'first' through 'last' (newest first,
+         * as the kernel would), each having 'objs' + its number objects. */
+static int write_slabinfo (int first, int last, unsigned objs, int stats)
+{
+    FILE *fp;
+    int c;
+
+    if (!(fp = fopen(slabinfo_file, "w")))
+        return 0;
+    fprintf(fp, "slabinfo - version: 2.1%s\n", stats ? " (statistics)" : "");
+    fprintf(fp, "# name            <active_objs> <num_objs> <objsize> <objperslab> <pagesperslab>"
+        " : tunables <limit> <batchcount> <sharedfactor> : slabdata <active_slabs> <num_slabs> <sharedavail>\n");
+    for (c = last; c >= first; c--) {
+        fprintf(fp, "cache-%-12d %6u %6u %6d %4d %4d : tunables %4d %4d %4d : slabdata %6u %6u %6d"
+            , c, objs + c, objs + c, 64, 64, 1, 0, 0, 0, (objs + c) / 64, (objs + c) / 64 + 1, 0);
+        if (stats)
+            fprintf(fp, " : globalstat %7d %6d %5d %4d %4d %4d %4d %4d %4d : cpustat %6d %6d %6d %6d"
+                , 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13);
+        fputc('\n', fp);
+    }
+    return (fclose(fp) == 0);
+}
+
+int check_slabinfo_values (void *data)
+{
+    struct slabinfo_info *info = NULL;
+    int rc;
+
+    testname = "slabinfo values, with the statistics extensions";
+    if (!write_slabinfo(1, 3, 640, 1))
+        return 0;
+    if (procps_slabinfo_new(&info) < 0)
+        return 0;
+    rc = (SLABINFO_GET(info, SLABS_CACHES_TOTAL, u_int) == 3
+        && SLABINFO_GET(info, SLABS_NUM_OBJS, u_int) == 641 + 642 + 643
+        && SLABINFO_GET(info, SLABS_NUMS_SLABS, u_int) == 11 * 3
+        && SLABINFO_GET(info, SLABS_ACTIVE_SLABS, u_int) == 10 * 3
+        && SLABINFO_GET(info, SLABS_OBJ_SIZE_MAX, u_int) == 64);
+    procps_slabinfo_unref(&info);
+    return rc;
+}
+
+int check_slabinfo_version (void *data)
+{
+    struct slabinfo_info *info = NULL;
+    FILE *fp;
+
+    testname = "slabinfo version 1.1 is rejected";
+    if (!(fp = fopen(slabinfo_file, "w")))
+        return 0;
+    fprintf(fp, "slabinfo - version: 1.1\n");
+    if (fclose(fp) != 0)
+        return 0;
+    return (procps_slabinfo_new(&info) == -ERANGE && info == NULL);
+}
+
+int check_slabinfo_deltas (void *data)
+{
+    struct slabinfo_info *info = NULL;
+    struct slabinfo_reaped *reaped;
+    struct slabinfo_stack *stack;
+    int i, rc = 1;
+
+    testname = "slabinfo deltas, as caches come and go";
+    if (!write_slabinfo(1, 5, 1000, 0))
+        return 0;
+    if (procps_slabinfo_new(&info) < 0)
+        return 0;
+    // cache-6 is new (and listed first), the others grow by 128 objects
+    if (!write_slabinfo(1, 6, 1128, 0))
+        return 0;
+    if (!(reaped = procps_slabinfo_reap(info, items, MAXTABLE(items))))
+        return 0;
+    for (i = 0; i < reaped->total; i++) {
+        stack = reaped->stacks[i];
+        if (!strcmp(SLABINFO_VAL(name, str, stack), "cache-6"))
+            rc &= (SLABINFO_VAL(objs_DEL, s_int, stack) == 0
+                && SLABINFO_VAL(size_DEL, sl_int, stack) == 0);
+        else
+            rc &= (SLABINFO_VAL(objs_DEL, s_int, stack) == 128
+                && SLABINFO_VAL(aslabs_DEL, s_int, stack) == 2
+                && SLABINFO_VAL(size_DEL, sl_int, stack) == 2L * getpagesize());
+    }
+    rc &= (reaped->total == 6);
+    // now those 4 newest are gone, with the 2 remaining shrinking back
+    if (!write_slabinfo(1, 2, 1000, 0)
+    || !(reaped = procps_slabinfo_reap(info, items, MAXTABLE(items))))
+        rc = 0;
+    else
+        rc &= (reaped->total == 2
+            && SLABINFO_VAL(objs_DEL, s_int, reaped->stacks[0]) == -128
+            && SLABINFO_VAL(objs_DEL, s_int, reaped->stacks[1]) == -128);
+    procps_slabinfo_unref(&info);
+    return rc;
+}
+
+int check_slabinfo_reordered (void *data)
+{
+    struct slabinfo_info *info = NULL;
+    struct slabinfo_reaped *reaped;
+    FILE *fp;
+    int c, rc = 1;
+
+    testname = "slabinfo deltas, with the caches listed oldest first";
+    if (!write_slabinfo(1, 5, 1000, 0))
+        return 0;
+    if (procps_slabinfo_new(&info) < 0)
+        return 0;
+    // the same caches, each grown by 128 objects, but in reverse order
+    if (!write_slabinfo(1, 0, 0, 0)
+    || !(fp = fopen(slabinfo_file, "a")))
+        return 0;
+    for (c = 1; c <= 5; c++)
+        fprintf(fp, "cache-%-12d %6u %6u %6d %4d %4d : tunables %4d %4d %4d : slabdata %6u %6u %6d\n"
+            , c, 1128 + c, 1128 + c, 64, 64, 1, 0, 0, 0, (1128 + c) / 64, (1128 + c) / 64 + 1, 0);
+    if (fclose(fp) != 0
+    || !(reaped = procps_slabinfo_reap(info, items, MAXTABLE(items)))
+    || reaped->total != 5)
+        rc = 0;
+    for (c = 0; rc && c < reaped->total; c++)
+        rc = (SLABINFO_VAL(objs_DEL, s_int, reaped->stacks[c]) == 128);
+    procps_slabinfo_unref(&info);
+    return rc;
+}
+
+int check_slabinfo_many (void *data)
+{
+    struct slabinfo_info *info = NULL;
+    struct slabinfo_reaped *reaped = NULL;
+    int i, rc = 1;
+
+    testname = "slabinfo reaps, for " STRINGIFY(NUM_CACHES) " caches";
+    if (!write_slabinfo(1, NUM_CACHES, 0, 0))
+        return 0;
+    if (procps_slabinfo_new(&info) < 0)
+        return 0;
+    for (i = 0; i < NUM_REAPS && rc; i++) {
+        if (!(reaped = procps_slabinfo_reap(info, items, MAXTABLE(items))))
+            rc = 0;
+    }
+    if (rc) {
+        rc = (reaped->total == NUM_CACHES
+            && !strcmp(SLABINFO_VAL(name, str, reaped->stacks[0]), "cache-" STRINGIFY(NUM_CACHES))
+            && SLABINFO_VAL(objs, u_int, reaped->stacks[0]) == NUM_CACHES
+            && SLABINFO_VAL(objs_DEL, s_int, reaped->stacks[0]) == 0
+            && info->nodes_alloc < NUM_CACHES + NODES_INCR);
+    }
+    procps_slabinfo_unref(&info);
+    return rc;
+}
+
+TestFunction test_funcs[] = {
+    check_slabinfo_values,
+    check_slabinfo_version,
+    check_slabinfo_deltas,
+    check_slabinfo_reordered,
+    check_slabinfo_many,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(slabinfo_file, sizeof(slabinfo_file), "%s/slabinfo", tmp_dir);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
@@ -0,0 +1,191 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the mergesort_r (natural mergesort) used by all sort calls
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "sort.h"
+#include "tests.h"
+
+#define NUM_ELEMENTS  5000
+#define NUM_FRAMES    50
+
+struct elem {
+    int key;            // what we sort on
+    int pid;            // a task's identity
+    int seq;            // original position, for stability checks
+};
+
+static struct elem elems[NUM_ELEMENTS];
+static struct elem *ptrs[NUM_ELEMENTS];
+static unsigned long compares;
+
+static int elem_cmp (const void *a, const void *b, void *arg)
+{
+    const struct elem *A = *(struct elem **)a, *B = *(struct elem **)b;
+
+    (void)arg;
+    compares++;
+    return (A->key > B->key) - (A->key < B->key);
+}
+
+static void elem_fill (int mod)
+{
+    int i;
+
+    for (i = 0; i < NUM_ELEMENTS; i++) {
+        elems[i].key = mod ? rand() % mod : 0;
+        elems[i].pid = i + 1;
+        ptrs[i] = &elems[i];
+    }
+}
+
+static void elem_sequence (void)
+{
+    int i;
+
+    for (i = 0; i < NUM_ELEMENTS; i++)
+        ptrs[i]->seq = i;
+}
+
+static int elem_verify (void)
+{
+    int i;
+
+    for (i = 1; i < NUM_ELEMENTS; i++) {
+        if (ptrs[i - 1]->key > ptrs[i]->key)
+            return 0;
+        if (ptrs[i - 1]->key == ptrs[i]->key
+        && ptrs[i - 1]->seq > ptrs[i]->seq)
+            return 0;
+    }
+    return 1;
+}
+
+int check_sort_random (void *data)
+{
+    testname = "mergesort_r() random, with duplicates";
+    elem_fill(100);
+    elem_sequence();
+    if (!mergesort_r(ptrs, NUM_ELEMENTS, elem_cmp, NULL))
+        return 0;
+    return elem_verify();
+}
+
+int check_sort_descending (void *data)
+{
+    int i;
+
+    testname = "mergesort_r() descending, with duplicates";
+    elem_fill(0);
+    for (i = 0; i < NUM_ELEMENTS; i++)
+        elems[i].key = (NUM_ELEMENTS - i) / 3;
+    elem_sequence();
+    if (!mergesort_r(ptrs, NUM_ELEMENTS, elem_cmp, NULL))
+        return 0;
+    return elem_verify();
+}
+
+int check_sort_sorted (void *data)
+{
+    int i;
+
+    testname = "mergesort_r() already sorted, n - 1 compares";
+    elem_fill(0);
+    for (i = 0; i < NUM_ELEMENTS; i++)
+        elems[i].key = i / 2;
+    elem_sequence();
+    compares = 0;
+    if (!mergesort_r(ptrs, NUM_ELEMENTS, elem_cmp, NULL))
+        return 0;
+    return (elem_verify() && compares == NUM_ELEMENTS - 1);
+}
+
+/*
+ * A simple benchmark, mimicking successive top frames where just
+ * a few tasks change their sort value. Each frame is sorted twice,
+ * once from /proc (pid) order and once seeded with the prior order.
+ */
+int check_sort_frames (void *data)
+{
+    static struct elem *prior[NUM_ELEMENTS];
+    struct timespec beg, end;
+    unsigned long cmp_pid = 0, cmp_seed = 0;
+    double ns_pid = 0, ns_seed = 0;
+    int f, i;
+
+    testname = "mergesort_r() successive frames, seeded vs. unseeded";
+    srand(1);
+    elem_fill(1000);
+    for (i = 0; i < NUM_ELEMENTS; i++)
+        prior[i] = ptrs[i];
+
+    for (f = 0; f < NUM_FRAMES; f++) {
+        // about 2% of the tasks change their sort value in each frame
+        for (i = 0; i < NUM_ELEMENTS / 50; i++)
+            elems[rand() % NUM_ELEMENTS].key = rand() % 1000;
+
+        for (i = 0; i < NUM_ELEMENTS; i++)
+            ptrs[i] = &elems[i];
+        elem_sequence();
+        compares = 0;
+        clock_gettime(CLOCK_MONOTONIC, &beg);
+        if (!mergesort_r(ptrs, NUM_ELEMENTS, elem_cmp, NULL))
+            return 0;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (!elem_verify())
+            return 0;
+        cmp_pid += compares;
+        ns_pid += (end.tv_sec - beg.tv_sec) * 1.0e9 + (end.tv_nsec - beg.tv_nsec);
+
+        for (i = 0; i < NUM_ELEMENTS; i++)
+            ptrs[i] = prior[i];
+        elem_sequence();
+        compares = 0;
+        clock_gettime(CLOCK_MONOTONIC, &beg);
+        if (!mergesort_r(ptrs, NUM_ELEMENTS, elem_cmp, NULL))
+            return 0;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (!elem_verify())
+            return 0;
+        cmp_seed += compares;
+        ns_seed += (end.tv_sec - beg.tv_sec) * 1.0e9 + (end.tv_nsec - beg.tv_nsec);
+
+        for (i = 0; i < NUM_ELEMENTS; i++)
+            prior[i] = ptrs[i];
+    }
+    printf("%d tasks, per frame: unseeded %lu compares %.1f us, seeded %lu compares %.1f us\n"
+        , NUM_ELEMENTS
+        , cmp_pid / NUM_FRAMES, ns_pid / NUM_FRAMES / 1000.0
+        , cmp_seed / NUM_FRAMES, ns_seed / NUM_FRAMES / 1000.0);
+    return (cmp_seed < cmp_pid);
+}
+
+TestFunction test_funcs[] = {
+    check_sort_random,
+    check_sort_descending,
+    check_sort_sorted,
+    check_sort_frames,
+    NULL,
+};
+
+int main(int argc, char *argv[])
+{
+    return run_tests(test_funcs, NULL);
+}
@@ -0,0 +1,143 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the stat library calls, using a synthetic stat file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// the library source is included here, but reading our own file
+static char stat_file[64];
+#define STAT_FILE  stat_file
+#include "../stat.c"
+
+#include "tests.h"
+
+#define NUM_REAPS    200
+#define IRQS_PER_CPU 8                 // plus 256 more, for the 'intr' line
+
+static char tmp_dir[] = "/tmp/test_stat.XXXXXX";
+
+/*
+ * A /proc/stat look-alike, where cpu N has user jiffies of N * 10 + tics
+ * (with cpu 1 offline) and where the 'intr' line grows with the cpus.
+ */
+static int write_stat (int num_cpus, int tics)
+{
+    FILE *fp;
+    int c, i;
+
+    if (!(fp = fopen(stat_file, "w")))
+        return 0;
+    fprintf(fp, "cpu  %d 2 3 4 5 6 7 8 0 0\n", num_cpus * tics);
+    for (c = 0; c < num_cpus; c++) {
+        if (c == 1)
+            continue;
+        fprintf(fp, "cpu%d %d 2 3 4 5 6 7 8 9 10\n", c, c * 10 + tics);
+    }
+    fprintf(fp, "intr %d", 123456 + tics);
+    for (i = 0; i < 256 + num_cpus * IRQS_PER_CPU; i++)
+        fprintf(fp, " %d", i % 7 ? 0 : i * 31);
+    fprintf(fp, "\nctxt %d\nbtime 1700000000\nprocesses 4321\n"
+                "procs_running 3\nprocs_blocked 1\n"
+                "softirq 98765 1 2 3 4 5 6 7 8 9 10\n", 7654321 + tics);
+    return (fclose(fp) == 0);
+}
+
+int check_stat_values (void *data)
+{
+    enum stat_item items[] = { STAT_TIC_ID, STAT_TIC_USER, STAT_TIC_GUEST_NICE, STAT_TIC_DELTA_USER };
+    struct stat_info *info = NULL;
+    struct stat_reaped *reaped;
+    int i, ok;
+
+    testname = "stat values, cpu and system lines";
+    if (!write_stat(8, 0) || procps_stat_new(&info) < 0)
+        return 0;
+    ok = (STAT_GET(info, STAT_SYS_INTERRUPTS, ul_int) == 123456
+        && STAT_GET(info, STAT_SYS_CTX_SWITCHES, ul_int) == 7654321
+        && STAT_GET(info, STAT_SYS_TIME_OF_BOOT, ul_int) == 1700000000
+        && STAT_GET(info, STAT_SYS_PROC_CREATED, ul_int) == 4321
+        && STAT_GET(info, STAT_SYS_PROC_RUNNING, ul_int) == 2
+        && STAT_GET(info, STAT_SYS_PROC_BLOCKED, ul_int) == 1
+        && write_stat(8, 5)
+        && (reaped = procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 4))
+        && reaped->cpus->total == 7
+        && STAT_VAL(1, ull_int, reaped->summary) == 40
+        && STAT_VAL(2, ull_int, reaped->summary) == 0);
+    for (i = 0; ok && i < reaped->cpus->total; i++) {
+        struct stat_stack *stack = reaped->cpus->stacks[i];
+        int id = STAT_VAL(0, s_int, stack);
+        if (id == 1
+        || STAT_VAL(1, ull_int, stack) != id * 10ULL + 5
+        || STAT_VAL(2, ull_int, stack) != 10
+        || STAT_VAL(3, sl_int, stack) != 5)
+            ok = 0;
+    }
+    procps_stat_unref(&info);
+    return ok;
+}
+
+/*
+ * A simple benchmark, the cost of a reap (a read plus a parse of the
+ * whole file) for some synthetic files with ever more cpus and irqs.
+ * It's run only when asked for, see tests_bench.
+ */
+int check_stat_bench (void *data)
+{
+    enum stat_item items[] = { STAT_TIC_ID, STAT_TIC_DELTA_USER, STAT_TIC_DELTA_SYSTEM };
+    static const int cpus[] = { 8, 128, 512 };
+    struct stat_info *info = NULL;
+    struct timespec beg, end;
+    size_t c;
+    int i;
+
+    testname = "stat benchmark, 8, 128 & 512 cpus (only with TESTS_BENCH)";
+    if (!tests_bench())
+        return 1;
+    for (c = 0; c < sizeof(cpus) / sizeof(cpus[0]); c++) {
+        if (!write_stat(cpus[c], 0) || procps_stat_new(&info) < 0)
+            return 0;
+        clock_gettime(CLOCK_MONOTONIC, &beg);
+        for (i = 0; i < NUM_REAPS; i++)
+            if (!procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 3))
+                return 0;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%d cpus: per reap %.1f us\n", cpus[c]
+            , ((end.tv_sec - beg.tv_sec) * 1.0e9 + (end.tv_nsec - beg.tv_nsec)) / 1000.0 / NUM_REAPS);
+        procps_stat_unref(&info);
+    }
+    return 1;
+}
+
+TestFunction test_funcs[] = {
+    check_stat_values,
+    check_stat_bench,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(stat_file, sizeof(stat_file), "%s/stat", tmp_dir);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
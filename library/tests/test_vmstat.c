@@ -0,0 +1,203 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for the vmstat library calls, using a synthetic vmstat file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+// the library sources are included here, but reading our own files
+static char vmstat_file[64];
+static char node_dir[64];
+#define VMSTAT_FILE  vmstat_file
+#define NODE_DIR     node_dir
+#include "../vmstat.c"
+#include "../numa.c"
+
+#include "tests.h"
+
+#define NUM_SELECTS  20000
+
+static char tmp_dir[] = "/tmp/test_vmstat.XXXXXX";
+
+/*
+ * Every name in our table, each with its own value, interleaved
+ * with names we don't know and ending without a newline.
+ */
+static int write_vmstat (void)
+{
+    FILE *fp;
+    int i, n = 0;
+
+    if (!(fp = fopen(vmstat_file, "w")))
+        return 0;
+    fprintf(fp, "nr_unknown_before 1\n");
+    for (i = 0; i < VMSTAT_TABLE_SIZE; i++) {
+        if (!vmstat_table[i].len)
+            continue;
+        fprintf(fp, "%s %d\n", vmstat_table[i].name, 1000 + i);
+        if (++n % 10 == 0)
+            fprintf(fp, "%s_unknown %d\n", vmstat_table[i].name, i);
+    }
+    fprintf(fp, "nr_unknown_after 2");
+    return (fclose(fp) == 0);
+}
+
+int check_vmstat_table (void *data)
+{
+    int i, n = 0;
+
+    testname = "vmstat perfect hash, every name in its own entry";
+    for (i = 0; i < VMSTAT_TABLE_SIZE; i++) {
+        if (!vmstat_table[i].len)
+            continue;
+        if (vmstat_table[i].len != strlen(vmstat_table[i].name)
+        || vmstat_hash(vmstat_table[i].name, vmstat_table[i].len) != (unsigned)i)
+            return 0;
+        ++n;
+    }
+    // that table is missing only the 'derived' field(s), if any
+    return (n == sizeof(struct vmstat_data) / sizeof(unsigned long));
+}
+
+int check_vmstat_values (void *data)
+{
+    struct vmstat_info *info = NULL;
+    int i, ok = 1;
+
+    testname = "vmstat values, every field (with unknowns ignored)";
+    if (!write_vmstat() || procps_vmstat_new(&info) < 0)
+        return 0;
+    for (i = 0; ok && i < VMSTAT_TABLE_SIZE; i++) {
+        if (!vmstat_table[i].len)
+            continue;
+        if (*(unsigned long *)((char *)&info->hist.new + vmstat_table[i].offset) != 1000UL + i)
+            ok = 0;
+    }
+    ok = (ok && VMSTAT_GET(info, VMSTAT_PGFAULT, ul_int) == 1000UL + vmstat_hash("pgfault", 7));
+    procps_vmstat_unref(&info);
+    return ok;
+}
+
+/*
+ * A node's vmstat, just a few fields of those the kernel provides.
+ */
+static int write_node (int node, unsigned long free_pages, unsigned long hits)
+{
+    char path[128];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/node%d", node_dir, node);
+    if (mkdir(path, 0700) < 0 && errno != EEXIST)
+        return 0;
+    snprintf(path, sizeof(path), "%s/node%d/vmstat", node_dir, node);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    fprintf(fp, "nr_free_pages %lu\nnr_zone_inactive_anon 5\nnuma_hit %lu\n", free_pages, hits);
+    return (fclose(fp) == 0);
+}
+
+int check_vmstat_nodes (void *data)
+{
+    enum vmstat_item items[] = {
+        VMSTAT_NODE_ID, VMSTAT_NR_FREE_PAGES, VMSTAT_DELTA_NR_FREE_PAGES, VMSTAT_NUMA_HIT };
+    struct vmstat_info *info = NULL;
+    struct vmstat_reaped *reaped;
+    char path[128];
+    FILE *fp;
+    int ok;
+
+    testname = "vmstat nodes, reaped then sorted and selected";
+    snprintf(path, sizeof(path), "%s/online", node_dir);
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    fprintf(fp, "0-1\n");
+    if (fclose(fp) != 0
+    || !write_node(0, 500, 10) || !write_node(1, 800, 20)
+    || procps_vmstat_new(&info) < 0)
+        return 0;
+    ok = ((reaped = procps_vmstat_reap(info, items, 4))
+        && reaped->total == 2
+        && VMSTAT_VAL(0, s_int, reaped->stacks[1]) == 1
+        && VMSTAT_VAL(1, ul_int, reaped->stacks[0]) == 500
+        && VMSTAT_VAL(3, ul_int, reaped->stacks[1]) == 20);
+    ok = (ok && write_node(1, 700, 25)
+        && (reaped = procps_vmstat_reap(info, items, 4))
+        && VMSTAT_VAL(2, sl_int, reaped->stacks[1]) == -100
+        && procps_vmstat_sort(info, reaped->stacks, reaped->total, VMSTAT_DELTA_NR_FREE_PAGES, VMSTAT_SORT_ASCEND)
+        && VMSTAT_VAL(0, s_int, reaped->stacks[0]) == 1);
+    ok = (ok && procps_vmstat_select_node(info, 0, items, 4)
+        && VMSTAT_VAL(1, ul_int, procps_vmstat_select_node(info, 0, items, 4)) == 500
+        && VMSTAT_VAL(0, s_int, procps_vmstat_select(info, items, 4)) == -1);
+    procps_vmstat_unref(&info);
+    return ok;
+}
+
+/*
+ * A simple benchmark, the cost of a select (a read plus a parse of the
+ * whole file) for both that synthetic file and the real /proc/vmstat.
+ * It's run only when asked for, see tests_bench.
+ */
+int check_vmstat_bench (void *data)
+{
+    enum vmstat_item items[] = { VMSTAT_PGFAULT, VMSTAT_DELTA_PGFAULT };
+    struct vmstat_info *info = NULL;
+    struct timespec beg, end;
+    int i, pass;
+
+    testname = "vmstat benchmark, procps_vmstat_select (only with TESTS_BENCH)";
+    if (!tests_bench())
+        return 1;
+    for (pass = 0; pass < 2; pass++) {
+        if (pass)
+            strcpy(vmstat_file, "/proc/vmstat");
+        if (procps_vmstat_new(&info) < 0)
+            return pass;               // a missing /proc/vmstat is not our problem
+        clock_gettime(CLOCK_MONOTONIC, &beg);
+        for (i = 0; i < NUM_SELECTS; i++)
+            if (!procps_vmstat_select(info, items, 2))
+                return 0;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%s: per select %.2f us\n", vmstat_file
+            , ((end.tv_sec - beg.tv_sec) * 1.0e9 + (end.tv_nsec - beg.tv_nsec)) / 1000.0 / NUM_SELECTS);
+        procps_vmstat_unref(&info);
+    }
+    return 1;
+}
+
+TestFunction test_funcs[] = {
+    check_vmstat_table,
+    check_vmstat_values,
+    check_vmstat_nodes,
+    check_vmstat_bench,
+    NULL,
+};
+
+static int setup_files (void)
+{
+    snprintf(vmstat_file, sizeof(vmstat_file), "%s/vmstat", tmp_dir);
+    snprintf(node_dir, sizeof(node_dir), "%s/node", tmp_dir);
+    return (mkdir(node_dir, 0700) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    return run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+}
@@ -24,7 +24,8 @@
 
 #include <errno.h>
 #include <fcntl.h>
-#include <search.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -34,13 +35,22 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "numa.h"
+#include "sort.h"
+
 #include "procps-private.h"
 #include "vmstat.h"
 
 
+#ifndef VMSTAT_FILE
 #define VMSTAT_FILE  "/proc/vmstat"
+#endif
 #define VMSTAT_BUFF  8192
 
+#ifndef NODE_DIR
+#define NODE_DIR     "/sys/devices/system/node"
+#endif
+
 /* ------------------------------------------------------------- +
    this provision can be used to help ensure that our Item_table |
    was synchronized with the enumerators found in the associated |
@@ -219,6 +229,15 @@ struct vmstat_data {
 struct vmstat_hist {
     struct vmstat_data new;
     struct vmstat_data old;
+    unsigned long long new_ns;         // CLOCK_MONOTONIC when 'new' was read
+    unsigned long long old_ns;         //  "  'old' (zero before a 2nd read)
+    int node_id;                       // numa node, or -1 for /proc/vmstat
+};
+
+struct vmstat_node {
+    int fd;                            // its nodeN/vmstat, else -1
+    int primed;                        // has 'hist' seen a prior read
+    struct vmstat_hist hist;
 };
 
 struct stacks_extent {
@@ -227,14 +246,21 @@ struct stacks_extent {
     struct vmstat_stack **stacks;
 };
 
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum vmstat_item *items;           // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for these extents
+};
+
 struct vmstat_info {
     int refcount;
     int vmstat_fd;
     struct vmstat_hist hist;
-    int numitems;
-    enum vmstat_item *items;
-    struct stacks_extent *extents;
-    struct hsearch_data hashtab;
+    struct ext_support select;         // support for 'procps_vmstat_select()'
+    struct ext_support nodes;          // support for 'procps_vmstat_reap()'
+    struct vmstat_reaped reaped;       // for return to caller after a reap
+    struct vmstat_node *node_hist;     // per node history, by node number
+    int node_alloc;                    // number of node_hist allocated
     struct vmstat_result get_this;
     time_t sav_secs;
 };
@@ -250,6 +276,10 @@ struct vmstat_info {
 #define REG_set(e,x) setDECL(e) { R->result.ul_int = H->new. x; }
 // delta assignment
 #define HST_set(e,x) setDECL(e) { R->result.sl_int = ( H->new. x - H->old. x ); }
+// rate assignment
+#define HST_rate(e,x) setDECL(e) { \
+    unsigned long long ns = H->old_ns ? H->new_ns - H->old_ns : 0; \
+    R->result.real = ns ? ( H->new. x - H->old. x ) * 1.0e9 / ns : 0.0; }
 
 setDECL(noop)  { (void)R; (void)H; }
 setDECL(extra) { (void)H; R->result.ul_int = 0; }
@@ -558,9 +588,79 @@ HST_set(DELTA_WORKINGSET_REFAULT,              workingset_refault)
 HST_set(DELTA_WORKINGSET_RESTORE,              workingset_restore)
 HST_set(DELTA_ZONE_RECLAIM_FAILED,             zone_reclaim_failed)
 
+setDECL(DELTA_ELAPSED) { R->result.real = H->old_ns ? ( H->new_ns - H->old_ns ) / 1.0e9 : 0.0; }
+HST_rate(DELTA_PGPGIN_PER_SEC,                  pgpgin)
+HST_rate(DELTA_PGPGOUT_PER_SEC,                 pgpgout)
+HST_rate(DELTA_PSWPIN_PER_SEC,                  pswpin)
+HST_rate(DELTA_PSWPOUT_PER_SEC,                 pswpout)
+HST_rate(DELTA_PGFAULT_PER_SEC,                 pgfault)
+HST_rate(DELTA_PGMAJFAULT_PER_SEC,              pgmajfault)
+HST_rate(DELTA_PGFREE_PER_SEC,                  pgfree)
+HST_rate(DELTA_PGSCAN_KSWAPD_PER_SEC,           pgscan_kswapd)
+HST_rate(DELTA_PGSCAN_DIRECT_PER_SEC,           pgscan_direct)
+HST_rate(DELTA_PGSTEAL_KSWAPD_PER_SEC,          pgsteal_kswapd)
+HST_rate(DELTA_PGSTEAL_DIRECT_PER_SEC,          pgsteal_direct)
+HST_rate(DELTA_ALLOCSTALL_NORMAL_PER_SEC,       allocstall_normal)
+HST_rate(DELTA_COMPACT_STALL_PER_SEC,           compact_stall)
+HST_rate(DELTA_OOM_KILL_PER_SEC,                oom_kill)
+HST_rate(DELTA_THP_FAULT_ALLOC_PER_SEC,         thp_fault_alloc)
+HST_rate(DELTA_WORKINGSET_REFAULT_PER_SEC,      workingset_refault)
+
+setDECL(NODE_ID) { R->result.s_int = H->node_id; }
+
 #undef setDECL
 #undef REG_set
 #undef HST_set
+#undef HST_rate
+
+
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum vmstat_sort_order order;
+};
+
+#define srtNAME(t) sort_vmstat_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct vmstat_stack **A, const struct vmstat_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct vmstat_result *a = (*A)->head + P->offset; \
+    const struct vmstat_result *b = (*B)->head + P->offset; \
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(sl_int) {
+    const struct vmstat_result *a = (*A)->head + P->offset; \
+    const struct vmstat_result *b = (*B)->head + P->offset; \
+    if ( a->result.sl_int > b->result.sl_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.sl_int < b->result.sl_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(ul_int) {
+    const struct vmstat_result *a = (*A)->head + P->offset; \
+    const struct vmstat_result *b = (*B)->head + P->offset; \
+    if ( a->result.ul_int > b->result.ul_int ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.ul_int < b->result.ul_int ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(real) {
+    const struct vmstat_result *a = (*A)->head + P->offset; \
+    const struct vmstat_result *b = (*B)->head + P->offset; \
+    if ( a->result.real > b->result.real ) return P->order > 0 ?  1 : -1; \
+    if ( a->result.real < b->result.real ) return P->order > 0 ? -1 :  1; \
+    return 0;
+}
+
+srtDECL(noop) { \
+    (void)A; (void)B; (void)P; \
+    return 0;
+}
+
+#undef srtDECL
 
 
 // ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -572,6 +672,9 @@ typedef void (*SET_t)(struct vmstat_result *, struct vmstat_hist *);
 #define RS(e) (SET_t)setNAME(e)
 #endif
 
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
 #define TS(t) STRINGIFY(t)
 #define TS_noop ""
 
@@ -585,316 +688,337 @@ static struct {
     int   enumnumb;              // enumerator (must match position!)
     char *enum2str;              // enumerator name as a char* string
 #endif
+    QSR_t sortfunc;              // sort cmp func for a specific type
     char *type2str;              // the result type as a string value
 } Item_table[] = {
-/*  setsfunc                                   type2str
-    -----------------------------------------  ---------- */
-  { RS(noop),                                  TS_noop    },
-  { RS(extra),                                 TS_noop    },
-
-  { RS(ALLOCSTALL_DMA),                        TS(ul_int) },
-  { RS(ALLOCSTALL_DMA32),                      TS(ul_int) },
-  { RS(ALLOCSTALL_HIGH),                       TS(ul_int) },
-  { RS(ALLOCSTALL_MOVABLE),                    TS(ul_int) },
-  { RS(ALLOCSTALL_NORMAL),                     TS(ul_int) },
-  { RS(BALLOON_DEFLATE),                       TS(ul_int) },
-  { RS(BALLOON_INFLATE),                       TS(ul_int) },
-  { RS(BALLOON_MIGRATE),                       TS(ul_int) },
-  { RS(COMPACT_DAEMON_FREE_SCANNED),           TS(ul_int) },
-  { RS(COMPACT_DAEMON_MIGRATE_SCANNED),        TS(ul_int) },
-  { RS(COMPACT_DAEMON_WAKE),                   TS(ul_int) },
-  { RS(COMPACT_FAIL),                          TS(ul_int) },
-  { RS(COMPACT_FREE_SCANNED),                  TS(ul_int) },
-  { RS(COMPACT_ISOLATED),                      TS(ul_int) },
-  { RS(COMPACT_MIGRATE_SCANNED),               TS(ul_int) },
-  { RS(COMPACT_STALL),                         TS(ul_int) },
-  { RS(COMPACT_SUCCESS),                       TS(ul_int) },
-  { RS(DROP_PAGECACHE),                        TS(ul_int) },
-  { RS(DROP_SLAB),                             TS(ul_int) },
-  { RS(HTLB_BUDDY_ALLOC_FAIL),                 TS(ul_int) },
-  { RS(HTLB_BUDDY_ALLOC_SUCCESS),              TS(ul_int) },
-  { RS(KSWAPD_HIGH_WMARK_HIT_QUICKLY),         TS(ul_int) },
-  { RS(KSWAPD_INODESTEAL),                     TS(ul_int) },
-  { RS(KSWAPD_LOW_WMARK_HIT_QUICKLY),          TS(ul_int) },
-  { RS(NR_ACTIVE_ANON),                        TS(ul_int) },
-  { RS(NR_ACTIVE_FILE),                        TS(ul_int) },
-  { RS(NR_ANON_PAGES),                         TS(ul_int) },
-  { RS(NR_ANON_TRANSPARENT_HUGEPAGES),         TS(ul_int) },
-  { RS(NR_BOUNCE),                             TS(ul_int) },
-  { RS(NR_DIRTIED),                            TS(ul_int) },
-  { RS(NR_DIRTY),                              TS(ul_int) },
-  { RS(NR_DIRTY_BACKGROUND_THRESHOLD),         TS(ul_int) },
-  { RS(NR_DIRTY_THRESHOLD),                    TS(ul_int) },
-  { RS(NR_FILE_HUGEPAGES),                     TS(ul_int) },
-  { RS(NR_FILE_PAGES),                         TS(ul_int) },
-  { RS(NR_FILE_PMDMAPPED),                     TS(ul_int) },
-  { RS(NR_FOLL_PIN_ACQUIRED),                  TS(ul_int) },
-  { RS(NR_FOLL_PIN_RELEASED),                  TS(ul_int) },
-  { RS(NR_FREE_CMA),                           TS(ul_int) },
-  { RS(NR_FREE_PAGES),                         TS(ul_int) },
-  { RS(NR_INACTIVE_ANON),                      TS(ul_int) },
-  { RS(NR_INACTIVE_FILE),                      TS(ul_int) },
-  { RS(NR_ISOLATED_ANON),                      TS(ul_int) },
-  { RS(NR_ISOLATED_FILE),                      TS(ul_int) },
-  { RS(NR_KERNEL_MISC_RECLAIMABLE),            TS(ul_int) },
-  { RS(NR_KERNEL_STACK),                       TS(ul_int) },
-  { RS(NR_MAPPED),                             TS(ul_int) },
-  { RS(NR_MLOCK),                              TS(ul_int) },
-  { RS(NR_PAGE_TABLE_PAGES),                   TS(ul_int) },
-  { RS(NR_SHADOW_CALL_STACK),                  TS(ul_int) },
-  { RS(NR_SHMEM),                              TS(ul_int) },
-  { RS(NR_SHMEM_HUGEPAGES),                    TS(ul_int) },
-  { RS(NR_SHMEM_PMDMAPPED),                    TS(ul_int) },
-  { RS(NR_SLAB_RECLAIMABLE),                   TS(ul_int) },
-  { RS(NR_SLAB_UNRECLAIMABLE),                 TS(ul_int) },
-  { RS(NR_UNEVICTABLE),                        TS(ul_int) },
-  { RS(NR_UNSTABLE),                           TS(ul_int) },
-  { RS(NR_VMSCAN_IMMEDIATE_RECLAIM),           TS(ul_int) },
-  { RS(NR_VMSCAN_WRITE),                       TS(ul_int) },
-  { RS(NR_WRITEBACK),                          TS(ul_int) },
-  { RS(NR_WRITEBACK_TEMP),                     TS(ul_int) },
-  { RS(NR_WRITTEN),                            TS(ul_int) },
-  { RS(NR_ZONE_ACTIVE_ANON),                   TS(ul_int) },
-  { RS(NR_ZONE_ACTIVE_FILE),                   TS(ul_int) },
-  { RS(NR_ZONE_INACTIVE_ANON),                 TS(ul_int) },
-  { RS(NR_ZONE_INACTIVE_FILE),                 TS(ul_int) },
-  { RS(NR_ZONE_UNEVICTABLE),                   TS(ul_int) },
-  { RS(NR_ZONE_WRITE_PENDING),                 TS(ul_int) },
-  { RS(NR_ZSPAGES),                            TS(ul_int) },
-  { RS(NUMA_FOREIGN),                          TS(ul_int) },
-  { RS(NUMA_HINT_FAULTS),                      TS(ul_int) },
-  { RS(NUMA_HINT_FAULTS_LOCAL),                TS(ul_int) },
-  { RS(NUMA_HIT),                              TS(ul_int) },
-  { RS(NUMA_HUGE_PTE_UPDATES),                 TS(ul_int) },
-  { RS(NUMA_INTERLEAVE),                       TS(ul_int) },
-  { RS(NUMA_LOCAL),                            TS(ul_int) },
-  { RS(NUMA_MISS),                             TS(ul_int) },
-  { RS(NUMA_OTHER),                            TS(ul_int) },
-  { RS(NUMA_PAGES_MIGRATED),                   TS(ul_int) },
-  { RS(NUMA_PTE_UPDATES),                      TS(ul_int) },
-  { RS(OOM_KILL),                              TS(ul_int) },
-  { RS(PAGEOUTRUN),                            TS(ul_int) },
-  { RS(PGACTIVATE),                            TS(ul_int) },
-  { RS(PGALLOC_DMA),                           TS(ul_int) },
-  { RS(PGALLOC_DMA32),                         TS(ul_int) },
-  { RS(PGALLOC_HIGH),                          TS(ul_int) },
-  { RS(PGALLOC_MOVABLE),                       TS(ul_int) },
-  { RS(PGALLOC_NORMAL),                        TS(ul_int) },
-  { RS(PGDEACTIVATE),                          TS(ul_int) },
-  { RS(PGFAULT),                               TS(ul_int) },
-  { RS(PGFREE),                                TS(ul_int) },
-  { RS(PGINODESTEAL),                          TS(ul_int) },
-  { RS(PGLAZYFREE),                            TS(ul_int) },
-  { RS(PGLAZYFREED),                           TS(ul_int) },
-  { RS(PGMAJFAULT),                            TS(ul_int) },
-  { RS(PGMIGRATE_FAIL),                        TS(ul_int) },
-  { RS(PGMIGRATE_SUCCESS),                     TS(ul_int) },
-  { RS(PGPGIN),                                TS(ul_int) },
-  { RS(PGPGOUT),                               TS(ul_int) },
-  { RS(PGREFILL),                              TS(ul_int) },
-  { RS(PGROTATED),                             TS(ul_int) },
-  { RS(PGSCAN_ANON),                           TS(ul_int) },
-  { RS(PGSCAN_DIRECT),                         TS(ul_int) },
-  { RS(PGSCAN_DIRECT_THROTTLE),                TS(ul_int) },
-  { RS(PGSCAN_FILE),                           TS(ul_int) },
-  { RS(PGSCAN_KSWAPD),                         TS(ul_int) },
-  { RS(PGSKIP_DMA),                            TS(ul_int) },
-  { RS(PGSKIP_DMA32),                          TS(ul_int) },
-  { RS(PGSKIP_HIGH),                           TS(ul_int) },
-  { RS(PGSKIP_MOVABLE),                        TS(ul_int) },
-  { RS(PGSKIP_NORMAL),                         TS(ul_int) },
-  { RS(PGSTEAL_ANON),                          TS(ul_int) },
-  { RS(PGSTEAL_DIRECT),                        TS(ul_int) },
-  { RS(PGSTEAL_FILE),                          TS(ul_int) },
-  { RS(PGSTEAL_KSWAPD),                        TS(ul_int) },
-  { RS(PSWPIN),                                TS(ul_int) },
-  { RS(PSWPOUT),                               TS(ul_int) },
-  { RS(SLABS_SCANNED),                         TS(ul_int) },
-  { RS(SWAP_RA),                               TS(ul_int) },
-  { RS(SWAP_RA_HIT),                           TS(ul_int) },
-  { RS(THP_COLLAPSE_ALLOC),                    TS(ul_int) },
-  { RS(THP_COLLAPSE_ALLOC_FAILED),             TS(ul_int) },
-  { RS(THP_DEFERRED_SPLIT_PAGE),               TS(ul_int) },
-  { RS(THP_FAULT_ALLOC),                       TS(ul_int) },
-  { RS(THP_FAULT_FALLBACK),                    TS(ul_int) },
-  { RS(THP_FAULT_FALLBACK_CHARGE),             TS(ul_int) },
-  { RS(THP_FILE_ALLOC),                        TS(ul_int) },
-  { RS(THP_FILE_FALLBACK),                     TS(ul_int) },
-  { RS(THP_FILE_FALLBACK_CHARGE),              TS(ul_int) },
-  { RS(THP_FILE_MAPPED),                       TS(ul_int) },
-  { RS(THP_SPLIT_PAGE),                        TS(ul_int) },
-  { RS(THP_SPLIT_PAGE_FAILED),                 TS(ul_int) },
-  { RS(THP_SPLIT_PMD),                         TS(ul_int) },
-  { RS(THP_SPLIT_PUD),                         TS(ul_int) },
-  { RS(THP_SWPOUT),                            TS(ul_int) },
-  { RS(THP_SWPOUT_FALLBACK),                   TS(ul_int) },
-  { RS(THP_ZERO_PAGE_ALLOC),                   TS(ul_int) },
-  { RS(THP_ZERO_PAGE_ALLOC_FAILED),            TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_CLEARED),               TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_CULLED),                TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_MLOCKED),               TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_MUNLOCKED),             TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_RESCUED),               TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_SCANNED),               TS(ul_int) },
-  { RS(UNEVICTABLE_PGS_STRANDED),              TS(ul_int) },
-  { RS(WORKINGSET_ACTIVATE),                   TS(ul_int) },
-  { RS(WORKINGSET_NODERECLAIM),                TS(ul_int) },
-  { RS(WORKINGSET_NODES),                      TS(ul_int) },
-  { RS(WORKINGSET_REFAULT),                    TS(ul_int) },
-  { RS(WORKINGSET_RESTORE),                    TS(ul_int) },
-  { RS(ZONE_RECLAIM_FAILED),                   TS(ul_int) },
-
-  { RS(DELTA_ALLOCSTALL_DMA),                  TS(sl_int) },
-  { RS(DELTA_ALLOCSTALL_DMA32),                TS(sl_int) },
-  { RS(DELTA_ALLOCSTALL_HIGH),                 TS(sl_int) },
-  { RS(DELTA_ALLOCSTALL_MOVABLE),              TS(sl_int) },
-  { RS(DELTA_ALLOCSTALL_NORMAL),               TS(sl_int) },
-  { RS(DELTA_BALLOON_DEFLATE),                 TS(sl_int) },
-  { RS(DELTA_BALLOON_INFLATE),                 TS(sl_int) },
-  { RS(DELTA_BALLOON_MIGRATE),                 TS(sl_int) },
-  { RS(DELTA_COMPACT_DAEMON_FREE_SCANNED),     TS(sl_int) },
-  { RS(DELTA_COMPACT_DAEMON_MIGRATE_SCANNED),  TS(sl_int) },
-  { RS(DELTA_COMPACT_DAEMON_WAKE),             TS(sl_int) },
-  { RS(DELTA_COMPACT_FAIL),                    TS(sl_int) },
-  { RS(DELTA_COMPACT_FREE_SCANNED),            TS(sl_int) },
-  { RS(DELTA_COMPACT_ISOLATED),                TS(sl_int) },
-  { RS(DELTA_COMPACT_MIGRATE_SCANNED),         TS(sl_int) },
-  { RS(DELTA_COMPACT_STALL),                   TS(sl_int) },
-  { RS(DELTA_COMPACT_SUCCESS),                 TS(sl_int) },
-  { RS(DELTA_DROP_PAGECACHE),                  TS(sl_int) },
-  { RS(DELTA_DROP_SLAB),                       TS(sl_int) },
-  { RS(DELTA_HTLB_BUDDY_ALLOC_FAIL),           TS(sl_int) },
-  { RS(DELTA_HTLB_BUDDY_ALLOC_SUCCESS),        TS(sl_int) },
-  { RS(DELTA_KSWAPD_HIGH_WMARK_HIT_QUICKLY),   TS(sl_int) },
-  { RS(DELTA_KSWAPD_INODESTEAL),               TS(sl_int) },
-  { RS(DELTA_KSWAPD_LOW_WMARK_HIT_QUICKLY),    TS(sl_int) },
-  { RS(DELTA_NR_ACTIVE_ANON),                  TS(sl_int) },
-  { RS(DELTA_NR_ACTIVE_FILE),                  TS(sl_int) },
-  { RS(DELTA_NR_ANON_PAGES),                   TS(sl_int) },
-  { RS(DELTA_NR_ANON_TRANSPARENT_HUGEPAGES),   TS(sl_int) },
-  { RS(DELTA_NR_BOUNCE),                       TS(sl_int) },
-  { RS(DELTA_NR_DIRTIED),                      TS(sl_int) },
-  { RS(DELTA_NR_DIRTY),                        TS(sl_int) },
-  { RS(DELTA_NR_DIRTY_BACKGROUND_THRESHOLD),   TS(sl_int) },
-  { RS(DELTA_NR_DIRTY_THRESHOLD),              TS(sl_int) },
-  { RS(DELTA_NR_FILE_HUGEPAGES),               TS(sl_int) },
-  { RS(DELTA_NR_FILE_PAGES),                   TS(sl_int) },
-  { RS(DELTA_NR_FILE_PMDMAPPED),               TS(sl_int) },
-  { RS(DELTA_NR_FOLL_PIN_ACQUIRED),            TS(sl_int) },
-  { RS(DELTA_NR_FOLL_PIN_RELEASED),            TS(sl_int) },
-  { RS(DELTA_NR_FREE_CMA),                     TS(sl_int) },
-  { RS(DELTA_NR_FREE_PAGES),                   TS(sl_int) },
-  { RS(DELTA_NR_INACTIVE_ANON),                TS(sl_int) },
-  { RS(DELTA_NR_INACTIVE_FILE),                TS(sl_int) },
-  { RS(DELTA_NR_ISOLATED_ANON),                TS(sl_int) },
-  { RS(DELTA_NR_ISOLATED_FILE),                TS(sl_int) },
-  { RS(DELTA_NR_KERNEL_MISC_RECLAIMABLE),      TS(sl_int) },
-  { RS(DELTA_NR_KERNEL_STACK),                 TS(sl_int) },
-  { RS(DELTA_NR_MAPPED),                       TS(sl_int) },
-  { RS(DELTA_NR_MLOCK),                        TS(sl_int) },
-  { RS(DELTA_NR_PAGE_TABLE_PAGES),             TS(sl_int) },
-  { RS(DELTA_NR_SHADOW_CALL_STACK),            TS(sl_int) },
-  { RS(DELTA_NR_SHMEM),                        TS(sl_int) },
-  { RS(DELTA_NR_SHMEM_HUGEPAGES),              TS(sl_int) },
-  { RS(DELTA_NR_SHMEM_PMDMAPPED),              TS(sl_int) },
-  { RS(DELTA_NR_SLAB_RECLAIMABLE),             TS(sl_int) },
-  { RS(DELTA_NR_SLAB_UNRECLAIMABLE),           TS(sl_int) },
-  { RS(DELTA_NR_UNEVICTABLE),                  TS(sl_int) },
-  { RS(DELTA_NR_UNSTABLE),                     TS(sl_int) },
-  { RS(DELTA_NR_VMSCAN_IMMEDIATE_RECLAIM),     TS(sl_int) },
-  { RS(DELTA_NR_VMSCAN_WRITE),                 TS(sl_int) },
-  { RS(DELTA_NR_WRITEBACK),                    TS(sl_int) },
-  { RS(DELTA_NR_WRITEBACK_TEMP),               TS(sl_int) },
-  { RS(DELTA_NR_WRITTEN),                      TS(sl_int) },
-  { RS(DELTA_NR_ZONE_ACTIVE_ANON),             TS(sl_int) },
-  { RS(DELTA_NR_ZONE_ACTIVE_FILE),             TS(sl_int) },
-  { RS(DELTA_NR_ZONE_INACTIVE_ANON),           TS(sl_int) },
-  { RS(DELTA_NR_ZONE_INACTIVE_FILE),           TS(sl_int) },
-  { RS(DELTA_NR_ZONE_UNEVICTABLE),             TS(sl_int) },
-  { RS(DELTA_NR_ZONE_WRITE_PENDING),           TS(sl_int) },
-  { RS(DELTA_NR_ZSPAGES),                      TS(sl_int) },
-  { RS(DELTA_NUMA_FOREIGN),                    TS(sl_int) },
-  { RS(DELTA_NUMA_HINT_FAULTS),                TS(sl_int) },
-  { RS(DELTA_NUMA_HINT_FAULTS_LOCAL),          TS(sl_int) },
-  { RS(DELTA_NUMA_HIT),                        TS(sl_int) },
-  { RS(DELTA_NUMA_HUGE_PTE_UPDATES),           TS(sl_int) },
-  { RS(DELTA_NUMA_INTERLEAVE),                 TS(sl_int) },
-  { RS(DELTA_NUMA_LOCAL),                      TS(sl_int) },
-  { RS(DELTA_NUMA_MISS),                       TS(sl_int) },
-  { RS(DELTA_NUMA_OTHER),                      TS(sl_int) },
-  { RS(DELTA_NUMA_PAGES_MIGRATED),             TS(sl_int) },
-  { RS(DELTA_NUMA_PTE_UPDATES),                TS(sl_int) },
-  { RS(DELTA_OOM_KILL),                        TS(sl_int) },
-  { RS(DELTA_PAGEOUTRUN),                      TS(sl_int) },
-  { RS(DELTA_PGACTIVATE),                      TS(sl_int) },
-  { RS(DELTA_PGALLOC_DMA),                     TS(sl_int) },
-  { RS(DELTA_PGALLOC_DMA32),                   TS(sl_int) },
-  { RS(DELTA_PGALLOC_HIGH),                    TS(sl_int) },
-  { RS(DELTA_PGALLOC_MOVABLE),                 TS(sl_int) },
-  { RS(DELTA_PGALLOC_NORMAL),                  TS(sl_int) },
-  { RS(DELTA_PGDEACTIVATE),                    TS(sl_int) },
-  { RS(DELTA_PGFAULT),                         TS(sl_int) },
-  { RS(DELTA_PGFREE),                          TS(sl_int) },
-  { RS(DELTA_PGINODESTEAL),                    TS(sl_int) },
-  { RS(DELTA_PGLAZYFREE),                      TS(sl_int) },
-  { RS(DELTA_PGLAZYFREED),                     TS(sl_int) },
-  { RS(DELTA_PGMAJFAULT),                      TS(sl_int) },
-  { RS(DELTA_PGMIGRATE_FAIL),                  TS(sl_int) },
-  { RS(DELTA_PGMIGRATE_SUCCESS),               TS(sl_int) },
-  { RS(DELTA_PGPGIN),                          TS(sl_int) },
-  { RS(DELTA_PGPGOUT),                         TS(sl_int) },
-  { RS(DELTA_PGREFILL),                        TS(sl_int) },
-  { RS(DELTA_PGROTATED),                       TS(sl_int) },
-  { RS(DELTA_PGSCAN_ANON),                     TS(sl_int) },
-  { RS(DELTA_PGSCAN_DIRECT),                   TS(sl_int) },
-  { RS(DELTA_PGSCAN_DIRECT_THROTTLE),          TS(sl_int) },
-  { RS(DELTA_PGSCAN_FILE),                     TS(sl_int) },
-  { RS(DELTA_PGSCAN_KSWAPD),                   TS(sl_int) },
-  { RS(DELTA_PGSKIP_DMA),                      TS(sl_int) },
-  { RS(DELTA_PGSKIP_DMA32),                    TS(sl_int) },
-  { RS(DELTA_PGSKIP_HIGH),                     TS(sl_int) },
-  { RS(DELTA_PGSKIP_MOVABLE),                  TS(sl_int) },
-  { RS(DELTA_PGSKIP_NORMAL),                   TS(sl_int) },
-  { RS(DELTA_PGSTEAL_ANON),                    TS(sl_int) },
-  { RS(DELTA_PGSTEAL_DIRECT),                  TS(sl_int) },
-  { RS(DELTA_PGSTEAL_FILE),                    TS(sl_int) },
-  { RS(DELTA_PGSTEAL_KSWAPD),                  TS(sl_int) },
-  { RS(DELTA_PSWPIN),                          TS(sl_int) },
-  { RS(DELTA_PSWPOUT),                         TS(sl_int) },
-  { RS(DELTA_SLABS_SCANNED),                   TS(sl_int) },
-  { RS(DELTA_SWAP_RA),                         TS(sl_int) },
-  { RS(DELTA_SWAP_RA_HIT),                     TS(sl_int) },
-  { RS(DELTA_THP_COLLAPSE_ALLOC),              TS(sl_int) },
-  { RS(DELTA_THP_COLLAPSE_ALLOC_FAILED),       TS(sl_int) },
-  { RS(DELTA_THP_DEFERRED_SPLIT_PAGE),         TS(sl_int) },
-  { RS(DELTA_THP_FAULT_ALLOC),                 TS(sl_int) },
-  { RS(DELTA_THP_FAULT_FALLBACK),              TS(sl_int) },
-  { RS(DELTA_THP_FAULT_FALLBACK_CHARGE),       TS(sl_int) },
-  { RS(DELTA_THP_FILE_ALLOC),                  TS(sl_int) },
-  { RS(DELTA_THP_FILE_FALLBACK),               TS(sl_int) },
-  { RS(DELTA_THP_FILE_FALLBACK_CHARGE),        TS(sl_int) },
-  { RS(DELTA_THP_FILE_MAPPED),                 TS(sl_int) },
-  { RS(DELTA_THP_SPLIT_PAGE),                  TS(sl_int) },
-  { RS(DELTA_THP_SPLIT_PAGE_FAILED),           TS(sl_int) },
-  { RS(DELTA_THP_SPLIT_PMD),                   TS(sl_int) },
-  { RS(DELTA_THP_SPLIT_PUD),                   TS(sl_int) },
-  { RS(DELTA_THP_SWPOUT),                      TS(sl_int) },
-  { RS(DELTA_THP_SWPOUT_FALLBACK),             TS(sl_int) },
-  { RS(DELTA_THP_ZERO_PAGE_ALLOC),             TS(sl_int) },
-  { RS(DELTA_THP_ZERO_PAGE_ALLOC_FAILED),      TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_CLEARED),         TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_CULLED),          TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_MLOCKED),         TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_MUNLOCKED),       TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_RESCUED),         TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_SCANNED),         TS(sl_int) },
-  { RS(DELTA_UNEVICTABLE_PGS_STRANDED),        TS(sl_int) },
-  { RS(DELTA_WORKINGSET_ACTIVATE),             TS(sl_int) },
-  { RS(DELTA_WORKINGSET_NODERECLAIM),          TS(sl_int) },
-  { RS(DELTA_WORKINGSET_NODES),                TS(sl_int) },
-  { RS(DELTA_WORKINGSET_REFAULT),              TS(sl_int) },
-  { RS(DELTA_WORKINGSET_RESTORE),              TS(sl_int) },
-  { RS(DELTA_ZONE_RECLAIM_FAILED),             TS(sl_int) },
+/*  setsfunc                                   sortfunc      type2str
+    -----------------------------------------  ------------  ---------- */
+  { RS(noop),                                  QS(noop),     TS_noop    },
+  { RS(extra),                                 QS(ul_int),   TS_noop    },
+
+  { RS(ALLOCSTALL_DMA),                        QS(ul_int),   TS(ul_int) },
+  { RS(ALLOCSTALL_DMA32),                      QS(ul_int),   TS(ul_int) },
+  { RS(ALLOCSTALL_HIGH),                       QS(ul_int),   TS(ul_int) },
+  { RS(ALLOCSTALL_MOVABLE),                    QS(ul_int),   TS(ul_int) },
+  { RS(ALLOCSTALL_NORMAL),                     QS(ul_int),   TS(ul_int) },
+  { RS(BALLOON_DEFLATE),                       QS(ul_int),   TS(ul_int) },
+  { RS(BALLOON_INFLATE),                       QS(ul_int),   TS(ul_int) },
+  { RS(BALLOON_MIGRATE),                       QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_DAEMON_FREE_SCANNED),           QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_DAEMON_MIGRATE_SCANNED),        QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_DAEMON_WAKE),                   QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_FAIL),                          QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_FREE_SCANNED),                  QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_ISOLATED),                      QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_MIGRATE_SCANNED),               QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_STALL),                         QS(ul_int),   TS(ul_int) },
+  { RS(COMPACT_SUCCESS),                       QS(ul_int),   TS(ul_int) },
+  { RS(DROP_PAGECACHE),                        QS(ul_int),   TS(ul_int) },
+  { RS(DROP_SLAB),                             QS(ul_int),   TS(ul_int) },
+  { RS(HTLB_BUDDY_ALLOC_FAIL),                 QS(ul_int),   TS(ul_int) },
+  { RS(HTLB_BUDDY_ALLOC_SUCCESS),              QS(ul_int),   TS(ul_int) },
+  { RS(KSWAPD_HIGH_WMARK_HIT_QUICKLY),         QS(ul_int),   TS(ul_int) },
+  { RS(KSWAPD_INODESTEAL),                     QS(ul_int),   TS(ul_int) },
+  { RS(KSWAPD_LOW_WMARK_HIT_QUICKLY),          QS(ul_int),   TS(ul_int) },
+  { RS(NR_ACTIVE_ANON),                        QS(ul_int),   TS(ul_int) },
+  { RS(NR_ACTIVE_FILE),                        QS(ul_int),   TS(ul_int) },
+  { RS(NR_ANON_PAGES),                         QS(ul_int),   TS(ul_int) },
+  { RS(NR_ANON_TRANSPARENT_HUGEPAGES),         QS(ul_int),   TS(ul_int) },
+  { RS(NR_BOUNCE),                             QS(ul_int),   TS(ul_int) },
+  { RS(NR_DIRTIED),                            QS(ul_int),   TS(ul_int) },
+  { RS(NR_DIRTY),                              QS(ul_int),   TS(ul_int) },
+  { RS(NR_DIRTY_BACKGROUND_THRESHOLD),         QS(ul_int),   TS(ul_int) },
+  { RS(NR_DIRTY_THRESHOLD),                    QS(ul_int),   TS(ul_int) },
+  { RS(NR_FILE_HUGEPAGES),                     QS(ul_int),   TS(ul_int) },
+  { RS(NR_FILE_PAGES),                         QS(ul_int),   TS(ul_int) },
+  { RS(NR_FILE_PMDMAPPED),                     QS(ul_int),   TS(ul_int) },
+  { RS(NR_FOLL_PIN_ACQUIRED),                  QS(ul_int),   TS(ul_int) },
+  { RS(NR_FOLL_PIN_RELEASED),                  QS(ul_int),   TS(ul_int) },
+  { RS(NR_FREE_CMA),                           QS(ul_int),   TS(ul_int) },
+  { RS(NR_FREE_PAGES),                         QS(ul_int),   TS(ul_int) },
+  { RS(NR_INACTIVE_ANON),                      QS(ul_int),   TS(ul_int) },
+  { RS(NR_INACTIVE_FILE),                      QS(ul_int),   TS(ul_int) },
+  { RS(NR_ISOLATED_ANON),                      QS(ul_int),   TS(ul_int) },
+  { RS(NR_ISOLATED_FILE),                      QS(ul_int),   TS(ul_int) },
+  { RS(NR_KERNEL_MISC_RECLAIMABLE),            QS(ul_int),   TS(ul_int) },
+  { RS(NR_KERNEL_STACK),                       QS(ul_int),   TS(ul_int) },
+  { RS(NR_MAPPED),                             QS(ul_int),   TS(ul_int) },
+  { RS(NR_MLOCK),                              QS(ul_int),   TS(ul_int) },
+  { RS(NR_PAGE_TABLE_PAGES),                   QS(ul_int),   TS(ul_int) },
+  { RS(NR_SHADOW_CALL_STACK),                  QS(ul_int),   TS(ul_int) },
+  { RS(NR_SHMEM),                              QS(ul_int),   TS(ul_int) },
+  { RS(NR_SHMEM_HUGEPAGES),                    QS(ul_int),   TS(ul_int) },
+  { RS(NR_SHMEM_PMDMAPPED),                    QS(ul_int),   TS(ul_int) },
+  { RS(NR_SLAB_RECLAIMABLE),                   QS(ul_int),   TS(ul_int) },
+  { RS(NR_SLAB_UNRECLAIMABLE),                 QS(ul_int),   TS(ul_int) },
+  { RS(NR_UNEVICTABLE),                        QS(ul_int),   TS(ul_int) },
+  { RS(NR_UNSTABLE),                           QS(ul_int),   TS(ul_int) },
+  { RS(NR_VMSCAN_IMMEDIATE_RECLAIM),           QS(ul_int),   TS(ul_int) },
+  { RS(NR_VMSCAN_WRITE),                       QS(ul_int),   TS(ul_int) },
+  { RS(NR_WRITEBACK),                          QS(ul_int),   TS(ul_int) },
+  { RS(NR_WRITEBACK_TEMP),                     QS(ul_int),   TS(ul_int) },
+  { RS(NR_WRITTEN),                            QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZONE_ACTIVE_ANON),                   QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZONE_ACTIVE_FILE),                   QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZONE_INACTIVE_ANON),                 QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZONE_INACTIVE_FILE),                 QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZONE_UNEVICTABLE),                   QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZONE_WRITE_PENDING),                 QS(ul_int),   TS(ul_int) },
+  { RS(NR_ZSPAGES),                            QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_FOREIGN),                          QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_HINT_FAULTS),                      QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_HINT_FAULTS_LOCAL),                QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_HIT),                              QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_HUGE_PTE_UPDATES),                 QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_INTERLEAVE),                       QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_LOCAL),                            QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_MISS),                             QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_OTHER),                            QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_PAGES_MIGRATED),                   QS(ul_int),   TS(ul_int) },
+  { RS(NUMA_PTE_UPDATES),                      QS(ul_int),   TS(ul_int) },
+  { RS(OOM_KILL),                              QS(ul_int),   TS(ul_int) },
+  { RS(PAGEOUTRUN),                            QS(ul_int),   TS(ul_int) },
+  { RS(PGACTIVATE),                            QS(ul_int),   TS(ul_int) },
+  { RS(PGALLOC_DMA),                           QS(ul_int),   TS(ul_int) },
+  { RS(PGALLOC_DMA32),                         QS(ul_int),   TS(ul_int) },
+  { RS(PGALLOC_HIGH),                          QS(ul_int),   TS(ul_int) },
+  { RS(PGALLOC_MOVABLE),                       QS(ul_int),   TS(ul_int) },
+  { RS(PGALLOC_NORMAL),                        QS(ul_int),   TS(ul_int) },
+  { RS(PGDEACTIVATE),                          QS(ul_int),   TS(ul_int) },
+  { RS(PGFAULT),                               QS(ul_int),   TS(ul_int) },
+  { RS(PGFREE),                                QS(ul_int),   TS(ul_int) },
+  { RS(PGINODESTEAL),                          QS(ul_int),   TS(ul_int) },
+  { RS(PGLAZYFREE),                            QS(ul_int),   TS(ul_int) },
+  { RS(PGLAZYFREED),                           QS(ul_int),   TS(ul_int) },
+  { RS(PGMAJFAULT),                            QS(ul_int),   TS(ul_int) },
+  { RS(PGMIGRATE_FAIL),                        QS(ul_int),   TS(ul_int) },
+  { RS(PGMIGRATE_SUCCESS),                     QS(ul_int),   TS(ul_int) },
+  { RS(PGPGIN),                                QS(ul_int),   TS(ul_int) },
+  { RS(PGPGOUT),                               QS(ul_int),   TS(ul_int) },
+  { RS(PGREFILL),                              QS(ul_int),   TS(ul_int) },
+  { RS(PGROTATED),                             QS(ul_int),   TS(ul_int) },
+  { RS(PGSCAN_ANON),                           QS(ul_int),   TS(ul_int) },
+  { RS(PGSCAN_DIRECT),                         QS(ul_int),   TS(ul_int) },
+  { RS(PGSCAN_DIRECT_THROTTLE),                QS(ul_int),   TS(ul_int) },
+  { RS(PGSCAN_FILE),                           QS(ul_int),   TS(ul_int) },
+  { RS(PGSCAN_KSWAPD),                         QS(ul_int),   TS(ul_int) },
+  { RS(PGSKIP_DMA),                            QS(ul_int),   TS(ul_int) },
+  { RS(PGSKIP_DMA32),                          QS(ul_int),   TS(ul_int) },
+  { RS(PGSKIP_HIGH),                           QS(ul_int),   TS(ul_int) },
+  { RS(PGSKIP_MOVABLE),                        QS(ul_int),   TS(ul_int) },
+  { RS(PGSKIP_NORMAL),                         QS(ul_int),   TS(ul_int) },
+  { RS(PGSTEAL_ANON),                          QS(ul_int),   TS(ul_int) },
+  { RS(PGSTEAL_DIRECT),                        QS(ul_int),   TS(ul_int) },
+  { RS(PGSTEAL_FILE),                          QS(ul_int),   TS(ul_int) },
+  { RS(PGSTEAL_KSWAPD),                        QS(ul_int),   TS(ul_int) },
+  { RS(PSWPIN),                                QS(ul_int),   TS(ul_int) },
+  { RS(PSWPOUT),                               QS(ul_int),   TS(ul_int) },
+  { RS(SLABS_SCANNED),                         QS(ul_int),   TS(ul_int) },
+  { RS(SWAP_RA),                               QS(ul_int),   TS(ul_int) },
+  { RS(SWAP_RA_HIT),                           QS(ul_int),   TS(ul_int) },
+  { RS(THP_COLLAPSE_ALLOC),                    QS(ul_int),   TS(ul_int) },
+  { RS(THP_COLLAPSE_ALLOC_FAILED),             QS(ul_int),   TS(ul_int) },
+  { RS(THP_DEFERRED_SPLIT_PAGE),               QS(ul_int),   TS(ul_int) },
+  { RS(THP_FAULT_ALLOC),                       QS(ul_int),   TS(ul_int) },
+  { RS(THP_FAULT_FALLBACK),                    QS(ul_int),   TS(ul_int) },
+  { RS(THP_FAULT_FALLBACK_CHARGE),             QS(ul_int),   TS(ul_int) },
+  { RS(THP_FILE_ALLOC),                        QS(ul_int),   TS(ul_int) },
+  { RS(THP_FILE_FALLBACK),                     QS(ul_int),   TS(ul_int) },
+  { RS(THP_FILE_FALLBACK_CHARGE),              QS(ul_int),   TS(ul_int) },
+  { RS(THP_FILE_MAPPED),                       QS(ul_int),   TS(ul_int) },
+  { RS(THP_SPLIT_PAGE),                        QS(ul_int),   TS(ul_int) },
+  { RS(THP_SPLIT_PAGE_FAILED),                 QS(ul_int),   TS(ul_int) },
+  { RS(THP_SPLIT_PMD),                         QS(ul_int),   TS(ul_int) },
+  { RS(THP_SPLIT_PUD),                         QS(ul_int),   TS(ul_int) },
+  { RS(THP_SWPOUT),                            QS(ul_int),   TS(ul_int) },
+  { RS(THP_SWPOUT_FALLBACK),                   QS(ul_int),   TS(ul_int) },
+  { RS(THP_ZERO_PAGE_ALLOC),                   QS(ul_int),   TS(ul_int) },
+  { RS(THP_ZERO_PAGE_ALLOC_FAILED),            QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_CLEARED),               QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_CULLED),                QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_MLOCKED),               QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_MUNLOCKED),             QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_RESCUED),               QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_SCANNED),               QS(ul_int),   TS(ul_int) },
+  { RS(UNEVICTABLE_PGS_STRANDED),              QS(ul_int),   TS(ul_int) },
+  { RS(WORKINGSET_ACTIVATE),                   QS(ul_int),   TS(ul_int) },
+  { RS(WORKINGSET_NODERECLAIM),                QS(ul_int),   TS(ul_int) },
+  { RS(WORKINGSET_NODES),                      QS(ul_int),   TS(ul_int) },
+  { RS(WORKINGSET_REFAULT),                    QS(ul_int),   TS(ul_int) },
+  { RS(WORKINGSET_RESTORE),                    QS(ul_int),   TS(ul_int) },
+  { RS(ZONE_RECLAIM_FAILED),                   QS(ul_int),   TS(ul_int) },
+
+  { RS(DELTA_ALLOCSTALL_DMA),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_ALLOCSTALL_DMA32),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_ALLOCSTALL_HIGH),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_ALLOCSTALL_MOVABLE),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_ALLOCSTALL_NORMAL),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_BALLOON_DEFLATE),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_BALLOON_INFLATE),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_BALLOON_MIGRATE),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_DAEMON_FREE_SCANNED),     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_DAEMON_MIGRATE_SCANNED),  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_DAEMON_WAKE),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_FAIL),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_FREE_SCANNED),            QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_ISOLATED),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_MIGRATE_SCANNED),         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_STALL),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_COMPACT_SUCCESS),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_DROP_PAGECACHE),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_DROP_SLAB),                       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_HTLB_BUDDY_ALLOC_FAIL),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_HTLB_BUDDY_ALLOC_SUCCESS),        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_KSWAPD_HIGH_WMARK_HIT_QUICKLY),   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_KSWAPD_INODESTEAL),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_KSWAPD_LOW_WMARK_HIT_QUICKLY),    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ACTIVE_ANON),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ACTIVE_FILE),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ANON_PAGES),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ANON_TRANSPARENT_HUGEPAGES),   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_BOUNCE),                       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_DIRTIED),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_DIRTY),                        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_DIRTY_BACKGROUND_THRESHOLD),   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_DIRTY_THRESHOLD),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FILE_HUGEPAGES),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FILE_PAGES),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FILE_PMDMAPPED),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FOLL_PIN_ACQUIRED),            QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FOLL_PIN_RELEASED),            QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FREE_CMA),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_FREE_PAGES),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_INACTIVE_ANON),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_INACTIVE_FILE),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ISOLATED_ANON),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ISOLATED_FILE),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_KERNEL_MISC_RECLAIMABLE),      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_KERNEL_STACK),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_MAPPED),                       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_MLOCK),                        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_PAGE_TABLE_PAGES),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_SHADOW_CALL_STACK),            QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_SHMEM),                        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_SHMEM_HUGEPAGES),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_SHMEM_PMDMAPPED),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_SLAB_RECLAIMABLE),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_SLAB_UNRECLAIMABLE),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_UNEVICTABLE),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_UNSTABLE),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_VMSCAN_IMMEDIATE_RECLAIM),     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_VMSCAN_WRITE),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_WRITEBACK),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_WRITEBACK_TEMP),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_WRITTEN),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZONE_ACTIVE_ANON),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZONE_ACTIVE_FILE),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZONE_INACTIVE_ANON),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZONE_INACTIVE_FILE),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZONE_UNEVICTABLE),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZONE_WRITE_PENDING),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NR_ZSPAGES),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_FOREIGN),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_HINT_FAULTS),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_HINT_FAULTS_LOCAL),          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_HIT),                        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_HUGE_PTE_UPDATES),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_INTERLEAVE),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_LOCAL),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_MISS),                       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_OTHER),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_PAGES_MIGRATED),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_NUMA_PTE_UPDATES),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_OOM_KILL),                        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PAGEOUTRUN),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGACTIVATE),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGALLOC_DMA),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGALLOC_DMA32),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGALLOC_HIGH),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGALLOC_MOVABLE),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGALLOC_NORMAL),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGDEACTIVATE),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGFAULT),                         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGFREE),                          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGINODESTEAL),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGLAZYFREE),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGLAZYFREED),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGMAJFAULT),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGMIGRATE_FAIL),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGMIGRATE_SUCCESS),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGPGIN),                          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGPGOUT),                         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGREFILL),                        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGROTATED),                       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSCAN_ANON),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSCAN_DIRECT),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSCAN_DIRECT_THROTTLE),          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSCAN_FILE),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSCAN_KSWAPD),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSKIP_DMA),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSKIP_DMA32),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSKIP_HIGH),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSKIP_MOVABLE),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSKIP_NORMAL),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSTEAL_ANON),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSTEAL_DIRECT),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSTEAL_FILE),                    QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PGSTEAL_KSWAPD),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PSWPIN),                          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_PSWPOUT),                         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_SLABS_SCANNED),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_SWAP_RA),                         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_SWAP_RA_HIT),                     QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_COLLAPSE_ALLOC),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_COLLAPSE_ALLOC_FAILED),       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_DEFERRED_SPLIT_PAGE),         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FAULT_ALLOC),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FAULT_FALLBACK),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FAULT_FALLBACK_CHARGE),       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FILE_ALLOC),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FILE_FALLBACK),               QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FILE_FALLBACK_CHARGE),        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_FILE_MAPPED),                 QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_SPLIT_PAGE),                  QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_SPLIT_PAGE_FAILED),           QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_SPLIT_PMD),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_SPLIT_PUD),                   QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_SWPOUT),                      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_SWPOUT_FALLBACK),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_ZERO_PAGE_ALLOC),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_THP_ZERO_PAGE_ALLOC_FAILED),      QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_CLEARED),         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_CULLED),          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_MLOCKED),         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_MUNLOCKED),       QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_RESCUED),         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_SCANNED),         QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_UNEVICTABLE_PGS_STRANDED),        QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_WORKINGSET_ACTIVATE),             QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_WORKINGSET_NODERECLAIM),          QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_WORKINGSET_NODES),                QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_WORKINGSET_REFAULT),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_WORKINGSET_RESTORE),              QS(sl_int),   TS(sl_int) },
+  { RS(DELTA_ZONE_RECLAIM_FAILED),             QS(sl_int),   TS(sl_int) },
+
+  { RS(DELTA_ELAPSED),                         QS(real),     TS(real)   },
+  { RS(DELTA_PGPGIN_PER_SEC),                  QS(real),     TS(real)   },
+  { RS(DELTA_PGPGOUT_PER_SEC),                 QS(real),     TS(real)   },
+  { RS(DELTA_PSWPIN_PER_SEC),                  QS(real),     TS(real)   },
+  { RS(DELTA_PSWPOUT_PER_SEC),                 QS(real),     TS(real)   },
+  { RS(DELTA_PGFAULT_PER_SEC),                 QS(real),     TS(real)   },
+  { RS(DELTA_PGMAJFAULT_PER_SEC),              QS(real),     TS(real)   },
+  { RS(DELTA_PGFREE_PER_SEC),                  QS(real),     TS(real)   },
+  { RS(DELTA_PGSCAN_KSWAPD_PER_SEC),           QS(real),     TS(real)   },
+  { RS(DELTA_PGSCAN_DIRECT_PER_SEC),           QS(real),     TS(real)   },
+  { RS(DELTA_PGSTEAL_KSWAPD_PER_SEC),          QS(real),     TS(real)   },
+  { RS(DELTA_PGSTEAL_DIRECT_PER_SEC),          QS(real),     TS(real)   },
+  { RS(DELTA_ALLOCSTALL_NORMAL_PER_SEC),       QS(real),     TS(real)   },
+  { RS(DELTA_COMPACT_STALL_PER_SEC),           QS(real),     TS(real)   },
+  { RS(DELTA_OOM_KILL_PER_SEC),                QS(real),     TS(real)   },
+  { RS(DELTA_THP_FAULT_ALLOC_PER_SEC),         QS(real),     TS(real)   },
+  { RS(DELTA_WORKINGSET_REFAULT_PER_SEC),      QS(real),     TS(real)   },
+
+  { RS(NODE_ID),                               QS(s_int),    TS(s_int)  },
 };
 
     /* please note,
@@ -902,7 +1026,9 @@ static struct {
 enum vmstat_item VMSTAT_logical_end = MAXTABLE(Item_table);
 
 #undef setNAME
+#undef srtNAME
 #undef RS
+#undef QS
 
 
 // ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -925,11 +1051,11 @@ static inline void vmstat_assign_results (
 
 
 static void vmstat_extents_free_all (
-        struct vmstat_info *info)
+        struct ext_support *this)
 {
-    while (info->extents) {
-        struct stacks_extent *p = info->extents;
-        info->extents = info->extents->next;
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
         free(p);
     };
 } // end: vmstat_extents_free_all
@@ -981,176 +1107,281 @@ static inline int vmstat_items_check_failed (
 } // end: vmstat_items_check_failed
 
 
-static int vmstat_make_hash_failed (
-        struct vmstat_info *info)
+typedef struct vmstat_table_struct {
+    const char *name;             // /proc/vmstat field name
+    unsigned char len;            // name length
+    unsigned short offset;        // where it goes in struct vmstat_data
+} vmstat_table_struct;
+
+#define F(x) { #x, sizeof(#x)-1, offsetof(struct vmstat_data, x) },
+
+#define VMSTAT_TABLE_SIZE 1024
+
+// A perfect hash in the gperf style, as with status2proc in readproc.c:
+//   length + asso[] of the 4th, 6th, 10th, 12th, 17th & last chars
+// masked to VMSTAT_TABLE_SIZE, with those key positions giving each of
+// our names a distinct set of characters.  Names not in the table (and
+// there are always many) simply fail the length or memcmp test.
+//
+// Adding a field means searching out a new 'asso' where none of those
+// names collide, perhaps with other key positions.  A duplicate index in
+// the table below silently replaces the earlier entry, but then it fails
+// check_vmstat_table (library/tests/test_vmstat.c), which finds every name
+// at its own hash and counts them against the struct's fields.
+
+static const unsigned short vmstat_asso[] =
 {
- #define htVAL(f) e.key = STRINGIFY(f); e.data = &info->hist.new. f; \
-  if (!hsearch_r(e, ENTER, &ep, &info->hashtab)) goto err_return;
-    ENTRY e, *ep;
-    size_t n;
-
-    n = sizeof(struct vmstat_data) / sizeof(unsigned long);
-    // we'll follow the hsearch recommendation of an extra 25%
-    if (!hcreate_r(n + (n / 4), &info->hashtab))
-        goto err_return;
-
-    htVAL(allocstall_dma)
-    htVAL(allocstall_dma32)
-    htVAL(allocstall_high)
-    htVAL(allocstall_movable)
-    htVAL(allocstall_normal)
-    htVAL(balloon_deflate)
-    htVAL(balloon_inflate)
-    htVAL(balloon_migrate)
-    htVAL(compact_daemon_free_scanned)
-    htVAL(compact_daemon_migrate_scanned)
-    htVAL(compact_daemon_wake)
-    htVAL(compact_fail)
-    htVAL(compact_free_scanned)
-    htVAL(compact_isolated)
-    htVAL(compact_migrate_scanned)
-    htVAL(compact_stall)
-    htVAL(compact_success)
-    htVAL(drop_pagecache)
-    htVAL(drop_slab)
-    htVAL(htlb_buddy_alloc_fail)
-    htVAL(htlb_buddy_alloc_success)
-    htVAL(kswapd_high_wmark_hit_quickly)
-    htVAL(kswapd_inodesteal)
-    htVAL(kswapd_low_wmark_hit_quickly)
-    htVAL(nr_active_anon)
-    htVAL(nr_active_file)
-    htVAL(nr_anon_pages)
-    htVAL(nr_anon_transparent_hugepages)
-    htVAL(nr_bounce)
-    htVAL(nr_dirtied)
-    htVAL(nr_dirty)
-    htVAL(nr_dirty_background_threshold)
-    htVAL(nr_dirty_threshold)
-    htVAL(nr_file_hugepages)
-    htVAL(nr_file_pages)
-    htVAL(nr_file_pmdmapped)
-    htVAL(nr_foll_pin_acquired)
-    htVAL(nr_foll_pin_released)
-    htVAL(nr_free_cma)
-    htVAL(nr_free_pages)
-    htVAL(nr_inactive_anon)
-    htVAL(nr_inactive_file)
-    htVAL(nr_isolated_anon)
-    htVAL(nr_isolated_file)
-    htVAL(nr_kernel_misc_reclaimable)
-    htVAL(nr_kernel_stack)
-    htVAL(nr_mapped)
-    htVAL(nr_mlock)
-    htVAL(nr_page_table_pages)
-    htVAL(nr_shadow_call_stack)
-    htVAL(nr_shmem)
-    htVAL(nr_shmem_hugepages)
-    htVAL(nr_shmem_pmdmapped)
-    htVAL(nr_slab_reclaimable)
-    htVAL(nr_slab_unreclaimable)
-    htVAL(nr_unevictable)
-    htVAL(nr_unstable)
-    htVAL(nr_vmscan_immediate_reclaim)
-    htVAL(nr_vmscan_write)
-    htVAL(nr_writeback)
-    htVAL(nr_writeback_temp)
-    htVAL(nr_written)
-    htVAL(nr_zone_active_anon)
-    htVAL(nr_zone_active_file)
-    htVAL(nr_zone_inactive_anon)
-    htVAL(nr_zone_inactive_file)
-    htVAL(nr_zone_unevictable)
-    htVAL(nr_zone_write_pending)
-    htVAL(nr_zspages)
-    htVAL(numa_foreign)
-    htVAL(numa_hint_faults)
-    htVAL(numa_hint_faults_local)
-    htVAL(numa_hit)
-    htVAL(numa_huge_pte_updates)
-    htVAL(numa_interleave)
-    htVAL(numa_local)
-    htVAL(numa_miss)
-    htVAL(numa_other)
-    htVAL(numa_pages_migrated)
-    htVAL(numa_pte_updates)
-    htVAL(oom_kill)
-    htVAL(pageoutrun)
-    htVAL(pgactivate)
-    htVAL(pgalloc_dma)
-    htVAL(pgalloc_dma32)
-    htVAL(pgalloc_high)
-    htVAL(pgalloc_movable)
-    htVAL(pgalloc_normal)
-    htVAL(pgdeactivate)
-    htVAL(pgfault)
-    htVAL(pgfree)
-    htVAL(pginodesteal)
-    htVAL(pglazyfree)
-    htVAL(pglazyfreed)
-    htVAL(pgmajfault)
-    htVAL(pgmigrate_fail)
-    htVAL(pgmigrate_success)
-    htVAL(pgpgin)
-    htVAL(pgpgout)
-    htVAL(pgrefill)
-    htVAL(pgrotated)
-    htVAL(pgscan_anon)
-    htVAL(pgscan_direct)
-    htVAL(pgscan_direct_throttle)
-    htVAL(pgscan_file)
-    htVAL(pgscan_kswapd)
-    htVAL(pgskip_dma)
-    htVAL(pgskip_dma32)
-    htVAL(pgskip_high)
-    htVAL(pgskip_movable)
-    htVAL(pgskip_normal)
-    htVAL(pgsteal_anon)
-    htVAL(pgsteal_direct)
-    htVAL(pgsteal_file)
-    htVAL(pgsteal_kswapd)
-    htVAL(pswpin)
-    htVAL(pswpout)
-    htVAL(slabs_scanned)
-    htVAL(swap_ra)
-    htVAL(swap_ra_hit)
-    htVAL(thp_collapse_alloc)
-    htVAL(thp_collapse_alloc_failed)
-    htVAL(thp_deferred_split_page)
-    htVAL(thp_fault_alloc)
-    htVAL(thp_fault_fallback)
-    htVAL(thp_fault_fallback_charge)
-    htVAL(thp_file_alloc)
-    htVAL(thp_file_fallback)
-    htVAL(thp_file_fallback_charge)
-    htVAL(thp_file_mapped)
-    htVAL(thp_split_page)
-    htVAL(thp_split_page_failed)
-    htVAL(thp_split_pmd)
-    htVAL(thp_split_pud)
-    htVAL(thp_swpout)
-    htVAL(thp_swpout_fallback)
-    htVAL(thp_zero_page_alloc)
-    htVAL(thp_zero_page_alloc_failed)
-    htVAL(unevictable_pgs_cleared)
-    htVAL(unevictable_pgs_culled)
-    htVAL(unevictable_pgs_mlocked)
-    htVAL(unevictable_pgs_munlocked)
-    htVAL(unevictable_pgs_rescued)
-    htVAL(unevictable_pgs_scanned)
-    htVAL(unevictable_pgs_stranded)
-    htVAL(workingset_activate)
-    htVAL(workingset_nodereclaim)
-    htVAL(workingset_nodes)
-    htVAL(workingset_refault)
-    htVAL(workingset_restore)
-    htVAL(zone_reclaim_failed)
+    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+     590,  528,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+       0,    0,    0,    0,    0,  724,    0,  680,  768,  313,
+     208,  951,  348,  827,   39,  409,    0,  456,  885,  105,
+     544,  484,  270,    0,  393,  675,  347,  237,  750, 1001,
+       0,  568,  591,    0,    0,    0,    0,    0
+};
 
-    return 0;
- err_return:
-    return 1;
- #undef htVAL
-} // end: vmstat_make_hash_failed
+static const vmstat_table_struct vmstat_table[VMSTAT_TABLE_SIZE] = {
+    [   1] = F(thp_fault_fallback_charge)
+    [   3] = F(nr_dirtied)
+    [  14] = F(kswapd_inodesteal)
+    [  29] = F(nr_mlock)
+    [  30] = F(workingset_restore)
+    [  31] = F(nr_writeback_temp)
+    [  33] = F(pgmigrate_fail)
+    [  38] = F(numa_pte_updates)
+    [  47] = F(nr_free_cma)
+    [  48] = F(pgskip_dma)
+    [  50] = F(numa_hit)
+    [  51] = F(nr_inactive_anon)
+    [  53] = F(nr_active_file)
+    [  56] = F(nr_isolated_anon)
+    [  58] = F(pgmigrate_success)
+    [  65] = F(balloon_migrate)
+    [  71] = F(nr_zone_unevictable)
+    [  74] = F(thp_collapse_alloc_failed)
+    [  75] = F(balloon_deflate)
+    [  83] = F(drop_pagecache)
+    [  87] = F(nr_page_table_pages)
+    [  88] = F(pglazyfree)
+    [  89] = F(allocstall_high)
+    [ 108] = F(nr_dirty_background_threshold)
+    [ 111] = F(htlb_buddy_alloc_success)
+    [ 114] = F(kswapd_low_wmark_hit_quickly)
+    [ 117] = F(pgalloc_dma)
+    [ 128] = F(thp_split_pud)
+    [ 136] = F(slabs_scanned)
+    [ 137] = F(pgskip_movable)
+    [ 143] = F(unevictable_pgs_culled)
+    [ 144] = F(unevictable_pgs_cleared)
+    [ 153] = F(nr_dirty)
+    [ 164] = F(nr_zone_active_file)
+    [ 169] = F(zone_reclaim_failed)
+    [ 172] = F(thp_collapse_alloc)
+    [ 173] = F(nr_zspages)
+    [ 195] = F(nr_zone_write_pending)
+    [ 196] = F(nr_unevictable)
+    [ 202] = F(nr_foll_pin_released)
+    [ 205] = F(pgrefill)
+    [ 209] = F(nr_zone_inactive_anon)
+    [ 218] = F(nr_shmem_hugepages)
+    [ 223] = F(thp_file_fallback)
+    [ 224] = F(unevictable_pgs_rescued)
+    [ 235] = F(thp_split_page_failed)
+    [ 238] = F(pageoutrun)
+    [ 243] = F(compact_migrate_scanned)
+    [ 253] = F(pgfree)
+    [ 256] = F(numa_pages_migrated)
+    [ 269] = F(thp_fault_alloc)
+    [ 273] = F(numa_local)
+    [ 278] = F(pgsteal_file)
+    [ 279] = F(allocstall_normal)
+    [ 291] = F(thp_split_page)
+    [ 301] = F(pgscan_kswapd)
+    [ 318] = F(htlb_buddy_alloc_fail)
+    [ 319] = F(compact_isolated)
+    [ 326] = F(swap_ra)
+    [ 327] = F(numa_interleave)
+    [ 340] = F(pswpin)
+    [ 343] = F(nr_kernel_stack)
+    [ 357] = F(pgrotated)
+    [ 370] = F(pglazyfreed)
+    [ 381] = F(thp_swpout)
+    [ 387] = F(nr_shmem_pmdmapped)
+    [ 394] = F(pgpgout)
+    [ 404] = F(nr_dirty_threshold)
+    [ 406] = F(swap_ra_hit)
+    [ 411] = F(nr_anon_pages)
+    [ 413] = F(pginodesteal)
+    [ 420] = F(kswapd_high_wmark_hit_quickly)
+    [ 427] = F(pgalloc_movable)
+    [ 436] = F(nr_vmscan_write)
+    [ 445] = F(numa_miss)
+    [ 458] = F(nr_inactive_file)
+    [ 460] = F(nr_written)
+    [ 463] = F(nr_isolated_file)
+    [ 480] = F(nr_file_pages)
+    [ 489] = F(numa_foreign)
+    [ 503] = F(thp_swpout_fallback)
+    [ 506] = F(unevictable_pgs_scanned)
+    [ 507] = F(unevictable_pgs_stranded)
+    [ 510] = F(nr_shadow_call_stack)
+    [ 523] = F(thp_fault_fallback)
+    [ 534] = F(workingset_nodes)
+    [ 546] = F(nr_free_pages)
+    [ 550] = F(pgskip_dma32)
+    [ 556] = F(pgsteal_kswapd)
+    [ 557] = F(pgalloc_dma32)
+    [ 579] = F(pgskip_high)
+    [ 586] = F(pgactivate)
+    [ 587] = F(thp_deferred_split_page)
+    [ 592] = F(nr_mapped)
+    [ 605] = F(workingset_activate)
+    [ 616] = F(nr_zone_inactive_file)
+    [ 623] = F(pgsteal_anon)
+    [ 646] = F(numa_huge_pte_updates)
+    [ 649] = F(pgskip_normal)
+    [ 651] = F(compact_free_scanned)
+    [ 656] = F(pgscan_file)
+    [ 665] = F(compact_stall)
+    [ 682] = F(numa_hint_faults_local)
+    [ 684] = F(nr_anon_transparent_hugepages)
+    [ 692] = F(balloon_inflate)
+    [ 698] = F(drop_slab)
+    [ 700] = F(pgsteal_direct)
+    [ 707] = F(thp_file_mapped)
+    [ 708] = F(pgmajfault)
+    [ 711] = F(nr_unstable)
+    [ 716] = F(nr_file_hugepages)
+    [ 725] = F(thp_file_fallback_charge)
+    [ 766] = F(numa_hint_faults)
+    [ 786] = F(pgdeactivate)
+    [ 799] = F(compact_success)
+    [ 805] = F(nr_active_anon)
+    [ 809] = F(pgalloc_normal)
+    [ 810] = F(allocstall_dma32)
+    [ 819] = F(thp_zero_page_alloc_failed)
+    [ 833] = F(nr_slab_reclaimable)
+    [ 838] = F(nr_kernel_misc_reclaimable)
+    [ 844] = F(pgalloc_high)
+    [ 852] = F(nr_file_pmdmapped)
+    [ 855] = F(nr_slab_unreclaimable)
+    [ 861] = F(pswpout)
+    [ 872] = F(pgscan_anon)
+    [ 881] = F(pgscan_direct_throttle)
+    [ 893] = F(nr_shmem)
+    [ 895] = F(pgfault)
+    [ 897] = F(pgpgin)
+    [ 898] = F(allocstall_dma)
+    [ 899] = F(pgscan_direct)
+    [ 916] = F(nr_zone_active_anon)
+    [ 917] = F(thp_zero_page_alloc)
+    [ 921] = F(workingset_nodereclaim)
+    [ 931] = F(allocstall_movable)
+    [ 936] = F(numa_other)
+    [ 941] = F(nr_bounce)
+    [ 942] = F(workingset_refault)
+    [ 955] = F(nr_foll_pin_acquired)
+    [ 960] = F(unevictable_pgs_mlocked)
+    [ 962] = F(unevictable_pgs_munlocked)
+    [ 966] = F(nr_writeback)
+    [ 970] = F(compact_daemon_wake)
+    [ 972] = F(compact_daemon_free_scanned)
+    [ 977] = F(thp_file_alloc)
+    [ 991] = F(compact_daemon_migrate_scanned)
+    [ 997] = F(compact_fail)
+    [1002] = F(oom_kill)
+    [1018] = F(nr_vmscan_immediate_reclaim)
+    [1020] = F(thp_split_pmd)
+};
+
+#undef F
+
+
+static inline unsigned vmstat_hash (
+        const char *s,
+        unsigned len)
+{
+    unsigned hval = len;
+
+    switch (len) {
+        default:
+            hval += vmstat_asso[s[16] & 127];
+            /* fall through */
+        case 16: case 15: case 14: case 13: case 12:
+            hval += vmstat_asso[s[11] & 127];
+            /* fall through */
+        case 11: case 10:
+            hval += vmstat_asso[s[9] & 127];
+            /* fall through */
+        case 9: case 8: case 7: case 6:
+            hval += vmstat_asso[s[5] & 127];
+            /* fall through */
+        case 5: case 4:
+            hval += vmstat_asso[s[3] & 127];
+            /* fall through */
+        case 3: case 2: case 1:
+            break;
+    }
+    hval += vmstat_asso[s[len - 1] & 127];
+    return hval & (VMSTAT_TABLE_SIZE - 1);
+} // end: vmstat_hash
+
+
+        /*
+         * Parse a buffer of "name value" lines, as found in /proc/vmstat
+         * and in each of the sysfs nodeN/vmstat files. */
+static void vmstat_parse (
+        struct vmstat_data *data,
+        char *head,
+        char *end)
+{
+    char *tail;
+
+    /* one pass, with each name hashed and its value then converted in place
+       (/proc/vmstat uses %lu, so there will never be a sign to deal with) */
+    while (head < end) {
+        const vmstat_table_struct *entry;
+        unsigned long num;
+        unsigned len;
+
+        if (!(tail = memchr(head, ' ', end - head)))
+            break;
+        len = tail - head;
+        entry = &vmstat_table[len ? vmstat_hash(head, len) : 0];
+        if (len && entry->len == len && !memcmp(entry->name, head, len)) {
+            for (num = 0, head = tail + 1; *head >= '0' && *head <= '9'; head++)
+                num = num * 10 + (*head - '0');
+            *(unsigned long *)((char *)data + entry->offset) = num;
+            tail = head;
+        }
+        if (!(tail = memchr(tail, '\n', end - tail)))
+            break;
+        head = tail + 1;
+    }
+} // end: vmstat_parse
+
+
+        /*
+         * Age a history, making room for the new values and stamping them. */
+static inline void vmstat_hist_age (
+        struct vmstat_hist *hist)
+{
+    struct timespec ts;
+
+    // remember history from last time around
+    memcpy(&hist->old, &hist->new, sizeof(struct vmstat_data));
+    // clear out the soon to be 'current' values
+    memset(&hist->new, 0, sizeof(struct vmstat_data));
+    hist->old_ns = hist->new_ns;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    hist->new_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+} // end: vmstat_hist_age
 
 
 /*
@@ -1163,14 +1394,9 @@ static int vmstat_read_failed (
         struct vmstat_info *info)
 {
     char buf[VMSTAT_BUFF];
-    char *head, *tail;
     int size;
-    unsigned long *valptr;
 
-    // remember history from last time around
-    memcpy(&info->hist.old, &info->hist.new, sizeof(struct vmstat_data));
-    // clear out the soon to be 'current' values
-    memset(&info->hist.new, 0, sizeof(struct vmstat_data));
+    vmstat_hist_age(&info->hist);
 
 #ifndef __CYGWIN__ /* /proc/vmstat does not exist */
     if (-1 == info->vmstat_fd
@@ -1202,31 +1428,93 @@ static int vmstat_read_failed (
     }
     buf[size] = '\0';
 
-    head = buf;
+    vmstat_parse(&info->hist.new, buf, buf + size);
+#endif /* !__CYGWIN__ */
+    return 0;
+} // end: vmstat_read_failed
 
-    for (;;) {
-        static __thread ENTRY e;  // keep coverity off our backs (e.data)
-        ENTRY *ep;
 
-        if (!(tail = strchr(head, ' ')))
-            break;
-        *tail = '\0';
-        valptr = NULL;
+/*
+ * vmstat_node_read_failed():
+ *
+ * Read the data out of a sysfs nodeN/vmstat file, into that node's
+ * history (which is created as needed). The first read of any node
+ * is copied to its 'old' values, so its deltas start out as zero.
+ */
+static int vmstat_node_read_failed (
+        struct vmstat_info *info,
+        int node)
+{
+    char buf[VMSTAT_BUFF], path[PATH_MAX];
+    struct vmstat_node *this;
+    int i, size;
 
-        e.key = head;
-        if (hsearch_r(e, FIND, &ep, &info->hashtab))
-            valptr = ep->data;
-        head = tail + 1;
-        if (valptr)
-            *valptr = strtoul(head, NULL, 10);
+    if (node >= info->node_alloc) {
+        if (!(this = realloc(info->node_hist, sizeof(struct vmstat_node) * (node + 1))))
+            return 1;
+        memset(this + info->node_alloc, 0, sizeof(struct vmstat_node) * (node + 1 - info->node_alloc));
+        for (i = info->node_alloc; i <= node; i++) {
+            this[i].fd = -1;
+            this[i].hist.node_id = i;
+        }
+        info->node_hist = this;
+        info->node_alloc = node + 1;
+    }
+    this = &info->node_hist[node];
 
-        if (!(tail = strchr(head, '\n')))
-            break;
-        head = tail + 1;
+    if (-1 == this->fd) {
+        snprintf(path, sizeof(path), "%s/node%d/vmstat", NODE_DIR, node);
+        if (-1 == (this->fd = open(path, O_RDONLY)))
+            return 1;
+        this->primed = 0;
+    }
+    // sysfs regenerates an attribute, in full, for each read at offset 0
+    for (;;) {
+        if ((size = pread(this->fd, buf, sizeof(buf)-1, 0)) < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return 1;
+        }
+        break;
+    }
+    if (size == 0) {
+        errno = EIO;
+        return 1;
+    }
+    buf[size] = '\0';
+
+    vmstat_hist_age(&this->hist);
+    vmstat_parse(&this->hist.new, buf, buf + size);
+    if (!this->primed) {
+        memcpy(&this->hist.old, &this->hist.new, sizeof(struct vmstat_data));
+        this->hist.old_ns = 0;
+        this->primed = 1;
     }
-#endif /* !__CYGWIN__ */
     return 0;
-} // end: vmstat_read_failed
+} // end: vmstat_node_read_failed
+
+
+        /*
+         * Close the files of any node no longer in that 'ids' list
+         * (which is ascending), so it starts afresh if it returns. */
+static void vmstat_nodes_offline (
+        struct vmstat_info *info,
+        int *ids,
+        int total)
+{
+    int i, n;
+
+    for (i = 0, n = 0; i < info->node_alloc; i++) {
+        if (n < total && ids[n] == i) {
+            ++n;
+            continue;
+        }
+        if (-1 != info->node_hist[i].fd) {
+            close(info->node_hist[i].fd);
+            info->node_hist[i].fd = -1;
+        }
+    }
+} // end: vmstat_nodes_offline
 
 
 /*
@@ -1241,7 +1529,7 @@ static int vmstat_read_failed (
  * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
  */
 static struct stacks_extent *vmstat_stacks_alloc (
-        struct vmstat_info *info,
+        struct ext_support *this,
         int maxstacks)
 {
     struct stacks_extent *p_blob;
@@ -1254,7 +1542,7 @@ static struct stacks_extent *vmstat_stacks_alloc (
     vect_size  = sizeof(void *) * maxstacks;                   // size of the addr vectors |
     vect_size += sizeof(void *);                               // plus NULL addr delimiter |
     head_size  = sizeof(struct vmstat_stack);                  // size of that head struct |
-    list_size  = sizeof(struct vmstat_result)*info->numitems;  // any single results stack |
+    list_size  = sizeof(struct vmstat_result)*this->numitems;  // any single results stack |
     blob_size  = sizeof(struct stacks_extent);                 // the extent anchor itself |
     blob_size += vect_size;                                    // plus room for addr vects |
     blob_size += head_size * maxstacks;                        // plus room for head thing |
@@ -1266,8 +1554,8 @@ static struct stacks_extent *vmstat_stacks_alloc (
     if (NULL == (p_blob = calloc(1, blob_size)))
         return NULL;
 
-    p_blob->next = info->extents;                              // push this extent onto... |
-    info->extents = p_blob;                                    // ...some existing extents |
+    p_blob->next = this->extents;                              // push this extent onto... |
+    this->extents = p_blob;                                    // ...some existing extents |
     p_vect = (void *)p_blob + sizeof(struct stacks_extent);    // prime our vector pointer |
     p_blob->stacks = p_vect;                                   // set actual vectors start |
     v_head = (void *)p_vect + vect_size;                       // prime head pointer start |
@@ -1275,7 +1563,7 @@ static struct stacks_extent *vmstat_stacks_alloc (
 
     for (i = 0; i < maxstacks; i++) {
         p_head = (struct vmstat_stack *)v_head;
-        p_head->head = vmstat_itemize_stack((struct vmstat_result *)v_list, info->numitems, info->items);
+        p_head->head = vmstat_itemize_stack((struct vmstat_result *)v_list, this->numitems, this->items);
         p_blob->stacks[i] = p_head;
         v_list += list_size;
         v_head += head_size;
@@ -1285,6 +1573,30 @@ static struct stacks_extent *vmstat_stacks_alloc (
 } // end: vmstat_stacks_alloc
 
 
+static int vmstat_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum vmstat_item *items,
+        int numitems)
+{
+    if (vmstat_items_check_failed(numitems, items))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum vmstat_item) * numitems)) {
+        // allow for our VMSTAT_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum vmstat_item) * (numitems + 1))))
+            return -1;
+        memcpy(this->items, items, sizeof(enum vmstat_item) * numitems);
+        this->items[numitems] = VMSTAT_logical_end;
+        this->numitems = numitems + 1;
+        vmstat_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: vmstat_stacks_reconfig_maybe
+
+
 // ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 // --- standard required functions --------------------------------------------
@@ -1324,11 +1636,7 @@ PROCPS_EXPORT int procps_vmstat_new (
 
     p->refcount = 1;
     p->vmstat_fd = -1;
-
-    if (vmstat_make_hash_failed(p)) {
-        free(p);
-        return -errno;
-    }
+    p->hist.node_id = -1;
 
     /* do a priming read here for the following potential benefits: |
          1) ensure there will be no problems with subsequent access |
@@ -1368,12 +1676,17 @@ PROCPS_EXPORT int procps_vmstat_unref (
 
         if ((*info)->vmstat_fd != -1)
             close((*info)->vmstat_fd);
+        if ((*info)->node_hist) {
+            vmstat_nodes_offline(*info, NULL, 0);
+            free((*info)->node_hist);
+        }
 
-        if ((*info)->extents)
-            vmstat_extents_free_all((*info));
-        if ((*info)->items)
-            free((*info)->items);
-        hdestroy_r(&(*info)->hashtab);
+        vmstat_extents_free_all(&(*info)->select);
+        if ((*info)->select.items)
+            free((*info)->select.items);
+        vmstat_extents_free_all(&(*info)->nodes);
+        if ((*info)->nodes.items)
+            free((*info)->nodes.items);
 
         free(*info);
         *info = NULL;
@@ -1418,6 +1731,56 @@ PROCPS_EXPORT struct vmstat_result *procps_vmstat_get (
 } // end: procps_vmstat_get
 
 
+/* procps_vmstat_reap():
+ *
+ * Harvest the requested vmstat information for each of the numa nodes,
+ * from the sysfs nodeN/vmstat files, then return it in a results stack
+ * per node (in node number order).
+ *
+ * Note: only some of the /proc/vmstat fields have a per node value.
+ *
+ * Returns: pointer to a vmstat_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct vmstat_reaped *procps_vmstat_reap (
+        struct vmstat_info *info,
+        enum vmstat_item *items,
+        int numitems)
+{
+    int ids[NUMA_NODES_MAX];
+    int i, n, total;
+
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > vmstat_stacks_reconfig_maybe(&info->nodes, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    // without numa (or that sysfs directory), there simply are no nodes
+    if (0 > (total = numa_nodes_online(ids, NUMA_NODES_MAX)))
+        total = 0;
+    // a node which goes offline as we read is ignored, just like the rest
+    for (i = 0, n = 0; i < total; i++)
+        if (!vmstat_node_read_failed(info, ids[i]))
+            ids[n++] = ids[i];
+    vmstat_nodes_offline(info, ids, n);
+
+    if (!info->nodes.extents
+    || info->nodes.extents->ext_numstacks != n) {
+        vmstat_extents_free_all(&info->nodes);
+        if (!vmstat_stacks_alloc(&info->nodes, n))
+            return NULL;
+    }
+    for (i = 0; i < n; i++)
+        vmstat_assign_results(info->nodes.extents->stacks[i], &info->node_hist[ids[i]].hist);
+
+    info->reaped.total = n;
+    info->reaped.stacks = info->nodes.extents->stacks;
+    errno = 0;               // (some node we skipped may have set it)
+    return &info->reaped;
+} // end: procps_vmstat_reap
+
+
 /* procps_vmstat_select():
  *
  * Harvest all the requested /proc/vmstat information then return
@@ -1433,35 +1796,109 @@ PROCPS_EXPORT struct vmstat_stack *procps_vmstat_select (
     errno = EINVAL;
     if (info == NULL || items == NULL)
         return NULL;
-    if (vmstat_items_check_failed(numitems, items))
-        return NULL;
+    if (0 > vmstat_stacks_reconfig_maybe(&info->select, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
     errno = 0;
 
-    /* is this the first time or have things changed since we were last called?
-       if so, gotta' redo all of our stacks stuff ... */
-    if (info->numitems != numitems + 1
-    || memcmp(info->items, items, sizeof(enum vmstat_item) * numitems)) {
-        // allow for our VMSTAT_logical_end
-        if (!(info->items = realloc(info->items, sizeof(enum vmstat_item) * (numitems + 1))))
-            return NULL;
-        memcpy(info->items, items, sizeof(enum vmstat_item) * numitems);
-        info->items[numitems] = VMSTAT_logical_end;
-        info->numitems = numitems + 1;
-        if (info->extents)
-            vmstat_extents_free_all(info);
-    }
-    if (!info->extents
-    && (!vmstat_stacks_alloc(info, 1)))
+    if (!info->select.extents
+    && (!vmstat_stacks_alloc(&info->select, 1)))
        return NULL;
 
     if (vmstat_read_failed(info))
         return NULL;
-    vmstat_assign_results(info->extents->stacks[0], &info->hist);
+    vmstat_assign_results(info->select.extents->stacks[0], &info->hist);
 
-    return info->extents->stacks[0];
+    return info->select.extents->stacks[0];
 } // end: procps_vmstat_select
 
 
+/* procps_vmstat_select_node():
+ *
+ * Just like procps_vmstat_select, but for a single numa node.  The
+ * stack returned is the one also used by procps_vmstat_select.
+ *
+ * Returns: pointer to a vmstat_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct vmstat_stack *procps_vmstat_select_node (
+        struct vmstat_info *info,
+        int node,
+        enum vmstat_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (node < 0 || node >= NUMA_NODES_MAX)
+        return NULL;
+    if (0 > vmstat_stacks_reconfig_maybe(&info->select, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select.extents
+    && (!vmstat_stacks_alloc(&info->select, 1)))
+       return NULL;
+
+    if (vmstat_node_read_failed(info, node))
+        return NULL;
+    vmstat_assign_results(info->select.extents->stacks[0], &info->node_hist[node].hist);
+
+    return info->select.extents->stacks[0];
+} // end: procps_vmstat_select_node
+
+
+/*
+ * procps_vmstat_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct vmstat_stack **procps_vmstat_sort (
+        struct vmstat_info *info,
+        struct vmstat_stack *stacks[],
+        int numstacked,
+        enum vmstat_item sortitem,
+        enum vmstat_sort_order order)
+{
+    struct vmstat_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // a vmstat_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= VMSTAT_logical_end)
+        return NULL;
+    if (order != VMSTAT_SORT_ASCEND && order != VMSTAT_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= VMSTAT_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    if (!mergesort_r(stacks, numstacked, (QSR_t)Item_table[p->item].sortfunc, &parms))
+        return NULL;
+    return stacks;
+} // end: procps_vmstat_sort
+
+
 // --- special debugging function(s) ------------------------------------------
 /*
  *  The following isn't part of the normal programming interface.  Rather,
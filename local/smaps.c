@@ -0,0 +1,141 @@
+/*
+ * smaps.c - a single pass tokenizer for /proc/<pid>/smaps and smaps_rollup
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <string.h>
+
+#include "smaps.h"
+
+/*
+ * Shared by readproc.c (for smaps_rollup) and pmap (for each vma in smaps).
+ *
+ * A perfect hash in the gperf style, as with meminfo.c and vmstat.c:
+ *   length + asso[1st char] + asso[3rd char] + asso[last char]
+ * masked to SMAPS_TABLE_SIZE.  A name not in the table simply fails the
+ * length or memcmp test, and then has a field of -1.
+ *
+ * Adding a field means searching out a new 'asso' where none of those
+ * names collide.  Any duplicate index in the table below will be flagged
+ * by gcc's -Woverride-init.
+ */
+
+#define SMAPS_TABLE_SIZE 64
+
+static const unsigned char smaps_asso[] =
+{
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,  32,   0,   0,   0,   0,
+	 12,   0,   0,   0,   0,   4,  16,  39,   0,   0,
+	 51,   0,  41,  34,   5,  13,  40,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,  49,  31,  44,
+	 55,  16,   4,   0,   0,  58,   0,   0,  16,  49,
+	 23,   6,  32,   0,  61,   2,   0,   0,   0,   0,
+	  0,  39,  49,   0,   0,   0,   0,   0
+};
+
+static const struct {
+	const char *name;
+	unsigned char len;
+	unsigned char field;
+} smaps_table[SMAPS_TABLE_SIZE] = {
+#define F(x) { #x, sizeof(#x) - 1, SMAPS_ ## x },
+	[ 0] = F(Shared_Hugetlb)
+	[ 6] = F(Shared_Dirty)
+	[13] = F(Pss_File)
+	[15] = F(MMUPageSize)
+	[17] = F(Private_Clean)
+	[19] = F(THPeligible)
+	[20] = F(Pss_Anon)
+	[21] = F(KSM)
+	[24] = F(ShmemPmdMapped)
+	[25] = F(LazyFree)
+	[27] = F(Private_Hugetlb)
+	[28] = F(SwapPss)
+	[31] = F(KernelPageSize)
+	[32] = F(FilePmdMapped)
+	[33] = F(Private_Dirty)
+	[37] = F(Pss_Dirty)
+	[39] = F(Size)
+	[45] = F(ProtectionKey)
+	[46] = F(Referenced)
+	[47] = F(Pss_Shmem)
+	[48] = F(Rss)
+	[49] = F(Anonymous)
+	[53] = F(AnonHugePages)
+	[54] = F(Shared_Clean)
+	[55] = F(Swap)
+	[57] = F(Locked)
+	[58] = F(Pss)
+	[61] = F(VmFlags)
+#undef F
+};
+
+int smaps_field(const char *name, unsigned len)
+{
+	unsigned hval = len;
+
+	if (!len)
+		return -1;
+	if (len > 2)
+		hval += smaps_asso[name[2] & 127];
+	hval += smaps_asso[name[0] & 127] + smaps_asso[name[len - 1] & 127];
+	hval &= SMAPS_TABLE_SIZE - 1;
+	if (smaps_table[hval].len != len || memcmp(smaps_table[hval].name, name, len))
+		return -1;
+	return smaps_table[hval].field;
+}
+
+/*
+ * Tokenize the line at 'head', returning where the next one begins or NULL
+ * at 'end'.  A vma header (whose address is lower case hex) is reported with
+ * a NULL name, otherwise it's a "Name:   value [kB]" line.
+ */
+char *smaps_line(char *head, const char *end, struct smaps_line *line)
+{
+	char *eol, *p;
+
+	if (head >= end)
+		return NULL;
+	if (!(eol = memchr(head, '\n', end - head)))
+		eol = (char *)end;
+	memset(line, 0, sizeof(*line));
+	line->field = -1;
+
+	if ((*head >= 'A' && *head <= 'Z') && (p = memchr(head, ':', eol - head))) {
+		line->name = head;
+		line->len = p - head;
+		line->field = smaps_field(head, line->len);
+		for (++p; p < eol && (*p == ' ' || *p == '\t'); p++)
+			;
+		line->value = p;
+		line->vlen = eol - p;
+		if (p < eol && *p >= '0' && *p <= '9') {
+			line->numeric = 1;
+			for ( ; p < eol && *p >= '0' && *p <= '9'; p++)
+				line->num = line->num * 10 + (*p - '0');
+		}
+	} else {
+		line->value = head;
+		line->vlen = eol - head;
+	}
+	return eol < end ? eol + 1 : eol;
+}
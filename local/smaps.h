@@ -0,0 +1,69 @@
+/*
+ * smaps.h - the fields of /proc/<pid>/smaps and smaps_rollup
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PROCPS_SMAPS_H
+#define PROCPS_SMAPS_H
+
+/* the known fields, in the kernel's own order (which we don't rely on) */
+enum smaps_field {
+	SMAPS_Size,
+	SMAPS_KernelPageSize,
+	SMAPS_MMUPageSize,
+	SMAPS_Rss,
+	SMAPS_Pss,
+	SMAPS_Pss_Dirty,
+	SMAPS_Pss_Anon,
+	SMAPS_Pss_File,
+	SMAPS_Pss_Shmem,
+	SMAPS_Shared_Clean,
+	SMAPS_Shared_Dirty,
+	SMAPS_Private_Clean,
+	SMAPS_Private_Dirty,
+	SMAPS_Referenced,
+	SMAPS_Anonymous,
+	SMAPS_KSM,
+	SMAPS_LazyFree,
+	SMAPS_AnonHugePages,
+	SMAPS_ShmemPmdMapped,
+	SMAPS_FilePmdMapped,
+	SMAPS_Shared_Hugetlb,
+	SMAPS_Private_Hugetlb,
+	SMAPS_Swap,
+	SMAPS_SwapPss,
+	SMAPS_Locked,
+	SMAPS_THPeligible,
+	SMAPS_ProtectionKey,
+	SMAPS_VmFlags,
+	SMAPS_NUMFIELDS
+};
+
+/* one line from either file, without anything being copied */
+struct smaps_line {
+	const char *name;		/* the field name, NULL for a vma header */
+	unsigned len;			/* its length, not including the ':' */
+	int field;			/* its enum smaps_field, -1 if unknown */
+	const char *value;		/* the text following the ':' and blanks */
+	unsigned vlen;			/* its length, not including any newline */
+	int numeric;			/* that value began with a digit, */
+	unsigned long num;		/* so was converted (as kB, typically) */
+};
+
+int smaps_field(const char *name, unsigned len);
+char *smaps_line(char *head, const char *end, struct smaps_line *line);
+
+#endif
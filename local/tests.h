@@ -2,8 +2,11 @@
 #ifndef PROCPS_NG_TESTS_H
 #define PROCPS_NG_TESTS_H
 
+#include <fcntl.h>
+#include <ftw.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 typedef int (*TestFunction)(void *data);
 
@@ -27,4 +30,50 @@ static inline int run_tests(TestFunction *list, void *data)
     }
     return EXIT_SUCCESS;
 }
+
+/*
+ * Benchmarks only time things, so they're opt-in (TESTS_BENCH=1 make check).
+ * Otherwise, such a test just passes without doing any work.
+ */
+static inline int tests_bench(void)
+{
+    return NULL != getenv("TESTS_BENCH");
+}
+
+static inline int tests_unlink(const char *path, const struct stat *sb, int type, struct FTW *ftw)
+{
+    (void)sb; (void)ftw;
+    return unlinkat(AT_FDCWD, path, (type == FTW_DP) ? AT_REMOVEDIR : 0);
+}
+
+/*
+ * Remove a directory with everything in it, never following symlinks.
+ */
+static inline int tests_remove_dir(const char *dir)
+{
+    return nftw(dir, tests_unlink, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+/*
+ * For tests reading synthetic files, run them within a private directory
+ * made from the mkdtemp 'template' (so it's altered in place), after any
+ * 'setup' of its contents. That directory is also the current one while
+ * they run, and is then removed along with all it holds.
+ */
+static inline int run_tests_in_dir(TestFunction *list, void *data, char *template, int (*setup)(void))
+{
+    int rc;
+
+    if (!mkdtemp(template))
+        return EXIT_FAILURE;
+    if (chdir(template) < 0
+    || (setup && !setup()))
+        rc = EXIT_FAILURE;
+    else
+        rc = run_tests(list, data);
+    if (chdir("/") < 0
+    || tests_remove_dir(template) < 0)
+        rc = EXIT_FAILURE;
+    return rc;
+}
 #endif
@@ -0,0 +1,388 @@
+/*
+ * cgtop.c - utility to display cgroup v2 control group statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <locale.h>
+#include <ncurses.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "c.h"
+#include "fileutils.h"
+#include "nls.h"
+#include "strutils.h"
+#include "units.h"
+
+#include "cgroups.h"
+
+#define DEFAULT_SORT  CGROUPS_DELTA_CPU_USAGE_PCT
+#define MAXTBL(t) (int)( sizeof(t) / sizeof(t[0]) )
+#define DEFAULT_DELAY 3
+
+static unsigned short Cols, Rows;
+static struct termios Saved_tty;
+static long Delay = 0;
+static int Human = 0;
+static int Run_once = 0;
+
+static struct cgroups_info *Cgroups_info;
+
+enum cgroups_item Sort_item = DEFAULT_SORT;
+enum cgroups_sort_order Sort_Order = CGROUPS_SORT_DESCEND;
+
+enum cgroups_item Node_items[] = {
+    CGROUPS_DELTA_CPU_USAGE_PCT,     CGROUPS_DELTA_CPU_THROTTLED_PCT,
+    CGROUPS_MEM_CURRENT,             CGROUPS_MEM_ANON,
+    CGROUPS_MEM_FILE,                CGROUPS_DELTA_IO_RBYTES_PER_SEC,
+    CGROUPS_DELTA_IO_WBYTES_PER_SEC, CGROUPS_NAME,
+    CGROUPS_DEPTH,
+    /* next 2 are sortable but are not displayable,
+       thus they need not be represented in the Relative_enums */
+    CGROUPS_MEM_KERNEL, CGROUPS_DELTA_MEM_PGMAJFAULT };
+
+enum Relative_node {
+    nod_CPU,  nod_THRT, nod_MEM,  nod_ANON,
+    nod_FILE, nod_READ, nod_WRITE, nod_NAME,
+    nod_DEPTH };
+
+#define PRINT_line(fmt, ...) if (Run_once) printf(fmt, __VA_ARGS__); else printw(fmt, __VA_ARGS__)
+
+
+/*
+ * term_resize - set the globals 'Cols' and 'Rows' to the current terminal size
+ */
+static void term_resize (int unusused __attribute__ ((__unused__)))
+{
+    struct winsize ws;
+
+    if ((ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != -1) && ws.ws_row > 10) {
+        Cols = ws.ws_col;
+        Rows = ws.ws_row;
+    } else {
+        Cols = 80;
+        Rows = 24;
+    }
+}
+
+static void sigint_handler (int unused __attribute__ ((__unused__)))
+{
+    Delay = 0;
+}
+
+static void __attribute__((__noreturn__)) usage (FILE *out)
+{
+    fputs(USAGE_HEADER, out);
+    fprintf(out, _(" %s [options]\n"), program_invocation_short_name);
+    fputs(USAGE_OPTIONS, out);
+    fputs(_(" -d, --delay <secs>  delay updates\n"), out);
+    fputs(_(" -o, --once          only display once, then exit\n"), out);
+    fputs(_(" --human             show human-readable output\n"), out);
+    fputs(_(" -s, --sort <char>   specify sort criteria by character (see below)\n"), out);
+    fputs(USAGE_SEPARATOR, out);
+    fputs(USAGE_HELP, out);
+    fputs(USAGE_VERSION, out);
+
+    fputs(_("\nThe following are valid sort criteria:\n"), out);
+    fputs(_(" a: sort by anonymous memory\n"), out);
+    fputs(_(" c: sort by cpu usage (the default)\n"), out);
+    fputs(_(" f: sort by file (page cache) memory\n"), out);
+    fputs(_(" j: sort by (non display) major page faults\n"), out);
+    fputs(_(" k: sort by (non display) kernel memory\n"), out);
+    fputs(_(" m: sort by memory usage\n"), out);
+    fputs(_(" n: sort by name\n"), out);
+    fputs(_(" r: sort by bytes read\n"), out);
+    fputs(_(" t: sort by cpu throttling\n"), out);
+    fputs(_(" w: sort by bytes written\n"), out);
+    fprintf(out, USAGE_MAN_TAIL("cgtop(1)"));
+
+    exit(out == stderr ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+static void set_sort_stuff (const char key)
+{
+    Sort_item = DEFAULT_SORT;
+    Sort_Order = CGROUPS_SORT_DESCEND;
+
+    switch (tolower(key)) {
+    case 'n':
+        Sort_item = CGROUPS_NAME;
+        Sort_Order = CGROUPS_SORT_ASCEND;
+        break;
+    case 'c':
+        Sort_item = CGROUPS_DELTA_CPU_USAGE_PCT;
+        break;
+    case 't':
+        Sort_item = CGROUPS_DELTA_CPU_THROTTLED_PCT;
+        break;
+    case 'm':
+        Sort_item = CGROUPS_MEM_CURRENT;
+        break;
+    case 'a':
+        Sort_item = CGROUPS_MEM_ANON;
+        break;
+    case 'f':
+        Sort_item = CGROUPS_MEM_FILE;
+        break;
+    case 'k':
+        Sort_item = CGROUPS_MEM_KERNEL;
+        break;
+    case 'j':
+        Sort_item = CGROUPS_DELTA_MEM_PGMAJFAULT;
+        break;
+    case 'r':
+        Sort_item = CGROUPS_DELTA_IO_RBYTES_PER_SEC;
+        break;
+    case 'w':
+        Sort_item = CGROUPS_DELTA_IO_WBYTES_PER_SEC;
+        break;
+    default:
+        break;
+    }
+}
+
+static void parse_opts (int argc, char **argv)
+{
+
+    enum {
+        HUMAN_OPTION = CHAR_MAX + 1,
+    };
+    static const struct option longopts[] = {
+        { "human",   no_argument,       NULL, HUMAN_OPTION },
+        { "delay",   required_argument, NULL, 'd' },
+        { "sort",    required_argument, NULL, 's' },
+        { "once",    no_argument,       NULL, 'o' },
+        { "help",    no_argument,       NULL, 'h' },
+        { "version", no_argument,       NULL, 'V' },
+        {  NULL,     0,                 NULL,  0  }};
+    int o;
+
+    while ((o = getopt_long(argc, argv, "d:s:ohV", longopts, NULL)) != -1) {
+        switch (o) {
+        case HUMAN_OPTION:
+            Human = 1;
+            break;
+        case 'd':
+            if (Run_once)
+                errx(EXIT_FAILURE, _("Cannot combine -d and -o options"));
+            errno = 0;
+            Delay = strtol_or_err(optarg, _("illegal delay"));
+            if (Delay < 1)
+                errx(EXIT_FAILURE, _("delay must be positive integer"));
+            break;
+        case 's':
+            set_sort_stuff(optarg[0]);
+            break;
+        case 'o':
+            if (Delay != 0)
+                errx(EXIT_FAILURE, _("Cannot combine -d and -o options"));
+            Run_once=1;
+            break;
+        case 'V':
+            printf(PROCPS_NG_VERSION);
+            exit(EXIT_SUCCESS);
+        case 'h':
+            usage(stdout);
+        default:
+            usage(stderr);
+        }
+    }
+    if (optind != argc)
+        usage(stderr);
+    if (!Run_once && Delay == 0)
+        Delay = DEFAULT_DELAY;
+}
+
+/*
+ * The root group's cpu & io are those of the system as a whole, while
+ * its memory (absent a memory.current) is the sum of its children.
+ */
+static void print_summary (struct cgroups_reaped *reaped, struct cgroups_stack *root)
+{
+ #define rootVAL(e,t) CGROUPS_VAL(e, t, root)
+    unsigned long long memory = 0;
+    int i;
+
+    for (i = 0; i < reaped->total; i++)
+        if (CGROUPS_VAL(nod_DEPTH, s_int, reaped->stacks[i]) == 1)
+            memory += CGROUPS_VAL(nod_MEM, ull_int, reaped->stacks[i]);
+
+    PRINT_line(" %-22s: %d\n"
+               , /* Translation Hint: Next four strings must not
+                  * exceed a length of 22 characters.  */
+                 _("Control Groups")
+               , reaped->total);
+    PRINT_line(" %-22s: %.1f%% / %.1f%%\n"
+               , /* xgettext:no-c-format */
+                 _("CPU Used / Throttled")
+               , rootVAL(nod_CPU,  real)
+               , rootVAL(nod_THRT, real));
+    PRINT_line(" %-22s: %s\n"
+               , _("Memory of Children")
+               , scale_size(memory / 1024, 0, 0, Human));
+    PRINT_line(" %-22s: %s / "
+               , _("Read / Write per Sec")
+               , scale_size(rootVAL(nod_READ, real) / 1024, 0, 0, Human));
+    PRINT_line("%s\n\n"
+               , scale_size(rootVAL(nod_WRITE, real) / 1024, 0, 0, Human));
+ #undef rootVAL
+}
+
+static void print_headings (void)
+{
+    /* Translation Hint: Please keep alignment of the
+     * following intact. */
+    PRINT_line("%-80s\n", /* xgettext:no-c-format */ _("  %CPU %THRT   MEMORY     ANON     FILE   READ/s  WRITE/s NAME"));
+}
+
+static void print_details (struct cgroups_stack *stack)
+{
+ #define nodeVAL(e,t) CGROUPS_VAL(e, t, stack)
+    char mem[16], anon[16], file[16], rd[16];
+
+    // scale_size uses but one static buffer, so all but the last are copied
+    snprintf(mem,  sizeof(mem),  "%s", scale_size(nodeVAL(nod_MEM,  ull_int) / 1024, 0, 0, Human));
+    snprintf(anon, sizeof(anon), "%s", scale_size(nodeVAL(nod_ANON, ull_int) / 1024, 0, 0, Human));
+    snprintf(file, sizeof(file), "%s", scale_size(nodeVAL(nod_FILE, ull_int) / 1024, 0, 0, Human));
+    snprintf(rd,   sizeof(rd),   "%s", scale_size(nodeVAL(nod_READ, real) / 1024, 0, 0, Human));
+    PRINT_line("%6.1f %5.1f %8s %8s %8s %8s %8s %s\n"
+        , nodeVAL(nod_CPU,  real)
+        , nodeVAL(nod_THRT, real)
+        , mem
+        , anon
+        , file
+        , rd
+        , scale_size(nodeVAL(nod_WRITE, real) / 1024, 0, 0, Human)
+        , nodeVAL(nod_NAME, str));
+
+    return;
+ #undef nodeVAL
+}
+
+
+int main(int argc, char *argv[])
+{
+    int is_tty = 0, rc = EXIT_SUCCESS;
+    unsigned short old_rows = 0;
+
+#ifdef HAVE_PROGRAM_INVOCATION_NAME
+    program_invocation_name = program_invocation_short_name;
+#endif
+    setlocale (LC_ALL, "");
+    bindtextdomain(PACKAGE, LOCALEDIR);
+    textdomain(PACKAGE);
+    atexit(close_stdout);
+
+    parse_opts(argc, argv);
+
+    if ((rc = procps_cgroups_new(&Cgroups_info)) < 0) {
+        errno = -rc;
+        err(EXIT_FAILURE, _("Unable to create cgroups structure"));
+    }
+    rc = EXIT_SUCCESS;
+
+    if (!Run_once) {
+        is_tty = isatty(STDIN_FILENO);
+        if (is_tty && tcgetattr(STDIN_FILENO, &Saved_tty) == -1)
+            warn(_("terminal setting retrieval"));
+        old_rows = Rows;
+        term_resize(0);
+        initscr();
+        resizeterm(Rows, Cols);
+        signal(SIGWINCH, term_resize);
+        signal(SIGINT, sigint_handler);
+    } else
+        // those rates & percentages need some interval, however brief
+        sleep(1);
+
+    do {
+        struct cgroups_reaped *reaped;
+        struct cgroups_stack *root;
+        struct timeval tv;
+        fd_set readfds;
+        int i;
+
+        if (!(reaped = procps_cgroups_reap(Cgroups_info, Node_items, MAXTBL(Node_items)))) {
+            warn(_("Unable to get cgroups data"));
+            rc = EXIT_FAILURE;
+            break;
+        }
+        // the root is always first, before any sort
+        root = reaped->stacks[0];
+
+        if (!(procps_cgroups_sort(Cgroups_info, reaped->stacks, reaped->total, Sort_item, Sort_Order))) {
+            warn(_("Unable to sort cgroups"));
+            rc = EXIT_FAILURE;
+            break;
+        }
+
+        if (Run_once) {
+            print_summary(reaped, root);
+            print_headings();
+            for (i = 0; i < reaped->total; i++)
+                print_details(reaped->stacks[i]);
+            break;
+        }
+
+        if (old_rows != Rows) {
+            resizeterm(Rows, Cols);
+            old_rows = Rows;
+        }
+        move(0, 0);
+        print_summary(reaped, root);
+        attron(A_REVERSE);
+        print_headings();
+        attroff(A_REVERSE);
+
+        for (i = 0; i < Rows - 7 && i < reaped->total; i++)
+            print_details(reaped->stacks[i]);
+        clrtobot();
+
+        refresh();
+        FD_ZERO(&readfds);
+        FD_SET(STDIN_FILENO, &readfds);
+        tv.tv_sec = Delay;
+        tv.tv_usec = 0;
+        if (select(STDOUT_FILENO, &readfds, NULL, NULL, &tv) > 0) {
+            char c;
+            if (read(STDIN_FILENO, &c, 1) != 1
+            || (c == 'Q' || c == 'q'))
+                break;
+            set_sort_stuff(c);
+        }
+    // made zero by sigint_handler()
+    } while (Delay);
+
+    if (!Run_once) {
+        if (is_tty)
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &Saved_tty);
+        endwin();
+    }
+    procps_cgroups_unref(&Cgroups_info);
+    return rc;
+}
@@ -55,6 +55,7 @@
 #define FREE_REPEATCOUNT	(1 << 7)
 #define FREE_COMMITTED		(1 << 8)
 #define FREE_LINE		(1 << 9)
+#define FREE_NUMA		(1 << 10)
 
 struct commandline_arguments {
 	int exponent;		/* demanded in kilos, magas... */
@@ -87,6 +88,7 @@ static void __attribute__ ((__noreturn__))
 	fputs(_("     --si            use powers of 1000 not 1024\n"), out);
 	fputs(_(" -l, --lohi          show detailed low and high memory statistics\n"), out);
 	fputs(_(" -L, --line          show output on a single line\n"), out);
+	fputs(_(" -N, --numa          show memory for each numa node\n"), out);
 	fputs(_(" -t, --total         show total for RAM + swap\n"), out);
 	fputs(_(" -v, --committed     show committed memory and commit limit\n"), out);
 	fputs(_(" -s N, --seconds N   repeat printing every N seconds\n"), out);
@@ -137,6 +139,46 @@ static void print_head_col(const char *str)
     printf("%s%.*s", str, spaces, "         ");
 }
 
+/*
+ * Print a line for each numa node, with just those columns the kernel
+ * provides per node (so there's never an 'available' amount shown).
+ */
+static void print_nodes(struct meminfo_info *mem_info, struct commandline_arguments *args, int flags)
+{
+	enum meminfo_item items[] = {
+		MEMINFO_NODE_ID, MEMINFO_MEM_TOTAL, MEMINFO_MEM_USED, MEMINFO_MEM_FREE,
+		MEMINFO_MEM_SHARED, MEMINFO_MEM_BUFFERS, MEMINFO_MEM_CACHED_ALL };
+	enum rel_items {
+		node_id, node_total, node_used, node_free,
+		node_shared, node_buffers, node_cached };
+	struct meminfo_reaped *reaped;
+	struct meminfo_stack *stack;
+	char label[32];
+	int i;
+
+	if (!(reaped = procps_meminfo_reap(mem_info, items, sizeof(items) / sizeof(items[0]))))
+		errx(EXIT_FAILURE, _("Unable to read numa node memory"));
+	for (i = 0; i < reaped->total; i++) {
+		stack = reaped->stacks[i];
+		snprintf(label, sizeof(label), _("Node%d:"), MEMINFO_VAL(node_id, s_int, stack));
+		print_head_col(label);
+		printf("%11s", scale_size(MEMINFO_VAL(node_total, ul_int, stack), args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+		printf(" %11s", scale_size(MEMINFO_VAL(node_used, ul_int, stack), args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+		printf(" %11s", scale_size(MEMINFO_VAL(node_free, ul_int, stack), args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+		printf(" %11s", scale_size(MEMINFO_VAL(node_shared, ul_int, stack), args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+		if (flags & FREE_WIDE) {
+			printf(" %11s", scale_size(MEMINFO_VAL(node_buffers, ul_int, stack),
+				    args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+			printf(" %11s", scale_size(MEMINFO_VAL(node_cached, ul_int, stack)
+				    , args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+		} else {
+			printf(" %11s", scale_size(MEMINFO_VAL(node_buffers, ul_int, stack) +
+				    MEMINFO_VAL(node_cached, ul_int, stack), args->exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
+		}
+		printf("\n");
+	}
+}
+
 int main(int argc, char **argv)
 {
 	int c, flags = 0, unit_set = 0, rc = 0;
@@ -175,6 +217,7 @@ int main(int argc, char **argv)
 		{  "si",	no_argument,	    NULL,  SI_OPTION	},
 		{  "lohi",	no_argument,	    NULL,  'l'		},
 		{  "line",	no_argument,	    NULL,  'L'		},
+		{  "numa",	no_argument,	    NULL,  'N'		},
 		{  "total",	no_argument,	    NULL,  't'		},
 		{  "committed",	no_argument,	    NULL,  'v'		},
 		{  "seconds",	required_argument,  NULL,  's'		},
@@ -198,7 +241,7 @@ int main(int argc, char **argv)
 	textdomain(PACKAGE);
 	atexit(close_stdout);
 
-	while ((c = getopt_long(argc, argv, "bkmghlLtvc:ws:V", longopts, NULL)) != -1)
+	while ((c = getopt_long(argc, argv, "bkmghlLNtvc:ws:V", longopts, NULL)) != -1)
 		switch (c) {
 		case 'b':
 		        check_unit_set(&unit_set);
@@ -261,6 +304,9 @@ int main(int argc, char **argv)
 		case 'L':
 			flags |= FREE_LINE;
 			break;
+		case 'N':
+			flags |= FREE_NUMA;
+			break;
 		case 't':
 			flags |= FREE_TOTAL;
 			break;
@@ -367,6 +413,8 @@ int main(int argc, char **argv)
 			printf(" %11s", scale_size(MEMINFO_GET(mem_info, MEMINFO_MEM_HIGH_FREE, ul_int), args.exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
 			printf("\n");
 		}
+		if (flags & FREE_NUMA)
+			print_nodes(mem_info, &args, flags);
 
 		print_head_col(_("Swap:"));
 		printf("%11s", scale_size(MEMINFO_GET(mem_info, MEMINFO_SWAP_TOTAL, ul_int), args.exponent, flags & FREE_SI, flags & FREE_HUMANREADABLE));
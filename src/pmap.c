@@ -25,6 +25,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,16 +34,22 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <wchar.h>
 #include <assert.h>
 #include <limits.h>
 
 #include "c.h"
 #include "fileutils.h"
 #include "nls.h"
+#include "smaps.h"
 #include "xalloc.h"
 
 #include "pids.h"
 
+#ifndef PMAP_PROC_DIR
+#define PMAP_PROC_DIR  "/proc"
+#endif
+
 static struct pids_info *Pids_info;
 
 enum pids_item Pid_items[] = {
@@ -86,14 +93,14 @@ static void nls_initialize(void)
 	nls_Dirty   = _("Dirty");
 }
 
-static int justify_print(const char *str, int width, int right)
+static int justify_print(FILE *out, const char *str, int width, int right)
 {
 	if (width < 1)
-		puts(str);
+		fprintf(out, "%s\n", str);
 	else {
 		int len = strlen(str);
 		if (width < len) width = len;
-		printf(right ? "%*.*s " : "%-*.*s ", width, width, str);
+		fprintf(out, right ? "%*.*s " : "%-*.*s ", width, width, str);
 	}
 	return width;
 }
@@ -140,8 +147,6 @@ usage(FILE * out)
 	exit(out == stderr ? EXIT_FAILURE : EXIT_SUCCESS);
 }
 
-static char mapbuf[1024];
-
 static unsigned long range_low;
 static unsigned long range_high = ~0ul;
 
@@ -231,13 +236,12 @@ static const char *mapping_name(struct pids_stack *p, unsigned long addr,
 				unsigned long len, const char *mapbuf_b,
 				unsigned showpath, unsigned dev_major,
 				unsigned dev_minor, unsigned long long inode,
-				unsigned use_kname)
+				unsigned use_kname, char *shmbuf, int shmlen)
 {
 	const char *cp;
 
 	if (!dev_major && dev_minor == shm_minor && strstr(mapbuf_b, "/SYSV")) {
-		static char shmbuf[64];
-		snprintf(shmbuf, sizeof shmbuf, "  [ shmid=0x%llx ]", inode);
+		snprintf(shmbuf, shmlen, "  [ shmid=0x%llx ]", inode);
 		return shmbuf;
 	}
 
@@ -262,22 +266,16 @@ static const char *mapping_name(struct pids_stack *p, unsigned long addr,
 
 
 #define DETAIL_LENGTH 32
-#define DETL "31"		/* for format strings */
-#define NUM_LENGTH 21		/* python says: len(str(2**64)) == 20 */
-#define NUML "20"		/* for format strings */
-#define VMFLAGS_LENGTH 128	/* 30 2-char space-separated flags == 90+1, but be safe */
-#define VMFL "127"		/* for format strings */
 
 struct listnode {
 	char description[DETAIL_LENGTH];
-	char value_str[NUM_LENGTH];
-	unsigned long value;
 	unsigned long total;
 	int max_width;
 	struct listnode *next;
 };
 
-static struct listnode *listhead=NULL, *listtail=NULL, *listnode;
+/* the -c/-X/-XX columns, their widths accumulated across all the PIDs */
+static struct listnode *listhead=NULL;
 
 
 struct cnf_listnode {
@@ -303,12 +301,14 @@ static int is_unimportant (const char *s)
 /* check, whether we want to display the field or not */
 static int is_enabled (const char *s)
 {
+	struct cnf_listnode *cnf;
+
 	if (X_option == 1) return !is_unimportant(s);
 
 	if (c_option) {  /* taking the list of disabled fields from the rc file */
 
-		for (cnf_listnode = cnf_listhead; cnf_listnode; cnf_listnode = cnf_listnode -> next) {
-			if (!strcmp(s, cnf_listnode -> description)) return 1;
+		for (cnf = cnf_listhead; cnf; cnf = cnf -> next) {
+			if (!strcmp(s, cnf -> description)) return 1;
 		}
 		return 0;
 
@@ -318,218 +318,348 @@ static int is_enabled (const char *s)
 }
 
 
-static void print_extended_maps (FILE *f)
-{
-	char perms[DETAIL_LENGTH], map_desc[128],
-	     detail_desc[DETAIL_LENGTH], value_str[NUM_LENGTH],
-	     start[NUM_LENGTH], end[NUM_LENGTH],
-	     offset[NUM_LENGTH], inode[NUM_LENGTH],
-	     dev[64], vmflags[VMFLAGS_LENGTH];
-	int maxw1=0, maxw2=0, maxw3=0, maxw4=0, maxw5=0, maxwv=0;
-	int nfields, firstmapping, footer_gap, i, maxw_;
-	char *ret, *map_basename, c, has_vmflags = 0;
+/* a vma header, "start-end perms offset dev inode [name]", split in place */
+struct vma_head {
+	char *start, *end, *perms, *offset, *dev, *inode, *name;
+};
+
+/* one -c/-X/-XX mapping, as measured and then later printed */
+struct vma_row {
+	struct vma_head head;
+	char *vmflags;
 	int in_range;
+	int nvals;			/* how many of the columns it supplied, */
+	int vals;			/* beginning at this job's vals[] index */
+};
 
-	ret = fgets(mapbuf, sizeof mapbuf, f);
-	firstmapping = 2;
-	while (ret != NULL) {
-		/* === READ MAPPING === */
-		map_desc[0] = '\0';
-		nfields = sscanf(mapbuf,
-				 "%"NUML"[0-9a-f]-%"NUML"[0-9a-f] "
-				 "%"DETL"s %"NUML"[0-9a-f] "
-				 "%63[0-9a-f:] %"NUML"s %127[^\n]",
-				 start, end, perms, offset,
-				 dev, inode, map_desc);
-		/* Must read at least up to inode, else something has changed! */
-		if (nfields < 6)
-			errx(EXIT_FAILURE, _("Unknown format in smaps file!"));
-		/* If line too long we dump everything else. */
-		c = mapbuf[strlen(mapbuf) - 1];
-		while (c != '\n') {
-			fgets(mapbuf, sizeof mapbuf, f);
-			if (!ret || !mapbuf[0])
-				errx(EXIT_FAILURE, _("Unknown format in smaps file!"));
-			c = mapbuf[strlen(mapbuf) - 1];
+/* everything about one PID, so that several can be handled at once */
+struct pmap_job {
+	struct pids_stack *p;
+	char *buf;			/* all of smaps (or maps), NUL terminated */
+	int len;
+	int ret;
+	struct listnode *list;		/* this PID's own columns and totals */
+	struct vma_row *rows;
+	int nrows, rows_alloc;
+	char **vals;
+	int nvals, vals_alloc;
+	int maxw1, maxw2, maxw3, maxw4, maxw5, maxwv;
+	int has_vmflags;
+	char *out;			/* this PID's output, until its turn */
+	size_t outlen;
+};
+
+static unsigned use_kname;
+
+
+/* read that file whole, with a spare byte so that the last line can always
+   be NUL terminated (there's no need to then ever copy a line or a field) */
+static char *slurp (const char *path, int *len)
+{
+	int fd, num, have = 0, size = 64 * 1024;
+	char *buf;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+	buf = xmalloc(size);
+	for (;;) {
+		if (size - have < 2)
+			buf = xrealloc(buf, (size *= 2));
+		num = read(fd, buf + have, size - have - 1);
+		if (num < 0) {
+			if (errno == EINTR)
+				continue;
+			free(buf);
+			close(fd);
+			return NULL;
+		}
+		if (num == 0)
+			break;
+		have += num;
+	}
+	close(fd);
+	buf[have] = '\0';
+	*len = have;
+	return buf;
+}
+
+/* split a header line (never a "Name: value" one) into its fields */
+static int vma_header (const struct smaps_line *line, struct vma_head *v)
+{
+	char *p = (char *)line->value, **fld[] = {
+		&v->end, &v->perms, &v->offset, &v->dev, &v->inode };
+	unsigned i;
+
+	p[line->vlen] = '\0';
+	v->start = p;
+	p += strcspn(p, "-");
+	if (!*p)
+		return 0;
+	*p++ = '\0';
+	for (i = 0; i < sizeof(fld) / sizeof(fld[0]); i++) {
+		while (*p == ' ')
+			p++;
+		if (!*p)
+			return 0;
+		*fld[i] = p;
+		p += strcspn(p, " ");
+		if (*p)
+			*p++ = '\0';
+	}
+	while (*p == ' ')
+		p++;
+	v->name = p;
+	return 1;
+}
+
+/* to clean up unprintables, with a shift state of our own (not mblen's) */
+static void mb_clean (char *s)
+{
+	size_t n, len = strlen(s);
+	mbstate_t ps;
+
+	memset(&ps, 0, sizeof(ps));
+	while (len) {
+		n = mbrlen(s, len, &ps);
+		if (n == (size_t)-1 || n == (size_t)-2) {
+			*s++ = '?';
+			len--;
+			memset(&ps, 0, sizeof(ps));
+		} else {
+			if (n == 0) n = 1;
+			s += n;
+			len -= n;
 		}
+	}
+}
 
-		in_range = 1;
-		{
-			unsigned long start_n, end_n;
-			start_n = strtoul(start, NULL, 16);
-			end_n = strtoul(end, NULL, 16);
 
-			if (end_n - 1 < range_low)
-				in_range = 0;
-			if (range_high < start_n)
-				in_range = 0;
+/* the -c/-X/-XX first pass, done once over the buffer, splitting each line
+   in place while measuring widths and tallying totals for our columns */
+static void smaps_measure (struct pmap_job *job)
+{
+	char *s = job->buf, *end = job->buf + job->len, *v;
+	char detail_desc[DETAIL_LENGTH];
+	struct smaps_line line;
+	struct listnode *node, **tail;
+	struct vma_row *row;
+	unsigned long start_n, end_n;
+	int n, maxw_;
+
+	s = smaps_line(s, end, &line);
+	while (s != NULL) {
+		/* === READ MAPPING === */
+		if (job->nrows >= job->rows_alloc) {
+			job->rows_alloc = job->rows_alloc ? job->rows_alloc * 2 : 256;
+			job->rows = xrealloc(job->rows, sizeof(*row) * job->rows_alloc);
 		}
+		row = &job->rows[job->nrows++];
+		memset(row, 0, sizeof(*row));
+		/* Must read at least up to inode, else something has changed! */
+		if (line.name || !vma_header(&line, &row->head))
+			errx(EXIT_FAILURE, _("Unknown format in smaps file!"));
+
+		start_n = strtoul(row->head.start, NULL, 16);
+		end_n = strtoul(row->head.end, NULL, 16);
+		row->in_range = !(end_n - 1 < range_low || range_high < start_n);
 
 		/* Store maximum widths for printing nice later */
-		if ((int)strlen(start ) > maxw1)	maxw1 = strlen(start);
-		if ((int)strlen(perms ) > maxw2)	maxw2 = strlen(perms);
-		if ((int)strlen(offset) > maxw3)	maxw3 = strlen(offset);
-		if ((int)strlen(dev   ) > maxw4)	maxw4 = strlen(dev);
-		if ((int)strlen(inode ) > maxw5)	maxw5 = strlen(inode);
-
-		ret = fgets(mapbuf, sizeof mapbuf, f);
-		nfields = ret ? sscanf(mapbuf, "%"DETL"[^:]: %"NUML"[0-9] kB %c",
-					detail_desc, value_str, &c) : 0;
-		listnode = listhead;
+		if ((int)strlen(row->head.start ) > job->maxw1)	job->maxw1 = strlen(row->head.start);
+		if ((int)strlen(row->head.perms ) > job->maxw2)	job->maxw2 = strlen(row->head.perms);
+		if ((int)strlen(row->head.offset) > job->maxw3)	job->maxw3 = strlen(row->head.offset);
+		if ((int)strlen(row->head.dev   ) > job->maxw4)	job->maxw4 = strlen(row->head.dev);
+		if ((int)strlen(row->head.inode ) > job->maxw5)	job->maxw5 = strlen(row->head.inode);
+
+		row->vals = job->nvals;
+		node = job->list;
+		tail = &job->list;
+		while (*tail) tail = &(*tail)->next;
+		s = smaps_line(s, end, &line);
 		/* === READ MAPPING DETAILS === */
-		while (ret != NULL && nfields == 2) {
-
+		while (s != NULL && line.name && line.numeric) {
+			n = line.len < DETAIL_LENGTH ? line.len : DETAIL_LENGTH - 1;
+			memcpy(detail_desc, line.name, n);
+			detail_desc[n] = '\0';
 			if (!is_enabled(detail_desc)) goto loop_end;
 
 			/* === CREATE LIST AND FILL description FIELD === */
-			if (listnode == NULL) {
-				assert(firstmapping == 2);
-				listnode = calloc(1, sizeof *listnode);
-				if (listnode == NULL)
-					errx(EXIT_FAILURE, _("ERROR: memory allocation failed"));
-
-				if (listhead == NULL) {
-					assert(listtail == NULL);
-					listhead = listnode;
-				} else {
-					listtail->next = listnode;
-				}
-				listtail = listnode;
-				/* listnode was calloc()ed so all fields are already NULL! */
-				strcpy(listnode->description, detail_desc);
-				if (!q_option) listnode->max_width = strlen(detail_desc);
-				else listnode->max_width = 0;
-			} else {
-			/* === LIST EXISTS  === */
-				if (strcmp(listnode->description, detail_desc) != 0)
-					errx(EXIT_FAILURE, "ERROR: %s %s",
-					      _("inconsistent detail field in smaps file, line:\n"),
-					      mapbuf);
+			if (node == NULL) {
+				node = xcalloc(1, sizeof *node);
+				*tail = node;
+				tail = &node->next;
+				strcpy(node->description, detail_desc);
+				if (!q_option) node->max_width = strlen(detail_desc);
+			} else if (strcmp(node->description, detail_desc) != 0)
+				errx(EXIT_FAILURE, "ERROR: %s %s",
+				      _("inconsistent detail field in smaps file, line:\n"),
+				      detail_desc);
+
+			/* the digits stay where they are, just terminated */
+			for (v = (char *)line.value; isdigit(*v); v++)
+				;
+			*v = '\0';
+			if (job->nvals >= job->vals_alloc) {
+				job->vals_alloc = job->vals_alloc ? job->vals_alloc * 2 : 4096;
+				job->vals = xrealloc(job->vals, sizeof(char *) * job->vals_alloc);
 			}
-			strcpy(listnode->value_str, value_str);
-			sscanf(value_str, "%lu", &listnode->value);
-			if (firstmapping == 2) {
-				if (in_range) {
-					listnode->total += listnode->value;
-					if (q_option) {
-						maxw_ = strlen(listnode->value_str);
-						if (maxw_ > listnode->max_width)
-							listnode->max_width = maxw_;
-					}
+			job->vals[job->nvals++] = (char *)line.value;
+			row->nvals++;
+			if (row->in_range) {
+				node->total += line.num;
+				if (q_option) {
+					maxw_ = v - line.value;
+					if (maxw_ > node->max_width)
+						node->max_width = maxw_;
 				}
 			}
-			listnode = listnode->next;
+			node = node->next;
 loop_end:
-			ret = fgets(mapbuf, sizeof mapbuf, f);
-			nfields = ret ? sscanf(mapbuf, "%"DETL"[^:]: %"NUML"[0-9] kB %c",
-						detail_desc, value_str, &c) : 0;
+			s = smaps_line(s, end, &line);
 		}
 
 		/* === GET VMFLAGS === */
-		nfields = ret ? sscanf(mapbuf, "VmFlags: %"VMFL"[a-z ]", vmflags) : 0;
-		if (nfields == 1) {
-			int len = strlen(vmflags);
-			if (len > 0 && vmflags[len-1] == ' ') vmflags[--len] = '\0';
-			if (len > maxwv) maxwv = len;
-			if (! has_vmflags) has_vmflags = 1;
-			ret = fgets(mapbuf, sizeof mapbuf, f);
+		if (s != NULL && line.field == SMAPS_VmFlags) {
+			row->vmflags = (char *)line.value;
+			n = line.vlen;
+			while (n > 0 && row->vmflags[n-1] == ' ') n--;
+			row->vmflags[n] = '\0';
+			if (n > job->maxwv) job->maxwv = n;
+			job->has_vmflags = 1;
+			s = smaps_line(s, end, &line);
 		}
+	}
 
-		if (firstmapping == 2) { /* width measurement stage, do not print anything yet */
-			if (ret == NULL) {	/* once the end of file is reached ...*/
-				firstmapping = 1;  /* ... we reset the file position to the beginning of the file */
-				fseek(f, 0, SEEK_SET);  /* ... and repeat the process with printing enabled */
-				ret = fgets(mapbuf, sizeof mapbuf, f); /* this is not ideal and needs to be redesigned one day */
-
-				if (!q_option) {
-					/* calculate width of totals */
-					for (listnode=listhead; listnode!=NULL; listnode=listnode->next) {
-						maxw_ = integer_width(listnode->total);
-						if (maxw_ > listnode->max_width)
-							listnode->max_width = maxw_;
-					}
-				}
+	if (!q_option) {
+		/* calculate width of totals */
+		for (node = job->list; node != NULL; node = node->next) {
+			maxw_ = integer_width(node->total);
+			if (maxw_ > node->max_width)
+				node->max_width = maxw_;
+		}
+	}
+}
 
-			}
-		} else {		 /* the maximum widths have been measured, we've already reached the printing stage */
-			/* === PRINT THIS MAPPING === */
+/* with the PIDs in their order, widen the shared columns by this one's then
+   give it all of them, any it lacked showing zero totals as always they did */
+static void smaps_widths (struct pmap_job *job)
+{
+	struct listnode **all = &listhead, **mine = &job->list;
+
+	for ( ; *mine; all = &(*all)->next, mine = &(*mine)->next) {
+		if (*all == NULL) {
+			*all = xcalloc(1, sizeof **all);
+			strcpy((*all)->description, (*mine)->description);
+		} else if (strcmp((*all)->description, (*mine)->description) != 0)
+			errx(EXIT_FAILURE, "ERROR: %s %s",
+			      _("inconsistent detail field in smaps file, line:\n"),
+			      (*mine)->description);
+		if ((*mine)->max_width > (*all)->max_width)
+			(*all)->max_width = (*mine)->max_width;
+		(*mine)->max_width = (*all)->max_width;
+	}
+	for ( ; *all; all = &(*all)->next, mine = &(*mine)->next) {
+		*mine = xcalloc(1, sizeof **mine);
+		strcpy((*mine)->description, (*all)->description);
+		(*mine)->max_width = (*all)->max_width;
+	}
+}
 
-			/* Print header */
-			if (firstmapping && !q_option) {
+/* the -c/-X/-XX second pass, over what the first left behind */
+static void print_extended_maps (struct pmap_job *job, FILE *out)
+{
+	struct listnode *listnode;
+	struct vma_row *row;
+	const char **cur, *map_basename;
+	int maxw1 = job->maxw1, maxw2 = job->maxw2, maxw3 = job->maxw3,
+	    maxw4 = job->maxw4, maxw5 = job->maxw5, maxwv = job->maxwv;
+	int footer_gap, i, k, ncols = 0;
 
-				maxw1 = justify_print(nls_Address, maxw1, 1);
+	for (listnode = job->list; listnode != NULL; listnode = listnode->next)
+		ncols++;
+	cur = xcalloc(ncols + 1, sizeof(char *));
+	for (k = 0; k < ncols; k++)
+		cur[k] = "";
 
-				if (is_enabled(nls_Perm))
-					maxw2 = justify_print(nls_Perm, maxw2, 1);
+	for (i = 0; i < job->nrows; i++) {
+		row = &job->rows[i];
+		/* === PRINT THIS MAPPING === */
 
-				if (is_enabled(nls_Offset))
-					maxw3 = justify_print(nls_Offset, maxw3, 1);
+		/* Print header */
+		if (i == 0 && !q_option) {
 
-				if (is_enabled(nls_Device))
-					maxw4 = justify_print(nls_Device, maxw4, 1);
+			maxw1 = justify_print(out, nls_Address, maxw1, 1);
 
-				if (is_enabled(nls_Inode))
-					maxw5 = justify_print(nls_Inode, maxw5, 1);
+			if (is_enabled(nls_Perm))
+				maxw2 = justify_print(out, nls_Perm, maxw2, 1);
 
-				for (listnode=listhead; listnode!=NULL; listnode=listnode->next)
-					justify_print(listnode->description, listnode->max_width, 1);
+			if (is_enabled(nls_Offset))
+				maxw3 = justify_print(out, nls_Offset, maxw3, 1);
 
-				if (has_vmflags && is_enabled("VmFlags"))
-					maxwv = justify_print("VmFlags", maxwv, 1);
+			if (is_enabled(nls_Device))
+				maxw4 = justify_print(out, nls_Device, maxw4, 1);
 
-				if (is_enabled(nls_Mapping))
-					justify_print(nls_Mapping, 0, 0);
-				else
-					printf("\n");
-			}
+			if (is_enabled(nls_Inode))
+				maxw5 = justify_print(out, nls_Inode, maxw5, 1);
 
-			if (!in_range)
-				goto skip_this_data;
+			for (listnode=job->list; listnode!=NULL; listnode=listnode->next)
+				justify_print(out, listnode->description, listnode->max_width, 1);
 
-			/* Print data */
-			printf("%*s", maxw1, start);    /* Address field is always enabled */
+			if (job->has_vmflags && is_enabled("VmFlags"))
+				maxwv = justify_print(out, "VmFlags", maxwv, 1);
 
-			if (is_enabled(nls_Perm))
-				printf(" %*s", maxw2, perms);
+			if (is_enabled(nls_Mapping))
+				justify_print(out, nls_Mapping, 0, 0);
+			else
+				fprintf(out, "\n");
+		}
 
-			if (is_enabled(nls_Offset))
-				printf(" %*s", maxw3, offset);
+		if (!row->in_range)
+			continue;
 
-			if (is_enabled(nls_Device))
-				printf(" %*s", maxw4, dev);
+		/* Print data */
+		fprintf(out, "%*s", maxw1, row->head.start);    /* Address field is always enabled */
 
-			if (is_enabled(nls_Inode))
-				printf(" %*s", maxw5, inode);
+		if (is_enabled(nls_Perm))
+			fprintf(out, " %*s", maxw2, row->head.perms);
 
-			for (listnode=listhead; listnode!=NULL; listnode=listnode->next)
-				printf(" %*s", listnode->max_width, listnode->value_str);
+		if (is_enabled(nls_Offset))
+			fprintf(out, " %*s", maxw3, row->head.offset);
 
-			if (has_vmflags && is_enabled("VmFlags"))
-				printf(" %*s", maxwv, vmflags);
+		if (is_enabled(nls_Device))
+			fprintf(out, " %*s", maxw4, row->head.dev);
 
-			if (is_enabled(nls_Mapping)) {
-				if (map_desc_showpath) {
-					printf(" %s", map_desc);
-				} else {
-					map_basename = strrchr(map_desc, '/');
-					if (!map_basename) {
-						printf(" %s", map_desc);
-					} else {
-						printf(" %s", map_basename + 1);
-					}
+		if (is_enabled(nls_Inode))
+			fprintf(out, " %*s", maxw5, row->head.inode);
 
-				}
-			}
+		/* a mapping short of some fields repeats the prior ones' values */
+		for (k = 0; k < row->nvals; k++)
+			cur[k] = job->vals[row->vals + k];
+		for (listnode=job->list, k=0; listnode!=NULL; listnode=listnode->next, k++)
+			fprintf(out, " %*s", listnode->max_width, cur[k]);
 
-			printf("\n");
+		if (job->has_vmflags && is_enabled("VmFlags"))
+			fprintf(out, " %*s", maxwv, row->vmflags ? row->vmflags : "");
 
-		  skip_this_data:
-			firstmapping = 0;
+		if (is_enabled(nls_Mapping)) {
+			if (map_desc_showpath) {
+				fprintf(out, " %s", row->head.name);
+			} else {
+				map_basename = strrchr(row->head.name, '/');
+				if (!map_basename) {
+					fprintf(out, " %s", row->head.name);
+				} else {
+					fprintf(out, " %s", map_basename + 1);
+				}
 
+			}
 		}
+
+		fprintf(out, "\n");
 	}
+	free(cur);
+
 	/* === PRINT TOTALS === */
-	if (!q_option && listhead!=NULL) { /* footer enabled and non-empty */
+	if (!q_option && job->list!=NULL) { /* footer enabled and non-empty */
 
 		                            footer_gap  = maxw1 + 1; /* Address field is always enabled */
 		if (is_enabled(nls_Perm  )) footer_gap += maxw2 + 1;
@@ -537,40 +667,35 @@ loop_end:
 		if (is_enabled(nls_Device)) footer_gap += maxw4 + 1;
 		if (is_enabled(nls_Inode )) footer_gap += maxw5 + 1;
 
-		for (i=0; i<footer_gap; i++) putc(' ', stdout);
+		for (i=0; i<footer_gap; i++) putc(' ', out);
 
-		for (listnode=listhead; listnode!=NULL; listnode=listnode->next) {
+		for (listnode=job->list; listnode!=NULL; listnode=listnode->next) {
 			for (i=0; i<listnode->max_width; i++)
-				putc('=', stdout);
-			putc(' ', stdout);
+				putc('=', out);
+			putc(' ', out);
 		}
 
-		putc('\n', stdout);
+		putc('\n', out);
 
-		for (i=0; i<footer_gap; i++) putc(' ', stdout);
+		for (i=0; i<footer_gap; i++) putc(' ', out);
 
-		for (listnode=listhead; listnode!=NULL; listnode=listnode->next) {
-			printf("%*lu ", listnode->max_width, listnode->total);
-                        listnode->total = 0;
-                }
+		for (listnode=job->list; listnode!=NULL; listnode=listnode->next)
+			fprintf(out, "%*lu ", listnode->max_width, listnode->total);
 
-		fputs("KB \n", stdout);
+		fputs("KB \n", out);
 	}
-	/* We don't free() the list, it's used for all PIDs passed as arguments */
 }
 
-	// variable placed here to silence compiler 'uninitialized' warning
-static unsigned long start_To_Avoid_Warning;
-
-static int one_proc (struct pids_stack *p, unsigned use_kname)
+static void print_maps (struct pmap_job *job, FILE *out)
 {
-	char buf[32];
-	FILE *fp;
+	struct pids_stack *p = job->p;
+	char *s = job->buf, *end = job->buf + job->len;
+	char shmbuf[64];
 	unsigned long total_shared = 0ul;
 	unsigned long total_private_readonly = 0ul;
 	unsigned long total_private_writeable = 0ul;
 	unsigned long diff = 0;
-	unsigned long end;
+	unsigned long start = 0, end_n;
 	char perms[32] = "";
 	const char *cp2 = NULL;
 	unsigned long long rss = 0ull;
@@ -581,36 +706,18 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 	unsigned long long total_shared_dirty = 0ull;
 	int maxw1=0, maxw2=0, maxw3=0, maxw4=0, maxw5=0;
 
-	printf("%u:   %s\n", PIDS_VAL(tgid, s_int, p), PIDS_VAL(cmdline, str, p));
-
-	if (x_option || X_option || c_option) {
-		snprintf(buf, sizeof buf, "/proc/%u/smaps", PIDS_VAL(tgid, s_int, p));
-		if ((fp = fopen(buf, "r")) == NULL)
-			return 1;
-	} else {
-		snprintf(buf, sizeof buf, "/proc/%u/maps", PIDS_VAL(tgid, s_int, p));
-		if ((fp = fopen(buf, "r")) == NULL)
-			return 1;
-	}
-
-	if (X_option || c_option) {
-		print_extended_maps(fp);
-        fclose(fp);
-		return 0;
-	}
-
 	if (x_option) {
 		maxw1 = 16;
 		if (sizeof(long) == 4) maxw1 = 8;
 		maxw2 = maxw3 = maxw4 = 7;
 		maxw5 = 5;
 		if (!q_option) {
-			maxw1 = justify_print(nls_Address, maxw1, 0);
-			maxw2 = justify_print(nls_Kbytes, maxw2, 1);
-			maxw3 = justify_print(nls_RSS, maxw3, 1);
-			maxw4 = justify_print(nls_Dirty, maxw4, 1);
-			maxw5 = justify_print(nls_Mode, maxw5, 0);
-			justify_print(nls_Mapping, 0, 0);
+			maxw1 = justify_print(out, nls_Address, maxw1, 0);
+			maxw2 = justify_print(out, nls_Kbytes, maxw2, 1);
+			maxw3 = justify_print(out, nls_RSS, maxw3, 1);
+			maxw4 = justify_print(out, nls_Dirty, maxw4, 1);
+			maxw5 = justify_print(out, nls_Mode, maxw5, 0);
+			justify_print(out, nls_Mapping, 0, 0);
 		}
 	}
 
@@ -622,88 +729,80 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 		maxw4 = 16;
 		maxw5 = 9;
 		if (!q_option) {
-			maxw1 = justify_print(nls_Address, maxw1, 0);
-			maxw2 = justify_print(nls_Kbytes, maxw2, 1);
-			maxw3 = justify_print(nls_Mode, maxw3, 0);
-			maxw4 = justify_print(nls_Offset, maxw4, 0);
-			maxw5 = justify_print(nls_Device, maxw5, 0);
-			justify_print(nls_Mapping, 0, 0);
+			maxw1 = justify_print(out, nls_Address, maxw1, 0);
+			maxw2 = justify_print(out, nls_Kbytes, maxw2, 1);
+			maxw3 = justify_print(out, nls_Mode, maxw3, 0);
+			maxw4 = justify_print(out, nls_Offset, maxw4, 0);
+			maxw5 = justify_print(out, nls_Device, maxw5, 0);
+			justify_print(out, nls_Mapping, 0, 0);
 		}
 	}
 
-	while (fgets(mapbuf, sizeof mapbuf, fp)) {
-		/* to clean up unprintables */
-		char *tmp;
+	while (s != NULL) {
 		unsigned long long file_offset, inode;
 		unsigned dev_major, dev_minor;
-		unsigned long long smap_value;
-		char smap_key[21];
+		struct smaps_line line;
+		struct vma_head head;
 
-		/* hex values are lower case or numeric, keys are upper */
-		if (mapbuf[0] >= 'A' && mapbuf[0] <= 'Z') {
+		if (!(s = smaps_line(s, end, &line)))
+			break;
+		if (line.name) {
 			/* Its a key */
-			if (sscanf(mapbuf, "%20[^:]: %llu", smap_key, &smap_value) == 2) {
-				if (strcmp("Rss", smap_key) == 0) {
-					rss = smap_value;
-					total_rss += smap_value;
+			if (line.numeric) {
+				if (line.field == SMAPS_Rss) {
+					rss = line.num;
+					total_rss += line.num;
 					continue;
 				}
-				if (strcmp("Shared_Dirty", smap_key) == 0) {
-					shared_dirty = smap_value;
-					total_shared_dirty += smap_value;
+				if (line.field == SMAPS_Shared_Dirty) {
+					shared_dirty = line.num;
+					total_shared_dirty += line.num;
 					continue;
 				}
-				if (strcmp("Private_Dirty", smap_key) == 0) {
-					private_dirty = smap_value;
-					total_private_dirty += smap_value;
+				if (line.field == SMAPS_Private_Dirty) {
+					private_dirty = line.num;
+					total_private_dirty += line.num;
 					continue;
 				}
-				if (strcmp("Swap", smap_key) == 0) {
+				if (line.field == SMAPS_Swap) {
 					/* doesn't matter as long as last */
 					if (cp2)
-                        printf("%0*lx %*lu %*llu %*llu %*s %s\n",
-                               maxw1, start_To_Avoid_Warning,
-                               maxw2, (unsigned long)(diff >> 10),
-                               maxw3, rss,
-                               maxw4, (private_dirty + shared_dirty),
-                               maxw5, perms,
-                               cp2);
+						fprintf(out, "%0*lx %*lu %*llu %*llu %*s %s\n",
+							maxw1, start,
+							maxw2, (unsigned long)(diff >> 10),
+							maxw3, rss,
+							maxw4, (private_dirty + shared_dirty),
+							maxw5, perms,
+							cp2);
 					/* reset some counters */
 					rss = shared_dirty = private_dirty = 0ull;
-                    diff = end = 0;
-                    perms[0] = '\0';
-                    cp2 = NULL;
+					diff = 0;
+					perms[0] = '\0';
+					cp2 = NULL;
 					continue;
 				}
 			}
 			/* Other keys or not a key-value pair */
 			continue;
 		}
-		sscanf(mapbuf, "%lx-%lx %31s %llx %x:%x %llu",
-		       &start_To_Avoid_Warning,
-		       &end, perms, &file_offset, &dev_major, &dev_minor,
-		       &inode);
-
-		if (end - 1 < range_low)
+		if (!vma_header(&line, &head))
+			continue;
+		start = strtoul(head.start, NULL, 16);
+		end_n = strtoul(head.end, NULL, 16);
+		file_offset = strtoull(head.offset, NULL, 16);
+		dev_major = strtoul(head.dev, NULL, 16);
+		dev_minor = strchr(head.dev, ':') ? strtoul(strchr(head.dev, ':') + 1, NULL, 16) : 0;
+		inode = strtoull(head.inode, NULL, 10);
+		snprintf(perms, sizeof(perms), "%s", head.perms);
+
+		if (end_n - 1 < range_low)
 			continue;
-		if (range_high < start_To_Avoid_Warning)
+		if (range_high < start)
 			break;
 
-		tmp = strchr(mapbuf, '\n');
-		if (tmp)
-			*tmp = '\0';
-		tmp = mapbuf;
-		while (*tmp) {
-			int n = mblen(tmp, strlen(tmp));
-			if (n < 0) {
-				*tmp = '?';
-				tmp++;
-			} else {
-				tmp += n;
-			}
-		}
+		mb_clean(head.name);
 
-		diff = end - start_To_Avoid_Warning;
+		diff = end_n - start;
 		if (perms[3] == 's')
 			total_shared += diff;
 		if (perms[3] == 'p') {
@@ -721,18 +820,18 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 		perms[5] = '\0';
 
 		if (x_option) {
-			cp2 =
-			    mapping_name(p, start_To_Avoid_Warning, diff, mapbuf, map_desc_showpath, dev_major,
-					 dev_minor, inode, use_kname);
 			/* printed with the keys */
+			cp2 =
+			    mapping_name(p, start, diff, head.name, map_desc_showpath, dev_major,
+					 dev_minor, inode, use_kname, shmbuf, sizeof(shmbuf));
 			continue;
 		}
 		if (d_option) {
 			const char *cp =
-			    mapping_name(p, start_To_Avoid_Warning, diff, mapbuf, map_desc_showpath, dev_major,
-					 dev_minor, inode, use_kname);
-			printf("%0*lx %*lu %*s %0*llx %*.*s%03x:%05x %s\n",
-			       maxw1, start_To_Avoid_Warning,
+			    mapping_name(p, start, diff, head.name, map_desc_showpath, dev_major,
+					 dev_minor, inode, use_kname, shmbuf, sizeof(shmbuf));
+			fprintf(out, "%0*lx %*lu %*s %0*llx %*.*s%03x:%05x %s\n",
+			       maxw1, start,
 			       maxw2, (unsigned long)(diff >> 10),
 			       maxw3, perms,
 			       maxw4, file_offset,
@@ -741,29 +840,28 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 		}
 		if (!x_option && !d_option) {
 			const char *cp =
-			    mapping_name(p, start_To_Avoid_Warning, diff, mapbuf, map_desc_showpath, dev_major,
-					 dev_minor, inode, use_kname);
-			printf((sizeof(long) == 8)
+			    mapping_name(p, start, diff, head.name, map_desc_showpath, dev_major,
+					 dev_minor, inode, use_kname, shmbuf, sizeof(shmbuf));
+			fprintf(out, (sizeof(long) == 8)
 			       ? "%016lx %6luK %s %s\n"
 			       : "%08lx %6luK %s %s\n",
-			       start_To_Avoid_Warning, (unsigned long)(diff >> 10), perms, cp);
+			       start, (unsigned long)(diff >> 10), perms, cp);
 		}
 
 	}
-	fclose(fp);
 	if (!q_option) {
 		if (x_option) {
 			if (sizeof(long) == 4)
-				justify_print("--------", maxw1, 0);
+				justify_print(out, "--------", maxw1, 0);
 			else
-				justify_print("----------------", maxw1, 0);
-			justify_print("-------", maxw2, 1);
-			justify_print("-------", maxw3, 1);
-			justify_print("-------", maxw4, 1);
-			printf("\n");
-
-			printf("%-*s ", maxw1, _("total kB"));
-			printf("%*ld %*llu %*llu\n",
+				justify_print(out, "----------------", maxw1, 0);
+			justify_print(out, "-------", maxw2, 1);
+			justify_print(out, "-------", maxw3, 1);
+			justify_print(out, "-------", maxw4, 1);
+			fprintf(out, "\n");
+
+			fprintf(out, "%-*s ", maxw1, _("total kB"));
+			fprintf(out, "%*ld %*llu %*llu\n",
 				maxw2, (total_shared +
 					total_private_writeable +
 					total_private_readonly) >> 10,
@@ -772,8 +870,8 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 					total_private_dirty));
 		}
 		if (d_option) {
-			printf
-			    (_("mapped: %ldK    writeable/private: %ldK    shared: %ldK\n"),
+			fprintf
+			    (out, _("mapped: %ldK    writeable/private: %ldK    shared: %ldK\n"),
 			     (total_shared + total_private_writeable +
 			      total_private_readonly) >> 10,
 			     total_private_writeable >> 10, total_shared >> 10);
@@ -782,19 +880,101 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 			if (sizeof(long) == 8)
 				/* Translation Hint: keep total string length
 				 * as 24 characters. Adjust %16 if needed*/
-				printf(_(" total %16ldK\n"),
+				fprintf(out, _(" total %16ldK\n"),
 				       (total_shared + total_private_writeable +
 					total_private_readonly) >> 10);
 			else
 				/* Translation Hint: keep total string length
 				 * as 16 characters. Adjust %8 if needed*/
-				printf(_(" total %8ldK\n"),
+				fprintf(out, _(" total %8ldK\n"),
 				       (total_shared + total_private_writeable +
 					total_private_readonly) >> 10);
 		}
 	}
+}
 
-	return 0;
+
+/* the first of two rounds for every PID, reading (and for -c/-X/-XX also
+   measuring) its mappings -- the order they're done in is of no concern */
+static void job_read (struct pmap_job *job)
+{
+	char path[64];
+
+	snprintf(path, sizeof path, "%s/%u/%s", PMAP_PROC_DIR, PIDS_VAL(tgid, s_int, job->p)
+		, (x_option || X_option || c_option) ? "smaps" : "maps");
+	if (!(job->buf = slurp(path, &job->len))) {
+		job->ret = 1;
+		return;
+	}
+	if (X_option || c_option)
+		smaps_measure(job);
+}
+
+/* the second round, with the output held until all before it were written */
+static void job_print (struct pmap_job *job)
+{
+	FILE *out;
+
+	if (!(out = open_memstream(&job->out, &job->outlen)))
+		err(EXIT_FAILURE, "open_memstream");
+	fprintf(out, "%u:   %s\n", PIDS_VAL(tgid, s_int, job->p), PIDS_VAL(cmdline, str, job->p));
+	if (job->buf) {
+		if (X_option || c_option)
+			print_extended_maps(job, out);
+		else
+			print_maps(job, out);
+	}
+	fclose(out);
+	free(job->buf);
+	free(job->rows);
+	free(job->vals);
+	job->buf = NULL;
+	job->rows = NULL;
+	job->vals = NULL;
+}
+
+
+static struct pmap_job *Jobs;
+static int Jobs_total, Jobs_next;
+static void (*Jobs_func)(struct pmap_job *);
+static pthread_mutex_t Jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *jobs_worker (void *unused)
+{
+	int i;
+
+	(void)unused;
+	for (;;) {
+		pthread_mutex_lock(&Jobs_lock);
+		i = Jobs_next++;
+		pthread_mutex_unlock(&Jobs_lock);
+		if (i >= Jobs_total)
+			break;
+		Jobs_func(&Jobs[i]);
+	}
+	return NULL;
+}
+
+/* run that function for every job, on as many threads as there are cpus
+   (but no more than there are jobs), with this thread being one of them */
+static void jobs_run (void (*func)(struct pmap_job *))
+{
+	pthread_t *tids;
+	long cpus;
+	int i, made = 0;
+
+	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpus > Jobs_total) cpus = Jobs_total;
+	Jobs_func = func;
+	Jobs_next = 0;
+	tids = xcalloc(cpus > 1 ? cpus : 1, sizeof(pthread_t));
+	for (i = 1; i < cpus; i++)
+		if (!pthread_create(&tids[made], NULL, jobs_worker, NULL))
+			made++;
+	jobs_worker(NULL);
+	for (i = 0; i < made; i++)
+		pthread_join(tids[i], NULL);
+	free(tids);
 }
 
 static void range_arguments(const char *optarg)
@@ -1056,9 +1236,9 @@ int main(int argc, char **argv)
 	struct pids_fetch *pids_fetch;
 	unsigned *pidlist;
 	int reap_count, user_count;
-	int ret = 0, c, conf_ret;
+	struct listnode *listnode;
+	int ret = 0, c, i, conf_ret;
 	char *rc_filename = NULL;
-	unsigned use_kname = 0;
 
 	static const struct option longopts[] = {
 		{"extended", no_argument, NULL, 'x'},
@@ -1228,9 +1408,27 @@ int main(int argc, char **argv)
 	if (!(pids_fetch = procps_pids_select(Pids_info, pidlist, user_count, PIDS_SELECT_PID)))
 		errx(EXIT_FAILURE, _("library failed pids statistics"));
 
-	for (reap_count = 0; reap_count < pids_fetch->counts->total; reap_count++) {
-		ret |= one_proc(pids_fetch->stacks[reap_count], use_kname);
+	/* the PIDs are read and printed concurrently, but output in order */
+	reap_count = pids_fetch->counts->total;
+	Jobs = xcalloc(reap_count + 1, sizeof(*Jobs));
+	for (Jobs_total = 0; Jobs_total < reap_count; Jobs_total++)
+		Jobs[Jobs_total].p = pids_fetch->stacks[Jobs_total];
+	jobs_run(job_read);
+	if (X_option || c_option)
+		for (i = 0; i < Jobs_total; i++)
+			smaps_widths(&Jobs[i]);
+	jobs_run(job_print);
+	for (i = 0; i < Jobs_total; i++) {
+		fwrite(Jobs[i].out, 1, Jobs[i].outlen, stdout);
+		free(Jobs[i].out);
+		ret |= Jobs[i].ret;
+		for (listnode = Jobs[i].list; listnode != NULL; ) {
+			Jobs[i].list = listnode->next;
+			free(listnode);
+			listnode = Jobs[i].list;
+		}
 	}
+	free(Jobs);
 
 	free(pidlist);
 	procps_pids_unref(&Pids_info);
@@ -92,6 +92,8 @@ makEXT(CGNAME)
 makEXT(CGROUP)
 makEXT(CMD)
 makEXT(CMDLINE)
+makEXT(CTXSW_INVOL)
+makEXT(CTXSW_VOL)
 makEXT(DOCKER_ID)
 makEXT(ENVIRON)
 makEXT(EXE)
@@ -152,6 +154,9 @@ makEXT(RSS)
 makEXT(RSS_RLIM)
 makEXT(SCHED_CLASS)
 makEXT(SCHED_CLASSSTR)
+makEXT(SCHED_RUNTIME_NS)
+makEXT(SCHED_TIMESLICES)
+makEXT(SCHED_WAIT_NS)
 makEXT(SD_MACH)
 makEXT(SD_OUID)
 makEXT(SD_SEAT)
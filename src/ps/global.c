@@ -70,6 +70,8 @@ makREL(CGNAME)
 makREL(CGROUP)
 makREL(CMD)
 makREL(CMDLINE)
+makREL(CTXSW_INVOL)
+makREL(CTXSW_VOL)
 makREL(DOCKER_ID)
 makREL(ENVIRON)
 makREL(EXE)
@@ -130,6 +132,9 @@ makREL(RSS)
 makREL(RSS_RLIM)
 makREL(SCHED_CLASS)
 makREL(SCHED_CLASSSTR)
+makREL(SCHED_RUNTIME_NS)
+makREL(SCHED_TIMESLICES)
+makREL(SCHED_WAIT_NS)
 makREL(SD_MACH)
 makREL(SD_OUID)
 makREL(SD_SEAT)
@@ -1327,6 +1327,30 @@ setREL1(IO_WRITE_OPS)
 
 //////////////////////////////////////////////////////////////////////////////////
 
+// scheduler stats
+static int pr_nivcsw(char *restrict const outbuf, const proc_t *restrict const pp){
+setREL1(CTXSW_INVOL)
+  return snprintf(outbuf, COLWID, "%lu", rSv(CTXSW_INVOL, ul_int, pp));
+}
+static int pr_nvcsw(char *restrict const outbuf, const proc_t *restrict const pp){
+setREL1(CTXSW_VOL)
+  return snprintf(outbuf, COLWID, "%lu", rSv(CTXSW_VOL, ul_int, pp));
+}
+static int pr_runns(char *restrict const outbuf, const proc_t *restrict const pp){
+setREL1(SCHED_RUNTIME_NS)
+  return snprintf(outbuf, COLWID, "%llu", rSv(SCHED_RUNTIME_NS, ull_int, pp));
+}
+static int pr_slices(char *restrict const outbuf, const proc_t *restrict const pp){
+setREL1(SCHED_TIMESLICES)
+  return snprintf(outbuf, COLWID, "%lu", rSv(SCHED_TIMESLICES, ul_int, pp));
+}
+static int pr_waitns(char *restrict const outbuf, const proc_t *restrict const pp){
+setREL1(SCHED_WAIT_NS)
+  return snprintf(outbuf, COLWID, "%llu", rSv(SCHED_WAIT_NS, ull_int, pp));
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
 // PID pid, TGID tgid
 static int pr_procs(char *restrict const outbuf, const proc_t *restrict const pp){
 setREL1(ID_TGID)
@@ -1781,13 +1805,13 @@ static const format_struct format_array[] = { /*
 {"netns",     "NETNS",   pr_netns,         PIDS_NS_NET,             10,    LNX,  ET|RIGHT},
 {"ni",        "NI",      pr_nice,          PIDS_NICE,                3,    BSD,  TO|RIGHT}, /*nice*/
 {"nice",      "NI",      pr_nice,          PIDS_NICE,                3,    U98,  TO|RIGHT}, /*ni*/
-{"nivcsw",    "IVCSW",   pr_nop,           PIDS_noop,                5,    XXX,  AN|RIGHT},
+{"nivcsw",    "IVCSW",   pr_nivcsw,        PIDS_CTXSW_INVOL,         5,    XXX,  AN|RIGHT},
 {"nlwp",      "NLWP",    pr_nlwp,          PIDS_NLWP,                4,    SUN,  PO|RIGHT},
 {"nsignals",  "NSIGS",   pr_nop,           PIDS_noop,                5,    DEC,  AN|RIGHT}, /*nsigs*/
 {"nsigs",     "NSIGS",   pr_nop,           PIDS_noop,                5,    BSD,  AN|RIGHT}, /*nsignals*/
 {"nswap",     "NSWAP",   pr_nop,           PIDS_noop,                5,    XXX,  AN|RIGHT},
 {"numa",      "NUMA",    pr_numa,          PIDS_PROCESSOR_NODE,      4,    XXX,  AN|RIGHT},
-{"nvcsw",     "VCSW",    pr_nop,           PIDS_noop,                5,    XXX,  AN|RIGHT},
+{"nvcsw",     "VCSW",    pr_nvcsw,         PIDS_CTXSW_VOL,           5,    XXX,  AN|RIGHT},
 {"nwchan",    "WCHAN",   pr_nop,           PIDS_noop,                6,    XXX,  TO|RIGHT},
 {"oom",       "OOM",     pr_oom,           PIDS_OOM_SCORE,           4,    XXX,  TO|RIGHT},
 {"oomadj",    "OOMADJ",  pr_oom_adj,       PIDS_OOM_ADJ,             5,    XXX,  TO|RIGHT},
@@ -1838,6 +1862,7 @@ static const format_struct format_array[] = { /*
 {"rsz",       "RSZ",     pr_rss,           PIDS_VM_RSS,              5,    BSD,  PO|RIGHT}, /*rssize*/
 {"rtprio",    "RTPRIO",  pr_rtprio,        PIDS_PRIORITY_RT,         6,    BSD,  TO|RIGHT},
 {"ruid",      "RUID",    pr_ruid,          PIDS_ID_RUID,             5,    XXX,  ET|RIGHT},
+{"runns",     "RUNNS",   pr_runns,         PIDS_SCHED_RUNTIME_NS,   10,    LNX,  TO|RIGHT},
 {"ruser",     "RUSER",   pr_ruser,         PIDS_ID_RUSER,            8,    U98,  ET|USER},
 {"s",         "S",       pr_s,             PIDS_STATE,               1,    SUN,  TO|LEFT},  /*stat,state*/
 {"sched",     "SCH",     pr_sched,         PIDS_SCHED_CLASS,         3,    AIX,  TO|RIGHT},
@@ -1863,6 +1888,7 @@ static const format_struct format_array[] = { /*
 {"size",      "SIZE",    pr_swapable,      PIDS_VSIZE_BYTES,         5,    SCO,  PO|RIGHT},
 {"sl",        "SL",      pr_nop,           PIDS_noop,                3,    XXX,  AN|RIGHT},
 {"slice",      "SLICE",  pr_sd_slice,      PIDS_SD_SLICE,           31,    LNX,  ET|LEFT},
+{"slices",    "SLICES",  pr_slices,        PIDS_SCHED_TIMESLICES,    6,    LNX,  TO|RIGHT},
 {"spid",      "SPID",    pr_tasks,         PIDS_ID_PID,              5,    SGI,  TO|PIDMAX|RIGHT},
 {"stackp",    "STACKP",  pr_stackp,        PIDS_ADDR_STACK_START, (int)(2*sizeof(long)), LNX, PO|RIGHT}, /*start_stack*/
 {"start",     "STARTED", pr_start,         PIDS_TICS_BEGAN,          8,    XXX,  ET|RIGHT},
@@ -1932,6 +1958,7 @@ static const format_struct format_array[] = { /*
 {"vm_stack",  "STACK",   pr_nop,           PIDS_VM_STACK,            5,    LNx,  PO|RIGHT},
 {"vsize",     "VSZ",     pr_vsz,           PIDS_VSIZE_BYTES,         6,    DEC,  PO|RIGHT}, /*vsz*/
 {"vsz",       "VSZ",     pr_vsz,           PIDS_VM_SIZE,             6,    U98,  PO|RIGHT}, /*vsize*/
+{"waitns",    "WAITNS",  pr_waitns,        PIDS_SCHED_WAIT_NS,      10,    LNX,  TO|RIGHT},
 {"wbytes",    "WBYTES",  pr_wbytes,        PIDS_IO_WRITE_BYTES,      5,    LNX,  TO|RIGHT},
 {"wcbytes",   "WCBYTES", pr_wcbytes,       PIDS_IO_WRITE_CBYTES,     5,    LNX,  TO|RIGHT},
 {"wchan",     "WCHAN",   pr_wchan,         PIDS_WCHAN_NAME,          6,    XXX,  TO|WCHAN}, /* BSD n forces this to nwchan */ /* was 10 wide */
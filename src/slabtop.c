@@ -68,9 +68,9 @@ enum slabinfo_item Node_items[] = {
     SLAB_NUM_OBJS,   SLAB_ACTIVE_OBJS, SLAB_PERCENT_USED,
     SLAB_OBJ_SIZE,   SLAB_NUMS_SLABS,  SLAB_OBJ_PER_SLAB,
     SLAB_SIZE_TOTAL, SLAB_NAME,
-    /* next 2 are sortable but are not displayable,
+    /* next 3 are sortable but are not displayable,
        thus they need not be represented in the Relative_enums */
-    SLAB_PAGES_PER_SLAB, SLAB_ACTIVE_SLABS };
+    SLAB_PAGES_PER_SLAB, SLAB_ACTIVE_SLABS, SLAB_DELTA_SIZE_TOTAL };
 
 enum Relative_node {
     nod_OBJS,  nod_AOBJS, nod_USE,  nod_OSIZE,
@@ -119,6 +119,7 @@ static void __attribute__((__noreturn__)) usage (FILE *out)
     fputs(_(" a: sort by number of active objects\n"), out);
     fputs(_(" b: sort by objects per slab\n"), out);
     fputs(_(" c: sort by cache size\n"), out);
+    fputs(_(" g: sort by (non display) growth in cache size\n"), out);
     fputs(_(" l: sort by number of slabs\n"), out);
     fputs(_(" v: sort by (non display) number of active slabs\n"), out);
     fputs(_(" n: sort by name\n"), out);
@@ -165,6 +166,9 @@ static void set_sort_stuff (const char key)
     case 'c':
         Sort_item = SLAB_SIZE_TOTAL;
         break;
+    case 'g':
+        Sort_item = SLAB_DELTA_SIZE_TOTAL;
+        break;
     case 'u':
         Sort_item = SLAB_PERCENT_USED;
         break;
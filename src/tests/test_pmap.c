@@ -0,0 +1,211 @@
+/*
+ * test_pmap.c - check pmap against a synthetic smaps, for several pids
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// pmap itself is included here, but reading our own files
+static char proc_dir[64];
+#define PMAP_PROC_DIR  proc_dir
+#define main pmap_main
+#include "../pmap.c"
+#undef main
+
+#include "tests.h"
+
+#define NUM_PIDS  4
+
+/* a benchmark is opt-in, as with PMAP_BENCH=100000 (being the vmas wanted)
+   which times each run, otherwise the fixture is just big enough to check */
+static int num_vmas = 64;
+static int bench;
+
+static char tmp_dir[] = "/tmp/test_pmap.XXXXXX";
+static char out_file[96];
+static pid_t kids[NUM_PIDS];
+
+/* each vma is 8 kB, half of that resident and dirty, none of it swapped */
+static int write_fixture (const char *path, int smaps)
+{
+    FILE *fp;
+    int i;
+
+    if (!(fp = fopen(path, "w")))
+        return 0;
+    for (i = 0; i < num_vmas; i++) {
+        fprintf(fp, "%012lx-%012lx rw-p 00000000 00:00 0          %s\n"
+            , 0x7f0000000000ul + i * 0x2000ul, 0x7f0000002000ul + i * 0x2000ul
+            , (i & 1) ? "/usr/lib/bench/libbench.so" : "");
+        if (smaps)
+            fprintf(fp, "Size:                  8 kB\nRss:                   4 kB\n"
+                "Pss:                   4 kB\nShared_Dirty:          0 kB\n"
+                "Private_Dirty:         4 kB\nSwap:                  0 kB\n"
+                "VmFlags: rd wr mr mw me ac \n");
+    }
+    return (fclose(fp) == 0);
+}
+
+/* run pmap, as a child, with its output going to our file */
+static double run_pmap (const char *opt)
+{
+    char pids[NUM_PIDS][16], *argv[NUM_PIDS + 3];
+    struct timespec t1, t2;
+    pid_t child;
+    int i, n = 0, status;
+
+    argv[n++] = "pmap";
+    if (*opt)
+        argv[n++] = (char *)opt;
+    for (i = 0; i < NUM_PIDS; i++) {
+        snprintf(pids[i], sizeof(pids[i]), "%d", (int)kids[i]);
+        argv[n++] = pids[i];
+    }
+    argv[n] = NULL;
+
+    fflush(stdout);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if ((child = fork()) < 0)
+        return -1;
+    if (child == 0) {
+        if (!freopen(out_file, "w", stdout))
+            _exit(EXIT_FAILURE);
+        exit(pmap_main(n, argv));
+    }
+    if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status))
+        return -1;
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    return (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
+}
+
+/* every pid must have been output in order, each with these totals
+   (as found with any runs of spaces squeezed to just one) */
+static int check_output (const char *want)
+{
+    char line[1024], head[32], *p, *q;
+    FILE *fp;
+    int pids = 0, totals = 0;
+
+    if (!(fp = fopen(out_file, "r")))
+        return 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (pids < NUM_PIDS) {
+            snprintf(head, sizeof(head), "%d:", (int)kids[pids]);
+            if (!strncmp(line, head, strlen(head))) {
+                ++pids;
+                continue;
+            }
+        }
+        for (p = q = line; *p; p++)
+            if (*p != ' ' || (q > line && q[-1] != ' '))
+                *q++ = *p;
+        *q = '\0';
+        if (strstr(line, want))
+            ++totals;
+    }
+    fclose(fp);
+    return (pids == NUM_PIDS && totals == NUM_PIDS);
+}
+
+int check_pmap_totals (void *data)
+{
+    static const char *opts[] = { "", "-x", "-X" };
+    char want[3][64];
+    double secs;
+    unsigned i;
+
+    testname = "pmap, -x & -X totals, for several pids at once";
+    snprintf(want[0], sizeof(want[0]), "total %dK", num_vmas * 8);
+    snprintf(want[1], sizeof(want[1]), "total kB %d %d %d", num_vmas * 8, num_vmas * 4, num_vmas * 4);
+    snprintf(want[2], sizeof(want[2]), "%d %d %d 0 KB", num_vmas * 8, num_vmas * 4, num_vmas * 4);
+    for (i = 0; i < sizeof(opts) / sizeof(opts[0]); i++) {
+        if ((secs = run_pmap(opts[i])) < 0 || !check_output(want[i]))
+            return 0;
+        if (bench)
+            printf("pmap %-2s for %d pids of %d vmas: %.3f secs\n"
+                , opts[i], NUM_PIDS, num_vmas, secs);
+    }
+    return 1;
+}
+
+TestFunction test_funcs[] = {
+    check_pmap_totals,
+    NULL,
+};
+
+/* one fixture, shared by every pid (each a child of ours, just waiting) */
+static int setup_files (void)
+{
+    char path[128], link[128];
+    int i;
+
+    snprintf(proc_dir, sizeof(proc_dir), "%s", tmp_dir);
+    snprintf(out_file, sizeof(out_file), "%s/out", tmp_dir);
+    for (i = 0; i < NUM_PIDS; i++) {
+        snprintf(path, sizeof(path), "%s/%d", tmp_dir, (int)kids[i]);
+        if (mkdir(path, 0700) < 0)
+            return 0;
+    }
+    snprintf(path, sizeof(path), "%s/%d/smaps", tmp_dir, (int)kids[0]);
+    if (!write_fixture(path, 1))
+        return 0;
+    snprintf(path, sizeof(path), "%s/%d/maps", tmp_dir, (int)kids[0]);
+    if (!write_fixture(path, 0))
+        return 0;
+    for (i = 1; i < NUM_PIDS; i++) {
+        snprintf(path, sizeof(path), "../%d/smaps", (int)kids[0]);
+        snprintf(link, sizeof(link), "%s/%d/smaps", tmp_dir, (int)kids[i]);
+        if (symlink(path, link) < 0)
+            return 0;
+        snprintf(path, sizeof(path), "../%d/maps", (int)kids[0]);
+        snprintf(link, sizeof(link), "%s/%d/maps", tmp_dir, (int)kids[i]);
+        if (symlink(path, link) < 0)
+            return 0;
+    }
+    return 1;
+}
+
+int main (int argc, char *argv[])
+{
+    const char *env;
+    int i, n, rc = EXIT_FAILURE;
+
+    if ((env = getenv("PMAP_BENCH")) && (n = atoi(env)) > 0) {
+        num_vmas = n;
+        bench = 1;
+    }
+    for (n = 0; n < NUM_PIDS; n++) {
+        if ((kids[n] = fork()) < 0)
+            goto end_kids;
+        if (kids[n] == 0) {
+            pause();
+            _exit(EXIT_SUCCESS);
+        }
+    }
+    rc = run_tests_in_dir(test_funcs, NULL, tmp_dir, setup_files);
+end_kids:
+    for (i = 0; i < n; i++) {
+        kill(kids[i], SIGTERM);
+        waitpid(kids[i], NULL, 0);
+    }
+    return rc;
+}
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "smaps.h"
+
+static const char *names[SMAPS_NUMFIELDS] = {
+    "Size", "KernelPageSize", "MMUPageSize", "Rss", "Pss", "Pss_Dirty",
+    "Pss_Anon", "Pss_File", "Pss_Shmem", "Shared_Clean", "Shared_Dirty",
+    "Private_Clean", "Private_Dirty", "Referenced", "Anonymous", "KSM",
+    "LazyFree", "AnonHugePages", "ShmemPmdMapped", "FilePmdMapped",
+    "Shared_Hugetlb", "Private_Hugetlb", "Swap", "SwapPss", "Locked",
+    "THPeligible", "ProtectionKey", "VmFlags"
+};
+
+/* two vmas, the second with its fields reordered plus one we don't know */
+static char buf[] =
+    "7f0000000000-7f0000001000 r--p 00000000 fe:00 12 /usr/lib/libc.so.6\n"
+    "Size:                  4 kB\n"
+    "Rss:                   4 kB\n"
+    "Swap:                  0 kB\n"
+    "THPeligible:    0\n"
+    "VmFlags: rd mr mw me \n"
+    "7fff00000000-7fff00021000 rw-p 00000000 00:00 0 [stack]\n"
+    "Swap:                 12 kB\n"
+    "Wombats:               7 kB\n"
+    "Rss:                 132 kB\n"
+    "Size:                132 kB\n"
+    "VmFlags: rd wr mr mw me gd ac";
+
+int main(int argc, char *argv[])
+{
+    unsigned long want[] = { 4, 4, 0, 12, 132, 132 };
+    int fields[] = { SMAPS_Size, SMAPS_Rss, SMAPS_Swap, SMAPS_Swap, SMAPS_Rss, SMAPS_Size };
+    struct smaps_line line;
+    char *s = buf, *end = buf + strlen(buf);
+    int i, n = 0, vmas = 0, unknown = 0, flags = 0;
+
+    for (i = 0; i < SMAPS_NUMFIELDS; i++) {
+        if (smaps_field(names[i], strlen(names[i])) != i) {
+            fprintf(stderr, "FAIL: smaps_field(\"%s\") != %d\n", names[i], i);
+            return EXIT_FAILURE;
+        }
+    }
+    if (smaps_field("Rs", 2) != -1 || smaps_field("Pss_Anonx", 9) != -1) {
+        fprintf(stderr, "FAIL: smaps_field() found a name not known\n");
+        return EXIT_FAILURE;
+    }
+    while ((s = smaps_line(s, end, &line))) {
+        if (!line.name)
+            ++vmas;
+        else if (line.field < 0)
+            ++unknown;
+        else if (line.field == SMAPS_VmFlags)
+            ++flags;
+        else if (line.field != SMAPS_THPeligible) {
+            if (n >= 6 || line.field != fields[n] || !line.numeric || line.num != want[n]) {
+                fprintf(stderr, "FAIL: smaps_line() for \"%.*s\"\n", (int)line.len, line.name);
+                return EXIT_FAILURE;
+            }
+            ++n;
+        }
+    }
+    if (n != 6 || vmas != 2 || unknown != 1 || flags != 2) {
+        fprintf(stderr, "FAIL: smaps_line() saw %d values, %d vmas, %d unknown & %d flags\n"
+            , n, vmas, unknown, flags);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
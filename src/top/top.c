@@ -54,6 +54,7 @@
 #include "meminfo.h"
 #include "misc.h"
 #include "pids.h"
+#include "pressure.h"
 #include "stat.h"
 
 #include "top.h"
@@ -147,7 +148,12 @@ static int Batch = 0,           // batch mode, collect no input, dumb output
            Loops = -1,          // number of iterations, -1 loops forever
            Secure_mode = 0,     // set if some functionality restricted
            Width_mode = 0,      // set w/ 'w' - potential output override
-           Thread_mode = 0;     // set w/ 'H' - show threads vs. tasks
+           Thread_mode = 0,     // set w/ 'H' - show threads vs. tasks
+           Group_mode = 0;      // set w/ 'D' - show tasks grouped (by Group_flds)
+
+        /* The fields by which 'D' may group tasks, with that first entry
+           (at Group_mode 0, and not a field at all) meaning no grouping */
+static const int Group_flds[] = { -1, EU_CGR, EU_DKR, EU_LXC };
 
         /* Unchangeable cap's stuff built just once (if at all) and
            thus NOT saved in a WIN_t's RCW_t.  To accommodate 'Batch'
@@ -201,6 +207,31 @@ static WIN_t *Curwin;
 static volatile int Frames_signal;     // time to rebuild all column headers
 static float        Frame_etscale;     // so we can '*' vs. '/' WHEN 'pcpu'
 
+        /* Support for the 'cost budget' mode (the -B switch), where our own
+           cpu consumption is held under some percentage by stretching the
+           delay interval plus refreshing the costly fields less often */
+#define BUDGET_stretch   4     // most we'll stretch the user's delay time
+#define BUDGET_every     8     // most frames between costly field refresh
+enum budget_refresh {
+   BUD_tasks, BUD_cpus, BUD_memory, BUD_total
+};
+static struct {
+   float  pct;                 // the self-cpu % ceiling, 0 == not active
+   double wall [BUD_total],    // each *_refresh guy's elapsed time (secs)
+          cost [BUD_total];    // each *_refresh guy's cpu time (secs)
+   double frame_cpu;           // cpu time from this process (smoothed)
+   double self;                // resulting self-cpu percentage (smoothed)
+   float  delay;               // delay between frames, as adapted by us
+   int    every;               // costly fields refreshed every Nth frame
+   int    frames;              // cadence counter for the above
+   int    skip;                // costly fields are omitted in this frame
+} Budget;
+
+        /* Support for the smaps_rollup fields, which the library samples.
+           A screenful of the largest tasks (by rss) are always current,
+           the others are refreshed in turn within this share of a delay */
+#define SMAPS_pct        5     // percent of the delay spent reading smaps
+
         /* Support for automatically sized fixed-width column expansions.
          * (hopefully, the macros help clarify/document our new 'feature') */
 static int Autox_array [EU_MAXPFLGS],
@@ -271,7 +302,8 @@ static struct pids_info *Pids_ctx;
 static int Pids_itms_tot;                   // same as MAXTBL(Fieldstab)
 static enum pids_item *Pids_itms;           // allocated as MAXTBL(Fieldstab)
 static struct pids_fetch *Pids_reap;        // for reap or select
-#define PIDSmaxt Pids_reap->counts->total   // just a little less wordy
+static struct pids_fetch *Pids_show;        // the above, or maybe its groups
+#define PIDSmaxt Pids_show->counts->total   // just a little less wordy
         // pid stack results extractor macro, where e=our EU enum, t=type, s=stack
         // ( now we're just duplicating that pids.h provided VAL macro since the )
         // ( 'info' parameter has been removed. however, we'll leave it in place )
@@ -330,6 +362,27 @@ enum Rel_memitems {
    swp_TOT, swp_FRE, swp_USE };
         // mem stack results extractor macro, where e=rel enum
 #define MEM_VAL(e) MEMINFO_VAL(e, ul_int, Mem_stack)
+        // and the per numa node memory, for the View_CPUNOD display
+static struct meminfo_reaped *Mem_nodes;
+static enum meminfo_item Mem_node_items[] = {
+   MEMINFO_NODE_ID,        MEMINFO_MEM_TOTAL,   MEMINFO_MEM_FREE,
+   MEMINFO_MEM_USED,       MEMINFO_MEM_CACHED_ALL };
+enum Rel_nodeitems {
+   nod_ID, nod_TOT, nod_FRE, nod_USE, nod_QUE };
+        // mem node results extractor macro, where e=rel enum, x=index
+#define MNOD_VAL(e,x) MEMINFO_VAL(e, ul_int, Mem_nodes->stacks[x])
+        /*
+         * --- <proc/pressure.h> ---------------------------------------------- */
+static struct pressure_info *Psi_ctx;
+static struct pressure_stack *Psi_stack;
+static enum pressure_item Psi_items[] = {
+   PRESSURE_DELTA_CPU_SOME_PCT, PRESSURE_DELTA_IO_SOME_PCT,
+   PRESSURE_DELTA_MEM_SOME_PCT, PRESSURE_DELTA_IO_FULL_PCT,
+   PRESSURE_DELTA_MEM_FULL_PCT };
+enum Rel_psiitems {
+   psi_CPU, psi_IO, psi_MEM, psi_IOF, psi_MEMF };
+        // psi stack results extractor macro, where e=rel enum
+#define PSI_VAL(e) PRESSURE_VAL(e, real, Psi_stack)
 
         /* Support for concurrent library updates via
            multithreaded background processes */
@@ -550,6 +603,7 @@ static void bye_bye (const char *str) {
       procps_pids_unref(&Pids_ctx);
       procps_stat_unref(&Stat_ctx);
       procps_meminfo_unref(&Mem_ctx);
+      if (Psi_ctx) procps_pressure_unref(&Psi_ctx);
 #if defined THREADED_CPU || defined THREADED_MEM || defined THREADED_TSK
       }
 #endif
@@ -1614,16 +1668,63 @@ static const char *user_certify (WIN_t *q, const char *str, char typ) {
 /*######  Basic Formatting support  ######################################*/
 
         /*
-         * Just do some justify stuff, then add post column padding. */
+         * Just do some justify stuff, then add post column padding.
+         * ( the usual case is handled without the snprintf overhead ) */
 static inline const char *justify_pad (const char *str, int width, int justr) {
    static char l_fmt[]  = "%-*.*s%s", r_fmt[] = "%*.*s%s";
    static char buf[SCREENMAX];
+   int len;
 
-   snprintf(buf, sizeof(buf), justr ? r_fmt : l_fmt, width, width, str, COLPADSTR);
+   if (0 > width || (int)(sizeof(buf) - COLPADSIZ) <= width) {
+      snprintf(buf, sizeof(buf), justr ? r_fmt : l_fmt, width, width, str, COLPADSTR);
+      return buf;
+   }
+   len = (int)strnlen(str, width);
+   if (justr) {
+      memset(buf, ' ', width - len);
+      memcpy(buf + width - len, str, len);
+   } else {
+      memcpy(buf, str, len);
+      memset(buf + len, ' ', width - len);
+   }
+   memcpy(buf + width, COLPADSTR, COLPADSIZ + 1);
    return buf;
 } // end: justify_pad
 
 
+        /*
+         * Convert an integer to its decimal string, without snprintf.
+         * Returns the resulting string length (excluding the null). */
+static inline int make_dec (char *buf, long long num) {
+   char tmp[TNYBUFSIZ + TNYBUFSIZ], *p = tmp + sizeof(tmp);
+   unsigned long long n = (0 > num) ? -(unsigned long long)num : (unsigned long long)num;
+   int len;
+
+   do {
+      *--p = '0' + (n % 10);
+      n /= 10;
+   } while (n);
+   if (0 > num) *--p = '-';
+   len = (int)(tmp + sizeof(tmp) - p);
+   memcpy(buf, p, len);
+   buf[len] = '\0';
+   return len;
+} // end: make_dec
+
+
+        /*
+         * Round a value (from 0 up to 1.0e18) to the nearest integer, with
+         * ties to even, matching what snprintf's "%.0f" would have shown. */
+static inline long long make_rnd (double num) {
+   long long n = (long long)num;
+   double frac = num - n;
+
+   if (0.5 < frac || (0.5 == frac && (n & 1)))
+      ++n;
+   return n;
+} // end: make_rnd
+
+
         /*
          * Make and then justify a single character. */
 static inline const char *make_chr (const char ch, int width, int justr) {
@@ -1644,7 +1745,7 @@ static inline const char *make_num (long num, int width, int justr, int col, int
    if (noz && Rc.zero_suppress && 0 == num)
       goto end_justifies;
 
-   if (width < snprintf(buf, sizeof(buf), "%ld", num)) {
+   if (width < make_dec(buf, num)) {
       if (width <= 0 || (size_t)width >= sizeof(buf))
          width = sizeof(buf)-1;
       buf[width-1] = COLPLUSCH;
@@ -1707,6 +1808,10 @@ static const char *scale_mem (int target, float num, int width, int justr) {
    buf[0] = '\0';
    if (Rc.zero_suppress && 0 >= num)
       goto end_justifies;
+   // an unscaled target is most common, and is satisfied without snprintf
+   if (SK_Kb == target && 0 <= num && 1.0e18 > num
+   && (width >= make_dec(buf, make_rnd(num))))
+      goto end_justifies;
 
    for (i = SK_Kb, psfx = Scaled_sfxtab; i < SK_Eb; psfx++, i++) {
       if (i >= target
@@ -1731,7 +1836,10 @@ static const char *scale_num (float num, int width, int justr) {
    buf[0] = '\0';
    if (Rc.zero_suppress && 0 >= num)
       goto end_justifies;
-   if (width >= snprintf(buf, sizeof(buf), "%.0f", num))
+   if (0 <= num && 1.0e18 > num) {
+      if (width >= make_dec(buf, make_rnd(num)))
+         goto end_justifies;
+   } else if (width >= snprintf(buf, sizeof(buf), "%.0f", num))
       goto end_justifies;
 
    for (psfx = Scaled_sfxtab; 0 < *psfx; psfx++) {
@@ -1772,6 +1880,17 @@ static const char *scale_pcnt (float num, int width, int justr, int xtra) {
    (void)xtra;
 #endif
 carry_on:
+   // the usual 'nn.n' is done with integers (tenths), avoiding snprintf
+   if (0 <= num && 1.0e9 > num) {
+      long long tenths = make_rnd(num * 10.0);
+      int len = make_dec(buf, tenths / 10);
+      if (width >= len + 2) {
+         buf[len] = '.';
+         buf[len + 1] = '0' + (tenths % 10);
+         buf[len + 2] = '\0';
+         goto end_justifies;
+      }
+   }
    if (width >= snprintf(buf, sizeof(buf), "%#.1f", num))
       goto end_justifies;
    if (width >= snprintf(buf, sizeof(buf), "%*.0f", width, num))
@@ -2022,8 +2141,20 @@ static struct {
    {    10,     -1,  A_right,  PIDS_NS_TIME        },  // ul_int   EU_NS8
    {     3,     -1,  A_left,   PIDS_SCHED_CLASSSTR },  // str      EU_CLS
    {     8,     -1,  A_left,   PIDS_DOCKER_ID      },  // str      EU_DKR
-   {     3,     -1,  A_right,  PIDS_OPEN_FILES     }   // str      EU_FDS
-#define eu_LAST        EU_FDS
+   {     3,     -1,  A_right,  PIDS_OPEN_FILES     },  // str      EU_FDS
+   {     6,     -1,  A_right,  PIDS_IO_READ_BYTES_RATE  },  // real     EU_IRR
+   {     6,     -1,  A_right,  PIDS_IO_WRITE_BYTES_RATE },  // real     EU_IWR
+   {     5,     -1,  A_right,  PIDS_CTXSW_VOL_DELTA },  // ul_int   EU_CSV
+   {     5,     -1,  A_right,  PIDS_CTXSW_INVOL_DELTA },  // ul_int   EU_CSI
+   {     5,     -1,  A_right,  PIDS_SCHED_WAIT_NS_DELTA },  // ull_int  EU_RQW
+   {     5,     -1,  A_right,  PIDS_DELAY_BLKIO_NS_DELTA },  // ull_int  EU_DIO
+   {     5,     -1,  A_right,  PIDS_DELAY_SWAPIN_NS_DELTA },  // ull_int  EU_DSW
+   {     5,     -1,  A_right,  PIDS_DELAY_FREEPAGES_NS_DELTA },  // ull_int  EU_DRC
+   {     5,     -1,  A_right,  PIDS_DELAY_THRASH_NS_DELTA },  // ull_int  EU_DTH
+   {     4,     -1,  A_right,  PIDS_PROCESSOR_MIGRATED },  // s_int    EU_MIG
+   {     4,     -1,  A_right,  PIDS_PROCESSOR_NODE_MIGRATED },  // s_int    EU_NOD
+   {     5,     -1,  A_right,  PIDS_GROUP_TASKS }   // s_int    EU_GTS
+#define eu_LAST        EU_GTS
 // xtra Fieldstab 'pseudo pflag' entries for the newlib interface . . . . . . .
 #define eu_CMDLINE     eu_LAST +1
 #define eu_TICS_ALL_C  eu_LAST +2
@@ -2031,9 +2162,10 @@ static struct {
 #define eu_CAPABILITY  eu_LAST +4
 #define eu_CMDLINE_V   eu_LAST +5
 #define eu_ENVIRON_V   eu_LAST +6
-#define eu_TREE_HID    eu_LAST +7
-#define eu_TREE_LVL    eu_LAST +8
-#define eu_TREE_ADD    eu_LAST +9
+#define eu_SMAP_AGE    eu_LAST +7
+#define eu_TREE_HID    eu_LAST +8
+#define eu_TREE_LVL    eu_LAST +9
+#define eu_TREE_ADD    eu_LAST +10
 #define eu_RESET       eu_TREE_HID       // demarcation for reset to zero (PIDS_extra)
    , {  -1, -1, -1,  PIDS_CMDLINE        }  // str      ( if Show_CMDLIN, eu_CMDLINE    )
    , {  -1, -1, -1,  PIDS_TICS_ALL_C     }  // ull_int  ( if Show_CTIMES, eu_TICS_ALL_C )
@@ -2041,6 +2173,7 @@ static struct {
    , {  -1, -1, -1,  PIDS_CAPS_PERMITTED }  // str      ( if kbd_CtrlA,   eu_CAPABILITY )
    , {  -1, -1, -1,  PIDS_CMDLINE_V      }  // strv     ( if kbd_CtrlK,   eu_CMDLINE_V  )
    , {  -1, -1, -1,  PIDS_ENVIRON_V      }  // strv     ( if kbd_CtrlN,   eu_ENVIRON_V  )
+   , {  -1, -1, -1,  PIDS_SMAP_AGE       }  // real     ( if smaps field, eu_SMAP_AGE   )
    , {  -1, -1, -1,  PIDS_extra          }  // s_ch     ( if Show_FOREST, eu_TREE_HID   )
    , {  -1, -1, -1,  PIDS_extra          }  // s_int    ( if Show_FOREST, eu_TREE_LVL   )
    , {  -1, -1, -1,  PIDS_extra          }  // s_int    ( if Show_FOREST, eu_TREE_ADD   )
@@ -2183,6 +2316,40 @@ static void adj_geometry (void) {
 } // end: adj_geometry
 
 
+        /*
+         * A build_headers *Helper* function which ensures costly fields
+         * incur no library costs in a frame where they are to be avoided.
+         * ( fmt_skipped will then display a '-' for each of those fields ) */
+static void budget_items (void) {
+   static const FLG_t costly[] = {
+      EU_CGN, EU_CGR, EU_DKR, EU_ENV, EU_FDS, EU_LXC, EU_WCH };
+   WIN_t *w = Curwin;
+   int i;
+
+   // 'other filters' may target these fields, thus they must stay current
+   do {
+      if (VIZISw(w) && w->osel_tot) return;
+      if (Rc.mode_altscr) w = w->next;
+   } while (w != Curwin);
+
+   for (i = 0; i < MAXTBL(costly); i++)
+      Pids_itms[costly[i]] = PIDS_noop;
+
+   // but sort fields and the bottom window's needs must be honored
+   do {
+      if (VIZISw(w) && EU_MAXPFLGS > w->rc.sortindx)
+         Pids_itms[w->rc.sortindx] = Fieldstab[w->rc.sortindx].item;
+      if (Rc.mode_altscr) w = w->next;
+   } while (w != Curwin);
+   for (i = 0; Bot_item[i] > BOT_DELIMIT; i++)
+      Pids_itms[Bot_item[i]] = Fieldstab[Bot_item[i]].item;
+} // end: budget_items
+
+
+   /* This guy is defined along with the task formatters, for which
+      he provides the precompiled (per window) table to task_show. */
+static void build_formats (void);
+
         /*
          * A calibrate_fields() *Helper* function to build the actual
          * column headers & ensure necessary item enumerators support */
@@ -2206,6 +2373,8 @@ static void build_headers (void) {
    ckITEM(EU_PID);      // these 2 fields may not display,
    ckITEM(EU_STA);      // yet we'll always need them both
    ckITEM(EU_CMD);      // this is used with 'Y' (inspect)
+   if (Group_mode)      // and the 'D' key (if any) becomes that cmd
+      ckITEM(Group_flds[Group_mode]);
 
    do {
       if (VIZISw(w)) {
@@ -2236,6 +2405,11 @@ static void build_headers (void) {
                // for 'cumulative' times, we'll need equivalent of cutime & cstime
                   if (CHKw(w, Show_CTIMES)) ckITEM(eu_TICS_ALL_C);
                   break;
+               case EU_PSS: case EU_PZA: case EU_PZF: case EU_PZS:
+               case EU_RSS: case EU_USS:
+               // smaps_rollup values may be stale, so we'll need their age
+                  ckITEM(eu_SMAP_AGE);
+                  break;
                default:
                   break;
             }
@@ -2292,6 +2466,11 @@ static void build_headers (void) {
       }
 #endif
 
+   // with a cost budget, this frame may need to avoid some costly fields
+   if (Budget.skip) budget_items();
+   // lastly, each window's formatters can now be established
+   build_formats();
+
  #undef ckITEM
  #undef ckCMDS
 } // end: build_headers
@@ -2736,6 +2915,85 @@ static void zap_fieldstab (void) {
  #undef maX
 } // end: zap_fieldstab
 
+/*######  Cost Budget support  ###########################################*/
+
+        /*
+         * A tiny routine returning some clock's time as fractional secs */
+static inline double budget_secs (clockid_t clk) {
+   struct timespec ts;
+
+   if (0 != clock_gettime(clk, &ts))
+      return 0.0;
+   return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+} // end: budget_secs
+
+
+        /*
+         * This guy adapts the delay interval and the costly fields cadence
+         * based on what this process has consumed since the last time.
+         * ( the cpu we'd use is measured across a whole frame, so it will )
+         * ( include formatting plus output in addition to library costs ) */
+static float budget_adapt (void) {
+   static double sav_wall, sav_cost;
+   double wall, cost, need, lim;
+
+   wall = budget_secs(CLOCK_MONOTONIC);
+   cost = budget_secs(CLOCK_PROCESS_CPUTIME_ID);
+   if (sav_wall && wall > sav_wall) {
+      // lightly smooth things so one odd frame won't whipsaw our cadence
+      if (Budget.frame_cpu) Budget.frame_cpu = 0.7 * Budget.frame_cpu + 0.3 * (cost - sav_cost);
+      else Budget.frame_cpu = cost - sav_cost;
+      Budget.self = 100.0 * (cost - sav_cost) / (wall - sav_wall);
+   }
+   sav_wall = wall;
+   sav_cost = cost;
+
+   // the interval needed so our cpu time stays under that budgeted percent
+   need = Budget.frame_cpu * 100.0 / Budget.pct;
+   lim = BUDGET_stretch * (Rc.delay_time > 0.5 ? Rc.delay_time : 0.5);
+   if (need > lim) {
+      // stretching alone won't do, so those costly fields must be avoided
+      if (Budget.every < BUDGET_every) ++Budget.every;
+      need = lim;
+   } else if (need < lim / (2 * BUDGET_stretch)) {
+      // plenty of headroom, so costly fields can be refreshed more often
+      if (Budget.every > 1) --Budget.every;
+   }
+   Budget.delay = need > Rc.delay_time ? need : Rc.delay_time;
+   return Budget.delay;
+} // end: budget_adapt
+
+
+        /*
+         * This guy determines if the current frame will include costly
+         * fields, returning true if that has changed since last frame. */
+static int budget_cadence (void) {
+   int was = Budget.skip;
+
+   // a frame after user interaction (or some signal) will always be complete
+   if (Frames_signal) Budget.frames = 0;
+   Budget.skip = (1 < Budget.every && 0 != Budget.frames % Budget.every);
+   ++Budget.frames;
+   return was != Budget.skip;
+} // end: budget_cadence
+
+
+        /*
+         * This guy is used to bracket each of the *_refresh routines,
+         * capturing both their elapsed and cpu time (as secs) */
+static void budget_mark (int which, int beg) {
+   double wall = budget_secs(CLOCK_MONOTONIC),
+          cost = budget_secs(CLOCK_THREAD_CPUTIME_ID);
+
+   if (beg) {
+      Budget.wall[which] = wall;
+      Budget.cost[which] = cost;
+   } else {
+      Budget.wall[which] = wall - Budget.wall[which];
+      Budget.cost[which] = cost - Budget.cost[which];
+   }
+} // end: budget_mark
+
 /*######  Library Interface (as separate threads)  #######################*/
 
         /*
@@ -2750,6 +3008,7 @@ static void *cpus_refresh (void *unused) {
       while (sem_wait(&Semaphore_cpus_beg) == -1 && errno == EINTR)
          ;
 #endif
+      if (Budget.pct) budget_mark(BUD_cpus, 1);
       which = STAT_REAP_CPUS_ONLY;
       if (CHKw(Curwin, View_CPUNOD))
          which = STAT_REAP_NUMA_NODES_TOO;
@@ -2777,6 +3036,7 @@ static void *cpus_refresh (void *unused) {
       Stat_reap->cpus->stacks[i]->head[stat_COR_TYP].result.s_int = (i < x) ? P_CORE : E_CORE;
 }
 #endif
+      if (Budget.pct) budget_mark(BUD_cpus, 0);
 #ifdef THREADED_CPU
       sem_post(&Semaphore_cpus_end);
    } while (1);
@@ -2805,8 +3065,14 @@ static void *memory_refresh (void *unused) {
       cur_secs = time(NULL);
 
       if (3 <= cur_secs - sav_secs) {
+         if (Budget.pct) budget_mark(BUD_memory, 1);
          if (!(Mem_stack = procps_meminfo_select(Mem_ctx, Mem_items, MAXTBL(Mem_items))))
             error_exit(fmtmk(N_fmt(LIB_errormem_fmt), __LINE__, strerror(errno)));
+         // the nodes are optional, a kernel without CONFIG_NUMA has none
+         Mem_nodes = NULL;
+         if (CHKw(Curwin, View_CPUNOD))
+            Mem_nodes = procps_meminfo_reap(Mem_ctx, Mem_node_items, MAXTBL(Mem_node_items));
+         if (Budget.pct) budget_mark(BUD_memory, 0);
          sav_secs = cur_secs;
       }
 #ifdef THREADED_MEM
@@ -2839,6 +3105,7 @@ static void *tasks_refresh (void *unused) {
       while (sem_wait(&Semaphore_tasks_beg) == -1 && errno == EINTR)
          ;
 #endif
+      if (Budget.pct) budget_mark(BUD_tasks, 1);
       if (0 != clock_gettime(CLOCK_BOOTTIME, &ts))
          Frame_etscale = 0;
       else {
@@ -2850,6 +3117,9 @@ static void *tasks_refresh (void *unused) {
          Frame_etscale = 100.0f / ((float)Hertz * (float)et * (Rc.mode_irixps ? 1 : Cpu_cnt));
       }
       what = Thread_mode ? PIDS_FETCH_THREADS_TOO : PIDS_FETCH_TASKS_ONLY;
+      // when in Batch mode, every task's smaps values are kept current
+      if (!Batch)
+         procps_pids_smaps_budget(Pids_ctx, Screen_rows, (int)(Rc.delay_time * 10 * SMAPS_pct));
       if (Monpidsidx) {
          what |= PIDS_SELECT_PID;
          Pids_reap = procps_pids_select(Pids_ctx, (unsigned *)Monpids, Monpidsidx, what);
@@ -2857,6 +3127,19 @@ static void *tasks_refresh (void *unused) {
          Pids_reap = procps_pids_reap(Pids_ctx, what);
       if (!Pids_reap)
          error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+      Pids_show = Pids_reap;
+      if (Group_mode) {
+         int f = Group_flds[Group_mode];
+         if (!(Pids_show = procps_pids_group(Pids_ctx, Pids_reap->stacks, n_reap, Fieldstab[f].item)))
+            error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+         // each group's key then replaces its (first task's) command
+         for (i = 0; i < PIDSmaxt; i++) {
+            struct pids_result *r = Pids_show->stacks[i]->head;
+            r[EU_CMD].result.str = r[f].result.str;
+            if (Pids_itms[eu_CMDLINE] == PIDS_CMDLINE)
+               r[eu_CMDLINE].result.str = r[f].result.str;
+         }
+      }
 
       // now refresh each window's stacks pointer array...
       if (n_alloc < n_reap) {
@@ -2864,12 +3147,16 @@ static void *tasks_refresh (void *unused) {
          n_alloc = nALGN2(n_reap, 128);
          for (i = 0; i < GROUPSMAX; i++) {
             Winstk[i].ppt = alloc_r(Winstk[i].ppt, sizeof(void *) * n_alloc);
-            memcpy(Winstk[i].ppt, Pids_reap->stacks, sizeof(void *) * PIDSmaxt);
+#ifndef SORT_SEED_NO
+            Winstk[i].seedpid = alloc_r(Winstk[i].seedpid, sizeof(int) * n_alloc);
+#endif
+            memcpy(Winstk[i].ppt, Pids_show->stacks, sizeof(void *) * PIDSmaxt);
          }
       } else {
          for (i = 0; i < GROUPSMAX; i++)
-            memcpy(Winstk[i].ppt, Pids_reap->stacks, sizeof(void *) * PIDSmaxt);
+            memcpy(Winstk[i].ppt, Pids_show->stacks, sizeof(void *) * PIDSmaxt);
       }
+      if (Budget.pct) budget_mark(BUD_tasks, 0);
 #ifdef THREADED_TSK
       sem_post(&Semaphore_tasks_end);
    } while (1);
@@ -3704,11 +3991,8 @@ static void before (char *me) {
    fatal_proc_unmounted(NULL, 0);
 
 #ifndef OFF_STDERROR
-   /* there's a chance that damn libnuma may spew to stderr so we gotta
-      make sure he does not corrupt poor ol' top's first output screen!
-      Yes, he provides some overridable 'weak' functions to change such
-      behavior but we can't exploit that since we don't follow a normal
-      ld route to symbol resolution (we use that dlopen() guy instead)! */
+   /* there's a chance that some library may spew to stderr so we gotta
+      make sure it does not corrupt poor ol' top's first output screen! */
    Stderr_save = dup(fileno(stderr));
    if (-1 < Stderr_save)
       freopen("/dev/null", "w", stderr);
@@ -4368,9 +4652,10 @@ default_or_error:
          *       overridden -- we'll force some on and negate others in our
          *       best effort to honor the loser's (oops, user's) wishes... */
 static void parse_args (int argc, char **argv) {
-    static const char sopts[] = "Abcd:E:e:Hhin:Oo:p:SsU:u:Vw::1";
+    static const char sopts[] = "AB:bcd:E:e:Hhin:Oo:p:SsU:u:Vw::1";
     static const struct option lopts[] = {
        { "apply-defaults",    no_argument,       NULL, 'A' },
+       { "cost-budget",       required_argument, NULL, 'B' },
        { "batch-mode",        no_argument,       NULL, 'b' },
        { "cmdline-toggle",    no_argument,       NULL, 'c' },
        { "delay",             required_argument, NULL, 'd' },
@@ -4432,6 +4717,12 @@ static void parse_args (int argc, char **argv) {
             Curwin = &Winstk[Rc.win_index];
             if (Secure_mode) Rc.delay_time = tmp_delay;
             return;
+         case 'B':
+            if (!mkfloat(cp, &tmp, 0) || 0 >= tmp || 100 < tmp)
+               error_exit(fmtmk(N_fmt(BAD_budgetpc_fmt), cp));
+            Budget.pct = tmp;
+            Budget.every = 1;
+            continue;
          case 'b':
             Batch = 1;
             break;
@@ -4544,6 +4835,8 @@ static void parse_args (int argc, char **argv) {
          error_exit(N_txt(DELAY_secure_txt));
       Rc.delay_time = tmp_delay;
    }
+   // a cost budget's delay begins life as the user's delay
+   if (Budget.pct) Budget.delay = Rc.delay_time;
 } // end: parse_args
 
 
@@ -5222,6 +5515,350 @@ static inline const char *forest_display (const WIN_t *q, int idx) {
  #undef rSv_Hid
 } // end: forest_display
 
+/*######  Task Formatting support  #######################################*/
+
+        /*
+         * These are the specialized formatters for each of the task fields.
+         * They're precompiled (as function pointers) by build_formats into
+         * each window's fmtab array along with their widths, scaling and
+         * justification, then simply invoked by task_show for every row.
+         *
+         * Except for the XOF/XON pseudo flags, these formatters are grouped
+         * by result type according to capacity (small -> large) and then by
+         * additional processing requirements (as in plain, scaled, decorated,
+         * etc.), just as the old task_show switch had been.  Each returns a
+         * justified and padded column or NULL if nothing should be shown. */
+
+  // some tailored formatter declaration, value, width & justify macros
+#define fmtDECL(n) static const char *fmt_ ## n \
+   (const WIN_t *q, const FMT_t *f, struct pids_stack *p, int idx)
+#define rSv(T)     PID_VAL(f->pflg, T, p)
+#define fW         f->width
+#define fJ         CHKw(q, f->jflg)
+
+#ifndef USE_X_COLHDR
+        // these 2 aren't real procflgs, they're used in column highlighting!
+fmtDECL(xonoff) {
+   (void)idx;
+   if (CHKw(q, NOPRINT_xxx)) return NULL;
+   /* treat running tasks specially - entire row may get highlighted
+      so we needn't turn it on and we MUST NOT turn it off */
+   if ('R' == PID_VAL(EU_STA, s_ch, p) && CHKw(q, Show_HIROWS)) return NULL;
+   return (EU_XON == f->pflg ? q->capclr_rowhigh : q->capclr_rownorm);
+}
+#endif
+   /* any costly field avoided in this frame under a cost budget */
+fmtDECL(skipped) {
+   (void)p; (void)idx;
+   return justify_pad("-", fW, fJ);
+}
+   /* s_ch, make_chr */
+fmtDECL(s_ch) {
+   (void)idx;
+   return make_chr(rSv(s_ch), fW, fJ);
+}
+   /* s_int, make_num with or without auto width or zero suppression */
+fmtDECL(s_int) {
+   (void)idx;
+   return make_num(rSv(s_int), fW, fJ, f->autox, f->noz);
+}
+   /* s_int, scale_num */
+fmtDECL(s_int_scaled) {
+   (void)idx;
+   return scale_num(rSv(s_int), fW, fJ);
+}
+   /* s_int, make_num or make_str */
+fmtDECL(priority) {
+   (void)idx;
+   if (-99 > rSv(s_int) || 999 < rSv(s_int))
+      return make_str("rt", fW, fJ, AUTOX_NO);
+   return make_num(rSv(s_int), fW, fJ, AUTOX_NO, 0);
+}
+   /* ull_int, scale_pcnt of runqueue or delay nanoseconds (scaled like pcpu) */
+fmtDECL(pwait) {
+   float u = (float)rSv(ull_int) * Hertz / 1.0e9f * Frame_etscale;
+   (void)idx;
+   if (u > Cpu_pmax) u = Cpu_pmax;
+   return scale_pcnt(u, fW, fJ, 0);
+}
+   /* u_int, scale_pcnt with special handling */
+fmtDECL(pcpu) {
+   float u = (float)rSv(u_int);
+   int n = PID_VAL(EU_THD, s_int, p);
+   (void)idx;
+#ifndef TREE_VCPUOFF
+ #ifndef TREE_VWINALL
+   if (q == Curwin) // note: the following is NOT indented
+ #endif
+   if (CHKw(q, Show_FOREST)) u += PID_VAL(eu_TREE_ADD, u_int, p);
+   u *= Frame_etscale;
+   /* technically, eu_TREE_HID is only valid if Show_FOREST is active
+      but its zeroed out slot will always be present now */
+   if (PID_VAL(eu_TREE_HID, s_ch, p) != 'x' && u > 100.0 * n) u = 100.0 * n;
+#else
+   u *= Frame_etscale;
+   /* process can't use more %cpu than number of threads it has
+    ( thanks Jaromir Capik <jcapik@redhat.com> ) */
+   if (u > 100.0 * n) u = 100.0 * n;
+#endif
+   if (u > Cpu_pmax) u = Cpu_pmax;
+   return scale_pcnt(u, fW, fJ, 0);
+}
+   /* real, scale_pcnt for 'utilization' */
+fmtDECL(real_pcnt) {
+   (void)idx;
+   return scale_pcnt(rSv(real), fW, fJ, 1);
+}
+   /* real, scale_num for 'per second' rates */
+fmtDECL(real_scaled) {
+   (void)idx;
+   return scale_num(rSv(real), fW, fJ);
+}
+   /* u_int, make_num with auto width */
+fmtDECL(u_int) {
+   (void)idx;
+   return make_num(rSv(u_int), fW, fJ, f->autox, f->noz);
+}
+   /* ul_int, make_num with auto width and zero suppression */
+fmtDECL(ul_int) {
+   (void)idx;
+   return make_num(rSv(ul_int), fW, fJ, f->autox, f->noz);
+}
+   /* ul_int, scale_mem */
+fmtDECL(ul_int_mem) {
+   (void)idx;
+   return scale_mem(f->scale, rSv(ul_int), fW, fJ);
+}
+   /* ul_int, scale_mem with a '~' if not current (or '-' if never read) */
+fmtDECL(ul_int_smap) {
+   static char buf[SMLBUFSIZ];
+   double age = PID_VAL(eu_SMAP_AGE, real, p);
+   const char *s;
+   int n;
+   (void)idx;
+   if (age < 0)
+      return justify_pad("-", fW, fJ);
+   if (age == 0 || fW < 2)
+      return scale_mem(f->scale, rSv(ul_int), fW, fJ);
+   s = scale_mem(f->scale, rSv(ul_int), fW - 1, fJ);
+   n = strspn(s, " ");
+   snprintf(buf, sizeof(buf), "%.*s~%s", n, s, s + n);
+   return buf;
+}
+   /* ul_int, scale_num */
+fmtDECL(ul_int_scaled) {
+   (void)idx;
+   return scale_num(rSv(ul_int), fW, fJ);
+}
+   /* ul_int, scale_pcnt (derived from PIDS_MEM_RES) */
+fmtDECL(pmem) {
+   (void)idx;
+   if (Restrict_some)
+      return justify_pad("?", fW, fJ);
+   return scale_pcnt((float)rSv(ul_int) * 100 / MEM_VAL(mem_TOT), fW, fJ, 0);
+}
+   /* ul_int, make_str with special handling */
+fmtDECL(flags) {
+   (void)idx;
+   return make_str(hex_make(rSv(ul_int), 1), fW, fJ, AUTOX_NO);
+}
+   /* ull_int, scale_tics (try 'minutes:seconds.hundredths') */
+fmtDECL(tics) {
+   TIC_t t;
+   (void)idx;
+   if (CHKw(q, Show_CTIMES)) t = PID_VAL(eu_TICS_ALL_C, ull_int, p);
+   else t = rSv(ull_int);
+   return scale_tics(t, fW, fJ, TICS_AS_SECS);
+}
+   /* ull_int, scale_tics (try 'minutes:seconds') */
+fmtDECL(tics_began) {
+   (void)idx;
+   return scale_tics(rSv(ull_int), fW, fJ, TICS_AS_MINS);
+}
+   /* real, scale_tics (try 'hour,minutes') */
+fmtDECL(elapsed) {
+   (void)idx;
+   return scale_tics(rSv(real) * Hertz, fW, fJ, TICS_AS_HOUR);
+}
+   /* str, make_str (fixed width, maybe with auto width) */
+fmtDECL(str) {
+   (void)idx;
+   return make_str(rSv(str), fW, fJ, f->autox);
+}
+   /* str, make_str_utf8 (all AUTOX yes) */
+fmtDECL(str_utf8) {
+   (void)idx;
+   return make_str_utf8(rSv(str), fW, fJ, f->autox);
+}
+
+        /*
+         * A *Helper* function for the variable width string formatters */
+static inline const char *fmt_variable (const WIN_t *q, const FMT_t *f, const char *pv, int utf8) {
+#ifndef SCROLLVAR_NO
+   if (q->varcolbeg) {
+      if (utf8)
+         pv = (q->varcolbeg < ((int)strlen(pv) - utf8_delta(pv))) ? pv + utf8_embody(pv, q->varcolbeg) : "";
+      else
+         pv = q->varcolbeg < (int)strlen(pv) ? pv + q->varcolbeg : "";
+   }
+#endif
+   if (utf8) return make_str_utf8(pv, fW, fJ, AUTOX_NO);
+   return make_str(pv, fW, fJ, AUTOX_NO);
+}
+   /* str, make_str_utf8 with variable width */
+fmtDECL(var_utf8) {
+   (void)idx;
+   return fmt_variable(q, f, rSv(str), 1);
+}
+   /* str, make_str with variable width */
+fmtDECL(var_str) {
+   (void)idx;
+   return fmt_variable(q, f, rSv(str), 0);
+}
+   /* str, make_str_utf8 with variable width + additional decoration */
+fmtDECL(cmd) {
+   (void)p;
+   return fmt_variable(q, f, forest_display(q, idx), 1);
+}
+
+#undef fmtDECL
+#undef rSv
+#undef fW
+#undef fJ
+
+
+        /*
+         * A build_headers *Helper* function which precompiles each visible
+         * window's fmtab, thus sparing task_show from a switch per column. */
+static void build_formats (void) {
+ #define setFMT(n,j,a,z) do { t->func = fmt_ ## n; t->jflg = j; t->autox = a; t->noz = z; } while (0)
+   WIN_t *w = Curwin;
+   FMT_t *t;
+   FLG_t f;
+   int i;
+
+   do {
+      if (VIZISw(w)) {
+         for (i = 0; i < w->maxpflgs; i++) {
+            t = &w->fmtab[i];
+            t->pflg = f = w->procflgs[i];
+            t->func = NULL;
+            if (EU_MAXPFLGS > f) {
+               t->width = VARcol(f) ? w->varcolsz : Fieldstab[f].width;
+               t->scale = Fieldstab[f].scale;
+            }
+            /* with the cost budget active, a costly field may have been avoided
+               in this frame (its item is a 'noop') and will just show a dash */
+            if (Budget.skip && EU_MAXPFLGS > f
+            && PIDS_noop == Pids_itms[f] && PIDS_noop != Fieldstab[f].item) {
+               setFMT(skipped, Fieldstab[f].align, AUTOX_NO, 0);
+               continue;
+            }
+            switch (f) {
+#ifndef USE_X_COLHDR
+               case EU_XOF:
+               case EU_XON:
+                  setFMT(xonoff, 0, AUTOX_NO, 0);
+                  break;
+#endif
+               case EU_STA:
+                  setFMT(s_ch, Show_JRSTRS, AUTOX_NO, 0);
+                  break;
+               case EU_LID:
+                  setFMT(s_int, Show_JRNUMS, f, 0);
+                  break;
+               case EU_AGI: case EU_CPN: case EU_GTS: case EU_MIG: case EU_NMA:
+               case EU_NOD: case EU_PGD: case EU_PID: case EU_PPD: case EU_SID:
+               case EU_TGD: case EU_THD: case EU_TPG:
+                  setFMT(s_int, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_AGN: case EU_NCE: case EU_OOA: case EU_OOM:
+                  setFMT(s_int, Show_JRNUMS, AUTOX_NO, 1);
+                  break;
+               case EU_FV1: case EU_FV2: case EU_FDS:
+                  setFMT(s_int_scaled, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_PRI:
+                  setFMT(priority, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_CPU:
+                  setFMT(pcpu, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_DIO: case EU_DRC: case EU_DSW: case EU_DTH:
+               case EU_RQW:
+                  setFMT(pwait, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_CUU: case EU_CUC:
+                  setFMT(real_pcnt, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_IRR: case EU_IWR:
+                  setFMT(real_scaled, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_GID: case EU_UED: case EU_URD: case EU_USD:
+                  setFMT(u_int, Show_JRNUMS, f, 0);
+                  break;
+               case EU_NS1: case EU_NS2: case EU_NS3: case EU_NS4:
+               case EU_NS5: case EU_NS6: case EU_NS7: case EU_NS8:
+                  setFMT(ul_int, Show_JRNUMS, f, 1);
+                  break;
+               case EU_COD: case EU_DAT: case EU_DRT: case EU_RES: case EU_RZA:
+               case EU_RZF: case EU_RZL: case EU_RZS: case EU_SHR: case EU_SWP:
+               case EU_USE: case EU_VRT:
+                  setFMT(ul_int_mem, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_PSS: case EU_PZA: case EU_PZF: case EU_PZS: case EU_RSS:
+               case EU_USS:
+                  setFMT(ul_int_smap, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_CSI: case EU_CSV: case EU_FL1: case EU_FL2:
+               case EU_IRB: case EU_IRO: case EU_IWB: case EU_IWO:
+                  setFMT(ul_int_scaled, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_MEM:
+                  setFMT(pmem, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_FLG:
+                  setFMT(flags, Show_JRSTRS, AUTOX_NO, 0);
+                  break;
+               case EU_TM2: case EU_TME:
+                  setFMT(tics, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_TM3:
+                  setFMT(tics_began, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_TM4:
+                  setFMT(elapsed, Show_JRNUMS, AUTOX_NO, 0);
+                  break;
+               case EU_CLS:
+                  setFMT(str, Show_JRSTRS, AUTOX_NO, 0);
+                  break;
+               case EU_DKR: case EU_LXC: case EU_TTY: case EU_WCH:
+                  setFMT(str, Show_JRSTRS, f, 0);
+                  break;
+               case EU_GRP: case EU_UEN: case EU_URN: case EU_USN:
+                  setFMT(str_utf8, Show_JRSTRS, f, 0);
+                  break;
+               case EU_CGN: case EU_CGR: case EU_ENV: case EU_EXE: case EU_SGN:
+                  setFMT(var_utf8, Show_JRSTRS, AUTOX_NO, 0);
+                  break;
+               case EU_SGD:
+                  setFMT(var_str, Show_JRSTRS, AUTOX_NO, 0);
+                  break;
+               case EU_CMD:
+                  setFMT(cmd, Show_JRSTRS, AUTOX_NO, 0);
+                  break;
+               default:            // keep gcc happy
+                  break;
+            }
+         }
+      }
+      if (Rc.mode_altscr) w = w->next;
+   } while (w != Curwin);
+
+ #undef setFMT
+} // end: build_formats
+
+
 /*######  Special Separate Bottom Window support  ########################*/
 
         /*
@@ -5493,7 +6130,7 @@ static inline int find_ofs (const WIN_t *q, const char *buf) {
 
 
 
-   /* This is currently the only true prototype required by top.
+   /* This is one of the only two true prototypes required by top.
       It is placed here, instead of top.h, to avoid one compiler
       warning when the top_nls.c source was compiled separately. */
 static const char *task_show (const WIN_t *q, int idx);
@@ -5789,6 +6426,20 @@ static void keys_global (int ch) {
          TOGw(w, View_NOBOLD);
          capsmk(w);
          break;
+      case 'D':
+         if (++Group_mode >= MAXTBL(Group_flds)) Group_mode = 0;
+         show_msg(fmtmk(N_fmt(GROUPS_show_fmt)
+            , Group_mode ? N_col(Group_flds[Group_mode]) : N_txt(OFF_one_word_txt)));
+         for (i = 0 ; i < GROUPSMAX; i++)
+            Winstk[i].begtask = Winstk[i].focus_pid = 0;
+         // that key field may be new, so the library must know of it now
+         build_headers();
+         if ((i = procps_pids_reset(Pids_ctx, Pids_itms, Pids_itms_tot)))
+            error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-i)));
+         // do an extra procs refresh to avoid %cpu distortions...
+         usleep_refresh();
+         Frames_signal = BREAK_screen;
+         break;
       case 'd':
       case 's':
          if (Secure_mode)
@@ -5834,6 +6485,9 @@ static void keys_global (int ch) {
       case 'k':
          if (Secure_mode)
             show_msg(N_txt(NOT_onsecure_txt));
+         // a group's PID is merely that of some one task within it
+         else if (Group_mode)
+            show_msg(N_txt(NOT_ongroup_txt));
          else {
             num = SIGTERM;
             def = PID_VAL(EU_PID, s_int, w->ppt[w->begtask]);
@@ -5856,6 +6510,8 @@ static void keys_global (int ch) {
       case 'r':
          if (Secure_mode)
             show_msg(N_txt(NOT_onsecure_txt));
+         else if (Group_mode)
+            show_msg(N_txt(NOT_ongroup_txt));
          else {
             def = PID_VAL(EU_PID, s_int, w->ppt[w->begtask]);
             pid = get_int(fmtmk(N_fmt(GET_pid2nice_fmt), def));
@@ -6055,6 +6711,13 @@ static void keys_summary (int ch) {
       case 'l':
          TOGw(w, View_LOADAV);
          break;
+      case 'p':
+         // the pressure files are only opened when first wanted
+         if (!Psi_ctx && procps_pressure_new(&Psi_ctx) < 0)
+            show_msg(N_txt(PSI_notavail_txt));
+         else
+            TOGw(w, View_PRESSR);
+         break;
       case 'm':
          if (!CHKw(w, View_MEMORY))
             SETw(w, View_MEMORY);
@@ -6840,9 +7503,10 @@ static void do_memory (void) {
       // & prT macro might replace space at buf[8] with: -------> +
       char buf[10]; // MEMORY_lines_fmt provides for 8+1 bytes
    } buftab[8];
-   char row[ROWMINSIZ];
+   char row[ROWMINSIZ], tmp[SMLBUFSIZ];
    long my_qued, my_misc, my_used;
    struct rx_st *rx;
+   int i;
 
    if (!scaletab[0].label) {
       scaletab[0].label = N_txt(AMT_kilobyte_txt);
@@ -6916,6 +7580,22 @@ static void do_memory (void) {
          , N_txt(WORD_abv_mem_txt));
       Msg_row += sum_see(row, 1);
    }
+
+   if (CHKw(Curwin, View_CPUNOD) && Mem_nodes) {
+      /*
+       * display each numa node's memory, or just the one selected ... */
+      for (i = 0; i < Mem_nodes->total; i++) {
+         int node = MEMINFO_VAL(nod_ID, s_int, Mem_nodes->stacks[i]);
+         if (Numa_node_sel >= 0 && Numa_node_sel != node) continue;
+         if (Msg_row + 1 >= SCREEN_ROWS - 1) break;
+         prT(bfT(0), mkM(MNOD_VAL(nod_TOT, i))); prT(bfT(1), mkM(MNOD_VAL(nod_FRE, i)));
+         prT(bfT(2), mkM(MNOD_VAL(nod_USE, i))); prT(bfT(3), mkM(MNOD_VAL(nod_QUE, i)));
+         snprintf(tmp, sizeof(tmp), N_fmt(NUMA_memnam_fmt), node);
+         snprintf(row, sizeof(row), N_unq(MEMORY_line1_fmt)
+            , scT(label), tmp, bfT(0), bfT(1), bfT(2), bfT(3));
+         Msg_row += sum_see(row, 1);
+      }
+   }
  #undef bfT
  #undef scT
  #undef mkM
@@ -6936,14 +7616,14 @@ static void do_key (int ch) {
          { kbd_CtrlA, kbd_CtrlG, kbd_CtrlK, kbd_CtrlL, kbd_CtrlN
          , kbd_CtrlP, kbd_CtrlU, kbd_TAB, kbd_BTAB, '\0' } },
       { keys_global,
-         { '?', 'B', 'd', 'E', 'e', 'f', 'g', 'H', 'h'
+         { '?', 'B', 'D', 'd', 'E', 'e', 'f', 'g', 'H', 'h'
          , 'I', 'k', 'r', 's', 'X', 'Y', 'Z', '0'
          , kbd_CtrlE, kbd_CtrlR, kbd_ENTER, kbd_SPACE, '\0' } },
       { keys_summary,
  #ifdef CORE_TYPE_NO
-         { '!', '^', '1', '2', '3', '4', 'C', 'l', 'm', 't', '\0' } },
+         { '!', '^', '1', '2', '3', '4', 'C', 'l', 'm', 'p', 't', '\0' } },
  #else
-         { '!', '^', '1', '2', '3', '4', '5', 'C', 'l', 'm', 't', '\0' } },
+         { '!', '^', '1', '2', '3', '4', '5', 'C', 'l', 'm', 'p', 't', '\0' } },
  #endif
       { keys_task,
          { '#', '<', '>', 'b', 'c', 'F', 'i', 'J', 'j', 'n', 'O', 'o'
@@ -7031,7 +7711,7 @@ static void summary_show (void) {
       if (isROOM(View_STATES, 1)) {
          show_special(0, fmtmk(N_unq(STATE_line_1_fmt)
             , Thread_mode ? N_txt(WORD_threads_txt) : N_txt(WORD_process_txt)
-            , PIDSmaxt, Pids_reap->counts->running
+            , Pids_reap->counts->total, Pids_reap->counts->running
             , Pids_reap->counts->sleeping + Pids_reap->counts->other
             , Pids_reap->counts->disk_sleep
             , Pids_reap->counts->stopped, Pids_reap->counts->zombied));
@@ -7062,7 +7742,7 @@ static void summary_show (void) {
    if (isROOM(View_STATES, 2)) {
       show_special(0, fmtmk(N_unq(STATE_line_1_fmt)
          , Thread_mode ? N_txt(WORD_threads_txt) : N_txt(WORD_process_txt)
-         , PIDSmaxt, Pids_reap->counts->running
+         , Pids_reap->counts->total, Pids_reap->counts->running
          , Pids_reap->counts->sleeping + Pids_reap->counts->other
          , Pids_reap->counts->disk_sleep
          , Pids_reap->counts->stopped, Pids_reap->counts->zombied));
@@ -7080,6 +7760,28 @@ static void summary_show (void) {
       do_memory();
    }
 
+   // Display Pressure stalls, as a percentage of the time since last frame
+   if (isROOM(View_PRESSR, 1)) {
+      if (!Psi_ctx && procps_pressure_new(&Psi_ctx) < 0)
+         OFFw(Curwin, View_PRESSR);
+      else if ((Psi_stack = procps_pressure_select(Psi_ctx, Psi_items, MAXTBL(Psi_items)))) {
+         show_special(0, fmtmk(N_unq(STALLS_line1_fmt)
+            , PSI_VAL(psi_CPU), PSI_VAL(psi_IO), PSI_VAL(psi_MEM)
+            , PSI_VAL(psi_IOF), PSI_VAL(psi_MEMF)));
+         Msg_row += 1;
+      }
+   }
+
+   // Display our own costs, when a cost budget is active
+   if (Budget.pct && Msg_row + 1 < SCREEN_ROWS - 1) {
+      show_special(0, fmtmk(N_unq(BUDGET_line1_fmt)
+         , Budget.cost[BUD_tasks] * 1000.0, Budget.cost[BUD_cpus] * 1000.0
+         , Budget.cost[BUD_memory] * 1000.0
+         , (Budget.wall[BUD_tasks] + Budget.wall[BUD_cpus] + Budget.wall[BUD_memory]) * 1000.0
+         , Budget.self, Budget.delay, Budget.every));
+      Msg_row += 1;
+   }
+
  #undef isROOM
 } // end: summary_show
 
@@ -7090,18 +7792,6 @@ static void summary_show (void) {
 static const char *task_show (const WIN_t *q, int idx) {
   // a tailored 'results stack value' extractor macro
  #define rSv(E,T)  PID_VAL(E, T, p)
-#ifndef SCROLLVAR_NO
- #define makeVAR(S)  { const char *pv = S; \
-    if (!q->varcolbeg) cp = make_str(pv, q->varcolsz, Js, AUTOX_NO); \
-    else cp = make_str(q->varcolbeg < (int)strlen(pv) ? pv + q->varcolbeg : "", q->varcolsz, Js, AUTOX_NO); }
- #define varUTF8(S)  { const char *pv = S; \
-    if (!q->varcolbeg) cp = make_str_utf8(pv, q->varcolsz, Js, AUTOX_NO); \
-    else cp = make_str_utf8((q->varcolbeg < ((int)strlen(pv) - utf8_delta(pv))) \
-    ? pv + utf8_embody(pv, q->varcolbeg) : "", q->varcolsz, Js, AUTOX_NO); }
-#else
- #define makeVAR(S)  { cp = make_str(S, q->varcolsz, Js, AUTOX_NO); }
- #define varUTF8(S)  { cp = make_str_utf8(S, q->varcolsz, Js, AUTOX_NO); }
-#endif
    struct pids_stack *p = q->ppt[idx];
    static char rbuf[ROWMINSIZ];
    char *rp;
@@ -7121,224 +7811,15 @@ static const char *task_show (const WIN_t *q, int idx) {
    *(rp = rbuf) = '\0';
    if (Rc.mode_altscr) rp = scat(rp, " ");
 
+   // the formatters were precompiled for us by build_formats ...
    for (x = 0; x < q->maxpflgs; x++) {
-      const char *cp = NULL;
-      FLG_t       i = q->procflgs[x];
-      #define S   Fieldstab[i].scale        // these used to be variables
-      #define W   Fieldstab[i].width        // but it's much better if we
-      #define Js  CHKw(q, Show_JRSTRS)      // represent them as #defines
-      #define Jn  CHKw(q, Show_JRNUMS)      // and only exec code if used
-
-   /* except for the XOF/XON pseudo flags the following case labels are grouped
-      by result type according to capacity (small -> large) and then ordered by
-      additional processing requirements (as in plain, scaled, decorated, etc.) */
-
-      switch (i) {
-#ifndef USE_X_COLHDR
-         // these 2 aren't real procflgs, they're used in column highlighting!
-         case EU_XOF:
-         case EU_XON:
-            cp = NULL;
-            if (!CHKw(q, NOPRINT_xxx)) {
-               /* treat running tasks specially - entire row may get highlighted
-                  so we needn't turn it on and we MUST NOT turn it off */
-               if (!('R' == rSv(EU_STA, s_ch) && CHKw(q, Show_HIROWS)))
-                  cp = (EU_XON == i ? q->capclr_rowhigh : q->capclr_rownorm);
-            }
-            break;
-#endif
-   /* s_ch, make_chr */
-         case EU_STA:        // PIDS_STATE
-            cp = make_chr(rSv(EU_STA, s_ch), W, Js);
-            break;
-   /* s_int, make_num with auto width */
-         case EU_LID:        // PIDS_ID_LOGIN
-            cp = make_num(rSv(EU_LID, s_int), W, Jn, EU_LID, 0);
-            break;
-   /* s_int, make_num without auto width */
-         case EU_AGI:        // PIDS_AUTOGRP_ID
-         case EU_CPN:        // PIDS_PROCESSOR
-         case EU_NMA:        // PIDS_PROCESSOR_NODE
-         case EU_PGD:        // PIDS_ID_PGRP
-         case EU_PID:        // PIDS_ID_PID
-         case EU_PPD:        // PIDS_ID_PPID
-         case EU_SID:        // PIDS_ID_SESSION
-         case EU_TGD:        // PIDS_ID_TGID
-         case EU_THD:        // PIDS_NLWP
-         case EU_TPG:        // PIDS_ID_TPGID
-            cp = make_num(rSv(i, s_int), W, Jn, AUTOX_NO, 0);
-            break;
-   /* s_int, make_num without auto width, but with zero suppression */
-         case EU_AGN:        // PIDS_AUTOGRP_NICE
-         case EU_NCE:        // PIDS_NICE
-         case EU_OOA:        // PIDS_OOM_ADJ
-         case EU_OOM:        // PIDS_OOM_SCORE
-            cp = make_num(rSv(i, s_int), W, Jn, AUTOX_NO, 1);
-            break;
-   /* s_int, scale_num */
-         case EU_FV1:        // PIDS_FLT_MAJ_DELTA
-         case EU_FV2:        // PIDS_FLT_MIN_DELTA
-         case EU_FDS:        // PIDS_OPEN_FILES
-            cp = scale_num(rSv(i, s_int), W, Jn);
-            break;
-   /* s_int, make_num or make_str */
-         case EU_PRI:        // PIDS_PRIORITY
-            if (-99 > rSv(EU_PRI, s_int) || 999 < rSv(EU_PRI, s_int))
-               cp = make_str("rt", W, Jn, AUTOX_NO);
-            else
-               cp = make_num(rSv(EU_PRI, s_int), W, Jn, AUTOX_NO, 0);
-            break;
-   /* u_int, scale_pcnt with special handling */
-         case EU_CPU:        // PIDS_TICS_ALL_DELTA
-         {  float u = (float)rSv(EU_CPU, u_int);
-            int n = rSv(EU_THD, s_int);
-#ifndef TREE_VCPUOFF
- #ifndef TREE_VWINALL
-            if (q == Curwin) // note: the following is NOT indented
- #endif
-            if (CHKw(q, Show_FOREST)) u += rSv(eu_TREE_ADD, u_int);
-            u *= Frame_etscale;
-            /* technically, eu_TREE_HID is only valid if Show_FOREST is active
-               but its zeroed out slot will always be present now */
-            if (rSv(eu_TREE_HID, s_ch) != 'x' && u > 100.0 * n) u = 100.0 * n;
-#else
-            u *= Frame_etscale;
-            /* process can't use more %cpu than number of threads it has
-             ( thanks Jaromir Capik <jcapik@redhat.com> ) */
-            if (u > 100.0 * n) u = 100.0 * n;
-#endif
-            if (u > Cpu_pmax) u = Cpu_pmax;
-            cp = scale_pcnt(u, W, Jn, 0);
-         }
-            break;
-   /* ull_int, scale_pcnt for 'utilization' */
-         case EU_CUU:        // PIDS_UTILIZATION
-         case EU_CUC:        // PIDS_UTILIZATION_C
-            cp = scale_pcnt(rSv(i, real), W, Jn, 1);
-            break;
-   /* u_int, make_num with auto width */
-         case EU_GID:        // PIDS_ID_EGID
-         case EU_UED:        // PIDS_ID_EUID
-         case EU_URD:        // PIDS_ID_RUID
-         case EU_USD:        // PIDS_ID_SUID
-            cp = make_num(rSv(i, u_int), W, Jn, i, 0);
-            break;
-   /* ul_int, make_num with auto width and zero suppression */
-         case EU_NS1:        // PIDS_NS_IPC
-         case EU_NS2:        // PIDS_NS_MNT
-         case EU_NS3:        // PIDS_NS_NET
-         case EU_NS4:        // PIDS_NS_PID
-         case EU_NS5:        // PIDS_NS_USER
-         case EU_NS6:        // PIDS_NS_UTS
-         case EU_NS7:        // PIDS_NS_CGROUP
-         case EU_NS8:        // PIDS_NS_TIME
-            cp = make_num(rSv(i, ul_int), W, Jn, i, 1);
-            break;
-   /* ul_int, scale_mem */
-         case EU_COD:        // PIDS_MEM_CODE
-         case EU_DAT:        // PIDS_MEM_DATA
-         case EU_DRT:        // PIDS_noop, really # pgs, but always 0 since 2.6
-         case EU_PZA:        // PIDS_SMAP_PSS_ANON
-         case EU_PZF:        // PIDS_SMAP_PSS_FILE
-         case EU_PZS:        // PIDS_SMAP_PSS_SHMEM
-         case EU_PSS:        // PIDS_SMAP_PSS
-         case EU_RES:        // PIDS_MEM_RES
-         case EU_RSS:        // PIDS_SMAP_RSS
-         case EU_RZA:        // PIDS_VM_RSS_ANON
-         case EU_RZF:        // PIDS_VM_RSS_FILE
-         case EU_RZL:        // PIDS_VM_RSS_LOCKED
-         case EU_RZS:        // PIDS_VM_RSS_SHARED
-         case EU_SHR:        // PIDS_MEM_SHR
-         case EU_SWP:        // PIDS_VM_SWAP
-         case EU_USE:        // PIDS_VM_USED
-         case EU_USS:        // PIDS_SMAP_PRV_TOTAL
-         case EU_VRT:        // PIDS_MEM_VIRT
-            cp = scale_mem(S, rSv(i, ul_int), W, Jn);
-            break;
-   /* ul_int, scale_num */
-         case EU_FL1:        // PIDS_FLT_MAJ
-         case EU_FL2:        // PIDS_FLT_MIN
-         case EU_IRB:        // PIDS_IO_READ_BYTES
-         case EU_IRO:        // PIDS_IO_READ_OPS
-         case EU_IWB:        // PIDS_IO_WRITE_BYTES
-         case EU_IWO:        // PIDS_IO_WRITE_OPS
-            cp = scale_num(rSv(i, ul_int), W, Jn);
-            break;
-   /* ul_int, scale_pcnt */
-         case EU_MEM:        // derive from PIDS_MEM_RES
-            if (Restrict_some) {
-               cp = justify_pad("?", W, Jn);
-               break;
-            }
-            cp = scale_pcnt((float)rSv(EU_MEM, ul_int) * 100 / MEM_VAL(mem_TOT), W, Jn, 0);
-            break;
-   /* ul_int, make_str with special handling */
-         case EU_FLG:        // PIDS_FLAGS
-            cp = make_str(hex_make(rSv(EU_FLG, ul_int), 1), W, Js, AUTOX_NO);
-            break;
-   /* ull_int, scale_tics (try 'minutes:seconds.hundredths') */
-         case EU_TM2:        // PIDS_TICS_ALL
-         case EU_TME:        // PIDS_TICS_ALL
-         {  TIC_t t;
-            if (CHKw(q, Show_CTIMES)) t = rSv(eu_TICS_ALL_C, ull_int);
-            else t = rSv(i, ull_int);
-            cp = scale_tics(t, W, Jn, TICS_AS_SECS);
-         }
-            break;
-   /* ull_int, scale_tics (try 'minutes:seconds') */
-         case EU_TM3:        // PIDS_TICS_BEGAN
-            cp = scale_tics(rSv(EU_TM3, ull_int), W, Jn, TICS_AS_MINS);
-            break;
-   /* real, scale_tics (try 'hour,minutes') */
-         case EU_TM4:        // PIDS_TIME_ELAPSED
-            cp = scale_tics(rSv(EU_TM4, real) * Hertz, W, Jn, TICS_AS_HOUR);
-            break;
-   /* str, make_str (fixed width) */
-         case EU_CLS:        // PIDS_SCHED_CLASSSTR
-            cp = make_str(rSv(i, str), W, Js, AUTOX_NO);
-            break;
-   /* str, make_str (all AUTOX yes) */
-         case EU_DKR:        // PIDS_DOCKER_ID
-         case EU_LXC:        // PIDS_LXCNAME
-         case EU_TTY:        // PIDS_TTY_NAME
-         case EU_WCH:        // PIDS_WCHAN_NAME
-            cp = make_str(rSv(i, str), W, Js, i);
-            break;
-   /* str, make_str_utf8 (all AUTOX yes) */
-         case EU_GRP:        // PIDS_ID_EGROUP
-         case EU_UEN:        // PIDS_ID_EUSER
-         case EU_URN:        // PIDS_ID_RUSER
-         case EU_USN:        // PIDS_ID_SUSER
-            cp = make_str_utf8(rSv(i, str), W, Js, i);
-            break;
-   /* str, make_str_utf8 with variable width */
-         case EU_CGN:        // PIDS_CGNAME
-         case EU_CGR:        // PIDS_CGROUP
-         case EU_ENV:        // PIDS_ENVIRON
-         case EU_EXE:        // PIDS_EXE
-         case EU_SGN:        // PIDS_SUPGROUPS
-            varUTF8(rSv(i, str))
-            break;
-   /* str, make_str with variable width */
-         case EU_SGD:        // PIDS_SUPGIDS
-            makeVAR(rSv(EU_SGD, str))
-            break;
-   /* str, make_str with variable width + additional decoration */
-         case EU_CMD:        // PIDS_CMD or PIDS_CMDLINE
-            varUTF8(forest_display(q, idx))
-            break;
-         default:            // keep gcc happy
-            continue;
-      } // end: switch 'procflag'
+      const FMT_t *f = &q->fmtab[x];
+      const char  *cp;
 
-      if (cp) {
-         if (q->osel_tot && !osel_matched(q, i, cp)) return "";
-         rp = scat(rp, cp);
-      }
-      #undef S
-      #undef W
-      #undef Js
-      #undef Jn
+      if (!f->func || !(cp = f->func(q, f, p, idx)))
+         continue;
+      if (q->osel_tot && !osel_matched(q, f->pflg, cp)) return "";
+      rp = scat(rp, cp);
    } // end: for 'maxpflgs'
 
    if (!CHKw(q, NOPRINT_xxx)) {
@@ -7367,8 +7848,6 @@ static const char *task_show (const WIN_t *q, int idx) {
    }
    return rbuf;
  #undef rSv
- #undef makeVAR
- #undef varUTF8
 } // end: task_show
 
 
@@ -7430,6 +7909,63 @@ wrap_up:
 } // end: window_hlp
 
 
+#ifndef SORT_SEED_NO
+        /*
+         * A window_show *Helper* function who rearranges this frame's tasks |
+         * into the order in which they were sorted during the prior frame. |
+         * With that, procps_pids_sort (a natural mergesort) sees an almost |
+         * sorted array and does far less work than starting from scratch. |
+         * Those tasks which are new to this frame will simply go at the end. |
+         * Note: as a side effect, tasks with equal sort values retain their |
+         *       prior relative order, thus reducing frame to frame jitter. | */
+static void window_seed (WIN_t *q) {
+ #define rSv(x) PID_VAL(EU_PID, s_int, (x))
+   static struct { int pid, pos; } *hash;  // pid to (1 + prior position)
+   static struct pids_stack **hold;        // the prior positions, refilled
+   static unsigned hash_siz;
+   static int hold_siz;
+   unsigned h, mask;
+   int i, j, new;
+
+   if (!q->seedtot) return;
+   // the hash table is kept no more than 50% full, to keep probes short...
+   if (hash_siz < 2 * (unsigned)q->seedtot) {
+      for (hash_siz = 1024; hash_siz < 2 * (unsigned)q->seedtot; hash_siz *= 2)
+         ;
+      hash = alloc_r(hash, sizeof(*hash) * hash_siz);
+   }
+   if (hold_siz < q->seedtot) {
+      hold_siz = q->seedtot;
+      hold = alloc_r(hold, sizeof(void *) * hold_siz);
+   }
+   memset(hash, 0, sizeof(*hash) * hash_siz);
+   memset(hold, 0, sizeof(void *) * q->seedtot);
+   mask = hash_siz - 1;
+
+   for (j = 0; j < q->seedtot; j++) {
+      for (h = ((unsigned)q->seedpid[j] * 2654435761u) & mask; hash[h].pid; h = (h + 1) & mask)
+         ;
+      hash[h].pid = q->seedpid[j];
+      hash[h].pos = j + 1;
+   }
+   /* find each task's prior position, while those not found (the newbies)
+      are compacted (in place) at the beginning of our window's ppt array */
+   for (i = 0, new = 0; i < PIDSmaxt; i++) {
+      int pid = rSv(q->ppt[i]);
+      for (h = ((unsigned)pid * 2654435761u) & mask; hash[h].pid; h = (h + 1) & mask)
+         if (hash[h].pid == pid) break;
+      if (hash[h].pid) hold[hash[h].pos - 1] = q->ppt[i];
+      else q->ppt[new++] = q->ppt[i];
+   }
+   // now the newbies go last, preceded by all the prior tasks (in order)
+   memmove(q->ppt + (PIDSmaxt - new), q->ppt, sizeof(void *) * new);
+   for (i = 0, j = 0; j < q->seedtot; j++)
+      if (hold[j]) q->ppt[i++] = hold[j];
+ #undef rSv
+} // end: window_seed
+#endif
+
+
         /*
          * Squeeze as many tasks as we can into a single window,
          * after sorting the passed proc table. */
@@ -7447,7 +7983,8 @@ static int window_show (WIN_t *q, int wmax) {
    // and just in case 'Monpids' is active but matched no processes ...
    if (!PIDSmaxt) return 1;                         // 1 for the column header
 
-   if (CHKw(q, Show_FOREST)) {
+   // grouped tasks have no parents, so there's no forest to be seen
+   if (CHKw(q, Show_FOREST) && !Group_mode) {
       forest_begin(q);
       if (q->focus_pid) forest_config(q);
    } else {
@@ -7456,8 +7993,16 @@ static int window_show (WIN_t *q, int wmax) {
          item = PIDS_CMDLINE;
       else if (item == PIDS_TICS_ALL && CHKw(q, Show_CTIMES))
          item = PIDS_TICS_ALL_C;
+#ifndef SORT_SEED_NO
+      window_seed(q);
+#endif
       if (!(procps_pids_sort(Pids_ctx, q->ppt , PIDSmaxt, item, sORDER)))
          error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+#ifndef SORT_SEED_NO
+      for (i = 0; i < PIDSmaxt; i++)
+         q->seedpid[i] = PID_VAL(EU_PID, s_int, q->ppt[i]);
+      q->seedtot = PIDSmaxt;
+#endif
    }
 
    if (mkVIZyes) window_hlp();
@@ -7541,6 +8086,12 @@ static void frame_make (void) {
 
    /* deal with potential signal(s) since the last time around
       plus any input which may change 'tasks_refresh' needs... */
+   if (Budget.pct && budget_cadence() && !Frames_signal) {
+      // just the costly fields changed, so we'll avoid all of that below
+      build_headers();
+      if ((i = procps_pids_reset(Pids_ctx, Pids_itms, Pids_itms_tot)))
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-i)));
+   }
    if (Frames_signal) {
       if (Frames_signal == BREAK_sig
       || (Frames_signal == BREAK_screen))
@@ -7636,14 +8187,16 @@ int main (int argc, char *argv[]) {
 
    for (;;) {
       struct timespec ts;
+      float delay;
 
       frame_make();
 
       if (0 < Loops) --Loops;
       if (!Loops) bye_bye(NULL);
 
-      ts.tv_sec = Rc.delay_time;
-      ts.tv_nsec = (Rc.delay_time - (int)Rc.delay_time) * 1000000000;
+      delay = Budget.pct ? budget_adapt() : Rc.delay_time;
+      ts.tv_sec = delay;
+      ts.tv_nsec = (delay - (int)delay) * 1000000000;
 
       if (Batch)
          pselect(0, NULL, NULL, NULL, &ts, NULL);
@@ -59,6 +59,7 @@
 //#define SCALE_POSTFX            /* scale_tics() try without a 'h,d' suffix */
 //#define SCROLLVAR_NO            /* disable intra-column horizontal scrolls */
 //#define SCROLLV_BY_1            /* when scrolling left/right do not move 8 */
+//#define SORT_SEED_NO            /* do not seed sorts with the prior frame */
 //#define STRINGCASENO            /* case insensitive compare/locate version */
 //#define TERMIOS_ONLY            /* use native input only (just limp along) */
 //#define THREADED_ALL            /* separate threads for the next 3 defines */
@@ -245,6 +246,10 @@ enum pflag {
    EU_NS7, EU_NS8,
    EU_CLS, EU_DKR,
    EU_FDS,
+   EU_IRR, EU_IWR,
+   EU_CSV, EU_CSI, EU_RQW,
+   EU_DIO, EU_DSW, EU_DRC, EU_DTH,
+   EU_MIG, EU_NOD, EU_GTS,
 #ifdef USE_X_COLHDR
    // not really pflags, used with tbl indexing
    EU_MAXPFLGS
@@ -290,6 +295,7 @@ typedef          long long SIC_t;
 #define View_LOADAV  0x004000     // 'l' - display load avg and uptime summary
 #define View_STATES  0x002000     // 't' - display task/cpu(s) states summary
 #define View_MEMORY  0x001000     // 'm' - display memory summary
+#define View_PRESSR  0x100000     // 'p' - display pressure stall summary
 #define View_NOBOLD  0x000008     // 'B' - disable 'bold' attribute globally
 #define View_SCROLL  0x080000     // 'C' - enable coordinates msg w/ scrolling
         // 'Show_' & 'Qsrt_' flags are for task display in a visible window
@@ -375,6 +381,20 @@ typedef struct RCF_t {
    int    tics_scaled;          // ^E  - scale TIME and/or TIME+ columns
 } RCF_t;
 
+        /* This represents a single precompiled task column formatter,
+           established by build_formats and then invoked by task_show */
+struct WIN_t;
+struct pids_stack;
+typedef struct FMT_t {
+   const char *(*func)(const struct WIN_t *, const struct FMT_t *, struct pids_stack *, int);
+   FLG_t  pflg;                 // the procflg this formatter represents
+   int    width;                // Fieldstab width (or varcolsz if variable)
+   int    scale;                // Fieldstab scale
+   int    jflg;                 // the WIN_t flag which controls justification
+   int    autox;                // procflg if auto width, otherwise AUTOX_NO
+   int    noz;                  // suppress zero values with make_num
+} FMT_t;
+
         /* This structure stores configurable information for each window.
            By expending a little effort in its creation and user requested
            maintenance, the only real additional per frame cost of having
@@ -382,6 +402,7 @@ typedef struct RCF_t {
 typedef struct WIN_t {
    FLG_t  pflgsall [PFLAGSSIZ],        // all 'active/on' fieldscur, as enum
           procflgs [PFLAGSSIZ];        // fieldscur subset, as enum
+   FMT_t  fmtab [PFLAGSSIZ];           // procflgs formatters, as precompiled
    RCW_t  rc;                          // stuff that gets saved in the rcfile
    int    winnum,          // a window's number (array pos + 1)
           winlines,        // current task window's rows (volatile)
@@ -420,6 +441,10 @@ typedef struct WIN_t {
    int    focus_lvl;                   // the indentation level of parent task
 #endif
    struct pids_stack **ppt;            // this window's stacks ptr array
+#ifndef SORT_SEED_NO
+   int   *seedpid;                     // ppt pids, as sorted in prior frame
+   int    seedtot;                     // total pids in the above array
+#endif
    struct WIN_t *next,                 // next window in window stack
                 *prev;                 // prior window in window stack
 } WIN_t;
@@ -681,6 +706,7 @@ typedef struct WIN_t {
 
    /* These 'prototypes' are here exclusively for documentation purposes. */
    /* ( see the find_string routine for the one true required prototype ) */
+   /* ( plus the one for build_formats, seen just before build_headers )  */
 /*------  Tiny useful routine(s)  ----------------------------------------*/
 //atic const char   *fmtmk (const char *fmts, ...);
 //atic inline int    mlen (const int *mem);
@@ -736,12 +762,18 @@ typedef struct WIN_t {
 /*------  Fields Management support  -------------------------------------*/
 /*atic struct        Fieldstab[] = { ... }                                */
 //atic void          adj_geometry (void);
+//atic void          budget_items (void);
 //atic void          build_headers (void);
 //atic void          calibrate_fields (void);
 //atic void          display_fields (int focus, int extend);
 //atic void          fields_utility (void);
 //atic inline void   widths_resize (void);
 //atic void          zap_fieldstab (void);
+/*------  Cost Budget support  ------------------------------------------*/
+//atic inline double budget_secs (clockid_t clk);
+//atic float         budget_adapt (void);
+//atic int           budget_cadence (void);
+//atic void          budget_mark (int which, int beg);
 /*------  Library Interface (as separate threads)  -----------------------*/
 //atic void         *cpus_refresh (void *unused);
 //atic void         *memory_refresh (void *unused);
@@ -793,6 +825,14 @@ typedef struct WIN_t {
 //atic void          forest_begin (WIN_t *q);
 //atic void          forest_config (WIN_t *q);
 //atic inline const char *forest_display (const WIN_t *q, int idx);
+/*------  Task Formatting support  ---------------------------------------*/
+//atic const char   *fmt_xonoff (const WIN_t *q, const FMT_t *f, struct pids_stack *p, int idx);
+//atic const char   *fmt_skipped (const WIN_t *q, const FMT_t *f, struct pids_stack *p, int idx);
+//atic const char   *fmt_s_ch (const WIN_t *q, const FMT_t *f, struct pids_stack *p, int idx);
+//atic const char   *fmt_ ... ( one for each of the other task column types )
+//atic inline const char *fmt_variable (const WIN_t *q, const FMT_t *f, const char *pv, int utf8);
+//atic const char   *fmt_cmd (const WIN_t *q, const FMT_t *f, struct pids_stack *p, int idx);
+//atic void          build_formats (void);
 /*------  Special Separate Bottom Window support  ------------------------*/
 //atic void          bot_do (const char *str, int focus);
 //atic int           bot_focus_str (const char *hdr, const char *str);
@@ -827,6 +867,7 @@ typedef struct WIN_t {
 //atic void          summary_show (void);
 //atic const char   *task_show (const WIN_t *q, int idx);
 //atic void          window_hlp (void);
+//atic void          window_seed (WIN_t *q);
 //atic int           window_show (WIN_t *q, int wmax);
 /*------  Entry point plus two  ------------------------------------------*/
 //atic void          frame_hlp (int wix, int max);
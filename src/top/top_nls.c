@@ -378,6 +378,42 @@ static void build_two_nlstabs (void) {
 /* Translation Hint: maximum 'nFD' = 3 */
    Head_nlstab[EU_FDS] = _("nFD");
    Desc_nlstab[EU_FDS] = _("Number of Open Files");
+/* Translation Hint: maximum 'ioR/s' = 6 */
+   Head_nlstab[EU_IRR] = _("ioR/s");
+   Desc_nlstab[EU_IRR] = _("I/O Bytes Read/sec");
+/* Translation Hint: maximum 'ioW/s' = 6 */
+   Head_nlstab[EU_IWR] = _("ioW/s");
+   Desc_nlstab[EU_IWR] = _("I/O Bytes Written/sec");
+/* Translation Hint: maximum 'vVCSW' = 5 */
+   Head_nlstab[EU_CSV] = _("vVCSW");
+   Desc_nlstab[EU_CSV] = _("Vol Switches delta");
+/* Translation Hint: maximum 'vIVCS' = 5 */
+   Head_nlstab[EU_CSI] = _("vIVCS");
+   Desc_nlstab[EU_CSI] = _("Invol Switches delta");
+/* Translation Hint: maximum '%WAIT' = 5 */
+   Head_nlstab[EU_RQW] = _("%WAIT");
+   Desc_nlstab[EU_RQW] = _("CPU Wait (runqueue)");
+/* Translation Hint: maximum '%DIO' = 5 */
+   Head_nlstab[EU_DIO] = _("%DIO");
+   Desc_nlstab[EU_DIO] = _("Block I/O Delay");
+/* Translation Hint: maximum '%DSW' = 5 */
+   Head_nlstab[EU_DSW] = _("%DSW");
+   Desc_nlstab[EU_DSW] = _("Swap In Delay");
+/* Translation Hint: maximum '%DRC' = 5 */
+   Head_nlstab[EU_DRC] = _("%DRC");
+   Desc_nlstab[EU_DRC] = _("Memory Reclaim Delay");
+/* Translation Hint: maximum '%DTH' = 5 */
+   Head_nlstab[EU_DTH] = _("%DTH");
+   Desc_nlstab[EU_DTH] = _("Thrashing Delay");
+/* Translation Hint: maximum 'vMIG' = 4 */
+   Head_nlstab[EU_MIG] = _("vMIG");
+   Desc_nlstab[EU_MIG] = _("Cpu Migrated delta");
+/* Translation Hint: maximum 'vNOD' = 4 */
+   Head_nlstab[EU_NOD] = _("vNOD");
+   Desc_nlstab[EU_NOD] = _("NUMA Node changed delta");
+/* Translation Hint: maximum 'nTSK' = 5 */
+   Head_nlstab[EU_GTS] = _("nTSK");
+   Desc_nlstab[EU_GTS] = _("Grouped Tasks count");
 }
 
 
@@ -411,6 +447,7 @@ static void build_norm_nlstab (void) {
       "\n"
       "Options:\n"
       " -A, --apply-defaults            if present, ignore config file(s)\n"
+      " -B, --cost-budget =PERCENT      limit our own cpu use to PERCENT\n"
       " -b, --batch-mode                run in non-interactive batch mode\n"
       " -c, --cmdline-toggle            reverse last remembered 'c' state\n"
       " -d, --delay =SECS [.TENTHS]     iterative delay as SECS [.TENTHS]\n"
@@ -434,6 +471,7 @@ static void build_norm_nlstab (void) {
       "\n"
       "For more details see top(1).");
    Norm_nlstab[BAD_delayint_fmt] = _("bad delay interval '%s'");
+   Norm_nlstab[BAD_budgetpc_fmt] = _("bad cost budget percent '%s'");
    Norm_nlstab[BAD_niterate_fmt] = _("bad iterations argument '%s'");
    Norm_nlstab[LIMIT_exceed_fmt] = _("pid limit (%d) exceeded");
    Norm_nlstab[BAD_mon_pids_fmt] = _("bad pid '%s'");
@@ -456,6 +494,7 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[WRITE_rcfile_fmt] = _("Wrote configuration to '%s'");
    Norm_nlstab[DELAY_change_fmt] = _("Change delay from %.1f to");
    Norm_nlstab[THREADS_show_fmt] = _("Show threads %s");
+   Norm_nlstab[GROUPS_show_fmt] = _("Group tasks by %s");
    Norm_nlstab[IRIX_curmode_fmt] = _("Irix mode %s");
    Norm_nlstab[GET_pid2kill_fmt] = _("PID to signal/kill [default pid = %d]");
    Norm_nlstab[GET_sigs_num_fmt] = _("Send pid %d signal [%d/sigterm]");
@@ -481,6 +520,7 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[RC_bad_files_fmt] = _("incompatible rcfile, you should delete '%s'");
    Norm_nlstab[RC_bad_entry_fmt] = _("window entry #%d corrupt, please delete '%s'");
    Norm_nlstab[NOT_onsecure_txt] = _("Unavailable in secure mode");
+   Norm_nlstab[NOT_ongroup_txt] = _("Unavailable while tasks are grouped");
    Norm_nlstab[NOT_smp_cpus_txt] = _("Only 1 cpu detected");
    Norm_nlstab[BAD_integers_txt] = _("Unacceptable integer");
    Norm_nlstab[SELECT_clash_txt] = _("conflicting process selections (U/p/u)");
@@ -581,9 +621,12 @@ static void build_norm_nlstab (void) {
 /* Translation Hint: The following word 'Node' should be exactly
                      4 characters, excluding leading %%, fmt chars & colon) */
    Norm_nlstab[NUMA_nodenam_fmt] = _("%%Node%-2d:");
+/* Translation Hint: this is a numa node's memory, aligned with "Mem " & "Swap" */
+   Norm_nlstab[NUMA_memnam_fmt] = _("Nd%-2d");
    Norm_nlstab[NUMA_nodeget_fmt] = _("expand which numa node (0-%d)");
    Norm_nlstab[NUMA_nodebad_txt] = _("invalid numa node");
    Norm_nlstab[NUMA_nodenot_txt] = _("sorry, NUMA extensions unavailable");
+   Norm_nlstab[PSI_notavail_txt] = _("sorry, pressure stall information unavailable");
 /* Translation Hint: 'Mem ' is an abbreviation for physical memory/ram
    .                 'Swap' represents the linux swap file --
    .                 please make both translations exactly 4 characters,
@@ -681,7 +724,7 @@ static void build_uniq_nlstab (void) {
       "%s"
       "  Y,^E      Inspect a task '~1Y~2'; Scale process time '~1^E~2'\n"
       "  !,^       Progressively Combine Cpus '~1!~2'; Display Cores vs. Cpus '~1^~2' \n"
-      "  W         Write config file '~1W~2'\n"
+      "  W,p,D     Write config file '~1W~2'; Toggle pressure stalls '~1p~2'; Group '~1D~2'\n"
       "\n"
       "Press '~1h~2' for help with ~1Specialized~2 keys, '~1H~2' for help with ~1Windows~2,\n"
       "Type 'q' or <Esc> to continue ");
@@ -808,6 +851,18 @@ static void build_uniq_nlstab (void) {
    Uniq_nlstab[STATE_lin2x7_fmt] = _("%s~3"
       "%#5.1f ~2us,~3%#5.1f ~2sy,~3%#5.1f ~2ni,~3%#5.1f ~2id,~3%#5.1f ~2wa,~3%#5.1f ~2hi,~3%#5.1f ~2si,~3%#5.1f ~2st~3 ~1");
 
+/* Translation Hint: Only the following abbreviations need be translated
+   .                 tsk = tasks, cpu = cpus, mem = memory, wall = elapsed time,
+   .                 s = seconds (the delay), costly = fields refreshed less often */
+   Uniq_nlstab[BUDGET_line1_fmt] = _("Cost ms:~3"
+      "%6.1f ~2tsk,~3%5.1f ~2cpu,~3%5.1f ~2mem,~3%6.1f ~2wall;~3%4.1f%% ~2self,~3%4.1f~2s,~3 1/%d ~2costly~3\n");
+
+/* Translation Hint: Only the following abbreviations need be translated
+   .                 cpu = cpus, io = block i/o, mem = memory,
+   .                 some = some tasks stalled, full = all non-idle tasks stalled */
+   Uniq_nlstab[STALLS_line1_fmt] = _("%%Stall:~3"
+      " %#5.1f ~2cpu,~3 %#5.1f ~2io,~3 %#5.1f ~2mem ~2some;~3 %#5.1f ~2io,~3 %#5.1f ~2mem ~2full~3\n");
+
 /* Translation Hint: next 2 must be treated together, with WORDS above & below aligned */
    Uniq_nlstab[MEMORY_line1_fmt] = _(""
       "%s %s:~3 %9.9s~2total,~3 %9.9s~2free,~3 %9.9s~2used,~3 %9.9s~2buff/cache~3 ~1    ");
@@ -46,8 +46,10 @@
 #include "strutils.h"
 
 #include "diskstats.h"
+#include "interrupts.h"
 #include "meminfo.h"
 #include "misc.h"
+#include "pressure.h"
 #include "slabinfo.h"
 #include "stat.h"
 #include "vmstat.h"
@@ -67,6 +69,7 @@ static char szDataUnit[3] = "K";
 #define SLABSTAT      0x00000004
 #define PARTITIONSTAT 0x00000008
 #define DISKSUMSTAT   0x00000010
+#define IRQSTAT       0x00000020
 
 static int statMode = VMSTAT;
 
@@ -82,6 +85,9 @@ static int y_option;
 /* "-t" means "show timestamp" */
 static int t_option;
 
+/* "-P" adds the pressure stall columns */
+static int P_option;
+
 static unsigned sleep_time = 1;
 static int infinite_updates = 0;
 static unsigned long num_updates =1;
@@ -140,6 +146,18 @@ enum Rel_memitems {
     mem_SUS, mem_FREE, mem_ACT, mem_INA, mem_BUF, mem_CAC,  MAX_mem
 };
 
+static enum pressure_item Psi_items[] = {
+    PRESSURE_CPU_SOME_TOTAL,
+    PRESSURE_IO_SOME_TOTAL,
+    PRESSURE_MEM_SOME_TOTAL,
+    PRESSURE_DELTA_CPU_SOME_PCT,
+    PRESSURE_DELTA_IO_SOME_PCT,
+    PRESSURE_DELTA_MEM_SOME_PCT
+};
+enum Rel_psiitems {
+    psi_CPU, psi_IO, psi_MEM, psi_DCPU, psi_DIO, psi_DMEM,  MAX_psi
+};
+
 static enum diskstats_item Disk_items[] = {
     DISKSTATS_TYPE,
     DISKSTATS_NAME,
@@ -227,7 +245,9 @@ static void __attribute__ ((__noreturn__))
     fputs(_(" -s, --stats            event counter statistics\n"), out);
     fputs(_(" -d, --disk             disk statistics\n"), out);
     fputs(_(" -D, --disk-sum         summarize disk statistics\n"), out);
+    fputs(_(" -I, --interrupts       hottest interrupts\n"), out);
     fputs(_(" -p, --partition <dev>  partition specific statistics\n"), out);
+    fputs(_(" -P, --pressure         pressure stall statistics\n"), out);
     fputs(_(" -S, --unit <char>      define display unit\n"), out);
     fputs(_(" -w, --wide             wide output\n"), out);
     fputs(_(" -t, --timestamp        show timestamp\n"), out);
@@ -280,6 +300,13 @@ static struct field fields[] = {
 	{ NULL,		0,  0,	0 }	/* Sentinel */
 };
 
+static struct field psi_fields[] = {
+	{ "cpu",	3,  4,	0 },	/* added if P_option */
+	{ "io",		3,  4,	0 },
+	{ "mem",	3,  4,	0 },
+	{ NULL,		0,  0,	0 }	/* Sentinel */
+};
+
 static void new_header(void)
 {
     struct tm *tm_ptr;
@@ -295,9 +322,14 @@ static void new_header(void)
     const char *wide_header =
         _("--procs-- -----------------------memory---------------------- ---swap-- -----io---- -system-- ----------cpu----------");
     const char *timestamp_header = _(" -----timestamp-----");
+    const char *pressure_header = _(" --pressure-");
+    const char *wide_pressure_header = _(" ---pressure---");
 
     printf("%s", w_option ? wide_header : header);
 
+    if (P_option) {
+        printf("%s", w_option ? wide_pressure_header : pressure_header);
+    }
     if (t_option) {
         printf("%s", timestamp_header);
     }
@@ -320,6 +352,11 @@ static void new_header(void)
             printf(" ");
         }
     }
+    if (P_option) {
+        for (field=psi_fields; field->header != NULL; field++)
+            printf(" %*s", !w_option ? field->width : field->wide_width,
+                      _(field->header));
+    }
     if (t_option) {
         (void) time( &the_time );
         tm_ptr = localtime( &the_time );
@@ -383,6 +420,12 @@ static void output_line(struct field *fields, char timebuf[])
         }
     }
 
+    if (P_option) {
+        for (field=psi_fields; field->header != NULL; field++)
+            printf(" %*lu", !w_option ? field->width : field->wide_width,
+                      field->value);
+    }
+
     if (t_option) {
         printf(" %s", timebuf);
     }
@@ -397,6 +440,8 @@ static void new_format(void)
 #define SYSv(E) STAT_VAL(E, ul_int, stat_stack)
 #define MEMv(E) MEMINFO_VAL(E, ul_int, mem_stack)
 #define DSYSv(E) STAT_VAL(E, s_int, stat_stack)
+#define PSIv(E) PRESSURE_VAL(E, ull_int, psi_stack)
+#define DPSIv(E) PRESSURE_VAL(E, real, psi_stack)
     unsigned int tog = 0;    /* toggle switch for cleaner code */
     unsigned long i;
     long long cpu_use, cpu_sys, cpu_idl, cpu_iow, cpu_sto, cpu_gue;
@@ -414,6 +459,8 @@ static void new_format(void)
     struct stat_stack *stat_stack;
     struct meminfo_info *mem_info = NULL;
     struct meminfo_stack *mem_stack;
+    struct pressure_info *psi_info = NULL;
+    struct pressure_stack *psi_stack = NULL;
 
     sleep_half = (sleep_time / 2);
     // long hz = procps_hertz_get();
@@ -424,6 +471,8 @@ static void new_format(void)
         errx(EXIT_FAILURE, _("Unable to create system stat structure"));
     if (procps_meminfo_new(&mem_info) < 0)
         errx(EXIT_FAILURE, _("Unable to create meminfo structure"));
+    if (P_option && procps_pressure_new(&psi_info) < 0)
+        errx(EXIT_FAILURE, _("Unable to create pressure structure"));
     if (procps_uptime(&uptime, NULL) < 0)
         err(EXIT_FAILURE, _("Unable to get uptime"));
     if (0.0 == uptime)
@@ -487,9 +536,22 @@ static void new_format(void)
 	V(17) = (100*cpu_gue + divo2) / Div;
 #undef V
 
+        if (P_option) {
+            if (!(psi_stack = procps_pressure_select(psi_info, Psi_items, MAX_psi)))
+                errx(EXIT_FAILURE, _("Unable to select pressure information"));
+            /* the stall totals are microseconds, so this is a percentage */
+            psi_fields[0].value = (unsigned)( PSIv(psi_CPU) / (uptime * 1e4) + 0.5 );
+            psi_fields[1].value = (unsigned)( PSIv(psi_IO)  / (uptime * 1e4) + 0.5 );
+            psi_fields[2].value = (unsigned)( PSIv(psi_MEM) / (uptime * 1e4) + 0.5 );
+        }
+
 	output_line(fields, timebuf);
-    } else
+    } else {
         num_updates++;
+        /* the first loop's stalls must then begin from here */
+        if (P_option && !procps_pressure_select(psi_info, Psi_items, MAX_psi))
+            errx(EXIT_FAILURE, _("Unable to select pressure information"));
+    }
 
     /* main loop */
     for (i = 1; infinite_updates || i < num_updates; i++) {
@@ -568,12 +630,24 @@ static void new_format(void)
 	V(17) = (100*cpu_gue + divo2) / Div;
 #undef V
 
+        if (P_option) {
+            if (!(psi_stack = procps_pressure_select(psi_info, Psi_items, MAX_psi)))
+                errx(EXIT_FAILURE, _("Unable to select pressure information"));
+            psi_fields[0].value = (unsigned)( DPSIv(psi_DCPU) + 0.5 );
+            psi_fields[1].value = (unsigned)( DPSIv(psi_DIO)  + 0.5 );
+            psi_fields[2].value = (unsigned)( DPSIv(psi_DMEM) + 0.5 );
+        }
+
 	output_line(fields, timebuf);
     }
     /* Cleanup */
     procps_stat_unref(&stat_info);
     procps_vmstat_unref(&vm_info);
     procps_meminfo_unref(&mem_info);
+    if (psi_info)
+        procps_pressure_unref(&psi_info);
+#undef PSIv
+#undef DPSIv
 #undef TICv
 #undef DTICv
 #undef SYSv
@@ -824,6 +898,101 @@ static void slabformat (void)
  #undef slabVAL
 }
 
+static void irqheader(void)
+{
+    printf("%-10s %12s %5s %6s  %s\n",
+    /* Translation Hint: Translating folloging irq fields that
+     * follow (marked with max x chars) might not work, unless
+     * manual page is translated as well.  */
+           /* Translation Hint: max 10 chars */
+           _("IRQ"),
+           /* Translation Hint: max 12 chars */
+           _("Count"),
+           /* Translation Hint: max 5 chars */
+           _("CPU"),
+           /* Translation Hint: max 6 chars */
+           _("Share"),
+           _("Description"));
+}
+
+static void irqformat (void)
+{
+ #define IRQ_HOTTEST 10
+ #define MAX_ITEMS (int)(sizeof(node_items) / sizeof(node_items[0]))
+ #define irqVAL(e,t) INTERRUPTS_VAL(e, t, p)
+    struct interrupts_info *irq_info = NULL;
+    struct interrupts_reaped *reaped;
+    unsigned long i;
+    int j, hot;
+    unsigned long long count, hot_count;
+    enum interrupts_item node_items[] = {
+        INTERRUPTS_NAME,       INTERRUPTS_TYPE,
+        INTERRUPTS_DESCRIPTION,
+        INTERRUPTS_TOTAL,      INTERRUPTS_NUM_CPUS,
+        INTERRUPTS_CPU_COUNTS, INTERRUPTS_DELTA_TOTAL,
+        INTERRUPTS_DELTA_HOT_CPU, INTERRUPTS_DELTA_HOT_CPU_COUNT };
+    enum rel_enums {
+        irq_NAME, irq_TYPE, irq_DESC, irq_TOT, irq_NCPU, irq_CPUS,
+        irq_DTOT, irq_DHOT, irq_DHCNT };
+
+    if (procps_interrupts_new(&irq_info) < 0)
+        err(EXIT_FAILURE, _("Unable to create interrupts structure"));
+
+    if (!moreheaders)
+        irqheader();
+
+    /* the first report (like that of the default mode) is since boot,
+       then each one after that is for the interval just completed */
+    if (y_option)
+        sleep(sleep_time);
+
+    for (i = 0; infinite_updates || i < num_updates; i++) {
+        int boot = (i == 0 && !y_option);
+        if (!(reaped = procps_interrupts_reap(irq_info, node_items, MAX_ITEMS)))
+            errx(EXIT_FAILURE, _("Unable to get interrupts data"));
+        if (!(procps_interrupts_sort(irq_info, reaped->stacks, reaped->total
+            , boot ? INTERRUPTS_TOTAL : INTERRUPTS_DELTA_TOTAL, INTERRUPTS_SORT_DESCEND)))
+            errx(EXIT_FAILURE, _("Unable to sort interrupts"));
+
+        if (moreheaders)
+            irqheader();
+        for (j = 0; j < reaped->total && j < IRQ_HOTTEST; j++) {
+            struct interrupts_stack *p = reaped->stacks[j];
+            if (boot) {
+                unsigned *cpus = irqVAL(irq_CPUS, u_vec);
+                int c;
+                count = irqVAL(irq_TOT, ull_int);
+                hot = -1;
+                hot_count = 0;
+                for (c = 0; c < irqVAL(irq_NCPU, s_int); c++)
+                    if (cpus[c] > hot_count) {
+                        hot = c;
+                        hot_count = cpus[c];
+                    }
+            } else {
+                count = irqVAL(irq_DTOT, ull_int);
+                hot = irqVAL(irq_DHOT, s_int);
+                hot_count = irqVAL(irq_DHCNT, u_int);
+            }
+            if (!count)
+                break;
+            printf("%-10.10s %12llu ", irqVAL(irq_NAME, str), count);
+            if (hot < 0)
+                printf("%5s %6s", "-", "-");
+            else
+                printf("%5d %5.1f%%", hot, hot_count * 100.0 / count);
+            printf("  %s\n", irqVAL(irq_TYPE, s_int) == INTERRUPTS_TYPE_SOFTIRQ
+                ? _("softirq") : irqVAL(irq_DESC, str));
+        }
+        if (infinite_updates || i+1 < num_updates)
+            sleep(sleep_time);
+    }
+    procps_interrupts_unref(&irq_info);
+ #undef IRQ_HOTTEST
+ #undef MAX_ITEMS
+ #undef irqVAL
+}
+
 static void disksum_format(void)
 {
 #define diskVAL(e,t) DISKSTATS_VAL(e, t, reap->stacks[j])
@@ -984,7 +1153,9 @@ int main(int argc, char *argv[])
         {"stats", no_argument, NULL, 's'},
         {"disk", no_argument, NULL, 'd'},
         {"disk-sum", no_argument, NULL, 'D'},
+        {"interrupts", no_argument, NULL, 'I'},
         {"partition", required_argument, NULL, 'p'},
+        {"pressure", no_argument, NULL, 'P'},
         {"unit", required_argument, NULL, 'S'},
         {"wide", no_argument, NULL, 'w'},
         {"timestamp", no_argument, NULL, 't'},
@@ -1003,7 +1174,7 @@ int main(int argc, char *argv[])
     atexit(close_stdout);
 
     while ((c =
-        getopt_long(argc, argv, "afmnsdDp:S:wthVy", longopts, NULL)) != -1)
+        getopt_long(argc, argv, "afmnsdDIp:PS:wthVy", longopts, NULL)) != -1)
         switch (c) {
         case 'V':
             printf(PROCPS_NG_VERSION);
@@ -1027,6 +1198,9 @@ int main(int argc, char *argv[])
         case 'D':
             statMode |= DISKSUMSTAT;
             break;
+        case 'I':
+            statMode |= IRQSTAT;
+            break;
         case 'n':
             /* print only one header */
             moreheaders = FALSE;
@@ -1037,6 +1211,9 @@ int main(int argc, char *argv[])
             if (strncmp(partition, "/dev/", 5) == 0)
                 partition += 5;
             break;
+        case 'P':
+            P_option = 1;
+            break;
         case 'S':
             switch (optarg[0]) {
             case 'b':
@@ -1119,6 +1296,9 @@ int main(int argc, char *argv[])
     case (DISKSUMSTAT):
         disksum_format();
         break;
+    case (IRQSTAT):
+        irqformat();
+        break;
     default:
         usage(stderr);
         break;